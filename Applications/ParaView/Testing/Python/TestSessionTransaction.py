@@ -0,0 +1,114 @@
+# Check that the requests made in a session transaction reach the server, in
+# order, in a single message, and that a request expecting a reply sends the
+# requests queued before it.
+
+import sys
+
+from paraview import servermanager
+import paraview.simple as smp
+
+
+# Make sure the test driver know that process has properly started
+print "Process started"
+
+
+def getHost(url):
+   return url.split(':')[1][2:]
+
+
+def getPort(url):
+   return int(url.split(':')[2])
+
+
+def failed(msg):
+   print "ERROR: %s" % msg
+   sys.exit(1)
+
+
+def setProperties(sphere, step):
+   # changes all the properties, so that each one is pushed.
+   sphere.Radius = step
+   sphere.ThetaResolution = 8 + step
+   sphere.PhiResolution = 6 + step
+   sphere.Center = [step, 2 * step, 3 * step]
+
+
+def checkSphere(sphere, step, label):
+   sphere.UpdatePipeline()
+   info = sphere.GetDataInformation()
+   # (PhiResolution - 2) * ThetaResolution + 2 poles.
+   numPoints = (4 + step) * (8 + step) + 2
+   if info.GetNumberOfPoints() != numPoints:
+      failed("%s: wrong number of points: %d, expected %d" %
+             (label, info.GetNumberOfPoints(), numPoints))
+   # the poles give the exact bounds along z.
+   bounds = info.GetBounds()
+   if abs(bounds[4] - 2 * step) > 1e-5 or abs(bounds[5] - 4 * step) > 1e-5:
+      failed("%s: wrong bounds: %s" % (label, bounds))
+
+
+def runTest():
+
+    options = servermanager.vtkProcessModule.GetProcessModule().GetOptions()
+    url = options.GetServerURL()
+
+    smp.Connect(getHost(url), getPort(url))
+    session = servermanager.ActiveConnection.Session
+    if not session.IsA("vtkSMSessionClient"):
+        failed("Not connected to a server.")
+
+    sphere = smp.Sphere()
+    sphere.UpdatePipeline()
+
+    # Without a transaction, each push is a message.
+    count = session.GetNumberOfMessagesSent()
+    setProperties(sphere, 2)
+    unbatched = session.GetNumberOfMessagesSent() - count
+    if unbatched < 4:
+        failed("Expected at least 4 messages for 4 pushes, got %d." % unbatched)
+    checkSphere(sphere, 2, "Without transaction")
+
+    # In a transaction, the pushes are sent together when it ends.
+    count = session.GetNumberOfMessagesSent()
+    session.BeginTransaction()
+    try:
+        setProperties(sphere, 3)
+        queued = session.GetNumberOfMessagesSent() - count
+    finally:
+        session.EndTransaction()
+    batched = session.GetNumberOfMessagesSent() - count
+    if queued != 0:
+        failed("%d messages sent before the end of the transaction." % queued)
+    if batched != 1:
+        failed("Expected 1 message for the transaction, got %d." % batched)
+    checkSphere(sphere, 3, "Transaction")
+
+    # A request expecting a reply carries the queued pushes to the server.
+    session.BeginTransaction()
+    try:
+        setProperties(sphere, 4)
+        checkSphere(sphere, 4, "Request in a transaction")
+        count = session.GetNumberOfMessagesSent()
+    finally:
+        session.EndTransaction()
+    if session.GetNumberOfMessagesSent() != count:
+        failed("Requests left queued after a request expecting a reply.")
+
+    # Nested transactions are sent when the outermost one ends.
+    count = session.GetNumberOfMessagesSent()
+    session.BeginTransaction()
+    session.BeginTransaction()
+    setProperties(sphere, 5)
+    session.EndTransaction()
+    if session.GetNumberOfMessagesSent() != count:
+        failed("Nested transaction sent before the outermost one ended.")
+    session.EndTransaction()
+    if session.GetNumberOfMessagesSent() - count != 1:
+        failed("Expected 1 message for nested transactions, got %d." %
+               (session.GetNumberOfMessagesSent() - count))
+    checkSphere(sphere, 5, "Nested transactions")
+
+    smp.Disconnect()
+
+
+runTest()
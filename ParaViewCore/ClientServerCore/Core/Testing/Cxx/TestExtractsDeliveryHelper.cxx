@@ -0,0 +1,235 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestExtractsDeliveryHelper.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Sends an extract from a producer to a consumer helper over a socket and
+// checks that the consumer sees every change, whether the producer sends the
+// extract in full, as a delta or not at all.
+
+#include "vtkBitArray.h"
+#include "vtkCellArray.h"
+#include "vtkDummyController.h"
+#include "vtkExtractsDeliveryHelper.h"
+#include "vtkFloatArray.h"
+#include "vtkMultiThreader.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkServerSocket.h"
+#include "vtkSmartPointer.h"
+#include "vtkSocketCommunicator.h"
+#include "vtkSocketController.h"
+#include "vtkTrivialProducer.h"
+
+#include <iostream>
+
+namespace
+{
+  struct ConnectInfo
+    {
+    vtkSocketController* Controller;
+    int Port;
+    int Result;
+    };
+
+  VTK_THREAD_RETURN_TYPE Connect(void* arg)
+    {
+    ConnectInfo* info = static_cast<ConnectInfo*>(
+      static_cast<vtkMultiThreader::ThreadInfo*>(arg)->UserData);
+    info->Result = info->Controller->ConnectTo("localhost", info->Port);
+    return VTK_THREAD_RETURN_VALUE;
+    }
+
+  // Sends the extracts of the producer, and receives them on the consumer.
+  // The extracts are small enough to fit in the socket buffers, so both sides
+  // can be run one after the other.
+  vtkPolyData* Deliver(vtkExtractsDeliveryHelper* producer,
+    vtkExtractsDeliveryHelper* consumer, vtkTrivialProducer* output)
+    {
+    producer->Update();
+    if (!consumer->Update())
+      {
+      return NULL;
+      }
+    return vtkPolyData::SafeDownCast(output->GetOutputDataObject(0));
+    }
+
+  bool CheckValues(vtkPolyData* received, vtkPolyData* sent)
+    {
+    vtkFloatArray* temperature = vtkFloatArray::SafeDownCast(
+      received->GetPointData()->GetArray("Temperature"));
+    vtkBitArray* mask = vtkBitArray::SafeDownCast(
+      received->GetPointData()->GetArray("Mask"));
+    vtkDataArray* sentTemperature =
+      sent->GetPointData()->GetArray("Temperature");
+    vtkDataArray* sentMask = sent->GetPointData()->GetArray("Mask");
+    if (!temperature || !mask ||
+      received->GetNumberOfPoints() != sent->GetNumberOfPoints() ||
+      received->GetNumberOfCells() != sent->GetNumberOfCells() ||
+      temperature->GetNumberOfTuples() != sent->GetNumberOfPoints() ||
+      mask->GetNumberOfTuples() != sent->GetNumberOfPoints())
+      {
+      return false;
+      }
+    for (vtkIdType cc=0; cc < sent->GetNumberOfPoints(); cc++)
+      {
+      if (temperature->GetValue(cc) != sentTemperature->GetTuple1(cc) ||
+        mask->GetValue(cc) != static_cast<int>(sentMask->GetTuple1(cc)))
+        {
+        return false;
+        }
+      }
+    return true;
+    }
+}
+
+#define TEST_ASSERT(condition, message) \
+  if (!(condition)) \
+    { \
+    std::cerr << "ERROR: " << message << std::endl; \
+    return EXIT_FAILURE; \
+    }
+
+int TestExtractsDeliveryHelper(int , char* [])
+{
+  // A 10x10 grid of quads, with one point array and one bit array. 121 bits
+  // leave a partly used last byte in the bit array.
+  const int resolution = 11;
+  vtkNew<vtkPolyData> extract;
+  vtkNew<vtkPoints> points;
+  vtkNew<vtkCellArray> polys;
+  vtkNew<vtkFloatArray> temperature;
+  vtkNew<vtkBitArray> mask;
+  temperature->SetName("Temperature");
+  mask->SetName("Mask");
+  for (int j=0; j < resolution; j++)
+    {
+    for (int i=0; i < resolution; i++)
+      {
+      points->InsertNextPoint(i, j, 0.0);
+      temperature->InsertNextValue(static_cast<float>(i + j));
+      mask->InsertNextValue((i + j) % 2);
+      if (i > 0 && j > 0)
+        {
+        vtkIdType quad[4] = { (j-1)*resolution + i-1, (j-1)*resolution + i,
+          j*resolution + i, j*resolution + i-1 };
+        polys->InsertNextCell(4, quad);
+        }
+      }
+    }
+  extract->SetPoints(points.GetPointer());
+  extract->SetPolys(polys.GetPointer());
+  extract->GetPointData()->AddArray(temperature.GetPointer());
+  extract->GetPointData()->AddArray(mask.GetPointer());
+
+  // Connect the producer and the consumer.
+  vtkNew<vtkSocketController> producerComm;
+  vtkNew<vtkSocketController> consumerComm;
+  producerComm->Initialize();
+  consumerComm->Initialize();
+  vtkNew<vtkServerSocket> server;
+  TEST_ASSERT(server->CreateServer(0) == 0, "Failed to create a server.");
+  ConnectInfo connectInfo = { consumerComm.GetPointer(),
+    server->GetServerPort(), 0 };
+  vtkNew<vtkMultiThreader> threader;
+  int thread = threader->SpawnThread(Connect, &connectInfo);
+  int accepted = vtkSocketCommunicator::SafeDownCast(
+    producerComm->GetCommunicator())->WaitForConnection(server.GetPointer());
+  threader->TerminateThread(thread);
+  TEST_ASSERT(accepted && connectInfo.Result,
+    "Failed to connect the producer and the consumer.");
+
+  vtkNew<vtkDummyController> parallelController;
+  vtkNew<vtkTrivialProducer> input;
+  input->SetOutput(extract.GetPointer());
+  vtkNew<vtkExtractsDeliveryHelper> producer;
+  producer->SetProcessIsProducer(true);
+  producer->SetNumberOfSimulationProcesses(1);
+  producer->SetNumberOfVisualizationProcesses(1);
+  producer->SetParallelController(parallelController.GetPointer());
+  producer->SetSimulation2VisualizationController(producerComm.GetPointer());
+  producer->AddExtractProducer("extract", input->GetOutputPort());
+
+  vtkNew<vtkTrivialProducer> output;
+  vtkNew<vtkExtractsDeliveryHelper> consumer;
+  consumer->SetProcessIsProducer(false);
+  consumer->SetNumberOfSimulationProcesses(1);
+  consumer->SetNumberOfVisualizationProcesses(1);
+  consumer->SetParallelController(parallelController.GetPointer());
+  consumer->SetSimulation2VisualizationController(consumerComm.GetPointer());
+  consumer->AddExtractConsumer("extract", output.GetPointer());
+
+  // The extracts received are kept, to compare them with the next ones.
+  // The first timestep is sent in full.
+  vtkSmartPointer<vtkPolyData> first = Deliver(producer.GetPointer(),
+    consumer.GetPointer(), output.GetPointer());
+  TEST_ASSERT(first.GetPointer() && CheckValues(first, extract.GetPointer()),
+    "Wrong extract received for the first timestep.");
+
+  // Nothing changed: the consumer keeps its extract.
+  vtkPolyData* unchanged = Deliver(producer.GetPointer(),
+    consumer.GetPointer(), output.GetPointer());
+  TEST_ASSERT(unchanged == first,
+    "An unchanged extract was not reused by the consumer.");
+
+  // A rebuilt but identical array is not sent either.
+  temperature->Modified();
+  unchanged = Deliver(producer.GetPointer(), consumer.GetPointer(),
+    output.GetPointer());
+  TEST_ASSERT(unchanged == first,
+    "An extract with identical values was not reused by the consumer.");
+
+  // Changed values are sent as a delta, on top of the previous topology.
+  for (vtkIdType cc=0; cc < temperature->GetNumberOfTuples(); cc++)
+    {
+    temperature->SetValue(cc, temperature->GetValue(cc) * 2.0f);
+    }
+  temperature->Modified();
+  vtkSmartPointer<vtkPolyData> delta = Deliver(producer.GetPointer(),
+    consumer.GetPointer(), output.GetPointer());
+  TEST_ASSERT(delta.GetPointer() && delta != first &&
+    delta->GetPolys() == first->GetPolys(),
+    "Changed values were not sent as a delta.");
+  TEST_ASSERT(CheckValues(delta, extract.GetPointer()),
+    "Wrong values received in a delta.");
+
+  // The same goes for a bit array, including its last, partial byte.
+  vtkSmartPointer<vtkPolyData> previous = delta;
+  mask->SetValue(resolution * resolution - 1,
+    !mask->GetValue(resolution * resolution - 1));
+  mask->Modified();
+  delta = Deliver(producer.GetPointer(), consumer.GetPointer(),
+    output.GetPointer());
+  TEST_ASSERT(delta.GetPointer() && delta != previous &&
+    delta->GetPolys() == first->GetPolys(),
+    "Changed bits were not sent as a delta.");
+  TEST_ASSERT(CheckValues(delta, extract.GetPointer()),
+    "Wrong bits received in a delta.");
+
+  // A new topology is sent in full.
+  previous = delta;
+  vtkIdType triangle[3] = { 0, 1, resolution };
+  polys->InsertNextCell(3, triangle);
+  polys->GetData()->Modified();
+  vtkPolyData* full = Deliver(producer.GetPointer(), consumer.GetPointer(),
+    output.GetPointer());
+  TEST_ASSERT(full && full->GetPolys() != previous->GetPolys(),
+    "A changed topology was not sent in full.");
+  TEST_ASSERT(CheckValues(full, extract.GetPointer()),
+    "Wrong extract received after a topology change.");
+
+  producerComm->CloseConnection();
+  consumerComm->CloseConnection();
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,264 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestTimeParallelExtractArraysOverTime.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Extracts the same selection over time with the time steps partitioned
+// between the processes and with the data partitioned between them, and
+// checks that both give the same rows on the root process, and that in time
+// parallel mode each process only executes the upstream pipeline for its own
+// time steps.
+
+#include "vtkCommunicator.h"
+#include "vtkCompositeDataIterator.h"
+#include "vtkDataArray.h"
+#include "vtkDataSet.h"
+#include "vtkDoubleArray.h"
+#include "vtkFieldData.h"
+#include "vtkIdTypeArray.h"
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkMPIController.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkPolyDataAlgorithm.h"
+#include "vtkPVExtractArraysOverTime.h"
+#include "vtkSelection.h"
+#include "vtkSelectionNode.h"
+#include "vtkSmartPointer.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkTable.h"
+#include "vtkTrivialProducer.h"
+
+#include <cmath>
+#include <iostream>
+
+namespace
+{
+  const int NumberOfTimeSteps = 10;
+  const int NumberOfPoints = 5;
+
+  // A row of points whose "Value" depends on the time step. The whole dataset
+  // is produced for piece 0, and nothing for the other pieces, so the results
+  // do not depend on the number of processes. The number of executions is
+  // counted to check which time steps are read.
+  class vtkTimeStepsSource : public vtkPolyDataAlgorithm
+  {
+  public:
+    static vtkTimeStepsSource* New();
+    vtkTypeMacro(vtkTimeStepsSource, vtkPolyDataAlgorithm);
+
+    int NumberOfExecutions;
+
+  protected:
+    vtkTimeStepsSource()
+      {
+      this->NumberOfExecutions = 0;
+      this->SetNumberOfInputPorts(0);
+      }
+
+    virtual int RequestInformation(vtkInformation*, vtkInformationVector**,
+      vtkInformationVector* outputVector)
+      {
+      vtkInformation* outInfo = outputVector->GetInformationObject(0);
+      double times[NumberOfTimeSteps];
+      for (int cc=0; cc < NumberOfTimeSteps; cc++)
+        {
+        times[cc] = cc;
+        }
+      double range[2] = { times[0], times[NumberOfTimeSteps - 1] };
+      outInfo->Set(vtkStreamingDemandDrivenPipeline::TIME_STEPS(), times,
+        NumberOfTimeSteps);
+      outInfo->Set(vtkStreamingDemandDrivenPipeline::TIME_RANGE(), range, 2);
+      outInfo->Set(CAN_HANDLE_PIECE_REQUEST(), 1);
+      return 1;
+      }
+
+    virtual int RequestData(vtkInformation*, vtkInformationVector**,
+      vtkInformationVector* outputVector)
+      {
+      vtkInformation* outInfo = outputVector->GetInformationObject(0);
+      vtkPolyData* output = vtkPolyData::GetData(outInfo);
+      this->NumberOfExecutions++;
+      if (outInfo->Get(
+          vtkStreamingDemandDrivenPipeline::UPDATE_PIECE_NUMBER()) != 0)
+        {
+        return 1;
+        }
+      double time = outInfo->Get(
+        vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEP());
+      vtkNew<vtkPoints> points;
+      vtkNew<vtkDoubleArray> values;
+      values->SetName("Value");
+      for (int cc=0; cc < NumberOfPoints; cc++)
+        {
+        points->InsertNextPoint(cc, 0.0, 0.0);
+        values->InsertNextValue(100.0 * time + cc);
+        }
+      output->SetPoints(points.GetPointer());
+      output->GetPointData()->AddArray(values.GetPointer());
+      output->GetInformation()->Set(vtkDataObject::DATA_TIME_STEP(), time);
+      return 1;
+      }
+
+  private:
+    vtkTimeStepsSource(const vtkTimeStepsSource&) VTK_DELETE_FUNCTION;
+    void operator=(const vtkTimeStepsSource&) VTK_DELETE_FUNCTION;
+  };
+  vtkStandardNewMacro(vtkTimeStepsSource);
+
+  vtkFieldData* GetRows(vtkDataObject* block)
+    {
+    if (vtkTable* table = vtkTable::SafeDownCast(block))
+      {
+      return table->GetRowData();
+      }
+    if (vtkDataSet* ds = vtkDataSet::SafeDownCast(block))
+      {
+      return ds->GetPointData();
+      }
+    return NULL;
+    }
+
+  // Returns true if both outputs have the same blocks, with the same arrays
+  // and values.
+  bool CompareOutputs(vtkMultiBlockDataSet* result, vtkMultiBlockDataSet* baseline)
+    {
+    vtkSmartPointer<vtkCompositeDataIterator> iter;
+    iter.TakeReference(baseline->NewIterator());
+    int numberOfBlocks = 0;
+    for (iter->InitTraversal(); !iter->IsDoneWithTraversal();
+      iter->GoToNextItem())
+      {
+      numberOfBlocks++;
+      vtkFieldData* expected = GetRows(iter->GetCurrentDataObject());
+      vtkFieldData* rows = GetRows(result->GetDataSet(iter));
+      if (!expected || !rows ||
+        rows->GetNumberOfArrays() != expected->GetNumberOfArrays())
+        {
+        std::cerr << "Different blocks or arrays." << std::endl;
+        return false;
+        }
+      for (int i=0; i < expected->GetNumberOfArrays(); i++)
+        {
+        vtkDataArray* expectedArray = expected->GetArray(i);
+        if (!expectedArray)
+          {
+          continue;
+          }
+        vtkDataArray* array = rows->GetArray(expectedArray->GetName());
+        if (!array ||
+          array->GetNumberOfTuples() != expectedArray->GetNumberOfTuples() ||
+          array->GetNumberOfComponents() !=
+          expectedArray->GetNumberOfComponents())
+          {
+          std::cerr << "Different array: " << expectedArray->GetName()
+            << std::endl;
+          return false;
+          }
+        for (vtkIdType t=0; t < array->GetNumberOfTuples(); t++)
+          {
+          for (int c=0; c < array->GetNumberOfComponents(); c++)
+            {
+            if (std::fabs(array->GetComponent(t, c) -
+                expectedArray->GetComponent(t, c)) > 1e-9)
+              {
+              std::cerr << "Different value in " << expectedArray->GetName()
+                << " at row " << t << std::endl;
+              return false;
+              }
+            }
+          }
+        }
+      }
+    if (numberOfBlocks == 0)
+      {
+      std::cerr << "Nothing extracted." << std::endl;
+      return false;
+      }
+    return true;
+    }
+
+  // Extracts points 1 and 3 over time, and returns the executions of the
+  // source on this process.
+  int Extract(vtkMultiProcessController* controller, bool timeParallel,
+    vtkMultiBlockDataSet* output)
+    {
+    vtkNew<vtkTimeStepsSource> source;
+
+    vtkNew<vtkSelectionNode> node;
+    node->SetContentType(vtkSelectionNode::INDICES);
+    node->SetFieldType(vtkSelectionNode::POINT);
+    vtkNew<vtkIdTypeArray> ids;
+    ids->InsertNextValue(1);
+    ids->InsertNextValue(3);
+    node->SetSelectionList(ids.GetPointer());
+    vtkNew<vtkSelection> selection;
+    selection->AddNode(node.GetPointer());
+    vtkNew<vtkTrivialProducer> selectionSource;
+    selectionSource->SetOutput(selection.GetPointer());
+
+    vtkNew<vtkPVExtractArraysOverTime> extract;
+    extract->SetController(controller);
+    extract->SetTimeParallel(timeParallel);
+    extract->SetInputConnection(source->GetOutputPort());
+    extract->SetSelectionConnection(selectionSource->GetOutputPort());
+    extract->UpdatePiece(controller->GetLocalProcessId(),
+      controller->GetNumberOfProcesses(), 0);
+    output->ShallowCopy(extract->GetOutputDataObject(0));
+    return source->NumberOfExecutions;
+    }
+}
+
+int TestTimeParallelExtractArraysOverTime(int argc, char* argv[])
+{
+  vtkNew<vtkMPIController> controller;
+  controller->Initialize(&argc, &argv, 0);
+  vtkMultiProcessController::SetGlobalController(controller.GetPointer());
+  int rank = controller->GetLocalProcessId();
+  int numProcs = controller->GetNumberOfProcesses();
+
+  int status = 1;
+  vtkNew<vtkMultiBlockDataSet> baseline;
+  Extract(controller.GetPointer(), false, baseline.GetPointer());
+  vtkNew<vtkMultiBlockDataSet> result;
+  int executions = Extract(controller.GetPointer(), true, result.GetPointer());
+
+  // With several processes, each one reads its own time steps only.
+  int localTimeSteps = NumberOfTimeSteps * (rank + 1) / numProcs -
+    NumberOfTimeSteps * rank / numProcs;
+  if (numProcs > 1 && executions > localTimeSteps)
+    {
+    std::cerr << "Process " << rank << " executed the source " << executions
+      << " times for " << localTimeSteps << " time steps." << std::endl;
+    status = 0;
+    }
+
+  // The rows are gathered on the root process.
+  if (rank == 0 &&
+    !CompareOutputs(result.GetPointer(), baseline.GetPointer()))
+    {
+    std::cerr << "Time parallel and serial extractions differ." << std::endl;
+    status = 0;
+    }
+
+  int globalStatus = 0;
+  controller->AllReduce(&status, &globalStatus, 1, vtkCommunicator::MIN_OP);
+
+  vtkMultiProcessController::SetGlobalController(NULL);
+  controller->Finalize();
+  return globalStatus ? EXIT_SUCCESS : EXIT_FAILURE;
+}
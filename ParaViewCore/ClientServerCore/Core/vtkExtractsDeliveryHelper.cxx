@@ -15,29 +15,342 @@
 #include "vtkExtractsDeliveryHelper.h"
 
 #include "vtkAlgorithmOutput.h"
+#include "vtkCellArray.h"
 #include "vtkCellData.h"
+#include "vtkCharArray.h"
+#include "vtkCommunicator.h"
 #include "vtkCompositeDataSet.h"
 #include "vtkDataObject.h"
 #include "vtkDataObjectTypes.h"
+#include "vtkDataSetAttributes.h"
+#include "vtkIdTypeArray.h"
+#include "vtkImageData.h"
 #include "vtkMultiProcessController.h"
 #include "vtkMultiProcessControllerHelper.h"
 #include "vtkMultiProcessStream.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkQuadricClustering.h"
+#include "vtkRectilinearGrid.h"
 #include "vtkSocketController.h"
 #include "vtkStructuredGrid.h"
+#include "vtkTimerLog.h"
 #include "vtkTrivialProducer.h"
 #include "vtkUnsignedCharArray.h"
+#include "vtkUnstructuredGrid.h"
+#include "vtkZLibDataCompressor.h"
 
+#include <algorithm>
 #include <assert.h>
+#include <cmath>
+#include <set>
+#include <sstream>
+#include <string.h>
+#include <vector>
+
+namespace
+{
+  // How an extract is sent to the consumer.
+  enum
+    {
+    FULL_EXTRACT = 0,
+    DELTA_EXTRACT = 1,
+    UNCHANGED_EXTRACT = 2,
+    SKIPPED_EXTRACT = 3
+    };
+
+  // How the data object of a FULL_EXTRACT or DELTA_EXTRACT is sent.
+  enum
+    {
+    DATA_OBJECT_PAYLOAD = 0,
+    RAW_PAYLOAD = 1,
+    COMPRESSED_PAYLOAD = 2
+    };
+
+  // Parts of a dataset compared between timesteps, besides the arrays which
+  // use the vtkDataObject::FIELD_ASSOCIATION_* values.
+  enum
+    {
+    COORDINATES_PART = -1,
+    TOPOLOGY_PART = -2
+    };
+
+  //--------------------------------------------------------------------------
+  vtkTypeUInt64 HashBytes(const void* data, size_t size, vtkTypeUInt64 hash)
+    {
+    // 64-bit FNV-1a, a word at a time.
+    const vtkTypeUInt64 prime = (static_cast<vtkTypeUInt64>(0x100) << 32) | 0x1b3;
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    size_t cc = 0;
+    for (; cc + sizeof(vtkTypeUInt64) <= size; cc += sizeof(vtkTypeUInt64))
+      {
+      vtkTypeUInt64 word;
+      memcpy(&word, bytes + cc, sizeof(vtkTypeUInt64));
+      hash = (hash ^ word) * prime;
+      hash ^= (hash >> 29);
+      }
+    for (; cc < size; cc++)
+      {
+      hash = (hash ^ bytes[cc]) * prime;
+      }
+    return hash;
+    }
+
+  //--------------------------------------------------------------------------
+  vtkTypeUInt64 HashArray(vtkAbstractArray* array)
+    {
+    vtkTypeUInt64 hash = (static_cast<vtkTypeUInt64>(0xcbf29ce4) << 32) | 0x84222325;
+    if (array == NULL)
+      {
+      return hash;
+      }
+    int header[3] = { array->GetDataType(), array->GetNumberOfComponents(),
+      static_cast<int>(array->GetNumberOfTuples()) };
+    hash = HashBytes(header, sizeof(header), hash);
+    vtkDataArray* da = vtkDataArray::SafeDownCast(array);
+    if (da && da->GetDataType() == VTK_BIT)
+      {
+      // Bits are packed, 8 values per byte. The unused bits of the last
+      // byte are not kept clear, so they are masked out.
+      vtkIdType numValues = da->GetNumberOfValues();
+      const unsigned char* bits =
+        static_cast<const unsigned char*>(da->GetVoidPointer(0));
+      hash = HashBytes(bits, static_cast<size_t>(numValues / 8), hash);
+      if (numValues % 8 != 0)
+        {
+        unsigned char last = static_cast<unsigned char>(bits[numValues / 8] &
+          (0xff << (8 - numValues % 8)));
+        hash = HashBytes(&last, 1, hash);
+        }
+      }
+    else if (da)
+      {
+      hash = HashBytes(da->GetVoidPointer(0),
+        static_cast<size_t>(da->GetNumberOfValues()) * da->GetDataTypeSize(),
+        hash);
+      }
+    else
+      {
+      // Other arrays are only compared by MTime.
+      unsigned long mtime = array->GetMTime();
+      hash = HashBytes(&mtime, sizeof(mtime), hash);
+      }
+    return hash;
+    }
+
+  // A part of a dataset compared between timesteps: an array, the points
+  // coordinates or a part of the topology.
+  struct vtkPart
+    {
+    int Association;
+    std::string Name;
+    vtkAbstractArray* Array;
+    int Attribute;
+    // The hash computed the last time is reused when the MTime and the
+    // attribute did not change. Topology parts without an array are hashed
+    // when listed.
+    unsigned long MTime;
+    bool Hashed;
+    vtkTypeUInt64 Hash;
+    };
+
+  //--------------------------------------------------------------------------
+  void AddPart(std::vector<vtkPart>& parts, int association,
+    const std::string& name, vtkAbstractArray* array, int attribute=-1)
+    {
+    vtkPart part;
+    part.Association = association;
+    part.Name = name;
+    part.Array = array;
+    part.Attribute = attribute;
+    part.MTime = array? array->GetMTime() : 0;
+    part.Hashed = false;
+    part.Hash = 0;
+    parts.push_back(part);
+    }
+
+  //--------------------------------------------------------------------------
+  void AddTopologyPart(std::vector<vtkPart>& parts, const std::string& name,
+    const void* data, size_t size)
+    {
+    vtkPart part;
+    part.Association = TOPOLOGY_PART;
+    part.Name = name;
+    part.Array = NULL;
+    part.Attribute = -1;
+    part.MTime = 0;
+    part.Hashed = true;
+    part.Hash = HashBytes(data, size, 0);
+    parts.push_back(part);
+    }
+
+  //--------------------------------------------------------------------------
+  bool AddArrayParts(std::vector<vtkPart>& parts, vtkFieldData* fd,
+    int association)
+    {
+    vtkDataSetAttributes* dsa = vtkDataSetAttributes::SafeDownCast(fd);
+    std::set<std::string> names;
+    for (int cc=0; cc < fd->GetNumberOfArrays(); cc++)
+      {
+      vtkAbstractArray* array = fd->GetAbstractArray(cc);
+      const char* name = array? array->GetName() : NULL;
+      // Arrays are matched by name between timesteps.
+      if (name == NULL || name[0] == 0 || !names.insert(name).second)
+        {
+        return false;
+        }
+      AddPart(parts, association, name, array,
+        dsa? dsa->IsArrayAnAttribute(cc) : -1);
+      }
+    return true;
+    }
+
+  //--------------------------------------------------------------------------
+  // Lists the parts of a dataset compared between timesteps. Returns false
+  // for the data objects that are always sent in full.
+  bool GetParts(vtkDataObject* dObj, std::vector<vtkPart>& parts)
+    {
+    parts.clear();
+    vtkDataSet* ds = vtkDataSet::SafeDownCast(dObj);
+    if (ds == NULL)
+      {
+      return false;
+      }
+
+    if (vtkPolyData* pd = vtkPolyData::SafeDownCast(ds))
+      {
+      AddPart(parts, TOPOLOGY_PART, "Verts", pd->GetVerts()->GetData());
+      AddPart(parts, TOPOLOGY_PART, "Lines", pd->GetLines()->GetData());
+      AddPart(parts, TOPOLOGY_PART, "Polys", pd->GetPolys()->GetData());
+      AddPart(parts, TOPOLOGY_PART, "Strips", pd->GetStrips()->GetData());
+      }
+    else if (vtkUnstructuredGrid* ug = vtkUnstructuredGrid::SafeDownCast(ds))
+      {
+      AddPart(parts, TOPOLOGY_PART, "Cells",
+        ug->GetCells()? ug->GetCells()->GetData() : NULL);
+      AddPart(parts, TOPOLOGY_PART, "CellTypes", ug->GetCellTypesArray());
+      }
+    else if (vtkStructuredGrid* sg = vtkStructuredGrid::SafeDownCast(ds))
+      {
+      AddTopologyPart(parts, "Extent", sg->GetExtent(), 6 * sizeof(int));
+      }
+    else if (vtkRectilinearGrid* rg = vtkRectilinearGrid::SafeDownCast(ds))
+      {
+      AddTopologyPart(parts, "Extent", rg->GetExtent(), 6 * sizeof(int));
+      AddPart(parts, TOPOLOGY_PART, "XCoordinates", rg->GetXCoordinates());
+      AddPart(parts, TOPOLOGY_PART, "YCoordinates", rg->GetYCoordinates());
+      AddPart(parts, TOPOLOGY_PART, "ZCoordinates", rg->GetZCoordinates());
+      }
+    else if (vtkImageData* id = vtkImageData::SafeDownCast(ds))
+      {
+      double geometry[6];
+      id->GetOrigin(geometry);
+      id->GetSpacing(geometry + 3);
+      AddTopologyPart(parts, "Extent", id->GetExtent(), 6 * sizeof(int));
+      AddTopologyPart(parts, "Geometry", geometry, sizeof(geometry));
+      }
+    else
+      {
+      return false;
+      }
+    // Subclasses of the types above may have more to them.
+    const char* classname = ds->GetClassName();
+    AddTopologyPart(parts, "ClassName", classname, strlen(classname));
+
+    if (vtkPointSet* ps = vtkPointSet::SafeDownCast(ds))
+      {
+      AddPart(parts, COORDINATES_PART, "Points",
+        ps->GetPoints()? ps->GetPoints()->GetData() : NULL);
+      }
+    return AddArrayParts(parts, ds->GetPointData(),
+      vtkDataObject::FIELD_ASSOCIATION_POINTS) &&
+      AddArrayParts(parts, ds->GetCellData(),
+        vtkDataObject::FIELD_ASSOCIATION_CELLS) &&
+      AddArrayParts(parts, ds->GetFieldData(),
+        vtkDataObject::FIELD_ASSOCIATION_NONE);
+    }
+
+  //--------------------------------------------------------------------------
+  vtkFieldData* GetFieldData(vtkDataSet* ds, int association)
+    {
+    switch (association)
+      {
+    case vtkDataObject::FIELD_ASSOCIATION_POINTS:
+      return ds->GetPointData();
+    case vtkDataObject::FIELD_ASSOCIATION_CELLS:
+      return ds->GetCellData();
+    default:
+      return ds->GetFieldData();
+      }
+    }
+}
+
+class vtkExtractsDeliveryHelper::vtkInternals
+{
+public:
+  struct vtkSentPart
+    {
+    unsigned long MTime;
+    int Attribute;
+    vtkTypeUInt64 Hash;
+    };
+  typedef std::pair<int, std::string> PartKey;
+  typedef std::map<PartKey, vtkSentPart> PartsType;
+
+  // What was sent for each extract, on the producer side.
+  std::map<std::string, PartsType> SentExtracts;
+
+  // The extracts received, on the consumer side. Delta-encoded extracts are
+  // applied to these.
+  std::map<std::string, vtkSmartPointer<vtkDataObject> > ReceivedExtracts;
+
+  // Bytes that can be sent before going over the MaximumBandwidth, and when
+  // it was last updated.
+  double Budget;
+  double BudgetTime;
+
+  vtkInternals() : Budget(0), BudgetTime(-1) {}
+
+  // Serializes the data object into the bytes sent to the consumer.
+  static vtkSmartPointer<vtkDataArray> Pack(vtkDataObject* dObj, bool compress,
+    int& payloadType, vtkTypeUInt64& size)
+    {
+    vtkSmartPointer<vtkCharArray> buffer = vtkSmartPointer<vtkCharArray>::New();
+    vtkCommunicator::MarshalDataObject(dObj, buffer);
+    size = static_cast<vtkTypeUInt64>(buffer->GetNumberOfTuples());
+    if (compress && size > 0)
+      {
+      vtkNew<vtkZLibDataCompressor> compressor;
+      // Favor speed, the simulation waits for the compression.
+      compressor->SetCompressionLevel(1);
+      vtkSmartPointer<vtkUnsignedCharArray> compressed;
+      compressed.TakeReference(compressor->Compress(
+        reinterpret_cast<unsigned char*>(buffer->GetPointer(0)), size));
+      if (compressed.GetPointer() && compressed->GetNumberOfTuples() > 0)
+        {
+        payloadType = COMPRESSED_PAYLOAD;
+        return compressed;
+        }
+      }
+    payloadType = RAW_PAYLOAD;
+    return buffer;
+    }
+};
 
 vtkStandardNewMacro(vtkExtractsDeliveryHelper);
 //----------------------------------------------------------------------------
 vtkExtractsDeliveryHelper::vtkExtractsDeliveryHelper() :
   ProcessIsProducer(true),
   NumberOfSimulationProcesses(0),
-  NumberOfVisualizationProcesses(0)
+  NumberOfVisualizationProcesses(0),
+  DeltaEncoding(true),
+  Compression(true),
+  MaximumBandwidth(0.0)
 {
+  this->Internals = new vtkInternals();
   this->SetParallelController(
     vtkMultiProcessController::GetGlobalController());
 }
@@ -45,6 +358,8 @@ vtkExtractsDeliveryHelper::vtkExtractsDeliveryHelper() :
 //----------------------------------------------------------------------------
 vtkExtractsDeliveryHelper::~vtkExtractsDeliveryHelper()
 {
+  delete this->Internals;
+  this->Internals = NULL;
 }
 
 //----------------------------------------------------------------------------
@@ -156,6 +471,362 @@ vtkDataObject* vtkExtractsDeliveryHelper::Collect(
     }
 }
 
+//----------------------------------------------------------------------------
+void vtkExtractsDeliveryHelper::SendExtract(
+  const std::string& key, vtkDataObject* dObj)
+{
+  vtkSocketController* comm = this->Simulation2VisualizationController;
+  vtkInternals& internals = *this->Internals;
+
+  // Compare the extract with what was sent the last time.
+  std::vector<vtkPart> parts;
+  bool deltaEncodable =
+    this->DeltaEncoding && dObj != NULL && GetParts(dObj, parts);
+  std::map<std::string, vtkInternals::PartsType>::iterator sent =
+    internals.SentExtracts.find(key);
+  for (size_t cc=0; deltaEncodable && cc < parts.size(); cc++)
+    {
+    vtkPart& part = parts[cc];
+    if (part.Hashed)
+      {
+      continue;
+      }
+    if (sent != internals.SentExtracts.end() && part.MTime != 0)
+      {
+      vtkInternals::PartsType::iterator previous = sent->second.find(
+        vtkInternals::PartKey(part.Association, part.Name));
+      if (previous != sent->second.end() &&
+        previous->second.MTime == part.MTime &&
+        previous->second.Attribute == part.Attribute)
+        {
+        part.Hash = previous->second.Hash;
+        continue;
+        }
+      }
+    part.Hash = HashBytes(&part.Attribute, sizeof(int), HashArray(part.Array));
+    }
+
+  int mode = FULL_EXTRACT;
+  std::vector<size_t> changed;
+  std::vector<vtkInternals::PartKey> removed;
+  if (deltaEncodable && sent != internals.SentExtracts.end())
+    {
+    bool topologyChanged = false;
+    std::set<vtkInternals::PartKey> current;
+    for (size_t cc=0; cc < parts.size() && !topologyChanged; cc++)
+      {
+      vtkInternals::PartKey partKey(parts[cc].Association, parts[cc].Name);
+      current.insert(partKey);
+      vtkInternals::PartsType::iterator previous = sent->second.find(partKey);
+      if (previous == sent->second.end() ||
+        previous->second.Hash != parts[cc].Hash)
+        {
+        if (parts[cc].Association == TOPOLOGY_PART || parts[cc].Array == NULL)
+          {
+          topologyChanged = true;
+          }
+        changed.push_back(cc);
+        }
+      }
+    for (vtkInternals::PartsType::iterator previous = sent->second.begin();
+      previous != sent->second.end() && !topologyChanged; ++previous)
+      {
+      if (current.find(previous->first) == current.end())
+        {
+        topologyChanged = (previous->first.first == TOPOLOGY_PART);
+        removed.push_back(previous->first);
+        }
+      }
+    if (!topologyChanged)
+      {
+      mode = (changed.empty() && removed.empty())?
+        UNCHANGED_EXTRACT : DELTA_EXTRACT;
+      }
+    }
+
+  // The data object to send: the extract itself or, for a delta, the
+  // changed arrays in the field data of a vtkPolyData.
+  vtkSmartPointer<vtkDataObject> payload = dObj;
+  if (mode == DELTA_EXTRACT)
+    {
+    vtkNew<vtkPolyData> delta;
+    for (size_t cc=0; cc < changed.size(); cc++)
+      {
+      vtkAbstractArray* array = parts[changed[cc]].Array;
+      vtkSmartPointer<vtkAbstractArray> copy;
+      copy.TakeReference(array->NewInstance());
+      if (vtkDataArray::SafeDownCast(array))
+        {
+        vtkDataArray::SafeDownCast(copy)->ShallowCopy(
+          vtkDataArray::SafeDownCast(array));
+        }
+      else
+        {
+        copy->DeepCopy(array);
+        }
+      // Arrays are matched by their index: the names may not be unique
+      // across the point, cell and field data.
+      std::ostringstream name;
+      name << cc;
+      copy->SetName(name.str().c_str());
+      delta->GetFieldData()->AddArray(copy);
+      }
+    payload = delta.GetPointer();
+    }
+
+  int payloadType = DATA_OBJECT_PAYLOAD;
+  vtkTypeUInt64 size = 0;
+  vtkSmartPointer<vtkDataArray> bytes;
+  bool limited = this->MaximumBandwidth > 0.0;
+  const double capacity = this->MaximumBandwidth * 1024.0 * 1024.0;
+  if (vtkDataSet::SafeDownCast(payload) && (this->Compression || limited))
+    {
+    bytes = vtkInternals::Pack(payload, this->Compression, payloadType, size);
+    }
+
+  bool decimated = false;
+  if (limited && (mode == FULL_EXTRACT || mode == DELTA_EXTRACT))
+    {
+    double length = bytes.GetPointer()?
+      static_cast<double>(bytes->GetNumberOfTuples()) :
+      (payload? 1024.0 * payload->GetActualMemorySize() : 0.0);
+    vtkPolyData* pd = vtkPolyData::SafeDownCast(dObj);
+    if (length > internals.Budget && mode == FULL_EXTRACT &&
+      internals.Budget > 0.0 && pd && pd->GetNumberOfCells() > 0)
+      {
+      // Decimate so that the extract fits in the budget. Extracts are mostly
+      // surfaces, so the number of points goes with the square of the
+      // number of divisions.
+      int divisions = static_cast<int>(std::sqrt(
+        pd->GetNumberOfPoints() * internals.Budget / length));
+      divisions = std::max(2, std::min(divisions, 1024));
+      vtkNew<vtkQuadricClustering> decimator;
+      decimator->SetUseInputPoints(1);
+      decimator->SetCopyCellData(1);
+      decimator->SetUseInternalTriangles(0);
+      decimator->SetNumberOfDivisions(divisions, divisions, divisions);
+      decimator->SetInputData(pd);
+      decimator->Update();
+      payload = decimator->GetOutput();
+      bytes = vtkInternals::Pack(payload, this->Compression, payloadType, size);
+      length = static_cast<double>(bytes->GetNumberOfTuples());
+      decimated = true;
+      }
+    // Send when it fits in the budget, or once the budget is full so that
+    // large extracts still go through at the maximum bandwidth.
+    if (length > internals.Budget && internals.Budget < capacity)
+      {
+      mode = SKIPPED_EXTRACT;
+      }
+    else
+      {
+      internals.Budget -= length;
+      }
+    }
+
+  vtkMultiProcessStream stream;
+  stream << key << mode;
+  if (mode == DELTA_EXTRACT)
+    {
+    stream << static_cast<int>(changed.size());
+    for (size_t cc=0; cc < changed.size(); cc++)
+      {
+      const vtkPart& part = parts[changed[cc]];
+      stream << part.Association << part.Name << part.Attribute;
+      }
+    stream << static_cast<int>(removed.size());
+    for (size_t cc=0; cc < removed.size(); cc++)
+      {
+      stream << removed[cc].first << removed[cc].second;
+      }
+    }
+  if (mode == FULL_EXTRACT || mode == DELTA_EXTRACT)
+    {
+    stream << payloadType;
+    if (payloadType != DATA_OBJECT_PAYLOAD)
+      {
+      stream << std::string(payload->GetClassName()) << size
+        << static_cast<vtkTypeUInt64>(bytes->GetNumberOfTuples());
+      }
+    }
+  comm->Send(stream, 1, 12000);
+  if (mode == FULL_EXTRACT || mode == DELTA_EXTRACT)
+    {
+    if (payloadType == DATA_OBJECT_PAYLOAD)
+      {
+      comm->Send(payload, 1, 12001);
+      }
+    else
+      {
+      comm->Send(static_cast<char*>(bytes->GetVoidPointer(0)),
+        bytes->GetNumberOfTuples(), 1, 12001);
+      }
+    }
+
+  // Remember what the consumer has, to send the next timestep as a delta.
+  if (mode == SKIPPED_EXTRACT)
+    {
+    return;
+    }
+  if (!deltaEncodable || decimated)
+    {
+    internals.SentExtracts.erase(key);
+    return;
+    }
+  vtkInternals::PartsType& sentParts = internals.SentExtracts[key];
+  sentParts.clear();
+  for (size_t cc=0; cc < parts.size(); cc++)
+    {
+    vtkInternals::vtkSentPart& sentPart = sentParts[
+      vtkInternals::PartKey(parts[cc].Association, parts[cc].Name)];
+    sentPart.MTime = parts[cc].MTime;
+    sentPart.Attribute = parts[cc].Attribute;
+    sentPart.Hash = parts[cc].Hash;
+    }
+}
+
+//----------------------------------------------------------------------------
+vtkDataObject* vtkExtractsDeliveryHelper::ReceiveExtract(std::string& key)
+{
+  vtkSocketController* comm = this->Simulation2VisualizationController;
+  vtkMultiProcessStream stream;
+  comm->Receive(stream, 1, 12000);
+  stream >> key;
+  if (key == "null")
+    {
+    return NULL;
+    }
+
+  int mode;
+  stream >> mode;
+  vtkSmartPointer<vtkDataObject>& received =
+    this->Internals->ReceivedExtracts[key];
+  if (mode == UNCHANGED_EXTRACT || mode == SKIPPED_EXTRACT)
+    {
+    // Keep the extract received the last time, if any.
+    if (received)
+      {
+      received->Register(this);
+      }
+    return received;
+    }
+
+  std::vector<int> associations, attributes;
+  std::vector<std::string> names;
+  std::vector<std::pair<int, std::string> > removed;
+  if (mode == DELTA_EXTRACT)
+    {
+    int count;
+    stream >> count;
+    associations.resize(count);
+    attributes.resize(count);
+    names.resize(count);
+    for (int cc=0; cc < count; cc++)
+      {
+      stream >> associations[cc] >> names[cc] >> attributes[cc];
+      }
+    stream >> count;
+    removed.resize(count);
+    for (int cc=0; cc < count; cc++)
+      {
+      stream >> removed[cc].first >> removed[cc].second;
+      }
+    }
+
+  int payloadType;
+  stream >> payloadType;
+  vtkSmartPointer<vtkDataObject> payload;
+  if (payloadType == DATA_OBJECT_PAYLOAD)
+    {
+    payload.TakeReference(comm->ReceiveDataObject(1, 12001));
+    }
+  else
+    {
+    std::string classname;
+    vtkTypeUInt64 size, length;
+    stream >> classname >> size >> length;
+    vtkNew<vtkCharArray> buffer;
+    buffer->SetNumberOfTuples(static_cast<vtkIdType>(length));
+    comm->Receive(buffer->GetPointer(0), static_cast<vtkIdType>(length),
+      1, 12001);
+    if (payloadType == COMPRESSED_PAYLOAD)
+      {
+      vtkNew<vtkCharArray> uncompressed;
+      uncompressed->SetNumberOfTuples(static_cast<vtkIdType>(size));
+      vtkNew<vtkZLibDataCompressor> compressor;
+      if (compressor->Uncompress(
+          reinterpret_cast<unsigned char*>(buffer->GetPointer(0)), length,
+          reinterpret_cast<unsigned char*>(uncompressed->GetPointer(0)),
+          size) != size)
+        {
+        vtkErrorMacro("Failed to uncompress extract " << key.c_str() << ".");
+        return NULL;
+        }
+      buffer->ShallowCopy(uncompressed.GetPointer());
+      }
+    payload.TakeReference(vtkDataObjectTypes::NewDataObject(classname.c_str()));
+    if (!payload ||
+      !vtkCommunicator::UnMarshalDataObject(buffer.GetPointer(), payload))
+      {
+      vtkErrorMacro("Failed to read extract " << key.c_str() << ".");
+      return NULL;
+      }
+    }
+
+  if (mode == FULL_EXTRACT)
+    {
+    received = payload;
+    }
+  else
+    {
+    vtkDataSet* previous = vtkDataSet::SafeDownCast(received);
+    if (!previous || !payload)
+      {
+      vtkErrorMacro("Received changes for extract " << key.c_str()
+        << " without the extract.");
+      return NULL;
+      }
+    // Reuse the topology and the unchanged arrays of the previous extract.
+    vtkDataSet* ds = previous->NewInstance();
+    ds->ShallowCopy(previous);
+    vtkFieldData* arrays = payload->GetFieldData();
+    for (size_t cc=0; cc < names.size(); cc++)
+      {
+      vtkAbstractArray* array = arrays->GetAbstractArray(static_cast<int>(cc));
+      array->SetName(names[cc].c_str());
+      if (associations[cc] == COORDINATES_PART)
+        {
+        vtkNew<vtkPoints> points;
+        points->SetData(vtkDataArray::SafeDownCast(array));
+        vtkPointSet::SafeDownCast(ds)->SetPoints(points.GetPointer());
+        continue;
+        }
+      vtkFieldData* fd = GetFieldData(ds, associations[cc]);
+      fd->RemoveArray(names[cc].c_str());
+      vtkDataSetAttributes* dsa = vtkDataSetAttributes::SafeDownCast(fd);
+      if (dsa && attributes[cc] >= 0)
+        {
+        dsa->SetAttribute(array, attributes[cc]);
+        }
+      else
+        {
+        fd->AddArray(array);
+        }
+      }
+    for (size_t cc=0; cc < removed.size(); cc++)
+      {
+      GetFieldData(ds, removed[cc].first)->RemoveArray(
+        removed[cc].second.c_str());
+      }
+    received.TakeReference(ds);
+    }
+  if (received)
+    {
+    received->Register(this);
+    }
+  return received;
+}
+
 //----------------------------------------------------------------------------
 bool vtkExtractsDeliveryHelper::Update()
 {
@@ -206,16 +877,43 @@ bool vtkExtractsDeliveryHelper::Update()
     vtkSocketController* comm = this->Simulation2VisualizationController;
     if (comm)
       {
+      if (this->MaximumBandwidth > 0.0)
+        {
+        // Refill the budget, up to a second worth of bandwidth.
+        double capacity = this->MaximumBandwidth * 1024.0 * 1024.0;
+        double now = vtkTimerLog::GetUniversalTime();
+        double& budget = this->Internals->Budget;
+        budget = (this->Internals->BudgetTime < 0.0)? capacity :
+          std::min(capacity,
+            budget + capacity * (now - this->Internals->BudgetTime));
+        this->Internals->BudgetTime = now;
+        }
+
       for (ExtractProducersType::iterator iter = this->ExtractProducers.begin();
         iter != this->ExtractProducers.end(); ++iter)
         {
-        vtkMultiProcessStream stream;
-        stream << iter->first;
-        comm->Send(stream, 1, 12000);
         vtkDataObject* dObj = (M > N)?  gathered_extracts[iter->first].GetPointer() :
           iter->second->GetProducer()->GetOutputDataObject(iter->second->GetIndex());
-        comm->Send(dObj, 1, 12001);
+        this->SendExtract(iter->first, dObj);
         }
+
+      // Forget the extracts that are not requested anymore, the consumer
+      // does the same.
+      std::map<std::string, vtkInternals::PartsType>::iterator sent =
+        this->Internals->SentExtracts.begin();
+      while (sent != this->Internals->SentExtracts.end())
+        {
+        if (this->ExtractProducers.find(sent->first) ==
+          this->ExtractProducers.end())
+          {
+          this->Internals->SentExtracts.erase(sent++);
+          }
+        else
+          {
+          ++sent;
+          }
+        }
+
       // mark end.
       vtkMultiProcessStream stream;
       stream << std::string("null");
@@ -229,19 +927,24 @@ bool vtkExtractsDeliveryHelper::Update()
       {
       std::vector<vtkSmartPointer<vtkCompositeDataSet> > compositeDSToShare;
       vtkMultiProcessStream data_types_stream;
+      std::set<std::string> receivedKeys;
       while (true)
         {
         int needToShare = 0;
         std::string key;
-        vtkMultiProcessStream stream;
-        comm->Receive(stream, 1, 12000);
-        stream >> key;
+        vtkSmartPointer<vtkDataObject> extract;
+        extract.TakeReference(this->ReceiveExtract(key));
         if (key == "null")
           {
           break;
           }
+        receivedKeys.insert(key);
+        if (!extract)
+          {
+          // Nothing was received for this extract yet.
+          continue;
+          }
 //        cout << "Received extract for: " << key.c_str() << endl;
-        vtkDataObject* extract = comm->ReceiveDataObject(1, 12001);
         ExtractConsumersType::iterator iter;
         iter = this->ExtractConsumers.find(key);
         if (iter != this->ExtractConsumers.end())
@@ -268,9 +971,23 @@ bool vtkExtractsDeliveryHelper::Update()
           needToShare = 1;
           }
         data_types_stream << key.c_str() << extract->GetClassName() << needToShare;
-        extract->Delete();
         }
       data_types_stream << "null";
+
+      // Forget the extracts the producer does not send anymore.
+      std::map<std::string, vtkSmartPointer<vtkDataObject> >::iterator
+        received = this->Internals->ReceivedExtracts.begin();
+      while (received != this->Internals->ReceivedExtracts.end())
+        {
+        if (receivedKeys.find(received->first) == receivedKeys.end())
+          {
+          this->Internals->ReceivedExtracts.erase(received++);
+          }
+        else
+          {
+          ++received;
+          }
+        }
       this->ParallelController->Broadcast(data_types_stream, 0);
 
       // Send the empty data object that need to share its structure
@@ -332,4 +1049,7 @@ bool vtkExtractsDeliveryHelper::Update()
 void vtkExtractsDeliveryHelper::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "DeltaEncoding: " << this->DeltaEncoding << endl;
+  os << indent << "Compression: " << this->Compression << endl;
+  os << indent << "MaximumBandwidth: " << this->MaximumBandwidth << endl;
 }
@@ -68,15 +68,53 @@ public:
   vtkSetMacro(NumberOfSimulationProcesses, int);
   vtkGetMacro(NumberOfSimulationProcesses, int);
 
+  // Description:
+  // When set, extracts that are vtkDataSets are sent as the difference with
+  // the extract sent for the previous timestep: only the arrays that changed
+  // are sent and the consumer reuses its copy of the topology. Arrays whose
+  // MTime did not change are not looked at, the others are compared by
+  // content. Extracts are sent in full when their topology changes. Only used
+  // on the producer side. Default is true.
+  vtkSetMacro(DeltaEncoding, bool);
+  vtkGetMacro(DeltaEncoding, bool);
+  vtkBooleanMacro(DeltaEncoding, bool);
+
+  // Description:
+  // When set, extracts that are vtkDataSets are compressed with zlib before
+  // being sent. Only used on the producer side. Default is true.
+  vtkSetMacro(Compression, bool);
+  vtkGetMacro(Compression, bool);
+  vtkBooleanMacro(Compression, bool);
+
+  // Description:
+  // Maximum bandwidth, in megabytes per second, to use to send the extracts
+  // over each simulation to visualization connection. An extract that does
+  // not fit in the bandwidth left is decimated (polygonal data) or skipped
+  // for this timestep, the consumer then keeps the previous one, so that
+  // the simulation never waits for the network. 0 means no limit, which is
+  // the default. Only used on the producer side.
+  vtkSetClampMacro(MaximumBandwidth, double, 0.0, VTK_DOUBLE_MAX);
+  vtkGetMacro(MaximumBandwidth, double);
+
 protected:
   vtkExtractsDeliveryHelper();
   ~vtkExtractsDeliveryHelper();
 
   vtkDataObject* Collect(int nodes_to_collect_to, vtkDataObject*);
 
+  // Description:
+  // Sends an extract to the consumer and receives one from the producer.
+  // ReceiveExtract() returns a new reference, or NULL if the producer did not
+  // send any data for this extract yet.
+  void SendExtract(const std::string& key, vtkDataObject* dObj);
+  vtkDataObject* ReceiveExtract(std::string& key);
+
   bool ProcessIsProducer;
   int NumberOfSimulationProcesses;
   int NumberOfVisualizationProcesses;
+  bool DeltaEncoding;
+  bool Compression;
+  double MaximumBandwidth;
 
   // the bool is to keep track of whether the trivial producer has had
   // its output set yet. we don't want to update the pipeline until
@@ -94,6 +132,9 @@ protected:
   vtkSmartPointer<vtkMultiProcessController> ParallelController;
 
 private:
+  class vtkInternals;
+  vtkInternals* Internals;
+
   vtkExtractsDeliveryHelper(const vtkExtractsDeliveryHelper&) VTK_DELETE_FUNCTION;
   void operator=(const vtkExtractsDeliveryHelper&) VTK_DELETE_FUNCTION;
 
@@ -14,9 +14,15 @@
 =========================================================================*/
 #include "vtkPVExtractArraysOverTime.h"
 
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkMultiProcessController.h"
 #include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPVExtractSelection.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
+
+#include <algorithm>
 
 vtkStandardNewMacro(vtkPVExtractArraysOverTime);
 
@@ -25,6 +31,7 @@ vtkPVExtractArraysOverTime::vtkPVExtractArraysOverTime()
 {
   vtkNew<vtkPVExtractSelection> se;
   this->SetSelectionExtractor(se.GetPointer());
+  this->TimeParallel = false;
 }
 
 //----------------------------------------------------------------------------
@@ -32,8 +39,96 @@ vtkPVExtractArraysOverTime::~vtkPVExtractArraysOverTime()
 {
 }
 
+//----------------------------------------------------------------------------
+bool vtkPVExtractArraysOverTime::GetLocalTimeSteps(int& begin, int& end)
+{
+  int numProcs = this->Controller ?
+    this->Controller->GetNumberOfProcesses() : 1;
+  if (!this->TimeParallel || numProcs <= 1 || this->NumberOfTimeSteps <= 0)
+    {
+    return false;
+    }
+  int procId = this->Controller->GetLocalProcessId();
+  // contiguous ranges, so that readers caching consecutive time steps help.
+  begin = static_cast<int>(
+    static_cast<vtkIdType>(this->NumberOfTimeSteps) * procId / numProcs);
+  end = static_cast<int>(
+    static_cast<vtkIdType>(this->NumberOfTimeSteps) * (procId + 1) / numProcs);
+  return true;
+}
+
+//----------------------------------------------------------------------------
+int vtkPVExtractArraysOverTime::RequestUpdateExtent(
+  vtkInformation* request,
+  vtkInformationVector** inputVector,
+  vtkInformationVector* outputVector)
+{
+  if (!this->Superclass::RequestUpdateExtent(request, inputVector, outputVector))
+    {
+    return 0;
+    }
+
+  int begin, end;
+  if (!this->GetLocalTimeSteps(begin, end))
+    {
+    return 1;
+    }
+
+  vtkInformation* inInfo = inputVector[0]->GetInformationObject(0);
+  inInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_PIECE_NUMBER(), 0);
+  inInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_NUMBER_OF_PIECES(), 1);
+  inInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_NUMBER_OF_GHOST_LEVELS(), 0);
+
+  // For the time steps of the other processes, request the closest time step
+  // of this process: the input is then already up to date and the upstream
+  // pipeline does not execute.
+  double* inTimes = inInfo->Get(vtkStreamingDemandDrivenPipeline::TIME_STEPS());
+  if (inTimes && (this->CurrentTimeIndex < begin || this->CurrentTimeIndex >= end))
+    {
+    int index = this->CurrentTimeIndex < begin ? begin : end - 1;
+    index = std::max(0, std::min(index, this->NumberOfTimeSteps - 1));
+    inInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEP(),
+      inTimes[index]);
+    }
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkPVExtractArraysOverTime::RequestData(
+  vtkInformation* request,
+  vtkInformationVector** inputVector,
+  vtkInformationVector* outputVector)
+{
+  int begin, end;
+  if (!this->GetLocalTimeSteps(begin, end) ||
+    (this->CurrentTimeIndex >= begin && this->CurrentTimeIndex < end))
+    {
+    return this->Superclass::RequestData(request, inputVector, outputVector);
+    }
+
+  // This time step is extracted by another process: skip it, and only advance
+  // the time loop of the superclass. Its rows stay invalid here, and are
+  // filled with those of the other process when the results are gathered in
+  // PostExecute().
+  if (this->CurrentTimeIndex == 0)
+    {
+    request->Set(vtkStreamingDemandDrivenPipeline::CONTINUE_EXECUTING(), 1);
+    }
+  this->CurrentTimeIndex++;
+  this->UpdateProgress(
+    static_cast<double>(this->CurrentTimeIndex) / this->NumberOfTimeSteps);
+  if (this->CurrentTimeIndex == this->NumberOfTimeSteps)
+    {
+    this->PostExecute(request, inputVector, outputVector);
+    request->Remove(vtkStreamingDemandDrivenPipeline::CONTINUE_EXECUTING());
+    this->CurrentTimeIndex = 0;
+    }
+  return 1;
+}
+
 //----------------------------------------------------------------------------
 void vtkPVExtractArraysOverTime::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os,indent);
+  os << indent << "TimeParallel: " << this->TimeParallel << endl;
 }
@@ -18,6 +18,16 @@
 // that overrides the default SelectionExtractor with a vtkPVExtractSelection
 // instance.
 // This enables query selections to be extracted at each time step.
+//
+// By default, each process executes the upstream pipeline for every time step
+// on its piece of the data. When TimeParallel is on, the time steps are
+// instead partitioned between the processes: each process requests the whole
+// dataset (piece 0 of 1) and executes the upstream pipeline only for its own
+// time steps, and the rows of all the time steps are then gathered on the
+// root process. This requires an upstream pipeline that each process can
+// execute independently (i.e. readers that do not need all the processes to
+// read collectively), and a selection that does not depend on the
+// distribution of the data (i.e. not ids with process ids).
 // .SECTION See Also
 // vtkExtractArraysOverTime
 // vtkPExtractArraysOverTime
@@ -35,10 +45,32 @@ public:
   vtkTypeMacro(vtkPVExtractArraysOverTime,vtkPExtractArraysOverTime);
   void PrintSelf(ostream& os, vtkIndent indent);
 
+  // Description:
+  // When on, partition the time steps between the processes instead of
+  // partitioning the data. Default is off.
+  vtkSetMacro(TimeParallel, bool);
+  vtkGetMacro(TimeParallel, bool);
+  vtkBooleanMacro(TimeParallel, bool);
+
 protected:
   vtkPVExtractArraysOverTime();
   ~vtkPVExtractArraysOverTime();
 
+  virtual int RequestUpdateExtent(vtkInformation* request,
+                                  vtkInformationVector** inputVector,
+                                  vtkInformationVector* outputVector);
+  virtual int RequestData(vtkInformation* request,
+                          vtkInformationVector** inputVector,
+                          vtkInformationVector* outputVector);
+
+  // Description:
+  // Returns true if the time steps are partitioned between the processes,
+  // in which case the range of time step indices [begin, end) of this
+  // process is returned.
+  bool GetLocalTimeSteps(int& begin, int& end);
+
+  bool TimeParallel;
+
 private:
   vtkPVExtractArraysOverTime(const vtkPVExtractArraysOverTime&) VTK_DELETE_FUNCTION;
   void operator=(const vtkPVExtractArraysOverTime&) VTK_DELETE_FUNCTION;
@@ -0,0 +1,970 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkPVQueryEvaluator.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkPVQueryEvaluator.h"
+
+#include "vtkCommunicator.h"
+#include "vtkCompositeDataIterator.h"
+#include "vtkCompositeDataSet.h"
+#include "vtkDataArray.h"
+#include "vtkDataSetAttributes.h"
+#include "vtkFieldData.h"
+#include "vtkMath.h"
+#include "vtkMultiProcessController.h"
+#include "vtkObjectFactory.h"
+#include "vtkSignedCharArray.h"
+#include "vtkSmartPointer.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace
+{
+  enum NodeTypes
+    {
+    NUMBER,
+    FIELD,
+    AGGREGATE,
+    NEGATE,
+    ABSOLUTE,
+    NOT,
+    ADD,
+    SUBTRACT,
+    MULTIPLY,
+    AND,
+    OR,
+    LESS,
+    LESS_EQUAL,
+    GREATER,
+    GREATER_EQUAL,
+    EQUAL,
+    NOT_EQUAL
+    };
+
+  enum Functions
+    {
+    MIN,
+    MAX,
+    MEAN
+    };
+
+  // Component of a FIELD node when not a single component.
+  enum
+    {
+    SCALAR = -1,
+    MAGNITUDE = -2
+    };
+
+  struct vtkQueryNode
+    {
+    int Type;
+    bool Boolean;
+    // Value of NUMBER nodes, and of AGGREGATE nodes once reduced.
+    double Value;
+    int Function;
+    std::string Name;
+    int Component;
+    int Children[2];
+    };
+
+  //--------------------------------------------------------------------------
+  enum TokenTypes
+    {
+    END_TOKEN,
+    NAME_TOKEN,
+    NUMBER_TOKEN,
+    OPERATOR_TOKEN
+    };
+
+  struct vtkQueryToken
+    {
+    int Type;
+    std::string Text;
+    double Number;
+    };
+
+  bool Tokenize(const char* query, std::vector<vtkQueryToken>& tokens)
+    {
+    static const char* operators[] = { "==", "!=", "<=", ">=", "<", ">", "&",
+      "|", "~", "+", "-", "*", "(", ")", "[", "]", ",", ":", NULL };
+    const char* cur = query;
+    while (*cur)
+      {
+      if (isspace(*cur))
+        {
+        ++cur;
+        continue;
+        }
+      vtkQueryToken token;
+      token.Number = 0;
+      if (isalpha(*cur) || *cur == '_')
+        {
+        const char* start = cur;
+        while (isalnum(*cur) || *cur == '_')
+          {
+          ++cur;
+          }
+        token.Type = NAME_TOKEN;
+        token.Text.assign(start, cur);
+        }
+      else if (isdigit(*cur) || (*cur == '.' && isdigit(cur[1])))
+        {
+        char* end = NULL;
+        token.Type = NUMBER_TOKEN;
+        token.Number = strtod(cur, &end);
+        if (end == cur || isalpha(*end) || *end == '_')
+          {
+          return false;
+          }
+        token.Text.assign(cur, static_cast<const char*>(end));
+        cur = end;
+        }
+      else
+        {
+        int cc = 0;
+        for (; operators[cc]; cc++)
+          {
+          size_t len = strlen(operators[cc]);
+          if (strncmp(cur, operators[cc], len) == 0)
+            {
+            break;
+            }
+          }
+        if (!operators[cc])
+          {
+          return false;
+          }
+        token.Type = OPERATOR_TOKEN;
+        token.Text = operators[cc];
+        cur += token.Text.size();
+        }
+      tokens.push_back(token);
+      }
+    vtkQueryToken end;
+    end.Type = END_TOKEN;
+    end.Number = 0;
+    tokens.push_back(end);
+    return true;
+    }
+
+  //--------------------------------------------------------------------------
+  // Recursive descent parser following the Python operator precedence:
+  // comparisons, |, &, + and -, *, unary operators, subscripts and calls.
+  // Each method returns the index of the node parsed, or -1 on failure.
+  class vtkQueryParser
+  {
+  public:
+    vtkQueryParser(const std::vector<vtkQueryToken>& tokens,
+      std::vector<vtkQueryNode>& nodes)
+      : Tokens(tokens), Nodes(nodes), Position(0)
+      {
+      }
+
+    int Parse()
+      {
+      int root = this->Comparison();
+      if (root < 0 || this->Tokens[this->Position].Type != END_TOKEN ||
+        !this->Nodes[root].Boolean)
+        {
+        return -1;
+        }
+      return root;
+      }
+
+  private:
+    const std::vector<vtkQueryToken>& Tokens;
+    std::vector<vtkQueryNode>& Nodes;
+    size_t Position;
+
+    bool Accept(const char* op)
+      {
+      const vtkQueryToken& token = this->Tokens[this->Position];
+      if (token.Type == OPERATOR_TOKEN && token.Text == op)
+        {
+        this->Position++;
+        return true;
+        }
+      return false;
+      }
+
+    int AddNode(int type, bool boolean, int child0 = -1, int child1 = -1)
+      {
+      vtkQueryNode node;
+      node.Type = type;
+      node.Boolean = boolean;
+      node.Value = 0;
+      node.Function = 0;
+      node.Component = SCALAR;
+      node.Children[0] = child0;
+      node.Children[1] = child1;
+      this->Nodes.push_back(node);
+      return static_cast<int>(this->Nodes.size()) - 1;
+      }
+
+    bool IsNumeric(int node) const
+      {
+      return node >= 0 && !this->Nodes[node].Boolean;
+      }
+
+    bool IsBoolean(int node) const
+      {
+      return node >= 0 && this->Nodes[node].Boolean;
+      }
+
+    int Comparison()
+      {
+      static const char* operators[] = { "<=", ">=", "<", ">", "==", "!=", NULL };
+      static const int types[] = { LESS_EQUAL, GREATER_EQUAL, LESS, GREATER,
+        EQUAL, NOT_EQUAL };
+      int left = this->BitOr();
+      for (int cc=0; left >= 0 && operators[cc]; cc++)
+        {
+        if (this->Accept(operators[cc]))
+          {
+          int right = this->BitOr();
+          if (!this->IsNumeric(left) || !this->IsNumeric(right))
+            {
+            return -1;
+            }
+          int node = this->AddNode(types[cc], true, left, right);
+          // chained comparisons are ambiguous with arrays.
+          for (int kk=0; operators[kk]; kk++)
+            {
+            if (this->Accept(operators[kk]))
+              {
+              return -1;
+              }
+            }
+          return node;
+          }
+        }
+      return left;
+      }
+
+    int BitOr()
+      {
+      int left = this->BitAnd();
+      while (left >= 0 && this->Accept("|"))
+        {
+        int right = this->BitAnd();
+        if (!this->IsBoolean(left) || !this->IsBoolean(right))
+          {
+          return -1;
+          }
+        left = this->AddNode(OR, true, left, right);
+        }
+      return left;
+      }
+
+    int BitAnd()
+      {
+      int left = this->Arithmetic();
+      while (left >= 0 && this->Accept("&"))
+        {
+        int right = this->Arithmetic();
+        if (!this->IsBoolean(left) || !this->IsBoolean(right))
+          {
+          return -1;
+          }
+        left = this->AddNode(AND, true, left, right);
+        }
+      return left;
+      }
+
+    int Arithmetic()
+      {
+      int left = this->Term();
+      while (left >= 0)
+        {
+        int type;
+        if (this->Accept("+"))
+          {
+          type = ADD;
+          }
+        else if (this->Accept("-"))
+          {
+          type = SUBTRACT;
+          }
+        else
+          {
+          break;
+          }
+        int right = this->Term();
+        if (!this->IsNumeric(left) || !this->IsNumeric(right))
+          {
+          return -1;
+          }
+        left = this->AddNode(type, false, left, right);
+        }
+      return left;
+      }
+
+    int Term()
+      {
+      // Division is not supported: it is an integer division for integer
+      // arrays with Python 2.
+      int left = this->Unary();
+      while (left >= 0 && this->Accept("*"))
+        {
+        int right = this->Unary();
+        if (!this->IsNumeric(left) || !this->IsNumeric(right))
+          {
+          return -1;
+          }
+        left = this->AddNode(MULTIPLY, false, left, right);
+        }
+      return left;
+      }
+
+    int Unary()
+      {
+      if (this->Accept("-"))
+        {
+        int child = this->Unary();
+        return this->IsNumeric(child)? this->AddNode(NEGATE, false, child) : -1;
+        }
+      if (this->Accept("+"))
+        {
+        int child = this->Unary();
+        return this->IsNumeric(child)? child : -1;
+        }
+      if (this->Accept("~"))
+        {
+        int child = this->Unary();
+        return this->IsBoolean(child)? this->AddNode(NOT, true, child) : -1;
+        }
+      return this->Postfix();
+      }
+
+    int Postfix()
+      {
+      const vtkQueryToken& token = this->Tokens[this->Position];
+      int node = this->Atom();
+      if (node >= 0 && this->Accept("["))
+        {
+        // only "name[:,component]" is supported.
+        if (token.Type != NAME_TOKEN || this->Nodes[node].Type != FIELD ||
+          this->Nodes[node].Component != SCALAR ||
+          !this->Accept(":") || !this->Accept(","))
+          {
+          return -1;
+          }
+        const vtkQueryToken& component = this->Tokens[this->Position];
+        if (component.Type != NUMBER_TOKEN ||
+          component.Text.find_first_not_of("0123456789") != std::string::npos)
+          {
+          return -1;
+          }
+        this->Position++;
+        if (!this->Accept("]"))
+          {
+          return -1;
+          }
+        this->Nodes[node].Component = atoi(component.Text.c_str());
+        }
+      return node;
+      }
+
+    int Atom()
+      {
+      const vtkQueryToken& token = this->Tokens[this->Position];
+      if (token.Type == NUMBER_TOKEN)
+        {
+        this->Position++;
+        int node = this->AddNode(NUMBER, false);
+        this->Nodes[node].Value = token.Number;
+        return node;
+        }
+      if (token.Type == NAME_TOKEN)
+        {
+        this->Position++;
+        if (!this->Accept("("))
+          {
+          int node = this->AddNode(FIELD, false);
+          this->Nodes[node].Name = token.Text;
+          return node;
+          }
+        int node = -1;
+        if (token.Text == "mag")
+          {
+          const vtkQueryToken& name = this->Tokens[this->Position];
+          if (name.Type == NAME_TOKEN)
+            {
+            this->Position++;
+            node = this->AddNode(FIELD, false);
+            this->Nodes[node].Name = name.Text;
+            this->Nodes[node].Component = MAGNITUDE;
+            }
+          }
+        else if (token.Text == "abs")
+          {
+          int child = this->Comparison();
+          node = this->IsNumeric(child)?
+            this->AddNode(ABSOLUTE, false, child) : -1;
+          }
+        else if (token.Text == "min" || token.Text == "max" ||
+          token.Text == "mean")
+          {
+          int child = this->Comparison();
+          if (this->IsNumeric(child))
+            {
+            node = this->AddNode(AGGREGATE, false, child);
+            this->Nodes[node].Function = token.Text == "min"? MIN :
+              (token.Text == "max"? MAX : MEAN);
+            }
+          }
+        return (node >= 0 && this->Accept(")"))? node : -1;
+        }
+      if (this->Accept("("))
+        {
+        int node = this->Comparison();
+        return (node >= 0 && this->Accept(")"))? node : -1;
+        }
+      return -1;
+      }
+  };
+
+  //--------------------------------------------------------------------------
+  // Same as paraview.make_name_valid() in Python.
+  std::string MakeNameValid(const char* name)
+    {
+    std::string result;
+    for (const char* cur = name; cur && *cur; ++cur)
+      {
+      if (isalnum(*cur) || *cur == '_')
+        {
+        result += *cur;
+        }
+      }
+    if (!result.empty() && !isalpha(result[0]))
+      {
+      result = "a" + result;
+      }
+    return result;
+    }
+
+  //--------------------------------------------------------------------------
+  template <class T>
+  void GetValues(const T* data, int numComps, int component,
+    vtkIdType begin, vtkIdType count, double* values)
+    {
+    const T* ptr = data + begin * numComps;
+    if (component >= 0)
+      {
+      for (vtkIdType cc=0; cc < count; cc++)
+        {
+        values[cc] = static_cast<double>(ptr[cc * numComps + component]);
+        }
+      return;
+      }
+    for (vtkIdType cc=0; cc < count; cc++, ptr += numComps)
+      {
+      double sum = 0;
+      for (int kk=0; kk < numComps; kk++)
+        {
+        sum += static_cast<double>(ptr[kk]) * static_cast<double>(ptr[kk]);
+        }
+      values[cc] = sqrt(sum);
+      }
+    }
+
+  //--------------------------------------------------------------------------
+  // A dataset to evaluate the query on, with the arrays used by the FIELD
+  // nodes.
+  struct vtkQueryLeaf
+    {
+    vtkDataObject* Data;
+    vtkIdType NumberOfElements;
+    std::vector<vtkDataArray*> Arrays;
+    std::vector<const void*> Pointers;
+    std::vector<char> IsIndex;
+    // Whether a node cannot be evaluated because of missing arrays, as with
+    // dsa.NoneArray in Python.
+    std::vector<char> Missing;
+    vtkSmartPointer<vtkSignedCharArray> Mask;
+    };
+
+  // A range of elements of a leaf.
+  struct vtkQueryWorkItem
+    {
+    size_t Leaf;
+    vtkIdType Begin;
+    vtkIdType Count;
+    };
+
+  struct vtkQueryPartial
+    {
+    double Min;
+    double Max;
+    double Sum;
+    double Count;
+    };
+}
+
+class vtkPVQueryEvaluator::vtkInternals
+{
+public:
+  std::vector<vtkQueryNode> Nodes;
+  int Root;
+  std::vector<vtkQueryLeaf> Leaves;
+  std::vector<vtkQueryWorkItem> WorkItems;
+  std::map<vtkDataObject*, size_t> LeafIndices;
+
+  vtkInternals() : Root(-1) {}
+
+  // Finds the arrays used by the query, returns false for unsupported
+  // arrays.
+  bool Resolve(vtkQueryLeaf& leaf, int attributeType,
+    std::vector<char>& found)
+    {
+    size_t numNodes = this->Nodes.size();
+    leaf.Arrays.assign(numNodes, NULL);
+    leaf.Pointers.assign(numNodes, NULL);
+    leaf.IsIndex.assign(numNodes, 0);
+    leaf.Missing.assign(numNodes, 0);
+    vtkFieldData* attributes = leaf.Data->GetAttributes(attributeType);
+    leaf.NumberOfElements = attributes?
+      leaf.Data->GetNumberOfElements(attributeType) : 0;
+
+    for (size_t cc=0; cc < numNodes; cc++)
+      {
+      const vtkQueryNode& node = this->Nodes[cc];
+      if (node.Type != FIELD)
+        {
+        continue;
+        }
+      vtkAbstractArray* array = NULL;
+      for (int kk=0; attributes && kk < attributes->GetNumberOfArrays(); kk++)
+        {
+        vtkAbstractArray* candidate = attributes->GetAbstractArray(kk);
+        if (candidate && MakeNameValid(candidate->GetName()) == node.Name)
+          {
+          array = candidate;
+          break;
+          }
+        }
+      if (!array)
+        {
+        if (node.Name == "id" && node.Component == SCALAR && attributes)
+          {
+          leaf.IsIndex[cc] = 1;
+          found[cc] = 1;
+          }
+        else
+          {
+          leaf.Missing[cc] = 1;
+          }
+        continue;
+        }
+      found[cc] = 1;
+      vtkDataArray* dataArray = vtkDataArray::SafeDownCast(array);
+      if (!dataArray ||
+        (node.Component == SCALAR && dataArray->GetNumberOfComponents() != 1) ||
+        node.Component >= dataArray->GetNumberOfComponents())
+        {
+        return false;
+        }
+      // the values are read through the types vtkTemplateMacro covers,
+      // others such as bit arrays are left to the python evaluator.
+      bool templated = false;
+      switch (dataArray->GetDataType())
+        {
+        vtkTemplateMacro(templated = true);
+        }
+      if (!templated)
+        {
+        return false;
+        }
+      leaf.Arrays[cc] = dataArray;
+      leaf.Pointers[cc] = dataArray->GetVoidPointer(0);
+      }
+    this->UpdateMissing(this->Root, leaf);
+    return true;
+    }
+
+  // Propagates the missing arrays, except through aggregates which are
+  // computed over all the datasets.
+  bool UpdateMissing(int index, vtkQueryLeaf& leaf)
+    {
+    const vtkQueryNode& node = this->Nodes[index];
+    bool missing = leaf.Missing[index] != 0;
+    for (int cc=0; cc < 2; cc++)
+      {
+      if (node.Children[cc] >= 0 &&
+        this->UpdateMissing(node.Children[cc], leaf) && node.Type != AGGREGATE)
+        {
+        missing = true;
+        }
+      }
+    leaf.Missing[index] = missing? 1 : 0;
+    return missing;
+    }
+
+  void Evaluate(int index, const vtkQueryLeaf& leaf, vtkIdType begin,
+    vtkIdType count, double* values) const
+    {
+    const vtkQueryNode& node = this->Nodes[index];
+    switch (node.Type)
+      {
+    case NUMBER:
+    case AGGREGATE:
+      std::fill(values, values + count, node.Value);
+      return;
+
+    case FIELD:
+      if (leaf.IsIndex[index])
+        {
+        for (vtkIdType cc=0; cc < count; cc++)
+          {
+          values[cc] = static_cast<double>(begin + cc);
+          }
+        }
+      else
+        {
+        vtkDataArray* array = leaf.Arrays[index];
+        int component = node.Component == SCALAR? 0 : node.Component;
+        switch (array->GetDataType())
+          {
+          vtkTemplateMacro(GetValues(
+              static_cast<const VTK_TT*>(leaf.Pointers[index]),
+              array->GetNumberOfComponents(), component, begin, count,
+              values));
+          }
+        }
+      return;
+
+    default:
+      break;
+      }
+
+    this->Evaluate(node.Children[0], leaf, begin, count, values);
+    std::vector<double> right;
+    if (node.Children[1] >= 0)
+      {
+      right.resize(count);
+      this->Evaluate(node.Children[1], leaf, begin, count, &right[0]);
+      }
+    for (vtkIdType cc=0; cc < count; cc++)
+      {
+      double& value = values[cc];
+      switch (node.Type)
+        {
+      case NEGATE: value = -value; break;
+      case ABSOLUTE: value = fabs(value); break;
+      case NOT: value = value != 0.0? 0.0 : 1.0; break;
+      case ADD: value = value + right[cc]; break;
+      case SUBTRACT: value = value - right[cc]; break;
+      case MULTIPLY: value = value * right[cc]; break;
+      case AND: value = (value != 0.0 && right[cc] != 0.0)? 1.0 : 0.0; break;
+      case OR: value = (value != 0.0 || right[cc] != 0.0)? 1.0 : 0.0; break;
+      case LESS: value = value < right[cc]? 1.0 : 0.0; break;
+      case LESS_EQUAL: value = value <= right[cc]? 1.0 : 0.0; break;
+      case GREATER: value = value > right[cc]? 1.0 : 0.0; break;
+      case GREATER_EQUAL: value = value >= right[cc]? 1.0 : 0.0; break;
+      case EQUAL: value = value == right[cc]? 1.0 : 0.0; break;
+      case NOT_EQUAL: value = value != right[cc]? 1.0 : 0.0; break;
+        }
+      }
+    }
+
+  void CollectAggregates(int index, std::vector<int>& aggregates) const
+    {
+    const vtkQueryNode& node = this->Nodes[index];
+    for (int cc=0; cc < 2; cc++)
+      {
+      if (node.Children[cc] >= 0)
+        {
+        this->CollectAggregates(node.Children[cc], aggregates);
+        }
+      }
+    if (node.Type == AGGREGATE)
+      {
+      aggregates.push_back(index);
+      }
+    }
+
+  //--------------------------------------------------------------------------
+  // Reduces the operand of an aggregate node over the work items.
+  class vtkReduceFunctor
+  {
+  public:
+    const vtkInternals* Internals;
+    int Child;
+    vtkSMPThreadLocal<vtkQueryPartial> Partials;
+
+    vtkReduceFunctor(const vtkQueryPartial& exemplar) : Partials(exemplar) {}
+
+    void operator()(vtkIdType begin, vtkIdType end)
+      {
+      vtkQueryPartial& partial = this->Partials.Local();
+      std::vector<double> values;
+      for (vtkIdType cc=begin; cc < end; cc++)
+        {
+        const vtkQueryWorkItem& item = this->Internals->WorkItems[cc];
+        const vtkQueryLeaf& leaf = this->Internals->Leaves[item.Leaf];
+        if (leaf.Missing[this->Child])
+          {
+          continue;
+          }
+        values.resize(item.Count);
+        this->Internals->Evaluate(this->Child, leaf, item.Begin, item.Count,
+          &values[0]);
+        for (vtkIdType kk=0; kk < item.Count; kk++)
+          {
+          partial.Min = std::min(partial.Min, values[kk]);
+          partial.Max = std::max(partial.Max, values[kk]);
+          partial.Sum += values[kk];
+          }
+        partial.Count += item.Count;
+        }
+      }
+  };
+
+  //--------------------------------------------------------------------------
+  // Computes the masks over the work items.
+  class vtkMaskFunctor
+  {
+  public:
+    vtkInternals* Internals;
+    bool Inverse;
+
+    void operator()(vtkIdType begin, vtkIdType end)
+      {
+      std::vector<double> values;
+      int root = this->Internals->Root;
+      for (vtkIdType cc=begin; cc < end; cc++)
+        {
+        const vtkQueryWorkItem& item = this->Internals->WorkItems[cc];
+        vtkQueryLeaf& leaf = this->Internals->Leaves[item.Leaf];
+        if (leaf.Missing[root])
+          {
+          continue;
+          }
+        values.resize(item.Count);
+        this->Internals->Evaluate(root, leaf, item.Begin, item.Count,
+          &values[0]);
+        signed char* mask = leaf.Mask->GetPointer(item.Begin);
+        for (vtkIdType kk=0; kk < item.Count; kk++)
+          {
+          mask[kk] = ((values[kk] != 0.0) != this->Inverse)? 1 : 0;
+          }
+        }
+      }
+  };
+};
+
+vtkStandardNewMacro(vtkPVQueryEvaluator);
+//----------------------------------------------------------------------------
+vtkPVQueryEvaluator::vtkPVQueryEvaluator()
+{
+  this->Internals = new vtkInternals();
+}
+
+//----------------------------------------------------------------------------
+vtkPVQueryEvaluator::~vtkPVQueryEvaluator()
+{
+  delete this->Internals;
+  this->Internals = NULL;
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVQueryEvaluator::SetQuery(const char* query)
+{
+  vtkInternals& internals = *this->Internals;
+  internals.Nodes.clear();
+  internals.Leaves.clear();
+  internals.LeafIndices.clear();
+  internals.Root = -1;
+
+  std::vector<vtkQueryToken> tokens;
+  if (query && Tokenize(query, tokens))
+    {
+    vtkQueryParser parser(tokens, internals.Nodes);
+    internals.Root = parser.Parse();
+    }
+  if (internals.Root < 0)
+    {
+    internals.Nodes.clear();
+    return false;
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkPVQueryEvaluator::Evaluate(
+  vtkDataObject* input, int attributeType, bool inverse)
+{
+  vtkInternals& internals = *this->Internals;
+  internals.Leaves.clear();
+  internals.LeafIndices.clear();
+  internals.WorkItems.clear();
+  if (internals.Root < 0)
+    {
+    return false;
+    }
+
+  // Collect the datasets.
+  std::vector<vtkDataObject*> datasets;
+  if (vtkCompositeDataSet* cd = vtkCompositeDataSet::SafeDownCast(input))
+    {
+    vtkSmartPointer<vtkCompositeDataIterator> iter;
+    iter.TakeReference(cd->NewIterator());
+    for (iter->InitTraversal(); !iter->IsDoneWithTraversal();
+      iter->GoToNextItem())
+      {
+      datasets.push_back(iter->GetCurrentDataObject());
+      }
+    }
+  else if (input)
+    {
+    datasets.push_back(input);
+    }
+
+  // Find the arrays. Queries using names that are not arrays are left to
+  // Python.
+  bool supported = true;
+  std::vector<char> found(internals.Nodes.size(), 0);
+  internals.Leaves.resize(datasets.size());
+  for (size_t cc=0; cc < datasets.size() && supported; cc++)
+    {
+    vtkQueryLeaf& leaf = internals.Leaves[cc];
+    leaf.Data = datasets[cc];
+    internals.LeafIndices[leaf.Data] = cc;
+    supported = internals.Resolve(leaf, attributeType, found);
+    }
+  for (size_t cc=0; cc < found.size() && supported && !datasets.empty(); cc++)
+    {
+    supported = internals.Nodes[cc].Type != FIELD || found[cc] != 0;
+    }
+
+  vtkMultiProcessController* controller =
+    vtkMultiProcessController::GetGlobalController();
+  bool parallel = controller && controller->GetNumberOfProcesses() > 1;
+  if (parallel)
+    {
+    int localSupported = supported? 1 : 0;
+    int globalSupported = 0;
+    controller->AllReduce(&localSupported, &globalSupported, 1,
+      vtkCommunicator::MIN_OP);
+    supported = globalSupported != 0;
+    }
+  if (!supported)
+    {
+    internals.Leaves.clear();
+    internals.LeafIndices.clear();
+    return false;
+    }
+
+  // Split the datasets in ranges of elements to process in parallel.
+  const vtkIdType chunkSize = 16384;
+  for (size_t cc=0; cc < internals.Leaves.size(); cc++)
+    {
+    vtkQueryLeaf& leaf = internals.Leaves[cc];
+    for (vtkIdType begin=0; begin < leaf.NumberOfElements; begin += chunkSize)
+      {
+      vtkQueryWorkItem item;
+      item.Leaf = cc;
+      item.Begin = begin;
+      item.Count = std::min(chunkSize, leaf.NumberOfElements - begin);
+      internals.WorkItems.push_back(item);
+      }
+    }
+  vtkIdType numItems = static_cast<vtkIdType>(internals.WorkItems.size());
+
+  // Compute the aggregates, innermost first.
+  std::vector<int> aggregates;
+  internals.CollectAggregates(internals.Root, aggregates);
+  for (size_t cc=0; cc < aggregates.size(); cc++)
+    {
+    vtkQueryNode& node = internals.Nodes[aggregates[cc]];
+    vtkQueryPartial exemplar = { VTK_DOUBLE_MAX, -VTK_DOUBLE_MAX, 0.0, 0.0 };
+    vtkInternals::vtkReduceFunctor reduce(exemplar);
+    reduce.Internals = &internals;
+    reduce.Child = node.Children[0];
+    vtkSMPTools::For(0, numItems, 1, reduce);
+
+    vtkQueryPartial result = exemplar;
+    for (vtkSMPThreadLocal<vtkQueryPartial>::iterator iter =
+      reduce.Partials.begin(); iter != reduce.Partials.end(); ++iter)
+      {
+      result.Min = std::min(result.Min, iter->Min);
+      result.Max = std::max(result.Max, iter->Max);
+      result.Sum += iter->Sum;
+      result.Count += iter->Count;
+      }
+    if (parallel)
+      {
+      double sums[2] = { result.Sum, result.Count };
+      double globalSums[2];
+      controller->AllReduce(&result.Min, &exemplar.Min, 1,
+        vtkCommunicator::MIN_OP);
+      controller->AllReduce(&result.Max, &exemplar.Max, 1,
+        vtkCommunicator::MAX_OP);
+      controller->AllReduce(sums, globalSums, 2, vtkCommunicator::SUM_OP);
+      result.Min = exemplar.Min;
+      result.Max = exemplar.Max;
+      result.Sum = globalSums[0];
+      result.Count = globalSums[1];
+      }
+    if (result.Count == 0)
+      {
+      node.Value = vtkMath::Nan();
+      }
+    else
+      {
+      node.Value = node.Function == MIN? result.Min :
+        (node.Function == MAX? result.Max : result.Sum / result.Count);
+      }
+    }
+
+  // Compute the masks.
+  for (size_t cc=0; cc < internals.Leaves.size(); cc++)
+    {
+    vtkQueryLeaf& leaf = internals.Leaves[cc];
+    if (!leaf.Missing[internals.Root])
+      {
+      leaf.Mask = vtkSmartPointer<vtkSignedCharArray>::New();
+      leaf.Mask->SetName("vtkInsidedness");
+      leaf.Mask->SetNumberOfTuples(leaf.NumberOfElements);
+      }
+    }
+  vtkInternals::vtkMaskFunctor mask;
+  mask.Internals = &internals;
+  mask.Inverse = inverse;
+  vtkSMPTools::For(0, numItems, 1, mask);
+  return true;
+}
+
+//----------------------------------------------------------------------------
+vtkSignedCharArray* vtkPVQueryEvaluator::GetMask(vtkDataObject* dataset)
+{
+  std::map<vtkDataObject*, size_t>::iterator iter =
+    this->Internals->LeafIndices.find(dataset);
+  return iter != this->Internals->LeafIndices.end()?
+    this->Internals->Leaves[iter->second].Mask.GetPointer() : NULL;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVQueryEvaluator::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+}
@@ -0,0 +1,81 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkPVQueryEvaluator.h
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkPVQueryEvaluator - native evaluation of selection queries.
+// .SECTION Description
+// vtkPVQueryEvaluator evaluates the query strings of vtkSelectionNode::QUERY
+// selections (as produced by vtkQuerySelectionSource) without going through
+// the Python interpreter. It supports the forms generated by the Find Data
+// panel: comparisons of arrays, array components (\c "V[:,1]"), magnitudes
+// (\c "mag(V)") or ids (\c "id") with numbers, combined with \c &, \c | and
+// \c ~, simple arithmetic and \c abs(), and the global \c min(), \c max() and
+// \c mean() reductions. The expressions follow the Python operator precedence
+// and array naming rules, so that they give the same result as with numpy.
+//
+// All the blocks of a composite dataset are evaluated in parallel using
+// vtkSMPTools. The global reductions are done over all the blocks and, when
+// running in parallel, over all the processes using the global controller.
+//
+// Evaluate() returns false for queries it cannot evaluate, which should then
+// be evaluated with Python (see vtkPythonExtractSelection). In parallel, all
+// the processes agree on that result, and Evaluate() must be called on all of
+// them.
+
+#ifndef vtkPVQueryEvaluator_h
+#define vtkPVQueryEvaluator_h
+
+#include "vtkObject.h"
+#include "vtkPVClientServerCoreCoreModule.h" //needed for exports
+
+class vtkDataObject;
+class vtkSignedCharArray;
+
+class VTKPVCLIENTSERVERCORECORE_EXPORT vtkPVQueryEvaluator : public vtkObject
+{
+public:
+  static vtkPVQueryEvaluator* New();
+  vtkTypeMacro(vtkPVQueryEvaluator, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Parses the query. Returns false if the query is not supported.
+  bool SetQuery(const char* query);
+
+  // Description:
+  // Evaluates the query for the elements of type attributeType
+  // (vtkDataObject::AttributeTypes) of the dataset or of the leaves of the
+  // composite dataset. When inverse is true, the result is negated. Returns
+  // false if the query cannot be evaluated on this data.
+  bool Evaluate(vtkDataObject* input, int attributeType, bool inverse);
+
+  // Description:
+  // Returns the mask computed by the last Evaluate() for a dataset (the input
+  // or one of its leaves), or NULL if some arrays used in the query are
+  // missing in that dataset. The array is named "vtkInsidedness" and has 1 for
+  // the selected elements.
+  vtkSignedCharArray* GetMask(vtkDataObject* dataset);
+
+protected:
+  vtkPVQueryEvaluator();
+  ~vtkPVQueryEvaluator();
+
+private:
+  vtkPVQueryEvaluator(const vtkPVQueryEvaluator&) VTK_DELETE_FUNCTION;
+  void operator=(const vtkPVQueryEvaluator&) VTK_DELETE_FUNCTION;
+
+  class vtkInternals;
+  vtkInternals* Internals;
+};
+
+#endif
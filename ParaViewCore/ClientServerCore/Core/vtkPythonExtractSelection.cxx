@@ -18,22 +18,28 @@
 #include "vtkCompositeDataIterator.h"
 #include "vtkCompositeDataSet.h"
 #include "vtkDataObjectTypes.h"
+#include "vtkDataSetAttributes.h"
 #include "vtkExtractSelectedIds.h"
 #include "vtkExtractSelectedRows.h"
 #include "vtkFieldData.h"
+#include "vtkIdTypeArray.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkNew.h"
 #include "vtkObjectFactory.h"
+#include "vtkPVQueryEvaluator.h"
 #include "vtkPythonInterpreter.h"
 #include "vtkSelection.h"
 #include "vtkSelectionNode.h"
+#include "vtkSignedCharArray.h"
 #include "vtkSmartPointer.h"
 #include "vtkTable.h"
 #include "vtkUnstructuredGrid.h"
 
 #include <cassert>
 #include <sstream>
+#include <utility>
+#include <vector>
 
 vtkStandardNewMacro(vtkPythonExtractSelection);
 //----------------------------------------------------------------------------
@@ -137,6 +143,12 @@ int vtkPythonExtractSelection::RequestData(
   vtkDataObject* output = vtkDataObject::GetData(outputVector, 0);
   this->InitializeOutput(output, input);
 
+  // Common queries are evaluated natively, without the Python interpreter.
+  if (this->EvaluateQuery(input, selection->GetNode(0), output))
+    {
+    return 1;
+    }
+
   // Set self to point to this
   char addrofthis[1024];
   sprintf(addrofthis, "%p", this);
@@ -165,6 +177,96 @@ int vtkPythonExtractSelection::RequestData(
   return 1;
 }
 
+//----------------------------------------------------------------------------
+bool vtkPythonExtractSelection::EvaluateQuery(
+  vtkDataObject* input, vtkSelectionNode* node, vtkDataObject* output)
+{
+  int attributeType;
+  switch (node->GetFieldType())
+    {
+  case vtkSelectionNode::CELL:
+    attributeType = vtkDataObject::CELL;
+    break;
+
+  case vtkSelectionNode::POINT:
+    attributeType = vtkDataObject::POINT;
+    break;
+
+  case vtkSelectionNode::ROW:
+    attributeType = vtkDataObject::ROW;
+    break;
+
+  default:
+    return false;
+    }
+
+  vtkNew<vtkPVQueryEvaluator> evaluator;
+  bool inverse = node->GetProperties()->Has(vtkSelectionNode::INVERSE()) &&
+    node->GetProperties()->Get(vtkSelectionNode::INVERSE()) == 1;
+  if (!evaluator->SetQuery(node->GetQueryString()) ||
+    !evaluator->Evaluate(input, attributeType, inverse))
+    {
+    return false;
+    }
+
+  // Same as extract_selection.execute(): add the mask when preserving
+  // topology, otherwise pass the selected ids in the field data to
+  // ExtractElements().
+  std::vector<std::pair<vtkDataObject*, vtkDataObject*> > leaves;
+  if (vtkCompositeDataSet* inputCD = vtkCompositeDataSet::SafeDownCast(input))
+    {
+    vtkCompositeDataSet* outputCD = vtkCompositeDataSet::SafeDownCast(output);
+    vtkSmartPointer<vtkCompositeDataIterator> iter;
+    iter.TakeReference(inputCD->NewIterator());
+    for (iter->InitTraversal(); !iter->IsDoneWithTraversal(); iter->GoToNextItem())
+      {
+      leaves.push_back(std::make_pair(iter->GetCurrentDataObject(),
+          outputCD->GetDataSet(iter)));
+      }
+    }
+  else
+    {
+    leaves.push_back(std::make_pair(input, output));
+    }
+
+  for (size_t cc=0; cc < leaves.size(); cc++)
+    {
+    vtkSignedCharArray* mask = evaluator->GetMask(leaves[cc].first);
+    vtkDataObject* outputLeaf = leaves[cc].second;
+    if (!mask || !outputLeaf)
+      {
+      continue;
+      }
+    if (this->PreserveTopology)
+      {
+      if (vtkFieldData* attributes = outputLeaf->GetAttributes(attributeType))
+        {
+        attributes->AddArray(mask);
+        }
+      continue;
+      }
+
+    vtkNew<vtkIdTypeArray> ids;
+    ids->SetName("vtkSelectedIds");
+    vtkIdType numElements = mask->GetNumberOfTuples();
+    const signed char* values = mask->GetPointer(0);
+    for (vtkIdType kk=0; kk < numElements; kk++)
+      {
+      if (values[kk])
+        {
+        ids->InsertNextValue(kk);
+        }
+      }
+    outputLeaf->GetFieldData()->AddArray(ids.GetPointer());
+    }
+
+  if (!this->PreserveTopology)
+    {
+    this->ExtractElements(attributeType, input, output);
+    }
+  return true;
+}
+
 //----------------------------------------------------------------------------
 void vtkPythonExtractSelection::InitializeOutput(
   vtkDataObject* output, vtkDataObject* input)
@@ -16,6 +16,8 @@
 // .SECTION Description
 // vtkPythonExtractSelection is a used to extra cells/points using numpy. This
 // enables creation of arbitrary queries to be used as the selection criteria.
+// Queries supported by vtkPVQueryEvaluator are evaluated natively instead,
+// without using the Python interpreter.
 
 #ifndef vtkPythonExtractSelection_h
 #define vtkPythonExtractSelection_h
@@ -24,6 +26,7 @@
 #include "vtkExtractSelectionBase.h"
 
 class vtkCompositeDataSet;
+class vtkSelectionNode;
 
 class VTKPVCLIENTSERVERCORECORE_EXPORT vtkPythonExtractSelection : public vtkExtractSelectionBase
 {
@@ -55,6 +58,12 @@ protected:
   // this->PreserveTopology.
   void InitializeOutput(vtkDataObject* output, vtkDataObject* input);
 
+  // Description:
+  // Evaluates the query using vtkPVQueryEvaluator. Returns false if the
+  // query is not supported, in which case it must be evaluated with Python.
+  bool EvaluateQuery(vtkDataObject* input, vtkSelectionNode* node,
+    vtkDataObject* output);
+
 private:
   vtkPythonExtractSelection(const vtkPythonExtractSelection&) VTK_DELETE_FUNCTION;
   void operator=(const vtkPythonExtractSelection&) VTK_DELETE_FUNCTION;
@@ -24,6 +24,7 @@
 #include "vtkProcessModule.h"
 #include "vtkPVFileInformationHelper.h"
 #include "vtkSmartPointer.h"
+#include "vtkSMPTools.h"
 
 #if defined(_WIN32)
 # define _WIN32_IE 0x0400  // special folder support
@@ -42,6 +43,7 @@
 # include <errno.h>     // errno
 # include <string.h>    // strerror
 # include <stdlib.h>    // getenv
+# include <time.h>      // time
 # define vtkPVServerFileListingGetCWD getcwd
 #endif
 #if defined (__APPLE__)
@@ -51,8 +53,11 @@
 
 #include <vtksys/SystemTools.hxx>
 #include <vtksys/RegularExpression.hxx>
+#include <algorithm>
+#include <map>
 #include <set>
 #include <string>
+#include <vector>
 
 vtkStandardNewMacro(vtkPVFileInformation);
 
@@ -369,6 +374,53 @@ class vtkPVFileInformationSet :
 {
 };
 
+//-----------------------------------------------------------------------------
+// Entries of a directory listing, sorted by name.
+class vtkPVFileInformationList :
+  public std::vector<vtkSmartPointer<vtkPVFileInformation> >
+{
+};
+
+//-----------------------------------------------------------------------------
+namespace
+{
+bool vtkPVFileInformationNameLess(
+  const vtkSmartPointer<vtkPVFileInformation>& a,
+  const vtkSmartPointer<vtkPVFileInformation>& b)
+{
+  return strcmp(a->GetName(), b->GetName()) < 0;
+}
+
+void vtkPVFileInformationSort(vtkPVFileInformationSet& info_set,
+  vtkPVFileInformationList& sorted)
+{
+  sorted.assign(info_set.begin(), info_set.end());
+  std::sort(sorted.begin(), sorted.end(), vtkPVFileInformationNameLess);
+}
+}
+
+//-----------------------------------------------------------------------------
+// Checks the type of files in parallel: on network file systems the latency of
+// each stat, rather than the number of entries, dominates the time to list a
+// directory.
+struct vtkPVFileInformation::vtkTypeDetector
+{
+  std::vector<vtkPVFileInformation*> Items;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+    {
+    for (vtkIdType cc = begin; cc < end; ++cc)
+      {
+      vtkPVFileInformation* item = this->Items[cc];
+      if (vtksys::SystemTools::FileExists(item->FullPath))
+        {
+        item->Type = vtksys::SystemTools::FileIsDirectory(item->FullPath)?
+          DIRECTORY : SINGLE_FILE;
+        }
+      }
+    }
+};
+
 //-----------------------------------------------------------------------------
 vtkPVFileInformation::vtkPVFileInformation()
 {
@@ -379,6 +431,9 @@ vtkPVFileInformation::vtkPVFileInformation()
   this->Name = NULL;
   this->FullPath = NULL;
   this->FastFileTypeDetection = 0;
+  this->DirectoryListingOffset = 0;
+  this->DirectoryListingLength = 0;
+  this->DirectoryListingSize = 0;
   this->Hidden = false;
 }
 
@@ -420,6 +475,8 @@ void vtkPVFileInformation::CopyFromObject(vtkObject* object)
     }
 
   this->FastFileTypeDetection = helper->GetFastFileTypeDetection();
+  this->DirectoryListingOffset = helper->GetDirectoryListingOffset();
+  this->DirectoryListingLength = helper->GetDirectoryListingLength();
 
   std::string working_directory =
     vtksys::SystemTools::GetCurrentWorkingDirectory().c_str();
@@ -677,11 +734,7 @@ void vtkPVFileInformation::GetWindowsDirectoryListing()
       }
     this->OrganizeCollection(info_set);
 
-    for (vtkPVFileInformationSet::iterator iter = info_set.begin();
-      iter != info_set.end(); ++iter)
-      {
-      this->Contents->AddItem(*iter);
-      }
+    this->SelectDirectoryListingRange(info_set, this->Contents);
     return;
     }
 
@@ -716,11 +769,7 @@ void vtkPVFileInformation::GetWindowsDirectoryListing()
       {
       this->OrganizeCollection(info_set);
 
-      for (vtkPVFileInformationSet::iterator iter = info_set.begin();
-        iter != info_set.end(); ++iter)
-        {
-        this->Contents->AddItem(*iter);
-        }
+      this->SelectDirectoryListingRange(info_set, this->Contents);
       return;
       }
     // fall through for normal file listing that works after shares are
@@ -808,11 +857,7 @@ void vtkPVFileInformation::GetWindowsDirectoryListing()
 
   this->OrganizeCollection(info_set);
 
-  for (vtkPVFileInformationSet::iterator iter = info_set.begin();
-    iter != info_set.end(); ++iter)
-    {
-    this->Contents->AddItem(*iter);
-    }
+  this->SelectDirectoryListingRange(info_set, this->Contents);
 
 #else
   vtkErrorMacro("GetWindowsDirectoryListing cannot be called on non-Windows systems.");
@@ -828,29 +873,97 @@ support and glibc/Linux system headers:
 # define dirent dirent64
 #endif
 
-//-----------------------------------------------------------------------------
-void vtkPVFileInformation::GetDirectoryListing()
+#if !defined(_WIN32)
+namespace
 {
-#if defined(_WIN32)
+// Names and types, as far as readdir() tells, of the entries of a directory.
+typedef std::vector<std::pair<std::string, int> > vtkPVFileInformationEntries;
+
+// Directory listings are kept for a few seconds so that a directory fetched in
+// several ranges, or browsed again right away, is read, grouped and sorted
+// only once. A listing is reused only while the modification time of the
+// directory is unchanged and older than the listing itself, since the
+// modification time only has a resolution of one second.
+struct vtkPVFileInformationCachedListing
+{
+  time_t ListingTime;
+  time_t ModifiedTime;
+  int FastFileTypeDetection;
+  vtkPVFileInformationList Items;
+};
+typedef std::map<std::string, vtkPVFileInformationCachedListing>
+  vtkPVFileInformationListingCache;
 
-  vtkErrorMacro("GetDirectoryListing() cannot be called on Windows systems.");
-  return;
+vtkPVFileInformationListingCache ListingCache;
+const time_t ListingCacheLifetime = 5; // in seconds
+const size_t ListingCacheSize = 16;
 
-#else
+// Returns the listing of path cached for the given modification time of the
+// directory, if any.
+vtkPVFileInformationCachedListing* vtkPVFileInformationFindListing(
+  const std::string& path, time_t modifiedTime, int fastFileTypeDetection)
+{
+  vtkPVFileInformationListingCache::iterator iter = ListingCache.find(path);
+  if (iter == ListingCache.end())
+    {
+    return NULL;
+    }
+  time_t now = time(NULL);
+  vtkPVFileInformationCachedListing& cached = iter->second;
+  if (now >= cached.ListingTime &&
+    now - cached.ListingTime <= ListingCacheLifetime &&
+    modifiedTime == cached.ModifiedTime &&
+    modifiedTime < cached.ListingTime &&
+    fastFileTypeDetection == cached.FastFileTypeDetection)
+    {
+    return &cached;
+    }
+  ListingCache.erase(iter);
+  return NULL;
+}
 
-  vtkPVFileInformationSet info_set;
-  std::string prefix = this->FullPath;
-  vtkPVFileInformationAddTerminatingSlash(prefix);
+// Adds an empty listing of path to the cache, dropping the oldest listing
+// to make room.
+vtkPVFileInformationCachedListing* vtkPVFileInformationAddListing(
+  const std::string& path, time_t modifiedTime, int fastFileTypeDetection)
+{
+  if (ListingCache.size() >= ListingCacheSize)
+    {
+    vtkPVFileInformationListingCache::iterator oldest = ListingCache.begin();
+    vtkPVFileInformationListingCache::iterator iter;
+    for (iter = ListingCache.begin(); iter != ListingCache.end(); ++iter)
+      {
+      if (iter->second.ListingTime < oldest->second.ListingTime)
+        {
+        oldest = iter;
+        }
+      }
+    ListingCache.erase(oldest);
+    }
+  vtkPVFileInformationCachedListing& cached = ListingCache[path];
+  cached.ListingTime = time(NULL);
+  cached.ModifiedTime = modifiedTime;
+  cached.FastFileTypeDetection = fastFileTypeDetection;
+  cached.Items.clear();
+  return &cached;
+}
 
+bool vtkPVFileInformationReadDirectory(const std::string& path,
+  vtkPVFileInformationEntries& entries)
+{
   // Open the directory and make sure it exists.
-  DIR* dir = opendir(this->FullPath);
+  DIR* dir = opendir(path.c_str());
   if(!dir)
     {
     // Could add check of errno here.
-    return;
+    return false;
     }
 
+  std::string prefix = path;
+  vtkPVFileInformationAddTerminatingSlash(prefix);
+
   // Loop through the directory listing.
+  entries.clear();
   while(const dirent* d = readdir(dir))
     {
     // Skip the special directory entries.
@@ -858,43 +971,118 @@ void vtkPVFileInformation::GetDirectoryListing()
       {
       continue;
       }
-    vtkPVFileInformation* info = vtkPVFileInformation::New();
-    info->SetName(d->d_name);
-    info->SetFullPath((prefix + d->d_name).c_str());
-    info->Type = INVALID;
-    info->SetHiddenFlag();
+    int type = vtkPVFileInformation::INVALID;
 
     // fix to bug #09452 such that directories with trailing names can be
     // shown in the file dialog
 #if defined (__SVR4) && defined (__sun)
-  struct stat status;
-  int res = stat( info->FullPath, &status );
-  if ( res != -1 && status.st_mode & S_IFDIR )
-    {
-    info->Type = DIRECTORY;
+    struct stat entryStatus;
+    int res = stat((prefix + d->d_name).c_str(), &entryStatus);
+    if ( res != -1 && entryStatus.st_mode & S_IFDIR )
+      {
+      type = vtkPVFileInformation::DIRECTORY;
+      }
+#else
+    // Other types, including DT_UNKNOWN and links, are detected later.
+    if ( d->d_type == DT_DIR )
+      {
+      type = vtkPVFileInformation::DIRECTORY;
+      }
+#endif
+    entries.push_back(std::make_pair(std::string(d->d_name), type));
     }
+  closedir(dir);
+  return true;
+}
+}
+#endif
+
+//-----------------------------------------------------------------------------
+void vtkPVFileInformation::GetDirectoryListing()
+{
+#if defined(_WIN32)
+
+  vtkErrorMacro("GetDirectoryListing() cannot be called on Windows systems.");
+  return;
+
 #else
-  if ( d->d_type & DT_DIR )
+
+  struct stat status;
+  if (stat(this->FullPath, &status) != 0)
     {
-    info->Type = DIRECTORY;
+    return;
     }
-#endif
 
-    info->FastFileTypeDetection = this->FastFileTypeDetection;
-    info_set.insert(info);
-    info->Delete();
+  // The listing is grouped and sorted once, ranges are then taken from the
+  // cached listing. The types detected below are kept in it too.
+  vtkPVFileInformationCachedListing* listing = vtkPVFileInformationFindListing(
+    this->FullPath, status.st_mtime, this->FastFileTypeDetection);
+  if (!listing)
+    {
+    vtkPVFileInformationEntries entries;
+    if (!vtkPVFileInformationReadDirectory(this->FullPath, entries))
+      {
+      return;
+      }
+
+    vtkPVFileInformationSet info_set;
+    std::string prefix = this->FullPath;
+    vtkPVFileInformationAddTerminatingSlash(prefix);
+    for (size_t cc = 0; cc < entries.size(); ++cc)
+      {
+      vtkPVFileInformation* info = vtkPVFileInformation::New();
+      info->SetName(entries[cc].first.c_str());
+      info->SetFullPath((prefix + entries[cc].first).c_str());
+      info->Type = entries[cc].second;
+      info->SetHiddenFlag();
+      info->FastFileTypeDetection = this->FastFileTypeDetection;
+      info_set.insert(info);
+      info->Delete();
+      }
+
+    this->OrganizeCollection(info_set);
+
+    listing = vtkPVFileInformationAddListing(this->FullPath,
+      status.st_mtime, this->FastFileTypeDetection);
+    vtkPVFileInformationSort(info_set, listing->Items);
     }
-  closedir(dir);
 
-  this->OrganizeCollection(info_set);
+  vtkNew<vtkCollection> range;
+  this->SelectDirectoryListingRange(listing->Items, range.GetPointer());
+
+  // Check the files whose type is still unknown all at once, in parallel.
+  // For groups, these are the files that DetectType() will look at.
+  vtkTypeDetector detector;
+  vtkSmartPointer<vtkCollectionIterator> iter;
+  iter.TakeReference(range->NewIterator());
+  for (iter->InitTraversal(); !iter->IsDoneWithTraversal(); iter->GoToNextItem())
+    {
+    vtkPVFileInformation* obj = vtkPVFileInformation::SafeDownCast(
+      iter->GetCurrentObject());
+    if (obj->Type == INVALID)
+      {
+      detector.Items.push_back(obj);
+      }
+    else if (obj->Type == FILE_GROUP)
+      {
+      int numChildren = this->FastFileTypeDetection? 1 :
+        obj->Contents->GetNumberOfItems();
+      for (int cc=0; cc < numChildren; cc++)
+        {
+        detector.Items.push_back(vtkPVFileInformation::SafeDownCast(
+          obj->Contents->GetItemAsObject(cc)));
+        }
+      }
+    }
+  vtkSMPTools::For(0, static_cast<vtkIdType>(detector.Items.size()), detector);
 
   // Now we detect the file types for items.
   // We dissolve any groups that contain non-file items.
 
-  for (vtkPVFileInformationSet::iterator iter = info_set.begin();
-    iter != info_set.end(); ++iter)
+  for (iter->InitTraversal(); !iter->IsDoneWithTraversal(); iter->GoToNextItem())
     {
-    vtkPVFileInformation* obj = (*iter);
+    vtkPVFileInformation* obj = vtkPVFileInformation::SafeDownCast(
+      iter->GetCurrentObject());
     if (obj->DetectType())
       {
       this->Contents->AddItem(obj);
@@ -916,6 +1104,34 @@ void vtkPVFileInformation::GetDirectoryListing()
 #endif
 }
 
+//-----------------------------------------------------------------------------
+void vtkPVFileInformation::SelectDirectoryListingRange(
+  vtkPVFileInformationSet& info_set, vtkCollection* range)
+{
+  vtkPVFileInformationList sorted;
+  vtkPVFileInformationSort(info_set, sorted);
+  this->SelectDirectoryListingRange(sorted, range);
+}
+
+//-----------------------------------------------------------------------------
+void vtkPVFileInformation::SelectDirectoryListingRange(
+  const vtkPVFileInformationList& items, vtkCollection* range)
+{
+  this->DirectoryListingSize = static_cast<int>(items.size());
+  size_t begin = std::min(items.size(),
+    static_cast<size_t>(this->DirectoryListingOffset));
+  size_t end = items.size();
+  if (this->DirectoryListingLength > 0)
+    {
+    end = std::min(end,
+      begin + static_cast<size_t>(this->DirectoryListingLength));
+    }
+  for (size_t cc = begin; cc < end; ++cc)
+    {
+    range->AddItem(items[cc].GetPointer());
+    }
+}
+
 //-----------------------------------------------------------------------------
 void vtkPVFileInformation::SetHiddenFlag( )
 {
@@ -1083,6 +1299,7 @@ void vtkPVFileInformation::CopyToStream(vtkClientServerStream* stream)
     << this->FullPath
     << this->Type
     << this->Hidden
+    << this->DirectoryListingSize
     << this->Contents->GetNumberOfItems();
 
   vtkSmartPointer<vtkCollectionIterator> iter;
@@ -1129,8 +1346,14 @@ void vtkPVFileInformation::CopyFromStream(const vtkClientServerStream* css)
     return;
     }
 
+  if (!css->GetArgument(0, 4, &this->DirectoryListingSize))
+    {
+    vtkErrorMacro("Error parsing DirectoryListingSize.");
+    return;
+    }
+
   int num_of_children =0;
-  if (!css->GetArgument(0, 4, &num_of_children))
+  if (!css->GetArgument(0, 5, &num_of_children))
     {
     vtkErrorMacro("Error parsing Number of children.");
     return;
@@ -1139,7 +1362,7 @@ void vtkPVFileInformation::CopyFromStream(const vtkClientServerStream* css)
     {
     vtkPVFileInformation* child = vtkPVFileInformation::New();
     vtkClientServerStream childStream;
-    if (!css->GetArgument(0, 5+cc, &childStream))
+    if (!css->GetArgument(0, 6+cc, &childStream))
       {
       vtkErrorMacro("Error parsing child #" << cc);
       return;
@@ -1157,6 +1380,7 @@ void vtkPVFileInformation::Initialize()
   this->SetFullPath(0);
   this->Type = INVALID;
   this->Hidden = false;
+  this->DirectoryListingSize = 0;
   this->Contents->RemoveAllItems();
 }
 
@@ -1187,6 +1411,7 @@ void vtkPVFileInformation::PrintSelf(ostream& os, vtkIndent indent)
     }
   os << indent << "Hidden: "<< this->Hidden << endl;
   os << indent << "FastFileTypeDetection: " << this->FastFileTypeDetection << endl;
+  os << indent << "DirectoryListingSize: " << this->DirectoryListingSize << endl;
 
   for (int cc=0; cc < this->Contents->GetNumberOfItems(); cc++)
     {
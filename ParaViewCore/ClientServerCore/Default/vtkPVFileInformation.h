@@ -28,6 +28,7 @@
 #include "vtkPVInformation.h"
 
 class vtkCollection;
+class vtkPVFileInformationList;
 class vtkPVFileInformationSet;
 class vtkFileSequenceParser;
 
@@ -91,6 +92,13 @@ public:
   // Get the state of the hidden flag for the file/directory.
   vtkGetMacro(Hidden,bool);
 
+  // Description:
+  // Get the total number of entries in the directory listing, file groups
+  // counting as one entry. When only a range of the listing was requested
+  // (see vtkPVFileInformationHelper::SetDirectoryListingLength()), Contents
+  // only holds the entries of that range.
+  vtkGetMacro(DirectoryListingSize, int);
+
   // Description:
   // Get the Contents for this directory.
   // Returns a collection with vtkPVFileInformation objects
@@ -120,15 +128,28 @@ protected:
   // are creates file groups, if possible.
   void OrganizeCollection(vtkPVFileInformationSet& vector);
 
+  // Keeps the entries of info_set in the range requested by
+  // DirectoryListingOffset and DirectoryListingLength, sorted by name.
+  void SelectDirectoryListingRange(vtkPVFileInformationSet& info_set,
+    vtkCollection* range);
+
+  // Same as above for a listing already sorted by name.
+  void SelectDirectoryListingRange(const vtkPVFileInformationList& sorted,
+    vtkCollection* range);
+
   bool DetectType();
   void GetSpecialDirectories();
   void SetHiddenFlag( );
   int FastFileTypeDetection;
+  int DirectoryListingOffset;
+  int DirectoryListingLength;
+  int DirectoryListingSize;
 private:
   vtkPVFileInformation(const vtkPVFileInformation&) VTK_DELETE_FUNCTION;
   void operator=(const vtkPVFileInformation&) VTK_DELETE_FUNCTION;
 
   struct vtkInfo;
+  struct vtkTypeDetector;
 
 };
 
@@ -23,6 +23,8 @@ vtkStandardNewMacro(vtkPVFileInformationHelper);
 vtkPVFileInformationHelper::vtkPVFileInformationHelper()
 {
   this->DirectoryListing = 0;
+  this->DirectoryListingOffset = 0;
+  this->DirectoryListingLength = 0;
   this->Path = 0;
   this->WorkingDirectory = 0;
   this->SpecialDirectories = 0;
@@ -64,6 +66,10 @@ void vtkPVFileInformationHelper::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "WorkingDirectory: " <<
     (this->WorkingDirectory? this->WorkingDirectory : "(null)") << endl;
   os << indent << "DirectoryListing: " << this->DirectoryListing << endl;
+  os << indent << "DirectoryListingOffset: "
+    << this->DirectoryListingOffset << endl;
+  os << indent << "DirectoryListingLength: "
+    << this->DirectoryListingLength << endl;
   os << indent << "SpecialDirectories: " << this->SpecialDirectories << endl;
   os << indent << "PathSeparator: " 
     <<  (this->PathSeparator? this->PathSeparator : "(null)") << endl;
@@ -60,6 +60,19 @@ public:
   vtkSetMacro(DirectoryListing, int);
   vtkBooleanMacro(DirectoryListing, int);
 
+  // Description:
+  // Get/Set the range of the directory listing to return. Entries of the
+  // directory, with file groups counted as a single entry, are sorted by
+  // name and only the DirectoryListingLength entries starting at
+  // DirectoryListingOffset are returned, which lets a client fetch a large
+  // directory in several requests. vtkPVFileInformation::GetDirectoryListingSize()
+  // returns the total number of entries. A length of 0 (default) returns all
+  // entries starting at the offset.
+  vtkSetClampMacro(DirectoryListingOffset, int, 0, VTK_INT_MAX);
+  vtkGetMacro(DirectoryListingOffset, int);
+  vtkSetClampMacro(DirectoryListingLength, int, 0, VTK_INT_MAX);
+  vtkGetMacro(DirectoryListingLength, int);
+
   // Description:
   // Get/Set if the query is for special directories.
   // Off by default. If set to true, Path and DirectoryListing 
@@ -99,6 +112,8 @@ protected:
   char* Path;
   char* WorkingDirectory;
   int DirectoryListing;
+  int DirectoryListingOffset;
+  int DirectoryListingLength;
   int SpecialDirectories;
   int FastFileTypeDetection;
 
@@ -0,0 +1,141 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestAMRStreamingPriorityQueue.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that blocks with the same priority are popped in the order of their
+// ids, and that PopWithinBudget() pops a single block until the cost per cell
+// is known, then as many blocks as the budget allows.
+
+#include "vtkAMRBox.h"
+#include "vtkAMRGaussianPulseSource.h"
+#include "vtkAMRInformation.h"
+#include "vtkAMRStreamingPriorityQueue.h"
+#include "vtkNew.h"
+#include "vtkOverlappingAMR.h"
+#include "vtkStreamingPriorityQueue.h"
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+  double GetCost(vtkAMRInformation* amr, unsigned int id)
+    {
+    unsigned int level = 0, index = 0;
+    amr->ComputeIndexPair(id, level, index);
+    return static_cast<double>(amr->GetAMRBox(level, index).GetNumberOfCells());
+    }
+}
+
+#define TEST_ASSERT(condition, message) \
+  if (!(condition)) \
+    { \
+    std::cerr << "ERROR: " << message << std::endl; \
+    return EXIT_FAILURE; \
+    }
+
+int TestAMRStreamingPriorityQueue(int, char* [])
+{
+  // Ties are broken on the identifier, whatever the order of insertion.
+  vtkStreamingPriorityQueue<> ties;
+  const unsigned int tiedIds[] = { 5, 2, 7, 0, 3 };
+  for (int cc=0; cc < 5; cc++)
+    {
+    vtkStreamingPriorityQueueItem item;
+    item.Identifier = tiedIds[cc];
+    item.Priority = 1.0;
+    ties.push(item);
+    }
+  vtkStreamingPriorityQueueItem top;
+  top.Identifier = 9;
+  top.Priority = 2.0;
+  ties.push(top);
+  const unsigned int expectedIds[] = { 9, 0, 2, 3, 5, 7 };
+  for (int cc=0; cc < 6; cc++, ties.pop())
+    {
+    TEST_ASSERT(!ties.empty() && ties.top().Identifier == expectedIds[cc],
+      "Wrong order for blocks with the same priority.");
+    }
+
+  vtkNew<vtkAMRGaussianPulseSource> source;
+  source->SetDimension(3);
+  source->SetNumberOfLevels(2);
+  source->Update();
+  vtkAMRInformation* amr = source->GetOutput()->GetAMRInfo();
+  unsigned int numBlocks = amr->GetTotalNumberOfBlocks();
+  TEST_ASSERT(numBlocks >= 3, "Not enough blocks: " << numBlocks);
+
+  // Without view planes, the blocks are popped in the order of their ids.
+  vtkNew<vtkAMRStreamingPriorityQueue> queue;
+  queue->SetController(NULL);
+  queue->Initialize(amr);
+  TEST_ASSERT(queue->GetNumberOfBlocks() == numBlocks &&
+    queue->GetNumberOfQueuedBlocks() == numBlocks &&
+    queue->GetNumberOfPoppedBlocks() == 0, "Wrong initial statistics.");
+
+  // Until a pass has been timed, a single block is popped.
+  std::vector<unsigned int> ids;
+  queue->PopWithinBudget(1000.0, 100, ids);
+  TEST_ASSERT(ids.size() == 1 && ids[0] == 0,
+    "Uncalibrated queue popped " << ids.size() << " blocks.");
+  TEST_ASSERT(queue->GetNumberOfPoppedBlocks() == 1 &&
+    queue->GetNumberOfQueuedBlocks() == numBlocks - 1,
+    "Wrong statistics after the first pass.");
+
+  const double timePerCell = 0.01;
+  queue->RecordPassTime(GetCost(amr, 0) * timePerCell);
+  TEST_ASSERT(std::fabs(queue->GetEstimatedTimePerCell() - timePerCell) < 1e-9,
+    "Wrong estimated time per cell: " << queue->GetEstimatedTimePerCell());
+
+  // With a budget worth one and a half blocks, the second block reaches the
+  // budget and ends the pass.
+  double budget = (GetCost(amr, 1) + 0.5 * GetCost(amr, 2)) * timePerCell;
+  const unsigned int expected = 2;
+  queue->PopWithinBudget(budget, 100, ids);
+  TEST_ASSERT(ids.size() == expected,
+    "Popped " << ids.size() << " blocks instead of " << expected << ".");
+  for (unsigned int cc=0; cc < expected; cc++)
+    {
+    TEST_ASSERT(ids[cc] == cc + 1, "Wrong block popped: " << ids[cc]);
+    }
+
+  // The estimate is a moving average of the passes.
+  double cells = 0.0;
+  for (unsigned int cc=0; cc < expected; cc++)
+    {
+    cells += GetCost(amr, ids[cc]);
+    }
+  queue->RecordPassTime(cells * 3 * timePerCell);
+  TEST_ASSERT(
+    std::fabs(queue->GetEstimatedTimePerCell() - 2 * timePerCell) < 1e-9,
+    "Wrong moving average: " << queue->GetEstimatedTimePerCell());
+
+  // The cost model survives a new structure.
+  queue->Initialize(amr);
+  TEST_ASSERT(
+    std::fabs(queue->GetEstimatedTimePerCell() - 2 * timePerCell) < 1e-9,
+    "The estimated time per cell was reset by Initialize().");
+
+  // max_blocks bounds the pass whatever the budget.
+  queue->PopWithinBudget(1e12, 1, ids);
+  TEST_ASSERT(ids.size() == 1 && ids[0] == 0, "max_blocks was not honored.");
+  queue->PopWithinBudget(1e12, VTK_INT_MAX, ids);
+  TEST_ASSERT(ids.size() == numBlocks - 1 && queue->IsEmpty(),
+    "A large budget did not pop all the blocks.");
+  TEST_ASSERT(queue->GetNumberOfPoppedBlocks() == numBlocks &&
+    queue->GetNumberOfQueuedBlocks() == 0,
+    "Wrong statistics once all the blocks are popped.");
+
+  return EXIT_SUCCESS;
+}
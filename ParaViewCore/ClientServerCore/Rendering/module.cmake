@@ -26,6 +26,8 @@ vtk_module(vtkPVClientServerCoreRendering
   PRIVATE_DEPENDS
     vtksys
     vtkzlib
+  TEST_DEPENDS
+    vtkTestingCore
   TEST_LABELS
     PARAVIEW
   KIT
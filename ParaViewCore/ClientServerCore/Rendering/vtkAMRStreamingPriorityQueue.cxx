@@ -14,13 +14,16 @@
 =========================================================================*/
 #include "vtkAMRStreamingPriorityQueue.h"
 
+#include "vtkAMRBox.h"
 #include "vtkAMRInformation.h"
 #include "vtkBoundingBox.h"
+#include "vtkCommunicator.h"
 #include "vtkMath.h"
 #include "vtkMultiProcessController.h"
 #include "vtkObjectFactory.h"
 #include "vtkStreamingPriorityQueue.h"
 
+#include <algorithm>
 #include <assert.h>
 #include <queue>
 #include <vector>
@@ -30,8 +33,31 @@ class vtkAMRStreamingPriorityQueue::vtkInternals
 public:
   vtkStreamingPriorityQueue<> PriorityQueue;
   vtkSmartPointer<vtkAMRInformation> AMRMetadata;
+
+  unsigned int NumberOfPoppedBlocks;
+
+  // Cost model, in milliseconds per cell. Negative when nothing has been
+  // measured yet.
+  double TimePerCell;
+  double LastPassCells;
+  double LastPassTime;
+
+  vtkInternals() :
+    NumberOfPoppedBlocks(0),
+    TimePerCell(-1.0),
+    LastPassCells(0.0),
+    LastPassTime(0.0)
+  {
+  }
 };
 
+namespace
+{
+  // Weight of the most recent pass in the running estimate of the time per
+  // cell.
+  const double TIME_PER_CELL_SMOOTHING = 0.5;
+}
+
 vtkStandardNewMacro(vtkAMRStreamingPriorityQueue);
 vtkCxxSetObjectMacro(vtkAMRStreamingPriorityQueue, Controller, vtkMultiProcessController);
 //----------------------------------------------------------------------------
@@ -53,9 +79,12 @@ vtkAMRStreamingPriorityQueue::~vtkAMRStreamingPriorityQueue()
 //----------------------------------------------------------------------------
 void vtkAMRStreamingPriorityQueue::Initialize(vtkAMRInformation* amr)
 {
+  // the cost model remains valid for the new structure.
+  double timePerCell = this->Internals->TimePerCell;
   delete this->Internals;
   this->Internals = new vtkInternals();
   this->Internals->AMRMetadata = amr;
+  this->Internals->TimePerCell = timePerCell;
 
   for (unsigned int cc=0; cc < amr->GetTotalNumberOfBlocks(); cc++)
     {
@@ -71,6 +100,8 @@ void vtkAMRStreamingPriorityQueue::Initialize(vtkAMRInformation* amr)
     double block_bounds[6];
     this->Internals->AMRMetadata->GetBounds(level, index, block_bounds);
     item.Bounds.SetBounds(block_bounds);
+    item.Cost = static_cast<double>(
+      this->Internals->AMRMetadata->GetAMRBox(level, index).GetNumberOfCells());
 
       // default priority is to prefer lower levels. Thus even without
       // view-planes we have reasonable priority.
@@ -113,6 +144,7 @@ unsigned int vtkAMRStreamingPriorityQueue::Pop()
     {
     items[cc] = this->Internals->PriorityQueue.top();
     this->Internals->PriorityQueue.pop();
+    this->Internals->NumberOfPoppedBlocks++;
     }
 
   // at the end, when the queue empties out in the middle of a pop, right now,
@@ -121,6 +153,114 @@ unsigned int vtkAMRStreamingPriorityQueue::Pop()
   return items[myid].Identifier;
 }
 
+//----------------------------------------------------------------------------
+void vtkAMRStreamingPriorityQueue::PopWithinBudget(
+  double budget_ms, int max_blocks, std::vector<unsigned int>& ids)
+{
+  ids.clear();
+
+  int num_procs = this->Controller? this->Controller->GetNumberOfProcesses() : 1;
+  int myid = this->Controller? this->Controller->GetLocalProcessId() : 0;
+  assert(myid < num_procs);
+
+  // Every process pops the same rounds of num_procs blocks and keeps the one
+  // at its own rank. The decision to stop only depends on the queue and on the
+  // (reduced) cost model, so all processes stop after the same round.
+  double timePerCell = this->Internals->TimePerCell;
+  double spent = 0.0;
+  double myCells = 0.0;
+  std::vector<vtkStreamingPriorityQueueItem> items(num_procs);
+  while (!this->IsEmpty() && static_cast<int>(ids.size()) < max_blocks)
+    {
+    double roundCost = 0.0;
+    for (int cc=0; cc < num_procs; cc++)
+      {
+      items[cc] = vtkStreamingPriorityQueueItem();
+      if (!this->Internals->PriorityQueue.empty())
+        {
+        items[cc] = this->Internals->PriorityQueue.top();
+        this->Internals->PriorityQueue.pop();
+        this->Internals->NumberOfPoppedBlocks++;
+        roundCost = std::max(roundCost, items[cc].Cost);
+        }
+      }
+
+    // like Pop(), processes left without a block in the last round ask for
+    // block 0.
+    ids.push_back(items[myid].Identifier);
+    myCells += items[myid].Cost;
+
+    spent += roundCost * std::max(timePerCell, 0.0);
+    if (timePerCell < 0.0 || spent >= budget_ms)
+      {
+      // without any measurement yet, do a single round to calibrate.
+      break;
+      }
+    }
+  this->Internals->LastPassCells = myCells;
+}
+
+//----------------------------------------------------------------------------
+void vtkAMRStreamingPriorityQueue::RecordPassTime(double elapsed_ms)
+{
+  this->Internals->LastPassTime = elapsed_ms;
+
+  // the slowest process dictates the frame rate.
+  double values[2] = { elapsed_ms, this->Internals->LastPassCells };
+  double reduced[2] = { values[0], values[1] };
+  if (this->Controller && this->Controller->GetNumberOfProcesses() > 1)
+    {
+    this->Controller->AllReduce(values, reduced, 2, vtkCommunicator::MAX_OP);
+    }
+  if (reduced[1] <= 0.0)
+    {
+    return;
+    }
+
+  double timePerCell = reduced[0] / reduced[1];
+  if (this->Internals->TimePerCell < 0.0)
+    {
+    this->Internals->TimePerCell = timePerCell;
+    }
+  else
+    {
+    this->Internals->TimePerCell =
+      TIME_PER_CELL_SMOOTHING * timePerCell +
+      (1.0 - TIME_PER_CELL_SMOOTHING) * this->Internals->TimePerCell;
+    }
+}
+
+//----------------------------------------------------------------------------
+unsigned int vtkAMRStreamingPriorityQueue::GetNumberOfBlocks()
+{
+  return this->Internals->AMRMetadata?
+    this->Internals->AMRMetadata->GetTotalNumberOfBlocks() : 0;
+}
+
+//----------------------------------------------------------------------------
+unsigned int vtkAMRStreamingPriorityQueue::GetNumberOfPoppedBlocks()
+{
+  return this->Internals->NumberOfPoppedBlocks;
+}
+
+//----------------------------------------------------------------------------
+unsigned int vtkAMRStreamingPriorityQueue::GetNumberOfQueuedBlocks()
+{
+  return static_cast<unsigned int>(this->Internals->PriorityQueue.size());
+}
+
+//----------------------------------------------------------------------------
+double vtkAMRStreamingPriorityQueue::GetEstimatedTimePerCell()
+{
+  return this->Internals->TimePerCell;
+}
+
+//----------------------------------------------------------------------------
+double vtkAMRStreamingPriorityQueue::GetLastPassTime()
+{
+  return this->Internals->LastPassTime;
+}
+
 //----------------------------------------------------------------------------
 void vtkAMRStreamingPriorityQueue::Update(const double view_planes[24])
 {
@@ -145,4 +285,11 @@ void vtkAMRStreamingPriorityQueue::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
   os << indent << "Controller: " << this->Controller << endl;
+  os << indent << "NumberOfBlocks: " << this->GetNumberOfBlocks() << endl;
+  os << indent << "NumberOfPoppedBlocks: "
+    << this->GetNumberOfPoppedBlocks() << endl;
+  os << indent << "NumberOfQueuedBlocks: "
+    << this->GetNumberOfQueuedBlocks() << endl;
+  os << indent << "EstimatedTimePerCell: "
+    << this->GetEstimatedTimePerCell() << endl;
 }
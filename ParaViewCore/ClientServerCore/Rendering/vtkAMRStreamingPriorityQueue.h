@@ -22,6 +22,12 @@
 // provide the view planes (returned by vtkCamera::GetFrustumPlanes()) to the
 // vtkAMRStreamingPriorityQueue::Update() call to update the prorities for the
 // blocks currently in the queue.
+//
+// Besides Pop(), which hands out one block per process at a time,
+// PopWithinBudget() pops as many blocks as fit in a time budget, using an
+// estimate of the cost per cell that is refined with RecordPassTime() after
+// each streaming pass. The estimate is reduced across processes so that all
+// processes pop the same blocks in the same order.
 // .SECTION See Also
 // vtkAMROutlineRepresentation, vtkAMRStreamingVolumeRepresentation.
 
@@ -31,6 +37,8 @@
 #include "vtkPVClientServerCoreRenderingModule.h" // for export macros
 #include "vtkObject.h"
 
+#include <vector> // for std::vector
+
 class vtkAMRInformation;
 class vtkMultiProcessController;
 
@@ -77,6 +85,38 @@ public:
   // Test if the queue is empty before calling this method.
   unsigned int Pop();
 
+  // Description:
+  // Pops blocks for this process until either the estimated time to fetch and
+  // process them reaches budget_ms, max_blocks blocks have been popped or the
+  // queue is empty. At least one block is popped when the queue is not empty.
+  // The composite ids of the blocks are returned in ids. Like Pop(), this must
+  // be called on all processes.
+  void PopWithinBudget(double budget_ms, int max_blocks,
+    std::vector<unsigned int>& ids);
+
+  // Description:
+  // Records the time it took to fetch and process the blocks last returned by
+  // PopWithinBudget(), to refine the estimated cost per cell. The time is
+  // reduced (max) across processes, hence this must be called on all
+  // processes.
+  void RecordPassTime(double elapsed_ms);
+
+  // Description:
+  // Progress statistics.
+  // GetNumberOfBlocks() returns the number of blocks in the AMR given to
+  // Initialize(), GetNumberOfPoppedBlocks() the number of blocks handed out
+  // (on all processes) since then and GetNumberOfQueuedBlocks() the number of
+  // blocks still in the queue. Blocks culled by Update() are in neither.
+  unsigned int GetNumberOfBlocks();
+  unsigned int GetNumberOfPoppedBlocks();
+  unsigned int GetNumberOfQueuedBlocks();
+
+  // Description:
+  // Returns the current estimate of the time, in milliseconds, needed to
+  // fetch and process a single cell, and the time taken by the last pass.
+  double GetEstimatedTimePerCell();
+  double GetLastPassTime();
+
 protected:
   vtkAMRStreamingPriorityQueue();
   ~vtkAMRStreamingPriorityQueue();
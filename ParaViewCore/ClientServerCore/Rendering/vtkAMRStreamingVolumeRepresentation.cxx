@@ -30,9 +30,13 @@
 #include "vtkRenderWindow.h"
 #include "vtkResampledAMRImageSource.h"
 #include "vtkSmartVolumeMapper.h"
+#include "vtkTimerLog.h"
 #include "vtkUniformGrid.h"
 #include "vtkVolumeProperty.h"
 
+#include <cmath>
+#include <vector>
+
 vtkStandardNewMacro(vtkAMRStreamingVolumeRepresentation);
 //----------------------------------------------------------------------------
 vtkAMRStreamingVolumeRepresentation::vtkAMRStreamingVolumeRepresentation()
@@ -56,6 +60,8 @@ vtkAMRStreamingVolumeRepresentation::vtkAMRStreamingVolumeRepresentation()
     vtkAMRStreamingVolumeRepresentation::RESAMPLE_OVER_DATA_BOUNDS;
 
   this->StreamingRequestSize = 50;
+  this->StreamingTimeBudget = 0.0;
+  this->ResamplingBoundsTolerance = 0.1;
 }
 
 //----------------------------------------------------------------------------
@@ -104,6 +110,10 @@ void vtkAMRStreamingVolumeRepresentation::PrintSelf(ostream& os, vtkIndent inden
     }
   os << indent << "StreamingRequestSize: "
     << this->StreamingRequestSize << endl;
+  os << indent << "StreamingTimeBudget: "
+    << this->StreamingTimeBudget << endl;
+  os << indent << "ResamplingBoundsTolerance: "
+    << this->ResamplingBoundsTolerance << endl;
 }
 
 //----------------------------------------------------------------------------
@@ -236,18 +246,27 @@ int vtkAMRStreamingVolumeRepresentation::RequestUpdateExtent(
         assert(this->PriorityQueue->IsEmpty() == false);
         assert(this->StreamingRequestSize > 0);
 
-        int *request_ids = new int[this->StreamingRequestSize];
-        for (int jj=0; jj < this->StreamingRequestSize; jj++)
+        std::vector<int> request_ids;
+        if (this->StreamingTimeBudget > 0.0)
+          {
+          std::vector<unsigned int> ids;
+          this->PriorityQueue->PopWithinBudget(this->StreamingTimeBudget,
+            this->StreamingRequestSize, ids);
+          request_ids.assign(ids.begin(), ids.end());
+          }
+        else
           {
-          int cid = static_cast<int>(this->PriorityQueue->Pop());
-          //vtkStreamingStatusMacro(<< this << ": requesting blocks: " << cid);
-          request_ids[jj] = cid;
+          for (int jj=0; jj < this->StreamingRequestSize; jj++)
+            {
+            int cid = static_cast<int>(this->PriorityQueue->Pop());
+            //vtkStreamingStatusMacro(<< this << ": requesting blocks: " << cid);
+            request_ids.push_back(cid);
+            }
           }
         // Request the next "group of blocks" to stream.
         info->Set(vtkCompositeDataPipeline::LOAD_REQUESTED_BLOCKS(), 1);
         info->Set(vtkCompositeDataPipeline::UPDATE_COMPOSITE_INDICES(),
-          request_ids, this->StreamingRequestSize);
-        delete [] request_ids;
+          &request_ids[0], static_cast<int>(request_ids.size()));
         }
       else
         {
@@ -349,7 +368,8 @@ bool vtkAMRStreamingVolumeRepresentation::StreamingUpdate(
 
       double bounds[6];
       if (vtkAMRVolumeMapper::ComputeResamplerBoundsFrustumMethod(
-        view->GetActiveCamera(), view->GetRenderer(), data_bounds, bounds))
+        view->GetActiveCamera(), view->GetRenderer(), data_bounds, bounds) &&
+        this->ResamplingBoundsChanged(bounds))
         {
         //vtkStreamingStatusMacro(<< this << ": computed volume bounds : "
         //  << bounds[0] << ", " << bounds[1] << ", " << bounds[2] << ", "
@@ -371,8 +391,18 @@ bool vtkAMRStreamingVolumeRepresentation::StreamingUpdate(
     this->PriorityQueue->Update(view_planes,
       this->Resampler->GetSpatialBounds());
 
+    double start = vtkTimerLog::GetUniversalTime();
     this->MarkModified();
     this->Update();
+    if (this->StreamingTimeBudget > 0.0)
+      {
+      double elapsed_ms = 1000.0 * (vtkTimerLog::GetUniversalTime() - start);
+      this->PriorityQueue->RecordPassTime(elapsed_ms);
+      vtkStreamingStatusMacro(<< this << ": streamed "
+        << this->GetNumberOfStreamedBlocks() << "/"
+        << this->GetNumberOfBlocks() << " blocks, last pass took "
+        << elapsed_ms << " ms.");
+      }
 
     this->InStreamingUpdate = false;
     return true;
@@ -381,6 +411,57 @@ bool vtkAMRStreamingVolumeRepresentation::StreamingUpdate(
   return false;
 }
 
+//----------------------------------------------------------------------------
+bool vtkAMRStreamingVolumeRepresentation::ResamplingBoundsChanged(
+  const double bounds[6])
+{
+  const double* current = this->Resampler->GetSpatialBounds();
+  if (!vtkMath::AreBoundsInitialized(const_cast<double*>(current)))
+    {
+    return true;
+    }
+
+  double diagonal = 0.0;
+  for (int cc=0; cc < 3; cc++)
+    {
+    double length = current[2*cc+1] - current[2*cc];
+    diagonal += length * length;
+    }
+  double tolerance = this->ResamplingBoundsTolerance * sqrt(diagonal);
+  for (int cc=0; cc < 6; cc++)
+    {
+    if (std::abs(bounds[cc] - current[cc]) > tolerance)
+      {
+      return true;
+      }
+    }
+  return false;
+}
+
+//----------------------------------------------------------------------------
+unsigned int vtkAMRStreamingVolumeRepresentation::GetNumberOfBlocks()
+{
+  return this->PriorityQueue->GetNumberOfBlocks();
+}
+
+//----------------------------------------------------------------------------
+unsigned int vtkAMRStreamingVolumeRepresentation::GetNumberOfStreamedBlocks()
+{
+  return this->PriorityQueue->GetNumberOfPoppedBlocks();
+}
+
+//----------------------------------------------------------------------------
+unsigned int vtkAMRStreamingVolumeRepresentation::GetNumberOfQueuedBlocks()
+{
+  return this->PriorityQueue->GetNumberOfQueuedBlocks();
+}
+
+//----------------------------------------------------------------------------
+double vtkAMRStreamingVolumeRepresentation::GetLastStreamingPassTime()
+{
+  return this->PriorityQueue->GetLastPassTime();
+}
+
 //----------------------------------------------------------------------------
 bool vtkAMRStreamingVolumeRepresentation::AddToView(vtkView* view)
 {
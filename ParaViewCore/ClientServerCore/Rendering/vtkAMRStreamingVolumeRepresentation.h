@@ -81,10 +81,37 @@ public:
 
   // Description:
   // Set the number of blocks to request at a given time on a single process
-  // when streaming.
+  // when streaming. When StreamingTimeBudget is set, this is the maximum
+  // number of blocks requested per pass.
   vtkSetClampMacro(StreamingRequestSize, int, 1, 10000);
   vtkGetMacro(StreamingRequestSize, int);
 
+  // Description:
+  // Set the time budget, in milliseconds, for each streaming pass. When
+  // positive, each pass requests as many blocks as the estimated time to
+  // read and process them allows, based on the time taken by previous
+  // passes. When 0 (default), StreamingRequestSize blocks are requested.
+  vtkSetClampMacro(StreamingTimeBudget, double, 0.0, VTK_DOUBLE_MAX);
+  vtkGetMacro(StreamingTimeBudget, double);
+
+  // Description:
+  // When using RESAMPLE_USING_VIEW_FRUSTUM, the resampling grid, and hence the
+  // blocks already streamed, are only discarded when the bounds computed from
+  // the view frustum move by more than this fraction of the current bounds
+  // diagonal. Defaults to 0.1.
+  vtkSetClampMacro(ResamplingBoundsTolerance, double, 0.0, 1.0);
+  vtkGetMacro(ResamplingBoundsTolerance, double);
+
+  // Description:
+  // Streaming progress statistics: the number of blocks in the AMR, the
+  // number of blocks streamed so far, the number of blocks still queued and
+  // the time, in milliseconds, taken by the last streaming pass. These are
+  // only meaningful on the data-server nodes.
+  unsigned int GetNumberOfBlocks();
+  unsigned int GetNumberOfStreamedBlocks();
+  unsigned int GetNumberOfQueuedBlocks();
+  double GetLastStreamingPassTime();
+
 
   // Description:
   // Set the input data arrays that this algorithm will process.
@@ -231,8 +258,15 @@ protected:
   // Used to keep track of data bounds.
   vtkBoundingBox DataBounds;
 
+  // Description:
+  // Returns true if the new bounds differ from the current resampling bounds
+  // by more than ResamplingBoundsTolerance.
+  bool ResamplingBoundsChanged(const double bounds[6]);
+
   int ResamplingMode;
   int StreamingRequestSize;
+  double StreamingTimeBudget;
+  double ResamplingBoundsTolerance;
 
 private:
   vtkAMRStreamingVolumeRepresentation(const vtkAMRStreamingVolumeRepresentation&) VTK_DELETE_FUNCTION;
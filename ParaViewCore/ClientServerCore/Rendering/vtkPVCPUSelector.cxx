@@ -0,0 +1,1131 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkPVCPUSelector.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkPVCPUSelector.h"
+
+#include "vtkActor.h"
+#include "vtkCamera.h"
+#include "vtkCellArray.h"
+#include "vtkCompositeDataDisplayAttributes.h"
+#include "vtkCompositeDataIterator.h"
+#include "vtkCompositeDataSet.h"
+#include "vtkCompositePolyDataMapper2.h"
+#include "vtkDataArray.h"
+#include "vtkIdTypeArray.h"
+#include "vtkInformation.h"
+#include "vtkMapper.h"
+#include "vtkMatrix4x4.h"
+#include "vtkMultiProcessController.h"
+#include "vtkObjectFactory.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkProperty.h"
+#include "vtkPVRenderViewSettings.h"
+#include "vtkRenderer.h"
+#include "vtkSelection.h"
+#include "vtkSelectionNode.h"
+#include "vtkSmartPointer.h"
+#include "vtkSMPTools.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <map>
+#include <vector>
+
+namespace
+{
+  //--------------------------------------------------------------------------
+  // Bounding volume hierarchy over the cells or the points of a polydata.
+  class vtkBVH
+  {
+  public:
+    vtkBVH() : Boxes(NULL) {}
+
+    struct Node
+      {
+      double Bounds[6];
+      vtkIdType Start;
+      vtkIdType Count;
+      // Children, -1 for leaves.
+      int Left;
+      int Right;
+      };
+    std::vector<Node> Nodes;
+    // Cell or point ids, in the order of the leaves.
+    std::vector<vtkIdType> Items;
+
+    // Builds the hierarchy from the bounding boxes of the items, 6 values
+    // per item.
+    void Build(const std::vector<vtkIdType>& items,
+      const std::vector<double>& boxes)
+      {
+      this->Nodes.clear();
+      this->Items = items;
+      this->Boxes = &boxes;
+      this->Centers.resize(items.size() * 3);
+      for (size_t cc=0; cc < items.size(); cc++)
+        {
+        const double* box = &boxes[6 * cc];
+        for (int kk=0; kk < 3; kk++)
+          {
+          this->Centers[3 * cc + kk] = 0.5 * (box[2 * kk] + box[2 * kk + 1]);
+          }
+        }
+      // Work on the item positions, then map them to the ids.
+      std::vector<vtkIdType> order(items.size());
+      for (size_t cc=0; cc < order.size(); cc++)
+        {
+        order[cc] = static_cast<vtkIdType>(cc);
+        }
+      if (!order.empty())
+        {
+        this->BuildNode(order, 0, static_cast<vtkIdType>(order.size()));
+        }
+      for (size_t cc=0; cc < order.size(); cc++)
+        {
+        this->Items[cc] = items[order[cc]];
+        }
+      this->Centers.clear();
+      this->Boxes = NULL;
+      }
+
+  private:
+    static const vtkIdType LeafSize = 8;
+    const std::vector<double>* Boxes;
+    std::vector<double> Centers;
+
+    struct CenterLess
+      {
+      const double* Centers;
+      int Axis;
+      bool operator()(vtkIdType a, vtkIdType b) const
+        {
+        return this->Centers[3 * a + this->Axis] <
+          this->Centers[3 * b + this->Axis];
+        }
+      };
+
+    int BuildNode(std::vector<vtkIdType>& order, vtkIdType start,
+      vtkIdType count)
+      {
+      Node node;
+      node.Start = start;
+      node.Count = count;
+      node.Left = node.Right = -1;
+      double centers[6] = { VTK_DOUBLE_MAX, -VTK_DOUBLE_MAX,
+        VTK_DOUBLE_MAX, -VTK_DOUBLE_MAX, VTK_DOUBLE_MAX, -VTK_DOUBLE_MAX };
+      for (int kk=0; kk < 3; kk++)
+        {
+        node.Bounds[2 * kk] = VTK_DOUBLE_MAX;
+        node.Bounds[2 * kk + 1] = -VTK_DOUBLE_MAX;
+        }
+      for (vtkIdType cc=start; cc < start + count; cc++)
+        {
+        const double* box = &(*this->Boxes)[6 * order[cc]];
+        const double* center = &this->Centers[3 * order[cc]];
+        for (int kk=0; kk < 3; kk++)
+          {
+          node.Bounds[2 * kk] = std::min(node.Bounds[2 * kk], box[2 * kk]);
+          node.Bounds[2 * kk + 1] =
+            std::max(node.Bounds[2 * kk + 1], box[2 * kk + 1]);
+          centers[2 * kk] = std::min(centers[2 * kk], center[kk]);
+          centers[2 * kk + 1] = std::max(centers[2 * kk + 1], center[kk]);
+          }
+        }
+      int index = static_cast<int>(this->Nodes.size());
+      this->Nodes.push_back(node);
+      if (count <= LeafSize)
+        {
+        return index;
+        }
+
+      // Split at the median of the centers along the longest axis.
+      CenterLess less;
+      less.Centers = &this->Centers[0];
+      less.Axis = 0;
+      for (int kk=1; kk < 3; kk++)
+        {
+        if (centers[2 * kk + 1] - centers[2 * kk] >
+          centers[2 * less.Axis + 1] - centers[2 * less.Axis])
+          {
+          less.Axis = kk;
+          }
+        }
+      vtkIdType half = count / 2;
+      std::nth_element(order.begin() + start, order.begin() + start + half,
+        order.begin() + start + count, less);
+      int left = this->BuildNode(order, start, half);
+      int right = this->BuildNode(order, start + half, count - half);
+      this->Nodes[index].Left = left;
+      this->Nodes[index].Right = right;
+      return index;
+      }
+  };
+
+  //--------------------------------------------------------------------------
+  // What is cached for a polydata: where to find the points of each cell,
+  // in the cell id order used by the mappers (verts, lines, polys then
+  // strips), and the hierarchies, built when first needed.
+  struct vtkPolyDataCache
+    {
+    unsigned long MTime;
+    bool Used;
+    const vtkIdType* Cells[4];
+    vtkIdType FirstCell[5];
+    std::vector<vtkIdType> Locations;
+    bool HasCellBVH;
+    vtkBVH CellBVH;
+    bool HasPointBVH;
+    vtkBVH PointBVH;
+
+    void Initialize(vtkPolyData* pd)
+      {
+      this->MTime = pd->GetMTime();
+      this->HasCellBVH = this->HasPointBVH = false;
+      this->CellBVH = vtkBVH();
+      this->PointBVH = vtkBVH();
+      vtkCellArray* arrays[4] = { pd->GetVerts(), pd->GetLines(),
+        pd->GetPolys(), pd->GetStrips() };
+      this->Locations.clear();
+      this->Locations.reserve(pd->GetNumberOfCells());
+      this->FirstCell[0] = 0;
+      for (int type=0; type < 4; type++)
+        {
+        vtkIdType size = arrays[type]->GetNumberOfConnectivityEntries();
+        this->Cells[type] = size > 0? arrays[type]->GetPointer() : NULL;
+        for (vtkIdType loc=0; loc < size; loc += this->Cells[type][loc] + 1)
+          {
+          this->Locations.push_back(loc);
+          }
+        this->FirstCell[type + 1] =
+          static_cast<vtkIdType>(this->Locations.size());
+        }
+      }
+
+    int GetCellType(vtkIdType cellId) const
+      {
+      int type = 0;
+      while (cellId >= this->FirstCell[type + 1])
+        {
+        type++;
+        }
+      return type;
+      }
+
+    const vtkIdType* GetCell(vtkIdType cellId, int type) const
+      {
+      return this->Cells[type] + this->Locations[cellId];
+      }
+
+    void BuildCellBVH(vtkPoints* points)
+      {
+      vtkIdType numCells = static_cast<vtkIdType>(this->Locations.size());
+      std::vector<vtkIdType> items(numCells);
+      std::vector<double> boxes(6 * numCells);
+      double x[3];
+      for (vtkIdType cellId=0; cellId < numCells; cellId++)
+        {
+        items[cellId] = cellId;
+        double* box = &boxes[6 * cellId];
+        box[0] = box[2] = box[4] = VTK_DOUBLE_MAX;
+        box[1] = box[3] = box[5] = -VTK_DOUBLE_MAX;
+        const vtkIdType* cell = this->GetCell(cellId, this->GetCellType(cellId));
+        for (vtkIdType cc=1; cc <= cell[0]; cc++)
+          {
+          points->GetPoint(cell[cc], x);
+          for (int kk=0; kk < 3; kk++)
+            {
+            box[2 * kk] = std::min(box[2 * kk], x[kk]);
+            box[2 * kk + 1] = std::max(box[2 * kk + 1], x[kk]);
+            }
+          }
+        }
+      this->CellBVH.Build(items, boxes);
+      this->HasCellBVH = true;
+      }
+
+    void BuildPointBVH(vtkPoints* points)
+      {
+      // Only the points used by the cells are rendered.
+      std::vector<char> used(points->GetNumberOfPoints(), 0);
+      for (int type=0; type < 4; type++)
+        {
+        for (vtkIdType cellId=this->FirstCell[type];
+          cellId < this->FirstCell[type + 1]; cellId++)
+          {
+          const vtkIdType* cell = this->GetCell(cellId, type);
+          for (vtkIdType cc=1; cc <= cell[0]; cc++)
+            {
+            used[cell[cc]] = 1;
+            }
+          }
+        }
+      std::vector<vtkIdType> items;
+      std::vector<double> boxes;
+      double x[3];
+      for (vtkIdType ptId=0; ptId < static_cast<vtkIdType>(used.size()); ptId++)
+        {
+        if (used[ptId])
+          {
+          points->GetPoint(ptId, x);
+          items.push_back(ptId);
+          double box[6] = { x[0], x[0], x[1], x[1], x[2], x[2] };
+          boxes.insert(boxes.end(), box, box + 6);
+          }
+        }
+      this->PointBVH.Build(items, boxes);
+      this->HasPointBVH = true;
+      }
+    };
+
+  enum
+    {
+    VERTEX = 0,
+    LINE = 1,
+    TRIANGLE = 2
+    };
+
+  //--------------------------------------------------------------------------
+  // A primitive to rasterize, in display coordinates with the normalized
+  // depth.
+  struct vtkPrimitive
+    {
+    int Kind;
+    int Item;
+    vtkIdType Id;
+    int ProcessId;
+    float Size;
+    float X[3];
+    float Y[3];
+    float Z[3];
+    };
+
+  //--------------------------------------------------------------------------
+  // A block of a prop to select from.
+  struct vtkItem
+    {
+    int PropId;
+    bool Composite;
+    unsigned int FlatIndex;
+    vtkPolyData* Data;
+    vtkPolyDataCache* Cache;
+    // Object to display coordinates.
+    double Matrix[16];
+    int Representation;
+    float PointSize;
+    float LineWidth;
+    vtkDataArray* ProcessIds;
+    };
+
+  //--------------------------------------------------------------------------
+  // Transforms a point to display coordinates, returns false when it is
+  // behind the camera.
+  bool Project(const double m[16], const double x[3], float out[3])
+    {
+    double w = m[12] * x[0] + m[13] * x[1] + m[14] * x[2] + m[15];
+    if (w <= 0.0)
+      {
+      return false;
+      }
+    out[0] = static_cast<float>(
+      (m[0] * x[0] + m[1] * x[1] + m[2] * x[2] + m[3]) / w);
+    out[1] = static_cast<float>(
+      (m[4] * x[0] + m[5] * x[1] + m[6] * x[2] + m[7]) / w);
+    out[2] = static_cast<float>(
+      (m[8] * x[0] + m[9] * x[1] + m[10] * x[2] + m[11]) / w);
+    return true;
+    }
+
+  //--------------------------------------------------------------------------
+  // Collects the items of the hierarchy that may be in the region.
+  void Query(const vtkBVH& bvh, const double m[16], const double region[4],
+    std::vector<vtkIdType>& result)
+    {
+    if (bvh.Nodes.empty())
+      {
+      return;
+      }
+    std::vector<int> stack(1, 0);
+    while (!stack.empty())
+      {
+      const vtkBVH::Node& node = bvh.Nodes[stack.back()];
+      stack.pop_back();
+
+      bool overlaps = true;
+      double rect[4] = { VTK_DOUBLE_MAX, -VTK_DOUBLE_MAX,
+        VTK_DOUBLE_MAX, -VTK_DOUBLE_MAX };
+      double zmin = VTK_DOUBLE_MAX, zmax = -VTK_DOUBLE_MAX;
+      for (int corner=0; corner < 8 && overlaps; corner++)
+        {
+        double x[3] = { node.Bounds[(corner & 1)], node.Bounds[2 + ((corner >> 1) & 1)],
+          node.Bounds[4 + ((corner >> 2) & 1)] };
+        float p[3];
+        if (!Project(m, x, p))
+          {
+          // Partly behind the camera: look at the children.
+          rect[0] = -VTK_DOUBLE_MAX;
+          break;
+          }
+        rect[0] = std::min(rect[0], static_cast<double>(p[0]));
+        rect[1] = std::max(rect[1], static_cast<double>(p[0]));
+        rect[2] = std::min(rect[2], static_cast<double>(p[1]));
+        rect[3] = std::max(rect[3], static_cast<double>(p[1]));
+        zmin = std::min(zmin, static_cast<double>(p[2]));
+        zmax = std::max(zmax, static_cast<double>(p[2]));
+        }
+      if (rect[0] != -VTK_DOUBLE_MAX)
+        {
+        overlaps = rect[1] >= region[0] && rect[0] <= region[1] &&
+          rect[3] >= region[2] && rect[2] <= region[3] &&
+          zmax >= -1.0 && zmin <= 1.0;
+        }
+      if (!overlaps)
+        {
+        continue;
+        }
+      if (node.Left < 0)
+        {
+        result.insert(result.end(), bvh.Items.begin() + node.Start,
+          bvh.Items.begin() + node.Start + node.Count);
+        }
+      else
+        {
+        stack.push_back(node.Left);
+        stack.push_back(node.Right);
+        }
+      }
+    }
+
+  //--------------------------------------------------------------------------
+  // Depth and primitive of a pixel.
+  struct vtkFragment
+    {
+    float Z;
+    vtkIdType Primitive;
+    };
+
+  //--------------------------------------------------------------------------
+  // Rasterizes the primitives in bands of rows, in parallel.
+  class vtkRasterizer
+  {
+  public:
+    const std::vector<vtkPrimitive>* Primitives;
+    std::vector<vtkFragment>* Fragments;
+    // Inclusive pixel range.
+    int Region[4];
+    int BandHeight;
+
+    void operator()(vtkIdType begin, vtkIdType end)
+      {
+      int width = this->Region[2] - this->Region[0] + 1;
+      for (vtkIdType band=begin; band < end; band++)
+        {
+        int rows[2] = { this->Region[1] + static_cast<int>(band) * this->BandHeight, 0 };
+        rows[1] = std::min(rows[0] + this->BandHeight - 1, this->Region[3]);
+        for (size_t cc=0; cc < this->Primitives->size(); cc++)
+          {
+          const vtkPrimitive& prim = (*this->Primitives)[cc];
+          vtkIdType index = static_cast<vtkIdType>(cc);
+          switch (prim.Kind)
+            {
+          case VERTEX:
+            this->Square(prim.X[0], prim.Y[0], prim.Z[0], prim.Size,
+              rows, width, index);
+            break;
+          case LINE:
+            this->Line(prim, rows, width, index);
+            break;
+          default:
+            this->Triangle(prim, rows, width, index);
+            }
+          }
+        }
+      }
+
+  private:
+    void Write(int x, int y, float z, int width, vtkIdType index)
+      {
+      if (z < -1.0f || z > 1.0f)
+        {
+        return;
+        }
+      vtkFragment& fragment = (*this->Fragments)[
+        static_cast<size_t>(y - this->Region[1]) * width + (x - this->Region[0])];
+      if (z < fragment.Z)
+        {
+        fragment.Z = z;
+        fragment.Primitive = index;
+        }
+      }
+
+    void Square(float x, float y, float z, float size, const int rows[2],
+      int width, vtkIdType index)
+      {
+      int s = std::max(1, static_cast<int>(size + 0.5f));
+      int x0 = static_cast<int>(std::floor(x - 0.5f * s + 0.5f));
+      int y0 = static_cast<int>(std::floor(y - 0.5f * s + 0.5f));
+      int xmin = std::max(x0, this->Region[0]);
+      int xmax = std::min(x0 + s - 1, this->Region[2]);
+      int ymin = std::max(y0, rows[0]);
+      int ymax = std::min(y0 + s - 1, rows[1]);
+      for (int py=ymin; py <= ymax; py++)
+        {
+        for (int px=xmin; px <= xmax; px++)
+          {
+          this->Write(px, py, z, width, index);
+          }
+        }
+      }
+
+    void Line(const vtkPrimitive& prim, const int rows[2], int width,
+      vtkIdType index)
+      {
+      float dx = prim.X[1] - prim.X[0];
+      float dy = prim.Y[1] - prim.Y[0];
+      float half = 0.5f * prim.Size + 1.0f;
+      if (std::max(prim.Y[0], prim.Y[1]) + half < rows[0] ||
+        std::min(prim.Y[0], prim.Y[1]) - half > rows[1] + 1)
+        {
+        return;
+        }
+      int steps = static_cast<int>(std::ceil(std::max(std::fabs(dx), std::fabs(dy))));
+      for (int cc=0; cc <= steps; cc++)
+        {
+        float t = steps > 0? static_cast<float>(cc) / steps : 0.0f;
+        this->Square(prim.X[0] + t * dx, prim.Y[0] + t * dy,
+          prim.Z[0] + t * (prim.Z[1] - prim.Z[0]), prim.Size, rows, width, index);
+        }
+      }
+
+    void Triangle(const vtkPrimitive& prim, const int rows[2], int width,
+      vtkIdType index)
+      {
+      const float* X = prim.X;
+      const float* Y = prim.Y;
+      float area = (X[1] - X[0]) * (Y[2] - Y[0]) - (X[2] - X[0]) * (Y[1] - Y[0]);
+      if (area == 0.0f)
+        {
+        return;
+        }
+      // Pixel centers are at half-integer coordinates.
+      int xmin = std::max(this->Region[0], static_cast<int>(
+          std::ceil(std::min(X[0], std::min(X[1], X[2])) - 0.5f)));
+      int xmax = std::min(this->Region[2], static_cast<int>(
+          std::floor(std::max(X[0], std::max(X[1], X[2])) - 0.5f)));
+      int ymin = std::max(rows[0], static_cast<int>(
+          std::ceil(std::min(Y[0], std::min(Y[1], Y[2])) - 0.5f)));
+      int ymax = std::min(rows[1], static_cast<int>(
+          std::floor(std::max(Y[0], std::max(Y[1], Y[2])) - 0.5f)));
+      for (int py=ymin; py <= ymax; py++)
+        {
+        float cy = py + 0.5f;
+        for (int px=xmin; px <= xmax; px++)
+          {
+          float cx = px + 0.5f;
+          float w0 = ((X[1] - cx) * (Y[2] - cy) - (X[2] - cx) * (Y[1] - cy)) / area;
+          float w1 = ((X[2] - cx) * (Y[0] - cy) - (X[0] - cx) * (Y[2] - cy)) / area;
+          float w2 = 1.0f - w0 - w1;
+          if (w0 >= 0.0f && w1 >= 0.0f && w2 >= 0.0f)
+            {
+            this->Write(px, py, w0 * prim.Z[0] + w1 * prim.Z[1] + w2 * prim.Z[2],
+              width, index);
+            }
+          }
+        }
+      }
+  };
+
+  //--------------------------------------------------------------------------
+  bool InsidePolygon(const int* polygon, vtkIdType count, double x, double y)
+    {
+    bool inside = false;
+    for (vtkIdType i=0, j=count - 1; i < count; j = i++)
+      {
+      double xi = polygon[2 * i], yi = polygon[2 * i + 1];
+      double xj = polygon[2 * j], yj = polygon[2 * j + 1];
+      if (((yi > y) != (yj > y)) &&
+        (x < (xj - xi) * (y - yi) / (yj - yi) + xi))
+        {
+        inside = !inside;
+        }
+      }
+    return inside;
+    }
+}
+
+class vtkPVCPUSelector::vtkInternals
+{
+public:
+  std::map<vtkProp*, int> Props;
+  std::map<vtkPolyData*, vtkPolyDataCache> Caches;
+  std::vector<vtkItem> Items;
+  std::vector<vtkPrimitive> Primitives;
+
+  vtkPolyDataCache* GetCache(vtkPolyData* pd)
+    {
+    vtkPolyDataCache& cache = this->Caches[pd];
+    if (cache.Locations.empty() || cache.MTime != pd->GetMTime())
+      {
+      cache.Initialize(pd);
+      }
+    cache.Used = true;
+    return &cache;
+    }
+
+  void AddItem(vtkItem& item, vtkPolyData* pd)
+    {
+    if (pd == NULL || pd->GetNumberOfCells() == 0 || pd->GetPoints() == NULL)
+      {
+      return;
+      }
+    item.Data = pd;
+    item.Cache = this->GetCache(pd);
+    item.ProcessIds = pd->GetPointData()->GetArray("vtkProcessId");
+    this->Items.push_back(item);
+    }
+
+  // Adds the primitives of an item that may be in the region.
+  void AddPrimitives(int itemIndex, int fieldAssociation,
+    const double region[4])
+    {
+    vtkItem& item = this->Items[itemIndex];
+    vtkPoints* points = item.Data->GetPoints();
+    vtkPolyDataCache& cache = *item.Cache;
+    bool selectPoints =
+      (fieldAssociation == vtkDataObject::FIELD_ASSOCIATION_POINTS);
+    float margin = std::max(item.PointSize, item.LineWidth);
+    double bounds[4] = { region[0] - margin, region[1] + margin,
+      region[2] - margin, region[3] + margin };
+
+    std::vector<vtkIdType> candidates;
+    if (selectPoints)
+      {
+      if (!cache.HasPointBVH)
+        {
+        cache.BuildPointBVH(points);
+        }
+      Query(cache.PointBVH, item.Matrix, bounds, candidates);
+      }
+    else
+      {
+      if (!cache.HasCellBVH)
+        {
+        cache.BuildCellBVH(points);
+        }
+      Query(cache.CellBVH, item.Matrix, bounds, candidates);
+      }
+
+    vtkPrimitive prim;
+    prim.Item = itemIndex;
+    double x[3];
+    float p[3];
+    for (size_t cc=0; cc < candidates.size(); cc++)
+      {
+      vtkIdType id = candidates[cc];
+      prim.Id = id;
+      if (selectPoints)
+        {
+        points->GetPoint(id, x);
+        prim.ProcessId = this->GetProcessId(item, id);
+        if (Project(item.Matrix, x, p))
+          {
+          this->AddVertex(prim, p, item.PointSize);
+          }
+        continue;
+        }
+
+      int type = cache.GetCellType(id);
+      const vtkIdType* cell = cache.GetCell(id, type);
+      vtkIdType npts = cell[0];
+      const vtkIdType* pts = cell + 1;
+      prim.ProcessId = npts > 0? this->GetProcessId(item, pts[0]) : -1;
+
+      // Project the points of the cell, skipping the cells partly behind the
+      // camera.
+      std::vector<float>& projected = this->Projected;
+      projected.resize(3 * npts);
+      bool visible = true;
+      for (vtkIdType kk=0; kk < npts && visible; kk++)
+        {
+        points->GetPoint(pts[kk], x);
+        visible = Project(item.Matrix, x, &projected[3 * kk]);
+        }
+      if (!visible || npts == 0)
+        {
+        continue;
+        }
+      const float* P = &projected[0];
+
+      int representation = item.Representation;
+      if (type == 0 || representation == VTK_POINTS)
+        {
+        for (vtkIdType kk=0; kk < npts; kk++)
+          {
+          this->AddVertex(prim, P + 3 * kk, item.PointSize);
+          }
+        }
+      else if (type == 1)
+        {
+        for (vtkIdType kk=0; kk + 1 < npts; kk++)
+          {
+          this->AddLine(prim, P + 3 * kk, P + 3 * kk + 3, item.LineWidth);
+          }
+        }
+      else if (representation == VTK_WIREFRAME)
+        {
+        if (type == 2)
+          {
+          for (vtkIdType kk=0; kk < npts; kk++)
+            {
+            this->AddLine(prim, P + 3 * kk, P + 3 * ((kk + 1) % npts),
+              item.LineWidth);
+            }
+          }
+        else
+          {
+          for (vtkIdType kk=0; kk + 1 < npts; kk++)
+            {
+            this->AddLine(prim, P + 3 * kk, P + 3 * kk + 3, item.LineWidth);
+            if (kk + 2 < npts)
+              {
+              this->AddLine(prim, P + 3 * kk, P + 3 * kk + 6, item.LineWidth);
+              }
+            }
+          }
+        }
+      else if (type == 2)
+        {
+        // Polygons are assumed convex, as for rendering.
+        for (vtkIdType kk=1; kk + 1 < npts; kk++)
+          {
+          this->AddTriangle(prim, P, P + 3 * kk, P + 3 * kk + 3);
+          }
+        }
+      else
+        {
+        for (vtkIdType kk=0; kk + 2 < npts; kk++)
+          {
+          this->AddTriangle(prim, P + 3 * kk, P + 3 * kk + 3, P + 3 * kk + 6);
+          }
+        }
+      }
+    }
+
+  int GetProcessId(const vtkItem& item, vtkIdType ptId) const
+    {
+    return item.ProcessIds?
+      static_cast<int>(item.ProcessIds->GetTuple1(ptId)) : this->ProcessId;
+    }
+
+  int ProcessId;
+
+private:
+  std::vector<float> Projected;
+
+  void AddVertex(vtkPrimitive& prim, const float* p, float size)
+    {
+    prim.Kind = VERTEX;
+    prim.Size = size;
+    prim.X[0] = p[0];
+    prim.Y[0] = p[1];
+    prim.Z[0] = p[2];
+    this->Primitives.push_back(prim);
+    }
+
+  void AddLine(vtkPrimitive& prim, const float* p0, const float* p1,
+    float width)
+    {
+    prim.Kind = LINE;
+    prim.Size = width;
+    prim.X[0] = p0[0]; prim.Y[0] = p0[1]; prim.Z[0] = p0[2];
+    prim.X[1] = p1[0]; prim.Y[1] = p1[1]; prim.Z[1] = p1[2];
+    this->Primitives.push_back(prim);
+    }
+
+  void AddTriangle(vtkPrimitive& prim, const float* p0, const float* p1,
+    const float* p2)
+    {
+    prim.Kind = TRIANGLE;
+    prim.Size = 0;
+    prim.X[0] = p0[0]; prim.Y[0] = p0[1]; prim.Z[0] = p0[2];
+    prim.X[1] = p1[0]; prim.Y[1] = p1[1]; prim.Z[1] = p1[2];
+    prim.X[2] = p2[0]; prim.Y[2] = p2[1]; prim.Z[2] = p2[2];
+    this->Primitives.push_back(prim);
+    }
+};
+
+vtkStandardNewMacro(vtkPVCPUSelector);
+vtkCxxSetObjectMacro(vtkPVCPUSelector, Controller, vtkMultiProcessController);
+//----------------------------------------------------------------------------
+vtkPVCPUSelector::vtkPVCPUSelector()
+  : FieldAssociation(vtkDataObject::FIELD_ASSOCIATION_CELLS),
+  ProcessId(0),
+  Controller(NULL)
+{
+  this->Internals = new vtkInternals();
+}
+
+//----------------------------------------------------------------------------
+vtkPVCPUSelector::~vtkPVCPUSelector()
+{
+  this->SetController(NULL);
+  delete this->Internals;
+  this->Internals = NULL;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVCPUSelector::SetRenderer(vtkRenderer* renderer)
+{
+  if (this->Renderer != renderer)
+    {
+    this->Renderer = renderer;
+    this->Modified();
+    }
+}
+
+//----------------------------------------------------------------------------
+vtkRenderer* vtkPVCPUSelector::GetRenderer()
+{
+  return this->Renderer;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVCPUSelector::AddProp(vtkProp* prop, int id)
+{
+  this->Internals->Props[prop] = id;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVCPUSelector::RemoveProp(vtkProp* prop)
+{
+  this->Internals->Props.erase(prop);
+}
+
+//----------------------------------------------------------------------------
+void vtkPVCPUSelector::ReleaseCache()
+{
+  this->Internals->Caches.clear();
+}
+
+//----------------------------------------------------------------------------
+vtkSelection* vtkPVCPUSelector::Select(int region[4])
+{
+  vtkSelection* sel = this->SelectInternal(region, NULL, 0, NULL);
+  int radius = vtkPVRenderViewSettings::GetInstance()->GetPointPickingRadius();
+  if (this->FieldAssociation == vtkDataObject::FIELD_ASSOCIATION_POINTS &&
+    region[0] == region[2] && region[1] == region[3] && radius > 0)
+    {
+    int numNodes = static_cast<int>(sel->GetNumberOfNodes());
+    if (this->Controller && this->Controller->GetNumberOfProcesses() > 1)
+      {
+      int localNumNodes = numNodes;
+      this->Controller->AllReduce(&localNumNodes, &numNodes, 1,
+        vtkCommunicator::SUM_OP);
+      }
+    if (numNodes > 0)
+      {
+      return sel;
+      }
+
+    // Select the closest point, as vtkPVHardwareSelector does.
+    int expanded[4] = { region[0] - radius, region[1] - radius,
+      region[2] + radius, region[3] + radius };
+    sel->Delete();
+    sel = this->SelectInternal(expanded, NULL, 0, region);
+    }
+  return sel;
+}
+
+//----------------------------------------------------------------------------
+vtkSelection* vtkPVCPUSelector::PolygonSelect(
+  int* polygonPoints, vtkIdType count)
+{
+  if (count < 3)
+    {
+    return vtkSelection::New();
+    }
+  int region[4] = { polygonPoints[0], polygonPoints[1],
+    polygonPoints[0], polygonPoints[1] };
+  for (vtkIdType cc=1; cc < count; cc++)
+    {
+    region[0] = std::min(region[0], polygonPoints[2 * cc]);
+    region[1] = std::min(region[1], polygonPoints[2 * cc + 1]);
+    region[2] = std::max(region[2], polygonPoints[2 * cc]);
+    region[3] = std::max(region[3], polygonPoints[2 * cc + 1]);
+    }
+  return this->SelectInternal(region, polygonPoints, count, NULL);
+}
+
+//----------------------------------------------------------------------------
+vtkSelection* vtkPVCPUSelector::SelectInternal(int inRegion[4],
+  int* polygonPoints, vtkIdType count, int* closestTo)
+{
+  vtkSelection* sel = vtkSelection::New();
+  vtkRenderer* renderer = this->Renderer;
+  if (renderer == NULL)
+    {
+    vtkErrorMacro("No renderer set.");
+    return sel;
+    }
+
+  // Clamp the region to the viewport.
+  int* size = renderer->GetSize();
+  int* origin = renderer->GetOrigin();
+  int region[4] = {
+    std::max(std::min(inRegion[0], inRegion[2]), origin[0]),
+    std::max(std::min(inRegion[1], inRegion[3]), origin[1]),
+    std::min(std::max(inRegion[0], inRegion[2]), origin[0] + size[0] - 1),
+    std::min(std::max(inRegion[1], inRegion[3]), origin[1] + size[1] - 1) };
+  if (region[0] > region[2] || region[1] > region[3])
+    {
+    return sel;
+    }
+
+  // World to display coordinates, with the normalized depth.
+  double viewport[16] = {
+    0.5 * size[0], 0, 0, origin[0] + 0.5 * size[0],
+    0, 0.5 * size[1], 0, origin[1] + 0.5 * size[1],
+    0, 0, 1, 0,
+    0, 0, 0, 1 };
+  double world[16];
+  vtkMatrix4x4::Multiply4x4(viewport,
+    *renderer->GetActiveCamera()->GetCompositeProjectionTransformMatrix(
+      renderer->GetTiledAspectRatio(), -1, 1)->Element, world);
+
+  // List the blocks of the props to select from.
+  vtkInternals& internals = *this->Internals;
+  internals.ProcessId = this->ProcessId;
+  internals.Items.clear();
+  internals.Primitives.clear();
+  for (std::map<vtkPolyData*, vtkPolyDataCache>::iterator iter =
+    internals.Caches.begin(); iter != internals.Caches.end(); ++iter)
+    {
+    iter->second.Used = false;
+    }
+  for (std::map<vtkProp*, int>::iterator iter = internals.Props.begin();
+    iter != internals.Props.end(); ++iter)
+    {
+    vtkActor* actor = vtkActor::SafeDownCast(iter->first);
+    if (!actor || !actor->GetVisibility() || !actor->GetPickable() ||
+      !actor->GetMapper() || !renderer->HasViewProp(actor))
+      {
+      continue;
+      }
+    vtkItem item;
+    item.PropId = iter->second;
+    item.Composite = false;
+    item.FlatIndex = 0;
+    vtkMatrix4x4::Multiply4x4(world, *actor->GetMatrix()->Element,
+      item.Matrix);
+    vtkProperty* property = actor->GetProperty();
+    item.Representation = property->GetRepresentation();
+    item.PointSize = property->GetPointSize();
+    item.LineWidth = property->GetLineWidth();
+
+    vtkDataObject* input = actor->GetMapper()->GetInputDataObject(0, 0);
+    if (vtkCompositeDataSet* cd = vtkCompositeDataSet::SafeDownCast(input))
+      {
+      vtkCompositePolyDataMapper2* cpm =
+        vtkCompositePolyDataMapper2::SafeDownCast(actor->GetMapper());
+      vtkCompositeDataDisplayAttributes* attributes =
+        cpm? cpm->GetCompositeDataDisplayAttributes() : NULL;
+      vtkSmartPointer<vtkCompositeDataIterator> citer;
+      citer.TakeReference(cd->NewIterator());
+      for (citer->InitTraversal(); !citer->IsDoneWithTraversal();
+        citer->GoToNextItem())
+        {
+        item.Composite = true;
+        item.FlatIndex = citer->GetCurrentFlatIndex();
+        if (attributes && attributes->HasBlockVisibility(item.FlatIndex) &&
+          !attributes->GetBlockVisibility(item.FlatIndex))
+          {
+          continue;
+          }
+        internals.AddItem(item,
+          vtkPolyData::SafeDownCast(citer->GetCurrentDataObject()));
+        }
+      }
+    else
+      {
+      internals.AddItem(item, vtkPolyData::SafeDownCast(input));
+      }
+    }
+
+  // Find the primitives that may be in the region using the hierarchies.
+  double bounds[4] = { static_cast<double>(region[0]), region[2] + 1.0,
+    static_cast<double>(region[1]), region[3] + 1.0 };
+  for (size_t cc=0; cc < internals.Items.size(); cc++)
+    {
+    internals.AddPrimitives(static_cast<int>(cc), this->FieldAssociation,
+      bounds);
+    }
+
+  // Forget the datasets not shown anymore.
+  std::map<vtkPolyData*, vtkPolyDataCache>::iterator citer =
+    internals.Caches.begin();
+  while (citer != internals.Caches.end())
+    {
+    if (!citer->second.Used)
+      {
+      internals.Caches.erase(citer++);
+      }
+    else
+      {
+      ++citer;
+      }
+    }
+
+  // Rasterize them to keep the visible ones.
+  int width = region[2] - region[0] + 1;
+  int height = region[3] - region[1] + 1;
+  vtkFragment empty = { VTK_FLOAT_MAX, -1 };
+  std::vector<vtkFragment> fragments(
+    static_cast<size_t>(width) * height, empty);
+  vtkRasterizer rasterizer;
+  rasterizer.Primitives = &internals.Primitives;
+  rasterizer.Fragments = &fragments;
+  std::copy(region, region + 4, rasterizer.Region);
+  rasterizer.BandHeight = std::max(16, height / 64);
+  vtkSMPTools::For(0, (height + rasterizer.BandHeight - 1) / rasterizer.BandHeight,
+    1, rasterizer);
+
+  // In parallel, keep only the fragments in front of those of the other
+  // processes.
+  bool parallel =
+    this->Controller && this->Controller->GetNumberOfProcesses() > 1;
+  if (parallel)
+    {
+    std::vector<float> depth(fragments.size());
+    std::vector<float> minDepth(fragments.size());
+    for (size_t cc=0; cc < fragments.size(); cc++)
+      {
+      depth[cc] = fragments[cc].Z;
+      }
+    this->Controller->AllReduce(&depth[0], &minDepth[0],
+      static_cast<vtkIdType>(depth.size()), vtkCommunicator::MIN_OP);
+    for (size_t cc=0; cc < fragments.size(); cc++)
+      {
+      if (fragments[cc].Z > minDepth[cc])
+        {
+        fragments[cc].Primitive = -1;
+        }
+      }
+    }
+
+  // Gather the selected ids for each prop, block and process.
+  typedef std::pair<std::pair<int, unsigned int>, int> KeyType;
+  std::map<KeyType, std::vector<vtkIdType> > selected;
+  std::map<KeyType, bool> composite;
+  vtkIdType closest = -1;
+  int closestDistance = VTK_INT_MAX;
+  for (int py=region[1]; py <= region[3]; py++)
+    {
+    for (int px=region[0]; px <= region[2]; px++)
+      {
+      vtkIdType primIndex = fragments[
+        static_cast<size_t>(py - region[1]) * width + (px - region[0])].Primitive;
+      if (primIndex < 0 || (polygonPoints &&
+          !InsidePolygon(polygonPoints, count, px + 0.5, py + 0.5)))
+        {
+        continue;
+        }
+      if (closestTo)
+        {
+        int distance = std::max(std::abs(px - closestTo[0]),
+          std::abs(py - closestTo[1]));
+        if (distance < closestDistance)
+          {
+          closestDistance = distance;
+          closest = primIndex;
+          }
+        continue;
+        }
+      const vtkPrimitive& prim = internals.Primitives[primIndex];
+      const vtkItem& item = internals.Items[prim.Item];
+      KeyType key(std::make_pair(item.PropId, item.FlatIndex), prim.ProcessId);
+      selected[key].push_back(prim.Id);
+      composite[key] = item.Composite;
+      }
+    }
+  if (closestTo && parallel)
+    {
+    // The closest element over all the processes wins, the lowest rank on
+    // ties.
+    int numProcs = this->Controller->GetNumberOfProcesses();
+    int local = closest >= 0? closestDistance * numProcs +
+      this->Controller->GetLocalProcessId() : VTK_INT_MAX;
+    int global = VTK_INT_MAX;
+    this->Controller->AllReduce(&local, &global, 1, vtkCommunicator::MIN_OP);
+    if (local != global)
+      {
+      closest = -1;
+      }
+    }
+  if (closest >= 0)
+    {
+    const vtkPrimitive& prim = internals.Primitives[closest];
+    const vtkItem& item = internals.Items[prim.Item];
+    KeyType key(std::make_pair(item.PropId, item.FlatIndex), prim.ProcessId);
+    selected[key].push_back(prim.Id);
+    composite[key] = item.Composite;
+    }
+
+  for (std::map<KeyType, std::vector<vtkIdType> >::iterator iter =
+    selected.begin(); iter != selected.end(); ++iter)
+    {
+    std::vector<vtkIdType>& ids = iter->second;
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+
+    vtkSmartPointer<vtkSelectionNode> node =
+      vtkSmartPointer<vtkSelectionNode>::New();
+    node->SetContentType(vtkSelectionNode::INDICES);
+    node->SetFieldType(
+      this->FieldAssociation == vtkDataObject::FIELD_ASSOCIATION_POINTS?
+      vtkSelectionNode::POINT : vtkSelectionNode::CELL);
+    node->GetProperties()->Set(vtkSelectionNode::PROP_ID(),
+      iter->first.first.first);
+    if (composite[iter->first])
+      {
+      node->GetProperties()->Set(vtkSelectionNode::COMPOSITE_INDEX(),
+        static_cast<int>(iter->first.first.second));
+      }
+    if (iter->first.second >= 0)
+      {
+      node->GetProperties()->Set(vtkSelectionNode::PROCESS_ID(),
+        iter->first.second);
+      }
+    vtkSmartPointer<vtkIdTypeArray> list =
+      vtkSmartPointer<vtkIdTypeArray>::New();
+    list->SetNumberOfTuples(static_cast<vtkIdType>(ids.size()));
+    std::copy(ids.begin(), ids.end(), list->GetPointer(0));
+    node->SetSelectionList(list);
+    sel->AddNode(node);
+    }
+
+  internals.Items.clear();
+  internals.Primitives.clear();
+  return sel;
+}
+
+//----------------------------------------------------------------------------
+void vtkPVCPUSelector::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "FieldAssociation: " << this->FieldAssociation << endl;
+  os << indent << "ProcessId: " << this->ProcessId << endl;
+  os << indent << "Controller: " << this->Controller << endl;
+}
@@ -0,0 +1,127 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkPVCPUSelector.h
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkPVCPUSelector - selection of points or cells without rendering.
+// .SECTION Description
+// vtkPVCPUSelector is an alternative to vtkPVHardwareSelector that does not
+// render the selection passes. It finds the primitives of the registered
+// props in the selected region using a bounding volume hierarchy built over
+// the polydata given to their mappers, and rasterizes only those on the CPU,
+// in parallel using vtkSMPTools, to keep the visible ones. This is much faster
+// than the hardware selection with software rendering (Mesa/OSMesa).
+//
+// The selection produced is the same as the one from vtkPVHardwareSelector:
+// one vtkSelectionNode with INDICES for each prop, block and process, with the
+// PROP_ID, COMPOSITE_INDEX and PROCESS_ID properties set. As with the
+// OpenGL2 hardware selection, points are selected by rendering the points
+// used by the cells, and cells are selected using the representation of the
+// actor (points, wireframe or surface). Only vtkActors with polydata or
+// composite datasets of polydata as input are supported.
+//
+// In parallel, set the Controller to keep only the elements in front of those
+// of the other processes. Select() and PolygonSelect() must then be called on
+// all the processes; each one returns the elements of its own props.
+// .SECTION See Also
+// vtkPVHardwareSelector
+
+#ifndef vtkPVCPUSelector_h
+#define vtkPVCPUSelector_h
+
+#include "vtkObject.h"
+#include "vtkPVClientServerCoreRenderingModule.h" //needed for exports
+#include "vtkWeakPointer.h" // needed for vtkWeakPointer.
+
+class vtkMultiProcessController;
+class vtkProp;
+class vtkRenderer;
+class vtkSelection;
+
+class VTKPVCLIENTSERVERCORERENDERING_EXPORT vtkPVCPUSelector : public vtkObject
+{
+public:
+  static vtkPVCPUSelector* New();
+  vtkTypeMacro(vtkPVCPUSelector, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Set the renderer whose camera and viewport are used for the selection.
+  void SetRenderer(vtkRenderer*);
+  vtkRenderer* GetRenderer();
+
+  // Description:
+  // Set the field association to select, i.e.
+  // vtkDataObject::FIELD_ASSOCIATION_POINTS or FIELD_ASSOCIATION_CELLS.
+  vtkSetMacro(FieldAssociation, int);
+  vtkGetMacro(FieldAssociation, int);
+
+  // Description:
+  // Process id used for the selection nodes when the data does not have a
+  // "vtkProcessId" point array.
+  vtkSetMacro(ProcessId, int);
+  vtkGetMacro(ProcessId, int);
+
+  // Description:
+  // Set the controller used to resolve the visibility between the processes.
+  // Default is NULL, i.e. only the local props are considered.
+  void SetController(vtkMultiProcessController*);
+  vtkGetObjectMacro(Controller, vtkMultiProcessController);
+
+  // Description:
+  // Register/unregister a prop to select from, with the id to use for the
+  // vtkSelectionNode::PROP_ID() property.
+  void AddProp(vtkProp*, int id);
+  void RemoveProp(vtkProp*);
+
+  // Description:
+  // Select the visible points or cells in the region (in display coordinates,
+  // with the same convention as vtkHardwareSelector). For a single point
+  // selection with nothing under the cursor, the closest point within
+  // vtkPVRenderViewSettings::GetPointPickingRadius() is selected.
+  // Returns a new vtkSelection.
+  vtkSelection* Select(int region[4]);
+
+  // Description:
+  // Same as Select() above, except this one use a polygon, instead
+  // of a rectangle region, and select elements inside the polygon.
+  vtkSelection* PolygonSelect(int* polygonPoints, vtkIdType count);
+
+  // Description:
+  // Release the bounding volume hierarchies cached for the datasets.
+  void ReleaseCache();
+
+protected:
+  vtkPVCPUSelector();
+  ~vtkPVCPUSelector();
+
+  // Description:
+  // Select within region, keeping only the pixels inside the polygon when
+  // polygonPoints is not NULL. When closestTo is not NULL, only the element
+  // closest to that pixel is selected.
+  vtkSelection* SelectInternal(int region[4],
+    int* polygonPoints, vtkIdType count, int* closestTo);
+
+  int FieldAssociation;
+  int ProcessId;
+  vtkMultiProcessController* Controller;
+  vtkWeakPointer<vtkRenderer> Renderer;
+
+private:
+  vtkPVCPUSelector(const vtkPVCPUSelector&) VTK_DELETE_FUNCTION;
+  void operator=(const vtkPVCPUSelector&) VTK_DELETE_FUNCTION;
+
+  class vtkInternals;
+  vtkInternals* Internals;
+};
+
+#endif
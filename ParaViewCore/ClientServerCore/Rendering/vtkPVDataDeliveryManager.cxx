@@ -230,7 +230,8 @@ public:
 vtkStandardNewMacro(vtkPVDataDeliveryManager);
 //----------------------------------------------------------------------------
 vtkPVDataDeliveryManager::vtkPVDataDeliveryManager()
-  : Internals(new vtkInternals())
+  : KdTreeManager(vtkSmartPointer<vtkKdTreeManager>::New()),
+  Internals(new vtkInternals())
 {
 }
 
@@ -561,7 +562,11 @@ void vtkPVDataDeliveryManager::RedistributeDataForOrderedCompositing(
     // need to re-generate the kd-tree.
     this->RedistributionTimeStamp.Modified();
 
-    vtkNew<vtkKdTreeManager> cutsGenerator;
+    // the manager is kept across renders: start from no data, and only use
+    // the structured data information of the visible representations.
+    vtkKdTreeManager* cutsGenerator = this->KdTreeManager;
+    cutsGenerator->RemoveAllDataObjects();
+    cutsGenerator->RemoveStructuredDataInformation();
     vtkInternals::ItemsMapType::iterator iter;
     for (iter = this->Internals->ItemsMap.begin();
       iter != this->Internals->ItemsMap.end(); ++iter)
@@ -620,9 +625,9 @@ void vtkPVDataDeliveryManager::RedistributeDataForOrderedCompositing(
       (item.GetDeliveredDataObject()->GetMTime() <
        item.GetRedistributedDataObject()->GetMTime()) &&
 
-      // kd-tree didn't change
+      // kd-tree cuts didn't change
       (item.GetRedistributedDataObject()->GetMTime() >
-       this->KdTree->GetMTime()))
+       this->KdTreeManager->GetCutsMTime()))
       {
       // skip redistribution.
       continue;
@@ -32,6 +32,7 @@
 class vtkAlgorithmOutput;
 class vtkDataObject;
 class vtkExtentTranslator;
+class vtkKdTreeManager;
 class vtkPKdTree;
 class vtkPVDataRepresentation;
 class vtkPVRenderView;
@@ -185,6 +186,9 @@ protected:
   vtkWeakPointer<vtkPVRenderView> RenderView;
   vtkSmartPointer<vtkPKdTree> KdTree;
 
+  // Kept across renders so that the kd-tree cuts can be updated incrementally.
+  vtkSmartPointer<vtkKdTreeManager> KdTreeManager;
+
   vtkTimeStamp RedistributionTimeStamp;
 private:
   vtkPVDataDeliveryManager(const vtkPVDataDeliveryManager&) VTK_DELETE_FUNCTION;
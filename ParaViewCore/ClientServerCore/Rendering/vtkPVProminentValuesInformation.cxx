@@ -29,27 +29,342 @@
 #include "vtkInformation.h"
 #include "vtkInformationKey.h"
 #include "vtkInformationIterator.h"
+#include "vtkMath.h"
 #include "vtkMultiProcessStream.h"
 #include "vtkNew.h"
 #include "vtkPointData.h"
 #include "vtkPVPostFilter.h"
 #include "vtkPVDataRepresentation.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
 #include "vtkStringArray.h"
 #include "vtkStdString.h"
 #include "vtkTable.h"
 #include "vtkVariant.h"
 #include "vtkVariantArray.h"
 
+#include <algorithm>
+#include <cmath>
+#include <functional>
 #include <map>
-#include <set>
 #include <vector>
 #include <sstream>
 
 #define VTK_MAX_CATEGORICAL_VALS (32)
+#define VTK_MAX_SKETCH_SIZE (8192)
+#define VTK_MAX_CACHED_ARRAYS (16)
 
 namespace
 {
-  typedef std::map<int,std::set<std::vector<vtkVariant> > > vtkInternalDistinctValuesBase;
+  typedef std::vector<vtkVariant> vtkProminentKey;
+
+  // Misra-Gries summary of the values of a component: Counts has at most
+  // the sketch size entries, and each count is lower than the number of
+  // occurrences of the value by at most Decrement (which is itself at most
+  // Total / (sketch size + 1)). Values not in Counts occur at most Decrement
+  // times.
+  struct vtkProminentSketch
+    {
+    std::map<vtkProminentKey, vtkIdType> Counts;
+    vtkIdType Total;
+    vtkIdType Decrement;
+    vtkProminentSketch() : Total(0), Decrement(0) {}
+    };
+
+  typedef std::map<int, vtkProminentSketch> vtkInternalDistinctValuesBase;
+
+  // Keeps at most capacity counters by decrementing all of them by the
+  // (capacity + 1)-th largest count. Returns the decrement.
+  template <class MapType>
+  vtkIdType vtkPruneCounts(MapType& counts, size_t capacity)
+    {
+    if (counts.size() <= capacity)
+      {
+      return 0;
+      }
+    std::vector<vtkIdType> values;
+    values.reserve(counts.size());
+    typename MapType::iterator iter;
+    for (iter = counts.begin(); iter != counts.end(); ++iter)
+      {
+      values.push_back(iter->second);
+      }
+    std::nth_element(values.begin(), values.begin() + capacity, values.end(),
+      std::greater<vtkIdType>());
+    vtkIdType decrement = values[capacity];
+    for (iter = counts.begin(); iter != counts.end();)
+      {
+      if ((iter->second -= decrement) <= 0)
+        {
+        counts.erase(iter++);
+        }
+      else
+        {
+        ++iter;
+        }
+      }
+    return decrement;
+    }
+
+  void vtkMergeSketch(vtkProminentSketch& target,
+    const vtkProminentSketch& source, size_t capacity)
+    {
+    std::map<vtkProminentKey, vtkIdType>::const_iterator iter;
+    for (iter = source.Counts.begin(); iter != source.Counts.end(); ++iter)
+      {
+      target.Counts[iter->first] += iter->second;
+      }
+    target.Total += source.Total;
+    target.Decrement += source.Decrement + vtkPruneCounts(target.Counts, capacity);
+    }
+
+  // NaN values are not counted, they cannot be ordered.
+  template <class T>
+  bool vtkIsNaN(const T&)
+    {
+    return false;
+    }
+  bool vtkIsNaN(const float& value)
+    {
+    return vtkMath::IsNan(value);
+    }
+  bool vtkIsNaN(const double& value)
+    {
+    return vtkMath::IsNan(value);
+    }
+  bool vtkIsNaN(const vtkVariant& value)
+    {
+    return value.IsNumeric() && vtkMath::IsNan(value.ToDouble());
+    }
+
+  template <class T>
+  void vtkMakeKey(const T& value, vtkProminentKey& key)
+    {
+    key.assign(1, vtkVariant(value));
+    }
+  template <class T>
+  void vtkMakeKey(const std::vector<T>& values, vtkProminentKey& key)
+    {
+    key.resize(values.size());
+    for (size_t i = 0; i < values.size(); ++i)
+      {
+      key[i] = vtkVariant(values[i]);
+      }
+    }
+
+  // Counts of the values of one thread, using the native value type.
+  template <class K>
+  struct vtkTypedCounts
+    {
+    std::map<K, vtkIdType> Counts;
+    vtkIdType Total;
+    vtkIdType Decrement;
+    vtkTypedCounts() : Total(0), Decrement(0) {}
+
+    void Add(const K& key, size_t capacity)
+      {
+      ++this->Counts[key];
+      ++this->Total;
+      // prune in batches to amortize the cost.
+      if (this->Counts.size() > 2 * capacity)
+        {
+        this->Decrement += vtkPruneCounts(this->Counts, capacity);
+        }
+      }
+
+    void AddTo(vtkProminentSketch& sketch, size_t capacity) const
+      {
+      vtkProminentSketch partial;
+      vtkProminentKey key;
+      typename std::map<K, vtkIdType>::const_iterator iter;
+      for (iter = this->Counts.begin(); iter != this->Counts.end(); ++iter)
+        {
+        vtkMakeKey(iter->first, key);
+        partial.Counts[key] = iter->second;
+        }
+      partial.Total = this->Total;
+      partial.Decrement = this->Decrement;
+      vtkMergeSketch(sketch, partial, capacity);
+      }
+    };
+
+  template <class T>
+  struct vtkPointerReader
+    {
+    typedef T ValueType;
+    const T* Data;
+    vtkPointerReader(const T* data) : Data(data) {}
+    T operator()(vtkIdType idx) const { return this->Data[idx]; }
+    };
+
+  struct vtkVariantReader
+    {
+    typedef vtkVariant ValueType;
+    vtkAbstractArray* Array;
+    vtkVariantReader(vtkAbstractArray* array) : Array(array) {}
+    vtkVariant operator()(vtkIdType idx) const
+      {
+      return this->Array->GetVariantValue(idx);
+      }
+    };
+
+  // Counts the values of each component and the tuples of a range of tuples.
+  template <class Reader>
+  class vtkCountFunctor
+    {
+  public:
+    typedef typename Reader::ValueType ValueType;
+    struct vtkLocalCounts
+      {
+      std::vector<vtkTypedCounts<ValueType> > Components;
+      vtkTypedCounts<std::vector<ValueType> > Tuples;
+      };
+
+    Reader Values;
+    int NumberOfComponents;
+    size_t Capacity;
+    vtkSMPThreadLocal<vtkLocalCounts> Locals;
+
+    vtkCountFunctor(const Reader& values, int nc, size_t capacity)
+      : Values(values), NumberOfComponents(nc), Capacity(capacity)
+      {
+      }
+
+    void Initialize()
+      {
+      this->Locals.Local().Components.resize(this->NumberOfComponents);
+      }
+
+    void operator()(vtkIdType begin, vtkIdType end)
+      {
+      vtkLocalCounts& local = this->Locals.Local();
+      int nc = this->NumberOfComponents;
+      std::vector<ValueType> tuple(nc);
+      for (vtkIdType t = begin; t < end; ++t)
+        {
+        bool valid = true;
+        for (int c = 0; c < nc; ++c)
+          {
+          tuple[c] = this->Values(t * nc + c);
+          if (vtkIsNaN(tuple[c]))
+            {
+            valid = false;
+            continue;
+            }
+          local.Components[c].Add(tuple[c], this->Capacity);
+          }
+        if (nc > 1 && valid)
+          {
+          local.Tuples.Add(tuple, this->Capacity);
+          }
+        }
+      }
+
+    void Reduce()
+      {
+      }
+
+    // Merges the counts of all the threads, the tuples are stored as
+    // component -1.
+    void GetSketches(vtkInternalDistinctValuesBase& sketches)
+      {
+      int nc = this->NumberOfComponents;
+      for (int c = (nc > 1 ? -1 : 0); c < nc; ++c)
+        {
+        sketches[c] = vtkProminentSketch();
+        }
+      typename vtkSMPThreadLocal<vtkLocalCounts>::iterator iter;
+      for (iter = this->Locals.begin(); iter != this->Locals.end(); ++iter)
+        {
+        for (int c = 0; c < nc && c < static_cast<int>(iter->Components.size()); ++c)
+          {
+          iter->Components[c].AddTo(sketches[c], this->Capacity);
+          }
+        if (nc > 1)
+          {
+          iter->Tuples.AddTo(sketches[-1], this->Capacity);
+          }
+        }
+      }
+    };
+
+  template <class Reader>
+  void vtkCountValues(const Reader& values, vtkIdType numTuples, int nc,
+    size_t capacity, vtkInternalDistinctValuesBase& sketches)
+    {
+    vtkCountFunctor<Reader> functor(values, nc, capacity);
+    vtkSMPTools::For(0, numTuples, functor);
+    functor.GetSketches(sketches);
+    }
+
+  // Summaries of the last arrays queried, so that querying an array that was
+  // not modified does not traverse it again.
+  struct vtkCachedSketches
+    {
+    unsigned long MTime;
+    int NumberOfComponents;
+    size_t Capacity;
+    unsigned long LastUse;
+    vtkInternalDistinctValuesBase Sketches;
+    };
+
+  class vtkSketchCache
+    {
+  public:
+    std::map<vtkAbstractArray*, vtkCachedSketches> Entries;
+    unsigned long Uses;
+
+    vtkSketchCache() : Uses(0) {}
+
+    const vtkInternalDistinctValuesBase* Find(
+      vtkAbstractArray* array, int nc, size_t capacity)
+      {
+      std::map<vtkAbstractArray*, vtkCachedSketches>::iterator iter =
+        this->Entries.find(array);
+      if (iter == this->Entries.end() ||
+        iter->second.MTime != array->GetMTime() ||
+        iter->second.NumberOfComponents != nc ||
+        iter->second.Capacity != capacity)
+        {
+        return NULL;
+        }
+      iter->second.LastUse = ++this->Uses;
+      return &iter->second.Sketches;
+      }
+
+    void Add(vtkAbstractArray* array, int nc, size_t capacity,
+      const vtkInternalDistinctValuesBase& sketches)
+      {
+      if (this->Entries.size() >= VTK_MAX_CACHED_ARRAYS &&
+        this->Entries.find(array) == this->Entries.end())
+        {
+        // evict the least recently used array.
+        std::map<vtkAbstractArray*, vtkCachedSketches>::iterator oldest =
+          this->Entries.begin();
+        std::map<vtkAbstractArray*, vtkCachedSketches>::iterator iter;
+        for (iter = this->Entries.begin(); iter != this->Entries.end(); ++iter)
+          {
+          if (iter->second.LastUse < oldest->second.LastUse)
+            {
+            oldest = iter;
+            }
+          }
+        this->Entries.erase(oldest);
+        }
+      vtkCachedSketches& entry = this->Entries[array];
+      entry.MTime = array->GetMTime();
+      entry.NumberOfComponents = nc;
+      entry.Capacity = capacity;
+      entry.LastUse = ++this->Uses;
+      entry.Sketches = sketches;
+      }
+    };
+
+  vtkSketchCache& vtkGetSketchCache()
+    {
+    static vtkSketchCache cache;
+    return cache;
+    }
 }
 
 class vtkPVProminentValuesInformation::vtkInternalDistinctValues:
@@ -86,6 +401,7 @@ void vtkPVProminentValuesInformation::InitializeParameters()
   this->NumberOfComponents = -2;
   this->Uncertainty = -1.;
   this->Fraction = -1.;
+  this->SketchSize = 0;
 }
 
 //----------------------------------------------------------------------------
@@ -120,15 +436,18 @@ void vtkPVProminentValuesInformation::PrintSelf(ostream& os, vtkIndent indent)
     {
     for ( vtkInternalDistinctValues::iterator cit = this->DistinctValues->begin(); cit != this->DistinctValues->end(); ++ cit )
       {
-      os << i2 << "Component " << cit->first << " (" << cit->second.size() << " values )" << endl;
-      for ( vtkInternalDistinctValues::mapped_type::iterator eit = cit->second.begin(); eit != cit->second.end(); ++ eit )
+      os << i2 << "Component " << cit->first << " (" << cit->second.Counts.size()
+        << " values out of " << cit->second.Total << ", error "
+        << cit->second.Decrement << ")" << endl;
+      std::map<vtkProminentKey, vtkIdType>::const_iterator eit;
+      for (eit = cit->second.Counts.begin(); eit != cit->second.Counts.end(); ++ eit )
         {
         os << i3;
-        for (std::vector<vtkVariant>::const_iterator vit = eit->begin(); vit != eit->end(); ++ vit)
+        for (std::vector<vtkVariant>::const_iterator vit = eit->first.begin(); vit != eit->first.end(); ++ vit)
           {
           os << " " << vit->ToString();
           }
-        os << endl;
+        os << ": " << eit->second << endl;
         }
       }
     }
@@ -138,6 +457,7 @@ void vtkPVProminentValuesInformation::PrintSelf(ostream& os, vtkIndent indent)
     }
   os << "Fraction: " << this->Fraction << endl;
   os << "Uncertainty: " << this->Uncertainty << endl;
+  os << "SketchSize: " << this->SketchSize << endl;
 }
 
 //----------------------------------------------------------------------------
@@ -277,6 +597,24 @@ void vtkPVProminentValuesInformation::DeepCopyParameters(
   this->SetNumberOfComponents(other->GetNumberOfComponents());
   this->Fraction = other->Fraction;
   this->Uncertainty = other->Uncertainty;
+  this->SketchSize = other->SketchSize;
+}
+
+//----------------------------------------------------------------------------
+int vtkPVProminentValuesInformation::GetEffectiveSketchSize()
+{
+  if (this->SketchSize > 0)
+    {
+    return this->SketchSize;
+    }
+  if (this->Fraction <= 0.)
+    {
+    return VTK_MAX_SKETCH_SIZE;
+    }
+  // keep the error on the counts below Fraction / 2.
+  double size = std::ceil(2. / this->Fraction);
+  return static_cast<int>(std::max(std::min(size,
+    static_cast<double>(VTK_MAX_SKETCH_SIZE)), 2. * VTK_MAX_CATEGORICAL_VALS));
 }
 
 //----------------------------------------------------------------------------
@@ -367,9 +705,8 @@ void vtkPVProminentValuesInformation::CopyFromLeafDataObject(
 //----------------------------------------------------------------------------
 void vtkPVProminentValuesInformation::CopyDistinctValuesFromObject(vtkAbstractArray* array)
 {
-  // Check whether each component of the array takes on a small number
-  // of unique values (i.e, test whether the array represents samples
-  // from a discrete set or a continuum).
+  // Summarize the values of each component of the array, to test whether the
+  // array represents samples from a discrete set or a continuum.
   // When there is more than 1 component, we also test whether the
   // tuples themselves behave discretely.
   if ( this->DistinctValues )
@@ -381,38 +718,46 @@ void vtkPVProminentValuesInformation::CopyDistinctValuesFromObject(vtkAbstractAr
     this->DistinctValues = new vtkInternalDistinctValues;
     }
   int nc = this->GetNumberOfComponents();
-  vtkNew<vtkVariantArray> cvalues;
-  std::vector<vtkVariant> tuple;
-  //bool tooManyValues;
-  for (int c = (nc > 1 ? -1 : 0); c < nc; ++c)
-    {
-    int tupleSize = c < 0 ? nc : 1;
-    tuple.resize(tupleSize);
-    std::set<std::vector<vtkVariant> >& compDistincts(
-      (*this->DistinctValues)[c]);
-    cvalues->Initialize();
-    array->GetProminentComponentValues(c, cvalues.GetPointer(), 0., 0.);
-    vtkIdType nt = cvalues->GetNumberOfTuples();
-    if (nt > 0)
+  if (nc <= 0 || array->GetNumberOfComponents() != nc)
+    {
+    return;
+    }
+
+  size_t capacity = static_cast<size_t>(this->GetEffectiveSketchSize());
+  vtkSketchCache& cache = vtkGetSketchCache();
+  const vtkInternalDistinctValuesBase* cached = cache.Find(array, nc, capacity);
+  if (cached)
+    {
+    *static_cast<vtkInternalDistinctValuesBase*>(this->DistinctValues) = *cached;
+    return;
+    }
+
+  vtkIdType numTuples = array->GetNumberOfTuples();
+  vtkDataArray* dataArray = vtkDataArray::SafeDownCast(array);
+  if (dataArray)
+    {
+    switch (dataArray->GetDataType())
       {
-      for (vtkIdType t = 0; t < nt; ++t)
-        {
-        for (int i = 0; i < tupleSize; ++i)
-          {
-          tuple[i] = cvalues->GetValue(i + t * tupleSize);
-          }
-        compDistincts.insert(tuple);
-        /*
-        if (compDistincts.insert(tuple).second)
-          {
-          if ((tooManyValues =
-            compDistincts.size() > vtkAbstractArray::MAX_DISCRETE_VALUES))
-            break;
-          }
-          */
-        }
+      vtkTemplateMacro(vtkCountValues(
+          vtkPointerReader<VTK_TT>(static_cast<VTK_TT*>(dataArray->GetVoidPointer(0))),
+          numTuples, nc, capacity, *this->DistinctValues));
+      default:
+        vtkCountValues(vtkVariantReader(array), numTuples, nc, capacity,
+          *this->DistinctValues);
       }
     }
+  else
+    {
+    vtkCountValues(vtkVariantReader(array), numTuples, nc, capacity,
+      *this->DistinctValues);
+    }
+  cache.Add(array, nc, capacity, *this->DistinctValues);
+}
+
+//----------------------------------------------------------------------------
+void vtkPVProminentValuesInformation::ReleaseCache()
+{
+  vtkGetSketchCache().Entries.clear();
 }
 
 //----------------------------------------------------------------------------
@@ -451,7 +796,8 @@ void vtkPVProminentValuesInformation::CopyToStream(vtkClientServerStream* css)
   *css
     << this->PortNumber
     << std::string(this->FieldAssociation) << std::string(this->FieldName)
-    << this->NumberOfComponents << this->Fraction << this->Uncertainty;
+    << this->NumberOfComponents << this->Fraction << this->Uncertainty
+    << this->SketchSize;
 
   // Now copy results to stream.
   int numberOfDistinctValueComponents = static_cast<int>(
@@ -463,16 +809,17 @@ void vtkPVProminentValuesInformation::CopyToStream(vtkClientServerStream* css)
     vtkInternalDistinctValues::iterator cit;
     for (cit = this->DistinctValues->begin(); cit != this->DistinctValues->end(); ++cit)
       {
-      unsigned nuv = static_cast<unsigned>(cit->second.size());
-      *css << cit->first << nuv;
-      vtkInternalDistinctValues::mapped_type::iterator eit;
-      for (eit = cit->second.begin(); eit != cit->second.end(); ++ eit)
+      unsigned nuv = static_cast<unsigned>(cit->second.Counts.size());
+      *css << cit->first << cit->second.Total << cit->second.Decrement << nuv;
+      std::map<vtkProminentKey, vtkIdType>::const_iterator eit;
+      for (eit = cit->second.Counts.begin(); eit != cit->second.Counts.end(); ++ eit)
         {
         std::vector<vtkVariant>::const_iterator vit;
-        for (vit = eit->begin(); vit != eit->end(); ++ vit)
+        for (vit = eit->first.begin(); vit != eit->first.end(); ++ vit)
           {
           *css << *vit;
           }
+        *css << eit->second;
         }
       }
     }
@@ -524,6 +871,12 @@ void vtkPVProminentValuesInformation::CopyFromStream(const vtkClientServerStream
     return;
     }
 
+  if ( ! css->GetArgument( 0, pos++, &this->SketchSize ) )
+    {
+    vtkErrorMacro("Error parsing sketch size from message.");
+    return;
+    }
+
   int numberOfDistinctValueComponents;
   if ( ! css->GetArgument( 0, pos++, &numberOfDistinctValueComponents ) )
     {
@@ -552,6 +905,13 @@ void vtkPVProminentValuesInformation::CopyFromStream(const vtkClientServerStream
         vtkErrorMacro( "Error decoding the " << i << "-th unique-value component ID." );
         return;
         }
+      vtkProminentSketch& sketch((*this->DistinctValues)[component]);
+      if ( ! css->GetArgument( 0, pos++, &sketch.Total ) ||
+        ! css->GetArgument( 0, pos++, &sketch.Decrement ) )
+        {
+        vtkErrorMacro( "Error decoding the number of values for component " << i );
+        return;
+        }
       unsigned nuv;
       if ( ! css->GetArgument( 0, pos++, &nuv ) )
         {
@@ -571,7 +931,11 @@ void vtkPVProminentValuesInformation::CopyFromStream(const vtkClientServerStream
             return;
             }
           }
-        (*this->DistinctValues)[component].insert(tuple);
+        if (!css->GetArgument(0, pos++, &sketch.Counts[tuple]))
+          {
+          vtkErrorMacro("Error decoding the count of the " << j << "-th unique tuple for component " << i);
+          return;
+          }
         }
       }
     }
@@ -586,7 +950,7 @@ void vtkPVProminentValuesInformation::CopyParametersToStream(vtkMultiProcessStre
   mps
     << magic_number << this->PortNumber
     << std::string(this->FieldAssociation) << std::string(this->FieldName) << this->NumberOfComponents
-    << this->Fraction << this->Uncertainty;
+    << this->Fraction << this->Uncertainty << this->SketchSize;
 }
 
 //-----------------------------------------------------------------------------
@@ -599,7 +963,7 @@ void vtkPVProminentValuesInformation::CopyParametersFromStream(vtkMultiProcessSt
   mps
     >> magic_number >> this->PortNumber
     >> fieldAssoc >> fieldName >> this->NumberOfComponents
-    >> this->Fraction >> this->Uncertainty;
+    >> this->Fraction >> this->Uncertainty >> this->SketchSize;
   if (magic_number != VTK_PROMINENT_MAGIC_NUMBER)
     {
     vtkErrorMacro("Magic number mismatch.");
@@ -617,38 +981,42 @@ void vtkPVProminentValuesInformation::AddDistinctValues(
     return;
     }
 
-  for ( int i = 0; i <= this->NumberOfComponents; ++ i )
+  size_t capacity = static_cast<size_t>(this->GetEffectiveSketchSize());
+  vtkInternalDistinctValues::iterator bit;
+  for (bit = info->DistinctValues->begin(); bit != info->DistinctValues->end(); ++bit)
     {
-    vtkInternalDistinctValues::iterator ait = this->DistinctValues->find(i);
-    vtkInternalDistinctValues::iterator bit = info->DistinctValues->find(i);
-    vtkInternalDistinctValues::mapped_type::iterator eit; // iterator over entries of component [ab]it->second.
-    bool tooManyValues = false;
-    if (
-      ait == this->DistinctValues->end() ||
-      bit == info->DistinctValues->end() )
-      { // someone had too many values to be rendered as categorical data.
-      tooManyValues = true;
-      }
-    else
-      { // Add info's values to our list of unique keys
-      for (eit = bit->second.begin(); eit != bit->second.end(); ++eit)
-        {
-        if (
-          (*this->DistinctValues)[i].insert( *eit ).second &&
-          (*this->DistinctValues)[i].size() > vtkAbstractArray::MAX_DISCRETE_VALUES)
-          {
-          tooManyValues = true;
-          break;
-          }
-        }
-      }
+    vtkMergeSketch((*this->DistinctValues)[bit->first], bit->second, capacity);
+    }
+}
 
-    // If the union of values is too large, delete the list of values
-    if ( tooManyValues )
-      {
-      this->DistinctValues->erase( i );
-      }
+//-----------------------------------------------------------------------------
+vtkIdType vtkPVProminentValuesInformation::GetNumberOfComponentValues(
+  int component)
+{
+  if (component < 0 && this->NumberOfComponents == 1)
+    component = 0;
+  vtkInternalDistinctValues::iterator compEntry;
+  if (!this->DistinctValues ||
+    (compEntry = this->DistinctValues->find(component)) == this->DistinctValues->end())
+    {
+    return 0;
+    }
+  return compEntry->second.Total;
+}
+
+//-----------------------------------------------------------------------------
+vtkIdType vtkPVProminentValuesInformation::GetComponentCountError(
+  int component)
+{
+  if (component < 0 && this->NumberOfComponents == 1)
+    component = 0;
+  vtkInternalDistinctValues::iterator compEntry;
+  if (!this->DistinctValues ||
+    (compEntry = this->DistinctValues->find(component)) == this->DistinctValues->end())
+    {
+    return 0;
     }
+  return compEntry->second.Decrement;
 }
 
 //-----------------------------------------------------------------------------
@@ -657,27 +1025,63 @@ vtkAbstractArray* vtkPVProminentValuesInformation::GetProminentComponentValues(
 {
   vtkVariantArray* va = 0;
   vtkInternalDistinctValues::iterator compEntry;
-  vtkIdType nt = 0;
   if (component < 0 && this->NumberOfComponents == 1)
     component = 0;
   if (
     ! this->DistinctValues ||
     (compEntry = this->DistinctValues->find(component)) == this->DistinctValues->end() ||
-    (nt = static_cast<vtkIdType>(compEntry->second.size())) == 0)
+    compEntry->second.Counts.empty())
     {
     return va;
     }
 
+  const vtkProminentSketch& sketch = compEntry->second;
+  std::vector<const vtkProminentKey*> prominent;
+  std::map<vtkProminentKey, vtkIdType>::const_iterator eit;
+  if (sketch.Decrement == 0 &&
+    sketch.Counts.size() <= static_cast<size_t>(vtkAbstractArray::MAX_DISCRETE_VALUES))
+    {
+    // The counts are exact: report all the distinct values.
+    for (eit = sketch.Counts.begin(); eit != sketch.Counts.end(); ++eit)
+      {
+      prominent.push_back(&eit->first);
+      }
+    }
+  else
+    {
+    // Keep the values that may make up at least Fraction of the array, the
+    // array is discrete if those surely make up more than 1 - Fraction of it.
+    double fraction = std::max(this->Fraction, 0.);
+    double minimumCount = fraction * sketch.Total;
+    vtkIdType covered = 0;
+    for (eit = sketch.Counts.begin(); eit != sketch.Counts.end(); ++eit)
+      {
+      if (eit->second + sketch.Decrement >= minimumCount)
+        {
+        if (prominent.size() >= static_cast<size_t>(vtkAbstractArray::MAX_DISCRETE_VALUES))
+          {
+          return va;
+          }
+        prominent.push_back(&eit->first);
+        covered += eit->second;
+        }
+      }
+    if (covered < (1. - fraction) * sketch.Total)
+      {
+      return va;
+      }
+    }
+
+  vtkIdType nt = static_cast<vtkIdType>(prominent.size());
   va = vtkVariantArray::New();
   int nc = (component < 0 ? this->NumberOfComponents : 1);
   va->SetNumberOfComponents(nc);
   va->Allocate(nt * nc);
-  vtkInternalDistinctValues::mapped_type::iterator eit;
-  for (eit = compEntry->second.begin(); eit != compEntry->second.end(); ++ eit)
+  for (vtkIdType t = 0; t < nt; ++t)
     {
     for (int i = 0; i < nc; ++i)
       {
-      va->InsertNextValue((*eit)[i]);
+      va->InsertNextValue((*prominent[t])[i]);
       }
     }
   return va;
@@ -20,11 +20,17 @@
 // as for its tuples as a whole).
 //
 // If the array behaves discretely (which we define to be: takes on fewer
-// than 33 distinct values over more than 99.9% of its entries to within a
-// given confidence that dictates the number of samples required), then
+// than 33 distinct values over more than 1 - Fraction of its entries), then
 // the prominent values are also made available.
 //
-// This class uses vtkAbstractArray::GetProminentComponentValues().
+// The values are counted with a heavy-hitters summary (Misra-Gries) of
+// SketchSize counters per component, computed in parallel with vtkSMPTools
+// and merged across blocks and processes. The count of each value is
+// underestimated by at most N / (SketchSize + 1) for an array of N values, so
+// all the values making up more than that fraction of the array are found.
+// When the array has no more than SketchSize distinct values, the counts are
+// exact. The summaries are cached for each array and only recomputed when the
+// array is modified, so querying the same array again is cheap.
 
 #ifndef vtkPVProminentValuesInformation_h
 #define vtkPVProminentValuesInformation_h
@@ -79,9 +85,19 @@ public:
   // Set/get the maximum uncertainty allowed in the detection of prominent values.
   // The uncertainty is the probability of prominent values going undetected.
   // Setting this to zero forces the entire array to be inspected.
+  //
+  // The entire array is always summarized, this is kept for compatibility.
   vtkSetClampMacro(Uncertainty,double,0.,1.);
   vtkGetMacro(Uncertainty,double);
 
+  // Description:
+  // Set/get the number of counters used to summarize each component (and the
+  // tuples) of the array. Larger values make the counts more accurate, at
+  // the expense of memory and communication. When 0 (the default), the size
+  // is chosen so that the error on the counts is at most Fraction / 2.
+  vtkSetClampMacro(SketchSize,int,0,VTK_INT_MAX);
+  vtkGetMacro(SketchSize,int);
+
   // Description:
   // Returns 1 if the array can be combined.
   // It must have the same name and number of components.
@@ -127,14 +143,25 @@ public:
   void Initialize();
 
   // Description:
-  // Merge another list of prominent values.
+  // Merge another summary of the values.
   void AddDistinctValues(vtkPVProminentValuesInformation*);
 
+  // Description:
+  // Returns the number of values summarized for a component (-1 for the
+  // tuples), and an upper bound of the error on their counts.
+  vtkIdType GetNumberOfComponentValues(int component);
+  vtkIdType GetComponentCountError(int component);
+
+  // Description:
+  // Release the summaries cached for the arrays.
+  static void ReleaseCache();
+
   // Description:
   // Returns either NULL (array component appears to be continuous) or
   // a pointer to a vtkAbstractArray (array component appears to be discrete)
   // containing a sorted list of all distinct prominent values encountered in
-  // the array component.
+  // the array component. When the counts are exact, all the distinct values
+  // are returned.
   //
   // Passing -1 as the component will return information about distinct tuple values
   // as opposed to distinct component values.
@@ -148,6 +175,11 @@ protected:
   void CopyFromCompositeDataSet(vtkCompositeDataSet*);
   void CopyFromLeafDataObject(vtkDataObject*);
 
+  // Description:
+  // Returns the number of counters of the summaries, i.e. SketchSize or the
+  // size computed from Fraction.
+  int GetEffectiveSketchSize();
+
   /// Information parameters
   //@{
   int PortNumber;
@@ -156,11 +188,13 @@ protected:
   char* FieldAssociation;
   double Fraction;
   double Uncertainty;
+  int SketchSize;
   //@}
 
   /// Information results
   //@{
 
+  /// Summary of the values for each component.
   class vtkInternalDistinctValues;
   vtkInternalDistinctValues* DistinctValues;
 
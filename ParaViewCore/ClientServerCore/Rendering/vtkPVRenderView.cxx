@@ -50,6 +50,7 @@
 #include "vtkProcessModule.h"
 #include "vtkPVAxesWidget.h"
 #include "vtkPVCenterAxesActor.h"
+#include "vtkPVCPUSelector.h"
 #include "vtkPVConfig.h"
 #include "vtkPVDataDeliveryManager.h"
 #include "vtkPVDataRepresentation.h"
@@ -57,6 +58,7 @@
 #include "vtkPVHardwareSelector.h"
 #include "vtkPVInteractorStyle.h"
 #include "vtkPVOptions.h"
+#include "vtkPVRenderViewSettings.h"
 #include "vtkPVSession.h"
 #include "vtkPVStreamingMacros.h"
 #include "vtkPVSynchronizedRenderer.h"
@@ -357,6 +359,7 @@ vtkPVRenderView::vtkPVRenderView()
   this->UseOffscreenRendering = (options->GetUseOffscreenRendering() != 0);
   this->EGLDeviceIndex = options->GetEGLDeviceIndex();
   this->Selector = vtkPVHardwareSelector::New();
+  this->CPUSelector = vtkPVCPUSelector::New();
   this->NeedsOrderedCompositing = false;
   this->RenderEmptyImages = false;
   this->DistributedRenderingRequired = false;
@@ -496,6 +499,7 @@ vtkPVRenderView::~vtkPVRenderView()
 
   this->SetLastSelection(NULL);
   this->Selector->Delete();
+  this->CPUSelector->Delete();
   this->SynchronizedRenderers->Delete();
   this->NonCompositedRenderer->Delete();
   this->RenderView->Delete();
@@ -620,6 +624,7 @@ void vtkPVRenderView::RegisterPropForHardwareSelection(
   vtkPVDataRepresentation* repr, vtkProp* prop)
 {
   int id = this->Selector->AssignUniqueId(prop);
+  this->CPUSelector->AddProp(prop, id);
   this->Internals->RegisterSelectionProp(id, prop, repr);
 }
 
@@ -627,6 +632,7 @@ void vtkPVRenderView::RegisterPropForHardwareSelection(
 void vtkPVRenderView::UnRegisterPropForHardwareSelection(
   vtkPVDataRepresentation* repr, vtkProp* prop)
 {
+  this->CPUSelector->RemoveProp(prop);
   this->Internals->UnRegisterSelectionProp(prop, repr);
 }
 
@@ -888,7 +894,11 @@ void vtkPVRenderView::Select(int fieldAssociation, int region[4])
     return;
     }
   vtkSmartPointer<vtkSelection> sel;
-  if (this->SynchronizedWindows->GetEnabled() ||
+  if (vtkPVRenderViewSettings::GetInstance()->GetUseCPUSelection())
+    {
+    sel.TakeReference(this->CPUSelect(region, NULL, 0));
+    }
+  else if (this->SynchronizedWindows->GetEnabled() ||
     this->SynchronizedWindows->GetLocalProcessIsDriver())
     {
     // we don't render labels for hardware selection
@@ -942,7 +952,11 @@ void vtkPVRenderView::SelectPolygon(
     return;
     }
   vtkSmartPointer<vtkSelection> sel;
-  if (this->SynchronizedWindows->GetEnabled() ||
+  if (vtkPVRenderViewSettings::GetInstance()->GetUseCPUSelection())
+    {
+    sel.TakeReference(this->CPUSelect(NULL, polygonPoints, arrayLen));
+    }
+  else if (this->SynchronizedWindows->GetEnabled() ||
     this->SynchronizedWindows->GetLocalProcessIsDriver())
     {
     sel.TakeReference(this->Selector->PolygonSelect(
@@ -951,6 +965,34 @@ void vtkPVRenderView::SelectPolygon(
   this->PostSelect(sel);
 }
 
+//----------------------------------------------------------------------------
+vtkSelection* vtkPVRenderView::CPUSelect(
+  int region[4], int* polygonPoints, vtkIdType count)
+{
+  // When rendering locally, the geometry is only on the driver process.
+  // Otherwise, all the rendering processes select from their own geometry and
+  // the results are combined on the driver.
+  bool distributed = this->SynchronizedWindows->GetEnabled();
+  if (!distributed && !this->SynchronizedWindows->GetLocalProcessIsDriver())
+    {
+    return NULL;
+    }
+
+  this->CPUSelector->SetRenderer(this->GetRenderer());
+  this->CPUSelector->SetFieldAssociation(
+    this->Selector->GetFieldAssociation());
+  this->CPUSelector->SetController(distributed?
+    this->SynchronizedWindows->GetParallelController() : NULL);
+  vtkSelection* sel = polygonPoints?
+    this->CPUSelector->PolygonSelect(polygonPoints, count) :
+    this->CPUSelector->Select(region);
+  if (distributed)
+    {
+    this->SynchronizedWindows->GatherToDriver(sel);
+    }
+  return sel;
+}
+
 //----------------------------------------------------------------------------
 void vtkPVRenderView::FinishSelection(vtkSelection* sel)
 {
@@ -46,6 +46,7 @@ class vtkLightKit;
 class vtkMatrix4x4;
 class vtkPVAxesWidget;
 class vtkPVCenterAxesActor;
+class vtkPVCPUSelector;
 class vtkPVDataDeliveryManager;
 class vtkPVDataRepresentation;
 class vtkPVGridAxes3DActor;
@@ -768,6 +769,12 @@ protected:
   // Post process after selection.
   void PostSelect(vtkSelection* sel);
 
+  // Description:
+  // Select using vtkPVCPUSelector instead of rendering the selection passes,
+  // in the region or, when polygonPoints is not NULL, in the polygon. Returns
+  // a new vtkSelection on the processes participating in the selection.
+  vtkSelection* CPUSelect(int region[4], int* polygonPoints, vtkIdType count);
+
   vtkLight* Light;
   vtkLightKit* LightKit;
   vtkRenderViewBase* RenderView;
@@ -780,6 +787,7 @@ protected:
   vtkPVCenterAxesActor* CenterAxes;
   vtkPVAxesWidget* OrientationWidget;
   vtkPVHardwareSelector* Selector;
+  vtkPVCPUSelector* CPUSelector;
   vtkSelection* LastSelection;
   vtkSmartPointer<vtkPVGridAxes3DActor> GridAxes3DActor;
 
@@ -47,6 +47,7 @@ vtkPVRenderViewSettings* vtkPVRenderViewSettings::GetInstance()
 vtkPVRenderViewSettings::vtkPVRenderViewSettings()
   : OutlineThreshold(250),
   PointPickingRadius(0),
+  UseCPUSelection(false),
   DisableIceT(false)
 {
 }
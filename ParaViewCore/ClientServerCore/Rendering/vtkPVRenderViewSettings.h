@@ -69,6 +69,12 @@ public:
   vtkSetMacro(PointPickingRadius, int);
   vtkGetMacro(PointPickingRadius, int);
 
+  // Description:
+  // When set, selections on the render view are computed on the CPU from the
+  // geometry (see vtkPVCPUSelector) instead of rendering the selection passes.
+  vtkSetMacro(UseCPUSelection, bool);
+  vtkGetMacro(UseCPUSelection, bool);
+
   // Description:
   // EXPERIMENTAL: Add ability to disable IceT.
   vtkSetMacro(DisableIceT, bool);
@@ -80,6 +86,7 @@ protected:
 
   vtkIdType OutlineThreshold;
   int PointPickingRadius;
+  bool UseCPUSelection;
   bool DisableIceT;
 private:
   vtkPVRenderViewSettings(const vtkPVRenderViewSettings&) VTK_DELETE_FUNCTION;
@@ -18,6 +18,7 @@
 #include "vtkCommand.h"
 #include "vtkDebugLeaks.h"
 #include "vtkMultiProcessStream.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkProcessModule.h"
 #include "vtkPVAxesWidget.h"
@@ -26,6 +27,7 @@
 #include "vtkRendererCollection.h"
 #include "vtkRenderer.h"
 #include "vtkRenderWindow.h"
+#include "vtkSelection.h"
 #include "vtkSelectionSerializer.h"
 #include "vtkSmartPointer.h"
 #include "vtkSocketController.h"
@@ -1790,6 +1792,76 @@ bool vtkPVSynchronizedRenderWindows::BroadcastToRenderServer(
   return true;
 }
 
+//----------------------------------------------------------------------------
+bool vtkPVSynchronizedRenderWindows::GatherToDriver(vtkSelection* selection)
+{
+  // handle trivial case.
+  if (this->Mode == BUILTIN || this->Mode == INVALID)
+    {
+    return true;
+    }
+
+  if (vtkProcessModule::GetProcessType() ==
+    vtkProcessModule::PROCESS_DATA_SERVER)
+    {
+    return false;
+    }
+
+  vtkMultiProcessController* parallelController =
+    this->GetParallelController();
+  vtkMultiProcessController* c_rs_controller =
+    this->GetClientServerController();
+
+  if (this->Mode == CLIENT)
+    {
+    if (c_rs_controller)
+      {
+      vtkMultiProcessStream stream;
+      c_rs_controller->Receive(stream, 1, 41235);
+      std::string xml;
+      stream >> xml;
+      selection->Initialize();
+      vtkSelectionSerializer::Parse(xml.c_str(), selection);
+      }
+    return true;
+    }
+
+  if (parallelController && parallelController->GetNumberOfProcesses() > 1)
+    {
+    int myId = parallelController->GetLocalProcessId();
+    if (myId != 0)
+      {
+      std::ostringstream xml_stream;
+      vtkSelectionSerializer::PrintXML(xml_stream, vtkIndent(), 1, selection);
+      vtkMultiProcessStream stream;
+      stream << xml_stream.str();
+      parallelController->Send(stream, 0, 41235);
+      return true;
+      }
+    int numProcs = parallelController->GetNumberOfProcesses();
+    for (int cc=1; cc < numProcs; cc++)
+      {
+      vtkMultiProcessStream stream;
+      parallelController->Receive(stream, cc, 41235);
+      std::string xml;
+      stream >> xml;
+      vtkNew<vtkSelection> other;
+      vtkSelectionSerializer::Parse(xml.c_str(), other.GetPointer());
+      selection->Union(other.GetPointer());
+      }
+    }
+
+  if (this->Mode != BATCH && c_rs_controller)
+    {
+    std::ostringstream xml_stream;
+    vtkSelectionSerializer::PrintXML(xml_stream, vtkIndent(), 1, selection);
+    vtkMultiProcessStream stream;
+    stream << xml_stream.str();
+    c_rs_controller->Send(stream, 1, 41235);
+    }
+  return true;
+}
+
 //----------------------------------------------------------------------------
 void vtkPVSynchronizedRenderWindows::TriggerRMI(
   vtkMultiProcessStream& stream, int tag)
@@ -121,6 +121,13 @@ public:
   bool BroadcastToDataServer(vtkSelection* selection);
   bool BroadcastToRenderServer(vtkDataObject*);
 
+  // Description:
+  // Combines the selections made on the render-server processes (or the
+  // satellites in batch mode) and delivers the result to the driver process,
+  // i.e. the client or the root node. On the other processes, the selection
+  // is left unchanged.
+  bool GatherToDriver(vtkSelection* selection);
+
   enum StandardOperations
     {
     MAX_OP = vtkCommunicator::MAX_OP,
@@ -120,7 +120,8 @@ public:
       this->CachedBlocks.erase(iter);
       }
 
-    if (static_cast<vtkIdType>(this->CachedBlocks.size()) == max)
+    while (!this->CachedBlocks.empty() &&
+      static_cast<vtkIdType>(this->CachedBlocks.size()) >= max)
       {
       // remove least-recent-used block.
       iter = this->CachedBlocks.begin();
@@ -262,6 +263,7 @@ vtkStandardNewMacro(vtkSpreadSheetView);
 vtkSpreadSheetView::vtkSpreadSheetView()
 {
   this->NumberOfRows = 0;
+  this->MaximumNumberOfCachedBlocks = 32;
   this->ShowExtractedSelection = false;
   this->TableStreamer = vtkSortedTableStreamer::New();
   this->TableSelectionMarker = vtkMarkSelectedRows::New();
@@ -336,6 +338,8 @@ void vtkSpreadSheetView::ClearCache()
 void vtkSpreadSheetView::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "MaximumNumberOfCachedBlocks: "
+     << this->MaximumNumberOfCachedBlocks << endl;
 }
 
 //----------------------------------------------------------------------------
@@ -446,7 +450,8 @@ vtkTable* vtkSpreadSheetView::FetchBlock(vtkIdType blockindex)
     this->FetchBlockCallback(blockindex);
     block = vtkTable::SafeDownCast(
       this->DeliveryFilter->GetOutputDataObject(0));
-    this->Internals->AddToCache(blockindex, block, 10);
+    this->Internals->AddToCache(blockindex, block,
+      this->MaximumNumberOfCachedBlocks);
     this->InvokeEvent(vtkCommand::UpdateEvent, &blockindex);
     }
 
@@ -551,6 +556,17 @@ bool vtkSpreadSheetView::IsAvailable(vtkIdType row)
   return this->Internals->GetDataObject(blockIndex) != NULL;
 }
 
+//----------------------------------------------------------------------------
+void vtkSpreadSheetView::Prefetch(vtkIdType blockindex)
+{
+  vtkIdType blockSize = this->TableStreamer->GetBlockSize();
+  if (this->Internals->ActiveRepresentation && blockindex >= 0 &&
+    blockindex * blockSize < this->GetNumberOfRows())
+    {
+    this->FetchBlock(blockindex);
+    }
+}
+
 //----------------------------------------------------------------------------
 bool vtkSpreadSheetView::Export(vtkCSVExporter* exporter)
 {
@@ -94,6 +94,19 @@ public:
   // Returns true is the data for the particular row is locally available.
   bool IsAvailable(vtkIdType row);
 
+  // Description:
+  // Fetches the block with the given index, unless it is already available
+  // locally. This lets the client read ahead of the rows being shown.
+  // @CallOnClient
+  void Prefetch(vtkIdType blockindex);
+
+  // Description:
+  // Get/Set the maximum number of blocks kept on the client. The least
+  // recently used blocks are released first. Default is 32.
+  // @CallOnClient
+  vtkSetClampMacro(MaximumNumberOfCachedBlocks, int, 1, VTK_INT_MAX);
+  vtkGetMacro(MaximumNumberOfCachedBlocks, int);
+
   //***************************************************************************
   // Forwarded to vtkSortedTableStreamer.
   // Description:
@@ -151,6 +164,7 @@ protected:
   vtkClientServerMoveData* DeliveryFilter;
 
   vtkIdType NumberOfRows;
+  int MaximumNumberOfCachedBlocks;
 
   enum
     {
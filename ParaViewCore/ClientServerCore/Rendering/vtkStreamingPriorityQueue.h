@@ -180,11 +180,13 @@ public:
   double Distance;
   double AmountOfDetail;
   double ItemCoverage;     // amount of the item that is onscreen (fraction, if whole item is onscreen it is 1)
+  double Cost;             // relative cost to fetch and process the block,
+                           // e.g. its number of cells. 0 is undefined.
   vtkBoundingBox Bounds;   // Bounds for the block.
 
   vtkStreamingPriorityQueueItem() :
     Identifier(0), Refinement(0), ScreenCoverage(0), Priority(0), Distance(0),
-    AmountOfDetail(-1)
+    AmountOfDetail(-1), Cost(0)
   {
   }
 };
@@ -195,7 +197,13 @@ public:
   bool operator()(const vtkStreamingPriorityQueueItem& me,
     const vtkStreamingPriorityQueueItem& other) const
     {
-    return me.Priority < other.Priority;
+    // break ties on the identifier so that the order in which blocks are
+    // popped does not depend on the history of the heap.
+    if (me.Priority != other.Priority)
+      {
+      return me.Priority < other.Priority;
+      }
+    return me.Identifier > other.Identifier;
     }
 };
 
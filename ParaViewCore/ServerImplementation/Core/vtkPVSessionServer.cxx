@@ -486,24 +486,29 @@ void vtkPVSessionServer::OnClientServerMessageRMI(void* message, int message_len
     {
   case vtkPVSessionServer::PUSH:
       {
-      std::string string;
-      stream >> string;
-      vtkSMMessage msg;
-      msg.ParseFromString(string);
-
-//      cout << "=================================" << endl;
-//      msg.PrintDebugString();
-//      cout << "=================================" << endl;
-
-      // Do we skip the processing ?
-      if(!this->Internal->StoreShareOnly(&msg))
+      // A client may batch several states in a single PUSH, they are applied
+      // in the order they were pushed.
+      while (!stream.Empty())
         {
-        this->PushState(&msg);
+        std::string string;
+        stream >> string;
+        vtkSMMessage msg;
+        msg.ParseFromString(string);
+
+//        cout << "=================================" << endl;
+//        msg.PrintDebugString();
+//        cout << "=================================" << endl;
+
+        // Do we skip the processing ?
+        if(!this->Internal->StoreShareOnly(&msg))
+          {
+          this->PushState(&msg);
+          }
+
+        // Notify when ProxyManager state has changed
+        // or any other state change
+        this->NotifyOtherClients(&msg);
         }
-
-      // Notify when ProxyManager state has changed
-      // or any other state change
-      this->NotifyOtherClients(&msg);
       }
     break;
 
@@ -575,6 +580,24 @@ void vtkPVSessionServer::OnClientServerMessageRMI(void* message, int message_len
         stream);
       }
     break;
+
+  case vtkPVSessionServer::BATCH:
+      {
+      // Messages queued by a client transaction, processed in order.
+      int count;
+      stream >> count;
+      for (int cc=0; cc < count; cc++)
+        {
+        std::string submessage;
+        stream >> submessage;
+        if (!submessage.empty())
+          {
+          this->OnClientServerMessageRMI(&submessage[0],
+            static_cast<int>(submessage.size()));
+          }
+        }
+      }
+    break;
     }
 }
 
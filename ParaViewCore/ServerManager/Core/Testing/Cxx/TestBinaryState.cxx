@@ -0,0 +1,130 @@
+/*=========================================================================
+
+Program:   ParaView
+Module:    TestBinaryState.cxx
+
+Copyright (c) Kitware, Inc.
+All rights reserved.
+See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+This software is distributed WITHOUT ANY WARRANTY; without even
+the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that truncated or corrupted binary states are rejected, without
+// allocating the sizes they claim.
+
+#include "vtkInitializationHelper.h"
+#include "vtkNew.h"
+#include "vtkProcessModule.h"
+#include "vtkSMProxy.h"
+#include "vtkSMPropertyHelper.h"
+#include "vtkSMSession.h"
+#include "vtkSMSessionProxyManager.h"
+#include "vtkSmartPointer.h"
+#include "vtkTestUtilities.h"
+
+#include <fstream>
+#include <iterator>
+#include <string>
+
+namespace
+{
+  bool WriteFile(const std::string& filename, const std::string& contents)
+    {
+    std::ofstream os(filename.c_str(), ios::out | ios::binary);
+    os.write(contents.c_str(), contents.size());
+    return os.good();
+    }
+
+  // Loads the file in a new session, and returns true if it is rejected
+  // without registering any proxy.
+  bool IsRejected(const std::string& filename)
+    {
+    vtkNew<vtkSMSession> session;
+    vtkSMSessionProxyManager* pxm = session->GetSessionProxyManager();
+    return !pxm->LoadBinaryState(filename.c_str()) &&
+      pxm->GetNumberOfProxies("sources") == 0;
+    }
+}
+
+int TestBinaryState(int argc, char* argv[])
+{
+  vtkInitializationHelper::Initialize(argv[0], vtkProcessModule::PROCESS_CLIENT);
+
+  char *tempDir = vtkTestUtilities::GetArgOrEnvOrDefault(
+    "-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  if (!tempDir)
+    {
+    cerr << "Could not determine temporary directory.\n";
+    return EXIT_FAILURE;
+    }
+  std::string path = tempDir;
+  delete [] tempDir;
+  std::string filename = path + "/TestBinaryState.pvbs";
+  std::string corrupted = path + "/TestBinaryStateCorrupted.pvbs";
+
+  std::string contents;
+    {
+    vtkNew<vtkSMSession> session;
+    vtkSMSessionProxyManager* pxm = session->GetSessionProxyManager();
+    vtkSmartPointer<vtkSMProxy> sphere;
+    sphere.TakeReference(pxm->NewProxy("sources", "SphereSource"));
+    vtkSMPropertyHelper(sphere, "Radius").Set(2.5);
+    sphere->UpdateVTKObjects();
+    pxm->RegisterProxy("sources", "Sphere", sphere);
+    if (!pxm->SaveBinaryState(filename.c_str()))
+      {
+      cerr << "Failed to save the binary state." << endl;
+      return EXIT_FAILURE;
+      }
+    std::ifstream is(filename.c_str(), ios::in | ios::binary);
+    contents.assign(std::istreambuf_iterator<char>(is),
+      std::istreambuf_iterator<char>());
+    }
+
+  // The file starts with an 8 bytes tag and a 4 bytes version, followed by
+  // the size of the first message.
+  const size_t headerSize = 12;
+  if (contents.size() <= headerSize + 4)
+    {
+    cerr << "Binary state too small: " << contents.size() << " bytes." << endl;
+    return EXIT_FAILURE;
+    }
+
+  // A truncated file.
+  if (!WriteFile(corrupted, contents.substr(0, contents.size() / 2)) ||
+    !IsRejected(corrupted))
+    {
+    cerr << "A truncated binary state was not rejected." << endl;
+    return EXIT_FAILURE;
+    }
+
+  // A message claiming 4GB.
+  std::string huge = contents;
+  huge.replace(headerSize, 4, 4, '\xff');
+  if (!WriteFile(corrupted, huge) || !IsRejected(corrupted))
+    {
+    cerr << "A binary state with an invalid size was not rejected." << endl;
+    return EXIT_FAILURE;
+    }
+
+  // A message claiming one byte more than the file holds.
+  std::string past = contents.substr(0, headerSize + 4);
+  size_t size = contents.size() - past.size() + 1;
+  for (int cc=0; cc < 4; cc++)
+    {
+    past[headerSize + cc] = static_cast<char>((size >> (8*cc)) & 0xff);
+    }
+  past += contents.substr(headerSize + 4);
+  if (!WriteFile(corrupted, past) || !IsRejected(corrupted))
+    {
+    cerr << "A binary state with a size past its end was not rejected."
+      << endl;
+    return EXIT_FAILURE;
+    }
+
+  vtkInitializationHelper::Finalize();
+  return EXIT_SUCCESS;
+}
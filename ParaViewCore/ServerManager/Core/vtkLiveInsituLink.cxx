@@ -336,6 +336,9 @@ vtkLiveInsituLink::vtkLiveInsituLink():
   InsituXMLStateChanged(false),
   ExtractsChanged(false),
   SimulationPaused(0),
+  ExtractsDeltaEncoding(true),
+  ExtractsCompression(true),
+  MaximumExtractsBandwidth(0.0),
   InsituXMLState(0),
   URL(0),
   Internals(new vtkInternals())
@@ -579,6 +582,10 @@ void vtkLiveInsituLink::InsituConnect(vtkMultiProcessController* controller)
     vtkSmartPointer<vtkExtractsDeliveryHelper>::New();
   this->ExtractsDeliveryHelper->SetProcessIsProducer(
     this->ProcessType == LIVE? false : true);
+  this->ExtractsDeliveryHelper->SetDeltaEncoding(this->ExtractsDeltaEncoding);
+  this->ExtractsDeliveryHelper->SetCompression(this->ExtractsCompression);
+  this->ExtractsDeliveryHelper->SetMaximumBandwidth(
+    this->MaximumExtractsBandwidth);
 
   vtkMultiProcessController* parallelController =
     vtkMultiProcessController::GetGlobalController();
@@ -1178,6 +1185,11 @@ void vtkLiveInsituLink::UnRegisterExtract(vtkTrivialProducer* producer)
 void vtkLiveInsituLink::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "ExtractsDeltaEncoding: " << this->ExtractsDeltaEncoding
+     << endl;
+  os << indent << "ExtractsCompression: " << this->ExtractsCompression << endl;
+  os << indent << "MaximumExtractsBandwidth: "
+     << this->MaximumExtractsBandwidth << endl;
 }
 //----------------------------------------------------------------------------
 bool vtkLiveInsituLink::FilterXMLState(vtkPVXMLElement* xmlState)
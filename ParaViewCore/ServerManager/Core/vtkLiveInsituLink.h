@@ -92,6 +92,19 @@ public:
   vtkGetMacro(SimulationPaused, int);
   void SetSimulationPaused (int paused);
 
+  // Description:
+  // Settings for sending the extracts from Insitu to ParaView Live, used on
+  // the Insitu side when the connection is made. By default extracts are
+  // delta-encoded and compressed, and the bandwidth is not limited. See
+  // vtkExtractsDeliveryHelper for details. MaximumExtractsBandwidth is in
+  // megabytes per second, 0 means no limit.
+  vtkSetMacro(ExtractsDeltaEncoding, bool);
+  vtkGetMacro(ExtractsDeltaEncoding, bool);
+  vtkSetMacro(ExtractsCompression, bool);
+  vtkGetMacro(ExtractsCompression, bool);
+  vtkSetClampMacro(MaximumExtractsBandwidth, double, 0.0, VTK_DOUBLE_MAX);
+  vtkGetMacro(MaximumExtractsBandwidth, double);
+
   // Description:
   // Initializes the link. For in situ this returns true it there is a
   // connection and false otherwise. For live it always returns true.
@@ -212,6 +225,9 @@ protected:
   bool InsituXMLStateChanged;
   bool ExtractsChanged;
   int SimulationPaused;
+  bool ExtractsDeltaEncoding;
+  bool ExtractsCompression;
+  double MaximumExtractsBandwidth;
 
   char* InsituXMLState;
   vtkWeakPointer<vtkPVSessionBase> LiveSession;
@@ -346,6 +346,8 @@ bool vtkSMParaViewPipelineController::InitializeSession(vtkSMSession* session)
   vtkSMSessionProxyManager* pxm = session->GetSessionProxyManager();
   assert(pxm);
 
+  vtkSMScopedSessionTransaction transaction(session);
+
   //---------------------------------------------------------------------------
   // If the session is a collaborative session, we need to fetch the state from
   // server before we start creating "essential" proxies. This is a no-op if not
@@ -549,6 +551,7 @@ bool vtkSMParaViewPipelineController::RegisterPipelineProxy(
     }
 
   SM_SCOPED_TRACE(RegisterPipelineProxy).arg("proxy", proxy);
+  vtkSMScopedSessionTransaction transaction(proxy->GetSession());
 
   // Create animation helpers for this proxy.
   this->CreateAnimationHelpers(proxy);
@@ -625,6 +628,7 @@ bool vtkSMParaViewPipelineController::RegisterViewProxy(
     }
 
   SM_SCOPED_TRACE(RegisterViewProxy).arg("proxy", proxy);
+  vtkSMScopedSessionTransaction transaction(proxy->GetSession());
 
   // Now register the proxy itself.
   proxy->GetSessionProxyManager()->RegisterProxy("views", proxyname, proxy);
@@ -945,6 +949,9 @@ bool vtkSMParaViewPipelineController::PreInitializeProxy(vtkSMProxy* proxy)
     return false;
     }
 
+  // Send the property pushes to the server together.
+  vtkSMScopedSessionTransaction transaction(proxy->GetSession());
+
   // 1. Load XML defaults
   //    (already done by NewProxy() call).
 
@@ -1001,6 +1008,10 @@ bool vtkSMParaViewPipelineController::PostInitializeProxy(vtkSMProxy* proxy)
   vtkTimeStamp ts = titer->second;
   this->Internals->InitializationTimeStamps.erase(titer);
 
+  // Send the property pushes to the server together, along with the pipeline
+  // information requests.
+  vtkSMScopedSessionTransaction transaction(proxy->GetSession());
+
   // ensure everything is up-to-date.
   proxy->UpdateVTKObjects();
 
@@ -1184,6 +1195,7 @@ bool vtkSMParaViewPipelineController::UnRegisterProxy(vtkSMProxy* proxy)
 
 
   SM_SCOPED_TRACE(CleanupAccessor).arg("proxy", proxy);
+  vtkSMScopedSessionTransaction transaction(proxy->GetSession());
 
   // determine what type of proxy is this, based on that, we can finalize it.
   vtkSMSessionProxyManager* pxm = proxy->GetSessionProxyManager();
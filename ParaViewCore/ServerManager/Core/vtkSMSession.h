@@ -128,6 +128,19 @@ public:
   // undo-redo state manager is updated.
   virtual void PushState(vtkSMMessage* msg);
 
+  // Description:
+  // Begin/End a transaction. While a transaction is open, sessions connected
+  // to remote servers hold on to the requests that expect no reply, such as
+  // the states pushed by vtkSMProxy::UpdateVTKObjects(), and send them to each
+  // server in a single message when the outermost transaction ends, or with
+  // the next request that needs a reply (e.g. GatherInformation()). The order
+  // of the requests is preserved. Transactions can be nested. The builtin
+  // session has no round trips to save and ignores these.
+  // vtkSMScopedSessionTransaction can be used to open a transaction for the
+  // lifetime of a scope.
+  virtual void BeginTransaction() {}
+  virtual void EndTransaction() {}
+
   // Description:
   // Sends the message to all clients.
   virtual void NotifyAllClients(const vtkSMMessage* msg)
@@ -256,4 +269,32 @@ private:
 
 };
 
+// Description:
+// Opens a transaction on the session for the lifetime of the object. See
+// vtkSMSession::BeginTransaction().
+class vtkSMScopedSessionTransaction
+{
+public:
+  vtkSMScopedSessionTransaction(vtkSMSession* session) : Session(session)
+    {
+    if (this->Session)
+      {
+      this->Session->BeginTransaction();
+      }
+    }
+  ~vtkSMScopedSessionTransaction()
+    {
+    if (this->Session)
+      {
+      this->Session->EndTransaction();
+      }
+    }
+
+private:
+  vtkSMScopedSessionTransaction(const vtkSMScopedSessionTransaction&) VTK_DELETE_FUNCTION;
+  void operator=(const vtkSMScopedSessionTransaction&) VTK_DELETE_FUNCTION;
+
+  vtkSmartPointer<vtkSMSession> Session;
+};
+
 #endif
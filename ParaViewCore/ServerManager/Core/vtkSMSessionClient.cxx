@@ -60,6 +60,84 @@ namespace
     self->OnServerNotificationMessageRMI(remoteArg, remoteArgLength);
     }
 };
+
+class vtkSMSessionClient::vtkTransaction
+{
+public:
+  // Messages queued for a server: the CLIENT_SERVER_MESSAGE_RMI messages, the
+  // payloads sent after the EXECUTE_STREAM ones, in order, and the states of
+  // the latest consecutive PUSH requests, merged in a single message, and
+  // the number of messages sent so far.
+  struct vtkQueue
+    {
+    std::vector<std::string> Messages;
+    std::vector<std::string> Payloads;
+    std::vector<std::string> States;
+    vtkTypeUInt64 NumberOfMessagesSent;
+    vtkQueue() : NumberOfMessagesSent(0) {}
+    };
+
+  // Queues for the data-server (0) and the render-server (1).
+  vtkQueue Queues[2];
+
+  static void ClosePush(vtkQueue& queue)
+    {
+    if (queue.States.empty())
+      {
+      return;
+      }
+    vtkMultiProcessStream stream;
+    stream << static_cast<int>(vtkPVSessionServer::PUSH);
+    for (size_t cc=0; cc < queue.States.size(); cc++)
+      {
+      stream << queue.States[cc];
+      }
+    std::vector<unsigned char> raw_message;
+    stream.GetRawData(raw_message);
+    queue.Messages.push_back(
+      std::string(raw_message.begin(), raw_message.end()));
+    queue.States.clear();
+    }
+
+  // Sends the queued messages, wrapped in a single BATCH message when there
+  // is more than one, followed by the EXECUTE_STREAM payloads.
+  static void Send(vtkQueue& queue, vtkMultiProcessController* controller)
+    {
+    ClosePush(queue);
+    if (controller && !queue.Messages.empty())
+      {
+      std::vector<unsigned char> raw_message;
+      if (queue.Messages.size() == 1)
+        {
+        raw_message.assign(queue.Messages[0].begin(), queue.Messages[0].end());
+        }
+      else
+        {
+        vtkMultiProcessStream stream;
+        stream << static_cast<int>(vtkPVSessionServer::BATCH)
+               << static_cast<int>(queue.Messages.size());
+        for (size_t cc=0; cc < queue.Messages.size(); cc++)
+          {
+          stream << queue.Messages[cc];
+          }
+        stream.GetRawData(raw_message);
+        }
+      controller->TriggerRMIOnAllChildren(
+        &raw_message[0], static_cast<int>(raw_message.size()),
+        vtkPVSessionServer::CLIENT_SERVER_MESSAGE_RMI);
+      queue.NumberOfMessagesSent++;
+      for (size_t cc=0; cc < queue.Payloads.size(); cc++)
+        {
+        controller->Send(
+          reinterpret_cast<const unsigned char*>(queue.Payloads[cc].data()),
+          static_cast<int>(queue.Payloads[cc].size()), 1,
+          vtkPVSessionServer::EXECUTE_STREAM_TAG);
+        }
+      }
+    queue.Messages.clear();
+    queue.Payloads.clear();
+    }
+};
 //****************************************************************************/
 vtkStandardNewMacro(vtkSMSessionClient);
 vtkCxxSetObjectMacro(vtkSMSessionClient, RenderServerController,
@@ -92,6 +170,8 @@ vtkSMSessionClient::vtkSMSessionClient() : Superclass(false)
   // Default value
   this->NoMoreDelete = false;
   this->NotBusy = 0;
+  this->TransactionDepth = 0;
+  this->Transaction = new vtkTransaction();
 }
 
 //----------------------------------------------------------------------------
@@ -120,6 +200,9 @@ vtkSMSessionClient::~vtkSMSessionClient()
 
   delete this->ServerLastInvokeResult;
   this->ServerLastInvokeResult = NULL;
+
+  delete this->Transaction;
+  this->Transaction = NULL;
 }
 
 //----------------------------------------------------------------------------
@@ -462,6 +545,7 @@ bool vtkSMSessionClient::IsMPIInitialized(vtkTypeUInt32 servers)
 //----------------------------------------------------------------------------
 void vtkSMSessionClient::CloseSession()
 {
+  this->FlushTransaction();
   if (this->DataServerController)
     {
     this->DataServerController->TriggerRMIOnAllChildren(
@@ -482,6 +566,7 @@ void vtkSMSessionClient::CloseSession()
 //----------------------------------------------------------------------------
 void vtkSMSessionClient::PreDisconnection()
 {
+  this->FlushTransaction();
   this->NoMoreDelete = true;
 }
 
@@ -529,7 +614,17 @@ void vtkSMSessionClient::PushState(vtkSMMessage* message)
     {
     controllers[num_controllers++] = this->RenderServerController;
     }
-  if (num_controllers > 0)
+  if (num_controllers > 0 && this->TransactionDepth > 0)
+    {
+    // Consecutive states are sent in a single PUSH message.
+    std::string state = message->SerializeAsString();
+    for (int cc=0; cc < num_controllers; cc++)
+      {
+      int index = (controllers[cc] == this->DataServerController)? 0 : 1;
+      this->Transaction->Queues[index].States.push_back(state);
+      }
+    }
+  else if (num_controllers > 0)
     {
     vtkMultiProcessStream stream;
     stream << static_cast<int>(vtkPVSessionServer::PUSH);
@@ -538,9 +633,7 @@ void vtkSMSessionClient::PushState(vtkSMMessage* message)
     stream.GetRawData(raw_message);
     for (int cc=0; cc < num_controllers; cc++)
       {
-      controllers[cc]->TriggerRMIOnAllChildren(
-          &raw_message[0], static_cast<int>(raw_message.size()),
-          vtkPVSessionServer::CLIENT_SERVER_MESSAGE_RMI);
+      this->SendToServer(controllers[cc], raw_message, false);
       }
     }
 
@@ -577,9 +670,7 @@ void vtkSMSessionClient::PushState(vtkSMMessage* message)
         stream << msg.SerializeAsString();
         std::vector<unsigned char> raw_message;
         stream.GetRawData(raw_message);
-        this->DataServerController->TriggerRMIOnAllChildren(
-            &raw_message[0], static_cast<int>(raw_message.size()),
-            vtkPVSessionServer::CLIENT_SERVER_MESSAGE_RMI);
+        this->SendToServer(this->DataServerController, raw_message, false);
         }
       else if(!remoteObject)
         {
@@ -602,6 +693,69 @@ void vtkSMSessionClient::PushState(vtkSMMessage* message)
     }
 }
 
+//----------------------------------------------------------------------------
+void vtkSMSessionClient::BeginTransaction()
+{
+  this->TransactionDepth++;
+}
+
+//----------------------------------------------------------------------------
+void vtkSMSessionClient::EndTransaction()
+{
+  if (this->TransactionDepth == 0)
+    {
+    vtkErrorMacro("EndTransaction() called without a matching BeginTransaction().");
+    return;
+    }
+  if (--this->TransactionDepth == 0)
+    {
+    this->FlushTransaction();
+    }
+}
+
+//----------------------------------------------------------------------------
+vtkTypeUInt64 vtkSMSessionClient::GetNumberOfMessagesSent()
+{
+  return this->Transaction->Queues[0].NumberOfMessagesSent +
+    this->Transaction->Queues[1].NumberOfMessagesSent;
+}
+
+//----------------------------------------------------------------------------
+void vtkSMSessionClient::FlushTransaction()
+{
+  vtkTransaction::Send(this->Transaction->Queues[0], this->DataServerController);
+  vtkTransaction::Send(this->Transaction->Queues[1], this->RenderServerController);
+}
+
+//----------------------------------------------------------------------------
+void vtkSMSessionClient::SendToServer(vtkMultiProcessController* controller,
+  const std::vector<unsigned char>& raw_message, bool expect_reply,
+  const unsigned char* payload/*=NULL*/, int payload_size/*=-1*/)
+{
+  int index = (controller == this->DataServerController)? 0 : 1;
+  vtkTransaction::vtkQueue& queue = this->Transaction->Queues[index];
+  if (expect_reply)
+    {
+    // The request may depend on what was queued for the other server, e.g.
+    // when data is delivered from the data-server to the render-server.
+    vtkTransaction::Send(this->Transaction->Queues[1 - index],
+      index == 0? this->RenderServerController : this->DataServerController);
+    }
+
+  vtkTransaction::ClosePush(queue);
+  queue.Messages.push_back(std::string(raw_message.begin(), raw_message.end()));
+  if (payload_size >= 0)
+    {
+    queue.Payloads.push_back(payload_size > 0?
+      std::string(reinterpret_cast<const char*>(payload), payload_size) :
+      std::string());
+    }
+  if (expect_reply || this->TransactionDepth == 0)
+    {
+    vtkTransaction::Send(queue, controller);
+    }
+}
+
 //----------------------------------------------------------------------------
 void vtkSMSessionClient::PullState(vtkSMMessage* message)
 {
@@ -635,9 +789,7 @@ void vtkSMSessionClient::PullState(vtkSMMessage* message)
     stream << message->SerializeAsString();
     std::vector<unsigned char> raw_message;
     stream.GetRawData(raw_message);
-    controller->TriggerRMIOnAllChildren(
-      &raw_message[0], static_cast<int>(raw_message.size()),
-      vtkPVSessionServer::CLIENT_SERVER_MESSAGE_RMI);
+    this->SendToServer(controller, raw_message, true);
 
     // Get the reply
     vtkMultiProcessStream replyStream;
@@ -694,16 +846,16 @@ void vtkSMSessionClient::ExecuteStream(
 
     for (int cc=0; cc < num_controllers; cc++)
       {
-      controllers[cc]->TriggerRMIOnAllChildren(
-        &raw_message[0], static_cast<int>(raw_message.size()),
-        vtkPVSessionServer::CLIENT_SERVER_MESSAGE_RMI);
-      controllers[cc]->Send(data, static_cast<int>(size), 1,
-        vtkPVSessionServer::EXECUTE_STREAM_TAG);
+      this->SendToServer(controllers[cc], raw_message, false,
+        data, static_cast<int>(size));
       }
     }
 
   if ( (location & vtkPVSession::CLIENT) != 0)
     {
+    // The client side may communicate with the servers e.g. to deliver data,
+    // so the servers must have received everything before.
+    this->FlushTransaction();
     this->Superclass::ExecuteStream(location, cssstream, ignore_errors);
     }
 }
@@ -738,9 +890,7 @@ const vtkClientServerStream& vtkSMSessionClient::GetLastResult(vtkTypeUInt32 loc
     stream << static_cast<int>(vtkPVSessionServer::LAST_RESULT);
     std::vector<unsigned char> raw_message;
     stream.GetRawData(raw_message);
-    controller->TriggerRMIOnAllChildren(
-      &raw_message[0], static_cast<int>(raw_message.size()),
-      vtkPVSessionServer::CLIENT_SERVER_MESSAGE_RMI);
+    this->SendToServer(controller, raw_message, true);
 
     // Get the reply
     int size=0;
@@ -816,9 +966,7 @@ bool vtkSMSessionClient::GatherInformation(
 
   if (controller)
     {
-    controller->TriggerRMIOnAllChildren(
-      &raw_message[0], static_cast<int>(raw_message.size()),
-      vtkPVSessionServer::CLIENT_SERVER_MESSAGE_RMI);
+    this->SendToServer(controller, raw_message, true);
 
     int length2 = 0;
     controller->Receive(&length2, 1, 1, vtkPVSessionServer::REPLY_GATHER_INFORMATION_TAG);
@@ -889,9 +1037,7 @@ void vtkSMSessionClient::UnRegisterSIObject(vtkSMMessage* message)
     stream.GetRawData(raw_message);
     for (int cc=0; cc < num_controllers; cc++)
       {
-      controllers[cc]->TriggerRMIOnAllChildren(
-        &raw_message[0], static_cast<int>(raw_message.size()),
-        vtkPVSessionServer::CLIENT_SERVER_MESSAGE_RMI);
+      this->SendToServer(controllers[cc], raw_message, false);
       }
     }
 
@@ -935,9 +1081,7 @@ void vtkSMSessionClient::RegisterSIObject(vtkSMMessage* message)
       {
       if(controllers[cc] != NULL)
         {
-        controllers[cc]->TriggerRMIOnAllChildren(
-              &raw_message[0], static_cast<int>(raw_message.size()),
-            vtkPVSessionServer::CLIENT_SERVER_MESSAGE_RMI);
+        this->SendToServer(controllers[cc], raw_message, false);
         }
       }
     }
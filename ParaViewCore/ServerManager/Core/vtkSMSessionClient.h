@@ -23,6 +23,7 @@
 
 #include "vtkPVServerManagerCoreModule.h" //needed for exports
 #include "vtkSMSession.h"
+#include <vector> // for std::vector
 
 class vtkMultiProcessController;
 class vtkPVServerInformation;
@@ -96,6 +97,24 @@ public:
     bool ignore_errors=false);
   virtual const vtkClientServerStream& GetLastResult(vtkTypeUInt32 location);
 
+  // Description:
+  // Overridden to queue the requests that expect no reply (state pushes,
+  // stream executions, object registrations) while a transaction is open.
+  // The queued requests are sent to each server in a single message when the
+  // outermost transaction ends, or along with the next request that expects a
+  // reply (PullState(), GatherInformation(), GetLastResult()) so that such a
+  // request only costs one round trip.
+  virtual void BeginTransaction();
+  virtual void EndTransaction();
+
+  // Description:
+  // Returns the number of messages sent to the servers for the requests made
+  // on this session. Outside of a transaction, each request is sent in its
+  // own message. In a transaction, the queued requests are sent in a single
+  // message per server, along with the next request that expects a reply if
+  // any. Used to check the round trips saved by transactions.
+  vtkTypeUInt64 GetNumberOfMessagesSent();
+
   // Description:
   // When Connect() is waiting for a server to connect back to the client (in
   // reverse connect mode), then it periodically fires ProgressEvent.
@@ -192,6 +211,18 @@ protected:
   // Notify server side object that it is used by one more client. (SIObject)
   virtual void RegisterSIObject(vtkSMMessage* msg);
 
+  // Description:
+  // Sends a CLIENT_SERVER_MESSAGE_RMI message to the given server, followed
+  // by the payload with the EXECUTE_STREAM_TAG when payload_size >= 0. While
+  // a transaction is open, messages are queued unless expect_reply is true.
+  void SendToServer(vtkMultiProcessController* controller,
+    const std::vector<unsigned char>& raw_message, bool expect_reply,
+    const unsigned char* payload=NULL, int payload_size=-1);
+
+  // Description:
+  // Sends the messages queued by the current transaction, if any.
+  void FlushTransaction();
+
   // Description:
   // Translates the location to a real location based on whether a separate
   // render-server exists.
@@ -236,6 +267,11 @@ private:
   void operator=(const vtkSMSessionClient&) VTK_DELETE_FUNCTION;
 
   int NotBusy;
+
+  // Transaction nesting level and the messages queued for the servers.
+  int TransactionDepth;
+  class vtkTransaction;
+  vtkTransaction* Transaction;
   vtkTypeUInt32 LastGlobalID;
   vtkTypeUInt32 LastGlobalIDAvailable;
 
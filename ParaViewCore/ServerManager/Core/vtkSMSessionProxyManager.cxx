@@ -42,6 +42,7 @@
 #include "vtkSMProxyProperty.h"
 #include "vtkSMProxySelectionModel.h"
 #include "vtkSMSessionClient.h"
+#include "vtkSMSourceProxy.h"
 #include "vtkSMStateLoader.h"
 #include "vtkSMStateLocator.h"
 #include "vtkSMUndoStackBuilder.h"
@@ -79,6 +80,145 @@ public:
 
 class vtkSMProxyManagerProxySet : public std::set<vtkSMProxy*> {};
 
+//*****************************************************************************
+namespace
+{
+  // Binary state files start with this tag followed by the format version.
+  const char vtkBinaryStateTag[8] = { 'P', 'V', 'B', 'S', 'T', 'A', 'T', 'E' };
+  const vtkTypeUInt32 vtkBinaryStateVersion = 1;
+
+  typedef std::map<vtkTypeUInt32, vtkTypeUInt32> vtkBinaryStateIdMap;
+
+  void vtkWriteUInt32(ostream& os, vtkTypeUInt32 value)
+    {
+    unsigned char bytes[4];
+    for (int cc=0; cc < 4; cc++)
+      {
+      bytes[cc] = static_cast<unsigned char>((value >> (8*cc)) & 0xff);
+      }
+    os.write(reinterpret_cast<char*>(bytes), 4);
+    }
+
+  // The readers below are given the number of bytes left in the stream, and
+  // fail instead of reading, or allocating, past them.
+  bool vtkReadUInt32(istream& is, vtkTypeUInt32& value,
+    std::streamoff& remaining)
+    {
+    unsigned char bytes[4];
+    if (remaining < 4 || !is.read(reinterpret_cast<char*>(bytes), 4))
+      {
+      return false;
+      }
+    remaining -= 4;
+    value = 0;
+    for (int cc=0; cc < 4; cc++)
+      {
+      value |= static_cast<vtkTypeUInt32>(bytes[cc]) << (8*cc);
+      }
+    return true;
+    }
+
+  void vtkWriteMessage(ostream& os, const vtkSMMessage& msg)
+    {
+    std::string data = msg.SerializePartialAsString();
+    vtkWriteUInt32(os, static_cast<vtkTypeUInt32>(data.size()));
+    os.write(data.c_str(), data.size());
+    }
+
+  bool vtkReadMessage(istream& is, vtkSMMessage& msg,
+    std::streamoff& remaining)
+    {
+    vtkTypeUInt32 size;
+    if (!vtkReadUInt32(is, size, remaining) ||
+      static_cast<std::streamoff>(size) > remaining)
+      {
+      return false;
+      }
+    std::string data(size, '\0');
+    if (size > 0 && !is.read(&data[0], size))
+      {
+      return false;
+      }
+    remaining -= size;
+    return msg.ParsePartialFromString(data);
+    }
+
+  // Replaces the proxy ids referred to by the variant. References to proxies
+  // that are not part of the state are dropped, as the XML state loader does.
+  void vtkRemapVariant(Variant* variant, const vtkBinaryStateIdMap& ids)
+    {
+    if (variant->type() != Variant::PROXY && variant->type() != Variant::INPUT)
+      {
+      return;
+      }
+    bool hasPorts =
+      (variant->port_number_size() == variant->proxy_global_id_size());
+    std::vector<vtkTypeUInt32> gids;
+    std::vector<int> ports;
+    for (int cc=0; cc < variant->proxy_global_id_size(); cc++)
+      {
+      vtkTypeUInt32 gid =
+        static_cast<vtkTypeUInt32>(variant->proxy_global_id(cc));
+      if (gid != 0)
+        {
+        vtkBinaryStateIdMap::const_iterator iter = ids.find(gid);
+        if (iter == ids.end())
+          {
+          continue;
+          }
+        gid = iter->second;
+        }
+      gids.push_back(gid);
+      if (hasPorts)
+        {
+        ports.push_back(variant->port_number(cc));
+        }
+      }
+    variant->clear_proxy_global_id();
+    variant->clear_port_number();
+    for (size_t cc=0; cc < gids.size(); cc++)
+      {
+      variant->add_proxy_global_id(gids[cc]);
+      if (hasPorts)
+        {
+        variant->add_port_number(ports[cc]);
+        }
+      }
+    }
+
+  void vtkRemapProxyState(vtkSMMessage& state, const vtkBinaryStateIdMap& ids)
+    {
+    vtkBinaryStateIdMap::const_iterator iter;
+    iter = ids.find(static_cast<vtkTypeUInt32>(state.global_id()));
+    state.set_global_id(iter != ids.end()? iter->second : 0);
+
+    for (int cc=0; cc < state.ExtensionSize(ProxyState::subproxy); cc++)
+      {
+      ProxyState_SubProxy* subproxy =
+        state.MutableExtension(ProxyState::subproxy, cc);
+      iter = ids.find(subproxy->global_id());
+      subproxy->set_global_id(iter != ids.end()? iter->second : 0);
+      }
+    for (int cc=0; cc < state.ExtensionSize(ProxyState::property); cc++)
+      {
+      ProxyState_Property* prop =
+        state.MutableExtension(ProxyState::property, cc);
+      if (prop->has_value())
+        {
+        vtkRemapVariant(prop->mutable_value(), ids);
+        }
+      for (int kk=0; kk < prop->user_data_size(); kk++)
+        {
+        ProxyState_UserData* data = prop->mutable_user_data(kk);
+        for (int ll=0; ll < data->variant_size(); ll++)
+          {
+          vtkRemapVariant(data->mutable_variant(ll), ids);
+          }
+        }
+      }
+    }
+}
+
 //*****************************************************************************
 class vtkSMProxyManagerObserver : public vtkCommand
 {
@@ -1231,6 +1371,478 @@ vtkPVXMLElement* vtkSMSessionProxyManager::SaveXMLState()
   return root;
 }
 
+//---------------------------------------------------------------------------
+bool vtkSMSessionProxyManager::SaveBinaryState(const char* filename)
+{
+  if (!filename || !this->Session)
+    {
+    vtkErrorMacro("A filename and a session are required to save the state.");
+    return false;
+    }
+
+  // The header lists the proxy and link registrations, as well as the custom
+  // proxy definitions. It is followed by the state of every proxy referred
+  // to by the registrations and their sub-proxies, then the link states.
+  vtkSMMessage header;
+  header.set_global_id(0);
+  header.set_location(0);
+
+  std::vector<vtkSMProxy*> proxies;
+  std::set<vtkSMProxy*> visited_proxies;
+
+  vtkSMSessionProxyManagerInternals::ProxyGroupType::iterator it =
+    this->Internals->RegisteredProxyMap.begin();
+  for (; it != this->Internals->RegisteredProxyMap.end(); it++)
+    {
+    // Skip the same groups as the XML state.
+    const std::string& colname = it->first;
+    const std::string protstr = "_prototypes";
+    if (colname == "global_properties" || colname == "settings" ||
+      colname.empty() || colname[0] == '_' ||
+      (colname.size() > protstr.size() &&
+       colname.compare(colname.size() - protstr.size(),
+         protstr.size(), protstr) == 0))
+      {
+      continue;
+      }
+
+    vtkSMProxyManagerProxyMapType::iterator it2 = it->second.begin();
+    for (; it2 != it->second.end(); it2++)
+      {
+      vtkSMProxyManagerProxyListType::iterator it3 = it2->second.begin();
+      for (; it3 != it2->second.end(); ++it3)
+        {
+        vtkSMProxy* proxy = it3->GetPointer()->Proxy.GetPointer();
+        PXMRegistrationState_Entry* entry =
+          header.AddExtension(PXMRegistrationState::registered_proxy);
+        entry->set_group(colname);
+        entry->set_name(it2->first);
+        entry->set_global_id(proxy->GetGlobalID());
+
+        std::vector<vtkSMProxy*> stack(1, proxy);
+        while (!stack.empty())
+          {
+          vtkSMProxy* current = stack.back();
+          stack.pop_back();
+          if (!visited_proxies.insert(current).second)
+            {
+            continue;
+            }
+          proxies.push_back(current);
+          for (unsigned int cc=0; cc < current->GetNumberOfSubProxies(); cc++)
+            {
+            stack.push_back(current->GetSubProxy(cc));
+            }
+          }
+        }
+      }
+    }
+
+  vtkSMSessionProxyManagerInternals::LinkType::iterator linkIter =
+    this->Internals->RegisteredLinkMap.begin();
+  for (; linkIter != this->Internals->RegisteredLinkMap.end(); ++linkIter)
+    {
+    PXMRegistrationState_Entry* entry =
+      header.AddExtension(PXMRegistrationState::registered_link);
+    entry->set_name(linkIter->first);
+    entry->set_global_id(linkIter->second->GetGlobalID());
+    }
+
+  vtkNew<vtkPVXMLElement> definitions;
+  definitions->SetName("CustomProxyDefinitions");
+  this->SaveCustomProxyDefinitions(definitions.GetPointer());
+  for (unsigned int cc=0; cc < definitions->GetNumberOfNestedElements(); cc++)
+    {
+    vtkPVXMLElement* definition = definitions->GetNestedElement(cc);
+    std::ostringstream xml;
+    definition->PrintXML(xml, vtkIndent());
+    ProxyDefinitionState_ProxyXMLDefinition* entry =
+      header.AddExtension(ProxyDefinitionState::xml_custom_definition_proxy);
+    entry->set_group(definition->GetAttributeOrEmpty("group"));
+    entry->set_name(definition->GetAttributeOrEmpty("name"));
+    entry->set_xml(xml.str());
+    }
+
+  ofstream os(filename, ios::out | ios::binary);
+  if (!os)
+    {
+    vtkErrorMacro("Failed to open file : " << filename);
+    return false;
+    }
+  os.write(vtkBinaryStateTag, sizeof(vtkBinaryStateTag));
+  vtkWriteUInt32(os, vtkBinaryStateVersion);
+  vtkWriteMessage(os, header);
+
+  // Save the current property values, which may not have been pushed yet,
+  // like the XML state does.
+  vtkWriteUInt32(os, static_cast<vtkTypeUInt32>(proxies.size()));
+  for (size_t cc=0; cc < proxies.size(); cc++)
+    {
+    vtkSMProxy* proxy = proxies[cc];
+    vtkSMMessage state;
+    state.CopyFrom(*proxy->GetFullState());
+    state.set_global_id(proxy->GetGlobalID());
+    state.set_location(proxy->GetLocation());
+    state.ClearExtension(ProxyState::property);
+
+    vtkSmartPointer<vtkSMPropertyIterator> iter;
+    iter.TakeReference(proxy->NewPropertyIterator());
+    iter->SetTraverseSubProxies(0);
+    for (iter->Begin(); !iter->IsAtEnd(); iter->Next())
+      {
+      vtkSMProperty* property = iter->GetProperty();
+      if (property && !property->GetInformationOnly() &&
+        !property->GetIsInternal() && !property->IsStateIgnored() &&
+        strcmp(property->GetClassName(), "vtkSMProperty") != 0)
+        {
+        property->WriteTo(&state);
+        }
+      }
+    vtkWriteMessage(os, state);
+    }
+
+  vtkWriteUInt32(os, static_cast<vtkTypeUInt32>(
+      this->Internals->RegisteredLinkMap.size()));
+  for (linkIter = this->Internals->RegisteredLinkMap.begin();
+    linkIter != this->Internals->RegisteredLinkMap.end(); ++linkIter)
+    {
+    vtkSMMessage state;
+    state.CopyFrom(*linkIter->second->GetFullState());
+    state.set_global_id(linkIter->second->GetGlobalID());
+    vtkWriteMessage(os, state);
+    }
+
+  os.flush();
+  if (!os)
+    {
+    vtkErrorMacro("Failed to write file : " << filename);
+    return false;
+    }
+  return true;
+}
+
+//---------------------------------------------------------------------------
+bool vtkSMSessionProxyManager::LoadBinaryState(const char* filename)
+{
+  vtkSMSession* session = this->Session;
+  if (!filename || !session)
+    {
+    vtkErrorMacro("A filename and a session are required to load the state.");
+    return false;
+    }
+
+  ifstream is(filename, ios::in | ios::binary);
+  if (!is)
+    {
+    vtkErrorMacro("Failed to open file : " << filename);
+    return false;
+    }
+
+  is.seekg(0, ios::end);
+  std::streamoff remaining = is.tellg();
+  is.seekg(0, ios::beg);
+
+  char tag[sizeof(vtkBinaryStateTag)];
+  vtkTypeUInt32 version = 0;
+  remaining -= static_cast<std::streamoff>(sizeof(tag));
+  if (remaining < 0 || !is.read(tag, sizeof(tag)) ||
+    memcmp(tag, vtkBinaryStateTag, sizeof(tag)) != 0 ||
+    !vtkReadUInt32(is, version, remaining) || version != vtkBinaryStateVersion)
+    {
+    vtkErrorMacro("Not a binary state file, or unsupported version : "
+      << filename);
+    return false;
+    }
+
+  vtkSMMessage header;
+  std::vector<vtkSMMessage> proxyStates;
+  std::vector<vtkSMMessage> linkStates;
+  vtkTypeUInt32 count = 0;
+  bool valid = vtkReadMessage(is, header, remaining) &&
+    vtkReadUInt32(is, count, remaining);
+  for (vtkTypeUInt32 cc=0; valid && cc < count; cc++)
+    {
+    proxyStates.push_back(vtkSMMessage());
+    valid = vtkReadMessage(is, proxyStates.back(), remaining);
+    }
+  valid = valid && vtkReadUInt32(is, count, remaining);
+  for (vtkTypeUInt32 cc=0; valid && cc < count; cc++)
+    {
+    linkStates.push_back(vtkSMMessage());
+    valid = vtkReadMessage(is, linkStates.back(), remaining);
+    }
+  if (!valid)
+    {
+    vtkErrorMacro("Failed to read binary state : " << filename);
+    return false;
+    }
+
+  // Custom proxy definitions must be known before the proxies are created.
+  int numberOfDefinitions =
+    header.ExtensionSize(ProxyDefinitionState::xml_custom_definition_proxy);
+  if (numberOfDefinitions > 0)
+    {
+    vtkNew<vtkPVXMLElement> definitions;
+    definitions->SetName("CustomProxyDefinitions");
+    for (int cc=0; cc < numberOfDefinitions; cc++)
+      {
+      vtkNew<vtkPVXMLParser> parser;
+      if (parser->Parse(header.GetExtension(
+            ProxyDefinitionState::xml_custom_definition_proxy, cc).xml().c_str()))
+        {
+        definitions->AddNestedElement(parser->GetRootElement());
+        }
+      }
+    this->LoadCustomProxyDefinitions(definitions.GetPointer());
+    }
+
+  std::map<vtkTypeUInt32, size_t> stateIndex;
+  for (size_t cc=0; cc < proxyStates.size(); cc++)
+    {
+    stateIndex[static_cast<vtkTypeUInt32>(proxyStates[cc].global_id())] = cc;
+    }
+
+  // There is only one animation scene, time animation cue and time keeper
+  // per session, as in vtkSMStateLoader, their state is loaded on the existing
+  // ones. Map their ids, and those of their sub-proxies, to the existing
+  // proxies.
+  vtkBinaryStateIdMap ids;
+  std::vector<std::pair<size_t, vtkSMProxy*> > singletons;
+  std::vector<std::pair<vtkTypeUInt32, vtkSMProxy*> > pending;
+  for (size_t cc=0; cc < proxyStates.size(); cc++)
+    {
+    const vtkSMMessage& state = proxyStates[cc];
+    const std::string& group = state.GetExtension(ProxyState::xml_group);
+    const std::string& name = state.GetExtension(ProxyState::xml_name);
+    vtkSMProxy* existing = NULL;
+    if (state.HasExtension(ProxyState::xml_sub_proxy_name))
+      {
+      continue;
+      }
+    else if (group == "animation" &&
+      (name == "AnimationScene" || name == "TimeAnimationCue"))
+      {
+      existing = this->FindProxy("animation", "animation", name.c_str());
+      }
+    else if (group == "misc" && name == "TimeKeeper")
+      {
+      existing = this->FindProxy("timekeeper", "misc", "TimeKeeper");
+      }
+    if (existing)
+      {
+      pending.push_back(std::make_pair(
+          static_cast<vtkTypeUInt32>(state.global_id()), existing));
+      }
+    }
+  while (!pending.empty())
+    {
+    std::pair<vtkTypeUInt32, vtkSMProxy*> item = pending.back();
+    pending.pop_back();
+    std::map<vtkTypeUInt32, size_t>::iterator found =
+      stateIndex.find(item.first);
+    if (found == stateIndex.end() || ids.find(item.first) != ids.end())
+      {
+      continue;
+      }
+    ids[item.first] = item.second->GetGlobalID();
+    singletons.push_back(std::make_pair(found->second, item.second));
+
+    const vtkSMMessage& state = proxyStates[found->second];
+    for (int cc=0; cc < state.ExtensionSize(ProxyState::subproxy); cc++)
+      {
+      const ProxyState_SubProxy& subproxy =
+        state.GetExtension(ProxyState::subproxy, cc);
+      if (vtkSMProxy* existing =
+        item.second->GetSubProxy(subproxy.name().c_str()))
+        {
+        pending.push_back(std::make_pair(subproxy.global_id(), existing));
+        }
+      }
+    }
+
+  // Every other proxy gets a new id.
+  vtkTypeUInt32 numberOfNewIds =
+    static_cast<vtkTypeUInt32>(proxyStates.size() - singletons.size());
+  vtkTypeUInt32 nextId = numberOfNewIds > 0?
+    session->GetNextChunkGlobalUniqueIdentifier(numberOfNewIds) : 0;
+  std::vector<bool> isSingleton(proxyStates.size(), false);
+  for (size_t cc=0; cc < singletons.size(); cc++)
+    {
+    isSingleton[singletons[cc].first] = true;
+    }
+  for (size_t cc=0; cc < proxyStates.size(); cc++)
+    {
+    if (!isSingleton[cc])
+      {
+      ids[static_cast<vtkTypeUInt32>(proxyStates[cc].global_id())] = nextId++;
+      }
+    }
+
+  // The deserializer and vtkSMProxy::LoadState(), for sub-proxies, look the
+  // states up in the session state locator.
+  vtkSMStateLocator* stateLocator = session->GetStateLocator();
+  for (size_t cc=0; cc < proxyStates.size(); cc++)
+    {
+    vtkRemapProxyState(proxyStates[cc], ids);
+    if (!isSingleton[cc])
+      {
+      stateLocator->RegisterState(&proxyStates[cc]);
+      }
+    }
+
+  vtkNew<vtkSMDeserializerProtobuf> deserializer;
+  deserializer->SetStateLocator(stateLocator);
+  deserializer->SetSessionProxyManager(this);
+
+  vtkNew<vtkSMProxyLocator> locator;
+  locator->SetDeserializer(deserializer.GetPointer());
+  locator->UseSessionToLocateProxy(true);
+  locator->SetSession(session);
+
+  bool previous = this->StateUpdateNotification;
+  this->StateUpdateNotification = false;
+
+  // Create the proxies and push all their states in a single transaction.
+  session->BeginTransaction();
+  vtkSMProxyProperty::EnableProxyCreation();
+  for (size_t cc=singletons.size(); cc > 0; cc--)
+    {
+    singletons[cc-1].second->LoadState(
+      &proxyStates[singletons[cc-1].first], locator.GetPointer());
+    }
+  for (size_t cc=0; cc < singletons.size(); cc++)
+    {
+    singletons[cc].second->UpdateVTKObjects();
+    }
+  int numberOfRegisteredProxies =
+    header.ExtensionSize(PXMRegistrationState::registered_proxy);
+  std::vector<vtkSMProxy*> registeredProxies(numberOfRegisteredProxies);
+  for (int cc=0; cc < numberOfRegisteredProxies; cc++)
+    {
+    const PXMRegistrationState_Entry& entry =
+      header.GetExtension(PXMRegistrationState::registered_proxy, cc);
+    vtkBinaryStateIdMap::iterator iter =
+      ids.find(static_cast<vtkTypeUInt32>(entry.global_id()));
+    registeredProxies[cc] = (iter != ids.end())?
+      locator->LocateProxy(iter->second) : NULL;
+    }
+  vtkSMProxyProperty::DisableProxyCreation();
+  session->EndTransaction();
+
+  for (size_t cc=0; cc < proxyStates.size(); cc++)
+    {
+    vtkSMSourceProxy* source = vtkSMSourceProxy::SafeDownCast(
+      session->GetRemoteObject(
+        static_cast<vtkTypeUInt32>(proxyStates[cc].global_id())));
+    if (source && !isSingleton[cc])
+      {
+      source->UpdatePipelineInformation();
+      }
+    }
+
+  session->BeginTransaction();
+  for (int cc=0; cc < numberOfRegisteredProxies; cc++)
+    {
+    const PXMRegistrationState_Entry& entry =
+      header.GetExtension(PXMRegistrationState::registered_proxy, cc);
+    if (registeredProxies[cc])
+      {
+      this->RegisterProxy(entry.group().c_str(), entry.name().c_str(),
+        registeredProxies[cc]);
+      }
+    else
+      {
+      vtkWarningMacro("Failed to restore proxy " << entry.group() << ", "
+        << entry.name());
+      }
+    }
+
+  std::map<vtkTypeUInt32, size_t> linkIndex;
+  for (size_t cc=0; cc < linkStates.size(); cc++)
+    {
+    linkIndex[static_cast<vtkTypeUInt32>(linkStates[cc].global_id())] = cc;
+    }
+  for (int cc=0;
+    cc < header.ExtensionSize(PXMRegistrationState::registered_link); cc++)
+    {
+    const PXMRegistrationState_Entry& entry =
+      header.GetExtension(PXMRegistrationState::registered_link, cc);
+    std::map<vtkTypeUInt32, size_t>::iterator found =
+      linkIndex.find(static_cast<vtkTypeUInt32>(entry.global_id()));
+    if (found == linkIndex.end())
+      {
+      continue;
+      }
+    vtkSMMessage& state = linkStates[found->second];
+    for (int kk=0; kk < state.ExtensionSize(LinkState::link); kk++)
+      {
+      LinkState_LinkDescription* description =
+        state.MutableExtension(LinkState::link, kk);
+      vtkBinaryStateIdMap::iterator iter = ids.find(description->proxy());
+      description->set_proxy(iter != ids.end()? iter->second : 0);
+      }
+
+    const char* className =
+      state.GetExtension(DefinitionHeader::client_class).c_str();
+    vtkObject* object = vtkPVInstantiator::CreateInstance(className);
+    vtkSMLink* link = vtkSMLink::SafeDownCast(object);
+    if (link)
+      {
+      link->SetSession(session);
+      link->LoadState(&state, locator.GetPointer());
+      this->RegisterLink(entry.name().c_str(), link);
+      }
+    else
+      {
+      vtkWarningMacro("Failed to restore link " << entry.name()
+        << " of type " << className);
+      }
+    if (object)
+      {
+      object->Delete();
+      }
+    }
+  session->EndTransaction();
+
+  // Leave the session state locator as pushing the states would have: only
+  // keep the states when undo/redo is tracking them.
+  vtkSMUndoStackBuilder* usb = vtkSMProxyManager::IsInitialized()?
+    vtkSMProxyManager::GetProxyManager()->GetUndoStackBuilder() : NULL;
+  for (size_t cc=0; cc < proxyStates.size(); cc++)
+    {
+    if (isSingleton[cc])
+      {
+      continue;
+      }
+    vtkTypeUInt32 gid = static_cast<vtkTypeUInt32>(proxyStates[cc].global_id());
+    vtkSMProxy* proxy =
+      vtkSMProxy::SafeDownCast(session->GetRemoteObject(gid));
+    if (usb && proxy && proxy->GetFullState())
+      {
+      vtkSMMessage state;
+      state.CopyFrom(*proxy->GetFullState());
+      state.set_global_id(gid);
+      state.set_location(proxy->GetLocation());
+      stateLocator->RegisterState(&state);
+      }
+    else
+      {
+      stateLocator->UnRegisterState(gid, false);
+      }
+    }
+
+  vtkSMProxy* timekeeper = this->GetProxy("timekeeper", "TimeKeeper");
+  if (timekeeper)
+    {
+    timekeeper->GetProperty("TimeRange")->Modified();
+    timekeeper->GetProperty("TimestepValues")->Modified();
+    }
+
+  this->StateUpdateNotification = previous;
+  this->TriggerStateUpdate();
+  return true;
+}
+
 //---------------------------------------------------------------------------
 void vtkSMSessionProxyManager::CollectReferredProxies(
   vtkSMProxyManagerProxySet& setOfProxies, vtkSMProxy* proxy)
@@ -361,6 +361,19 @@ public:
   // it's the caller's responsibility to free it by calling Delete().
   vtkPVXMLElement* SaveXMLState();
 
+  // Description:
+  // Save/Load the state of the server manager in a compact binary format made
+  // of the protobuf states of the registered proxies (and their sub-proxies),
+  // their registration names, the registered links and the custom proxy
+  // definitions. LoadBinaryState() does not go through XML and pushes the
+  // states of all the proxies to the servers in a single batch, which makes
+  // it a lot faster than LoadXMLState() for large states. Unlike the XML
+  // state, vtkCommand::SaveStateEvent/LoadStateEvent are not fired so
+  // application specific state, such as the view layouts, is not saved.
+  // Returns false on failure.
+  bool SaveBinaryState(const char* filename);
+  bool LoadBinaryState(const char* filename);
+
   // Description:
   // Given a group name, create prototypes and store them
   // in a instance group called groupName_prototypes.
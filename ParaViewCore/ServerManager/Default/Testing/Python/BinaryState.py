@@ -0,0 +1,87 @@
+# Save a state as XML and as a binary state, and check that both restore the
+# same pipelines. Run with --benchmark to time them on a large state.
+
+from paraview.simple import *
+from paraview import servermanager
+from paraview import smtesting
+import os
+import os.path
+import sys
+
+smtesting.ProcessCommandLineArguments()
+
+numPipelines = smtesting.ProblemSize(10, 200)
+
+view = CreateRenderView()
+for i in range(numPipelines):
+  sphere = Sphere(Radius=1 + i * 0.01, ThetaResolution=8 + i % 8)
+  RenameSource("Sphere%d" % i, sphere)
+  shrink = Shrink(Input=sphere, ShrinkFactor=0.25 + (i % 50) * 0.01)
+  RenameSource("Shrink%d" % i, shrink)
+  Show(shrink, view)
+
+xml_filename = os.path.join(smtesting.TempDir, "BinaryState.pvsm")
+binary_filename = os.path.join(smtesting.TempDir, "BinaryState.pvbs")
+
+pxm = servermanager.ProxyManager()
+smtesting.Timed("Save XML state", pxm.SaveState, xml_filename)
+if not smtesting.Timed("Save binary state", pxm.SaveBinaryState,
+    binary_filename):
+  print "ERROR: Failed to save the binary state."
+  sys.exit(1)
+
+numSources = pxm.GetNumberOfProxies("sources")
+numRepresentations = pxm.GetNumberOfProxies("representations")
+
+def check_state(label):
+  pxm = servermanager.ProxyManager()
+  if pxm.GetNumberOfProxies("sources") != numSources:
+    print "ERROR: %s: wrong number of sources: %d, expected %d" % \
+      (label, pxm.GetNumberOfProxies("sources"), numSources)
+    sys.exit(1)
+  if pxm.GetNumberOfProxies("representations") != numRepresentations:
+    print "ERROR: %s: wrong number of representations: %d, expected %d" % \
+      (label, pxm.GetNumberOfProxies("representations"), numRepresentations)
+    sys.exit(1)
+  for i in range(0, numPipelines, max(1, numPipelines / 10)):
+    sphere = FindSource("Sphere%d" % i)
+    shrink = FindSource("Shrink%d" % i)
+    if not sphere or not shrink:
+      print "ERROR: %s: pipeline %d is missing" % (label, i)
+      sys.exit(1)
+    if abs(sphere.Radius - (1 + i * 0.01)) > 1e-12 or \
+       sphere.ThetaResolution != 8 + i % 8 or \
+       abs(shrink.ShrinkFactor - (0.25 + (i % 50) * 0.01)) > 1e-12:
+      print "ERROR: %s: pipeline %d has wrong property values" % (label, i)
+      sys.exit(1)
+    if shrink.Input.GetGlobalID() != sphere.GetGlobalID():
+      print "ERROR: %s: pipeline %d is not connected" % (label, i)
+      sys.exit(1)
+  shrink.UpdatePipeline()
+  if shrink.GetDataInformation().GetNumberOfCells() == 0:
+    print "ERROR: %s: the loaded pipeline produces no data" % label
+    sys.exit(1)
+
+Disconnect()
+Connect()
+smtesting.Timed("Load XML state", LoadState, xml_filename)
+check_state("XML")
+
+Disconnect()
+Connect()
+RemoveViewsAndLayouts()
+if not smtesting.Timed("Load binary state",
+    servermanager.ProxyManager().LoadBinaryState, binary_filename):
+  print "ERROR: Failed to load the binary state."
+  sys.exit(1)
+check_state("Binary")
+
+if smtesting.Benchmark:
+  print "XML state size:    %10d bytes" % os.path.getsize(xml_filename)
+  print "Binary state size: %10d bytes" % os.path.getsize(binary_filename)
+
+for filename in (xml_filename, binary_filename):
+  try:
+    os.remove(filename)
+  except:
+    pass
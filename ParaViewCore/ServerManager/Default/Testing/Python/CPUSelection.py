@@ -0,0 +1,60 @@
+# Select points and cells on the render view by rendering the selection passes
+# and with the CPU selection, and check that both select the same elements.
+# Run with --benchmark to time them on a finer sphere.
+
+from paraview.simple import *
+from paraview import servermanager
+from paraview import smtesting
+import sys
+import vtk
+
+smtesting.ProcessCommandLineArguments()
+
+resolution = smtesting.ProblemSize(128, 1024)
+sphere = Sphere(ThetaResolution=resolution, PhiResolution=resolution)
+view = CreateRenderView()
+view.ViewSize = [800, 800]
+Show(sphere, view)
+view.ResetCamera()
+Render(view)
+
+settings = servermanager.ProxyManager().GetProxy("settings", "RenderViewSettings")
+
+regions = [("full view", [0, 0, 799, 799]),
+           ("rubber band", [250, 300, 450, 420]),
+           ("single pixel", [400, 400, 400, 400])]
+
+def select(method, region, label):
+  representations = vtk.vtkCollection()
+  sources = vtk.vtkCollection()
+  smtesting.Timed(label, getattr(view.SMProxy, method),
+    region, representations, sources, False)
+  ids = []
+  for i in range(sources.GetNumberOfItems()):
+    source = servermanager._getPyProxy(sources.GetItemAsObject(i))
+    ids.extend(source.IDs)
+  # IDs are (process, index) pairs.
+  return sorted(zip(ids[0::2], ids[1::2]))
+
+for method in ("SelectSurfaceCells", "SelectSurfacePoints"):
+  for label, region in regions:
+    settings.UseCPUSelection = 0
+    hardware_ids = select(method, region,
+      "%s (%s): render" % (method, label))
+    settings.UseCPUSelection = 1
+    # the first CPU selection builds the hierarchy, time the second one.
+    getattr(view.SMProxy, method)(region, vtk.vtkCollection(),
+      vtk.vtkCollection(), False)
+    cpu_ids = select(method, region, "%s (%s): CPU" % (method, label))
+    if not hardware_ids:
+      print "ERROR: %s (%s): nothing selected" % (method, label)
+      sys.exit(1)
+    # Rasterization rules differ slightly on the silhouette and on shared
+    # edges, allow a small difference.
+    difference = len(set(hardware_ids) ^ set(cpu_ids))
+    if difference > max(2, len(hardware_ids) / 50):
+      print "ERROR: %s (%s): selections differ by %d elements (%d vs %d)" % \
+        (method, label, difference, len(hardware_ids), len(cpu_ids))
+      sys.exit(1)
+
+settings.UseCPUSelection = 0
@@ -0,0 +1,121 @@
+# Check the output of the CSV writer at each Precision setting against
+# printf-style formatting, and with the shortest round-trip formatting. The
+# writer is also compared with vtkDelimitedTextWriter, which formats the values
+# one at a time through an ostream like vtkCSVWriter used to: both must write
+# the same bytes. Run with --benchmark to time the writers on a large table.
+
+from paraview import smtesting
+from paraview import vtk
+from paraview import pvvtkextensions
+from paraview.vtk.vtkIOInfovis import vtkDelimitedTextWriter
+import math
+import os
+import os.path
+import struct
+import sys
+
+smtesting.ProcessCommandLineArguments()
+
+numRows = smtesting.ProblemSize(2000, 200000)
+
+doubles = vtk.vtkDoubleArray()
+doubles.SetName("double")
+doubles.SetNumberOfTuples(numRows)
+floats = vtk.vtkFloatArray()
+floats.SetName("float")
+floats.SetNumberOfTuples(numRows)
+ints = vtk.vtkIntArray()
+ints.SetName("int")
+ints.SetNumberOfTuples(numRows)
+for i in range(numRows):
+  value = math.sin(i * 0.1) * 10.0 ** ((i % 21) - 10)
+  doubles.SetValue(i, value)
+  floats.SetValue(i, value)
+  ints.SetValue(i, i * 7919 - numRows * 3000)
+
+table = vtk.vtkTable()
+table.AddColumn(doubles)
+table.AddColumn(floats)
+table.AddColumn(ints)
+
+temp_filename = os.path.join(smtesting.TempDir, "CSVWriterPrecision.csv")
+
+writer = pvvtkextensions.vtkCSVWriter()
+writer.SetInputData(table)
+writer.SetFileName(temp_filename)
+
+def check_rows(check_value):
+  f = open(temp_filename, "r")
+  header = f.readline().strip()
+  if header != '"double","float","int"':
+    print "ERROR: Wrong header:", header
+    sys.exit(1)
+  rows = f.readlines()
+  f.close()
+  if len(rows) != numRows:
+    print "ERROR: Wrong number of rows:", len(rows)
+    sys.exit(1)
+  for i in range(0, numRows, max(1, numRows / 2000)):
+    fields = rows[i].strip().split(",")
+    check_value(i, fields[0], doubles.GetValue(i), False)
+    check_value(i, fields[1], floats.GetValue(i), True)
+    if fields[2] != str(ints.GetValue(i)):
+      print "ERROR: Row %d: wrong integer %s" % (i, fields[2])
+      sys.exit(1)
+
+for scientific in (1, 0):
+  writer.SetUseScientificNotation(scientific)
+  fmt = "%.*e" if scientific else "%.*g"
+  for precision in range(0, 18):
+    writer.SetPrecision(precision)
+    smtesting.Timed("Scientific: %d Precision: %d" % (scientific, precision),
+      writer.Write)
+
+    def check_value(row, text, value, single):
+      if text != fmt % (precision, value):
+        print "ERROR: Row %d: got %s, expected %s" % \
+          (row, text, fmt % (precision, value))
+        sys.exit(1)
+    check_rows(check_value)
+
+  writer.UseShortestRoundTripOn()
+  smtesting.Timed("Scientific: %d Shortest round-trip" % scientific,
+    writer.Write)
+  writer.UseShortestRoundTripOff()
+
+  def check_round_trip(row, text, value, single):
+    parsed = float(text)
+    if single:
+      parsed = struct.unpack("f", struct.pack("f", parsed))[0]
+    if parsed != value:
+      print "ERROR: Row %d: %s does not read back as %r" % (row, text, value)
+      sys.exit(1)
+  check_rows(check_round_trip)
+
+# vtkDelimitedTextWriter uses the default ostream formatting, that is %.6g.
+reference_filename = os.path.join(smtesting.TempDir,
+                                  "CSVWriterPrecisionReference.csv")
+reference = vtkDelimitedTextWriter()
+reference.SetInputData(table)
+reference.SetFileName(reference_filename)
+smtesting.Timed("vtkDelimitedTextWriter", reference.Write)
+
+writer.SetUseScientificNotation(0)
+writer.SetPrecision(6)
+smtesting.Timed("vtkCSVWriter", writer.Write)
+
+f = open(temp_filename, "rb")
+written = f.read()
+f.close()
+f = open(reference_filename, "rb")
+expected = f.read()
+f.close()
+if written != expected:
+  print "ERROR: The output differs from vtkDelimitedTextWriter's."
+  sys.exit(1)
+
+for filename in (temp_filename, reference_filename):
+  try:
+    os.remove(filename)
+  except:
+    pass
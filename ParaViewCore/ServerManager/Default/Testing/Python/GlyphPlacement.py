@@ -0,0 +1,56 @@
+# Check the number of glyphs generated by the Glyph filter on an unstructured
+# grid: glyphs uniformly distributed in space, then changing only the scale
+# factor, which reuses the placement, and glyphing every n-th point. Run with
+# --benchmark to time them on a larger grid.
+
+from paraview.simple import *
+from paraview import smtesting
+import sys
+
+smtesting.ProcessCommandLineArguments()
+
+wavelet = Wavelet()
+size = smtesting.ProblemSize(10, 40)
+numSamplePoints = smtesting.ProblemSize(500, 5000)
+wavelet.WholeExtent = [-size, size, -size, size, -size, size]
+grid = Tetrahedralize(Input=wavelet)
+grid.UpdatePipeline()
+numPoints = grid.GetDataInformation().GetNumberOfPoints()
+
+arrow = Arrow()
+arrow.UpdatePipeline()
+numArrowCells = arrow.GetDataInformation().GetNumberOfCells()
+
+def update(glyph, label):
+  smtesting.Timed(label, glyph.UpdatePipeline)
+  return glyph.GetDataInformation().GetNumberOfCells()
+
+def check(numCells, expected, label):
+  if numCells != expected:
+    print "ERROR: %s generated %d cells instead of %d" % \
+      (label, numCells, expected)
+    sys.exit(1)
+
+glyph = Glyph(Input=grid, GlyphType='Arrow')
+glyph.GlyphMode = 'Uniform Spatial Distribution'
+glyph.MaximumNumberOfSamplePoints = numSamplePoints
+placed = update(glyph, "uniform distribution")
+if placed == 0 or placed % numArrowCells != 0:
+  print "ERROR: uniform distribution generated %d cells" % placed
+  sys.exit(1)
+
+glyph.ScaleFactor = 2 * glyph.ScaleFactor
+check(update(glyph, "scale factor changed"), placed, "scale factor change")
+
+# a new filter places the glyphs from scratch, at the same points.
+other = Glyph(Input=grid, GlyphType='Arrow')
+other.GlyphMode = 'Uniform Spatial Distribution'
+other.MaximumNumberOfSamplePoints = numSamplePoints
+other.ScaleFactor = glyph.ScaleFactor
+check(update(other, "new filter"), placed, "new filter")
+
+stride = 10
+glyph.GlyphMode = 'Every Nth Point'
+glyph.Stride = stride
+check(update(glyph, "every %d-th point" % stride),
+  ((numPoints + stride - 1) / stride) * numArrowCells, "every n-th point")
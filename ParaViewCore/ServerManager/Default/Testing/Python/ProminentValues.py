@@ -0,0 +1,71 @@
+# Check the prominent values found for categorical coloring with a
+# categorical array, an array with a few rare values and a continuous array.
+# Run with --benchmark to time their detection on many more points.
+
+from paraview.simple import *
+from paraview import smtesting
+import sys
+
+smtesting.ProcessCommandLineArguments()
+
+numPoints = smtesting.ProblemSize(20000, 2000000)
+
+source = ProgrammableSource()
+source.OutputDataSetType = 'vtkPolyData'
+source.Script = """
+import vtk
+numPoints = %d
+output = self.GetOutput()
+points = vtk.vtkPoints()
+points.SetNumberOfPoints(numPoints)
+category = vtk.vtkIntArray()
+category.SetName("category")
+category.SetNumberOfTuples(numPoints)
+rare = vtk.vtkIntArray()
+rare.SetName("rare")
+rare.SetNumberOfTuples(numPoints)
+continuous = vtk.vtkDoubleArray()
+continuous.SetName("continuous")
+continuous.SetNumberOfTuples(numPoints)
+for i in range(numPoints):
+  points.SetPoint(i, i %% 1000, i / 1000, 0)
+  category.SetValue(i, (i * 7) %% 5)
+  # 3 values, plus a different value every 1000 points.
+  if i %% 1000 == 0:
+    rare.SetValue(i, 1000 + i)
+  else:
+    rare.SetValue(i, i %% 3)
+  continuous.SetValue(i, i * 0.25)
+output.SetPoints(points)
+output.GetPointData().AddArray(category)
+output.GetPointData().AddArray(rare)
+output.GetPointData().AddArray(continuous)
+""" % numPoints
+
+display = Show(source)
+Render()
+
+def prominentValues(arrayName, uncertainty, label):
+  ColorBy(display, ('POINTS', arrayName))
+  info = smtesting.Timed(label,
+    display.SMProxy.GetProminentValuesInformationForColorArray,
+    uncertainty, 1e-3)
+  values = info.GetProminentComponentValues(0)
+  if values is None:
+    return None
+  return sorted([values.GetValue(i).ToInt()
+    for i in range(values.GetNumberOfTuples())])
+
+expected = [("category", [0, 1, 2, 3, 4]),
+            ("rare", [0, 1, 2]),
+            ("continuous", None)]
+
+for arrayName, expectedValues in expected:
+  values = prominentValues(arrayName, 1e-6, arrayName)
+  # querying again with a smaller uncertainty gathers the information again,
+  # which should use the values cached on the server.
+  cachedValues = prominentValues(arrayName, 1e-7, "%s (cached)" % arrayName)
+  if values != expectedValues or cachedValues != expectedValues:
+    print "ERROR: prominent values of '%s' are %s instead of %s" % \
+      (arrayName, values, expectedValues)
+    sys.exit(1)
@@ -0,0 +1,97 @@
+# Check the number of cells selected by the common query forms on a
+# multiblock dataset with many small blocks, and that the native query
+# evaluation selects the same cells as the Python one. Run with --benchmark to
+# time them on many more blocks.
+
+from paraview.simple import *
+from paraview import smtesting
+import math
+import sys
+import vtk
+
+smtesting.ProcessCommandLineArguments()
+
+numBlocks = smtesting.ProblemSize(50, 2000)
+
+source = ProgrammableSource()
+source.OutputDataSetType = 'vtkMultiBlockDataSet'
+source.Script = """
+import vtk
+numBlocks = %d
+output = self.GetOutput()
+output.SetNumberOfBlocks(numBlocks)
+for i in range(numBlocks):
+  sphere = vtk.vtkSphereSource()
+  sphere.SetCenter(i %% 50, i / 50, 0)
+  sphere.SetRadius(0.4)
+  sphere.Update()
+  block = vtk.vtkPolyData()
+  block.ShallowCopy(sphere.GetOutput())
+  values = vtk.vtkDoubleArray()
+  values.SetName("value")
+  vectors = vtk.vtkDoubleArray()
+  vectors.SetName("vector")
+  vectors.SetNumberOfComponents(3)
+  for j in range(block.GetNumberOfCells()):
+    v = ((i * 37 + j * 11) %% 1000) / 10.0
+    values.InsertNextValue(v)
+    vectors.InsertNextTuple3(v, -v, 1)
+  block.GetCellData().AddArray(values)
+  block.GetCellData().AddArray(vectors)
+  output.SetBlock(i, block)
+""" % numBlocks
+
+# compute the expected values.
+sphere = vtk.vtkSphereSource()
+sphere.Update()
+numCells = sphere.GetOutput().GetNumberOfCells()
+values = []
+for i in range(numBlocks):
+  values.append([((i * 37 + j * 11) % 1000) / 10.0 for j in range(numCells)])
+allValues = [v for block in values for v in block]
+mean = sum(allValues) / len(allValues)
+maximum = max(allValues)
+
+def expected(predicate):
+  count = 0
+  for block in values:
+    for j in range(len(block)):
+      if predicate(block[j], j):
+        count += 1
+  return count
+
+queries = [
+  ("(value > 20) & (value < 30)", lambda v, j: v > 20 and v < 30),
+  ("(value == 5) | (value == 7.5)", lambda v, j: v == 5 or v == 7.5),
+  ("value  == max(value)", lambda v, j: v == maximum),
+  ("abs(value - mean(value)) < 5", lambda v, j: abs(v - mean) < 5),
+  ("mag(vector) >= 50", lambda v, j: math.sqrt(2 * v * v + 1) >= 50),
+  ("vector[:,1] <= -90", lambda v, j: -v <= -90),
+  ("~(id < 3)", lambda v, j: not j < 3),
+  # not supported natively, evaluated with Python.
+  ("(value > 20) & (np.mod(id, 2) == 0)", lambda v, j: v > 20 and j % 2 == 0),
+  ]
+
+def select(query):
+  selection = SelectCells(query, source)
+  extract = ExtractSelection(Input=source, Selection=selection)
+  smtesting.Timed(query, extract.UpdatePipeline)
+  count = extract.GetDataInformation().GetNumberOfCells()
+  Delete(extract)
+  return count
+
+source.UpdatePipeline()
+for query, predicate in queries:
+  count = select(query)
+  if count != expected(predicate):
+    print "ERROR: '%s' selected %d cells instead of %d" % \
+      (query, count, expected(predicate))
+    sys.exit(1)
+
+# same query, evaluated natively and with Python.
+native_count = select("(value > 20) & (value < 30)")
+python_count = select("np.logical_and(value > 20, value < 30)")
+if native_count != python_count:
+  print "ERROR: native and Python evaluations differ: %d vs %d" % \
+    (native_count, python_count)
+  sys.exit(1)
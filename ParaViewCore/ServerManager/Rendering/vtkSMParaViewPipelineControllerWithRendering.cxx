@@ -28,6 +28,7 @@
 #include "vtkSMProxyProperty.h"
 #include "vtkSMProxySelectionModel.h"
 #include "vtkSMPVRepresentationProxy.h"
+#include "vtkSMSession.h"
 #include "vtkSMSessionProxyManager.h"
 #include "vtkSMSourceProxy.h"
 #include "vtkSMTrace.h"
@@ -351,6 +352,9 @@ vtkSMProxy* vtkSMParaViewPipelineControllerWithRendering::Show(
     return (view? view->FindRepresentation(producer, outputPort) : NULL);
     }
 
+  // Create, initialize and register the representation in one transaction.
+  vtkSMScopedSessionTransaction transaction(producer->GetSession());
+
   // find is there's already a representation in this view.
   if (vtkSMProxy* repr = view->FindRepresentation(producer, outputPort))
     {
@@ -52,6 +52,39 @@ int TestOutputData(vtkMultiBlockDataSet* mb, int nCells, int nArrays)
   return 0;
 }
 
+// Count the zones read, which are the non empty blocks of the bases.
+int CountZones(vtkMultiBlockDataSet* mb)
+{
+  int nZones = 0;
+  for (unsigned int i = 0; i < mb->GetNumberOfBlocks(); ++i)
+  {
+    vtkMultiBlockDataSet* mb2 = vtkMultiBlockDataSet::SafeDownCast(mb->GetBlock(i));
+    for (unsigned int j = 0; mb2 && j < mb2->GetNumberOfBlocks(); ++j)
+    {
+      if (mb2->GetBlock(j))
+      {
+        ++nZones;
+      }
+    }
+  }
+  return nZones;
+}
+
+// Every zone must be read by exactly one of the pieces.
+int TestPieces(const char* fileName, int nZones, int nPieces)
+{
+  int nRead = 0;
+  for (int piece = 0; piece < nPieces; ++piece)
+  {
+    vtkNew<vtkCGNSReader> reader;
+    reader->SetFileName(fileName);
+    reader->UpdatePiece(piece, nPieces, 0);
+    nRead += CountZones(reader->GetOutput());
+  }
+  vtk_assert(nRead == nZones);
+  return 0;
+}
+
 int TestReadCGNSSolution(int argc, char* argv[])
 {
   if (argc < 3) return 0; // for some reason two tests are run, one without data file on cmd line
@@ -76,6 +109,11 @@ int TestReadCGNSSolution(int argc, char* argv[])
   if (0 != TestOutputData(mb, 19742, 20))
     return 1;
 
+  int nZones = CountZones(mb);
+  if (0 != TestPieces(solution, nZones, 2) ||
+      0 != TestPieces(solution, nZones, nZones + 1))
+    return 1;
+
   cout << __FILE__ << " tests passed." << endl;
   return 0;
 }
@@ -695,4 +695,101 @@ int readZoneInfo(int cgioNum, double nodeId,
     }
   return 0;
 }
+
+//------------------------------------------------------------------------------
+int readZoneCoreInfo(int cgioNum, double zoneId, int cellDim,
+                     CGNSRead::ZoneInformation& zoneInfo)
+{
+  CGNSRead::char_33 dataType;
+
+  memset(zoneInfo.name, 0, 33);
+  for (int n = 0; n < 9; ++n)
+    {
+    zoneInfo.size[n] = 0;
+    }
+  zoneInfo.nCells = 0;
+  zoneInfo.family.clear();
+
+  if (cgio_get_name(cgioNum, zoneId, zoneInfo.name) != CG_OK)
+    {
+    std::cerr << "cgio_get_name" << std::endl;
+    return 1;
+    }
+
+  if (cgio_get_data_type(cgioNum, zoneId, dataType) != CG_OK)
+    {
+    return 1;
+    }
+
+  if (strcmp(dataType, "I4") == 0)
+    {
+    std::vector<int> mdata;
+    CGNSRead::readNodeData<int>(cgioNum, zoneId, mdata);
+    for (std::size_t index = 0; index < mdata.size() && index < 9; index++)
+      {
+      zoneInfo.size[index] = static_cast<vtkIdType>(mdata[index]);
+      }
+    }
+  else if (strcmp(dataType, "I8") == 0)
+    {
+    std::vector<cglong_t> mdata;
+    CGNSRead::readNodeData<cglong_t>(cgioNum, zoneId, mdata);
+    for (std::size_t index = 0; index < mdata.size() && index < 9; index++)
+      {
+      zoneInfo.size[index] = static_cast<vtkIdType>(mdata[index]);
+      }
+    }
+  else
+    {
+    std::cerr << "Unexpected data type for dimension data of zone "
+              << zoneInfo.name << std::endl;
+    return 1;
+    }
+
+  double famId;
+  if (CGNSRead::getFirstNodeId(cgioNum, zoneId, "FamilyName_t",
+                               &famId) == CG_OK)
+    {
+    CGNSRead::readNodeStringData(cgioNum, famId, zoneInfo.family);
+    cgio_release_id(cgioNum, famId);
+    }
+
+  // zones without ZoneType_t node are read as structured zones
+  zoneInfo.zoneType = CGNS_ENUMV(Structured);
+  double zoneTypeId;
+  if (CGNSRead::getFirstNodeId(cgioNum, zoneId, "ZoneType_t",
+                               &zoneTypeId) == CG_OK)
+    {
+    std::string zoneType;
+    CGNSRead::readNodeStringData(cgioNum, zoneTypeId, zoneType);
+    cgio_release_id(cgioNum, zoneTypeId);
+
+    if (zoneType == "Unstructured")
+      {
+      zoneInfo.zoneType = CGNS_ENUMV(Unstructured);
+      }
+    else if (zoneType == "Null")
+      {
+      zoneInfo.zoneType = CGNS_ENUMV(ZoneTypeNull);
+      }
+    else if (zoneType == "UserDefined")
+      {
+      zoneInfo.zoneType = CGNS_ENUMV(ZoneTypeUserDefined);
+      }
+    }
+
+  if (zoneInfo.zoneType == CGNS_ENUMV(Structured))
+    {
+    zoneInfo.nCells = 1;
+    for (int n = 0; n < cellDim; ++n)
+      {
+      zoneInfo.nCells *= zoneInfo.size[cellDim + n];
+      }
+    }
+  else if (zoneInfo.zoneType == CGNS_ENUMV(Unstructured))
+    {
+    zoneInfo.nCells = zoneInfo.size[1];
+    }
+  return 0;
+}
 }
@@ -112,5 +112,9 @@ int readBaseReferenceState(int cgioNum, double nodeId, CGNSRead::BaseInformation
 //------------------------------------------------------------------------------
 int readZoneInfo(int cgioNum, double nodeId, CGNSRead::BaseInformation& baseInfo);
 
+//------------------------------------------------------------------------------
+int readZoneCoreInfo(int cgioNum, double zoneId, int cellDim,
+                     CGNSRead::ZoneInformation& zoneInfo);
+
 }
 #endif //cgio_helpers_h
@@ -63,18 +63,25 @@ vtkStandardNewMacro ( vtkCGNSReader );
 
 namespace
 {
-  struct duo_t
+  // A zone and its number of cells, ordered by decreasing number of cells.
+  struct ZoneWeight
   {
-    duo_t()
+    vtkIdType nCells;
+    int base;
+    int zone;
+
+    bool operator<(const ZoneWeight& other) const
     {
-      pair[0] = 0;
-      pair[1] = 0;
+      if (this->nCells != other.nCells)
+        {
+        return this->nCells > other.nCells;
+        }
+      if (this->base != other.base)
+        {
+        return this->base < other.base;
+        }
+      return this->zone < other.zone;
     }
-
-    int& operator[](std::size_t n) { return pair[n]; }
-    const int& operator[](std::size_t n) const { return pair[n]; }
-    private:
-      int pair[2];
   };
 
   class SectionInformation
@@ -127,6 +134,10 @@ public:
     vtkCGNSReader* self);
 
   static int AttachReferenceValue(const int base, vtkDataSet* ds, vtkCGNSReader* self);
+
+  static void AssignZones(const int piece, const int numPieces,
+    std::vector< std::vector<int> >& baseToZones,
+    vtkCGNSReader* self);
 };
 
 //----------------------------------------------------------------------------
@@ -233,6 +244,59 @@ bool vtkCGNSReader::vtkPrivate::IsVarEnabled(
   return (DataSelection->ArrayIsEnabled(name) != 0);
 }
 
+//------------------------------------------------------------------------------
+// Balance the zones of the selected bases between the pieces by number of
+// cells: the largest zones go first, each one to the least loaded piece.
+// Every process computes the same assignment from the broadcast metadata and
+// keeps the zones of its piece, in file order.
+void vtkCGNSReader::vtkPrivate::AssignZones(const int piece,
+  const int numPieces, std::vector< std::vector<int> >& baseToZones,
+  vtkCGNSReader* self)
+{
+  int numBases = self->Internal->GetNumberOfBaseNodes();
+  baseToZones.clear();
+  baseToZones.resize(numBases);
+
+  std::vector<ZoneWeight> weights;
+  for (int bb = 0; bb < numBases; ++bb)
+    {
+    const CGNSRead::BaseInformation& baseInfo = self->Internal->GetBase(bb);
+    if (self->BaseSelection->ArrayIsEnabled(baseInfo.name) == 0)
+      {
+      continue;
+      }
+    for (std::size_t zz = 0; zz < baseInfo.zones.size(); ++zz)
+      {
+      ZoneWeight weight;
+      // empty zones still cost a few reads
+      weight.nCells = std::max(baseInfo.zones[zz].nCells,
+                               static_cast<vtkIdType>(1));
+      weight.base = bb;
+      weight.zone = static_cast<int>(zz);
+      weights.push_back(weight);
+      }
+    }
+  std::sort(weights.begin(), weights.end());
+
+  std::vector<vtkIdType> loads(std::max(numPieces, 1), 0);
+  for (std::vector<ZoneWeight>::const_iterator iter = weights.begin();
+       iter != weights.end(); ++iter)
+    {
+    std::vector<vtkIdType>::iterator least =
+      std::min_element(loads.begin(), loads.end());
+    *least += iter->nCells;
+    if (static_cast<int>(least - loads.begin()) == piece)
+      {
+      baseToZones[iter->base].push_back(iter->zone);
+      }
+    }
+
+  for (int bb = 0; bb < numBases; ++bb)
+    {
+    std::sort(baseToZones[bb].begin(), baseToZones[bb].end());
+    }
+}
+
 //------------------------------------------------------------------------------
 int vtkCGNSReader::vtkPrivate::getGridAndSolutionName(
   const int base,
@@ -2438,7 +2502,6 @@ int vtkCGNSReader::RequestData(vtkInformation *vtkNotUsed(request),
 
   int processNumber;
   int numProcessors;
-  int startRange, endRange;
 
   vtkInformation* outInfo = outputVector->GetInformationObject(0);
   // get the output
@@ -2452,67 +2515,6 @@ int vtkCGNSReader::RequestData(vtkInformation *vtkNotUsed(request),
   numProcessors =
       outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_NUMBER_OF_PIECES());
 
-  int numBases = this->Internal->GetNumberOfBaseNodes();
-  int numZones = 0;
-  for (int bb=0; bb < numBases; bb++)
-    {
-    numZones += this->Internal->GetBase(bb).nzones;
-    }
-
-  // Divide the files evenly between processors
-  int num_zones_per_process = numZones / numProcessors;
-
-  // This if/else logic is for when you don't have a nice even division of files
-  // Each process computes which sequence of files it needs to read in
-  int left_over_zones = numZones - (num_zones_per_process*numProcessors);
-  // base --> startZone,endZone
-  std::map<int, duo_t> baseToZoneRange;
-
-  // REDO this part !!!!
-  if (processNumber < left_over_zones)
-    {
-    int accumulated = 0;
-    startRange = (num_zones_per_process+1)*processNumber;
-    endRange = startRange + (num_zones_per_process+1);
-    for (int bb = 0; bb < numBases; bb++)
-      {
-      duo_t zoneRange;
-      startRange = startRange - accumulated;
-      endRange = endRange - accumulated;
-      int startInterZone = std::max(startRange, 0);
-      int endInterZone = std::min(endRange, this->Internal->GetBase(bb).nzones);
-
-      if ((endInterZone - startInterZone) > 0)
-        {
-        zoneRange[0] = startInterZone;
-        zoneRange[1] = endInterZone;
-        }
-      accumulated = this->Internal->GetBase(bb).nzones;
-      baseToZoneRange[bb] = zoneRange;
-      }
-    }
-  else
-    {
-    int accumulated = 0;
-    startRange = num_zones_per_process * processNumber + left_over_zones;
-    endRange = startRange + num_zones_per_process;
-    for (int bb = 0; bb < numBases; bb++)
-      {
-      duo_t zoneRange;
-      startRange = startRange - accumulated;
-      endRange = endRange  - accumulated;
-      int startInterZone = std::max(startRange, 0);
-      int endInterZone = std::min(endRange, this->Internal->GetBase(bb).nzones);
-      if ((endInterZone - startInterZone) > 0)
-        {
-        zoneRange[0] = startInterZone;
-        zoneRange[1] = endInterZone;
-        }
-      accumulated = this->Internal->GetBase(bb).nzones;
-      baseToZoneRange[bb] = zoneRange;
-      }
-    }
-
   //Bnd Sections Not implemented yet for parallel
   if (numProcessors > 1)
     {
@@ -2520,11 +2522,17 @@ int vtkCGNSReader::RequestData(vtkInformation *vtkNotUsed(request),
     this->CreateEachSolutionAsBlock = 0;
     }
 
+  // The metadata is parsed once per file, and broadcast by
+  // RequestInformation, so this is a no-op for the following time steps.
   if (!this->Internal->Parse(this->FileName))
     {
     return 0;
     }
 
+  // base --> zones of this piece
+  std::vector< std::vector<int> > baseToZones;
+  vtkPrivate::AssignZones(processNumber, numProcessors, baseToZones, this);
+
   vtkMultiBlockDataSet* rootNode = output;
 
   vtkDebugMacro(<< "Start Loading CGNS data");
@@ -2672,127 +2680,40 @@ int vtkCGNSReader::RequestData(vtkInformation *vtkNotUsed(request),
       mbase->SetNumberOfBlocks(nzones);
       }
 
-    std::vector<double> baseChildId;
-    CGNSRead::getNodeChildrenId(this->cgioNum, baseIds[numBase], baseChildId);
-
-    std::size_t nz;
-    std::size_t nn;
-    CGNSRead::char_33 nodeLabel;
-    for (nz = 0, nn = 0; nn < baseChildId.size(); ++nn)
-      {
-      if (cgio_get_label(this->cgioNum, baseChildId[nn], nodeLabel) != CG_OK)
-        {
-        return false;
-        }
-
-      if (strcmp(nodeLabel, "Zone_t") == 0)
-        {
-        if (nz < nn)
-          {
-          baseChildId[nz] = baseChildId[nn];
-          }
-        nz++;
-        }
-      else
-        {
-        cgio_release_id(this->cgioNum, baseChildId[nn]);
-        }
-      }
-
-    int zonemin = baseToZoneRange[numBase][0];
-    int zonemax = baseToZoneRange[numBase][1];
-    for (int zone = zonemin; zone < zonemax; ++zone)
+    // Zones are looked up by name from the cached metadata, rather than
+    // by listing the children of the base, which may be many.
+    const std::vector<int>& zones = baseToZones[numBase];
+    for (std::size_t zz = 0; zz < zones.size(); ++zz)
       {
-      CGNSRead::char_33 zoneName;
+      const int zone = zones[zz];
+      const CGNSRead::ZoneInformation& zoneInfo = curBaseInfo.zones[zone];
       cgsize_t zsize[9];
-      CGNS_ENUMT(ZoneType_t) zt = CGNS_ENUMV(ZoneTypeNull);
-      memset(zoneName, 0, 33);
-      memset(zsize, 0, 9*sizeof(cgsize_t));
-
-      if (cgio_get_name(this->cgioNum, baseChildId[zone], zoneName) != CG_OK)
+      CGNS_ENUMT(ZoneType_t) zt = zoneInfo.zoneType;
+      for (int n = 0; n < 9; ++n)
         {
-        char errmsg[CGIO_MAX_ERROR_LENGTH+1];
-        cgio_error_message(errmsg);
-        vtkErrorMacro(<< "Problem while reading name of zone number " << zone << ", error : " << errmsg);
-        return 1;
+        zsize[n] = static_cast<cgsize_t>(zoneInfo.size[n]);
         }
 
-      CGNSRead::char_33 dataType;
-      if (cgio_get_data_type(this->cgioNum, baseChildId[zone],
-                             dataType) != CG_OK)
+      double zoneId;
+      if (cgio_get_node_id(this->cgioNum, baseIds[numBase], zoneInfo.name,
+                           &zoneId) != CG_OK)
         {
         char errmsg[CGIO_MAX_ERROR_LENGTH+1];
         cgio_error_message(errmsg);
-        vtkErrorMacro(<< "Problem while reading data_type of zone number "<< zone << " "<< errmsg);
-        return 1;
-        }
-
-      if (strcmp(dataType, "I4") == 0)
-        {
-        std::vector<int> mdata;
-        CGNSRead::readNodeData<int>(this->cgioNum, baseChildId[zone], mdata);
-        for (std::size_t index = 0; index < mdata.size(); index++)
-          {
-          zsize[index] = static_cast<cgsize_t>(mdata[index]);
-          }
-        }
-      else if (strcmp(dataType, "I8") == 0)
-        {
-        std::vector<cglong_t> mdata;
-        CGNSRead::readNodeData<cglong_t>(this->cgioNum, baseChildId[zone], mdata);
-        for (std::size_t index=0; index < mdata.size(); index++)
-          {
-          zsize[index] = static_cast<cgsize_t>(mdata[index]);
-          }
-        }
-      else
-        {
-        vtkErrorMacro(<< "Problem while reading dimension in zone number " << zone);
+        vtkErrorMacro(<< "Problem while reading zone " << zoneInfo.name << ", error : " << errmsg);
         return 1;
         }
 
+      mbase->GetMetaData(zone)->Set(vtkCompositeDataSet::NAME(), zoneInfo.name);
 
-      mbase->GetMetaData(zone)->Set(vtkCompositeDataSet::NAME(), zoneName);
-
-      double famId;
-      if (CGNSRead::getFirstNodeId(this->cgioNum,
-                                   baseChildId[zone], "FamilyName_t", &famId) == CG_OK)
+      if (!zoneInfo.family.empty())
         {
-        std::string familyName;
-        CGNSRead::readNodeStringData(this->cgioNum, famId, familyName);
-
         vtkInformationStringKey* zonefamily =
             new vtkInformationStringKey("FAMILY","vtkCompositeDataSet");
-        mbase->GetMetaData(zone)->Set(zonefamily, familyName.c_str());
+        mbase->GetMetaData(zone)->Set(zonefamily, zoneInfo.family.c_str());
         }
 
-      this->currentId = baseChildId[zone];
-
-      double zoneTypeId;
-      zt = CGNS_ENUMV(Structured);
-      if (CGNSRead::getFirstNodeId(this->cgioNum,
-                                   baseChildId[zone], "ZoneType_t", &zoneTypeId) == CG_OK)
-        {
-        std::string zoneType;
-        CGNSRead::readNodeStringData(this->cgioNum, zoneTypeId, zoneType);
-
-        if (zoneType == "Structured")
-          {
-          zt = CGNS_ENUMV(Structured);
-          }
-        else if (zoneType == "Unstructured")
-          {
-          zt = CGNS_ENUMV(Unstructured);
-          }
-        else if (zoneType == "Null")
-          {
-          zt = CGNS_ENUMV(ZoneTypeNull);
-          }
-        else if (zoneType == "UserDefined")
-          {
-          zt = CGNS_ENUMV(ZoneTypeUserDefined);
-          }
-        }
+      this->currentId = zoneId;
 
       switch (zt)
         {
@@ -2820,6 +2741,7 @@ int vtkCGNSReader::RequestData(vtkInformation *vtkNotUsed(request),
             }
           break;
         }
+      cgio_release_id(this->cgioNum, zoneId);
       this->UpdateProgress(0.5);
       }
     rootNode->SetBlock(blockIndex, mbase);
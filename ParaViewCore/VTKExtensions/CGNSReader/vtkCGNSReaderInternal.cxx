@@ -18,6 +18,7 @@
 
 #include <algorithm>
 #include "vtkCellType.h"
+#include "vtkNew.h"
 #include "cgio_helpers.h"
 
 namespace CGNSRead
@@ -689,6 +690,20 @@ bool vtkCGNSMetaData::Parse(const char* cgnsFileName)
       }
     this->baseList[numBase].nzones = static_cast<int>(nzones);
 
+    // zone names and sizes, to balance and read the zones
+    // without parsing the base again
+    this->baseList[numBase].zones.resize(nzones);
+    for (nn = 0; nn < nzones; ++nn)
+      {
+      if (readZoneCoreInfo(cgioNum, baseChildId[nn],
+                           this->baseList[numBase].cellDim,
+                           this->baseList[numBase].zones[nn]) != 0)
+        {
+        cgio_close_file(cgioNum);
+        return false;
+        }
+      }
+
     if (this->baseList[numBase].times.size() < 1)
       {
       // If no time information were found
@@ -704,6 +719,10 @@ bool vtkCGNSMetaData::Parse(const char* cgnsFileName)
       // variable name and more, based on first zone only
       readZoneInfo(cgioNum, baseChildId[0], this->baseList[numBase]);
       }
+    for (nn = 0; nn < nzones; ++nn)
+      {
+      cgio_release_id(cgioNum, baseChildId[nn]);
+      }
 
     }
 
@@ -755,6 +774,12 @@ void vtkCGNSMetaData::PrintSelf(std::ostream& os)
     {
     os << "  Base name: "  << this->baseList[b].name << std::endl ;
     os << "    number of zones: " << this->baseList[b].nzones << std::endl;
+    for (std::size_t z=0; z < this->baseList[b].zones.size(); z++)
+      {
+      os << "      Zone: " << this->baseList[b].zones[z].name
+         << " number of cells: " << this->baseList[b].zones[z].nCells
+         << std::endl;
+      }
     os << "    number of time steps: "<< this->baseList[b].times.size()
        << std::endl;
     os << "    use unsteady grid: "<< this->baseList[b].useGridPointers
@@ -968,6 +993,75 @@ static void BroadcastFamilies(vtkMultiProcessController* controller,
     }
 }
 
+//------------------------------------------------------------------------------
+static void BroadcastZones(vtkMultiProcessController* controller,
+                           std::vector<CGNSRead::ZoneInformation>& zoneInfo,
+                           int rank)
+{
+  unsigned long len = static_cast<unsigned long>(zoneInfo.size());
+  controller->Broadcast(&len, 1, 0);
+  if (rank != 0)
+    {
+    zoneInfo.resize(len);
+    }
+  if (len == 0)
+    {
+    return;
+    }
+
+  // Pack all zones of the base in a few messages, there may be
+  // thousands of them: names and families are '\0' separated,
+  // zone type, number of cells and sizes are 11 components tuples.
+  std::vector<char> names;
+  vtkNew<vtkIdTypeArray> sizes;
+  sizes->SetNumberOfComponents(11);
+  if (rank == 0)
+    {
+    sizes->SetNumberOfTuples(static_cast<vtkIdType>(len));
+    for (unsigned long i = 0; i < len; ++i)
+      {
+      const CGNSRead::ZoneInformation& zone = zoneInfo[i];
+      names.insert(names.end(), zone.name, zone.name + strlen(zone.name) + 1);
+      names.insert(names.end(), zone.family.c_str(),
+                   zone.family.c_str() + zone.family.size() + 1);
+      vtkIdType* tuple = sizes->GetPointer(11 * static_cast<vtkIdType>(i));
+      tuple[0] = static_cast<vtkIdType>(zone.zoneType);
+      tuple[1] = zone.nCells;
+      for (int n = 0; n < 9; ++n)
+        {
+        tuple[2 + n] = zone.size[n];
+        }
+      }
+    }
+
+  unsigned long namesLen = static_cast<unsigned long>(names.size());
+  controller->Broadcast(&namesLen, 1, 0);
+  names.resize(namesLen);
+  controller->Broadcast(&names[0], namesLen, 0);
+  controller->Broadcast(sizes.GetPointer(), 0);
+
+  if (rank != 0)
+    {
+    const char* name = &names[0];
+    for (unsigned long i = 0; i < len; ++i)
+      {
+      CGNSRead::ZoneInformation& zone = zoneInfo[i];
+      memset(zone.name, 0, 33);
+      strncpy(zone.name, name, 32);
+      name += strlen(name) + 1;
+      zone.family = name;
+      name += zone.family.size() + 1;
+      vtkIdType* tuple = sizes->GetPointer(11 * static_cast<vtkIdType>(i));
+      zone.zoneType = static_cast<CGNS_ENUMT(ZoneType_t)>(tuple[0]);
+      zone.nCells = tuple[1];
+      for (int n = 0; n < 9; ++n)
+        {
+        zone.size[n] = tuple[2 + n];
+        }
+      }
+    }
+}
+
 //------------------------------------------------------------------------------
 void vtkCGNSMetaData::Broadcast(vtkMultiProcessController* controller,
                                 int rank)
@@ -986,6 +1080,7 @@ void vtkCGNSMetaData::Broadcast(vtkMultiProcessController* controller,
     controller->Broadcast(&ite->physicalDim, 1, 0);
     controller->Broadcast(&ite->baseNumber, 1, 0);
     controller->Broadcast(&ite->nzones, 1, 0);
+    CGNSRead::BroadcastZones(controller, ite->zones, rank);
 
     int flags = 0;
     if (rank == 0)
@@ -171,6 +171,12 @@ class ZoneInformation
 {
 public :
   char_33 name;
+  CGNS_ENUMT(ZoneType_t) zoneType;
+  // vertex, cell and boundary vertex sizes of the zone
+  vtkIdType size[9];
+  // number of cells, used to balance the zones between pieces
+  vtkIdType nCells;
+  std::string family;
 };
 
 //------------------------------------------------------------------------------
@@ -222,7 +228,9 @@ public:
 
   int nzones;
 
-  //std::vector<CGNSRead::zone> zone;
+  // zone names, types and sizes, read once to avoid walking
+  // the zone nodes again for each time step
+  std::vector<CGNSRead::ZoneInformation> zones;
   vtkCGNSArraySelection PointDataArraySelection;
   vtkCGNSArraySelection CellDataArraySelection;
 };
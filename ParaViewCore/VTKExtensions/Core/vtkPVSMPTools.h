@@ -0,0 +1,111 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    vtkPVSMPTools.h
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkPVSMPTools - vtkSMPTools::For with a per-call number of threads.
+// .SECTION Description
+// vtkSMPTools::Initialize() sets the number of threads of the whole process,
+// and only the first call takes effect with some backends (e.g. TBB), so it
+// cannot be used by filters exposing their own number of threads.
+// vtkPVSMPTools::For() instead runs at most the requested number of slots
+// through vtkSMPTools::For(), each slot applying the functor to grains of the
+// range taken from a shared counter until none are left. The grains are thus
+// balanced over the threads, and no more than that many threads work on the
+// range at a time.
+//
+// Usage:
+// \code
+// vtkPVSMPTools::For(this->NumberOfThreads, 0, n, grain, functor);
+// \endcode
+// where functor has an operator()(vtkIdType begin, vtkIdType end).
+
+#ifndef vtkPVSMPTools_h
+#define vtkPVSMPTools_h
+
+#include "vtkAtomicInt.h" // for vtkAtomicInt
+#include "vtkSMPTools.h" // for vtkSMPTools
+#include "vtkType.h" // for vtkIdType
+
+class vtkPVSMPTools
+{
+public:
+  // Description:
+  // Applies the functor to [first, last) with numberOfThreads threads. 1
+  // applies it to the whole range on the calling thread, 0 (or less) calls
+  // vtkSMPTools::For() with the default number of threads, and larger values
+  // use at most that many threads of vtkSMPTools for this call only. A grain
+  // of 0 lets the range be split automatically.
+  template <class Functor>
+  static void For(int numberOfThreads, vtkIdType first, vtkIdType last,
+    vtkIdType grain, Functor& f)
+    {
+    vtkIdType n = last - first;
+    if (n <= 0)
+      {
+      return;
+      }
+    if (numberOfThreads == 1)
+      {
+      f(first, last);
+      }
+    else if (numberOfThreads <= 0)
+      {
+      vtkSMPTools::For(first, last, grain, f);
+      }
+    else
+      {
+      if (grain <= 0)
+        {
+        grain = n / (4 * static_cast<vtkIdType>(numberOfThreads));
+        grain = grain < 1 ? 1 : grain;
+        }
+      Slots<Functor> slots(first, last, grain, f);
+      vtkSMPTools::For(0, numberOfThreads, 1, slots);
+      }
+    }
+
+private:
+  // vtkSMPTools functor run once per slot.
+  template <class Functor>
+  class Slots
+  {
+  public:
+    Slots(vtkIdType first, vtkIdType last, vtkIdType grain, Functor& f)
+      : Last(last), Grain(grain), F(f)
+      {
+      this->Next = first;
+      }
+
+    void operator()(vtkIdType slotBegin, vtkIdType slotEnd)
+      {
+      for (vtkIdType slot = slotBegin; slot < slotEnd; ++slot)
+        {
+        vtkIdType begin;
+        while ((begin = (this->Next += this->Grain) - this->Grain) < this->Last)
+          {
+          vtkIdType end = begin + this->Grain;
+          this->F(begin, end < this->Last ? end : this->Last);
+          }
+        }
+      }
+
+  private:
+    vtkAtomicInt<vtkIdType> Next;
+    vtkIdType Last;
+    vtkIdType Grain;
+    Functor& F;
+  };
+};
+
+#endif
+// VTK-HeaderTest-Exclude: vtkPVSMPTools.h
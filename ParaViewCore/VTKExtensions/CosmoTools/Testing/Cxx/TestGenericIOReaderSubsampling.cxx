@@ -0,0 +1,117 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestGenericIOReaderSubsampling.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+#include <mpi.h>
+
+#include "vtkMPIController.h"
+#include "vtkNew.h"
+#include "vtkPGenericIOReader.h"
+#include "vtkPointData.h"
+#include "vtkTestUtilities.h"
+#include "vtkUnstructuredGrid.h"
+
+namespace {
+vtkIdType readNumberOfPoints(vtkPGenericIOReader* reader)
+{
+  reader->Modified();
+  reader->Update();
+  vtkUnstructuredGrid* output = reader->GetOutput();
+  if (!output->GetPointData()->HasArray("vx"))
+    {
+    std::cerr << "Point data does not have array: vx" << std::endl;
+    return -1;
+    }
+  return output->GetNumberOfPoints();
+}
+
+int runSubsamplingTest(int argc, char* argv[])
+{
+  char* fname =
+  vtkTestUtilities::ExpandDataFileName(argc,argv,"genericio/m000.499.allparticles");
+
+  vtkNew< vtkPGenericIOReader > reader;
+  reader->SetFileName(fname);
+  reader->UpdateInformation();
+  reader->SetXAxisVariableName("x");
+  reader->SetYAxisVariableName("y");
+  reader->SetZAxisVariableName("z");
+  reader->SetPointArrayStatus("vx",1);
+  delete [] fname;
+
+  vtkIdType all = readNumberOfPoints(reader.GetPointer());
+  if (all <= 0)
+    {
+    std::cerr << "Error at line: " << __LINE__ << std::endl;
+    return 0;
+    }
+
+  // a region of interest containing everything must not drop any particle
+  double bounds[6];
+  reader->GetOutput()->GetBounds(bounds);
+  reader->SetRegionOfInterest(bounds);
+  reader->UseRegionOfInterestOn();
+  if (readNumberOfPoints(reader.GetPointer()) != all)
+    {
+    std::cerr << "Error at line: " << __LINE__ << std::endl;
+    return 0;
+    }
+  reader->UseRegionOfInterestOff();
+
+  // keeping every other particle should roughly halve the output
+  reader->SetSubsamplingStrategy(vtkPGenericIOReader::SUBSAMPLE_STRIDE);
+  reader->SetSubsamplingFraction(0.5);
+  vtkIdType stride = readNumberOfPoints(reader.GetPointer());
+  if (stride < all / 2 || stride > all / 2 + 1024)
+    {
+    std::cerr << "Error at line: " << __LINE__ << " got " << stride
+              << " out of " << all << " particles" << std::endl;
+    return 0;
+    }
+
+  // random subsampling must be reproducible
+  reader->SetSubsamplingStrategy(vtkPGenericIOReader::SUBSAMPLE_RANDOM);
+  reader->SetSubsamplingFraction(0.25);
+  vtkIdType random1 = readNumberOfPoints(reader.GetPointer());
+  vtkIdType random2 = readNumberOfPoints(reader.GetPointer());
+  if (random1 <= 0 || random1 >= all || random1 != random2)
+    {
+    std::cerr << "Error at line: " << __LINE__ << std::endl;
+    return 0;
+    }
+
+  // back to the full dataset
+  reader->SetSubsamplingStrategy(vtkPGenericIOReader::SUBSAMPLE_NONE);
+  if (readNumberOfPoints(reader.GetPointer()) != all)
+    {
+    std::cerr << "Error at line: " << __LINE__ << std::endl;
+    return 0;
+    }
+  return 1;
+}
+}
+
+int TestGenericIOReaderSubsampling(int argc, char* argv[])
+{
+  MPI_Init(&argc,&argv);
+
+  vtkNew< vtkMPIController > controller;
+  controller->Initialize();
+  vtkMultiProcessController::SetGlobalController(controller.GetPointer());
+
+  int retVal = runSubsamplingTest(argc,argv);
+
+  controller->Finalize();
+  return !retVal;
+}
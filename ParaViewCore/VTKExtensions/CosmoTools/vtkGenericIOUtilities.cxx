@@ -155,6 +155,28 @@ double GetDoubleFromRawBuffer(
   return( dataItem );
 }
 
+//==============================================================================
+size_t GetSizeOfType(const int type)
+{
+  switch( type )
+    {
+    case gio::GENERIC_IO_INT32_TYPE:
+      return( sizeof(int32_t) );
+    case gio::GENERIC_IO_INT64_TYPE:
+      return( sizeof(int64_t) );
+    case gio::GENERIC_IO_UINT32_TYPE:
+      return( sizeof(uint32_t) );
+    case gio::GENERIC_IO_UINT64_TYPE:
+      return( sizeof(uint64_t) );
+    case gio::GENERIC_IO_DOUBLE_TYPE:
+      return( sizeof(double) );
+    case gio::GENERIC_IO_FLOAT_TYPE:
+      return( sizeof(float) );
+    default:
+      return( 0 );
+    } // END switch
+}
+
 //==============================================================================
 vtkIdType GetIdFromRawBuffer(
       const int type, void* buffer, vtkIdType buffer_idx)
@@ -94,6 +94,12 @@ vtkIdType GetIdFromRawBuffer(
 double GetDoubleFromRawBuffer(
       const int type, void* buffer, vtkIdType buffer_idx);
 
+//==============================================================================
+// Description:
+// Returns the size in bytes of a single value of the given GenericIO type,
+// or 0 if the type is unknown.
+size_t GetSizeOfType(const int type);
+
 //==============================================================================
 // Description:
 // This method constructs and returns the underlying GenericIO reader.
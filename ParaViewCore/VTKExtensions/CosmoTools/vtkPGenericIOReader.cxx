@@ -53,13 +53,25 @@
 #include <algorithm>
 #include <cassert>
 #include <cctype>
+#include <cstring>
 #include <set>
+#include <sstream>
 #include <stdexcept>
 #include <vector>
 
 // Uncomment the line below to get debugging information
 //#define DEBUG
 
+//------------------------------------------------------------------------------
+struct vtkGenericIOBlockInfo
+{
+  int GlobalId;
+  vtkIdType NumberOfElements;
+  bool HasBounds;
+  double Bounds[6];
+  uint64_t Coords[3];
+};
+
 //------------------------------------------------------------------------------
 class vtkGenericIOMetaData
 {
@@ -73,6 +85,19 @@ public:
   MPI_Comm MPICommunicator;
   std::set< int > RanksToLoad;
 
+  // Local blocks, in block header order.
+  std::vector< vtkGenericIOBlockInfo > Blocks;
+
+  // Indices in Blocks of the blocks selected for reading and, for each of
+  // them, the (sorted) indices of the particles to keep within the block.
+  // An empty particle list means that every particle of the block is kept.
+  std::vector< int > SelectedBlocks;
+  std::vector< std::vector< vtkIdType > > SelectedParticles;
+
+  // Describes what is currently held in the RawCache, so that the cache is
+  // released when the region of interest or the subsampling changes.
+  std::string RawCacheKey;
+
   /**
    * @brief Metadata constructor.
    */
@@ -134,23 +159,52 @@ public:
   return( status );
   }
 
+  /**
+   * @brief Returns the number of particles kept from the given selected block.
+   * @param i the index of the block in SelectedBlocks.
+   * @return the number of particles to read from that block.
+   */
+  vtkIdType GetNumberOfSelectedParticles(const int i)
+  {
+  assert("pre: selected block index is out-of-bounds!" &&
+         (i >= 0) && (i < static_cast<int>(this->SelectedBlocks.size())) );
+  if(this->SelectedParticles[i].empty())
+    {
+    return( this->Blocks[ this->SelectedBlocks[i] ].NumberOfElements );
+    }
+  return( static_cast<vtkIdType>(this->SelectedParticles[i].size()) );
+  }
+
+  /**
+   * @brief Releases the raw buffers of all variables, but keeps the variables.
+   */
+  void ReleaseRawCache()
+  {
+  std::map<std::string,void*>::iterator iter;
+  for( iter=this->RawCache.begin(); iter != this->RawCache.end(); ++iter)
+    {
+    delete [] static_cast<char*>( iter->second );
+    iter->second = NULL;
+    this->VariableStatus[ iter->first ] = false;
+    } // END for
+  this->RawCacheKey.clear();
+  }
+
   /**
    * @brief Clears the metadata
    */
   void Clear()
   {
+  this->ReleaseRawCache();
   this->NumberOfElements = 0;
   this->VariableGenericIOType.clear();
   this->VariableStatus.clear();
   this->Information.clear();
   this->RanksToLoad.clear();
-
-  std::map<std::string,void*>::iterator iter;
-  for( iter=this->RawCache.begin(); iter != this->RawCache.end(); ++iter)
-    {
-    delete [] static_cast<char*>( iter->second );
-    } // END for
   this->RawCache.clear();
+  this->Blocks.clear();
+  this->SelectedBlocks.clear();
+  this->SelectedParticles.clear();
   }
 
 };
@@ -176,6 +230,16 @@ vtkPGenericIOReader::vtkPGenericIOReader()
   this->BuildMetaData     = false;
   this->AppendBlockCoordinates = true;
 
+  this->UseRegionOfInterest = false;
+  for(int i=0; i < 3; ++i)
+    {
+    this->RegionOfInterest[2*i]   = VTK_DOUBLE_MIN;
+    this->RegionOfInterest[2*i+1] = VTK_DOUBLE_MAX;
+    }
+  this->SubsamplingStrategy = SUBSAMPLE_NONE;
+  this->SubsamplingFraction = 1.0;
+  this->SubsamplingSeed     = 0;
+
   this->MetaData  = new vtkGenericIOMetaData();
   this->MetaData->InitCommunicator( this->Controller );
 
@@ -236,6 +300,14 @@ void vtkPGenericIOReader::PrintSelf(std::ostream &os, vtkIndent indent)
   os << indent << "z-axis: " << this->ZAxisVariableName << endl;
   os << indent << "GenericIOType: " << this->GenericIOType << endl;
   os << indent << "BlockAssignment: " << this->BlockAssignment << endl;
+  os << indent << "UseRegionOfInterest: " << this->UseRegionOfInterest << endl;
+  os << indent << "RegionOfInterest: ("
+     << this->RegionOfInterest[0] << ", " << this->RegionOfInterest[1] << ", "
+     << this->RegionOfInterest[2] << ", " << this->RegionOfInterest[3] << ", "
+     << this->RegionOfInterest[4] << ", " << this->RegionOfInterest[5] << ")\n";
+  os << indent << "SubsamplingStrategy: " << this->SubsamplingStrategy << endl;
+  os << indent << "SubsamplingFraction: " << this->SubsamplingFraction << endl;
+  os << indent << "SubsamplingSeed: " << this->SubsamplingSeed << endl;
   os << indent << "ArrayList: " << endl;
   this->ArrayList->PrintSelf(os,indent.GetNextIndent());
   os << indent << "PointDataSelection: " << endl;
@@ -499,6 +571,38 @@ void vtkPGenericIOReader::LoadMetaData()
       }
     } // END for all variables in the file
 
+  // Gather the per-block metadata used to select the blocks to read
+  bool decomposed = this->Reader->IsSpatiallyDecomposed();
+  this->MetaData->Blocks.resize(this->Reader->GetNumberOfBlockHeaders());
+  for(int i=0; i < this->Reader->GetNumberOfBlockHeaders(); ++i)
+    {
+    vtkGenericIOBlockInfo& block = this->MetaData->Blocks[i];
+    gio::RankHeader header = this->Reader->GetBlockHeader(i);
+    block.GlobalId         = static_cast<int>(header.GlobalRank);
+    block.NumberOfElements = static_cast<vtkIdType>(header.NElems);
+    block.HasBounds        = decomposed;
+    if( decomposed )
+      {
+      double min[3];
+      double max[3];
+      this->Reader->GetBlockBounds(i,min,max);
+      this->Reader->GetBlockCoords(i,block.Coords);
+      for(int dim=0; dim < 3; ++dim)
+        {
+        block.Bounds[2*dim]   = min[dim];
+        block.Bounds[2*dim+1] = max[dim];
+        }
+      }
+    else
+      {
+      for(int j=0; j < 6; ++j)
+        {
+        block.Bounds[j] = 0.0;
+        }
+      block.Coords[0] = block.Coords[1] = block.Coords[2] = 0;
+      }
+    } // END for all local blocks
+
   this->BuildMetaData = false; /* signal that the metadata is build */
 
   assert("pre: metadata is corrupt!" && (this->MetaData->SanityCheck()));
@@ -546,6 +650,14 @@ void vtkPGenericIOReader::LoadRawData()
 {
   assert("pre: metadata is corrupt!" && (this->MetaData->SanityCheck()));
 
+  if(this->MetaData->RawCacheKey != "all")
+    {
+    // the cache holds a subset of the blocks or particles, start over
+    this->MetaData->ReleaseRawCache();
+    this->MetaData->RawCacheKey = "all";
+    }
+  this->MetaData->NumberOfElements = this->Reader->GetNumberOfElements();
+
   std::string xaxis = std::string(this->XAxisVariableName);
   xaxis = vtkGenericIOUtilities::trim(xaxis);
 
@@ -611,6 +723,273 @@ void vtkPGenericIOReader::LoadRawData()
 }
 
 
+//------------------------------------------------------------------------------
+void vtkPGenericIOReader::GetVariablesToLoad(std::vector< std::string >& vars)
+{
+  vars.clear();
+
+  std::string xaxis = std::string(this->XAxisVariableName);
+  vars.push_back( vtkGenericIOUtilities::trim(xaxis) );
+
+  std::string yaxis = std::string(this->YAxisVariableName);
+  vars.push_back( vtkGenericIOUtilities::trim(yaxis) );
+
+  std::string zaxis = std::string(this->ZAxisVariableName);
+  vars.push_back( vtkGenericIOUtilities::trim(zaxis) );
+
+  if (this->HaloList->GetNumberOfIds() > 0)
+    {
+    std::string haloIds = std::string(this->HaloIdVariableName);
+    vars.push_back( vtkGenericIOUtilities::trim(haloIds) );
+    }
+
+  int arrayIdx = 0;
+  for(;arrayIdx < this->PointDataArraySelection->GetNumberOfArrays(); ++arrayIdx)
+    {
+    const char *name = this->PointDataArraySelection->GetArrayName(arrayIdx);
+    if( this->PointDataArraySelection->ArrayIsEnabled(name) &&
+        (std::find(vars.begin(),vars.end(),std::string(name)) == vars.end()) )
+      {
+      vars.push_back( std::string(name) );
+      }
+    } // END for all arrays
+}
+
+namespace {
+
+//------------------------------------------------------------------------------
+// Returns a pseudo-random number in [0,1) that only depends on its arguments,
+// so that random subsampling is reproducible across runs and decompositions.
+inline double SampleHash(int seed, int blockId, vtkIdType idx)
+{
+  vtkTypeUInt64 h = static_cast<vtkTypeUInt64>(static_cast<unsigned int>(seed));
+  h = (h << 32) ^ static_cast<vtkTypeUInt64>(static_cast<unsigned int>(blockId));
+  h ^= static_cast<vtkTypeUInt64>(idx) * 0x9E3779B97F4A7C15ULL;
+  h ^= (h >> 30);
+  h *= 0xBF58476D1CE4E5B9ULL;
+  h ^= (h >> 27);
+  h *= 0x94D049BB133111EBULL;
+  h ^= (h >> 31);
+  return( static_cast<double>(h >> 11) * (1.0/9007199254740992.0) );
+}
+
+//------------------------------------------------------------------------------
+inline bool BoundsIntersect(const double a[6], const double b[6])
+{
+  for(int dim=0; dim < 3; ++dim)
+    {
+    if( (a[2*dim] > b[2*dim+1]) || (b[2*dim] > a[2*dim+1]) )
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+}
+
+//------------------------------------------------------------------------------
+double vtkPGenericIOReader::GetEffectiveSubsamplingFraction(
+      vtkInformation* outInfo)
+{
+  double fraction = 1.0;
+  if( this->SubsamplingStrategy != SUBSAMPLE_NONE )
+    {
+    fraction = this->SubsamplingFraction;
+    }
+
+  if( (outInfo != NULL) &&
+      outInfo->Has(vtkStreamingDemandDrivenPipeline::UPDATE_RESOLUTION()) )
+    {
+    double resolution =
+      outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_RESOLUTION());
+    if( (resolution > 0.0) && (resolution < fraction) )
+      {
+      fraction = resolution;
+      }
+    }
+  return( fraction );
+}
+
+//------------------------------------------------------------------------------
+void vtkPGenericIOReader::SelectBlocks(double fraction)
+{
+  this->MetaData->SelectedBlocks.clear();
+  this->MetaData->SelectedParticles.clear();
+
+  // a downstream resolution request without an explicit strategy uses a stride
+  int strategy = this->SubsamplingStrategy;
+  if( (strategy == SUBSAMPLE_NONE) && (fraction < 1.0) )
+    {
+    strategy = SUBSAMPLE_STRIDE;
+    }
+
+  for(unsigned int i=0; i < this->MetaData->Blocks.size(); ++i)
+    {
+    const vtkGenericIOBlockInfo& block = this->MetaData->Blocks[i];
+    if( block.NumberOfElements == 0 )
+      {
+      continue;
+      }
+
+    if( this->UseRegionOfInterest && block.HasBounds &&
+        !BoundsIntersect(block.Bounds,this->RegionOfInterest) )
+      {
+#ifdef DEBUG
+      std::cout << "\t[INFO]: Skipping block " << block.GlobalId
+                << " outside of the region of interest\n";
+      std::cout.flush();
+#endif
+      continue;
+      }
+
+    std::vector< vtkIdType > particles;
+    if( (strategy == SUBSAMPLE_STRIDE) && (fraction < 1.0) )
+      {
+      vtkIdType stride = (fraction > 0.0)?
+          static_cast<vtkIdType>(1.0/fraction + 0.5) : block.NumberOfElements;
+      stride = std::max(stride,static_cast<vtkIdType>(1));
+      for(vtkIdType idx=0; idx < block.NumberOfElements; idx+=stride)
+        {
+        particles.push_back(idx);
+        }
+      }
+    else if( (strategy == SUBSAMPLE_RANDOM) && (fraction < 1.0) )
+      {
+      for(vtkIdType idx=0; idx < block.NumberOfElements; ++idx)
+        {
+        if( SampleHash(this->SubsamplingSeed,block.GlobalId,idx) < fraction )
+          {
+          particles.push_back(idx);
+          }
+        }
+      }
+
+    if( (fraction < 1.0) && particles.empty() )
+      {
+      // nothing to keep from this block, do not read it at all
+      continue;
+      }
+
+    this->MetaData->SelectedBlocks.push_back( static_cast<int>(i) );
+    this->MetaData->SelectedParticles.push_back( particles );
+    } // END for all local blocks
+}
+
+//------------------------------------------------------------------------------
+void vtkPGenericIOReader::LoadRawDataForSelectedBlocks(double fraction)
+{
+  assert("pre: metadata is corrupt!" && (this->MetaData->SanityCheck()));
+
+  this->SelectBlocks(fraction);
+
+  // STEP 0: release the cache if it holds a different selection
+  std::ostringstream key;
+  key << "blocks:";
+  for(unsigned int i=0; i < this->MetaData->SelectedBlocks.size(); ++i)
+    {
+    key << this->MetaData->SelectedBlocks[i] << ",";
+    }
+  key << ";strategy=" << this->SubsamplingStrategy
+      << ";fraction=" << fraction
+      << ";seed=" << this->SubsamplingSeed;
+  if( this->MetaData->RawCacheKey != key.str() )
+    {
+    this->MetaData->ReleaseRawCache();
+    this->MetaData->RawCacheKey = key.str();
+    }
+
+  vtkIdType numberOfElements = 0;
+  for(unsigned int i=0; i < this->MetaData->SelectedBlocks.size(); ++i)
+    {
+    numberOfElements += this->MetaData->GetNumberOfSelectedParticles(i);
+    }
+  this->MetaData->NumberOfElements = static_cast<int>(numberOfElements);
+
+  // STEP 1: allocate the variables that are not already cached
+  std::vector< std::string > vars;
+  this->GetVariablesToLoad(vars);
+
+  std::vector< std::string > varsToRead;
+  for(unsigned int v=0; v < vars.size(); ++v)
+    {
+    assert("pre: no variable in metadata with given name" &&
+            this->MetaData->HasVariable(vars[v]));
+    if( !this->MetaData->VariableStatus[ vars[v] ] )
+      {
+      this->MetaData->RawCache[ vars[v] ] =
+        gio::GenericIOUtilities::AllocateVariableArray(
+          this->MetaData->Information[ vars[v] ],numberOfElements);
+      this->MetaData->VariableStatus[ vars[v] ] = true;
+      varsToRead.push_back( vars[v] );
+      }
+    } // END for all variables
+
+  if( varsToRead.empty() )
+    {
+    return;
+    }
+
+  // STEP 2: read the selected blocks, compacting the subsampled particles
+  vtkIdType offset = 0;
+  std::vector< char* > scratch( varsToRead.size(), static_cast<char*>(NULL) );
+  for(unsigned int i=0; i < this->MetaData->SelectedBlocks.size(); ++i)
+    {
+    const vtkGenericIOBlockInfo& block =
+        this->MetaData->Blocks[ this->MetaData->SelectedBlocks[i] ];
+    const std::vector< vtkIdType >& particles =
+        this->MetaData->SelectedParticles[i];
+
+    this->Reader->ClearVariables();
+    for(unsigned int v=0; v < varsToRead.size(); ++v)
+      {
+      const std::string& name = varsToRead[v];
+      size_t size = vtkGenericIOUtilities::GetSizeOfType(
+          this->MetaData->VariableGenericIOType[name]);
+      char* target = static_cast<char*>(this->MetaData->RawCache[name]);
+      if( particles.empty() )
+        {
+        // read straight into place
+        this->Reader->AddVariable(
+          this->MetaData->Information[name],target+offset*size);
+        }
+      else
+        {
+        scratch[v] = static_cast<char*>(
+          gio::GenericIOUtilities::AllocateVariableArray(
+            this->MetaData->Information[name],block.NumberOfElements));
+        this->Reader->AddVariable(
+          this->MetaData->Information[name],scratch[v]);
+        }
+      } // END for all variables
+
+    this->Reader->ReadBlock(block.GlobalId);
+
+    if( !particles.empty() )
+      {
+      for(unsigned int v=0; v < varsToRead.size(); ++v)
+        {
+        const std::string& name = varsToRead[v];
+        size_t size = vtkGenericIOUtilities::GetSizeOfType(
+            this->MetaData->VariableGenericIOType[name]);
+        char* target =
+          static_cast<char*>(this->MetaData->RawCache[name]) + offset*size;
+        for(size_t k=0; k < particles.size(); ++k)
+          {
+          memcpy(target+k*size,scratch[v]+particles[k]*size,size);
+          }
+        delete [] scratch[v];
+        scratch[v] = NULL;
+        } // END for all variables
+      }
+
+    offset += this->MetaData->GetNumberOfSelectedParticles(i);
+    } // END for all selected blocks
+
+  assert("post: offset must match the number of elements" &&
+         (offset == numberOfElements) );
+}
+
 //------------------------------------------------------------------------------
 void vtkPGenericIOReader::GetPointFromRawData(
         int xType, void* xBuffer, int yType, void* yBuffer, int zType, void* zBuffer,
@@ -795,12 +1174,28 @@ void vtkPGenericIOReader::LoadData(vtkUnstructuredGrid *grid,
     unsigned long long coords[3];
     // since the compiler can't tell if they're the same....
     assert (sizeof(unsigned long long) == sizeof(uint64_t));
+    bool allBlocks = (this->MetaData->RawCacheKey == "all");
     for (int i = 0; i < this->MetaData->NumberOfElements; ++i)
       {
-      if (i == nextBlockStart)
+      while (i == nextBlockStart)
         {
-        this->Reader->GetBlockCoords(nextBlockIdx,(uint64_t*)coords);
-        nextBlockStart += this->Reader->GetNumberOfElementsInBlock(nextBlockIdx);
+        if (allBlocks)
+          {
+          this->Reader->GetBlockCoords(nextBlockIdx,(uint64_t*)coords);
+          nextBlockStart += this->Reader->GetNumberOfElementsInBlock(nextBlockIdx);
+          }
+        else
+          {
+          // only the selected blocks, possibly subsampled, were read
+          const vtkGenericIOBlockInfo& block = this->MetaData->Blocks[
+            this->MetaData->SelectedBlocks[nextBlockIdx] ];
+          for (int dim = 0; dim < 3; ++dim)
+            {
+            coords[dim] = block.Coords[dim];
+            }
+          nextBlockStart +=
+            this->MetaData->GetNumberOfSelectedParticles(nextBlockIdx);
+          }
         ++nextBlockIdx;
         }
       dataArray->SetTypedTuple(i,coords);
@@ -958,8 +1353,17 @@ int vtkPGenericIOReader::RequestData(
   assert("pre: output grid is NULL!" && (output != NULL) );
   std::set< vtkIdType > pointsInSelectedHalos;
 
-  // STEP 1: Load raw data
-  this->LoadRawData();
+  // STEP 1: Load raw data, block by block if only part of it is needed
+  double fraction = this->GetEffectiveSubsamplingFraction(outInfo);
+  if( (this->UseRegionOfInterest && this->Reader->IsSpatiallyDecomposed()) ||
+      (fraction < 1.0) )
+    {
+    this->LoadRawDataForSelectedBlocks(fraction);
+    }
+  else
+    {
+    this->LoadRawData();
+    }
 
   // STEP 2: Load coordinates
   this->LoadCoordinates(output,pointsInSelectedHalos);
@@ -16,6 +16,14 @@
 //
 // .SECTION Description
 //  Creates a vtkUnstructuredGrid instance from a GenericIO file.
+//
+//  When the file is spatially decomposed, the reader can restrict the read
+//  to the blocks that intersect a user-supplied region of interest.  The
+//  particles of each block can further be subsampled, either with a fixed
+//  stride or with a deterministic pseudo-random selection.  A downstream
+//  request for a lower resolution, via
+//  vtkStreamingDemandDrivenPipeline::UPDATE_RESOLUTION(), is honored the same
+//  way so that LOD pipelines can obtain a cheap particle subset.
 
 #ifndef vtkPGenericIOReader_h
 #define vtkPGenericIOReader_h
@@ -25,6 +33,8 @@
 #include "vtkPVVTKExtensionsCosmoToolsModule.h" // For export macro
 
 #include <set> // for std::set in protected methods
+#include <string> // for std::string in protected methods
+#include <vector> // for std::vector in protected methods
 
 // Forward Declarations
 class vtkCallbackCommand;
@@ -59,6 +69,12 @@ enum BlockAssignment {
   RCB
 };
 
+enum SubsamplingStrategy {
+  SUBSAMPLE_NONE,
+  SUBSAMPLE_STRIDE,
+  SUBSAMPLE_RANDOM
+};
+
 
   static vtkPGenericIOReader *New();
   vtkTypeMacro(vtkPGenericIOReader,vtkUnstructuredGridAlgorithm);
@@ -115,6 +131,39 @@ enum BlockAssignment {
   vtkBooleanMacro(AppendBlockCoordinates,bool);
   vtkGetMacro(AppendBlockCoordinates,bool);
 
+  // Description:
+  // Set/Get whether only the blocks intersecting the RegionOfInterest should
+  // be read. This only has an effect on spatially decomposed files.
+  // Defaults to false (Off).
+  vtkSetMacro(UseRegionOfInterest,bool);
+  vtkBooleanMacro(UseRegionOfInterest,bool);
+  vtkGetMacro(UseRegionOfInterest,bool);
+
+  // Description:
+  // Set/Get the region of interest as (xmin,xmax,ymin,ymax,zmin,zmax).
+  // Blocks whose bounds do not intersect this box are not read.
+  vtkSetVector6Macro(RegionOfInterest,double);
+  vtkGetVector6Macro(RegionOfInterest,double);
+
+  // Description:
+  // Set/Get the particle subsampling strategy, i.e., SUBSAMPLE_NONE,
+  // SUBSAMPLE_STRIDE or SUBSAMPLE_RANDOM. Defaults to SUBSAMPLE_NONE.
+  vtkSetClampMacro(SubsamplingStrategy,int,SUBSAMPLE_NONE,SUBSAMPLE_RANDOM);
+  vtkGetMacro(SubsamplingStrategy,int);
+
+  // Description:
+  // Set/Get the fraction of particles, in (0,1], kept by the subsampling
+  // strategy. Defaults to 1.0, i.e., all particles.
+  vtkSetClampMacro(SubsamplingFraction,double,0.0,1.0);
+  vtkGetMacro(SubsamplingFraction,double);
+
+  // Description:
+  // Set/Get the seed used by the SUBSAMPLE_RANDOM strategy. The selection is
+  // a deterministic function of the seed, the block and the particle index,
+  // so the same subset is returned across executions and process counts.
+  vtkSetMacro(SubsamplingSeed,int);
+  vtkGetMacro(SubsamplingSeed,int);
+
   // Description:
   // Returns the list of arrays used to select the variables to be used
   // for the x,y and z axis.
@@ -240,6 +289,26 @@ protected:
   // Loads the Raw data
   void LoadRawData();
 
+  // Description:
+  // Loads the raw data one block at a time, reading only the blocks that
+  // pass the region of interest and keeping only the subsampled particles.
+  // The given fraction is the effective subsampling fraction.
+  void LoadRawDataForSelectedBlocks(double fraction);
+
+  // Description:
+  // Returns the names of the coordinate, halo id and enabled variables.
+  void GetVariablesToLoad(std::vector< std::string >& vars);
+
+  // Description:
+  // Computes the list of local blocks to read, according to the region of
+  // interest, and the indices of the particles to keep within each block.
+  void SelectBlocks(double fraction);
+
+  // Description:
+  // Returns the effective subsampling fraction for this request, combining
+  // the SubsamplingFraction and any downstream UPDATE_RESOLUTION request.
+  double GetEffectiveSubsamplingFraction(vtkInformation* outInfo);
+
   // Description:
   // Loads the particle coordinates
   void LoadCoordinates(vtkUnstructuredGrid *grid,
@@ -275,6 +344,12 @@ protected:
   bool BuildMetaData;
   bool AppendBlockCoordinates;
 
+  bool UseRegionOfInterest;
+  double RegionOfInterest[6];
+  int SubsamplingStrategy;
+  double SubsamplingFraction;
+  int SubsamplingSeed;
+
 
   vtkMultiProcessController* Controller;
 
@@ -20,195 +20,414 @@
 #include "vtkDataArray.h"
 #include "vtkErrorCode.h"
 #include "vtkInformation.h"
+#include "vtkMath.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPointSet.h"
 #include "vtkPolyData.h"
 #include "vtkPolyLineToRectilinearGridFilter.h"
+#include "vtkSMPTools.h"
+#include "vtkStringArray.h"
 #include "vtkTable.h"
 #include "vtkSmartPointer.h"
 
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
 #include <vector>
 #include <sstream>
 
-vtkStandardNewMacro(vtkCSVWriter);
-//-----------------------------------------------------------------------------
-vtkCSVWriter::vtkCSVWriter()
+namespace
 {
-  this->StringDelimiter = 0;
-  this->FieldDelimiter = 0;
-  this->UseStringDelimiter = true;
-  this->SetStringDelimiter("\"");
-  this->SetFieldDelimiter(",");
-  this->Stream = 0;
-  this->FileName = 0;
-  this->Precision = 5;
-  this->UseScientificNotation = true;
-}
+// Number of rows formatted by a single task and number of tasks formatted
+// before the results are written out. This bounds the memory used for the
+// formatted text to a few chunks per column.
+const vtkIdType vtkCSVRowsPerChunk = 4096;
+const vtkIdType vtkCSVChunksPerWrite = 64;
 
-//-----------------------------------------------------------------------------
-vtkCSVWriter::~vtkCSVWriter()
+struct vtkCSVFormat
 {
-  this->SetStringDelimiter(0);
-  this->SetFieldDelimiter(0);
-  this->SetFileName(0);
-  delete this->Stream;
-}
+  int Precision;
+  bool UseScientificNotation;
+  bool UseShortestRoundTrip;
+  std::string StringDelimiter;
+};
 
-//-----------------------------------------------------------------------------
-int vtkCSVWriter::FillInputPortInformation(
-  int vtkNotUsed(port), vtkInformation* info)
+// A column of the table. Data is the pointer to the values of numeric
+// arrays, obtained up front so that the formatting tasks never ask the array
+// for it concurrently.
+struct vtkCSVColumn
 {
-  info->Set(vtkAlgorithm::INPUT_REQUIRED_DATA_TYPE(), "vtkTable");
-  return 1;
-}
+  vtkAbstractArray* Array;
+  vtkStringArray* StringArray;
+  void* Data;
+  int DataType;
+  int NumberOfComponents;
+  vtkIdType NumberOfValues;
+};
 
-//-----------------------------------------------------------------------------
-bool vtkCSVWriter::OpenFile()
+// The text for a range of rows of a column: the values are appended to Text
+// and Offsets holds the end of each value (one per row and component).
+struct vtkCSVColumnText
 {
-  if ( !this->FileName )
-    {
-    vtkErrorMacro(<< "No FileName specified! Can't write!");
-    this->SetErrorCode(vtkErrorCode::NoFileNameError);
-    return false;
-    }
+  std::string Text;
+  std::vector<size_t> Offsets;
+};
 
-  vtkDebugMacro(<<"Opening file for writing...");
+//-----------------------------------------------------------------------------
+template <typename T, bool IsSigned>
+struct vtkCSVSign
+{
+  static bool IsNegative(T value) { return value < 0; }
+};
 
-  ofstream *fptr = new ofstream(this->FileName, ios::out);
+template <typename T>
+struct vtkCSVSign<T, false>
+{
+  static bool IsNegative(T) { return false; }
+};
 
-  if (fptr->fail())
+template <typename T>
+inline void vtkCSVAppendInteger(std::string& out, T value)
+{
+  char buffer[32];
+  char* end = buffer + sizeof(buffer);
+  char* p = end;
+  bool negative =
+    vtkCSVSign<T, std::numeric_limits<T>::is_signed>::IsNegative(value);
+  unsigned long long u = static_cast<unsigned long long>(value);
+  if (negative)
     {
-    vtkErrorMacro(<< "Unable to open file: "<< this->FileName);
-    this->SetErrorCode(vtkErrorCode::CannotOpenFileError);
-    delete fptr;
-    return false;
+    u = 0ull - u;
     }
-
-  this->Stream = fptr;
-  return true;
+  do
+    {
+    *--p = static_cast<char>('0' + (u % 10));
+    u /= 10;
+    }
+  while (u != 0);
+  if (negative)
+    {
+    *--p = '-';
+    }
+  out.append(p, end - p);
 }
 
 //-----------------------------------------------------------------------------
-template <class iterT>
-void vtkCSVWriterGetDataString(
-  iterT* iter, vtkIdType tupleIndex, ofstream* stream, vtkCSVWriter* writer,
-  bool* first)
+// Formats value with the given number of digits; this matches what an
+// ostream with std::setprecision (and std::scientific) produces.
+inline int vtkCSVFormatReal(std::vector<char>& buffer, double value,
+  int precision, bool scientific)
+{
+  size_t needed = static_cast<size_t>(precision) + 32;
+  if (buffer.size() < needed)
+    {
+    buffer.resize(needed);
+    }
+  return sprintf(&buffer[0], scientific ? "%.*e" : "%.*g", precision, value);
+}
+
+// Formats value with the fewest digits that read back to the same value.
+template <typename T>
+inline int vtkCSVFormatShortest(std::vector<char>& buffer, T value,
+  bool scientific)
 {
-  int numComps = iter->GetNumberOfComponents();
-  vtkIdType index = tupleIndex* numComps;
-  for (int cc=0; cc < numComps; cc++)
+  if (!vtkMath::IsFinite(value))
+    {
+    return vtkCSVFormatReal(buffer, value, 6, scientific);
+    }
+
+  // %e counts the digits after the decimal point, %g the significant ones.
+  const int offset = scientific ? 1 : 0;
+  int low = 1 - offset;
+  int high = std::numeric_limits<T>::digits10 + 3 - offset;
+  while (low < high)
     {
-    if ((index+cc) < iter->GetNumberOfValues())
+    int mid = (low + high) / 2;
+    vtkCSVFormatReal(buffer, value, mid, scientific);
+    if (static_cast<T>(strtod(&buffer[0], NULL)) == value)
       {
-      if (*first == false)
-        {
-        (*stream) << writer->GetFieldDelimiter();
-        }
-      *first = false;
-      (*stream) << iter->GetValue(index+cc);
+      high = mid;
       }
     else
       {
-      if (*first == false)
-        {
-        (*stream) << writer->GetFieldDelimiter();
-        }
-      *first = false;
+      low = mid + 1;
       }
     }
+  return vtkCSVFormatReal(buffer, value, low, scientific);
+}
+
+template <typename T>
+inline void vtkCSVAppendReal(std::string& out, T value,
+  const vtkCSVFormat& format, std::vector<char>& buffer)
+{
+  int length = format.UseShortestRoundTrip?
+    vtkCSVFormatShortest(buffer, value, format.UseScientificNotation) :
+    vtkCSVFormatReal(buffer, value, format.Precision,
+      format.UseScientificNotation);
+  out.append(&buffer[0], length);
 }
 
 //-----------------------------------------------------------------------------
-template<>
-void vtkCSVWriterGetDataString(
-  vtkArrayIteratorTemplate<vtkStdString>* iter, vtkIdType tupleIndex,
-  ofstream* stream, vtkCSVWriter* writer, bool* first)
+template <typename T>
+inline void vtkCSVAppendValue(std::string& out, T value,
+  const vtkCSVFormat&, std::vector<char>&)
 {
-  int numComps = iter->GetNumberOfComponents();
-  vtkIdType index = tupleIndex* numComps;
-  for (int cc=0; cc < numComps; cc++)
+  vtkCSVAppendInteger(out, value);
+}
+
+inline void vtkCSVAppendValue(std::string& out, float value,
+  const vtkCSVFormat& format, std::vector<char>& buffer)
+{
+  vtkCSVAppendReal(out, value, format, buffer);
+}
+
+inline void vtkCSVAppendValue(std::string& out, double value,
+  const vtkCSVFormat& format, std::vector<char>& buffer)
+{
+  vtkCSVAppendReal(out, value, format, buffer);
+}
+
+inline void vtkCSVAppendValue(std::string& out, signed char value,
+  const vtkCSVFormat&, std::vector<char>&)
+{
+  // signed char has always been streamed as a character.
+  out.push_back(static_cast<char>(value));
+}
+
+//-----------------------------------------------------------------------------
+template <typename T>
+void vtkCSVFormatValues(const T* data, const vtkCSVColumn& column,
+  vtkIdType begin, vtkIdType end, const vtkCSVFormat& format,
+  vtkCSVColumnText& result)
+{
+  std::vector<char> buffer(64);
+  const int numComps = column.NumberOfComponents;
+  for (vtkIdType row = begin; row < end; ++row)
     {
-    if ((index+cc) < iter->GetNumberOfValues())
+    vtkIdType index = row * numComps;
+    for (int cc = 0; cc < numComps; ++cc, ++index)
       {
-      if (*first == false)
+      if (index < column.NumberOfValues)
         {
-        (*stream) << writer->GetFieldDelimiter();
+        vtkCSVAppendValue(result.Text, data[index], format, buffer);
         }
-      *first = false;
-      (*stream) << writer->GetString(iter->GetValue(index+cc));
+      result.Offsets.push_back(result.Text.size());
       }
-    else
+    }
+}
+
+// Fallback for arrays that are neither numeric nor strings, e.g.
+// vtkVariantArray: use the array iterator and an ostream, as before.
+template <typename iterT>
+void vtkCSVFormatIteratorValues(iterT* iter, const vtkCSVColumn& column,
+  vtkIdType begin, vtkIdType end, const vtkCSVFormat& format,
+  vtkCSVColumnText& result)
+{
+  std::ostringstream stream;
+  if (format.UseScientificNotation)
+    {
+    stream << std::scientific;
+    }
+  stream << std::setprecision(format.Precision);
+
+  const int numComps = column.NumberOfComponents;
+  for (vtkIdType row = begin; row < end; ++row)
+    {
+    vtkIdType index = row * numComps;
+    for (int cc = 0; cc < numComps; ++cc, ++index)
       {
-      if (*first == false)
+      if (index < column.NumberOfValues)
         {
-        (*stream) << writer->GetFieldDelimiter();
+        stream.str("");
+        stream << iter->GetValue(index);
+        result.Text += stream.str();
         }
-      *first = false;
+      result.Offsets.push_back(result.Text.size());
       }
     }
 }
 
-//-----------------------------------------------------------------------------
-template<>
-void vtkCSVWriterGetDataString(
-  vtkArrayIteratorTemplate<char>* iter, vtkIdType tupleIndex,
-  ofstream* stream, vtkCSVWriter* writer, bool* first)
+void vtkCSVFormatColumn(const vtkCSVColumn& column, vtkIdType begin,
+  vtkIdType end, const vtkCSVFormat& format, vtkCSVColumnText& result)
 {
-  int numComps = iter->GetNumberOfComponents();
-  vtkIdType index = tupleIndex* numComps;
-  for (int cc=0; cc < numComps; cc++)
+  result.Text.clear();
+  result.Offsets.clear();
+  result.Offsets.reserve(
+    static_cast<size_t>((end - begin) * column.NumberOfComponents + 1));
+  result.Offsets.push_back(0);
+
+  if (column.StringArray)
     {
-    if ((index+cc) < iter->GetNumberOfValues())
+    const int numComps = column.NumberOfComponents;
+    for (vtkIdType row = begin; row < end; ++row)
       {
-      if (*first == false)
+      vtkIdType index = row * numComps;
+      for (int cc = 0; cc < numComps; ++cc, ++index)
         {
-        (*stream) << writer->GetFieldDelimiter();
+        if (index < column.NumberOfValues)
+          {
+          result.Text += format.StringDelimiter;
+          result.Text += column.StringArray->GetValue(index);
+          result.Text += format.StringDelimiter;
+          }
+        result.Offsets.push_back(result.Text.size());
         }
-      *first = false;
-      (*stream) << static_cast<int>( iter->GetValue(index+cc) );
       }
-    else
+    }
+  else if (column.Data)
+    {
+    switch (column.DataType)
       {
-      if (*first == false)
-        {
-        (*stream) << writer->GetFieldDelimiter();
-        }
-      *first = false;
+      vtkTemplateMacro(vtkCSVFormatValues(
+          static_cast<const VTK_TT*>(column.Data), column, begin, end,
+          format, result));
+      }
+    }
+  else
+    {
+    vtkSmartPointer<vtkArrayIterator> iter;
+    iter.TakeReference(column.Array->NewIterator());
+    switch (column.Array->GetDataType())
+      {
+      vtkArrayIteratorTemplateMacro(vtkCSVFormatIteratorValues(
+          static_cast<VTK_TT*>(iter.GetPointer()), column, begin, end,
+          format, result));
+      default:
+        // unknown types are written as empty fields, the rows still need
+        // an offset per value.
+        result.Offsets.resize(
+          static_cast<size_t>((end - begin) * column.NumberOfComponents) + 1,
+          0);
       }
     }
 }
 
 //-----------------------------------------------------------------------------
-template<>
-void vtkCSVWriterGetDataString(
-  vtkArrayIteratorTemplate<unsigned char>* iter, vtkIdType tupleIndex,
-  ofstream* stream, vtkCSVWriter* writer, bool* first)
+// Formats chunks of rows into separate strings so that they can be written
+// out in order once all the chunks are done.
+class vtkCSVFormatChunks
 {
-  int numComps = iter->GetNumberOfComponents();
-  vtkIdType index = tupleIndex* numComps;
-  for (int cc=0; cc < numComps; cc++)
+public:
+  const std::vector<vtkCSVColumn>* Columns;
+  const vtkCSVFormat* Format;
+  const char* FieldDelimiter;
+  vtkIdType FirstChunk;
+  vtkIdType NumberOfRows;
+  std::vector<std::string>* Output;
+
+  void operator()(vtkIdType begin, vtkIdType end)
     {
-    if ((index+cc) < iter->GetNumberOfValues())
+    const std::vector<vtkCSVColumn>& columns = *this->Columns;
+    std::vector<vtkCSVColumnText> texts(columns.size());
+    const size_t delimiterLength = strlen(this->FieldDelimiter);
+
+    for (vtkIdType chunk = begin; chunk < end; ++chunk)
       {
-      if (*first == false)
+      vtkIdType firstRow = (this->FirstChunk + chunk) * vtkCSVRowsPerChunk;
+      vtkIdType lastRow = std::min(firstRow + vtkCSVRowsPerChunk,
+        this->NumberOfRows);
+
+      size_t size = 0;
+      for (size_t cc = 0; cc < columns.size(); ++cc)
         {
-        (*stream) << writer->GetFieldDelimiter();
+        vtkCSVFormatColumn(columns[cc], firstRow, lastRow, *this->Format,
+          texts[cc]);
+        size += texts[cc].Text.size() +
+          (texts[cc].Offsets.size() - 1) * delimiterLength;
         }
-      *first = false;
-      (*stream) << static_cast<int>( iter->GetValue(index+cc) );
-      }
-    else
-      {
-      if (*first == false)
+
+      // stitch the columns together, row by row.
+      std::string& out = (*this->Output)[chunk];
+      out.clear();
+      out.reserve(size + static_cast<size_t>(lastRow - firstRow));
+      for (vtkIdType row = 0; row < lastRow - firstRow; ++row)
         {
-        (*stream) << writer->GetFieldDelimiter();
+        bool first = true;
+        for (size_t cc = 0; cc < columns.size(); ++cc)
+          {
+          const vtkCSVColumnText& text = texts[cc];
+          const int numComps = columns[cc].NumberOfComponents;
+          for (int comp = 0; comp < numComps; ++comp)
+            {
+            if (!first)
+              {
+              out.append(this->FieldDelimiter, delimiterLength);
+              }
+            first = false;
+            size_t index = static_cast<size_t>(row * numComps + comp);
+            out.append(text.Text, text.Offsets[index],
+              text.Offsets[index + 1] - text.Offsets[index]);
+            }
+          }
+        out += '\n';
         }
-      *first = false;
       }
     }
+};
 }
 
+vtkStandardNewMacro(vtkCSVWriter);
+//-----------------------------------------------------------------------------
+vtkCSVWriter::vtkCSVWriter()
+{
+  this->StringDelimiter = 0;
+  this->FieldDelimiter = 0;
+  this->UseStringDelimiter = true;
+  this->SetStringDelimiter("\"");
+  this->SetFieldDelimiter(",");
+  this->Stream = 0;
+  this->FileName = 0;
+  this->Precision = 5;
+  this->UseScientificNotation = true;
+  this->UseShortestRoundTrip = false;
+}
+
+//-----------------------------------------------------------------------------
+vtkCSVWriter::~vtkCSVWriter()
+{
+  this->SetStringDelimiter(0);
+  this->SetFieldDelimiter(0);
+  this->SetFileName(0);
+  delete this->Stream;
+}
+
+//-----------------------------------------------------------------------------
+int vtkCSVWriter::FillInputPortInformation(
+  int vtkNotUsed(port), vtkInformation* info)
+{
+  info->Set(vtkAlgorithm::INPUT_REQUIRED_DATA_TYPE(), "vtkTable");
+  return 1;
+}
+
+//-----------------------------------------------------------------------------
+bool vtkCSVWriter::OpenFile()
+{
+  if ( !this->FileName )
+    {
+    vtkErrorMacro(<< "No FileName specified! Can't write!");
+    this->SetErrorCode(vtkErrorCode::NoFileNameError);
+    return false;
+    }
+
+  vtkDebugMacro(<<"Opening file for writing...");
+
+  ofstream *fptr = new ofstream(this->FileName, ios::out);
+
+  if (fptr->fail())
+    {
+    vtkErrorMacro(<< "Unable to open file: "<< this->FileName);
+    this->SetErrorCode(vtkErrorCode::CannotOpenFileError);
+    delete fptr;
+    return false;
+    }
+
+  delete this->Stream;
+  this->Stream = fptr;
+  return true;
+}
 
 //-----------------------------------------------------------------------------
 vtkStdString vtkCSVWriter::GetString(vtkStdString string)
@@ -246,12 +465,13 @@ void vtkCSVWriter::WriteTable(vtkTable* table)
     return;
     }
 
-  std::vector<vtkSmartPointer<vtkArrayIterator> > columnsIters;
+  std::vector<vtkCSVColumn> columns;
 
   int cc;
   int numArrays = dsa->GetNumberOfArrays();
   bool first = true;
   // Write headers:
+  std::string header;
   for (cc=0; cc < numArrays; cc++)
     {
     vtkAbstractArray* array = dsa->GetAbstractArray(cc);
@@ -259,7 +479,7 @@ void vtkCSVWriter::WriteTable(vtkTable* table)
       {
       if (!first)
         {
-        (*this->Stream) << this->FieldDelimiter;
+        header += this->FieldDelimiter;
         }
       first = false;
 
@@ -269,38 +489,69 @@ void vtkCSVWriter::WriteTable(vtkTable* table)
         {
         array_name << ":" << comp;
         }
-      (*this->Stream) << this->GetString(array_name.str());
+      header += this->GetString(array_name.str());
+      }
+
+    vtkCSVColumn column;
+    column.Array = array;
+    column.StringArray = vtkStringArray::SafeDownCast(array);
+    column.DataType = array->GetDataType();
+    column.NumberOfComponents = array->GetNumberOfComponents();
+    column.NumberOfValues = array->GetNumberOfValues();
+    column.Data = NULL;
+    // the types vtkTemplateMacro does not cover, such as VTK_BIT, are
+    // written through array iterators.
+    vtkDataArray* da = vtkDataArray::SafeDownCast(array);
+    if (da && column.NumberOfValues > 0)
+      {
+      switch (column.DataType)
+        {
+        vtkTemplateMacro(column.Data = da->GetVoidPointer(0));
+        }
       }
-    vtkArrayIterator* iter = array->NewIterator();
-    columnsIters.push_back(iter);
-    iter->Delete();
+    columns.push_back(column);
     }
-  (*this->Stream) << "\n";
+  header += "\n";
+  this->Stream->write(header.c_str(), header.size());
 
-  // push the floating point precision/notation type.
-  if (this->UseScientificNotation)
+  vtkCSVFormat format;
+  format.Precision = this->Precision;
+  format.UseScientificNotation = this->UseScientificNotation;
+  format.UseShortestRoundTrip = this->UseShortestRoundTrip;
+  if (this->UseStringDelimiter && this->StringDelimiter)
     {
-    (*this->Stream) << std::scientific;
+    format.StringDelimiter = this->StringDelimiter;
     }
-  
-  (*this->Stream) << std::setprecision(this->Precision);
 
-  for (vtkIdType index=0; index < numRows; index++)
+  const vtkIdType numChunks =
+    (numRows + vtkCSVRowsPerChunk - 1) / vtkCSVRowsPerChunk;
+  std::vector<std::string> output;
+
+  vtkCSVFormatChunks functor;
+  functor.Columns = &columns;
+  functor.Format = &format;
+  functor.FieldDelimiter = this->FieldDelimiter ? this->FieldDelimiter : "";
+  functor.NumberOfRows = numRows;
+  functor.Output = &output;
+  for (vtkIdType chunk = 0; chunk < numChunks; chunk += vtkCSVChunksPerWrite)
     {
-    first = true;
-    std::vector<vtkSmartPointer<vtkArrayIterator> >::iterator iter;
-    for (iter = columnsIters.begin(); iter != columnsIters.end(); ++iter)
+    vtkIdType count = std::min(vtkCSVChunksPerWrite, numChunks - chunk);
+    output.resize(static_cast<size_t>(count));
+    functor.FirstChunk = chunk;
+    vtkSMPTools::For(0, count, 1, functor);
+
+    for (vtkIdType kk = 0; kk < count && !this->Stream->fail(); ++kk)
       {
-      switch ((*iter)->GetDataType())
-        {
-        vtkArrayIteratorTemplateMacro(
-          vtkCSVWriterGetDataString(static_cast<VTK_TT*>(iter->GetPointer()),
-            index, this->Stream, this, &first));
-        }
+      this->Stream->write(output[kk].c_str(), output[kk].size());
       }
-    (*this->Stream) << "\n";
+    this->UpdateProgress(static_cast<double>(chunk + count) / numChunks);
     }
 
+  if (this->Stream->fail())
+    {
+    vtkErrorMacro(<< "Failed to write file: " << this->FileName);
+    this->SetErrorCode(vtkErrorCode::OutOfDiskSpaceError);
+    }
   this->Stream->close();
 }
 
@@ -317,4 +568,5 @@ void vtkCSVWriter::PrintSelf(ostream& os, vtkIndent indent)
     << endl;
   os << indent << "UseScientificNotation: " << this->UseScientificNotation << endl;
   os << indent << "Precision: " << this->Precision << endl;
+  os << indent << "UseShortestRoundTrip: " << this->UseShortestRoundTrip << endl;
 }
@@ -13,7 +13,9 @@
 
 =========================================================================*/
 // .NAME vtkCSVWriter - CSV writer for vtkTable
-// Writes a vtkTable as a delimited text file (such as CSV). 
+// Writes a vtkTable as a delimited text file (such as CSV).
+// Rows are formatted in chunks, in parallel using vtkSMPTools, and written
+// to the file in large buffers.
 #ifndef vtkCSVWriter_h
 #define vtkCSVWriter_h
 
@@ -58,6 +60,14 @@ public:
   vtkSetClampMacro(Precision, int, 0, VTK_INT_MAX);
   vtkGetMacro(Precision, int);
 
+  // Description:
+  // When set, Precision is ignored and floating point values are written
+  // with the fewest digits needed to read back the exact same value.
+  // Default is false.
+  vtkSetMacro(UseShortestRoundTrip, bool);
+  vtkGetMacro(UseShortestRoundTrip, bool);
+  vtkBooleanMacro(UseShortestRoundTrip, bool);
+
   // Description:
   // Get/Set whether scientific notation is used for numeric values.
   vtkSetMacro(UseScientificNotation, bool);
@@ -87,6 +97,7 @@ protected:
   bool UseStringDelimiter;
   int Precision;
   bool UseScientificNotation;
+  bool UseShortestRoundTrip;
 
   ofstream* Stream;
 private:
@@ -16,30 +16,145 @@
 
 #include "vtkObjectFactory.h"
 
-#include <vtksys/SystemTools.hxx>
-#include <vtksys/RegularExpression.hxx>
-#include <set>
+#include <cstdlib>
 #include <string>
 
+namespace
+{
+inline bool vtkIsDigit(char c)
+{
+  return c >= '0' && c <= '9';
+}
+
+inline bool vtkIsLetter(char c)
+{
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+// Characters allowed in a sequence index.
+inline bool vtkIsIndexChar(char c)
+{
+  return vtkIsDigit(c) || c == '.';
+}
+
+inline bool vtkIsSeparator(char c)
+{
+  return c == '.' || c == '_' || c == '-';
+}
+
+// "name.#": the index is whatever follows the last dot of the trailing run of
+// index characters.
+bool vtkMatchTrailingIndex(const std::string& file,
+  std::string& name, int& index)
+{
+  size_t n = file.size();
+  for (size_t cc = n; cc > 0 && vtkIsIndexChar(file[cc-1]); --cc)
+    {
+    if (file[cc-1] == '.' && cc < n)
+      {
+      name = file.substr(0, cc-1);
+      index = atoi(file.c_str() + cc);
+      return true;
+      }
+    }
+  return false;
+}
+
+// "name<sep>#.ext": the last separator followed by a run of index characters
+// that contains a dot (the one before the extension). The index ends at the
+// last dot of that run.
+bool vtkMatchInfixIndex(const std::string& file, bool (*isSeparator)(char),
+  std::string& name, int& index)
+{
+  size_t n = file.size();
+  for (size_t cc = n; cc > 0; --cc)
+    {
+    size_t sep = cc - 1;
+    if (!isSeparator(file[sep]))
+      {
+      continue;
+      }
+    size_t dot = std::string::npos;
+    for (size_t kk = sep + 1; kk < n && vtkIsIndexChar(file[kk]); ++kk)
+      {
+      if (file[kk] == '.' && kk > sep + 1)
+        {
+        dot = kk;
+        }
+      }
+    if (dot != std::string::npos)
+      {
+      name = file.substr(0, sep + 1) + ".." + file.substr(dot + 1);
+      index = atoi(file.c_str() + sep + 1);
+      return true;
+      }
+    }
+  return false;
+}
+
+// "#<sep>name.ext" and "#<letter>name.ext": the index is a leading run of index
+// characters, followed by a separator and a name with an extension. With a
+// letter, the whole run is the index.
+bool vtkMatchLeadingIndex(const std::string& file, bool letter,
+  std::string& name, int& index)
+{
+  size_t n = file.size();
+  size_t run = 0;
+  while (run < n && vtkIsIndexChar(file[run]))
+    {
+    ++run;
+    }
+  if (run == 0 || run == n)
+    {
+    return false;
+    }
+  for (size_t cc = run; cc > 0; --cc)
+    {
+    char c = file[cc];
+    bool separator = letter? vtkIsLetter(c) :
+      (cc == run? (c == '_' || c == '-') : (c == '.'));
+    if (separator && file.find('.', cc + 1) != std::string::npos)
+      {
+      name = ".." + file.substr(cc);
+      index = atoi(file.c_str());
+      return true;
+      }
+    }
+  return false;
+}
+
+// "name#other": the last run of digits that is neither at the start nor at
+// the end of the name.
+bool vtkMatchLastNumber(const std::string& file,
+  std::string& name, int& index)
+{
+  size_t end = file.size();
+  while (end > 0 && !vtkIsDigit(file[end-1]))
+    {
+    --end;
+    }
+  if (end == 0 || end == file.size())
+    {
+    return false;
+    }
+  size_t begin = end;
+  while (begin > 0 && vtkIsDigit(file[begin-1]))
+    {
+    --begin;
+    }
+  if (begin == 0)
+    {
+    return false;
+    }
+  name = file.substr(0, begin) + ".." + file.substr(end);
+  index = atoi(file.c_str() + begin);
+  return true;
+}
+}
+
 vtkStandardNewMacro(vtkFileSequenceParser);
 //-----------------------------------------------------------------------------
 vtkFileSequenceParser::vtkFileSequenceParser() :
-  // sequence ending with numbers.
-  reg_ex( new vtksys::RegularExpression("^(.*)\\.([0-9.]+)$")),
-  // sequence ending with extension.
-  reg_ex2( new vtksys::RegularExpression("^(.*)(\\.|_|-)([0-9.]+)\\.(.*)$")),
-  // sequence ending with extension, but with no ". or _" before
-  // the series number.
-  reg_ex3( new vtksys::RegularExpression("^(.*)([a-zA-Z])([0-9.]+)\\.(.*)$")),
-  // sequence ending with extension, and starting with series number
-  // followed by ". or _".
-  reg_ex4( new vtksys::RegularExpression("^([0-9.]+)(\\.|_|-)(.*)\\.(.*)$")),
-  // sequence ending with extension, and starting with series number,
-  // but not followed by ". or _".
-  reg_ex5( new vtksys::RegularExpression("^([0-9.]+)([a-zA-Z])(.*)\\.(.*)$")),
-  // fallback: any sequence with a number in the middle (taking the last number
-  // if multiple exist).
-  reg_ex_last( new vtksys::RegularExpression("^(.*[^0-9])([0-9]+)([^0-9]+)$")),
   SequenceIndex(-1),
   SequenceName(NULL)
 {
@@ -48,13 +163,6 @@ vtkFileSequenceParser::vtkFileSequenceParser() :
 //-----------------------------------------------------------------------------
 vtkFileSequenceParser::~vtkFileSequenceParser()
 {
-  delete this->reg_ex;
-  delete this->reg_ex2;
-  delete this->reg_ex3;
-  delete this->reg_ex4;
-  delete this->reg_ex5;
-  delete this->reg_ex_last;
-
   this->SetSequenceName(NULL);
 }
 
@@ -62,42 +170,25 @@ vtkFileSequenceParser::~vtkFileSequenceParser()
 //-----------------------------------------------------------------------------
 bool vtkFileSequenceParser::ParseFileSequence(char * file)
 {
-  bool match = false;
-  if (this->reg_ex->find(file))
-    {
-    this->SetSequenceName(this->reg_ex->match(1).c_str());
-    this->SequenceIndex = atoi(reg_ex->match(2).c_str());
-    match = true;
-    }
-  else if (this->reg_ex2->find(file))
-    {
-    this->SetSequenceName(std::string(this->reg_ex2->match(1) + this->reg_ex2->match(2) + ".." + this->reg_ex2->match(4)).c_str());
-    this->SequenceIndex = atoi(reg_ex2->match(3).c_str());
-    match = true;
-    }
-  else if (this->reg_ex3->find(file))
+  if (!file)
     {
-    this->SetSequenceName(std::string(this->reg_ex3->match(1) + this->reg_ex3->match(2) + ".." + this->reg_ex3->match(4)).c_str());
-    this->SequenceIndex = atoi(reg_ex3->match(3).c_str());
-    match = true;
+    return false;
     }
-  else if (this->reg_ex4->find(file))
-    {
-    this->SetSequenceName(std::string(".." + this->reg_ex4->match(2) + this->reg_ex4->match(3) + "." + this->reg_ex4->match(4)).c_str());
-    this->SequenceIndex = atoi(reg_ex4->match(1).c_str());
-    match = true;
-    }
-  else if (this->reg_ex5->find(file))
-    {
-    this->SetSequenceName(std::string(".." + this->reg_ex5->match(2) + this->reg_ex5->match(3) + "." + this->reg_ex5->match(4)).c_str());
-    this->SequenceIndex = atoi(reg_ex5->match(1).c_str());
-    match = true;
-    }
-  else if (this->reg_ex_last->find(file))
+
+  std::string filename(file);
+  std::string name;
+  int index = -1;
+  bool match =
+    vtkMatchTrailingIndex(filename, name, index) ||
+    vtkMatchInfixIndex(filename, vtkIsSeparator, name, index) ||
+    vtkMatchInfixIndex(filename, vtkIsLetter, name, index) ||
+    vtkMatchLeadingIndex(filename, false, name, index) ||
+    vtkMatchLeadingIndex(filename, true, name, index) ||
+    vtkMatchLastNumber(filename, name, index);
+  if (match)
     {
-    this->SetSequenceName(std::string(this->reg_ex_last->match(1) + ".." + this->reg_ex_last->match(3)).c_str());
-    this->SequenceIndex = atoi(reg_ex_last->match(2).c_str());
-    match = true;
+    this->SetSequenceName(name.c_str());
+    this->SequenceIndex = index;
     }
   return match;
 }
@@ -106,5 +197,7 @@ bool vtkFileSequenceParser::ParseFileSequence(char * file)
 void vtkFileSequenceParser::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
-
+  os << indent << "SequenceName: "
+    << (this->SequenceName? this->SequenceName : "(null)") << endl;
+  os << indent << "SequenceIndex: " << this->SequenceIndex << endl;
 }
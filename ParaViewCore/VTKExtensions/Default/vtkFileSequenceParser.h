@@ -19,7 +19,18 @@
 // extract the base portion of the file name that is common to all the files
 // in the sequence. It will also provide the current sequence index of the
 // provided file name.
-// by several vtkPVUpdateSuppressor objects.
+//
+// The file name is matched against the following patterns, in order, and the
+// first match wins ("#" stands for the sequence index, a run of digits and
+// dots):
+// \li "name.#" ending with the index;
+// \li "name[._-]#.ext" with the index before the extension;
+// \li "nameX#.ext" where X is a letter;
+// \li "#[._-]name.ext" starting with the index;
+// \li "#Xname.ext" where X is a letter;
+// \li "name#other", using the last run of digits.
+// The matching is done by a hand-written scanner rather than regular
+// expressions since this is called for every entry of directory listings.
 
 #ifndef vtkFileSequenceParser_h
 #define vtkFileSequenceParser_h
@@ -27,11 +38,6 @@
 #include "vtkPVVTKExtensionsDefaultModule.h" //needed for exports
 #include "vtkObject.h"
 
-namespace vtksys {
-  class RegularExpression;
-}
-
-
 class VTKPVVTKEXTENSIONSDEFAULT_EXPORT vtkFileSequenceParser : public vtkObject
 {
 public:
@@ -52,13 +58,6 @@ protected:
   vtkFileSequenceParser();
   ~vtkFileSequenceParser();
 
-  vtksys::RegularExpression * reg_ex;
-  vtksys::RegularExpression * reg_ex2;
-  vtksys::RegularExpression * reg_ex3;
-  vtksys::RegularExpression * reg_ex4;
-  vtksys::RegularExpression * reg_ex5;
-  vtksys::RegularExpression * reg_ex_last;
-
   // Used internall so char * allocations are done automatically.
   vtkSetStringMacro(SequenceName);
 
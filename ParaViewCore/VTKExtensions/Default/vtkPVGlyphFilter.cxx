@@ -23,18 +23,24 @@
 #include "vtkDataSet.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkIdTypeArray.h"
+#include "vtkMath.h"
 #include "vtkMinimalStandardRandomSequence.h"
 #include "vtkMultiBlockDataSet.h"
 #include "vtkMultiProcessController.h"
 #include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkPointSet.h"
 #include "vtkPolyData.h"
 #include "vtkSmartPointer.h"
+#include "vtkSMPTools.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkTransform.h"
 #include "vtkUniformGrid.h"
 #include "vtkTuple.h"
 #include "vtkOctreePointLocator.h"
+#include "vtkWeakPointer.h"
 
 // C/C++ includes
 #include <vector>
@@ -43,48 +49,179 @@
 #include <algorithm>
 #include <cmath>
 
+namespace
+{
+// number of glyphed points generated together by a thread.
+const vtkIdType GLYPH_GRAIN = 4096;
+}
+
 class vtkPVGlyphFilter::vtkInternals
 {
   vtkBoundingBox Bounds;
   double NearestPointRadius;
   std::vector<vtkTuple<double, 3> > Points;
-  std::vector<vtkIdType> PointIds;
-  size_t NextPointId;
 
-  vtkNew<vtkOctreePointLocator>Locator;
+  // the sample points above were generated for these parameters.
+  int SampleSeed;
+  int NumberOfSamples;
+  double SampleBounds[6];
 
-  void SetupLocator(vtkDataSet* ds)
+  // Placement of the glyphs on a dataset. The locator is built once for
+  // each modification of the dataset, the points to glyph are found once
+  // for each set of sample points.
+  struct Placement
     {
-    if (this->Locator->GetDataSet() == ds) { return; }
+    vtkWeakPointer<vtkDataSet> DataSet;
+    unsigned long MTime;
+    vtkSmartPointer<vtkOctreePointLocator> Locator;
+    bool HasPointIds;
+    std::vector<vtkIdType> PointIds;
+    };
+  typedef std::map<vtkDataSet*, Placement> PlacementsType;
+  PlacementsType Placements;
+
+  // cell centers of the datasets glyphed at their cells.
+  struct CellCenters
+    {
+    vtkWeakPointer<vtkDataSet> DataSet;
+    unsigned long MTime;
+    vtkSmartPointer<vtkPolyData> Centers;
+    };
+  typedef std::map<vtkDataSet*, CellCenters> CellCentersType;
+  CellCentersType Centers;
+
+  // datasets used by the current execution, the others are released
+  // after it.
+  std::set<vtkDataSet*> UsedDataSets;
+
+  // placement of the dataset being glyphed.
+  Placement* Current;
+  vtkDataSet* CurrentDataSet;
+  size_t NextPointId;
+
+  //---------------------------------------------------------------------------
+  Placement* GetPlacement(vtkDataSet* ds)
+    {
+    this->UsedDataSets.insert(ds);
+    Placement& placement = this->Placements[ds];
+    if (placement.DataSet.GetPointer() != ds || placement.MTime != ds->GetMTime())
+      {
+      placement.DataSet = ds;
+      placement.MTime = ds->GetMTime();
+      placement.Locator = vtkSmartPointer<vtkOctreePointLocator>::New();
+      placement.Locator->SetDataSet(ds);
+      placement.Locator->BuildLocator();
+      placement.HasPointIds = false;
+      placement.PointIds.clear();
+      }
+    if (!placement.HasPointIds)
+      {
+      std::set<vtkIdType> pointset;
+      for (std::vector<vtkTuple<double, 3> >::iterator iter=this->Points.begin(), end=this->Points.end();
+        iter != end; ++iter)
+        {
+        double dist2;
+        vtkIdType ptId = placement.Locator->FindClosestPointWithinRadius(
+          this->NearestPointRadius, iter->GetData(), dist2);
+        if (ptId >= 0)
+          {
+          pointset.insert(ptId);
+          }
+        }
+      placement.PointIds.assign(pointset.begin(), pointset.end());
+      placement.HasPointIds = true;
+      }
+    return &placement;
+    }
 
-    this->Locator->Initialize();
-    this->Locator->SetDataSet(ds);
-    this->Locator->BuildLocator();
+  //---------------------------------------------------------------------------
+  void InvalidatePlacements()
+    {
+    for (PlacementsType::iterator iter = this->Placements.begin();
+      iter != this->Placements.end(); ++iter)
+      {
+      iter->second.HasPointIds = false;
+      iter->second.PointIds.clear();
+      }
+    }
 
-    this->PointIds.clear();
-    std::set<vtkIdType> pointset;
-    for (std::vector<vtkTuple<double, 3> >::iterator iter=this->Points.begin(), end=this->Points.end();
-      iter != end; ++iter)
+  //---------------------------------------------------------------------------
+  // Releases the cached information of the datasets not used by the last
+  // execution.
+  template <class MapType>
+  void Prune(MapType& cache)
+    {
+    typename MapType::iterator iter = cache.begin();
+    while (iter != cache.end())
       {
-      double dist2;
-      vtkIdType ptId = this->Locator->FindClosestPointWithinRadius(
-        this->NearestPointRadius, iter->GetData(), dist2);
-      if (ptId >= 0)
+      if (this->UsedDataSets.find(iter->first) == this->UsedDataSets.end())
+        {
+        cache.erase(iter++);
+        }
+      else
         {
-        pointset.insert(ptId);
+        ++iter;
         }
       }
-    this->PointIds.insert(this->PointIds.begin(), pointset.begin(), pointset.end());
-    this->NextPointId = 0;
     }
 
 public:
+  vtkInternals() :
+    NearestPointRadius(0.0),
+    SampleSeed(0),
+    NumberOfSamples(0),
+    Current(NULL),
+    CurrentDataSet(NULL),
+    NextPointId(0)
+    {
+    vtkMath::UninitializeBounds(this->SampleBounds);
+    }
+
+  //---------------------------------------------------------------------------
+  // Called before and after each execution. The locators and placements of
+  // the datasets glyphed by the last execution are kept, so that changing
+  // only the glyph parameters does not place the glyphs again.
   void Reset()
     {
     this->Bounds.Reset();
-    this->Points.clear();
-    this->Locator->Initialize();
-    this->Locator->SetDataSet(NULL);
+    this->Rewind();
+    }
+
+  // Forget the progress of IsPointVisible() on the current dataset, for it to
+  // be iterated again.
+  void Rewind()
+    {
+    this->Current = NULL;
+    this->CurrentDataSet = NULL;
+    this->NextPointId = 0;
+    }
+
+  void ReleaseUnusedDataSets()
+    {
+    this->Prune(this->Placements);
+    this->Prune(this->Centers);
+    this->UsedDataSets.clear();
+    }
+
+  //---------------------------------------------------------------------------
+  // Returns the cell centers of the dataset, computed once for each
+  // modification of the dataset.
+  vtkPolyData* GetCellCenters(vtkDataSet* ds)
+    {
+    this->UsedDataSets.insert(ds);
+    CellCenters& centers = this->Centers[ds];
+    if (centers.DataSet.GetPointer() != ds || centers.MTime != ds->GetMTime())
+      {
+      vtkNew<vtkCellCenters> cellCenters;
+      cellCenters->SetInputData(ds);
+      cellCenters->Update();
+      centers.DataSet = ds;
+      centers.MTime = ds->GetMTime();
+      centers.Centers = vtkSmartPointer<vtkPolyData>::New();
+      centers.Centers->ShallowCopy(cellCenters->GetOutput());
+      }
+    this->UsedDataSets.insert(centers.Centers.GetPointer());
+    return centers.Centers;
     }
 
   //---------------------------------------------------------------------------
@@ -143,9 +280,27 @@ public:
 
     if (!this->Bounds.IsValid())
       {
+      this->Points.clear();
+      vtkMath::UninitializeBounds(this->SampleBounds);
+      this->InvalidatePlacements();
       return;
       }
 
+    // the sample points, and the glyphs placed with them, are unchanged
+    // unless the parameters or the bounds changed.
+    double bds[6];
+    this->Bounds.GetBounds(bds);
+    if (this->SampleSeed == self->GetSeed() &&
+      this->NumberOfSamples == self->GetMaximumNumberOfSamplePoints() &&
+      std::equal(bds, bds + 6, this->SampleBounds))
+      {
+      return;
+      }
+    this->SampleSeed = self->GetSeed();
+    this->NumberOfSamples = self->GetMaximumNumberOfSamplePoints();
+    std::copy(bds, bds + 6, this->SampleBounds);
+    this->InvalidatePlacements();
+
     // build up list of points to glyph.
     vtkNew<vtkMinimalStandardRandomSequence> randomGenerator;
     randomGenerator->SetSeed(self->GetSeed());
@@ -195,16 +350,23 @@ public:
       return self->GetStride() <= 1 || (ptId % self->GetStride()) == 0;
 
     case vtkPVGlyphFilter::SPATIALLY_UNIFORM_DISTRIBUTION:
-      // This will initialize the point locator and build the list of PointIds
-      // that should be glyphed.
-      this->SetupLocator(ds);
+      {
+      // This will get the point locator and the list of PointIds that should
+      // be glyphed, building them if the dataset or the samples changed.
+      if (ds != this->CurrentDataSet)
+        {
+        this->Current = this->GetPlacement(ds);
+        this->CurrentDataSet = ds;
+        this->NextPointId = 0;
+        }
+      const std::vector<vtkIdType>& pointIds = this->Current->PointIds;
 
       // since PointIds is a sorted list, and we know that IsPointVisible will
       // be called for in monotonically increasing fashion for a specific ds, we
       // use this->NextPointId to simplify the "contains" check.
 
-      while ( (this->NextPointId < this->PointIds.size()) &&
-              (this->PointIds[this->NextPointId] < ptId) )
+      while ( (this->NextPointId < pointIds.size()) &&
+              (pointIds[this->NextPointId] < ptId) )
         {
         // this is need since it is possible (due to ghost cells or other
         // masking employed by vtkGlyph3D) that certain ptIds are never tested
@@ -212,15 +374,104 @@ public:
         this->NextPointId++;
         }
 
-      if (this->NextPointId < this->PointIds.size() &&
-        ptId == this->PointIds[this->NextPointId])
+      if (this->NextPointId < pointIds.size() &&
+        ptId == pointIds[this->NextPointId])
         {
         this->NextPointId++;
         return true;
         }
       }
+      }
     return false;
     }
+
+  //---------------------------------------------------------------------------
+  // Glyphs chunks of the points selected for glyphing, each with its own
+  // copy of the filter. A chunk is made of a polydata with the points and the
+  // point data of GLYPH_GRAIN selected points.
+  class GlyphChunks
+    {
+  public:
+    vtkDataSet* Input;
+    vtkInformationVector* SourceVector;
+    const std::vector<vtkIdType>* PointIds;
+    int PointsType;
+    int ScalarsIndex;
+    int VectorsIndex;
+    const char* PointIdsName;
+    std::vector<vtkSmartPointer<vtkPVGlyphFilter> > Filters;
+    std::vector<vtkSmartPointer<vtkPolyData> > Outputs;
+    std::vector<int> Results;
+
+    void operator()(vtkIdType begin, vtkIdType end)
+      {
+      vtkIdType numGlyphs = static_cast<vtkIdType>(this->PointIds->size());
+      vtkPointData* inPD = this->Input->GetPointData();
+      for (vtkIdType chunkId = begin; chunkId < end; ++chunkId)
+        {
+        vtkIdType first = chunkId * GLYPH_GRAIN;
+        vtkIdType count = std::min(numGlyphs - first, GLYPH_GRAIN);
+        const vtkIdType* ids = &(*this->PointIds)[first];
+
+        vtkNew<vtkPoints> points;
+        points->SetDataType(this->PointsType);
+        points->SetNumberOfPoints(count);
+        for (vtkIdType cc = 0; cc < count; ++cc)
+          {
+          double x[3];
+          this->Input->GetPoint(ids[cc], x);
+          points->SetPoint(cc, x);
+          }
+        vtkNew<vtkPolyData> chunk;
+        chunk->SetPoints(points.GetPointer());
+
+        vtkPointData* chunkPD = chunk->GetPointData();
+        for (int arrayId = 0; arrayId < inPD->GetNumberOfArrays(); ++arrayId)
+          {
+          vtkAbstractArray* array = inPD->GetAbstractArray(arrayId);
+          vtkAbstractArray* chunkArray = array->NewInstance();
+          chunkArray->SetName(array->GetName());
+          chunkArray->SetNumberOfComponents(array->GetNumberOfComponents());
+          chunkArray->CopyComponentNames(array);
+          chunkArray->SetNumberOfTuples(count);
+          for (vtkIdType cc = 0; cc < count; ++cc)
+            {
+            chunkArray->SetTuple(cc, ids[cc], array);
+            }
+          chunkPD->AddArray(chunkArray);
+          chunkArray->Delete();
+          }
+        int attributes[vtkDataSetAttributes::NUM_ATTRIBUTES];
+        inPD->GetAttributeIndices(attributes);
+        for (int type = 0; type < vtkDataSetAttributes::NUM_ATTRIBUTES; ++type)
+          {
+          if (attributes[type] >= 0)
+            {
+            chunkPD->SetActiveAttribute(attributes[type], type);
+            }
+          }
+
+        vtkPolyData* output = vtkPolyData::New();
+        this->Outputs[chunkId].TakeReference(output);
+        this->Results[chunkId] = this->Filters[chunkId]->Execute(
+          chunk.GetPointer(), this->SourceVector, output,
+          this->ScalarsIndex >= 0 ? chunkPD->GetArray(this->ScalarsIndex) : NULL,
+          this->VectorsIndex >= 0 ? chunkPD->GetArray(this->VectorsIndex) : NULL)? 1 : 0;
+
+        // the generated point ids are those of the chunk.
+        vtkIdTypeArray* outputIds = this->PointIdsName ? vtkIdTypeArray::SafeDownCast(
+          output->GetPointData()->GetArray(this->PointIdsName)) : NULL;
+        if (outputIds)
+          {
+          vtkIdType* values = outputIds->GetPointer(0);
+          for (vtkIdType cc = 0, max = outputIds->GetNumberOfTuples(); cc < max; ++cc)
+            {
+            values[cc] = ids[values[cc]];
+            }
+          }
+        }
+      }
+    };
 };
 
 vtkStandardNewMacro(vtkPVGlyphFilter);
@@ -343,7 +594,9 @@ int vtkPVGlyphFilter::RequestData(
       }
     else
       {
-      return this->Execute(ds, sourceVector, outputPD)? 1 : 0;
+      return this->ExecuteGlyphs(ds, sourceVector, outputPD,
+        this->GetInputArrayToProcess(0, ds),
+        this->GetInputArrayToProcess(1, ds))? 1 : 0;
       }
     }
   else if (cds)
@@ -383,12 +636,15 @@ int vtkPVGlyphFilter::RequestData(
           }
         else
           {
-         res = this->Execute(currentDS, sourceVector, outputPD.GetPointer());
+          res = this->ExecuteGlyphs(currentDS, sourceVector, outputPD.GetPointer(),
+            this->GetInputArrayToProcess(0, currentDS),
+            this->GetInputArrayToProcess(1, currentDS));
           }
         if (!res)
           {
           vtkErrorMacro("Glyph generation failed for block: " << iter->GetCurrentFlatIndex());
           this->Internals->Reset();
+          this->Internals->ReleaseUnusedDataSets();
           return 0;
           }
         outputMD->SetDataSet(iter, outputPD.GetPointer());
@@ -396,6 +652,7 @@ int vtkPVGlyphFilter::RequestData(
       }
     }
   this->Internals->Reset();
+  this->Internals->ReleaseUnusedDataSets();
   return 1;
 }
 
@@ -442,15 +699,121 @@ bool vtkPVGlyphFilter::ExecuteWithCellCenters(vtkDataSet* input,
                                               vtkInformationVector* sourceVector,
                                               vtkPolyData* output)
 {
-  vtkNew<vtkCellCenters> cellCenters;
-  cellCenters->SetInputData(input);
-  cellCenters->Update();
-  input = cellCenters->GetOutput();
+  input = this->Internals->GetCellCenters(input);
   vtkDataArray* inSScalars = input->GetPointData()->GetArray(
     this->GetInputArrayInformation(0)->Get(vtkDataObject::FIELD_NAME()));
   vtkDataArray* inVectors = input->GetPointData()->GetArray(
     this->GetInputArrayInformation(1)->Get(vtkDataObject::FIELD_NAME()));
-  return this->Execute(input, sourceVector, output, inSScalars, inVectors);
+  return this->ExecuteGlyphs(input, sourceVector, output, inSScalars, inVectors);
+}
+
+//-----------------------------------------------------------------------------
+bool vtkPVGlyphFilter::ExecuteGlyphs(vtkDataSet* input,
+                                     vtkInformationVector* sourceVector,
+                                     vtkPolyData* output,
+                                     vtkDataArray* inSScalars,
+                                     vtkDataArray* inVectors)
+{
+  // the arrays are passed to the chunks by index in the point data, and the
+  // glyphs indexed among several sources are generated serially.
+  vtkPointData* inPD = input->GetPointData();
+  int scalarsIndex = -1;
+  int vectorsIndex = -1;
+  for (int cc = 0; cc < inPD->GetNumberOfArrays(); ++cc)
+    {
+    vtkAbstractArray* array = inPD->GetAbstractArray(cc);
+    scalarsIndex = (inSScalars && array == inSScalars)? cc : scalarsIndex;
+    vectorsIndex = (inVectors && array == inVectors)? cc : vectorsIndex;
+    }
+  if ((inSScalars && scalarsIndex < 0) || (inVectors && vectorsIndex < 0) ||
+    this->IndexMode != VTK_INDEXING_OFF)
+    {
+    return this->Superclass::Execute(input, sourceVector, output, inSScalars, inVectors);
+    }
+
+  // the points to glyph.
+  std::vector<vtkIdType> pointIds;
+  vtkIdType numPts = input->GetNumberOfPoints();
+  for (vtkIdType ptId = 0; ptId < numPts; ++ptId)
+    {
+    if (this->IsPointVisible(input, ptId))
+      {
+      pointIds.push_back(ptId);
+      }
+    }
+  this->Internals->Rewind();
+  if (pointIds.empty())
+    {
+    return this->Superclass::Execute(input, sourceVector, output, inSScalars, inVectors);
+    }
+
+  vtkIdType numGlyphs = static_cast<vtkIdType>(pointIds.size());
+  vtkIdType numChunks = (numGlyphs + GLYPH_GRAIN - 1) / GLYPH_GRAIN;
+  vtkInternals::GlyphChunks chunks;
+  chunks.Input = input;
+  chunks.SourceVector = sourceVector;
+  chunks.PointIds = &pointIds;
+  vtkPointSet* ps = vtkPointSet::SafeDownCast(input);
+  chunks.PointsType = (ps && ps->GetPoints())? ps->GetPoints()->GetDataType() : VTK_FLOAT;
+  chunks.ScalarsIndex = scalarsIndex;
+  chunks.VectorsIndex = vectorsIndex;
+  chunks.PointIdsName = this->GeneratePointIds? this->PointIdsName : NULL;
+  chunks.Outputs.resize(numChunks);
+  chunks.Results.resize(numChunks, 0);
+
+  // each chunk is glyphed by a copy of this filter, glyphing all its points.
+  for (vtkIdType cc = 0; cc < numChunks; ++cc)
+    {
+    vtkSmartPointer<vtkPVGlyphFilter> filter = vtkSmartPointer<vtkPVGlyphFilter>::New();
+    filter->SetController(NULL);
+    filter->SetScaling(this->Scaling);
+    filter->SetScaleMode(this->ScaleMode);
+    filter->SetColorMode(this->ColorMode);
+    filter->SetScaleFactor(this->ScaleFactor);
+    filter->SetRange(this->Range);
+    filter->SetOrient(this->Orient);
+    filter->SetClamping(this->Clamping);
+    filter->SetVectorMode(this->VectorMode);
+    filter->SetIndexMode(this->IndexMode);
+    filter->SetGeneratePointIds(this->GeneratePointIds);
+    filter->SetPointIdsName(this->PointIdsName);
+    filter->SetFillCellData(this->FillCellData);
+    filter->SetOutputPointsPrecision(this->OutputPointsPrecision);
+    if (this->SourceTransform)
+      {
+      vtkNew<vtkTransform> transform;
+      transform->DeepCopy(this->SourceTransform);
+      filter->SetSourceTransform(transform.GetPointer());
+      }
+    for (int idx = 0; idx < 4; ++idx)
+      {
+      filter->SetInputArrayToProcess(idx, this->GetInputArrayInformation(idx));
+      }
+    chunks.Filters.push_back(filter);
+    }
+
+  // the chunks share the source, whose cells are otherwise built lazily by
+  // the first access from any of the threads.
+  vtkPolyData* source = this->GetSource(0, sourceVector);
+  if (source && source->NeedToBuildCells())
+    {
+    source->BuildCells();
+    }
+
+  vtkSMPTools::For(0, numChunks, 1, chunks);
+
+  vtkNew<vtkAppendPolyData> appender;
+  for (vtkIdType cc = 0; cc < numChunks; ++cc)
+    {
+    if (!chunks.Results[cc])
+      {
+      return false;
+      }
+    appender->AddInputData(chunks.Outputs[cc]);
+    }
+  appender->Update();
+  output->ShallowCopy(appender->GetOutput());
+  return true;
 }
 
 //-----------------------------------------------------------------------------
@@ -32,7 +32,11 @@
 // can be used to limit the number of sample points used for random sampling. This
 // doesn't not equal the number of points actually glyphed, since that depends on
 // several factors. In parallel, this filter ensures that spatial bounds are collected
-// across all ranks for generating identical sample points.
+// across all ranks for generating identical sample points. The point locators
+// and the points to glyph are kept between executions, and only computed again
+// when the input, the seed or the number of sample points change.
+//
+// The glyphs are generated in parallel using vtkSMPTools.
 
 #ifndef vtkPVGlyphFilter_h
 #define vtkPVGlyphFilter_h
@@ -120,6 +124,16 @@ protected:
                                       vtkInformationVector* sourceVector,
                                       vtkPolyData* output);
 
+  // Description:
+  // Method called in RequestData() to glyph the points of \c input selected
+  // by the glyph mode. The points are glyphed in chunks, in parallel using
+  // vtkSMPTools, by copies of this filter.
+  virtual bool ExecuteGlyphs(vtkDataSet* input,
+                             vtkInformationVector* sourceVector,
+                             vtkPolyData* output,
+                             vtkDataArray* inSScalars,
+                             vtkDataArray* inVectors);
+
   int GlyphMode;
   int MaximumNumberOfSamplePoints;
   int Seed;
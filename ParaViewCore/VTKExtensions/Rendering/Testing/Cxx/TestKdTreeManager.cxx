@@ -0,0 +1,161 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestKdTreeManager.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Regenerates the kd-tree of a distributed sphere after changing its scalars,
+// after slightly deforming it and after moving all its cells in a corner, and
+// checks that the cuts are reused in the first two cases only. The data is
+// redistributed with the first cuts and again with the reused ones, which must
+// give the same cells on each process.
+
+#include "vtkCommunicator.h"
+#include "vtkDataSet.h"
+#include "vtkFloatArray.h"
+#include "vtkKdTreeManager.h"
+#include "vtkMPIController.h"
+#include "vtkNew.h"
+#include "vtkOrderedCompositeDistributor.h"
+#include "vtkPKdTree.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphereSource.h"
+
+#include <iostream>
+
+namespace
+{
+  vtkIdType Redistribute(vtkPolyData* data, vtkPKdTree* tree)
+    {
+    vtkNew<vtkOrderedCompositeDistributor> redistributor;
+    redistributor->SetController(
+      vtkMultiProcessController::GetGlobalController());
+    redistributor->SetInputData(data);
+    redistributor->SetPKdTree(tree);
+    redistributor->SetPassThrough(0);
+    redistributor->Update();
+    vtkDataSet* output =
+      vtkDataSet::SafeDownCast(redistributor->GetOutputDataObject(0));
+    return output? output->GetNumberOfCells() : -1;
+    }
+
+  // Moves the points to center + factor * (point - center).
+  void ScalePoints(vtkPolyData* data, double factor, const double center[3])
+    {
+    vtkPoints* points = data->GetPoints();
+    double pt[3];
+    for (vtkIdType cc=0; cc < points->GetNumberOfPoints(); cc++)
+      {
+      points->GetPoint(cc, pt);
+      for (int i=0; i < 3; i++)
+        {
+        pt[i] = center[i] + factor * (pt[i] - center[i]);
+        }
+      points->SetPoint(cc, pt);
+      }
+    points->Modified();
+    }
+
+  void Regenerate(vtkKdTreeManager* manager, vtkPolyData* data)
+    {
+    manager->RemoveAllDataObjects();
+    manager->AddDataObject(data);
+    manager->GenerateKdTree();
+    }
+}
+
+#define TEST_ASSERT(condition, message) \
+  if (!(condition)) \
+    { \
+    std::cerr << "ERROR: " << message << std::endl; \
+    status = 0; \
+    }
+
+int TestKdTreeManager(int argc, char* argv[])
+{
+  vtkNew<vtkMPIController> controller;
+  controller->Initialize(&argc, &argv, 0);
+  vtkMultiProcessController::SetGlobalController(controller.GetPointer());
+  int rank = controller->GetLocalProcessId();
+  int numProcs = controller->GetNumberOfProcesses();
+  int status = 1;
+
+    {
+    vtkNew<vtkSphereSource> sphere;
+    sphere->SetThetaResolution(64);
+    sphere->SetPhiResolution(64);
+    sphere->UpdatePiece(rank, numProcs, 0);
+    vtkNew<vtkPolyData> data;
+    data->DeepCopy(sphere->GetOutput());
+    vtkNew<vtkFloatArray> scalars;
+    scalars->SetName("Scalars");
+    scalars->SetNumberOfTuples(data->GetNumberOfPoints());
+    scalars->FillComponent(0, 0.0);
+    data->GetPointData()->SetScalars(scalars.GetPointer());
+
+    vtkNew<vtkKdTreeManager> manager;
+    Regenerate(manager.GetPointer(), data.GetPointer());
+    unsigned long cutsTime = manager->GetCutsMTime();
+    vtkIdType firstCells = Redistribute(data.GetPointer(), manager->GetKdTree());
+    TEST_ASSERT(firstCells >= 0, "Redistribution failed.");
+
+    // Only the scalars change: the cuts are reused, and redistributing again
+    // gives the same cells.
+    scalars->FillComponent(0, 1.0);
+    scalars->Modified();
+    Regenerate(manager.GetPointer(), data.GetPointer());
+    TEST_ASSERT(manager->GetCutsMTime() == cutsTime,
+      "The cuts were regenerated after a scalars change.");
+    vtkIdType secondCells =
+      Redistribute(data.GetPointer(), manager->GetKdTree());
+    TEST_ASSERT(secondCells == firstCells,
+      "Redistributing with the reused cuts gave " << secondCells
+      << " cells instead of " << firstCells << ".");
+
+    // A slight deformation keeps the cells inside the tree and balanced: the
+    // cuts are reused.
+    double center[3] = { 0.0, 0.0, 0.0 };
+    ScalePoints(data.GetPointer(), 0.98, center);
+    Regenerate(manager.GetPointer(), data.GetPointer());
+    TEST_ASSERT(manager->GetCutsMTime() == cutsTime,
+      "The cuts were regenerated after a slight deformation.");
+    TEST_ASSERT(Redistribute(data.GetPointer(), manager->GetKdTree()) >= 0,
+      "Redistribution with the reused cuts failed.");
+
+    // All the cells in a corner of the tree unbalance the processes: the cuts
+    // are regenerated.
+    if (numProcs > 1)
+      {
+      double corner[3] = { 0.45, 0.45, 0.45 };
+      ScalePoints(data.GetPointer(), 0.05, corner);
+      Regenerate(manager.GetPointer(), data.GetPointer());
+      TEST_ASSERT(manager->GetCutsMTime() > cutsTime,
+        "The cuts were reused for unbalanced cells.");
+      }
+
+    // Without IncrementalUpdate, the cuts are always regenerated.
+    cutsTime = manager->GetCutsMTime();
+    manager->IncrementalUpdateOff();
+    Regenerate(manager.GetPointer(), data.GetPointer());
+    TEST_ASSERT(manager->GetCutsMTime() > cutsTime,
+      "The cuts were reused with IncrementalUpdate off.");
+    }
+
+  int globalStatus = 0;
+  controller->AllReduce(&status, &globalStatus, 1, vtkCommunicator::MIN_OP);
+
+  vtkMultiProcessController::SetGlobalController(NULL);
+  controller->Finalize();
+  return globalStatus ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -20,6 +20,8 @@
 #include "vtkPythonInterpreter.h"
 #endif
 
+#include <sstream>
+
 
 vtkStandardNewMacro(vtkCinemaExporter);
 
@@ -29,6 +31,9 @@ vtkCinemaExporter::vtkCinemaExporter()
 , ViewSelection(NULL)
 , TrackSelection(NULL)
 , ArraySelection(NULL)
+, Resume(false)
+, PartitionIndex(0)
+, NumberOfPartitions(1)
 {
 }
 
@@ -48,6 +53,12 @@ void vtkCinemaExporter::WriteData()
     return;
     }
 
+  if (this->PartitionIndex >= this->NumberOfPartitions)
+    {
+    vtkErrorMacro(<< "PartitionIndex must be less than NumberOfPartitions!");
+    return;
+    }
+
   if (!this->checkInterpreterInitialization())
     {
     return;
@@ -108,7 +119,14 @@ const vtkStdString vtkCinemaExporter::GetPythonScript()
   script += this->TrackSelection ? this->TrackSelection : "";
   script += "}, arraySelection={";
   script += this->ArraySelection ? this->ArraySelection : "";
-  script += "})\n";
+  script += "}";
+
+  std::ostringstream options;
+  options << ", resume=" << (this->Resume ? "True" : "False")
+    << ", partitionIndex=" << this->PartitionIndex
+    << ", numberOfPartitions=" << this->NumberOfPartitions;
+  script += options.str();
+  script += ")\n";
 
   return script;
 }
@@ -129,5 +147,9 @@ void vtkCinemaExporter::PrintSelf(ostream& os, vtkIndent indent)
   char const * arr = this->ArraySelection ? this->ArraySelection : "(null)";
   os << indent << "ArraySelection: " << arr << '\n';
 
+  os << indent << "Resume: " << this->Resume << '\n';
+  os << indent << "PartitionIndex: " << this->PartitionIndex << '\n';
+  os << indent << "NumberOfPartitions: " << this->NumberOfPartitions << '\n';
+
   os << indent << "PythonScript: " << this->GetPythonScript().c_str() << "\n";
 }
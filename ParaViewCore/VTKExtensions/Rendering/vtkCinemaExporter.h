@@ -47,6 +47,26 @@ public:
   vtkSetStringMacro(ArraySelection);
   vtkGetStringMacro(ArraySelection);
 
+  // Description:
+  // When set, images already present in the Cinema database are not rendered
+  // again and timesteps with all their images present are not loaded. This
+  // makes it possible to resume an interrupted export, or to add timesteps to
+  // an existing database. Off by default.
+  vtkSetMacro(Resume, bool);
+  vtkGetMacro(Resume, bool);
+  vtkBooleanMacro(Resume, bool);
+
+  // Description:
+  // Split the export among NumberOfPartitions independent processes, e.g.
+  // several pvbatch jobs writing to a shared file system. Timesteps (or images
+  // when there is no time) are assigned round-robin and only the ones for
+  // PartitionIndex are rendered. Only partition 0 writes info.json.
+  // Defaults to a single partition.
+  vtkSetClampMacro(PartitionIndex, int, 0, VTK_INT_MAX);
+  vtkGetMacro(PartitionIndex, int);
+  vtkSetClampMacro(NumberOfPartitions, int, 1, VTK_INT_MAX);
+  vtkGetMacro(NumberOfPartitions, int);
+
 protected:
   vtkCinemaExporter();
   ~vtkCinemaExporter();
@@ -63,6 +83,12 @@ protected:
 
   char* ArraySelection;
 
+  bool Resume;
+
+  int PartitionIndex;
+
+  int NumberOfPartitions;
+
 private:
   /// @brief Defines the Python script to be ran.
   const vtkStdString GetPythonScript();
@@ -15,6 +15,7 @@
 #include "vtkKdTreeManager.h"
 
 #include "vtkBoundingBox.h"
+#include "vtkCommunicator.h"
 #include "vtkCompositeDataIterator.h"
 #include "vtkCompositeDataSet.h"
 #include "vtkExtentTranslator.h"
@@ -28,12 +29,68 @@
 #include "vtkSphereSource.h"
 #include "vtkUnstructuredGrid.h"
 
+#include <algorithm>
 #include <set>
 #include <vector>
 
 class vtkKdTreeManager::vtkDataObjectSet : 
   public std::set<vtkSmartPointer<vtkDataObject> > {};
 
+namespace
+{
+  // FNV-1a hashing of raw bytes, used to build geometry signatures.
+  class vtkSignature
+    {
+  public:
+    vtkSignature() : Value(14695981039346656037ULL) {}
+
+    void Add(const void* data, size_t length)
+      {
+      const unsigned char* bytes = static_cast<const unsigned char*>(data);
+      for (size_t cc=0; cc < length; ++cc)
+        {
+        this->Value ^= bytes[cc];
+        this->Value *= 1099511628211ULL;
+        }
+      }
+
+    template <class T>
+    void Add(const T& value)
+      {
+      this->Add(&value, sizeof(T));
+      }
+
+    vtkTypeUInt64 Value;
+    };
+
+  // Collects the non-null leaf datasets of a data object.
+  void GetLeafDataSets(vtkDataObject* data, std::vector<vtkDataSet*>& leaves)
+    {
+    vtkCompositeDataSet* cd = vtkCompositeDataSet::SafeDownCast(data);
+    if (!cd)
+      {
+      if (vtkDataSet* ds = vtkDataSet::SafeDownCast(data))
+        {
+        leaves.push_back(ds);
+        }
+      return;
+      }
+    vtkCompositeDataIterator* iter = cd->NewIterator();
+    for (iter->InitTraversal(); !iter->IsDoneWithTraversal();
+      iter->GoToNextItem())
+      {
+      if (vtkDataSet* ds = vtkDataSet::SafeDownCast(iter->GetCurrentDataObject()))
+        {
+        leaves.push_back(ds);
+        }
+      }
+    iter->Delete();
+    }
+
+  // Maximum number of points sampled per dataset for the geometry signature.
+  const vtkIdType MAX_SIGNATURE_SAMPLES = 4096;
+}
+
 vtkStandardNewMacro(vtkKdTreeManager);
 //----------------------------------------------------------------------------
 vtkKdTreeManager::vtkKdTreeManager()
@@ -49,6 +106,11 @@ vtkKdTreeManager::vtkKdTreeManager()
   this->NumberOfPieces = globalController?
     globalController->GetNumberOfProcesses() : 1;
   this->KdTreeInitialized = false;
+  this->IncrementalUpdate = true;
+  this->RebalanceTolerance = 0.25;
+  this->CutsValid = false;
+  this->CutsUseExtentTranslator = false;
+  this->GeometrySignature = 0;
 
   vtkPKdTree* tree = vtkPKdTree::New();
   tree->SetController(globalController);
@@ -92,6 +154,7 @@ void vtkKdTreeManager::SetKdTree(vtkPKdTree* tree)
     {
     vtkSetObjectBodyMacro(KdTree, vtkPKdTree, tree);
     this->KdTreeInitialized = false;
+    this->CutsValid = false;
     }
 }
 
@@ -108,9 +171,30 @@ void vtkKdTreeManager::SetStructuredDataInformation(
   this->Modified();
 }
 
+//----------------------------------------------------------------------------
+void vtkKdTreeManager::RemoveStructuredDataInformation()
+{
+  if (this->ExtentTranslator)
+    {
+    this->ExtentTranslator = NULL;
+    this->Modified();
+    }
+}
+
 //----------------------------------------------------------------------------
 void vtkKdTreeManager::GenerateKdTree()
 {
+  vtkTypeUInt64 signature = this->ComputeGeometrySignature();
+  if (this->CanReuseCuts(signature))
+    {
+    // the cuts are still good, leave CutsTime untouched so that the data
+    // redistributed with these cuts is reused. The datasets are only needed
+    // to build the cuts, release them.
+    this->KdTree->RemoveAllDataSets();
+    this->GeometrySignature = signature;
+    return;
+    }
+
   this->KdTree->RemoveAllDataSets();
   if (!this->KdTreeInitialized)
     {
@@ -171,6 +255,174 @@ void vtkKdTreeManager::GenerateKdTree()
 
   this->KdTree->BuildLocator();
   //this->KdTree->PrintTree();
+
+  this->CutsValid = true;
+  this->CutsUseExtentTranslator = (this->ExtentTranslator != NULL);
+  this->GeometrySignature = signature;
+  this->CutsTime.Modified();
+}
+
+//----------------------------------------------------------------------------
+vtkTypeUInt64 vtkKdTreeManager::ComputeGeometrySignature()
+{
+  vtkSignature signature;
+  signature.Add(this->NumberOfPieces);
+  if (this->ExtentTranslator)
+    {
+    // the cuts only depend on the structured data information.
+    signature.Add(this->ExtentTranslator.GetPointer());
+    signature.Add(this->WholeExtent, sizeof(this->WholeExtent));
+    signature.Add(this->Origin, sizeof(this->Origin));
+    signature.Add(this->Spacing, sizeof(this->Spacing));
+    return signature.Value;
+    }
+
+  std::vector<vtkDataSet*> leaves;
+  for (vtkDataObjectSet::iterator iter = this->DataObjects->begin();
+    iter != this->DataObjects->end(); ++iter)
+    {
+    GetLeafDataSets(iter->GetPointer(), leaves);
+    }
+
+  // vtkDataObjectSet is ordered by pointer, which differs between updates.
+  // Combine the per-dataset signatures in an order independent way.
+  std::vector<vtkTypeUInt64> values;
+  for (size_t cc=0; cc < leaves.size(); ++cc)
+    {
+    vtkDataSet* ds = leaves[cc];
+    vtkSignature dsSignature;
+    vtkIdType numPoints = ds->GetNumberOfPoints();
+    vtkIdType numCells = ds->GetNumberOfCells();
+    double bounds[6];
+    ds->GetBounds(bounds);
+    dsSignature.Add(numPoints);
+    dsSignature.Add(numCells);
+    dsSignature.Add(bounds, sizeof(bounds));
+
+    // sample point coordinates, enough to notice deformed geometry without
+    // paying for a full pass over large datasets.
+    vtkIdType step = std::max<vtkIdType>(1, numPoints / MAX_SIGNATURE_SAMPLES);
+    double pt[3];
+    for (vtkIdType ptId=0; ptId < numPoints; ptId += step)
+      {
+      ds->GetPoint(ptId, pt);
+      dsSignature.Add(pt, sizeof(pt));
+      }
+    values.push_back(dsSignature.Value);
+    }
+  std::sort(values.begin(), values.end());
+  for (size_t cc=0; cc < values.size(); ++cc)
+    {
+    signature.Add(values[cc]);
+    }
+  return signature.Value;
+}
+
+//----------------------------------------------------------------------------
+bool vtkKdTreeManager::CanReuseCuts(vtkTypeUInt64 signature)
+{
+  bool hasTranslator = (this->ExtentTranslator != NULL);
+  if (!this->IncrementalUpdate || !this->CutsValid ||
+    !this->KdTree->GetCuts() ||
+    hasTranslator != this->CutsUseExtentTranslator)
+    {
+    return false;
+    }
+
+  vtkMultiProcessController *controller = this->KdTree->GetController();
+
+  // same geometry everywhere, e.g. only the scalars changed.
+  int sameGeometry = (signature == this->GeometrySignature)? 1 : 0;
+  int allSameGeometry = sameGeometry;
+  if (controller)
+    {
+    controller->AllReduce(&sameGeometry, &allSameGeometry, 1,
+                          vtkCommunicator::MIN_OP);
+    }
+  if (allSameGeometry)
+    {
+    return true;
+    }
+
+  if (hasTranslator)
+    {
+    // the structured partitioning changed, the cuts must follow.
+    return false;
+    }
+
+  return this->CutsAreBalanced();
+}
+
+//----------------------------------------------------------------------------
+bool vtkKdTreeManager::CutsAreBalanced()
+{
+  vtkMultiProcessController *controller = this->KdTree->GetController();
+  int numProcs = controller? controller->GetNumberOfProcesses() : 1;
+  int* regionMap = this->KdTree->GetRegionAssignmentMap();
+  int regionMapLength = this->KdTree->GetRegionAssignmentMapLength();
+  if (!regionMap || regionMapLength <= 0)
+    {
+    return false;
+    }
+
+  // count the cells each process would own with the current cuts. The last
+  // entry counts the cells that fall outside of the tree.
+  std::vector<vtkIdType> localCounts(numProcs + 1, 0);
+  std::vector<vtkDataSet*> leaves;
+  for (vtkDataObjectSet::iterator iter = this->DataObjects->begin();
+    iter != this->DataObjects->end(); ++iter)
+    {
+    GetLeafDataSets(iter->GetPointer(), leaves);
+    }
+  double bounds[6];
+  for (size_t cc=0; cc < leaves.size(); ++cc)
+    {
+    vtkDataSet* ds = leaves[cc];
+    vtkIdType numCells = ds->GetNumberOfCells();
+    for (vtkIdType cellId=0; cellId < numCells; ++cellId)
+      {
+      ds->GetCellBounds(cellId, bounds);
+      int region = this->KdTree->GetRegionContainingPoint(
+        0.5*(bounds[0]+bounds[1]), 0.5*(bounds[2]+bounds[3]),
+        0.5*(bounds[4]+bounds[5]));
+      int owner = (region >= 0 && region < regionMapLength)?
+        regionMap[region] : -1;
+      if (owner >= 0 && owner < numProcs)
+        {
+        localCounts[owner]++;
+        }
+      else
+        {
+        localCounts[numProcs]++;
+        }
+      }
+    }
+
+  std::vector<vtkIdType> counts(localCounts);
+  if (controller)
+    {
+    controller->AllReduce(&localCounts[0], &counts[0], numProcs + 1,
+                          vtkCommunicator::SUM_OP);
+    }
+  if (counts[numProcs] > 0)
+    {
+    // some cells are outside of the current tree.
+    return false;
+    }
+
+  vtkIdType total = 0;
+  vtkIdType maxCount = 0;
+  for (int cc=0; cc < numProcs; ++cc)
+    {
+    total += counts[cc];
+    maxCount = std::max(maxCount, counts[cc]);
+    }
+  if (total == 0)
+    {
+    return true;
+    }
+  double average = static_cast<double>(total) / numProcs;
+  return (maxCount <= average * (1.0 + this->RebalanceTolerance));
 }
 
 //-----------------------------------------------------------------------------
@@ -289,6 +541,8 @@ void vtkKdTreeManager::PrintSelf(ostream& os, vtkIndent indent)
   this->Superclass::PrintSelf(os, indent);
   os << indent << "KdTree: " << this->KdTree << endl;
   os << indent << "NumberOfPieces: " << this->NumberOfPieces << endl;
+  os << indent << "IncrementalUpdate: " << this->IncrementalUpdate << endl;
+  os << indent << "RebalanceTolerance: " << this->RebalanceTolerance << endl;
 }
 
 
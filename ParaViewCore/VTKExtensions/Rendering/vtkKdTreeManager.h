@@ -21,6 +21,13 @@
 // translator. This class manages this logic. When structure data's extent
 // translator is to be used, it simply uses vtkKdTreeGenerator. Otherwise, it
 // lets the vtkPKdTree build the optimal partitioning for the data.
+//
+// The manager is meant to be kept around between renders. When
+// IncrementalUpdate is on, GenerateKdTree() reuses the existing cuts if the
+// geometry of the data objects is unchanged (e.g. only scalars changed), or if
+// the existing cuts still balance the cells across processes within
+// RebalanceTolerance. GetCutsMTime() only changes when the cuts are
+// regenerated, so that data redistributed with the old cuts can be reused.
 
 #ifndef vtkKdTreeManager_h
 #define vtkKdTreeManager_h
@@ -43,17 +50,19 @@ public:
   void PrintSelf(ostream& os, vtkIndent indent);
 
   // Description:
-  // Add data objects.
+  // Add/remove data objects.
   void AddDataObject(vtkDataObject*);
   void RemoveAllDataObjects();
 
   // Description:
   // Set the optional extent translator to use to get aid in building the
-  // KdTree.
+  // KdTree. RemoveStructuredDataInformation() stops using it, e.g. when the
+  // manager is reused for data without structured data information.
   void SetStructuredDataInformation(
     vtkExtentTranslator* translator,
     const int whole_extent[6],
     const double origin[3], const double spacing[3]);
+  void RemoveStructuredDataInformation();
 
   // Description:
   // Get/Set the KdTree managed by this manager.
@@ -68,9 +77,29 @@ public:
   vtkGetMacro(NumberOfPieces, int);
 
   // Description:
-  // Rebuilds the KdTree.
+  // When on (default), GenerateKdTree() reuses the current cuts whenever
+  // possible instead of always rebuilding them.
+  vtkSetMacro(IncrementalUpdate, bool);
+  vtkGetMacro(IncrementalUpdate, bool);
+  vtkBooleanMacro(IncrementalUpdate, bool);
+
+  // Description:
+  // When the geometry changed, the current cuts are kept as long as the most
+  // loaded process has no more than (1 + RebalanceTolerance) times the average
+  // number of cells. Defaults to 0.25.
+  vtkSetClampMacro(RebalanceTolerance, double, 0.0, VTK_DOUBLE_MAX);
+  vtkGetMacro(RebalanceTolerance, double);
+
+  // Description:
+  // Rebuilds the KdTree, or reuses the current cuts when IncrementalUpdate is
+  // on and they are still valid.
   void GenerateKdTree();
 
+  // Description:
+  // Returns the time at which the cuts were last regenerated.
+  unsigned long GetCutsMTime() const
+    { return this->CutsTime.GetMTime(); }
+
 protected:
   vtkKdTreeManager();
   ~vtkKdTreeManager();
@@ -78,10 +107,34 @@ protected:
   void AddDataObjectToKdTree(vtkDataObject *data);
   void AddDataSetToKdTree(vtkDataSet *data);
 
+  // Description:
+  // Returns true if the current cuts can be used for the current data objects
+  // and structured data information, given their current geometry signature.
+  // Must be called on all processes.
+  bool CanReuseCuts(vtkTypeUInt64 signature);
+
+  // Description:
+  // Returns true if, with the current cuts, the cells of the data objects are
+  // all inside the tree and balanced across processes within
+  // RebalanceTolerance. Must be called on all processes.
+  bool CutsAreBalanced();
+
+  // Description:
+  // Computes a signature of the geometry and of the structured data
+  // information, ignoring the point and cell attributes.
+  vtkTypeUInt64 ComputeGeometrySignature();
+
   bool KdTreeInitialized;
   vtkPKdTree* KdTree;
   int NumberOfPieces;
 
+  bool IncrementalUpdate;
+  double RebalanceTolerance;
+  bool CutsValid;
+  bool CutsUseExtentTranslator;
+  vtkTypeUInt64 GeometrySignature;
+  vtkTimeStamp CutsTime;
+
   vtkSmartPointer<vtkExtentTranslator> ExtentTranslator;
   double Origin[3];
   double Spacing[3];
@@ -25,10 +25,14 @@
 #include "vtkOrderedCompositeDistributor.h"
 #include "vtkPVConfig.h" // needed for PARAVIEW_USE_MPI 
 
+#include "vtkAppendFilter.h"
 #include "vtkBSPCuts.h"
 #include "vtkCallbackCommand.h"
 #include "vtkDataObjectTypes.h"
+#include "vtkExtractCells.h"
+#include "vtkIdList.h"
 #include "vtkInformation.h"
+#include "vtkIntArray.h"
 #include "vtkInformationVector.h"
 #include "vtkMath.h"
 #include "vtkMultiProcessController.h"
@@ -37,8 +41,11 @@
 #include "vtkPKdTree.h"
 #include "vtkPolyData.h"
 #include "vtkDataSetSurfaceFilter.h"
+#include "vtkSmartPointer.h"
 #include "vtkUnstructuredGrid.h"
 
+#include <vector>
+
 #ifdef PARAVIEW_USE_MPI
 # include "vtkDistributedDataFilter.h"
 #endif
@@ -69,6 +76,7 @@ vtkOrderedCompositeDistributor::vtkOrderedCompositeDistributor()
   this->PKdTree = NULL;
   this->Controller = NULL;
   this->PassThrough = false;
+  this->MoveOnlyNonLocalCells = true;
   this->OutputType = NULL;
   this->SetController(vtkMultiProcessController::GetGlobalController());
 }
@@ -88,6 +96,8 @@ void vtkOrderedCompositeDistributor::PrintSelf(ostream &os, vtkIndent indent)
   os << indent << "PKdTree: " << this->PKdTree << endl;
   os << indent << "Controller: " << this->Controller << endl;
   os << indent << "PassThrough: " << this->PassThrough << endl;
+  os << indent << "MoveOnlyNonLocalCells: " << this->MoveOnlyNonLocalCells
+     << endl;
   os << indent << "OutputType: " << 
     (this->OutputType? this->OutputType : "(none)") << endl;
 }
@@ -204,6 +214,43 @@ int vtkOrderedCompositeDistributor::RequestData(
 
   this->UpdateProgress(0.01);
 
+  // Only the cells that are not already owned by this process need to move.
+  vtkSmartPointer<vtkDataSet> cellsToMove = input;
+  vtkSmartPointer<vtkDataSet> cellsToKeep;
+  if (this->MoveOnlyNonLocalCells)
+    {
+    vtkNew<vtkIdList> localCells;
+    vtkNew<vtkIdList> nonLocalCells;
+    this->SplitLocalCells(input, localCells.GetPointer(),
+      nonLocalCells.GetPointer());
+
+    vtkIdType numNonLocal = nonLocalCells->GetNumberOfIds();
+    vtkIdType totalNonLocal = 0;
+    this->Controller->AllReduce(&numNonLocal, &totalNonLocal, 1,
+      vtkCommunicator::SUM_OP);
+    if (totalNonLocal == 0)
+      {
+      // every cell is already where it belongs.
+      output->ShallowCopy(input);
+      return 1;
+      }
+
+    if (localCells->GetNumberOfIds() > 0)
+      {
+      vtkNew<vtkExtractCells> keeper;
+      keeper->SetInputData(input);
+      keeper->SetCellList(localCells.GetPointer());
+      keeper->Update();
+      cellsToKeep = keeper->GetOutput();
+
+      vtkNew<vtkExtractCells> mover;
+      mover->SetInputData(input);
+      mover->SetCellList(nonLocalCells.GetPointer());
+      mover->Update();
+      cellsToMove = mover->GetOutput();
+      }
+    }
+
   vtkNew<vtkDistributedDataFilter> d3;
 
   // add progress observer.
@@ -213,7 +260,7 @@ int vtkOrderedCompositeDistributor::RequestData(
   d3->AddObserver(vtkCommand::ProgressEvent, cbc.GetPointer());
 
   d3->SetBoundaryModeToSplitBoundaryCells();
-  d3->SetInputData(input);
+  d3->SetInputData(cellsToMove);
   d3->SetCuts(cuts);
 
   // We need to pass the region assignments from PKdTree to D3
@@ -225,8 +272,19 @@ int vtkOrderedCompositeDistributor::RequestData(
   //d3->SetClipAlgorithmType(vtkDistributedDataFilter::USE_TABLEBASEDCLIPDATASET);
   d3->Update();
 
-  vtkDataSet* distributedData =
+  vtkSmartPointer<vtkDataSet> distributedData =
     vtkDataSet::SafeDownCast(d3->GetOutputDataObject(0));
+  if (cellsToKeep)
+    {
+    vtkNew<vtkAppendFilter> appender;
+    appender->AddInputData(cellsToKeep);
+    if (distributedData && distributedData->GetNumberOfCells() > 0)
+      {
+      appender->AddInputData(distributedData);
+      }
+    appender->Update();
+    distributedData = appender->GetOutput();
+    }
   // D3 can result in certain processes having empty datasets. Since we use
   // internal methods on vtkDataSetSurfaceFilter, they are not empty-data safe
   // and hence can segfault. This check avoids such segfaults.
@@ -242,7 +300,7 @@ int vtkOrderedCompositeDistributor::RequestData(
       {
       vtkNew<vtkDataSetSurfaceFilter> converter;
       converter->UnstructuredGridExecute(
-        distributedData, vtkPolyData::SafeDownCast(output));
+        distributedData.GetPointer(), vtkPolyData::SafeDownCast(output));
       }
     else
       {
@@ -255,3 +313,49 @@ int vtkOrderedCompositeDistributor::RequestData(
 
   return 1;
 }
+
+//-----------------------------------------------------------------------------
+void vtkOrderedCompositeDistributor::SplitLocalCells(vtkDataSet* input,
+  vtkIdList* localCells, vtkIdList* nonLocalCells)
+{
+  localCells->Reset();
+  nonLocalCells->Reset();
+
+  vtkIdType numCells = input->GetNumberOfCells();
+  std::vector<double> regionBounds;
+  if (this->PKdTree && numCells > 0)
+    {
+    vtkNew<vtkIntArray> regions;
+    this->PKdTree->GetRegionAssignmentList(
+      this->Controller->GetLocalProcessId(), regions.GetPointer());
+    for (vtkIdType cc=0; cc < regions->GetNumberOfTuples(); ++cc)
+      {
+      double bounds[6];
+      this->PKdTree->GetRegionBounds(regions->GetValue(cc), bounds);
+      regionBounds.insert(regionBounds.end(), bounds, bounds + 6);
+      }
+    }
+
+  size_t numRegions = regionBounds.size() / 6;
+  double bounds[6];
+  for (vtkIdType cellId=0; cellId < numCells; ++cellId)
+    {
+    input->GetCellBounds(cellId, bounds);
+    bool local = false;
+    for (size_t rr=0; rr < numRegions && !local; ++rr)
+      {
+      const double* rb = &regionBounds[6*rr];
+      local = (bounds[0] >= rb[0] && bounds[1] <= rb[1] &&
+               bounds[2] >= rb[2] && bounds[3] <= rb[3] &&
+               bounds[4] >= rb[4] && bounds[5] <= rb[5]);
+      }
+    if (local)
+      {
+      localCells->InsertNextId(cellId);
+      }
+    else
+      {
+      nonLocalCells->InsertNextId(cellId);
+      }
+    }
+}
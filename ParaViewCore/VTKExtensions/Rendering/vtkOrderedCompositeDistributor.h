@@ -35,6 +35,10 @@
 // This class also has an optional pass through mode to make it easy to
 // turn ordered compositing on and off.
 //
+// When MoveOnlyNonLocalCells is on, the cells that already lie entirely within
+// one of the kd-tree regions assigned to the local process are kept in place
+// and only the remaining cells go through vtkDistributedDataFilter.
+//
 
 #ifndef vtkOrderedCompositeDistributor_h
 #define vtkOrderedCompositeDistributor_h
@@ -46,6 +50,7 @@ class vtkBSPCuts;
 class vtkDataSet;
 class vtkDataSetSurfaceFilter;
 class vtkDistributedDataFilter;
+class vtkIdList;
 class vtkMultiProcessController;
 class vtkPKdTree;
 
@@ -77,12 +82,26 @@ public:
   vtkSetStringMacro(OutputType);
   vtkGetStringMacro(OutputType);
 
+  // Description:
+  // When on (default), cells already owned by the local process are not sent
+  // through the redistribution.
+  vtkSetMacro(MoveOnlyNonLocalCells, bool);
+  vtkGetMacro(MoveOnlyNonLocalCells, bool);
+  vtkBooleanMacro(MoveOnlyNonLocalCells, bool);
+
 protected:
   vtkOrderedCompositeDistributor();
   ~vtkOrderedCompositeDistributor();
 
+  // Description:
+  // Splits the cells of the input into the ones lying entirely within a
+  // region assigned to the local process and the ones that must be moved.
+  void SplitLocalCells(vtkDataSet* input, vtkIdList* localCells,
+    vtkIdList* nonLocalCells);
+
   char *OutputType;
   bool PassThrough;
+  bool MoveOnlyNonLocalCells;
   vtkPKdTree *PKdTree;
   vtkMultiProcessController *Controller;
  
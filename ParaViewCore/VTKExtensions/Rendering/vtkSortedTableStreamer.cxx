@@ -48,10 +48,12 @@
 #include "vtkDoubleArray.h"
 
 #include <algorithm>
+#include <map>
 #include <vector>
 #include <set>
 
 #include <float.h>
+#include <string.h>
 
 #include <string>
 #include <sstream>
@@ -424,6 +426,21 @@ public:
       return this->Value > other.Value;
       }
 
+    // Description:
+    // Compare values only, for binary searches and stable sorts.
+    static bool ValueLess(const SortableArrayItem& a, const SortableArrayItem& b)
+      {
+      return a.Value < b.Value;
+      }
+    static bool ItemBefore(const SortableArrayItem& a, const T& value)
+      {
+      return a.Value < value;
+      }
+    static bool ItemAfter(const T& value, const SortableArrayItem& a)
+      {
+      return value < a.Value;
+      }
+
     SortableArrayItem& operator=(const SortableArrayItem& other) {
       if (this != &other) // make sure not the same object
         {
@@ -444,6 +461,7 @@ public:
       {
       this->Array = 0;
       this->Histo = 0;
+      this->ArraySize = 0;
       }
 
     ~ArraySorter()
@@ -463,7 +481,30 @@ public:
         delete this->Histo;
         this->Histo = 0;
         }
+      this->ArraySize = 0;
       }
+
+    // Description:
+    // Return the value used to sort the given tuple: either a component or
+    // the normalized magnitude when selectedComponent is negative.
+    static T GetSortValue(T* dataPtr, vtkIdType tupleIdx, int numComponents,
+                          int selectedComponent)
+      {
+      if(selectedComponent < 0)
+        {
+        double value = 0;
+        double tmp;
+        for(int k=0;k<numComponents;k++)
+          {
+          tmp = static_cast<double>(dataPtr[k + tupleIdx*numComponents]);
+          value +=  tmp*tmp;
+          }
+        value = sqrt(value) / sqrt(static_cast<double>(numComponents));
+        return static_cast<T>(value);
+        }
+      return dataPtr[selectedComponent + tupleIdx*numComponents];
+      }
+
     void FillArray(vtkIdType numTuples)
       {
       // Clear memory if needed
@@ -504,25 +545,24 @@ public:
       for(vtkIdType i=0; i < this->ArraySize; ++i)
         {
         this->Array[i].OriginalIndex = i;
-        double value = 0;
-        double tmp;
+        this->Array[i].Value =
+          GetSortValue(dataPtr, i, numComponents, selectedComponent);
         if(selectedComponent < 0)
           {
-          // Compute magnitude
+          // Keep the unrounded magnitude for the histogram
+          double value = 0;
           for(int k=0;k<numComponents;k++)
             {
-            tmp = static_cast<double>(dataPtr[k + i*numComponents]);
+            double tmp = static_cast<double>(dataPtr[k + i*numComponents]);
             value +=  tmp*tmp;
             }
-          value = sqrt(value) / sqrt(static_cast<double>(numComponents));
-          this->Array[i].Value = static_cast<T>(value);
+          this->Histo->AddValue(
+            sqrt(value) / sqrt(static_cast<double>(numComponents)));
           }
         else
           {
-          this->Array[i].Value = dataPtr[selectedComponent + i*numComponents];
-          value = static_cast<double>(this->Array[i].Value);
+          this->Histo->AddValue(static_cast<double>(this->Array[i].Value));
           }
-        this->Histo->AddValue(value);
         }
 
       // Sort it
@@ -536,6 +576,27 @@ public:
         }
       }
 
+    // Description:
+    // Sort by value only, in increasing order, keeping the current order of
+    // tuples with the same value. No histogram is built.
+    void StableSort(T* dataPtr, vtkIdType numTuples, int numComponents,
+                    int selectedComponent)
+      {
+      if(numComponents == 1 && selectedComponent < 0)
+        {
+        selectedComponent = 0; // We can not compute magnitude on scalar value
+        }
+
+      this->FillArray(numTuples);
+      for(vtkIdType i=0; i < this->ArraySize; ++i)
+        {
+        this->Array[i].Value =
+          GetSortValue(dataPtr, i, numComponents, selectedComponent);
+        }
+      std::stable_sort(this->Array, this->Array + this->ArraySize,
+                       SortableArrayItem::ValueLess);
+      }
+
     void SortProcessId(vtkIdType* dataPtr, vtkIdType numTuples,
                        vtkIdType histogramSize,
                        double* scalarRange, bool reverseOrder)
@@ -888,6 +949,10 @@ public:
     return 1;
     }
   // --------------------------------------------------------------------------
+  // The global order sorts the values in increasing order, then by process id,
+  // then by local index, so that block boundaries are exact even with
+  // repeated values. An inverted order is the exact reverse of it, hence the
+  // same local sort serves both orders.
   int Compute(vtkTable* input, vtkTable* output,
               vtkIdType block, vtkIdType blockSize, bool revertOrder)
     {
@@ -898,217 +963,247 @@ public:
     // ------------------------------------------------------------------------
     if(this->NeedToBuildCache)
       {
-      this->BuildCache(true, revertOrder);
+      this->BuildCache(true, false);
       }
 
     // ------------------------------------------------------------------------
-    // Search for lower bound
-    // ------------------------------------------------------------------------
-    vtkIdType nbElementsToRemoveFromHead = 0;
-    vtkIdType localOffset = 0;
-    vtkIdType nbElementsInBar = 0;
-    this->SearchGlobalIndexLocation( (block * blockSize),
-                                     this->LocalSorter->Histo,
-                                     this->GlobalHistogram,
-                                     nbElementsToRemoveFromHead,
-                                     localOffset,
-                                     nbElementsInBar);
-
-
-
-    // ------------------------------------------------------------------------
-    // Search for upper bound
+    // Look up the part of the block owned by each process
     // ------------------------------------------------------------------------
-    vtkIdType upperOffset = 0;
-    vtkIdType globalUpperOffset = 0;
-    vtkIdType searchIdx =
-        (this->GlobalHistogram->TotalValues < (block + 1) * blockSize) ?
-        this->GlobalHistogram->TotalValues : ((block + 1) * blockSize);
-    searchIdx--; // It is not a size it is an index (so -1)
-
-    this->SearchGlobalIndexLocation( searchIdx,
-                                     this->LocalSorter->Histo,
-                                     this->GlobalHistogram,
-                                     globalUpperOffset,
-                                     upperOffset,
-                                     nbElementsInBar );
+    vtkIdType first = MIN(block * blockSize, this->TotalNumberOfValues);
+    vtkIdType last = MIN(first + blockSize, this->TotalNumberOfValues);
+    if(revertOrder)
+      {
+      vtkIdType tmp = first;
+      first = this->TotalNumberOfValues - last;
+      last = this->TotalNumberOfValues - tmp;
+      }
 
+    // Copy the lower bounds as looking up the upper ones may flush the cache
+    std::vector<vtkIdType> lowerBounds = this->GetGlobalBoundary(first);
+    const std::vector<vtkIdType>& upperBounds = this->GetGlobalBoundary(last);
 
-    // We have to include our searched index (so +1)
-    vtkIdType localSize = (upperOffset + nbElementsInBar) - localOffset + 1;
+    int mergePid = 0;
+    vtkIdType maxSize = 0;
+    for(int pid=0; pid < this->NumProcs; pid++)
+      {
+      if(maxSize < upperBounds[pid] - lowerBounds[pid])
+        {
+        maxSize = upperBounds[pid] - lowerBounds[pid];
+        mergePid = pid;
+        }
+      }
 
     // ------------------------------------------------------------------------
-    // Build local subset table
+    // Build local subset table, already sorted
     // ------------------------------------------------------------------------
+    vtkIdType localSize = upperBounds[this->Me] - lowerBounds[this->Me];
     vtkSmartPointer<vtkTable> localSubset;
     localSubset.TakeReference( this->NewSubsetTable( input,
                                                      this->LocalSorter,
-                                                     localOffset,
+                                                     lowerBounds[this->Me],
                                                      localSize));
 
     // ------------------------------------------------------------------------
-    // Find the process that will merge all subset table
-    // ------------------------------------------------------------------------
-    int mergePid = GetMergingProcessId(localSubset.GetPointer());
-
+    // Only processes owning part of the block send it to process mergePid
     // ------------------------------------------------------------------------
-    // Add local meta-data in case of merge process
-    // ------------------------------------------------------------------------
-    if(this->NumProcs > 1 && this->Me == mergePid)
+    if( this->Me != mergePid )
       {
-      vtkSmartPointer<vtkIdTypeArray> processIdArray = vtkSmartPointer<vtkIdTypeArray>::New();
-      processIdArray->SetName("vtkOriginalProcessIds");
-      processIdArray->SetNumberOfComponents(1);
-      processIdArray->Allocate( (blockSize<localSize) ? localSize : blockSize);
-      for(vtkIdType idx=0; idx < localSubset->GetNumberOfRows(); idx++)
+      if(localSize > 0)
         {
-        processIdArray->InsertNextTuple1(mergePid);
+        this->MPI->Send(localSubset.GetPointer(), mergePid, VTK_TABLE_EXCHANGE_TAG);
         }
-      localSubset->GetRowData()->AddArray(processIdArray);
+
+      // Ask other processes to provide metadata for table decoration
+      this->DecorateTable(input, NULL, mergePid);
+      return 1;
       }
 
     // ------------------------------------------------------------------------
-    // Send local subset array to process mergePid
+    // Merging procedure only on process mergePid. Pieces are appended in
+    // process order so a stable sort on the values gives the global order.
     // ------------------------------------------------------------------------
-    if( this->Me != mergePid )
+    vtkSmartPointer<vtkTable> merged;
+    merged.TakeReference(this->NewSubsetTable(localSubset.GetPointer(), NULL, 0, 0));
+    if(this->NumProcs > 1)
       {
-      this->MPI->Send(localSubset.GetPointer(), mergePid, VTK_TABLE_EXCHANGE_TAG);
+      vtkSmartPointer<vtkIdTypeArray> processIdArray = vtkSmartPointer<vtkIdTypeArray>::New();
+      processIdArray->SetName("vtkOriginalProcessIds");
+      processIdArray->SetNumberOfComponents(1);
+      processIdArray->Allocate(blockSize);
+      merged->GetRowData()->AddArray(processIdArray);
       }
 
-    // ------------------------------------------------------------------------
-    // Merging procedure only on process mergePid
-    // ------------------------------------------------------------------------
-    if( this->Me == mergePid)
+    vtkSmartPointer<vtkTable> tmp = vtkSmartPointer<vtkTable>::New();
+    for(int i=0; i < this->NumProcs; i++)
       {
-      vtkSmartPointer<vtkTable> tmp = vtkSmartPointer<vtkTable>::New();
-      for(int i=0; i < this->NumProcs; i++)
+      if(upperBounds[i] == lowerBounds[i])
         {
-        if(i == mergePid)
-          continue;
-
-        this->MPI->Receive(tmp.GetPointer(), i, VTK_TABLE_EXCHANGE_TAG);
-        this->MergeTable(i,tmp.GetPointer(),localSubset.GetPointer(),blockSize);
+        continue;
         }
-
-      // Sort new table/array
-      if(!this->DataToSort)
+      if(i == mergePid)
         {
-        // This mean that no output can be provided
-        // cout << "ERROR the merge process have no DataArray." << endl;
-        return 1;
+        this->MergeTable(i, localSubset.GetPointer(), merged.GetPointer(), blockSize);
         }
-      vtkDataArray* subsetArray = vtkDataArray::SafeDownCast(
-          localSubset->GetColumnByName(this->DataToSort->GetName()));
-
-      if(!subsetArray)
+      else
         {
-        vtkSortedTableStreamer::PrintInfo(localSubset.GetPointer());
+        this->MPI->Receive(tmp.GetPointer(), i, VTK_TABLE_EXCHANGE_TAG);
+        this->MergeTable(i, tmp.GetPointer(), merged.GetPointer(), blockSize);
         }
+      }
 
+    vtkDataArray* subsetArray = this->DataToSort ?
+      vtkDataArray::SafeDownCast(
+        merged->GetColumnByName(this->DataToSort->GetName())) : NULL;
+    if(subsetArray)
+      {
       ArraySorter sorter;
-      sorter.Update(static_cast<T*>(subsetArray->GetVoidPointer(0)),
-                    subsetArray->GetNumberOfTuples(),
-                    subsetArray->GetNumberOfComponents(),
-                    this->SelectedComponent,
-                    HISTOGRAM_SIZE,
-                    this->CommonRange,
-                    revertOrder);
-
-      // trim it (remove head and tail that don't belong to the result)
-      localSubset.TakeReference(
-          this->NewSubsetTable(localSubset.GetPointer(),
+      sorter.StableSort(static_cast<T*>(subsetArray->GetVoidPointer(0)),
+                        subsetArray->GetNumberOfTuples(),
+                        subsetArray->GetNumberOfComponents(),
+                        this->SelectedComponent);
+      if(revertOrder)
+        {
+        std::reverse(sorter.Array, sorter.Array + sorter.ArraySize);
+        }
+      merged.TakeReference(
+          this->NewSubsetTable(merged.GetPointer(),
                                &sorter,
-                               nbElementsToRemoveFromHead,
-                               blockSize));
+                               0,
+                               sorter.ArraySize));
+      }
 
-      // Add extra information such as structured indices, block number...
-      this->DecorateTable(input, localSubset.GetPointer(), mergePid);
+    // Add extra information such as structured indices, block number...
+    this->DecorateTable(input, merged.GetPointer(), mergePid);
 
-      // ShallowCopy it to the output
-      output->ShallowCopy(localSubset.GetPointer());
+    // ShallowCopy it to the output
+    output->ShallowCopy(merged.GetPointer());
+    return 1;
+    }
+
+  // --------------------------------------------------------------------------
+  // Returns, for each process, how many of its locally sorted values come
+  // before the given position in the global order. All processes request the
+  // same positions, so the results are kept until the cache is rebuilt and
+  // revisiting a block needs no communication.
+  const std::vector<vtkIdType>& GetGlobalBoundary(vtkIdType position)
+    {
+    std::map<vtkIdType, std::vector<vtkIdType> >::iterator iter =
+      this->Boundaries.find(position);
+    if(iter != this->Boundaries.end())
+      {
+      return iter->second;
       }
-    else
+    if(this->Boundaries.size() >= static_cast<size_t>(MAX_CACHED_BOUNDARIES))
       {
-      // Ask other processes to provide metadata for table decoration
-      this->DecorateTable(input, NULL, mergePid);
+      this->Boundaries.clear();
       }
 
-    return 1;
+    vtkIdType localOffset = this->SelectGlobalPosition(position);
+    std::vector<vtkIdType>& offsets = this->Boundaries[position];
+    offsets.resize(this->NumProcs);
+    this->MPI->AllGather(&localOffset, &offsets[0], 1);
+    return offsets;
     }
 
   // --------------------------------------------------------------------------
-  // nbGlobalToSkip is the number of elements that should be skiped at the end
-  // if you exactly want to reach the searchedGlobalIndex.
-  // localOffset is the corresponding local index in the sorted table to the
-  // global index of (searchedGlobalIndex - nbGlobalToSkip)
-  // nbInLocalBar is the local number of elements that are available
-  // in the hitogram bar where the searchedGlobalIndex has been found.
-  // nbInLocalBar is used when you want to get an upper bound that
-  // will include the searchedGlobalIndex.
-  void SearchGlobalIndexLocation(vtkIdType searchedGlobalIndex,
-                                 Histogram* localHistogram,
-                                 Histogram* globalHistogram,
-                                 vtkIdType& nbGlobalToSkip,
-                                 vtkIdType& localOffset,
-                                 vtkIdType& nbInLocalBar)
+  // Distributed selection: narrows down the candidate range of every process
+  // around a pivot chosen as the weighted median of the local medians, until
+  // the pivot value holds the searched position. Each round discards at least
+  // a quarter of the candidates.
+  vtkIdType SelectGlobalPosition(vtkIdType position)
     {
-    // Communication buffer
-    vtkIdType* bufferHistogramValues = new vtkIdType[this->NumProcs *  HISTOGRAM_SIZE];
-
-    // Local internal working var
-    vtkIdType histogramBarIdx = -1;
-    double currentRange[2];
-    vtkIdType idx, idxEnd;
+    const SortableArrayItem* items = this->LocalSorter->Array;
+    vtkIdType lo = 0;
+    vtkIdType hi = items ? this->LocalSorter->ArraySize : 0;
+    vtkIdType remaining = position;
 
-    // Setup inital hitogram range and values
-    Histogram _globalHistogram;
-    Histogram _localHistogram;
-    localHistogram->CopyTo(_localHistogram);
-    globalHistogram->CopyTo(_globalHistogram);
-
-    // Reset local offsets
-    localOffset = 0;
-    nbGlobalToSkip = searchedGlobalIndex;
-
-    do
+    std::vector<char> proposals(this->NumProcs * sizeof(T));
+    std::vector<vtkIdType> weights(this->NumProcs);
+    std::vector<vtkIdType> counts(2 * this->NumProcs);
+    std::vector<std::pair<T, vtkIdType> > pivots;
+    for(;;)
       {
-      nbGlobalToSkip -= _globalHistogram.GetNewRange(nbGlobalToSkip,
-                                                     histogramBarIdx,
-                                                     currentRange);
-
-      localOffset += _localHistogram.GetNumberOfElements(0, histogramBarIdx);
-      nbInLocalBar = _localHistogram.GetNumberOfElements(histogramBarIdx,
-                                                         histogramBarIdx+1);
+      T proposal = T();
+      vtkIdType weight = hi - lo;
+      if(weight > 0)
+        {
+        proposal = items[lo + weight / 2].Value;
+        }
+      this->MPI->AllGather(reinterpret_cast<char*>(&proposal),
+                           &proposals[0], static_cast<vtkIdType>(sizeof(T)));
+      this->MPI->AllGather(&weight, &weights[0], 1);
 
-      // Based on a narrowed range, build local histogram to get closer to the
-      // real index of the object
-      _localHistogram.SetScalarRange(currentRange);
-      _localHistogram.ClearHistogramValues();
+      vtkIdType candidates = 0;
+      pivots.clear();
+      for(int pid=0; pid < this->NumProcs; pid++)
+        {
+        if(weights[pid] > 0)
+          {
+          T value;
+          memcpy(&value, &proposals[pid * sizeof(T)], sizeof(T));
+          pivots.push_back(std::pair<T, vtkIdType>(value, weights[pid]));
+          candidates += weights[pid];
+          }
+        }
+      if(remaining <= 0)
+        {
+        return lo;
+        }
+      if(remaining >= candidates)
+        {
+        return hi;
+        }
 
-      idxEnd = localOffset + nbInLocalBar;
-      for(idx = localOffset; idx < idxEnd; ++idx)
+      // Weighted median of the proposals
+      std::sort(pivots.begin(), pivots.end());
+      T pivot = pivots.back().first;
+      vtkIdType accumulated = 0;
+      for(size_t cc=0; cc < pivots.size(); cc++)
         {
-        _localHistogram.AddValue(this->LocalSorter->Array[idx].Value);
+        accumulated += pivots[cc].second;
+        if(2 * accumulated >= candidates)
+          {
+          pivot = pivots[cc].first;
+          break;
+          }
         }
 
-      // Exchange local histo with everyone
-      this->MPI->AllGather( _localHistogram.Values,
-                            bufferHistogramValues, HISTOGRAM_SIZE);
+      vtkIdType less = std::lower_bound(items + lo, items + hi, pivot,
+        SortableArrayItem::ItemBefore) - (items + lo);
+      vtkIdType lessOrEqual = std::upper_bound(items + lo, items + hi, pivot,
+        SortableArrayItem::ItemAfter) - (items + lo);
+      vtkIdType localCounts[2] = { less, lessOrEqual - less };
+      this->MPI->AllGather(localCounts, &counts[0], 2);
 
-      // Build global histogram
-      _globalHistogram.SetScalarRange(currentRange);
-      _globalHistogram.ClearHistogramValues();
+      vtkIdType globalLess = 0;
+      vtkIdType globalEqual = 0;
+      for(int pid=0; pid < this->NumProcs; pid++)
+        {
+        globalLess += counts[2*pid];
+        globalEqual += counts[2*pid+1];
+        }
 
-      idxEnd = this->NumProcs * HISTOGRAM_SIZE;
-      for(idx = 0; idx < idxEnd; ++idx)
+      if(remaining < globalLess)
+        {
+        hi = lo + less;
+        }
+      else if(remaining <= globalLess + globalEqual)
         {
-        _globalHistogram.TotalValues += bufferHistogramValues[idx];
-        _globalHistogram.Values[idx % HISTOGRAM_SIZE] += bufferHistogramValues[idx];
+        // The position falls among the values equal to the pivot, which are
+        // ordered by process id.
+        vtkIdType equalToTake = remaining - globalLess;
+        for(int pid=0; pid < this->Me; pid++)
+          {
+          equalToTake -= MIN(equalToTake, counts[2*pid+1]);
+          }
+        return lo + less + MIN(equalToTake, counts[2*this->Me+1]);
+        }
+      else
+        {
+        remaining -= globalLess + globalEqual;
+        lo += lessOrEqual;
         }
       }
-    while(nbGlobalToSkip > 0 && _globalHistogram.CanBeReduced());
-
-    delete[] bufferHistogramValues;
     }
 
   // --------------------------------------------------------------------------
@@ -1175,13 +1270,16 @@ public:
   void InvalidateCache()
     {
     this->NeedToBuildCache = true;
+    this->Sortable = -1;
+    this->Boundaries.clear();
     }
 
   // --------------------------------------------------------------------------
   bool IsInvalid(vtkTable* input, vtkDataArray* dataToProcess)
     {
-    return !dataToProcess || input->GetMTime() != this->InputMTime
-           || dataToProcess->GetMTime() != this->DataMTime;
+    return dataToProcess != this->DataToSort
+           || input->GetMTime() != this->InputMTime
+           || (dataToProcess && dataToProcess->GetMTime() != this->DataMTime);
     }
 
   // --------------------------------------------------------------------------
@@ -1404,6 +1502,10 @@ private:
   vtkCommunicator* MPI;       // MPI communicator to send/receive/gather
   int SelectedComponent;      // Component used to sort array
   bool NeedToBuildCache;
+  int Sortable;               // Cached result of IsSortable(), -1 if unknown
+  vtkIdType TotalNumberOfValues; // Number of values across processes
+  // Local offsets of all processes for the global positions looked up so far
+  std::map<vtkIdType, std::vector<vtkIdType> > Boundaries;
   bool Debug;
 
   const static int VTK_TABLE_EXCHANGE_TAG = 50;
@@ -1414,6 +1516,89 @@ private:
   // Maybe make some test on huge cluster to see which histogram size is
   // the best.
   const static int HISTOGRAM_SIZE = 256;
+  // Number of block boundaries remembered before starting over.
+  const static int MAX_CACHED_BOUNDARIES = 4096;
+};
+
+//****************************************************************************
+// Sort indices kept between executions, one per column and component, along
+// with the table merged from a composite input. All processes go through the
+// same sequence of requests so their caches stay identical.
+class vtkSortedTableStreamer::IndexCache
+{
+public:
+  struct Entry
+    {
+    std::string Column;
+    int Component;
+    InternalsBase* Index;
+    unsigned long LastUsed;
+    };
+
+  std::vector<Entry> Entries;
+  unsigned long UseCounter;
+  unsigned long InputMTime;
+
+  vtkSmartPointer<vtkTable> MergedInput;
+  unsigned long MergedInputMTime;
+
+  IndexCache() : UseCounter(0), InputMTime(0), MergedInputMTime(0) {}
+  ~IndexCache() { this->Clear(); }
+
+  void Clear()
+    {
+    for(size_t cc=0; cc < this->Entries.size(); cc++)
+      {
+      delete this->Entries[cc].Index;
+      }
+    this->Entries.clear();
+    }
+
+  Entry* Find(const std::string& column, int component)
+    {
+    for(size_t cc=0; cc < this->Entries.size(); cc++)
+      {
+      if(this->Entries[cc].Column == column &&
+         this->Entries[cc].Component == component)
+        {
+        return &this->Entries[cc];
+        }
+      }
+    return NULL;
+    }
+
+  void Remove(Entry* entry)
+    {
+    delete entry->Index;
+    this->Entries.erase(this->Entries.begin() + (entry - &this->Entries[0]));
+    }
+
+  Entry* Add(const std::string& column, int component, InternalsBase* index,
+             int maxSize)
+    {
+    // Evict the least recently used indices
+    while(!this->Entries.empty() &&
+          static_cast<int>(this->Entries.size()) >= maxSize)
+      {
+      size_t oldest = 0;
+      for(size_t cc=1; cc < this->Entries.size(); cc++)
+        {
+        if(this->Entries[cc].LastUsed < this->Entries[oldest].LastUsed)
+          {
+          oldest = cc;
+          }
+        }
+      this->Remove(&this->Entries[oldest]);
+      }
+
+    Entry entry;
+    entry.Column = column;
+    entry.Component = component;
+    entry.Index = index;
+    entry.LastUsed = 0;
+    this->Entries.push_back(entry);
+    return &this->Entries.back();
+    }
 };
 //****************************************************************************
 vtkStandardNewMacro(vtkSortedTableStreamer);
@@ -1429,6 +1614,8 @@ vtkSortedTableStreamer::vtkSortedTableStreamer()
   this->Block = 0;
   this->BlockSize = 1024;
   this->Internal = 0;
+  this->Indexes = new IndexCache();
+  this->IndexCacheSize = 4;
   this->SelectedComponent = 0;
   this->SetController(vtkMultiProcessController::GetGlobalController());
 }
@@ -1438,11 +1625,8 @@ vtkSortedTableStreamer::~vtkSortedTableStreamer()
 {
   this->SetColumnToSort(0);
   this->SetController(0);
-  if(this->Internal)
-    {
-    delete this->Internal;
-    this->Internal = 0;
-    }
+  this->Internal = 0;
+  delete this->Indexes;
 }
 
 //----------------------------------------------------------------------------
@@ -1468,8 +1652,15 @@ int vtkSortedTableStreamer::RequestData( vtkInformation* vtkNotUsed(request),
 
   bool orderInverted = this->InvertOrder > 0;
 
-  // Convert a composite dataset into a vtkTable input.
-  if(!input)
+  // Convert a composite dataset into a vtkTable input. The merged table is
+  // kept until the input changes so that the sort indices built on it remain
+  // valid.
+  if(!input && this->Indexes->MergedInput &&
+     this->Indexes->MergedInputMTime == inputDO->GetMTime())
+    {
+    input = this->Indexes->MergedInput;
+    }
+  else if(!input)
     {
     vtkSmartPointer<vtkCompositeDataSet> inputCompositeDS =
         vtkCompositeDataSet::SafeDownCast(inputDO);
@@ -1555,6 +1746,9 @@ int vtkSortedTableStreamer::RequestData( vtkInformation* vtkNotUsed(request),
         }
       }
     iter->Delete();
+
+    this->Indexes->MergedInput = input;
+    this->Indexes->MergedInputMTime = inputDO->GetMTime();
     }
 
   // Get input data
@@ -1570,14 +1764,8 @@ int vtkSortedTableStreamer::RequestData( vtkInformation* vtkNotUsed(request),
   // single point/cell.
   // --------------------------------------------------------------------------
 
-  // Delete internal object if the input has change (table or array to sort)
-  if(this->Internal && this->Internal->IsInvalid(input, arrayToProcess))
-    {
-    delete this->Internal;
-    this->Internal = 0;
-    }
-
-  // Make sure that an internal object is available
+  // Find the sort index for the current column and component, building a new
+  // one if the input has changed
   this->CreateInternalIfNeeded(input, arrayToProcess);
   int realComponent = (!arrayToProcess) ?  0 :
                       this->GetSelectedComponent() % arrayToProcess->GetNumberOfComponents();
@@ -1606,6 +1794,7 @@ void vtkSortedTableStreamer::PrintSelf(ostream& os, vtkIndent indent)
   this->Superclass::PrintSelf(os, indent);
   os << indent << "Sorting column: "
      << (this->ColumnToSort?this->ColumnToSort:"(none)") << endl;
+  os << indent << "IndexCacheSize: " << this->IndexCacheSize << endl;
 }
 
 //----------------------------------------------------------------------------
@@ -1616,30 +1805,14 @@ const char* vtkSortedTableStreamer::GetColumnNameToSort()
 //----------------------------------------------------------------------------
 void vtkSortedTableStreamer::SetColumnNameToSort(const char* columnName)
 {
+  // Sort indices are kept per column, nothing to invalidate here
   this->SetColumnToSort(columnName);
-  if(strcmp("vtkOriginalProcessIds", this->GetColumnToSort()) != 0)
-    {
-    if(this->Internal)
-      {
-      delete this->Internal;
-      this->Internal = 0;
-      }
-    }
 }
 //----------------------------------------------------------------------------
 void vtkSortedTableStreamer::SetInvertOrder(int newValue)
 {
-  bool changed = this->InvertOrder != newValue;
-  bool removeInternal = changed &&
-                        strcmp("vtkOriginalProcessIds", this->GetColumnToSort()) != 0;
-
-  if(removeInternal && this->Internal)
-    {
-    delete this->Internal;
-    this->Internal = 0;
-    }
-
-  if(changed)
+  // The same sort index serves both orders
+  if(this->InvertOrder != newValue)
     {
     this->InvertOrder = newValue;
     this->Modified();
@@ -1664,27 +1837,90 @@ vtkDataArray* vtkSortedTableStreamer::GetDataArrayToProcess(vtkTable* input)
 void vtkSortedTableStreamer::CreateInternalIfNeeded( vtkTable* input,
                                                      vtkDataArray* data)
 {
-  if(!this->Internal)
+  std::string column = this->GetColumnToSort() ? this->GetColumnToSort() : "";
+  IndexCache::Entry* entry =
+    this->Indexes->Find(column, this->GetSelectedComponent());
+
+  // Building an index is collective, so all processes must agree on whether
+  // the input or the array to sort have changed.
+  int localInvalid[2] =
+    {
+    input->GetMTime() != this->Indexes->InputMTime ? 1 : 0,
+    (entry && entry->Index->IsInvalid(input, data)) ? 1 : 0
+    };
+  int globalInvalid[2] = { localInvalid[0], localInvalid[1] };
+  if(this->Controller)
+    {
+    this->Controller->AllReduce(localInvalid, globalInvalid, 2,
+                                vtkCommunicator::MAX_OP);
+    }
+
+  if(globalInvalid[0])
+    {
+    this->Indexes->Clear();
+    this->Indexes->InputMTime = input->GetMTime();
+    entry = NULL;
+    }
+  else if(globalInvalid[1] && entry)
+    {
+    this->Indexes->Remove(entry);
+    entry = NULL;
+    }
+
+  if(!entry)
     {
+    // The sort exchanges values of the column type, so all processes must
+    // use the same type, including those whose piece lacks the column.
+    int localType[2] = { VTK_INT_MAX, -1 };
     if(data)
       {
       switch (data->GetDataType())
         {
         vtkTemplateMacro(
-            this->Internal = new Internals<VTK_TT>( input, data,
-                                                    this->GetController());
+          localType[0] = data->GetDataType();
+          localType[1] = -data->GetDataType();
         );
         default:
         vtkErrorMacro("Array type not supported: " << data->GetClassName());
         }
       }
-    else
+    int globalType[2] = { localType[0], localType[1] };
+    if(this->Controller)
+      {
+      this->Controller->AllReduce(localType, globalType, 2,
+                                  vtkCommunicator::MIN_OP);
+      }
+    int dataType = globalType[0];
+    if(dataType != VTK_INT_MAX && dataType != -globalType[1])
+      {
+      vtkErrorMacro("The column to sort does not have the same type on "
+                    "all processes.");
+      dataType = VTK_INT_MAX;
+      }
+    if(!data || localType[0] != dataType)
+      {
+      data = 0;
+      }
+
+    InternalsBase* index = 0;
+    switch (dataType)
+      {
+      vtkTemplateMacro(
+          index = new Internals<VTK_TT>( input, data,
+                                         this->GetController());
+      );
+      }
+    if(!index)
       {
       // Provide an empty data
-      this->Internal = new Internals<double>( input, 0,
-                                              this->GetController());
+      index = new Internals<double>( input, 0,
+                                     this->GetController());
       }
+    entry = this->Indexes->Add(column, this->GetSelectedComponent(), index,
+                               this->IndexCacheSize);
     }
+  entry->LastUsed = ++this->Indexes->UseCounter;
+  this->Internal = entry->Index;
 }
 //----------------------------------------------------------------------------
 void vtkSortedTableStreamer::PrintInfo(vtkTable* input)
@@ -18,6 +18,12 @@
 // This filter is used quickly get a sorted subset of a given vtkTable.
 // By sorted we mean a subset build from a global sort even if some optimisation
 // allow us to skip a global table sorting.
+//
+// Each process sorts its part of the table once per column and component.
+// These sort indices are kept, up to IndexCacheSize of them, until the input
+// is modified, and serve both the normal and the inverted order. The position
+// of each block in the distributed index is remembered as well, so scrolling
+// back to a block only fetches its rows from the processes owning them.
 
 #ifndef vtkSortedTableStreamer_h
 #define vtkSortedTableStreamer_h
@@ -33,7 +39,9 @@ class VTKPVVTKEXTENSIONSRENDERING_EXPORT vtkSortedTableStreamer : public vtkTabl
 private:
   class InternalsBase;
   template<class T> class Internals;
+  class IndexCache;
   InternalsBase* Internal;
+  IndexCache* Indexes;
 
 public:
   static void PrintInfo(vtkTable* input);
@@ -80,6 +88,13 @@ public:
   void SetInvertOrder(int newValue);
   vtkGetMacro(InvertOrder, int);
 
+  // Description:
+  // Maximum number of sort indices, one per column and component, kept
+  // between executions. The least recently used one is discarded when a new
+  // column is sorted. Default is 4.
+  vtkSetClampMacro(IndexCacheSize, int, 1, VTK_INT_MAX);
+  vtkGetMacro(IndexCacheSize, int);
+
 protected:
   vtkSortedTableStreamer();
   ~vtkSortedTableStreamer();
@@ -88,6 +103,10 @@ protected:
                    vtkInformationVector**,
                    vtkInformationVector*);
 
+  // Description:
+  // Makes Internal point to the sort index for the current column and
+  // component, creating it if needed. Indices are discarded when the input
+  // changes. Must be called on all processes.
   void CreateInternalIfNeeded(vtkTable* input, vtkDataArray* data);
   vtkDataArray* GetDataArrayToProcess(vtkTable* input);
 
@@ -104,6 +123,7 @@ protected:
   char* ColumnToSort;
   int SelectedComponent;
   int InvertOrder;
+  int IndexCacheSize;
 private:
   vtkSortedTableStreamer(const vtkSortedTableStreamer&) VTK_DELETE_FUNCTION;
   void operator=(const vtkSortedTableStreamer&) VTK_DELETE_FUNCTION;
@@ -0,0 +1,63 @@
+#include "vtkFileSequenceParser.h"
+#include "vtkNew.h"
+
+#include <cstring>
+
+namespace
+{
+struct vtkSequenceCase
+{
+  const char* FileName;
+  bool Match;
+  const char* SequenceName;
+  int SequenceIndex;
+};
+
+const vtkSequenceCase Cases[] = {
+  { "data.vtk", false, "", 0 },
+  { "data", false, "", 0 },
+  { "", false, "", 0 },
+  { "can.ex2.12", true, "can.ex2", 12 },
+  { "can.e.4.002", true, "can.e.4", 2 },
+  { "can.e.", false, "", 0 },
+  { "data_0012.vtu", true, "data_..vtu", 12 },
+  { "data-7.vtk", true, "data-..vtk", 7 },
+  { "data.1.2.vtk", true, "data.1...vtk", 2 },
+  { "data_1.5.vtk", true, "data_1...vtk", 5 },
+  { "step12.vti", true, "step..vti", 12 },
+  { "0012_data.vtk", true, ".._data.vtk", 12 },
+  { "12.data.vtk", true, "...data.vtk", 12 },
+  { "12data.vtk", true, "..data.vtk", 12 },
+  { "out_12_final", true, "out_.._final", 12 },
+  { "a1b22c", true, "a1b..c", 22 },
+  { "12abc", false, "", 0 },
+};
+}
+
+int TestFileSequenceParser(int, char*[])
+{
+  vtkNew<vtkFileSequenceParser> parser;
+  int errors = 0;
+  for (size_t cc = 0; cc < sizeof(Cases) / sizeof(Cases[0]); ++cc)
+    {
+    const vtkSequenceCase& test = Cases[cc];
+    bool match = parser->ParseFileSequence(const_cast<char*>(test.FileName));
+    if (match != test.Match)
+      {
+      cerr << "ERROR: '" << test.FileName << "' should "
+        << (test.Match? "" : "not ") << "be part of a sequence." << endl;
+      ++errors;
+      continue;
+      }
+    if (match && (strcmp(parser->GetSequenceName(), test.SequenceName) != 0 ||
+        parser->GetSequenceIndex() != test.SequenceIndex))
+      {
+      cerr << "ERROR: '" << test.FileName << "' parsed as '"
+        << parser->GetSequenceName() << "' #" << parser->GetSequenceIndex()
+        << ", expected '" << test.SequenceName << "' #"
+        << test.SequenceIndex << endl;
+      ++errors;
+      }
+    }
+  return errors == 0? 0 : 1;
+}
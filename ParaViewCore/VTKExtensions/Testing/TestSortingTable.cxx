@@ -24,7 +24,10 @@
 #include "vtkMultiProcessController.h"
 #include "vtkDummyController.h"
 
+#include <algorithm>
 #include <float.h>
+#include <utility>
+#include <vector>
 // ----------------------------------------------------------------------------
 void fillArray(vtkDoubleArray* array, double* dataPointer, int dataSize, const char* name)
 {
@@ -156,6 +159,71 @@ int sortMagnitudeOnUnsignedCharVector()
   return EXIT_SUCCESS;
 }
 
+// ----------------------------------------------------------------------------
+// Scroll through blocks in both orders and switch columns back and forth so
+// that cached sort indices and block boundaries get reused.
+int sortBlocksWithCachedIndices(bool debug)
+{
+  const int size = 1000;
+  const int blockSize = 64;
+  std::vector<std::pair<double, double> > expected;
+  vtkSmartPointer<vtkDoubleArray> data = vtkSmartPointer<vtkDoubleArray>::New();
+  vtkSmartPointer<vtkDoubleArray> ids = vtkSmartPointer<vtkDoubleArray>::New();
+  data->SetName("data");
+  ids->SetName("id");
+  for(int i=0;i<size;i++)
+    {
+    double value = (i * 37) % 101;
+    data->InsertNextTuple1(value);
+    ids->InsertNextTuple1(i);
+    expected.push_back(std::pair<double, double>(value, i));
+    }
+  std::sort(expected.begin(), expected.end());
+
+  vtkSmartPointer<vtkTable> input = vtkSmartPointer<vtkTable>::New();
+  input->AddColumn(data);
+  input->AddColumn(ids);
+  vtkSmartPointer<vtkSortedTableStreamer> sortingfilter = vtkSmartPointer<vtkSortedTableStreamer>::New();
+  sortingfilter->SetInputData(input.GetPointer());
+  sortingfilter->SetSelectedComponent(0);
+  sortingfilter->SetBlockSize(blockSize);
+
+  const int numBlocks = (size + blockSize - 1) / blockSize;
+  for(int pass=0;pass<4;pass++)
+    {
+    bool inverted = (pass % 2) == 1;
+    sortingfilter->SetColumnNameToSort(pass == 2 ? "id" : "data");
+    sortingfilter->SetInvertOrder(inverted ? 1 : 0);
+    for(int step=0;step<2*numBlocks;step++)
+      {
+      // Go forward, then backward over the same blocks
+      int block = step < numBlocks ? step : 2*numBlocks - step - 1;
+      sortingfilter->SetBlock(block);
+      sortingfilter->Update();
+
+      int first = block * blockSize;
+      int count = std::min(blockSize, size - first);
+      std::vector<double> values(count);
+      std::vector<double> indices(count);
+      for(int i=0;i<count;i++)
+        {
+        int pos = inverted ? (size - first - i - 1) : (first + i);
+        // Sorting on "id" gives the original order
+        values[i] = pass == 2 ? data->GetValue(pos) : expected[pos].first;
+        indices[i] = pass == 2 ? pos : expected[pos].second;
+        }
+      if(!compareArray(sortingfilter->GetOutput(), "data", &values[0], count, debug) ||
+         !compareArray(sortingfilter->GetOutput(), "id", &indices[0], count, debug))
+        {
+        cout << "Wrong block " << block << " in pass " << pass << endl;
+        return EXIT_FAILURE;
+        }
+      }
+    }
+
+  return EXIT_SUCCESS;
+}
+
 // ----------------------------------------------------------------------------
 int TestSortingTable(int vtkNotUsed(argc), char **vtkNotUsed(argv))
 {
@@ -179,6 +247,10 @@ int TestSortingTable(int vtkNotUsed(argc), char **vtkNotUsed(argv))
            ? "FAILED" :  "SUCCESS")
        << endl;
   // --------------------------------------------------------------------------
+  cout << "Testing block requests with cached sort indices: "
+       << ((result += sortBlocksWithCachedIndices(debug))
+           ? "FAILED" :  "SUCCESS")
+       << endl;
   // --------------------------------------------------------------------------
 
   // Delete Fake MPI controller
@@ -0,0 +1,142 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    DepthSortBenchmark.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// This test measures the throughput of vtkDepthSortPoints, in millions of
+// points sorted per second, when sorting from scratch and when refining the
+// previous order for the same view and after a slight rotation of the view,
+// and checks the orders.
+
+#include "vtkDepthSortPoints.h"
+#include "vtkIdList.h"
+#include "vtkMath.h"
+#include "vtkMinimalStandardRandomSequence.h"
+#include "vtkNew.h"
+#include "vtkPoints.h"
+#include "vtkTimerLog.h"
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+// Returns true if order is a permutation of the points sorted back to front.
+bool CheckOrder(vtkPoints* points, const double origin[3],
+  const double direction[3], vtkIdList* order)
+{
+  vtkIdType n = points->GetNumberOfPoints();
+  if (order->GetNumberOfIds() != n)
+    {
+    std::cerr << "ERROR: " << order->GetNumberOfIds()
+      << " ids sorted instead of " << n << std::endl;
+    return false;
+    }
+  std::vector<bool> seen(n, false);
+  float previous = VTK_FLOAT_MAX;
+  for (vtkIdType i = 0; i < n; ++i)
+    {
+    vtkIdType id = order->GetId(i);
+    if (id < 0 || id >= n || seen[id])
+      {
+      std::cerr << "ERROR: invalid or repeated id " << id << std::endl;
+      return false;
+      }
+    seen[id] = true;
+    double x[3];
+    points->GetPoint(id, x);
+    float depth = static_cast<float>((x[0] - origin[0]) * direction[0] +
+      (x[1] - origin[1]) * direction[1] + (x[2] - origin[2]) * direction[2]);
+    if (depth > previous)
+      {
+      std::cerr << "ERROR: point " << id << " at " << i
+        << " is farther than the previous one" << std::endl;
+      return false;
+      }
+    previous = depth;
+    }
+  return true;
+}
+
+// Sorts the points and prints the throughput.
+bool Sort(vtkDepthSortPoints* sorter, vtkPoints* points, const double origin[3],
+  const double direction[3], vtkIdList* order, const char* label,
+  int incremental)
+{
+  vtkNew<vtkTimerLog> timer;
+  timer->StartTimer();
+  sorter->Sort(points, NULL, origin, direction, order);
+  timer->StopTimer();
+  double elapsed = timer->GetElapsedTime();
+  std::cout << label << ": " << elapsed << " s, "
+    << points->GetNumberOfPoints() / (1.0e6 * elapsed) << " Mpoints/s"
+    << std::endl;
+  if (sorter->GetLastSortIncremental() != incremental)
+    {
+    std::cerr << "ERROR: " << label << " was "
+      << (incremental ? "not " : "") << "incremental" << std::endl;
+    return false;
+    }
+  return CheckOrder(points, origin, direction, order);
+}
+}
+
+int DepthSortBenchmark(int, char*[])
+{
+  const vtkIdType numPoints = 1000000;
+
+  vtkNew<vtkMinimalStandardRandomSequence> random;
+  vtkNew<vtkPoints> points;
+  points->SetDataTypeToFloat();
+  points->SetNumberOfPoints(numPoints);
+  for (vtkIdType i = 0; i < numPoints; ++i)
+    {
+    double x[3];
+    for (int j = 0; j < 3; ++j)
+      {
+      x[j] = random->GetRangeValue(-1.0, 1.0);
+      random->Next();
+      }
+    points->SetPoint(i, x);
+    }
+
+  double origin[3] = { 0.0, 0.0, 10.0 };
+  double direction[3] = { 0.0, 0.0, -1.0 };
+  // the view after a rotation of 1e-4 degree around the y axis, as between
+  // two renders of an interaction.
+  double angle = vtkMath::RadiansFromDegrees(1.0e-4);
+  double movedOrigin[3] = { 10.0 * sin(angle), 0.0, 10.0 * cos(angle) };
+  double movedDirection[3] = { -sin(angle), 0.0, -cos(angle) };
+
+  bool ok = true;
+  int threads[2] = { 1, 0 };
+  for (int t = 0; t < 2; ++t)
+    {
+    std::cout << (threads[t] == 1 ? "1 thread" : "default threads")
+      << ", " << numPoints << " points" << std::endl;
+    vtkNew<vtkDepthSortPoints> sorter;
+    sorter->SetNumberOfThreads(threads[t]);
+    vtkNew<vtkIdList> order;
+    ok &= Sort(sorter.GetPointer(), points.GetPointer(), origin, direction,
+      order.GetPointer(), "  radix sort      ", 0);
+    ok &= Sort(sorter.GetPointer(), points.GetPointer(), origin, direction,
+      order.GetPointer(), "  same view       ", 1);
+    ok &= Sort(sorter.GetPointer(), points.GetPointer(), movedOrigin,
+      movedDirection, order.GetPointer(), "  incremental sort", 1);
+    // a large rotation falls back to the radix sort.
+    ok &= Sort(sorter.GetPointer(), points.GetPointer(), origin,
+      movedOrigin, order.GetPointer(), "  resort          ", 0);
+    }
+
+  return ok ? 0 : 1;
+}
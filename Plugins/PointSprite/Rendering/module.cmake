@@ -5,9 +5,13 @@ vtk_module(vtkPointSpriteRendering
     vtkImagingCore
     vtkInteractionStyle
     vtkRenderingFreeType
+  PRIVATE_DEPENDS
+    vtkPVVTKExtensionsCore
   COMPILE_DEPENDS
     vtkUtilitiesEncodeString
   EXCLUDE_FROM_WRAP_HIERARCHY
+  TEST_DEPENDS
+    vtkTestingCore
   TEST_LABELS
     PARAVIEW
 )
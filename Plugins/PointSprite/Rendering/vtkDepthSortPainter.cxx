@@ -47,11 +47,16 @@
 #include "vtkTexture.h"
 #include "vtkProperty.h"
 #include "vtkDepthSortPolyData.h"
+#include "vtkDepthSortPoints.h"
+#include "vtkIdList.h"
+#include "vtkNew.h"
+#include "vtkSmartPointer.h"
 #include "vtkScalarsToColors.h"
 
 #include <vector>
 #include <algorithm>
 #include <functional>
+#include <map>
 
 #include <cmath>
 #include "vtkImageData.h"
@@ -60,11 +65,32 @@
 #include "vtkCellData.h"
 #include "vtkPolyData.h"
 
+//-----------------------------------------------------------------------------
+class vtkDepthSortPainter::vtkInternals
+{
+public:
+  // The order of the vertices of a dataset at the last sort, which is
+  // refined by the next one.
+  struct PreviousOrder
+    {
+    vtkWeakPointer<vtkPolyData> Input;
+    unsigned long MTime;
+    vtkSmartPointer<vtkIdList> Order;
+    };
+  typedef std::map<vtkPolyData*, PreviousOrder> OrderMap;
+
+  // orders of the last sort, and of the one in progress.
+  OrderMap Orders;
+  OrderMap NewOrders;
+};
+
 //-----------------------------------------------------------------------------
 vtkStandardNewMacro(vtkDepthSortPainter)
 //-----------------------------------------------------------------------------
 vtkCxxSetObjectMacro(vtkDepthSortPainter,DepthSortPolyData,vtkDepthSortPolyData)
 ;
+vtkCxxSetObjectMacro(vtkDepthSortPainter,DepthSortPoints,vtkDepthSortPoints)
+;
 vtkCxxSetObjectMacro(vtkDepthSortPainter,OutputData,vtkDataObject)
 ;
 
@@ -74,18 +100,25 @@ vtkDepthSortPainter::vtkDepthSortPainter()
   this->CachedIsTextureSemiTranslucent = 1;
   this->CachedIsColorSemiTranslucent = 1;
   this->DepthSortPolyData = vtkDepthSortPolyData::New();
+  this->DepthSortPoints = vtkDepthSortPoints::New();
   this->OutputData = NULL;
+  this->Internals = new vtkInternals;
 }
 //-----------------------------------------------------------------------------
 vtkDepthSortPainter::~vtkDepthSortPainter()
 {
   this->SetDepthSortPolyData(NULL);
+  this->SetDepthSortPoints(NULL);
   this->SetOutputData(NULL);
+  delete this->Internals;
 }
 //-----------------------------------------------------------------------------
 void vtkDepthSortPainter::PrintSelf(ostream &os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "DepthSortEnableMode: " << this->DepthSortEnableMode << endl;
+  os << indent << "DepthSortPolyData: " << this->DepthSortPolyData << endl;
+  os << indent << "DepthSortPoints: " << this->DepthSortPoints << endl;
 }
 
 //-----------------------------------------------------------------------------
@@ -120,6 +153,7 @@ void vtkDepthSortPainter::PrepareForRendering(vtkRenderer* renderer,
 
   if (this->DepthSortPolyData != NULL && this->NeedSorting(renderer, actor))
     {
+    this->Internals->NewOrders.clear();
     if (input->IsA("vtkCompositeDataSet"))
       {
       vtkCompositeDataSet* cdInput = vtkCompositeDataSet::SafeDownCast(input);
@@ -134,6 +168,14 @@ void vtkDepthSortPainter::PrepareForRendering(vtkRenderer* renderer,
             iter));
         if (pdInput && pdOutput)
           {
+          if (pdOutput == pdInput)
+            {
+            // the shallow copy shares the leaves, sort a copy of the input.
+            pdOutput = pdInput->NewInstance();
+            pdOutput->ShallowCopy(pdInput);
+            cdOutput->SetDataSet(iter, pdOutput);
+            pdOutput->Delete();
+            }
           this->Sort(pdOutput, pdInput, renderer, actor);
           }
         }
@@ -145,15 +187,26 @@ void vtkDepthSortPainter::PrepareForRendering(vtkRenderer* renderer,
       this->Sort(vtkDataSet::SafeDownCast(this->OutputData),
           vtkDataSet::SafeDownCast(input), renderer, actor);
       }
+    this->Internals->Orders.swap(this->Internals->NewOrders);
+    this->Internals->NewOrders.clear();
     this->SortTime.Modified();
     }
 }
 
+//-----------------------------------------------------------------------------
 void vtkDepthSortPainter::Sort(vtkDataSet* output,
     vtkDataSet* input,
-    vtkRenderer* vtkNotUsed(renderer),
-    vtkActor* vtkNotUsed(actor))
+    vtkRenderer* renderer,
+    vtkActor* actor)
 {
+  vtkPolyData* pdInput = vtkPolyData::SafeDownCast(input);
+  vtkPolyData* pdOutput = vtkPolyData::SafeDownCast(output);
+  if (pdInput && pdOutput &&
+      this->SortPoints(pdOutput, pdInput, renderer, actor))
+    {
+    return;
+    }
+
   this->DepthSortPolyData->SetInputData(input);
 
   this->DepthSortPolyData->Update();
@@ -163,6 +216,112 @@ void vtkDepthSortPainter::Sort(vtkDataSet* output,
   output->ShallowCopy(polyData);
 }
 
+//-----------------------------------------------------------------------------
+bool vtkDepthSortPainter::SortPoints(vtkPolyData* output,
+    vtkPolyData* input,
+    vtkRenderer* renderer,
+    vtkActor* actor)
+{
+  // only datasets made of vertices of one point, with named cell arrays
+  // which can be replaced by their sorted copy.
+  vtkCellArray* verts = input->GetVerts();
+  vtkIdType nVerts = verts ? verts->GetNumberOfCells() : 0;
+  if (this->DepthSortPoints == NULL || input->GetPoints() == NULL
+      || nVerts == 0 || input->GetNumberOfLines() != 0
+      || input->GetNumberOfPolys() != 0 || input->GetNumberOfStrips() != 0
+      || verts->GetNumberOfConnectivityEntries() != 2 * nVerts)
+    {
+    return false;
+    }
+  vtkCellData* inCD = input->GetCellData();
+  for (int i = 0; i < inCD->GetNumberOfArrays(); i++)
+    {
+    vtkAbstractArray* array = inCD->GetAbstractArray(i);
+    if (!array || !array->GetName())
+      {
+      return false;
+      }
+    }
+
+  // the view direction in the coordinates of the dataset, as computed by
+  // vtkDepthSortPolyData.
+  vtkCamera* camera = renderer->GetActiveCamera();
+  double position[4], focalPoint[4];
+  camera->GetPosition(position);
+  camera->GetFocalPoint(focalPoint);
+  position[3] = focalPoint[3] = 1.0;
+  double origin[4], target[4];
+  if (actor)
+    {
+    vtkNew<vtkMatrix4x4> inverse;
+    vtkMatrix4x4::Invert(actor->GetMatrix(), inverse.GetPointer());
+    inverse->MultiplyPoint(position, origin);
+    inverse->MultiplyPoint(focalPoint, target);
+    }
+  else
+    {
+    std::copy(position, position + 4, origin);
+    std::copy(focalPoint, focalPoint + 4, target);
+    }
+  double direction[3];
+  for (int i = 0; i < 3; i++)
+    {
+    direction[i] = target[i] - origin[i];
+    }
+
+  // start from the order of the last sort of this input, if it did not
+  // change since.
+  vtkInternals::PreviousOrder& previous = this->Internals->NewOrders[input];
+  vtkInternals::OrderMap::iterator it = this->Internals->Orders.find(input);
+  if (it != this->Internals->Orders.end()
+      && it->second.Input.GetPointer() == input
+      && it->second.MTime == input->GetMTime())
+    {
+    previous = it->second;
+    }
+  else
+    {
+    previous.Input = input;
+    previous.MTime = input->GetMTime();
+    previous.Order = vtkSmartPointer<vtkIdList>::New();
+    }
+  vtkIdList* order = previous.Order;
+  this->DepthSortPoints->Sort(input->GetPoints(), verts, origin, direction,
+    order);
+
+  // the vertices, and their data, back to front.
+  vtkNew<vtkIdTypeArray> sortedIds;
+  sortedIds->SetNumberOfValues(2 * nVerts);
+  vtkIdType* sorted = sortedIds->GetPointer(0);
+  const vtkIdType* ids = verts->GetPointer();
+  const vtkIdType* sortedVertIds = order->GetPointer(0);
+  for (vtkIdType i = 0; i < nVerts; i++)
+    {
+    sorted[2 * i] = 1;
+    sorted[2 * i + 1] = ids[2 * sortedVertIds[i] + 1];
+    }
+  vtkNew<vtkCellArray> sortedVerts;
+  sortedVerts->SetCells(nVerts, sortedIds.GetPointer());
+  output->SetVerts(sortedVerts.GetPointer());
+
+  vtkCellData* outCD = output->GetCellData();
+  for (int i = 0; i < inCD->GetNumberOfArrays(); i++)
+    {
+    vtkAbstractArray* array = inCD->GetAbstractArray(i);
+    vtkAbstractArray* sortedArray = array->NewInstance();
+    sortedArray->SetName(array->GetName());
+    sortedArray->SetNumberOfComponents(array->GetNumberOfComponents());
+    sortedArray->CopyComponentNames(array);
+    sortedArray->SetNumberOfTuples(nVerts);
+    array->GetTuples(order, sortedArray);
+    // replaces the array of the same name, keeping its attribute.
+    outCD->AddArray(sortedArray);
+    sortedArray->Delete();
+    }
+  return true;
+}
+
+//-----------------------------------------------------------------------------
 int vtkDepthSortPainter::NeedSorting(vtkRenderer* renderer, vtkActor* actor)
 {
   if (!actor || !renderer)
@@ -32,6 +32,10 @@
 // painter does nothing.
 // This painter is useful with the point sprite painter
 // to sort points when depth peeling is disabled.
+//
+// Datasets made of vertices only are sorted with vtkDepthSortPoints, which
+// refines the order of the previous render when the camera moved. Other
+// datasets are sorted by the vtkDepthSortPolyData filter.
 
 #ifndef vtkDepthSortPainter_h
 #define vtkDepthSortPainter_h
@@ -46,9 +50,11 @@ class vtkIdTypeArray;
 class vtkMatrix4x4;
 class vtkCamera;
 class vtkPoints;
+class vtkPolyData;
 class vtkDataObject;
 class vtkTexture;
 class vtkDepthSortPolyData;
+class vtkDepthSortPoints;
 class vtkUnsignedCharArray;
 
 class VTKPOINTSPRITERENDERING_EXPORT vtkDepthSortPainter : public vtkPainter
@@ -100,6 +106,12 @@ public:
   virtual void  SetDepthSortPolyData(vtkDepthSortPolyData*);
   vtkGetObjectMacro(DepthSortPolyData, vtkDepthSortPolyData);
 
+  // Description:
+  // Set/Get the sort used for the datasets made of vertices only. When NULL
+  // these are sorted by the DepthSortPolyData algorithm too.
+  virtual void  SetDepthSortPoints(vtkDepthSortPoints*);
+  vtkGetObjectMacro(DepthSortPoints, vtkDepthSortPoints);
+
 protected:
   vtkDepthSortPainter();
   virtual ~vtkDepthSortPainter();
@@ -108,6 +120,12 @@ protected:
   // do the sorting for a given dataset
   virtual void Sort(vtkDataSet* output, vtkDataSet* input, vtkRenderer* renderer, vtkActor* actor);
 
+  // Description:
+  // Sort a polydata made of vertices only with DepthSortPoints. Returns false
+  // if the input is not supported, in which case it must be sorted with
+  // DepthSortPolyData.
+  virtual bool SortPoints(vtkPolyData* output, vtkPolyData* input, vtkRenderer* renderer, vtkActor* actor);
+
   // Description:
   // Called just before RenderInternal(). We sort the points here if the
   // renderer's camera has been modified.
@@ -139,6 +157,7 @@ protected:
   vtkTimeStamp          CachedIsColorSemiTranslucentTime;
   int                   CachedIsColorSemiTranslucent;
   vtkDepthSortPolyData* DepthSortPolyData;
+  vtkDepthSortPoints*   DepthSortPoints;
 
   vtkWeakPointer<vtkDataObject> PrevInput;
   vtkWeakPointer<vtkTexture> CachedTexture;
@@ -147,6 +166,9 @@ protected:
 private:
   vtkDepthSortPainter(const vtkDepthSortPainter &) VTK_DELETE_FUNCTION;
   void operator=(const vtkDepthSortPainter &) VTK_DELETE_FUNCTION;
+
+  class vtkInternals;
+  vtkInternals* Internals;
 };
 
 #endif //vtkDepthSortPainter_h
@@ -0,0 +1,390 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkDepthSortPoints.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+// .NAME vtkDepthSortPoints
+// .SECTION Thanks
+// <verbatim>
+//
+//  This file is part of the PointSprites plugin developed and contributed by
+//
+//  Copyright (c) CSCS - Swiss National Supercomputing Centre
+//                EDF - Electricite de France
+//
+//  John Biddiscombe, Ugo Varetto (CSCS)
+//  Stephane Ploix (EDF)
+//
+// </verbatim>
+
+#include "vtkDepthSortPoints.h"
+
+#include "vtkAtomicInt.h"
+#include "vtkCellArray.h"
+#include "vtkIdList.h"
+#include "vtkObjectFactory.h"
+#include "vtkPVSMPTools.h"
+#include "vtkPoints.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+// number of keys counted and scattered together by a radix sort pass,
+// and number of keys of the blocks sorted concurrently by the incremental
+// sort.
+const vtkIdType BLOCK_SIZE = 65536;
+
+// number of moves per key after which the incremental sort gives up, about
+// the cost of the radix sort.
+const vtkIdType MAX_MOVES_PER_KEY = 4;
+
+//-----------------------------------------------------------------------------
+// Maps a depth to an unsigned key that orders back to front : the float bits
+// are made to compare as unsigned integers then complemented.
+inline vtkTypeUInt32 DepthToKey(float depth)
+{
+  vtkTypeUInt32 bits;
+  memcpy(&bits, &depth, sizeof(bits));
+  bits = (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+  return ~bits;
+}
+
+//-----------------------------------------------------------------------------
+template <class Functor>
+void ForEachBlock(int nThreads, vtkIdType nBlocks, Functor& f)
+{
+  vtkPVSMPTools::For(nThreads, 0, nBlocks, 1, f);
+}
+
+//-----------------------------------------------------------------------------
+// Computes the key of each element of the sequence. The elements are the
+// vertices of a cell array ([1, id] pairs) or the points, in the order given
+// by Seed or else in increasing order.
+template <class T>
+class ComputeKeys
+{
+public:
+  const T* Coords;
+  const vtkIdType* Verts;
+  const vtkIdType* Seed;
+  double Origin[3];
+  double Direction[3];
+  vtkTypeUInt32* Keys;
+  vtkIdType* Ids;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+    {
+    for (vtkIdType i = begin; i < end; ++i)
+      {
+      vtkIdType e = this->Seed ? this->Seed[i] : i;
+      vtkIdType pt = this->Verts ? this->Verts[2 * e + 1] : e;
+      const T* x = this->Coords + 3 * pt;
+      double depth = (x[0] - this->Origin[0]) * this->Direction[0] +
+        (x[1] - this->Origin[1]) * this->Direction[1] +
+        (x[2] - this->Origin[2]) * this->Direction[2];
+      this->Keys[i] = DepthToKey(static_cast<float>(depth));
+      this->Ids[i] = e;
+      }
+    }
+};
+
+//-----------------------------------------------------------------------------
+template <class T>
+void ComputeKeysThreaded(int nThreads, vtkIdType n, ComputeKeys<T>& keys)
+{
+  vtkPVSMPTools::For(nThreads, 0, n, BLOCK_SIZE, keys);
+}
+
+//-----------------------------------------------------------------------------
+// Insertion sort of [begin, end), giving up when more than maxMoves elements
+// have been moved. Returns false if it gave up.
+bool InsertionSort(vtkTypeUInt32* keys, vtkIdType* ids, vtkIdType begin,
+  vtkIdType end, vtkIdType maxMoves)
+{
+  vtkIdType moves = 0;
+  for (vtkIdType i = begin + 1; i < end; ++i)
+    {
+    vtkTypeUInt32 key = keys[i];
+    if (keys[i - 1] <= key)
+      {
+      continue;
+      }
+    vtkIdType id = ids[i];
+    vtkIdType j = i;
+    do
+      {
+      keys[j] = keys[j - 1];
+      ids[j] = ids[j - 1];
+      --j;
+      ++moves;
+      }
+    while (j > begin && keys[j - 1] > key);
+    keys[j] = key;
+    ids[j] = id;
+    if (moves > maxMoves)
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+// Insertion sorts the blocks of the sequence, giving up as soon as one of
+// them needs too many moves.
+class SortBlocks
+{
+public:
+  vtkIdType N;
+  vtkTypeUInt32* Keys;
+  vtkIdType* Ids;
+  vtkAtomicInt<int> Failed;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+    {
+    for (vtkIdType b = begin; (b < end) && !this->Failed; ++b)
+      {
+      vtkIdType first = b * BLOCK_SIZE;
+      vtkIdType last = std::min(this->N, first + BLOCK_SIZE);
+      if (!InsertionSort(this->Keys, this->Ids, first, last,
+          MAX_MOVES_PER_KEY * (last - first)))
+        {
+        this->Failed = 1;
+        }
+      }
+    }
+};
+
+//-----------------------------------------------------------------------------
+// Counts the digits of each block for a radix sort pass.
+class CountDigits
+{
+public:
+  vtkIdType N;
+  int Shift;
+  const vtkTypeUInt32* Keys;
+  vtkIdType* Counts;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+    {
+    for (vtkIdType b = begin; b < end; ++b)
+      {
+      vtkIdType* counts = this->Counts + 256 * b;
+      std::fill(counts, counts + 256, 0);
+      vtkIdType last = std::min(this->N, (b + 1) * BLOCK_SIZE);
+      for (vtkIdType i = b * BLOCK_SIZE; i < last; ++i)
+        {
+        ++counts[(this->Keys[i] >> this->Shift) & 0xff];
+        }
+      }
+    }
+};
+
+//-----------------------------------------------------------------------------
+// Scatters each block to the offsets of its digits for a radix sort pass.
+class ScatterDigits
+{
+public:
+  vtkIdType N;
+  int Shift;
+  const vtkTypeUInt32* Keys;
+  const vtkIdType* Ids;
+  const vtkIdType* Offsets;
+  vtkTypeUInt32* OutKeys;
+  vtkIdType* OutIds;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+    {
+    vtkIdType offsets[256];
+    for (vtkIdType b = begin; b < end; ++b)
+      {
+      std::copy(this->Offsets + 256 * b, this->Offsets + 256 * (b + 1), offsets);
+      vtkIdType last = std::min(this->N, (b + 1) * BLOCK_SIZE);
+      for (vtkIdType i = b * BLOCK_SIZE; i < last; ++i)
+        {
+        vtkTypeUInt32 key = this->Keys[i];
+        vtkIdType j = offsets[(key >> this->Shift) & 0xff]++;
+        this->OutKeys[j] = key;
+        this->OutIds[j] = this->Ids[i];
+        }
+      }
+    }
+};
+}
+
+//-----------------------------------------------------------------------------
+class vtkDepthSortPoints::vtkInternals
+{
+public:
+  std::vector<vtkTypeUInt32> Keys;
+  std::vector<vtkTypeUInt32> TmpKeys;
+  std::vector<vtkIdType> TmpIds;
+  std::vector<vtkIdType> Counts;
+
+  // Least significant digit radix sort of the keys and ids. Passes on a
+  // digit shared by all the keys are skipped. Returns the ids buffer which
+  // holds the result.
+  vtkIdType* RadixSort(int nThreads, vtkIdType n, vtkIdType* ids)
+    {
+    vtkIdType nBlocks = (n + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    this->TmpKeys.resize(n);
+    this->TmpIds.resize(n);
+    this->Counts.resize(256 * nBlocks);
+
+    vtkTypeUInt32* keys = &this->Keys[0];
+    vtkTypeUInt32* outKeys = &this->TmpKeys[0];
+    vtkIdType* outIds = &this->TmpIds[0];
+    vtkIdType* counts = &this->Counts[0];
+
+    for (int shift = 0; shift < 32; shift += 8)
+      {
+      CountDigits count;
+      count.N = n;
+      count.Shift = shift;
+      count.Keys = keys;
+      count.Counts = counts;
+      ForEachBlock(nThreads, nBlocks, count);
+
+      // exclusive prefix sum, by digit then by block so that the
+      // sort is stable.
+      vtkIdType offset = 0;
+      bool skip = false;
+      for (int d = 0; (d < 256) && !skip; ++d)
+        {
+        vtkIdType first = offset;
+        for (vtkIdType b = 0; b < nBlocks; ++b)
+          {
+          vtkIdType c = counts[256 * b + d];
+          counts[256 * b + d] = offset;
+          offset += c;
+          }
+        skip = (offset - first == n);
+        }
+      if (skip)
+        {
+        continue;
+        }
+
+      ScatterDigits scatter;
+      scatter.N = n;
+      scatter.Shift = shift;
+      scatter.Keys = keys;
+      scatter.Ids = ids;
+      scatter.Offsets = counts;
+      scatter.OutKeys = outKeys;
+      scatter.OutIds = outIds;
+      ForEachBlock(nThreads, nBlocks, scatter);
+
+      std::swap(keys, outKeys);
+      std::swap(ids, outIds);
+      }
+
+    // the keys of the next incremental sort are computed in Keys.
+    if (keys != &this->Keys[0])
+      {
+      this->Keys.swap(this->TmpKeys);
+      }
+    return ids;
+    }
+};
+
+//-----------------------------------------------------------------------------
+vtkStandardNewMacro(vtkDepthSortPoints)
+
+//-----------------------------------------------------------------------------
+vtkDepthSortPoints::vtkDepthSortPoints()
+{
+  this->NumberOfThreads = 0;
+  this->IncrementalSort = 1;
+  this->LastSortIncremental = 0;
+  this->Internals = new vtkInternals;
+}
+
+//-----------------------------------------------------------------------------
+vtkDepthSortPoints::~vtkDepthSortPoints()
+{
+  delete this->Internals;
+}
+
+//-----------------------------------------------------------------------------
+void vtkDepthSortPoints::PrintSelf(ostream &os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "NumberOfThreads: " << this->NumberOfThreads << endl;
+  os << indent << "IncrementalSort: " << this->IncrementalSort << endl;
+  os << indent << "LastSortIncremental: " << this->LastSortIncremental << endl;
+}
+
+//-----------------------------------------------------------------------------
+void vtkDepthSortPoints::Sort(vtkPoints* points, vtkCellArray* verts,
+  const double origin[3], const double direction[3], vtkIdList* order)
+{
+  this->LastSortIncremental = 0;
+  vtkIdType n = verts ? verts->GetNumberOfCells() : points->GetNumberOfPoints();
+  bool seeded = this->IncrementalSort && n > 0 && order->GetNumberOfIds() == n;
+  order->SetNumberOfIds(n);
+  if (n == 0)
+    {
+    return;
+    }
+
+  int nThreads = this->NumberOfThreads;
+
+  vtkInternals* internals = this->Internals;
+  internals->Keys.resize(n);
+  vtkIdType* ids = order->GetPointer(0);
+
+  // the keys, in the order of the seed when refining it.
+  switch (points->GetDataType())
+    {
+    vtkTemplateMacro(
+      ComputeKeys<VTK_TT> keys;
+      keys.Coords = static_cast<VTK_TT*>(points->GetVoidPointer(0));
+      keys.Verts = verts ? verts->GetPointer() : NULL;
+      keys.Seed = seeded ? ids : NULL;
+      std::copy(origin, origin + 3, keys.Origin);
+      std::copy(direction, direction + 3, keys.Direction);
+      keys.Keys = &internals->Keys[0];
+      keys.Ids = ids;
+      ComputeKeysThreaded(nThreads, n, keys));
+    default:
+      vtkErrorMacro("Unsupported points type " << points->GetDataType());
+      return;
+    }
+
+  if (seeded)
+    {
+    // sort the blocks concurrently then the whole sequence.
+    SortBlocks blocks;
+    blocks.N = n;
+    blocks.Keys = &internals->Keys[0];
+    blocks.Ids = ids;
+    blocks.Failed = 0;
+    ForEachBlock(nThreads, (n + BLOCK_SIZE - 1) / BLOCK_SIZE, blocks);
+    if (!blocks.Failed &&
+      InsertionSort(&internals->Keys[0], ids, 0, n, MAX_MOVES_PER_KEY * n))
+      {
+      this->LastSortIncremental = 1;
+      return;
+      }
+    }
+
+  vtkIdType* sorted = internals->RadixSort(nThreads, n, ids);
+  if (sorted != ids)
+    {
+    std::copy(sorted, sorted + n, ids);
+    }
+}
@@ -0,0 +1,110 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkDepthSortPoints.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+// .NAME vtkDepthSortPoints - threaded radix depth sort of points
+// .SECTION Thanks
+// <verbatim>
+//
+//  This file is part of the PointSprites plugin developed and contributed by
+//
+//  Copyright (c) CSCS - Swiss National Supercomputing Centre
+//                EDF - Electricite de France
+//
+//  John Biddiscombe, Ugo Varetto (CSCS)
+//  Stephane Ploix (EDF)
+//
+// </verbatim>
+// .SECTION Description
+// vtkDepthSortPoints orders points, or vertex cells, back to front along a
+// view direction. It is used by vtkDepthSortPainter in place of
+// vtkDepthSortPolyData for datasets made of vertices only, which is the case
+// of the point sprites.
+//
+// The depths are converted to 32 bit integer keys which are sorted by a least
+// significant digit radix sort, 8 bits per pass. Each pass counts and scatters
+// blocks of the keys in parallel using vtkSMPTools.
+//
+// When IncrementalSort is on and the order passed to Sort() already holds an
+// order of the same points, as after a previous Sort() with another view, this
+// order is refined by an insertion sort. It takes a time linear in the number
+// of points when the view moved slightly. The radix sort is used when the
+// insertion sort makes more than a few moves per point.
+//
+// .SECTION See Also
+// vtkDepthSortPainter vtkDepthSortPolyData
+
+#ifndef vtkDepthSortPoints_h
+#define vtkDepthSortPoints_h
+
+#include "vtkPointSpriteRenderingModule.h" //needed for exports
+#include "vtkObject.h"
+
+class vtkCellArray;
+class vtkIdList;
+class vtkPoints;
+
+class VTKPOINTSPRITERENDERING_EXPORT vtkDepthSortPoints : public vtkObject
+{
+public:
+  vtkTypeMacro(vtkDepthSortPoints, vtkObject);
+  virtual void PrintSelf(ostream &os, vtkIndent indent);
+  static vtkDepthSortPoints *New();
+
+  // Description:
+  // Set the number of threads used by the sort. 0, the default, uses the
+  // number of threads of vtkSMPTools, larger values use at most that many of
+  // them for this sort only. 1 sorts on the calling thread.
+  vtkSetClampMacro(NumberOfThreads, int, 0, VTK_INT_MAX);
+  vtkGetMacro(NumberOfThreads, int);
+
+  // Description:
+  // Enable or disable refining the order passed to Sort(), if any, instead
+  // of sorting from scratch. On by default.
+  vtkSetMacro(IncrementalSort, int);
+  vtkGetMacro(IncrementalSort, int);
+  vtkBooleanMacro(IncrementalSort, int);
+
+  // Description:
+  // Sort the vertices of verts, or all of the points when verts is NULL,
+  // back to front along direction, that is by decreasing
+  // (x - origin).direction. verts must contain only cells of one point.
+  // On return order holds the indices of the vertices (or the point ids),
+  // the farthest first. If it holds as many ids when called, it is used
+  // as a starting point when IncrementalSort is on.
+  virtual void Sort(vtkPoints* points, vtkCellArray* verts,
+    const double origin[3], const double direction[3], vtkIdList* order);
+
+  // Description:
+  // Returns 1 if the last Sort() refined the order it was given, 0 if it
+  // used the radix sort.
+  vtkGetMacro(LastSortIncremental, int);
+
+protected:
+  vtkDepthSortPoints();
+  ~vtkDepthSortPoints();
+
+  int NumberOfThreads;
+  int IncrementalSort;
+  int LastSortIncremental;
+
+private:
+  vtkDepthSortPoints(const vtkDepthSortPoints &) VTK_DELETE_FUNCTION;
+  void operator=(const vtkDepthSortPoints &) VTK_DELETE_FUNCTION;
+
+  class vtkInternals;
+  vtkInternals* Internals;
+};
+
+#endif //vtkDepthSortPoints_h
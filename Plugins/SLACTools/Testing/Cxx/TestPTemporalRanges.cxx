@@ -0,0 +1,248 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestPTemporalRanges.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Computes the temporal ranges of a distributed dataset with the data
+// partitioned between the processes and with the time steps partitioned
+// between them, and checks the statistics on the root process, including the
+// variance merged across the processes. In time parallel mode each process
+// must only execute the upstream pipeline for its own time steps, and once
+// all the time steps are known the upstream pipeline must not execute again.
+
+#include "vtkCommunicator.h"
+#include "vtkDoubleArray.h"
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkMPIController.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkPolyDataAlgorithm.h"
+#include "vtkPTemporalRanges.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkTable.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace
+{
+  const int NumberOfTimeSteps = 10;
+  const int NumberOfPoints = 30;
+
+  double GetValue(double time, int point)
+    {
+    return std::sin(time + 0.3 * point) * (point + 1);
+    }
+
+  // A row of points whose "Value" depends on the time step, split evenly
+  // between the pieces requested. The number of executions is counted to
+  // check which time steps are read.
+  class vtkTimeStepsSource : public vtkPolyDataAlgorithm
+  {
+  public:
+    static vtkTimeStepsSource* New();
+    vtkTypeMacro(vtkTimeStepsSource, vtkPolyDataAlgorithm);
+
+    int NumberOfExecutions;
+
+  protected:
+    vtkTimeStepsSource()
+      {
+      this->NumberOfExecutions = 0;
+      this->SetNumberOfInputPorts(0);
+      }
+
+    virtual int RequestInformation(vtkInformation*, vtkInformationVector**,
+      vtkInformationVector* outputVector)
+      {
+      vtkInformation* outInfo = outputVector->GetInformationObject(0);
+      double times[NumberOfTimeSteps];
+      for (int cc=0; cc < NumberOfTimeSteps; cc++)
+        {
+        times[cc] = cc;
+        }
+      double range[2] = { times[0], times[NumberOfTimeSteps - 1] };
+      outInfo->Set(vtkStreamingDemandDrivenPipeline::TIME_STEPS(), times,
+        NumberOfTimeSteps);
+      outInfo->Set(vtkStreamingDemandDrivenPipeline::TIME_RANGE(), range, 2);
+      outInfo->Set(CAN_HANDLE_PIECE_REQUEST(), 1);
+      return 1;
+      }
+
+    virtual int RequestData(vtkInformation*, vtkInformationVector**,
+      vtkInformationVector* outputVector)
+      {
+      vtkInformation* outInfo = outputVector->GetInformationObject(0);
+      vtkPolyData* output = vtkPolyData::GetData(outInfo);
+      this->NumberOfExecutions++;
+      int piece = outInfo->Get(
+        vtkStreamingDemandDrivenPipeline::UPDATE_PIECE_NUMBER());
+      int numPieces = outInfo->Get(
+        vtkStreamingDemandDrivenPipeline::UPDATE_NUMBER_OF_PIECES());
+      double time = outInfo->Get(
+        vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEP());
+      vtkNew<vtkPoints> points;
+      vtkNew<vtkDoubleArray> values;
+      values->SetName("Value");
+      int end = NumberOfPoints * (piece + 1) / numPieces;
+      for (int cc=NumberOfPoints * piece / numPieces; cc < end; cc++)
+        {
+        points->InsertNextPoint(cc, 0.0, 0.0);
+        values->InsertNextValue(GetValue(time, cc));
+        }
+      output->SetPoints(points.GetPointer());
+      output->GetPointData()->AddArray(values.GetPointer());
+      output->GetInformation()->Set(vtkDataObject::DATA_TIME_STEP(), time);
+      return 1;
+      }
+
+  private:
+    vtkTimeStepsSource(const vtkTimeStepsSource&) VTK_DELETE_FUNCTION;
+    void operator=(const vtkTimeStepsSource&) VTK_DELETE_FUNCTION;
+  };
+  vtkStandardNewMacro(vtkTimeStepsSource);
+
+  // Checks the statistics of "Value" over all the points and time steps.
+  bool CheckStatistics(vtkTable* output)
+    {
+    double expected[vtkTemporalRanges::NUMBER_OF_ROWS];
+    int count = NumberOfTimeSteps * NumberOfPoints;
+    double sum = 0.0;
+    expected[vtkTemporalRanges::MINIMUM_ROW] = VTK_DOUBLE_MAX;
+    expected[vtkTemporalRanges::MAXIMUM_ROW] = -VTK_DOUBLE_MAX;
+    for (int t=0; t < NumberOfTimeSteps; t++)
+      {
+      for (int cc=0; cc < NumberOfPoints; cc++)
+        {
+        double value = GetValue(t, cc);
+        sum += value;
+        expected[vtkTemporalRanges::MINIMUM_ROW] =
+          std::min(expected[vtkTemporalRanges::MINIMUM_ROW], value);
+        expected[vtkTemporalRanges::MAXIMUM_ROW] =
+          std::max(expected[vtkTemporalRanges::MAXIMUM_ROW], value);
+        }
+      }
+    double average = sum / count;
+    double squaredDifferences = 0.0;
+    for (int t=0; t < NumberOfTimeSteps; t++)
+      {
+      for (int cc=0; cc < NumberOfPoints; cc++)
+        {
+        double difference = GetValue(t, cc) - average;
+        squaredDifferences += difference * difference;
+        }
+      }
+    expected[vtkTemporalRanges::AVERAGE_ROW] = average;
+    expected[vtkTemporalRanges::COUNT_ROW] = count;
+    expected[vtkTemporalRanges::VARIANCE_ROW] = squaredDifferences / count;
+
+    vtkDoubleArray* column =
+      vtkDoubleArray::SafeDownCast(output->GetColumnByName("Value"));
+    if (!column ||
+      column->GetNumberOfTuples() != vtkTemporalRanges::NUMBER_OF_ROWS)
+      {
+      std::cerr << "Missing Value column." << std::endl;
+      return false;
+      }
+    for (int row=0; row < vtkTemporalRanges::NUMBER_OF_ROWS; row++)
+      {
+      if (std::fabs(column->GetValue(row) - expected[row]) >
+        1e-9 * std::max(1.0, std::fabs(expected[row])))
+        {
+        std::cerr << "Wrong value at row " << row << ": "
+          << column->GetValue(row) << " instead of " << expected[row]
+          << std::endl;
+        return false;
+        }
+      }
+    return true;
+    }
+}
+
+#define TEST_ASSERT(condition, message) \
+  if (!(condition)) \
+    { \
+    std::cerr << "ERROR: " << message << std::endl; \
+    status = 0; \
+    }
+
+int TestPTemporalRanges(int argc, char* argv[])
+{
+  vtkNew<vtkMPIController> controller;
+  controller->Initialize(&argc, &argv, 0);
+  vtkMultiProcessController::SetGlobalController(controller.GetPointer());
+  int rank = controller->GetLocalProcessId();
+  int numProcs = controller->GetNumberOfProcesses();
+  int status = 1;
+
+    {
+    // Data parallel: every process reads all the time steps, and the
+    // statistics of the pieces are merged on the root.
+    vtkNew<vtkTimeStepsSource> dataSource;
+    vtkNew<vtkPTemporalRanges> dataRanges;
+    dataRanges->SetController(controller.GetPointer());
+    dataRanges->SetInputConnection(dataSource->GetOutputPort());
+    dataRanges->UpdatePiece(rank, numProcs, 0);
+    TEST_ASSERT(dataSource->NumberOfExecutions == NumberOfTimeSteps,
+      "Data parallel mode read " << dataSource->NumberOfExecutions
+      << " time steps on process " << rank << ".");
+    TEST_ASSERT(rank != 0 || CheckStatistics(dataRanges->GetOutput()),
+      "Wrong statistics in data parallel mode.");
+
+    // All the time steps are known: the filter executes without updating its
+    // input.
+    dataRanges->Modified();
+    dataRanges->UpdatePiece(rank, numProcs, 0);
+    TEST_ASSERT(dataSource->NumberOfExecutions == NumberOfTimeSteps,
+      "The input was updated again in data parallel mode on process "
+      << rank << ".");
+    TEST_ASSERT(rank != 0 || CheckStatistics(dataRanges->GetOutput()),
+      "Wrong statistics after executing again in data parallel mode.");
+
+    // Time parallel: each process reads its own contiguous time steps
+    // entirely.
+    vtkNew<vtkTimeStepsSource> timeSource;
+    vtkNew<vtkPTemporalRanges> timeRanges;
+    timeRanges->SetController(controller.GetPointer());
+    timeRanges->TimeParallelOn();
+    timeRanges->SetInputConnection(timeSource->GetOutputPort());
+    timeRanges->UpdatePiece(rank, numProcs, 0);
+    int localSteps = NumberOfTimeSteps * (rank + 1) / numProcs
+      - NumberOfTimeSteps * rank / numProcs;
+    TEST_ASSERT(timeSource->NumberOfExecutions == localSteps,
+      "Time parallel mode read " << timeSource->NumberOfExecutions
+      << " time steps instead of " << localSteps << " on process " << rank
+      << ".");
+    TEST_ASSERT(rank != 0 || CheckStatistics(timeRanges->GetOutput()),
+      "Wrong statistics in time parallel mode.");
+
+    timeRanges->Modified();
+    timeRanges->UpdatePiece(rank, numProcs, 0);
+    TEST_ASSERT(timeSource->NumberOfExecutions == localSteps,
+      "The input was updated again in time parallel mode on process "
+      << rank << ".");
+    TEST_ASSERT(rank != 0 || CheckStatistics(timeRanges->GetOutput()),
+      "Wrong statistics after executing again in time parallel mode.");
+    }
+
+  int globalStatus = 0;
+  controller->AllReduce(&status, &globalStatus, 1, vtkCommunicator::MIN_OP);
+
+  vtkMultiProcessController::SetGlobalController(NULL);
+  controller->Finalize();
+  return globalStatus ? EXIT_SUCCESS : EXIT_FAILURE;
+}
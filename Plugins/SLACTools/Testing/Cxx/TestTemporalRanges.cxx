@@ -0,0 +1,193 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestTemporalRanges.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Computes the temporal ranges of the SLAC pic-example with a cache file, and
+// checks that appending a mode file only reads its time step, that a new
+// filter reuses the statistics of the cache file, and that the cache file is
+// reset for other reader settings. The results must match those of a filter
+// reading all the time steps at once.
+
+#include "vtkDoubleArray.h"
+#include "vtkNew.h"
+#include "vtkSLACReader.h"
+#include "vtkTable.h"
+#include "vtkTemporalRanges.h"
+#include "vtkTestUtilities.h"
+
+#include <vtksys/SystemTools.hxx>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+
+namespace
+{
+  // Number of statistics lines for each time in the cache file, and its
+  // identity line.
+  std::map<double, int> ReadCacheFile(const std::string& fileName,
+    std::string& identity)
+    {
+    std::map<double, int> lines;
+    std::ifstream file(fileName.c_str());
+    std::string line;
+    std::getline(file, line);
+    std::getline(file, identity);
+    while (std::getline(file, line))
+      {
+      if (!line.empty() && line[0] != '#')
+        {
+        double time;
+        std::istringstream(line) >> time;
+        lines[time]++;
+        }
+      }
+    return lines;
+    }
+
+  bool CompareTables(vtkTable* result, vtkTable* baseline)
+    {
+    int numberOfColumns = 0;
+    for (vtkIdType c=0; c < baseline->GetNumberOfColumns(); c++)
+      {
+      vtkDoubleArray* expected =
+        vtkDoubleArray::SafeDownCast(baseline->GetColumn(c));
+      if (!expected)
+        {
+        continue;
+        }
+      numberOfColumns++;
+      vtkDoubleArray* column = vtkDoubleArray::SafeDownCast(
+        result->GetColumnByName(expected->GetName()));
+      if (!column)
+        {
+        std::cerr << "Missing column " << expected->GetName() << std::endl;
+        return false;
+        }
+      for (int row=0; row < vtkTemporalRanges::NUMBER_OF_ROWS; row++)
+        {
+        double value = expected->GetValue(row);
+        if (std::fabs(column->GetValue(row) - value) >
+          1e-9 * std::max(1.0, std::fabs(value)))
+          {
+          std::cerr << "Different value in " << expected->GetName()
+            << " at row " << row << ": " << column->GetValue(row)
+            << " instead of " << value << std::endl;
+          return false;
+          }
+        }
+      }
+    if (numberOfColumns == 0 ||
+      result->GetNumberOfColumns() != baseline->GetNumberOfColumns())
+      {
+      std::cerr << "Different columns." << std::endl;
+      return false;
+      }
+    return true;
+    }
+}
+
+#define TEST_ASSERT(condition, message) \
+  if (!(condition)) \
+    { \
+    std::cerr << "ERROR: " << message << std::endl; \
+    return EXIT_FAILURE; \
+    }
+
+int TestTemporalRanges(int argc, char* argv[])
+{
+  char* data = vtkTestUtilities::GetDataRoot(argc, argv);
+  std::string dataDir = std::string(data) + "/SLAC/pic-example/";
+  delete [] data;
+  char* temp = vtkTestUtilities::GetArgOrEnvOrDefault(
+    "-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  std::string cacheFileName = std::string(temp) + "/TestTemporalRanges.cache";
+  delete [] temp;
+  vtksys::SystemTools::RemoveFile(cacheFileName.c_str());
+
+  std::string meshFileName = dataDir + "mesh.ncdf";
+  std::string firstModeFileName = dataDir + "fields_4.mod";
+  std::string secondModeFileName = dataDir + "fields_5.mod";
+
+  // All the time steps at once, without cache.
+  vtkNew<vtkSLACReader> allReader;
+  allReader->SetMeshFileName(meshFileName.c_str());
+  allReader->AddModeFileName(firstModeFileName.c_str());
+  allReader->AddModeFileName(secondModeFileName.c_str());
+  vtkNew<vtkTemporalRanges> allRanges;
+  allRanges->SetInputConnection(allReader->GetOutputPort(0));
+  allRanges->Update();
+  vtkTable* baseline = allRanges->GetOutput();
+
+  // The first time step only.
+  vtkNew<vtkSLACReader> reader;
+  reader->SetMeshFileName(meshFileName.c_str());
+  reader->AddModeFileName(firstModeFileName.c_str());
+  vtkNew<vtkTemporalRanges> ranges;
+  ranges->SetInputConnection(reader->GetOutputPort(0));
+  ranges->SetCacheFileName(cacheFileName.c_str());
+  ranges->Update();
+  std::string identity;
+  std::map<double, int> lines = ReadCacheFile(cacheFileName, identity);
+  TEST_ASSERT(lines.size() == 1 && lines.begin()->second > 0,
+    "The statistics of the first time step were not cached.");
+  double firstTime = lines.begin()->first;
+  int numberOfColumns = lines.begin()->second;
+
+  // Appending a mode file only reads the new time step: the statistics of the
+  // first one are not computed, nor cached, again.
+  reader->AddModeFileName(secondModeFileName.c_str());
+  ranges->Update();
+  lines = ReadCacheFile(cacheFileName, identity);
+  TEST_ASSERT(lines.size() == 2 && lines[firstTime] == numberOfColumns,
+    "The first time step was read again after appending a mode file.");
+  TEST_ASSERT(CompareTables(ranges->GetOutput(), baseline),
+    "Appending a mode file gave different statistics.");
+
+  // A new filter reuses the statistics of the cache file.
+  std::ifstream::pos_type cacheSize =
+    std::ifstream(cacheFileName.c_str(), std::ios::ate).tellg();
+  vtkNew<vtkTemporalRanges> reloaded;
+  reloaded->SetInputConnection(reader->GetOutputPort(0));
+  reloaded->SetCacheFileName(cacheFileName.c_str());
+  reloaded->Update();
+  TEST_ASSERT(
+    std::ifstream(cacheFileName.c_str(), std::ios::ate).tellg() == cacheSize,
+    "The statistics of the cache file were computed again.");
+  TEST_ASSERT(CompareTables(reloaded->GetOutput(), baseline),
+    "The cache file gave different statistics.");
+
+  // Other reader settings make the cache file stale: it is reset, then holds
+  // the statistics of each time step once.
+  vtkNew<vtkSLACReader> otherReader;
+  otherReader->SetMeshFileName(meshFileName.c_str());
+  otherReader->AddModeFileName(firstModeFileName.c_str());
+  otherReader->AddModeFileName(secondModeFileName.c_str());
+  otherReader->SetReadMidpoints(!reader->GetReadMidpoints());
+  vtkNew<vtkTemporalRanges> reset;
+  reset->SetInputConnection(otherReader->GetOutputPort(0));
+  reset->SetCacheFileName(cacheFileName.c_str());
+  reset->Update();
+  std::string otherIdentity;
+  std::map<double, int> otherLines =
+    ReadCacheFile(cacheFileName, otherIdentity);
+  TEST_ASSERT(otherIdentity != identity && otherLines == lines,
+    "The cache file was not reset for other reader settings.");
+
+  vtksys::SystemTools::RemoveFile(cacheFileName.c_str());
+  return EXIT_SUCCESS;
+}
@@ -20,8 +20,14 @@
 
 #include "vtkPTemporalRanges.h"
 
+#include "vtkDataArray.h"
+#include "vtkDataObject.h"
+#include "vtkFieldData.h"
+#include "vtkIdList.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkMultiBlockDataSetAlgorithm.h"
 #include "vtkMultiProcessController.h"
 #include "vtkObjectFactory.h"
 #include "vtkReductionFilter.h"
@@ -32,12 +38,18 @@
 #define VTK_CREATE(type, name) \
   vtkSmartPointer<type> name = vtkSmartPointer<type>::New()
 
+#include <map>
+
 //=============================================================================
 //=============================================================================
-class vtkPTemporalRanges::vtkRangeTableReduction : public vtkTableAlgorithm
+// Merges the statistics of the time steps computed by each process, given as
+// multiblocks of tables with a "Time" field data array.
+class vtkPTemporalRanges::vtkRangeTableReduction
+  : public vtkMultiBlockDataSetAlgorithm
 {
 public:
-  vtkTypeMacro(vtkPTemporalRanges::vtkRangeTableReduction, vtkTableAlgorithm);
+  vtkTypeMacro(vtkPTemporalRanges::vtkRangeTableReduction,
+               vtkMultiBlockDataSetAlgorithm);
   static vtkRangeTableReduction *New() {
     // Just registers with debug leaks.  Not expecting a result.
     vtkObjectFactory::CreateInstance("vtkPTemporalRanges::vtkRangeTableReduction");
@@ -75,14 +87,43 @@ int vtkPTemporalRanges::vtkRangeTableReduction::RequestData(
                                             vtkInformationVector *outputVector)
 {
   int numInputs = inputVector[0]->GetNumberOfInformationObjects();
-  vtkTable *output = vtkTable::GetData(outputVector);
-
-  this->Parent->InitializeTable(output);
+  vtkMultiBlockDataSet *output = vtkMultiBlockDataSet::GetData(outputVector);
 
+  // Tables without time come from an input without time steps.
+  std::map<double, vtkSmartPointer<vtkTable> > timeSteps;
+  vtkSmartPointer<vtkTable> untimed;
   for (int i = 0; i < numInputs; i++)
     {
-    vtkTable *input = vtkTable::GetData(inputVector[0], i);
-    this->Parent->AccumulateTable(input, output);
+    vtkMultiBlockDataSet *input = vtkMultiBlockDataSet::GetData(inputVector[0], i);
+    if (!input) continue;
+    for (unsigned int b = 0; b < input->GetNumberOfBlocks(); b++)
+      {
+      vtkTable *timeStep = vtkTable::SafeDownCast(input->GetBlock(b));
+      if (!timeStep) continue;
+      vtkDataArray *time = timeStep->GetFieldData()->GetArray("Time");
+      vtkSmartPointer<vtkTable> &merged
+        = time ? timeSteps[time->GetTuple1(0)] : untimed;
+      if (!merged)
+        {
+        merged = vtkSmartPointer<vtkTable>::New();
+        this->Parent->InitializeTable(merged);
+        if (time)
+          {
+          merged->GetFieldData()->AddArray(time);
+          }
+        }
+      this->Parent->AccumulateTable(timeStep, merged);
+      }
+    }
+
+  if (untimed)
+    {
+    output->SetBlock(output->GetNumberOfBlocks(), untimed);
+    }
+  std::map<double, vtkSmartPointer<vtkTable> >::iterator iter;
+  for (iter = timeSteps.begin(); iter != timeSteps.end(); ++iter)
+    {
+    output->SetBlock(output->GetNumberOfBlocks(), iter->second);
     }
 
   return 1;
@@ -100,6 +141,7 @@ vtkPTemporalRanges::vtkPTemporalRanges()
 {
   this->Controller = NULL;
   this->SetController(vtkMultiProcessController::GetGlobalController());
+  this->TimeParallel = false;
 }
 
 vtkPTemporalRanges::~vtkPTemporalRanges()
@@ -112,35 +154,114 @@ void vtkPTemporalRanges::PrintSelf(ostream &os, vtkIndent indent)
   this->Superclass::PrintSelf(os, indent);
 
   os << indent << "Controller: " << this->Controller << endl;
+  os << indent << "TimeParallel: " << this->TimeParallel << endl;
 }
 
 //-----------------------------------------------------------------------------
-int vtkPTemporalRanges::RequestData(vtkInformation *request,
-                                    vtkInformationVector **inputVector,
-                                    vtkInformationVector *outputVector)
+int vtkPTemporalRanges::RequestUpdateExtent(vtkInformation *request,
+                                            vtkInformationVector **inputVector,
+                                            vtkInformationVector *outputVector)
 {
-  if (!this->Superclass::RequestData(request, inputVector, outputVector))
+  if (!this->Superclass::RequestUpdateExtent(request, inputVector,
+                                             outputVector))
     {
     return 0;
     }
 
-  if (!request->Has(vtkStreamingDemandDrivenPipeline::CONTINUE_EXECUTING()))
+  vtkInformation *inInfo = inputVector[0]->GetInformationObject(0);
+  if (this->PendingTimeSteps->GetNumberOfIds() == 0)
     {
-    // Finished last execution.  Reduce tables.
-    this->Reduce(vtkTable::GetData(outputVector));
+    // Nothing to read on this process. Request the piece the input already
+    // holds, as the superclass does for the time step, so that the upstream
+    // pipeline does not execute.
+    vtkDataObject *input = vtkDataObject::GetData(inInfo);
+    vtkInformation *dataInfo = input ? input->GetInformation() : NULL;
+    if (dataInfo && dataInfo->Has(vtkDataObject::DATA_PIECE_NUMBER()))
+      {
+      inInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_PIECE_NUMBER(),
+        dataInfo->Get(vtkDataObject::DATA_PIECE_NUMBER()));
+      inInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_NUMBER_OF_PIECES(),
+        dataInfo->Get(vtkDataObject::DATA_NUMBER_OF_PIECES()));
+      inInfo->Set(
+        vtkStreamingDemandDrivenPipeline::UPDATE_NUMBER_OF_GHOST_LEVELS(),
+        dataInfo->Get(vtkDataObject::DATA_NUMBER_OF_GHOST_LEVELS()));
+      }
+    return 1;
+    }
+
+  if (   this->TimeParallel && this->Controller
+      && (this->Controller->GetNumberOfProcesses() > 1) )
+    {
+    // Each process reads the whole data for its own time steps.
+    inInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_PIECE_NUMBER(), 0);
+    inInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_NUMBER_OF_PIECES(), 1);
+    inInfo->Set(
+      vtkStreamingDemandDrivenPipeline::UPDATE_NUMBER_OF_GHOST_LEVELS(), 0);
     }
 
   return 1;
 }
 
 //-----------------------------------------------------------------------------
-void vtkPTemporalRanges::Reduce(vtkTable *table)
+void vtkPTemporalRanges::PrepareTimeSteps(vtkInformation *inInfo)
 {
   if (!this->Controller || (this->Controller->GetNumberOfProcesses() <= 1))
     {
+    this->Superclass::PrepareTimeSteps(inInfo);
     return;
     }
 
+  // The root process holds the statistics of the time steps, and decides
+  // which ones need to be executed.
+  int procId = this->Controller->GetLocalProcessId();
+  int numProcs = this->Controller->GetNumberOfProcesses();
+  if (procId == 0)
+    {
+    this->Superclass::PrepareTimeSteps(inInfo);
+    }
+  else
+    {
+    this->PendingTimeSteps->Reset();
+    this->NewTimeSteps->Initialize();
+    }
+
+  vtkIdType numPending = this->PendingTimeSteps->GetNumberOfIds();
+  this->Controller->Broadcast(&numPending, 1, 0);
+  this->PendingTimeSteps->SetNumberOfIds(numPending);
+  if (numPending > 0)
+    {
+    this->Controller->Broadcast(this->PendingTimeSteps->GetPointer(0),
+                                numPending, 0);
+    }
+
+  if (this->TimeParallel)
+    {
+    // Contiguous ranges of time steps, so that readers caching consecutive
+    // time steps help. Without time steps, only the root reads the data.
+    vtkIdType begin = numPending*procId/numProcs;
+    vtkIdType end = numPending*(procId + 1)/numProcs;
+    if ((numPending == 1) && (this->PendingTimeSteps->GetId(0) < 0))
+      {
+      begin = 0;
+      end = (procId == 0) ? 1 : 0;
+      }
+    VTK_CREATE(vtkIdList, localTimeSteps);
+    for (vtkIdType i = begin; i < end; i++)
+      {
+      localTimeSteps->InsertNextId(this->PendingTimeSteps->GetId(i));
+      }
+    this->PendingTimeSteps->DeepCopy(localTimeSteps);
+    }
+}
+
+//-----------------------------------------------------------------------------
+bool vtkPTemporalRanges::GatherTimeSteps()
+{
+  if (!this->Controller || (this->Controller->GetNumberOfProcesses() <= 1))
+    {
+    return true;
+    }
+
   VTK_CREATE(vtkReductionFilter, reduceFilter);
   reduceFilter->SetController(this->Controller);
 
@@ -148,17 +269,22 @@ void vtkPTemporalRanges::Reduce(vtkTable *table)
   reduceOperation->SetParent(this);
   reduceFilter->SetPostGatherHelper(reduceOperation);
 
-  VTK_CREATE(vtkTable, copy);
-  copy->ShallowCopy(table);
+  VTK_CREATE(vtkMultiBlockDataSet, copy);
+  copy->ShallowCopy(this->NewTimeSteps);
   reduceFilter->SetInputData(copy);
   reduceFilter->Update();
 
   if (this->Controller->GetLocalProcessId() == 0)
     {
-    table->ShallowCopy(reduceFilter->GetOutput());
-    }
-  else
-    {
-    table->Initialize();
+    vtkMultiBlockDataSet *merged
+      = vtkMultiBlockDataSet::SafeDownCast(reduceFilter->GetOutput());
+    if (merged)
+      {
+      this->NewTimeSteps->ShallowCopy(merged);
+      }
+    return true;
     }
+
+  this->NewTimeSteps->Initialize();
+  return false;
 }
@@ -25,6 +25,12 @@
 // vtkPTemporalRanges works basically like its superclass, vtkTemporalRanges,
 // except that it works in a data parallel manner.
 //
+// When TimeParallel is on, the time steps are instead partitioned between the
+// processes: each process reads the whole data set (piece 0 of 1) for its own
+// time steps only. This requires an upstream pipeline that each process can
+// execute independently. In both cases, the statistics of each time step are
+// merged on the root process, which caches them.
+//
 
 #ifndef vtkPTemporalRanges_h
 #define vtkPTemporalRanges_h
@@ -43,17 +49,26 @@ public:
   vtkGetObjectMacro(Controller, vtkMultiProcessController);
   virtual void SetController(vtkMultiProcessController *);
 
+  // Description:
+  // When on, partition the time steps between the processes instead of
+  // partitioning the data. Default is off.
+  vtkSetMacro(TimeParallel, bool);
+  vtkGetMacro(TimeParallel, bool);
+  vtkBooleanMacro(TimeParallel, bool);
+
 protected:
   vtkPTemporalRanges();
   ~vtkPTemporalRanges();
 
   vtkMultiProcessController *Controller;
+  bool TimeParallel;
 
-  virtual int RequestData(vtkInformation *,
-                          vtkInformationVector **,
-                          vtkInformationVector *);
+  virtual int RequestUpdateExtent(vtkInformation *,
+                                  vtkInformationVector **,
+                                  vtkInformationVector *);
 
-  virtual void Reduce(vtkTable *table);
+  virtual void PrepareTimeSteps(vtkInformation *inInfo);
+  virtual bool GatherTimeSteps();
 
 private:
   vtkPTemporalRanges(const vtkPTemporalRanges &) VTK_DELETE_FUNCTION;
@@ -26,21 +26,29 @@
 #include "vtkDataArray.h"
 #include "vtkDataSet.h"
 #include "vtkDoubleArray.h"
+#include "vtkFieldData.h"
+#include "vtkIdList.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkMath.h"
+#include "vtkMultiBlockDataSet.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkSLACReader.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkStringArray.h"
 #include "vtkTable.h"
 #include "vtkTypeTraits.h"
 
 #include "vtkSmartPointer.h"
+#include <vtksys/SystemTools.hxx>
 #define VTK_CREATE(type, name) \
   vtkSmartPointer<type> name = vtkSmartPointer<type>::New()
 
 #include <algorithm>
+#include <fstream>
+#include <map>
+#include <string>
 #include <vector>
 #include <sstream>
 
@@ -50,8 +58,14 @@ namespace vtkTemporalRangesNamespace{
   const int MINIMUM_ROW = vtkTemporalRanges::MINIMUM_ROW;
   const int MAXIMUM_ROW = vtkTemporalRanges::MAXIMUM_ROW;
   const int COUNT_ROW   = vtkTemporalRanges::COUNT_ROW;
+  const int VARIANCE_ROW = vtkTemporalRanges::VARIANCE_ROW;
   const int NUMBER_OF_ROWS = vtkTemporalRanges::NUMBER_OF_ROWS;
 
+  const char *TIME_ARRAY_NAME = "Time";
+  const char *CACHE_FILE_HEADER = "# vtkTemporalRanges 3";
+  // Prefix of the lines of the cache file recording a mode file.
+  const char *CACHE_FILE_MODE_FILE = "#\t";
+
   inline void InitializeColumn(vtkDoubleArray *column)
   {
     column->SetNumberOfComponents(1);
@@ -61,39 +75,176 @@ namespace vtkTemporalRangesNamespace{
     column->SetValue(MINIMUM_ROW, vtkTypeTraits<double>::Max());
     column->SetValue(MAXIMUM_ROW, vtkTypeTraits<double>::Min());
     column->SetValue(COUNT_ROW,   0.0);
+    column->SetValue(VARIANCE_ROW, 0.0);
   }
 
-  inline void AccumulateValue(double value, vtkDoubleArray *column)
+  // Statistics of the values of an array, using Welford's update of the mean
+  // and of the sum of squared differences from the mean.
+  struct Accumulator
   {
-    if (!vtkMath::IsNan(value))
-      {
-      column->SetValue(AVERAGE_ROW, value + column->GetValue(AVERAGE_ROW));
-      column->SetValue(MINIMUM_ROW, std::min(column->GetValue(MINIMUM_ROW),
-                                                value));
-      column->SetValue(MAXIMUM_ROW, std::max(column->GetValue(MAXIMUM_ROW),
-                                                value));
-      column->SetValue(COUNT_ROW, column->GetValue(COUNT_ROW) + 1);
-      }
-  }
+    double Mean;
+    double SquaredDifferences;
+    double Minimum;
+    double Maximum;
+    double Count;
+
+    Accumulator() : Mean(0.0), SquaredDifferences(0.0),
+                    Minimum(vtkTypeTraits<double>::Max()),
+                    Maximum(vtkTypeTraits<double>::Min()), Count(0.0) {}
+
+    inline void AccumulateValue(double value)
+    {
+      if (!vtkMath::IsNan(value))
+        {
+        this->Count += 1;
+        double delta = value - this->Mean;
+        this->Mean += delta/this->Count;
+        this->SquaredDifferences += delta*(value - this->Mean);
+        this->Minimum = std::min(this->Minimum, value);
+        this->Maximum = std::max(this->Maximum, value);
+        }
+    }
+
+    void CopyTo(vtkDoubleArray *column)
+    {
+      column->SetValue(AVERAGE_ROW, this->Mean);
+      column->SetValue(MINIMUM_ROW, this->Minimum);
+      column->SetValue(MAXIMUM_ROW, this->Maximum);
+      column->SetValue(COUNT_ROW, this->Count);
+      column->SetValue(VARIANCE_ROW, this->Count > 0
+                       ? this->SquaredDifferences/this->Count : 0.0);
+    }
+  };
 
+  // Merges the statistics of two sets of values (Chan et al. for the
+  // variance), which is associative.
   inline void AccumulateColumn(vtkDoubleArray *source,
                                vtkDoubleArray *target)
   {
     double targetCount = target->GetValue(COUNT_ROW);
     double sourceCount = source->GetValue(COUNT_ROW);
+    if (sourceCount <= 0) return;
     double totalCount = targetCount + sourceCount;
-    double targetTotal = targetCount*target->GetValue(AVERAGE_ROW);
-    double sourceTotal = sourceCount*source->GetValue(AVERAGE_ROW);
-    target->SetValue(AVERAGE_ROW, (targetTotal + sourceTotal)/totalCount);
+    double targetMean = target->GetValue(AVERAGE_ROW);
+    double delta = source->GetValue(AVERAGE_ROW) - targetMean;
+    double squaredDifferences
+      = target->GetValue(VARIANCE_ROW)*targetCount
+      + source->GetValue(VARIANCE_ROW)*sourceCount
+      + delta*delta*targetCount*sourceCount/totalCount;
+    target->SetValue(AVERAGE_ROW, targetMean + delta*sourceCount/totalCount);
     target->SetValue(MINIMUM_ROW, std::min(source->GetValue(MINIMUM_ROW),
                                               target->GetValue(MINIMUM_ROW)));
     target->SetValue(MAXIMUM_ROW, std::max(source->GetValue(MAXIMUM_ROW),
                                               target->GetValue(MAXIMUM_ROW)));
     target->SetValue(COUNT_ROW, totalCount);
+    target->SetValue(VARIANCE_ROW, squaredDifferences/totalCount);
+  }
+
+  // Largest modification time of the algorithms upstream of algorithm.
+  unsigned long GetUpstreamMTime(vtkAlgorithm *algorithm)
+  {
+    unsigned long mtime = algorithm->GetMTime();
+    for (int port = 0; port < algorithm->GetNumberOfInputPorts(); port++)
+      {
+      for (int i = 0; i < algorithm->GetNumberOfInputConnections(port); i++)
+        {
+        vtkAlgorithm *input = algorithm->GetInputAlgorithm(port, i);
+        if (input)
+          {
+          mtime = std::max(mtime, GetUpstreamMTime(input));
+          }
+        }
+      }
+    return mtime;
+  }
+
+  // Identifies the data read by the reader feeding the filter, but for its
+  // mode files: its settings, and the mesh file and its modification time.
+  // Empty when the input is not a reader known to this filter, in which case
+  // the statistics are discarded when the reader is modified, and nothing is
+  // cached in files.
+  std::string GetReaderIdentity(vtkAlgorithm *input)
+  {
+    vtkSLACReader *reader = vtkSLACReader::SafeDownCast(input);
+    if (!reader || !reader->GetMeshFileName())
+      {
+      return std::string();
+      }
+
+    std::ostringstream identity;
+    identity << reader->GetClassName()
+             << "\t" << reader->GetReadInternalVolume()
+             << "\t" << reader->GetReadExternalSurface()
+             << "\t" << reader->GetReadMidpoints();
+    for (int i = 0; i < reader->GetNumberOfVariableArrays(); i++)
+      {
+      const char *name = reader->GetVariableArrayName(i);
+      if (name && reader->GetVariableArrayStatus(name))
+        {
+        identity << "\t" << name;
+        }
+      }
+    identity << "\t" << reader->GetMeshFileName() << "\t"
+             << vtksys::SystemTools::ModifiedTime(reader->GetMeshFileName());
+    return identity.str();
+  }
+
+  // Modification time of each mode file read by the reader feeding the
+  // filter. A running simulation appends a mode file for each new time step.
+  typedef std::map<std::string, long> FileTimes;
+  FileTimes GetModeFiles(vtkAlgorithm *input)
+  {
+    FileTimes files;
+    vtkSLACReader *reader = vtkSLACReader::SafeDownCast(input);
+    for (unsigned int i = 0; reader && (i < reader->GetNumberOfModeFileNames());
+         i++)
+      {
+      const char *fileName = reader->GetModeFileName(i);
+      files[fileName] = vtksys::SystemTools::ModifiedTime(fileName);
+      }
+    return files;
+  }
+
+  // True if current holds all the files of previous, unmodified, and others.
+  bool FilesAppended(const FileTimes &previous, const FileTimes &current)
+  {
+    if (current.size() <= previous.size())
+      {
+      return false;
+      }
+    for (FileTimes::const_iterator iter = previous.begin();
+         iter != previous.end(); ++iter)
+      {
+      FileTimes::const_iterator file = current.find(iter->first);
+      if ((file == current.end()) || (file->second != iter->second))
+        {
+        return false;
+        }
+      }
+    return true;
   }
 };
 using namespace vtkTemporalRangesNamespace;
 
+//=============================================================================
+class vtkTemporalRanges::vtkInternals
+{
+public:
+  // Statistics of each time step, by time.
+  std::map<double, vtkSmartPointer<vtkTable> > TimeSteps;
+  unsigned long UpstreamMTime;
+  // Identity of the reader and mode files read for TimeSteps.
+  std::string ReaderIdentity;
+  FileTimes ModeFiles;
+  std::string LoadedCacheFileName;
+  // Identity of the data whose statistics are in the cache file, empty if
+  // the cache file is not used, and the mode files it records.
+  std::string CacheIdentity;
+  FileTimes CachedModeFiles;
+
+  vtkInternals() : UpstreamMTime(0) {}
+};
+
 //=============================================================================
 vtkStandardNewMacro(vtkTemporalRanges);
 
@@ -101,15 +252,26 @@ vtkStandardNewMacro(vtkTemporalRanges);
 vtkTemporalRanges::vtkTemporalRanges()
 {
   this->CurrentTimeIndex = 0;
+  this->CacheFileName = NULL;
+  this->PendingTimeSteps = vtkIdList::New();
+  this->NewTimeSteps = vtkMultiBlockDataSet::New();
+  this->Internals = new vtkInternals;
 }
 
 vtkTemporalRanges::~vtkTemporalRanges()
 {
+  this->SetCacheFileName(NULL);
+  this->PendingTimeSteps->Delete();
+  this->NewTimeSteps->Delete();
+  delete this->Internals;
 }
 
 void vtkTemporalRanges::PrintSelf(ostream &os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+
+  os << indent << "CacheFileName: "
+     << (this->CacheFileName ? this->CacheFileName : "(none)") << endl;
 }
 
 //-----------------------------------------------------------------------------
@@ -154,11 +316,34 @@ int vtkTemporalRanges::RequestUpdateExtent(
   // upstream pipeline to get each time step in order.  The executive in turn
   // will call this method to get the extent request for each iteration (in this
   // case the time step).
+  if (this->CurrentTimeIndex == 0)
+    {
+    this->PrepareTimeSteps(inInfo);
+    }
+
   double *inTimes = inInfo->Get(vtkStreamingDemandDrivenPipeline::TIME_STEPS());
-  if (inTimes)
+  if (   inTimes
+      && (this->CurrentTimeIndex < this->PendingTimeSteps->GetNumberOfIds()) )
     {
-    inInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEP(),
-                inTimes[this->CurrentTimeIndex]);
+    vtkIdType timeIndex
+      = this->PendingTimeSteps->GetId(this->CurrentTimeIndex);
+    if (timeIndex >= 0)
+      {
+      inInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEP(),
+                  inTimes[timeIndex]);
+      }
+    }
+  else if (this->PendingTimeSteps->GetNumberOfIds() == 0)
+    {
+    // The statistics of all the time steps are known. Request the time step
+    // the input already holds, so that the upstream pipeline does not execute.
+    vtkDataObject *input = vtkDataObject::GetData(inInfo);
+    vtkInformation *dataInfo = input ? input->GetInformation() : NULL;
+    if (dataInfo && dataInfo->Has(vtkDataObject::DATA_TIME_STEP()))
+      {
+      inInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEP(),
+                  dataInfo->Get(vtkDataObject::DATA_TIME_STEP()));
+      }
     }
 
   return 1;
@@ -171,35 +356,52 @@ int vtkTemporalRanges::RequestData(vtkInformation *request,
 {
   vtkInformation *inInfo = inputVector[0]->GetInformationObject(0);
   vtkTable *output = vtkTable::GetData(outputVector);
+  vtkIdType numPending = this->PendingTimeSteps->GetNumberOfIds();
 
-  if (this->CurrentTimeIndex == 0)
+  if (this->CurrentTimeIndex < numPending)
     {
-    // First execution.  Initialize table.
-    this->InitializeTable(output);
-    }
+    // Compute the statistics of this time step on their own, so that they
+    // can be cached.
+    VTK_CREATE(vtkTable, timeStep);
+    this->InitializeTable(timeStep);
 
-  vtkCompositeDataSet *compositeInput = vtkCompositeDataSet::GetData(inInfo);
-  vtkDataSet *dsInput = vtkDataSet::GetData(inInfo);
+    vtkCompositeDataSet *compositeInput = vtkCompositeDataSet::GetData(inInfo);
+    vtkDataSet *dsInput = vtkDataSet::GetData(inInfo);
 
-  if (compositeInput)
-    {
-    this->AccumulateCompositeData(compositeInput, output);
-    }
-  else if (dsInput)
-    {
-    this->AccumulateDataSet(dsInput, output);
-    }
-  else
-    {
-    vtkWarningMacro(<< "Unknown data type : "
-                    << vtkDataObject::GetData(inputVector[0])->GetClassName());
-    return 0;
-    }
+    if (compositeInput)
+      {
+      this->AccumulateCompositeData(compositeInput, timeStep);
+      }
+    else if (dsInput)
+      {
+      this->AccumulateDataSet(dsInput, timeStep);
+      }
+    else
+      {
+      vtkWarningMacro(<< "Unknown data type : "
+                      << vtkDataObject::GetData(inputVector[0])->GetClassName());
+      this->CurrentTimeIndex = 0;
+      return 0;
+      }
 
-  this->CurrentTimeIndex++;
+    vtkIdType timeIndex
+      = this->PendingTimeSteps->GetId(this->CurrentTimeIndex);
+    double *inTimes
+      = inInfo->Get(vtkStreamingDemandDrivenPipeline::TIME_STEPS());
+    if (inTimes && (timeIndex >= 0))
+      {
+      VTK_CREATE(vtkDoubleArray, time);
+      time->SetName(TIME_ARRAY_NAME);
+      time->InsertNextValue(inTimes[timeIndex]);
+      timeStep->GetFieldData()->AddArray(time);
+      }
+    this->NewTimeSteps->SetBlock(this->NewTimeSteps->GetNumberOfBlocks(),
+                                 timeStep);
+
+    this->CurrentTimeIndex++;
+    }
 
-  if (  this->CurrentTimeIndex
-      < inInfo->Length(vtkStreamingDemandDrivenPipeline::TIME_STEPS()) )
+  if (this->CurrentTimeIndex < numPending)
     {
     // There is still more to do.
     request->Set(vtkStreamingDemandDrivenPipeline::CONTINUE_EXECUTING(), 1);
@@ -209,11 +411,306 @@ int vtkTemporalRanges::RequestData(vtkInformation *request,
     // We are done.  Finish up.
     request->Remove(vtkStreamingDemandDrivenPipeline::CONTINUE_EXECUTING());
     this->CurrentTimeIndex = 0;
+    this->FinishTimeSteps(inInfo, output);
     }
 
   return 1;
 }
 
+//-----------------------------------------------------------------------------
+void vtkTemporalRanges::PrepareTimeSteps(vtkInformation *inInfo)
+{
+  this->PendingTimeSteps->Reset();
+  this->NewTimeSteps->Initialize();
+
+  // The statistics kept are only valid for the current upstream pipeline,
+  // unless the only modification is mode files appended to the reader (by a
+  // running simulation), which only adds time steps.
+  vtkAlgorithm *input = this->GetNumberOfInputConnections(0) > 0
+    ? this->GetInputAlgorithm(0, 0) : NULL;
+  unsigned long upstreamMTime = input ? GetUpstreamMTime(input) : 0;
+  std::string readerIdentity = GetReaderIdentity(input);
+  FileTimes modeFiles = GetModeFiles(input);
+  bool appended = (   !readerIdentity.empty()
+                   && (readerIdentity == this->Internals->ReaderIdentity)
+                   && FilesAppended(this->Internals->ModeFiles, modeFiles) );
+  bool upstreamModified = (   (this->Internals->UpstreamMTime != 0)
+                           && (upstreamMTime != this->Internals->UpstreamMTime)
+                           && !appended );
+  if ((upstreamMTime != this->Internals->UpstreamMTime) && !appended)
+    {
+    this->Internals->TimeSteps.clear();
+    this->Internals->LoadedCacheFileName.clear();
+    }
+  this->Internals->UpstreamMTime = upstreamMTime;
+  this->Internals->ReaderIdentity = readerIdentity;
+  this->Internals->ModeFiles = modeFiles;
+  if (   this->CacheFileName && this->CacheFileName[0]
+      && (this->Internals->LoadedCacheFileName != this->CacheFileName) )
+    {
+    // The statistics in the file are only reused for the output of the same
+    // reader, with the same settings, reading the same unmodified files. Any
+    // other modification upstream makes them stale.
+    this->Internals->CacheIdentity = readerIdentity;
+    if (this->Internals->CacheIdentity.empty())
+      {
+      vtkWarningMacro(<< "Not using " << this->CacheFileName
+                      << ", the cache file is only used on the output of a"
+                      << " SLAC reader.");
+      }
+    else if (upstreamModified)
+      {
+      this->ResetCacheFile();
+      }
+    else
+      {
+      this->LoadCacheFile();
+      }
+    this->Internals->LoadedCacheFileName = this->CacheFileName;
+    }
+
+  double *inTimes = inInfo->Get(vtkStreamingDemandDrivenPipeline::TIME_STEPS());
+  int numTimes = inInfo->Length(vtkStreamingDemandDrivenPipeline::TIME_STEPS());
+  if (!inTimes || (numTimes <= 0))
+    {
+    // Without time steps, the data is read once and nothing is cached.
+    this->PendingTimeSteps->InsertNextId(-1);
+    return;
+    }
+  for (int i = 0; i < numTimes; i++)
+    {
+    if (   this->Internals->TimeSteps.find(inTimes[i])
+        == this->Internals->TimeSteps.end() )
+      {
+      this->PendingTimeSteps->InsertNextId(i);
+      }
+    }
+}
+
+//-----------------------------------------------------------------------------
+bool vtkTemporalRanges::GatherTimeSteps()
+{
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+void vtkTemporalRanges::FinishTimeSteps(vtkInformation *inInfo,
+                                        vtkTable *output)
+{
+  if (!this->GatherTimeSteps())
+    {
+    output->Initialize();
+    this->NewTimeSteps->Initialize();
+    return;
+    }
+
+  this->InitializeTable(output);
+
+  VTK_CREATE(vtkMultiBlockDataSet, newCachedTimeSteps);
+  for (unsigned int i = 0; i < this->NewTimeSteps->GetNumberOfBlocks(); i++)
+    {
+    vtkTable *timeStep = vtkTable::SafeDownCast(this->NewTimeSteps->GetBlock(i));
+    if (!timeStep) continue;
+    vtkDataArray *time = timeStep->GetFieldData()->GetArray(TIME_ARRAY_NAME);
+    if (time)
+      {
+      this->Internals->TimeSteps[time->GetTuple1(0)] = timeStep;
+      newCachedTimeSteps->SetBlock(newCachedTimeSteps->GetNumberOfBlocks(),
+                                   timeStep);
+      }
+    else
+      {
+      this->AccumulateTable(timeStep, output);
+      }
+    }
+  if (   this->CacheFileName && this->CacheFileName[0]
+      && !this->Internals->CacheIdentity.empty()
+      && (newCachedTimeSteps->GetNumberOfBlocks() > 0) )
+    {
+    this->AppendToCacheFile(newCachedTimeSteps);
+    }
+  this->NewTimeSteps->Initialize();
+
+  // Merge the statistics of all the time steps of the input.
+  double *inTimes = inInfo->Get(vtkStreamingDemandDrivenPipeline::TIME_STEPS());
+  int numTimes = inInfo->Length(vtkStreamingDemandDrivenPipeline::TIME_STEPS());
+  for (int i = 0; inTimes && (i < numTimes); i++)
+    {
+    std::map<double, vtkSmartPointer<vtkTable> >::iterator timeStep
+      = this->Internals->TimeSteps.find(inTimes[i]);
+    if (timeStep != this->Internals->TimeSteps.end())
+      {
+      this->AccumulateTable(timeStep->second, output);
+      }
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vtkTemporalRanges::LoadCacheFile()
+{
+  std::ifstream file(this->CacheFileName);
+  if (!file)
+    {
+    // Nothing cached yet.
+    return;
+    }
+
+  std::string line;
+  if (!std::getline(file, line) || (line != CACHE_FILE_HEADER))
+    {
+    vtkWarningMacro(<< "Ignoring " << this->CacheFileName
+                    << ", which is not a temporal ranges cache file.");
+    this->Internals->CacheIdentity.clear();
+    return;
+    }
+  if (   !std::getline(file, line)
+      || (line != "# " + this->Internals->CacheIdentity) )
+    {
+    // The statistics are those of other data, or of another version of the
+    // mesh file.
+    file.close();
+    this->ResetCacheFile();
+    return;
+    }
+
+  // Each line has the time, the statistics in the order of the rows and the
+  // name of the column, separated by tabs. Lines starting with
+  // CACHE_FILE_MODE_FILE record the modification time and the name of a mode
+  // file read.
+  std::map<double, vtkSmartPointer<vtkTable> > timeSteps;
+  FileTimes cachedModeFiles;
+  const std::string modeFilePrefix = CACHE_FILE_MODE_FILE;
+  while (std::getline(file, line))
+    {
+    if (line.compare(0, modeFilePrefix.size(), modeFilePrefix) == 0)
+      {
+      std::istringstream fields(line.substr(modeFilePrefix.size()));
+      long modifiedTime;
+      std::string fileName;
+      if (   (fields >> modifiedTime) && (fields.get() == '\t')
+          && std::getline(fields, fileName) )
+        {
+        cachedModeFiles[fileName] = modifiedTime;
+        }
+      continue;
+      }
+
+    std::istringstream fields(line);
+    double time;
+    double values[NUMBER_OF_ROWS];
+    fields >> time;
+    for (int row = 0; row < NUMBER_OF_ROWS; row++)
+      {
+      fields >> values[row];
+      }
+    std::string name;
+    if (!fields || (fields.get() != '\t') || !std::getline(fields, name))
+      {
+      vtkWarningMacro(<< "Ignoring invalid line in " << this->CacheFileName
+                      << ": " << line);
+      continue;
+      }
+
+    vtkSmartPointer<vtkTable> &timeStep = timeSteps[time];
+    if (!timeStep)
+      {
+      timeStep = vtkSmartPointer<vtkTable>::New();
+      this->InitializeTable(timeStep);
+      }
+    vtkDoubleArray *column = this->GetColumn(timeStep, name.c_str());
+    for (int row = 0; row < NUMBER_OF_ROWS; row++)
+      {
+      column->SetValue(row, values[row]);
+      }
+    }
+  file.close();
+
+  // A mode file modified since its statistics were cached makes them stale.
+  // Mode files no longer read only remove time steps.
+  for (FileTimes::iterator iter = cachedModeFiles.begin();
+       iter != cachedModeFiles.end(); ++iter)
+    {
+    FileTimes::iterator modeFile = this->Internals->ModeFiles.find(iter->first);
+    if (   (modeFile != this->Internals->ModeFiles.end())
+        && (modeFile->second != iter->second) )
+      {
+      this->ResetCacheFile();
+      return;
+      }
+    }
+
+  this->Internals->CachedModeFiles = cachedModeFiles;
+  this->Internals->TimeSteps.insert(timeSteps.begin(), timeSteps.end());
+}
+
+//-----------------------------------------------------------------------------
+void vtkTemporalRanges::AppendToCacheFile(vtkMultiBlockDataSet *timeSteps)
+{
+  bool exists = std::ifstream(this->CacheFileName).good();
+  std::ofstream file(this->CacheFileName, std::ios::out | std::ios::app);
+  if (!file)
+    {
+    vtkWarningMacro(<< "Could not write the cache file " << this->CacheFileName);
+    return;
+    }
+  if (!exists)
+    {
+    file << CACHE_FILE_HEADER << "\n# " << this->Internals->CacheIdentity
+         << "\n";
+    this->Internals->CachedModeFiles.clear();
+    }
+
+  // Record the mode files read, so that the statistics are discarded when one
+  // of them is modified.
+  for (FileTimes::iterator iter = this->Internals->ModeFiles.begin();
+       iter != this->Internals->ModeFiles.end(); ++iter)
+    {
+    FileTimes::iterator cached
+      = this->Internals->CachedModeFiles.find(iter->first);
+    if (   (cached == this->Internals->CachedModeFiles.end())
+        || (cached->second != iter->second) )
+      {
+      file << CACHE_FILE_MODE_FILE << iter->second << "\t" << iter->first
+           << "\n";
+      this->Internals->CachedModeFiles[iter->first] = iter->second;
+      }
+    }
+
+  file.precision(17);
+  for (unsigned int i = 0; i < timeSteps->GetNumberOfBlocks(); i++)
+    {
+    vtkTable *timeStep = vtkTable::SafeDownCast(timeSteps->GetBlock(i));
+    vtkDataArray *time = timeStep->GetFieldData()->GetArray(TIME_ARRAY_NAME);
+    for (vtkIdType c = 0; c < timeStep->GetNumberOfColumns(); c++)
+      {
+      vtkDoubleArray *column
+        = vtkDoubleArray::SafeDownCast(timeStep->GetColumn(c));
+      if (!column || !column->GetName()) continue;
+      file << time->GetTuple1(0);
+      for (int row = 0; row < NUMBER_OF_ROWS; row++)
+        {
+        file << "\t" << column->GetValue(row);
+        }
+      file << "\t" << column->GetName() << "\n";
+      }
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vtkTemporalRanges::ResetCacheFile()
+{
+  std::ofstream file(this->CacheFileName, std::ios::out | std::ios::trunc);
+  if (!file)
+    {
+    vtkWarningMacro(<< "Could not write the cache file " << this->CacheFileName);
+    this->Internals->CacheIdentity.clear();
+    return;
+    }
+  file << CACHE_FILE_HEADER << "\n# " << this->Internals->CacheIdentity
+       << "\n";
+  this->Internals->CachedModeFiles.clear();
+}
+
 //-----------------------------------------------------------------------------
 void vtkTemporalRanges::InitializeTable(vtkTable *output)
 {
@@ -228,6 +725,7 @@ void vtkTemporalRanges::InitializeTable(vtkTable *output)
   rangeName->SetValue(MINIMUM_ROW, "Minimum");
   rangeName->SetValue(MAXIMUM_ROW, "Maximum");
   rangeName->SetValue(COUNT_ROW, "Count");
+  rangeName->SetValue(VARIANCE_ROW, "Variance");
 
   output->AddColumn(rangeName);
 }
@@ -282,24 +780,19 @@ void vtkTemporalRanges::AccumulateArray(vtkDataArray *field, vtkTable *output)
   vtkIdType numTuples = field->GetNumberOfTuples();
   vtkDoubleArray *magnitudeColumn = NULL;
   std::vector<vtkDoubleArray *> componentColumns(numComponents);
-  VTK_CREATE(vtkDoubleArray, magnitudeAccumulate);
-  std::vector<vtkSmartPointer<vtkDoubleArray> > componentAccumulate(numComponents);
+  Accumulator magnitudeAccumulate;
+  std::vector<Accumulator> componentAccumulate(numComponents);
   if (numComponents > 1)
     {
     magnitudeColumn = this->GetColumn(output, field->GetName(), -1);
-    InitializeColumn(magnitudeAccumulate);
     for (int i = 0; i < numComponents; i++)
       {
       componentColumns[i] = this->GetColumn(output, field->GetName(), i);
-      componentAccumulate[i] = vtkSmartPointer<vtkDoubleArray>::New();
-      InitializeColumn(componentAccumulate[i]);
       }
     }
   else
     {
     componentColumns[0] = this->GetColumn(output, field->GetName());
-    componentAccumulate[0] = vtkSmartPointer<vtkDoubleArray>::New();
-    InitializeColumn(componentAccumulate[0]);
     }
 
   for (vtkIdType i = 0; i < numTuples; i++)
@@ -309,28 +802,26 @@ void vtkTemporalRanges::AccumulateArray(vtkDataArray *field, vtkTable *output)
       {
       double value = field->GetComponent(i, j);
       mag += value*value;
-      AccumulateValue(value, componentAccumulate[j]);
+      componentAccumulate[j].AccumulateValue(value);
       }
     if (magnitudeColumn)
       {
       mag = sqrt(mag);
-      AccumulateValue(mag, magnitudeAccumulate);
+      magnitudeAccumulate.AccumulateValue(mag);
       }
     }
 
+  VTK_CREATE(vtkDoubleArray, accumulated);
+  InitializeColumn(accumulated);
   for (int j = 0; j < numComponents; j++)
     {
-    componentAccumulate[j]->SetValue(AVERAGE_ROW,
-                              (  componentAccumulate[j]->GetValue(AVERAGE_ROW)
-                               / componentAccumulate[j]->GetValue(COUNT_ROW) ));
-    AccumulateColumn(componentAccumulate[j], componentColumns[j]);
+    componentAccumulate[j].CopyTo(accumulated);
+    AccumulateColumn(accumulated, componentColumns[j]);
     }
   if (magnitudeColumn)
     {
-    magnitudeAccumulate->SetValue(AVERAGE_ROW,
-                                  (  magnitudeAccumulate->GetValue(AVERAGE_ROW)
-                                   / magnitudeAccumulate->GetValue(COUNT_ROW)));
-    AccumulateColumn(magnitudeAccumulate, magnitudeColumn);
+    magnitudeAccumulate.CopyTo(accumulated);
+    AccumulateColumn(accumulated, magnitudeColumn);
     }
 }
 
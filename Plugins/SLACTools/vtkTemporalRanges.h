@@ -31,6 +31,20 @@
 // and time, it will also give a single statistics over all blocks in a data
 // set.
 //
+// The statistics of each time step are kept, so that when the filter executes
+// again with new time steps appended to its input (for example, the output of
+// a vtkSLACReader given the mode files of a running simulation), only the new
+// time steps are read. They are discarded when anything else upstream is
+// modified.
+//
+// When the input is the output of a vtkSLACReader and CacheFileName is set,
+// the statistics of each time step are also stored in that file (keyed by
+// time and array), and reused for the time steps that are still in the input
+// when the filter executes again, for instance in another session. The file
+// records the reader settings, and the files read and their modification
+// times. It is truncated when they differ, or when anything else upstream is
+// modified.
+//
 
 #ifndef vtkTemporalRanges_h
 #define vtkTemporalRanges_h
@@ -41,6 +55,8 @@ class vtkCompositeDataSet;
 class vtkDataSet;
 class vtkDoubleArray;
 class vtkFieldData;
+class vtkIdList;
+class vtkMultiBlockDataSet;
 
 class vtkTemporalRanges : public vtkTableAlgorithm
 {
@@ -54,15 +70,33 @@ public:
     MINIMUM_ROW,
     MAXIMUM_ROW,
     COUNT_ROW,
+    VARIANCE_ROW,
     NUMBER_OF_ROWS
   };
 
+  // Description:
+  // File in which the statistics of each time step are cached. Default is
+  // NULL, i.e. the statistics are only kept in memory.
+  vtkSetStringMacro(CacheFileName);
+  vtkGetStringMacro(CacheFileName);
+
 protected:
   vtkTemporalRanges();
   ~vtkTemporalRanges();
 
+  // Description:
+  // Index in PendingTimeSteps of the time step being executed.
   int CurrentTimeIndex;
 
+  char *CacheFileName;
+
+  // Description:
+  // Indices of the input time steps to execute (-1 for an input without
+  // time steps), and the statistics computed for each of them: tables with a
+  // "Time" field data array holding the time step value.
+  vtkIdList *PendingTimeSteps;
+  vtkMultiBlockDataSet *NewTimeSteps;
+
   virtual int FillInputPortInformation(int port, vtkInformation *info);
 
   virtual int RequestInformation(vtkInformation *,
@@ -79,6 +113,31 @@ protected:
 
   virtual void InitializeTable(vtkTable *output);
 
+  // Description:
+  // Fills PendingTimeSteps with the input time steps whose statistics are not
+  // known. Called before the first execution of each update.
+  virtual void PrepareTimeSteps(vtkInformation *inInfo);
+
+  // Description:
+  // Merges the statistics of the time steps executed by all the processes in
+  // NewTimeSteps. Returns false if this process does not hold the results.
+  virtual bool GatherTimeSteps();
+
+  // Description:
+  // Caches the new statistics and merges those of all the input time steps
+  // in the output.
+  virtual void FinishTimeSteps(vtkInformation *inInfo, vtkTable *output);
+
+  // Description:
+  // Load/append the statistics of time steps from/to CacheFileName.
+  virtual void LoadCacheFile();
+  virtual void AppendToCacheFile(vtkMultiBlockDataSet *timeSteps);
+
+  // Description:
+  // Empty CacheFileName, keeping only its header, when the statistics it
+  // holds are stale.
+  virtual void ResetCacheFile();
+
   virtual void AccumulateCompositeData(vtkCompositeDataSet *input,
                                        vtkTable *output);
   virtual void AccumulateDataSet(vtkDataSet *input, vtkTable *output);
@@ -94,6 +153,9 @@ protected:
 private:
   vtkTemporalRanges(const vtkTemporalRanges &) VTK_DELETE_FUNCTION;
   void operator=(const vtkTemporalRanges &) VTK_DELETE_FUNCTION;
+
+  class vtkInternals;
+  vtkInternals *Internals;
 };
 
 #endif //vtkTemporalRanges_h
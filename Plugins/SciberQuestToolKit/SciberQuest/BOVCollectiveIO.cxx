@@ -0,0 +1,557 @@
+/*
+ * Copyright 2012 SciberQuest Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of SciberQuest Inc. nor the names of any contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "BOVCollectiveIO.h"
+
+#include "SQPOSIXOnWindowsWarningSupression.h"
+#include "SQPosixOnWindows.h"
+#include "CartesianExtent.h"
+#include "SQMacros.h"
+#include "postream.h"
+#include "vtkSQLog.h"
+
+#include <map>
+#include <string>
+#include <sstream>
+#include <cstdlib>
+
+// ROMIO's default collective buffer size
+#define BOVCollectiveIO_CB_BUFFER_SIZE 16777216LL
+
+#ifndef SQTK_WITHOUT_MPI
+namespace {
+
+// stripe size and count of the directories already seen. They are
+// queried by opening a file, once per directory.
+class StripeInfo
+{
+public:
+  StripeInfo() : Unit(0), Count(0) {}
+  long long Unit;
+  long long Count;
+};
+typedef std::map<std::string,StripeInfo> StripeInfoMap;
+static StripeInfoMap StripeInfoCache;
+
+//-----------------------------------------------------------------------------
+long long GetHint(MPI_Info info, const char *key)
+{
+  char val[MPI_MAX_INFO_VAL+1]={'\0'};
+  int flag=0;
+  MPI_Info_get(info,const_cast<char*>(key),MPI_MAX_INFO_VAL,val,&flag);
+  if (!flag)
+    {
+    return -1;
+    }
+  return atoll(val);
+}
+
+//-----------------------------------------------------------------------------
+void SetHint(MPI_Info info, const char *key, long long val)
+{
+  std::ostringstream os;
+  os << val;
+  MPI_Info_set(info,const_cast<char*>(key),const_cast<char*>(os.str().c_str()));
+}
+
+//-----------------------------------------------------------------------------
+void SetDefaultHint(MPI_Info info, const char *key, long long val)
+{
+  if (GetHint(info,key)<0)
+    {
+    SetHint(info,key,val);
+    }
+}
+
+//-----------------------------------------------------------------------------
+StripeInfo GetStripeInfo(MPI_Comm comm, const char *fileName, int readMode)
+{
+  // added this to deal with vpic data arrays which use spaces.
+  std::string cleanFileName=fileName;
+  size_t fileNameLen=cleanFileName.size();
+  for (size_t i=0; i<fileNameLen; ++i)
+    {
+    if (cleanFileName[i]==' ') cleanFileName[i]='-';
+    }
+
+  std::string dir;
+  size_t sep=cleanFileName.find_last_of("/\\");
+  if (sep!=std::string::npos)
+    {
+    dir=cleanFileName.substr(0,sep);
+    }
+
+  StripeInfoMap::iterator it=StripeInfoCache.find(dir);
+  if (it!=StripeInfoCache.end())
+    {
+    return it->second;
+    }
+
+  // the file system reports the striping in the hints of an
+  // open file. files to be written may not exist yet.
+  StripeInfo stripe;
+  if (!readMode)
+    {
+    return stripe;
+    }
+
+  MPI_File file=0;
+  int iErr=MPI_File_open(
+        comm,
+        const_cast<char *>(cleanFileName.c_str()),
+        MPI_MODE_RDONLY,
+        MPI_INFO_NULL,
+        &file);
+  if (iErr==MPI_SUCCESS)
+    {
+    MPI_Info info;
+    MPI_File_get_info(file,&info);
+    stripe.Unit=GetHint(info,"striping_unit");
+    stripe.Count=GetHint(info,"striping_factor");
+    MPI_Info_free(&info);
+    MPI_File_close(&file);
+    }
+
+  StripeInfoCache[dir]=stripe;
+
+  return stripe;
+}
+
+//-----------------------------------------------------------------------------
+int GetNumberOfNodes(MPI_Comm comm)
+{
+  #if MPI_VERSION>=3
+  MPI_Comm nodeComm;
+  MPI_Comm_split_type(comm,MPI_COMM_TYPE_SHARED,0,MPI_INFO_NULL,&nodeComm);
+  int nodeRank=0;
+  MPI_Comm_rank(nodeComm,&nodeRank);
+  MPI_Comm_free(&nodeComm);
+  int leader=(nodeRank==0?1:0);
+  int nNodes=0;
+  MPI_Allreduce(&leader,&nNodes,1,MPI_INT,MPI_SUM,comm);
+  return nNodes;
+  #else
+  (void)comm;
+  return 0;
+  #endif
+}
+
+};
+#endif
+
+//-----------------------------------------------------------------------------
+BOVCollectiveIO::BOVCollectiveIO()
+{}
+
+//-----------------------------------------------------------------------------
+BOVCollectiveIO::~BOVCollectiveIO()
+{
+  this->Clear();
+}
+
+//-----------------------------------------------------------------------------
+MPI_Info BOVCollectiveIO::TuneHints(
+      MPI_Comm comm,
+      MPI_Info hints,
+      const char *fileName,
+      int readMode)
+{
+  #ifdef SQTK_WITHOUT_MPI
+  (void)comm;
+  (void)fileName;
+  (void)readMode;
+  return hints;
+  #else
+  MPI_Info tuned;
+  if (hints==MPI_INFO_NULL)
+    {
+    MPI_Info_create(&tuned);
+    }
+  else
+    {
+    MPI_Info_dup(hints,&tuned);
+    }
+
+  // striping given by the user take precedence, they are
+  // used when creating files.
+  StripeInfo stripe;
+  stripe.Unit=GetHint(tuned,"striping_unit");
+  stripe.Count=GetHint(tuned,"striping_factor");
+  if (stripe.Unit<=0)
+    {
+    stripe=GetStripeInfo(comm,fileName,readMode);
+    }
+
+  // one aggregator per node, or per stripe when there are fewer
+  // stripes than nodes so that each aggregator works with its
+  // own storage target.
+  if (GetHint(tuned,"cb_nodes")<0)
+    {
+    int nNodes=GetNumberOfNodes(comm);
+    if (nNodes>0)
+      {
+      long long cbNodes=nNodes;
+      if ((stripe.Count>0) && (stripe.Count<cbNodes))
+        {
+        cbNodes=stripe.Count;
+        }
+      SetHint(tuned,"cb_nodes",cbNodes);
+      if (GetHint(tuned,"cb_config_list")<0)
+        {
+        MPI_Info_set(
+              tuned,
+              const_cast<char*>("cb_config_list"),
+              const_cast<char*>("*:1"));
+        }
+      }
+    }
+
+  // align the requests of the aggregators to the stripes.
+  if (stripe.Unit>0)
+    {
+    long long cbBufferSize=GetHint(tuned,"cb_buffer_size");
+    if (cbBufferSize<=0)
+      {
+      cbBufferSize=BOVCollectiveIO_CB_BUFFER_SIZE;
+      }
+    cbBufferSize=((cbBufferSize+stripe.Unit-1)/stripe.Unit)*stripe.Unit;
+    SetHint(tuned,"cb_buffer_size",cbBufferSize);
+    SetDefaultHint(tuned,"striping_unit",stripe.Unit);
+    SetDefaultHint(tuned,"romio_cb_fr_alignment",stripe.Unit);
+    }
+
+  return tuned;
+  #endif
+}
+
+//-----------------------------------------------------------------------------
+void BOVCollectiveIO::Add(
+      MPI_File file,
+      MPI_Info hints,
+      const CartesianExtent &domain,
+      const CartesianExtent &decomp,
+      MPI_Datatype nativeType,
+      size_t typeSize,
+      int nCompsMem,
+      int compNoMem,
+      void *data,
+      ScatterFunction scatter,
+      int write)
+{
+  Operation op;
+  op.File=file;
+  op.Hints=hints;
+  op.NativeType=nativeType;
+  op.FileView=0;
+  op.NumberOfElements=decomp.Size();
+  op.TypeSize=typeSize;
+  op.NCompsMem=nCompsMem;
+  op.CompNoMem=compNoMem;
+  op.Data=data;
+  op.Buffer=0;
+  op.Scatter=scatter;
+  op.Write=write;
+
+  #ifdef SQTK_WITHOUT_MPI
+  (void)domain;
+  #else
+  // file view
+  int domainDims[3];
+  domain.Size(domainDims);
+  int decompDims[3];
+  decomp.Size(decompDims);
+  int decompStart[3];
+  decomp.GetStartIndex(decompStart);
+
+  int iErr;
+  if (domain==decomp)
+    {
+    iErr=MPI_Type_contiguous((int)op.NumberOfElements,nativeType,&op.FileView);
+    }
+  else
+    {
+    iErr=MPI_Type_create_subarray(3,
+        domainDims,
+        decompDims,
+        decompStart,
+        MPI_ORDER_FORTRAN,
+        nativeType,
+        &op.FileView);
+    }
+  if (iErr)
+    {
+    sqErrorMacro(pCerr(),"Failed to create the file view.");
+    }
+  iErr=MPI_Type_commit(&op.FileView);
+  if (iErr)
+    {
+    sqErrorMacro(pCerr(),"MPI_Type_commit failed.");
+    }
+  #endif
+
+  this->Ops.push_back(op);
+}
+
+//-----------------------------------------------------------------------------
+void BOVCollectiveIO::Clear()
+{
+  size_t nOps=this->Ops.size();
+  for (size_t i=0; i<nOps; ++i)
+    {
+    Operation &op=this->Ops[i];
+    #ifndef SQTK_WITHOUT_MPI
+    if (op.FileView)
+      {
+      MPI_Type_free(&op.FileView);
+      }
+    #endif
+    free(op.Buffer);
+    }
+  this->Ops.clear();
+}
+
+//-----------------------------------------------------------------------------
+int BOVCollectiveIO::Execute(MPI_Comm comm, const char *eventName)
+{
+  #ifdef SQTK_WITHOUT_MPI
+  (void)comm;
+  (void)eventName;
+  this->Clear();
+  return 0;
+  #else
+  size_t nOps=this->Ops.size();
+  if (nOps==0)
+    {
+    return 1;
+    }
+
+  int ok=1;
+  int iErr;
+  int eStrLen=256;
+  char eStr[256]={'\0'};
+
+  double startTime=MPI_Wtime();
+  unsigned long long nBytes=0;
+
+  // set the views and stage components of interleaved arrays
+  for (size_t i=0; i<nOps; ++i)
+    {
+    Operation &op=this->Ops[i];
+    size_t opBytes=op.NumberOfElements*op.TypeSize;
+    nBytes+=opBytes;
+
+    if (op.NCompsMem>1)
+      {
+      posix_memalign(&op.Buffer,16,opBytes);
+      if (op.Write)
+        {
+        op.Scatter(
+              op.Data,
+              op.Buffer,
+              op.NumberOfElements,
+              op.NCompsMem,
+              op.CompNoMem,
+              1);
+        }
+      }
+
+    iErr=MPI_File_set_view(
+        op.File,
+        0,
+        op.NativeType,
+        op.FileView,
+        const_cast<char*>("native"),
+        op.Hints);
+    if (iErr)
+      {
+      sqErrorMacro(pCerr(),"MPI_File_set_view failed.");
+      }
+    }
+
+  // start all the operations, then complete them so that the
+  // files of the time step are accessed concurrently.
+  #if (MPI_VERSION>3) || ((MPI_VERSION==3) && (MPI_SUBVERSION>=1))
+  std::vector<MPI_Request> reqs(nOps,MPI_REQUEST_NULL);
+  for (size_t i=0; i<nOps; ++i)
+    {
+    Operation &op=this->Ops[i];
+    void *buf=op.Buffer?op.Buffer:op.Data;
+    if (op.Write)
+      {
+      iErr=MPI_File_iwrite_all(
+            op.File,buf,(int)op.NumberOfElements,op.NativeType,&reqs[i]);
+      }
+    else
+      {
+      iErr=MPI_File_iread_all(
+            op.File,buf,(int)op.NumberOfElements,op.NativeType,&reqs[i]);
+      }
+    if (iErr!=MPI_SUCCESS)
+      {
+      MPI_Error_string(iErr,eStr,&eStrLen);
+      sqErrorMacro(pCerr(),<< "Error starting collective I/O." << std::endl << eStr);
+      ok=0;
+      }
+    }
+  iErr=MPI_Waitall((int)nOps,&reqs[0],MPI_STATUSES_IGNORE);
+  if (iErr!=MPI_SUCCESS)
+    {
+    MPI_Error_string(iErr,eStr,&eStrLen);
+    sqErrorMacro(pCerr(),<< "Error completing collective I/O." << std::endl << eStr);
+    ok=0;
+    }
+  #else
+  for (size_t i=0; i<nOps; ++i)
+    {
+    Operation &op=this->Ops[i];
+    void *buf=op.Buffer?op.Buffer:op.Data;
+    if (op.Write)
+      {
+      iErr=MPI_File_write_all_begin(
+            op.File,buf,(int)op.NumberOfElements,op.NativeType);
+      }
+    else
+      {
+      iErr=MPI_File_read_all_begin(
+            op.File,buf,(int)op.NumberOfElements,op.NativeType);
+      }
+    if (iErr!=MPI_SUCCESS)
+      {
+      MPI_Error_string(iErr,eStr,&eStrLen);
+      sqErrorMacro(pCerr(),<< "Error starting collective I/O." << std::endl << eStr);
+      ok=0;
+      }
+    }
+  for (size_t i=0; i<nOps; ++i)
+    {
+    Operation &op=this->Ops[i];
+    void *buf=op.Buffer?op.Buffer:op.Data;
+    MPI_Status status;
+    if (op.Write)
+      {
+      iErr=MPI_File_write_all_end(op.File,buf,&status);
+      }
+    else
+      {
+      iErr=MPI_File_read_all_end(op.File,buf,&status);
+      }
+    if (iErr!=MPI_SUCCESS)
+      {
+      MPI_Error_string(iErr,eStr,&eStrLen);
+      sqErrorMacro(pCerr(),<< "Error completing collective I/O." << std::endl << eStr);
+      ok=0;
+      }
+    }
+  #endif
+
+  double ioTime=MPI_Wtime()-startTime;
+
+  // move the staged components into the interleaved arrays
+  for (size_t i=0; i<nOps; ++i)
+    {
+    Operation &op=this->Ops[i];
+    if (op.Buffer && !op.Write)
+      {
+      op.Scatter(
+            op.Buffer,
+            op.Data,
+            op.NumberOfElements,
+            op.NCompsMem,
+            op.CompNoMem,
+            0);
+      }
+    }
+
+  this->Clear();
+
+  BOVCollectiveIO::LogBandwidth(comm,eventName,nOps,nBytes,ioTime);
+
+  return ok;
+  #endif
+}
+
+//-----------------------------------------------------------------------------
+void BOVCollectiveIO::LogBandwidth(
+      MPI_Comm comm,
+      const char *eventName,
+      size_t nOps,
+      unsigned long long nBytes,
+      double seconds)
+{
+  vtkSQLog *log=vtkSQLog::GetGlobalInstance();
+  if (!log->GetGlobalLevel())
+    {
+    return;
+    }
+
+  #ifdef SQTK_WITHOUT_MPI
+  (void)comm;
+  int worldRank=0;
+  int rank=0;
+  int size=1;
+  unsigned long long totalBytes=nBytes;
+  double maxSeconds=seconds;
+  #else
+  int worldRank=0;
+  MPI_Comm_rank(MPI_COMM_WORLD,&worldRank);
+
+  int rank=0;
+  MPI_Comm_rank(comm,&rank);
+  int size=1;
+  MPI_Comm_size(comm,&size);
+
+  unsigned long long totalBytes=nBytes;
+  double maxSeconds=seconds;
+  if (size>1)
+    {
+    MPI_Reduce(&nBytes,&totalBytes,1,MPI_UNSIGNED_LONG_LONG,MPI_SUM,0,comm);
+    MPI_Reduce(&seconds,&maxSeconds,1,MPI_DOUBLE,MPI_MAX,0,comm);
+    }
+  #endif
+
+  const double MiB=1048576.0;
+
+  log->GetBody()
+    << worldRank << " " << eventName
+    << " files=" << nOps
+    << " bytes=" << nBytes
+    << " seconds=" << seconds
+    << " MiB/s=" << (seconds>0.0?nBytes/MiB/seconds:0.0)
+    << "\n";
+
+  if ((size>1) && (rank==0))
+    {
+    log->GetBody()
+      << worldRank << " " << eventName << " aggregate"
+      << " bytes=" << totalBytes
+      << " seconds=" << maxSeconds
+      << " MiB/s=" << (maxSeconds>0.0?totalBytes/MiB/maxSeconds:0.0)
+      << "\n";
+    }
+}
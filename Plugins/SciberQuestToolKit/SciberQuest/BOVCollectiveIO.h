@@ -0,0 +1,235 @@
+/*
+ * Copyright 2012 SciberQuest Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of SciberQuest Inc. nor the names of any contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef BOVCollectiveIO_h
+#define BOVCollectiveIO_h
+
+#ifdef SQTK_WITHOUT_MPI
+typedef void * MPI_Comm;
+typedef void * MPI_Info;
+typedef void * MPI_File;
+typedef void * MPI_Datatype;
+#else
+#include "SQMPICHWarningSupression.h" // for suppressing MPI warnings
+#include <mpi.h> // for MPI_Comm, MPI_Info, MPI_File, and MPI_Datatype
+#endif
+
+#include "MPIRawArrayIO.hxx" // for DataTraits
+
+#include <vector> // for vector
+#include <cstdlib> // for size_t
+
+class CartesianExtent;
+
+/// BOVCollectiveIO - tuned and batched collective I/O for the BOV files.
+/**
+The BOV reader and writer use this class for the MPI-IO of a time step.
+
+TuneHints makes the hints used to open the files of a time step. The
+user's hints are kept, the aggregators and collective buffer are chosen
+only when not set. The stripe size and count are queried once for each
+directory. There is one aggregator per node, or per stripe when there
+are fewer stripes than nodes. The collective buffer and the file realms
+are aligned to the stripe size.
+
+The reads or writes of all the arrays and components of a time step
+are queued with AddRead/AddWrite, then Execute starts all of them before
+completing any. It uses non-blocking collectives when MPI supports them
+(MPI 3.1) and split collectives otherwise, so the I/O of the separate
+files of a step can overlap. Components of interleaved VTK arrays are
+staged in contiguous buffers while the operations are pending. When the
+global log level is not 0 the bytes, time, and bandwidth of each
+Execute are recorded in vtkSQLog.
+
+Calls that return an int return 0 to indicate an error.
+*/
+class BOVCollectiveIO
+{
+public:
+  BOVCollectiveIO();
+  ~BOVCollectiveIO();
+
+  /**
+  Return new hints for the files of fileName's directory, tuned from
+  a copy of the given hints (may be MPI_INFO_NULL). In read mode the
+  file must exist. Collective over comm, the caller frees the hints.
+  */
+  static MPI_Info TuneHints(
+        MPI_Comm comm,
+        MPI_Info hints,
+        const char *fileName,
+        int readMode);
+
+  /**
+  Queue a collective read of the decomp subset of the domain sized
+  file into component compNoMem of the nCompsMem component array data.
+  */
+  template<typename T>
+  void AddRead(
+        MPI_File file,
+        MPI_Info hints,
+        const CartesianExtent &domain,
+        const CartesianExtent &decomp,
+        int nCompsMem,
+        int compNoMem,
+        T *data)
+    {
+    this->Add(
+          file,hints,domain,decomp,
+          DataTraits<T>::Type(),sizeof(T),
+          nCompsMem,compNoMem,data,
+          &BOVCollectiveIO::Scatter<T>,0);
+    }
+
+  /**
+  Queue a collective write of component compNoMem of the nCompsMem
+  component array data to the decomp subset of the domain sized file.
+  */
+  template<typename T>
+  void AddWrite(
+        MPI_File file,
+        MPI_Info hints,
+        const CartesianExtent &domain,
+        const CartesianExtent &decomp,
+        int nCompsMem,
+        int compNoMem,
+        T *data)
+    {
+    this->Add(
+          file,hints,domain,decomp,
+          DataTraits<T>::Type(),sizeof(T),
+          nCompsMem,compNoMem,data,
+          &BOVCollectiveIO::Scatter<T>,1);
+    }
+
+  /**
+  Return the number of queued operations.
+  */
+  size_t GetNumberOfOperations() const { return this->Ops.size(); }
+
+  /**
+  Issue the queued operations and wait for their completion. All the
+  processes of comm must call Execute with operations on the same files
+  in the same order. The queue is emptied. eventName is used to label
+  the log entries.
+  */
+  int Execute(MPI_Comm comm, const char *eventName);
+
+  /**
+  Record the bandwidth of an I/O of nBytes local bytes that took the
+  given time in the log. Collective over comm, when comm has more than
+  one process the aggregate bandwidth is recorded by its rank 0.
+  */
+  static void LogBandwidth(
+        MPI_Comm comm,
+        const char *eventName,
+        size_t nOps,
+        unsigned long long nBytes,
+        double seconds);
+
+private:
+  typedef void (*ScatterFunction)(
+        const void *src,
+        void *dest,
+        size_t n,
+        int nComps,
+        int compNo,
+        int gather);
+
+  template<typename T>
+  static void Scatter(
+        const void *src,
+        void *dest,
+        size_t n,
+        int nComps,
+        int compNo,
+        int gather)
+    {
+    const T *s=static_cast<const T*>(src);
+    T *d=static_cast<T*>(dest);
+    if (gather)
+      {
+      // interleaved array to contiguous buffer
+      for (size_t i=0; i<n; ++i)
+        {
+        d[i]=s[nComps*i+compNo];
+        }
+      }
+    else
+      {
+      // contiguous buffer to interleaved array
+      for (size_t i=0; i<n; ++i)
+        {
+        d[nComps*i+compNo]=s[i];
+        }
+      }
+    }
+
+  void Add(
+        MPI_File file,
+        MPI_Info hints,
+        const CartesianExtent &domain,
+        const CartesianExtent &decomp,
+        MPI_Datatype nativeType,
+        size_t typeSize,
+        int nCompsMem,
+        int compNoMem,
+        void *data,
+        ScatterFunction scatter,
+        int write);
+
+  void Clear();
+
+private:
+  class Operation
+  {
+  public:
+    MPI_File File;
+    MPI_Info Hints;
+    MPI_Datatype NativeType;
+    MPI_Datatype FileView;
+    size_t NumberOfElements;
+    size_t TypeSize;
+    int NCompsMem;
+    int CompNoMem;
+    void *Data;
+    void *Buffer;
+    ScatterFunction Scatter;
+    int Write;
+  };
+  std::vector<Operation> Ops;
+
+private:
+  BOVCollectiveIO(const BOVCollectiveIO &);
+  void operator=(const BOVCollectiveIO &);
+};
+
+#endif
+
+// VTK-HeaderTest-Exclude: BOVCollectiveIO.h
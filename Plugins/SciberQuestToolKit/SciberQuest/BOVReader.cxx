@@ -38,6 +38,7 @@
 #include "vtkPointData.h"
 
 #include "BinaryStream.hxx"
+#include "BOVCollectiveIO.h"
 #include "BOVTimeStepImage.h"
 #include "BOVScalarImageIterator.h"
 #include "BOVArrayImageIterator.h"
@@ -343,13 +344,9 @@ vtkDataSet *BOVReader::GetDataSet()
 //-----------------------------------------------------------------------------
 int BOVReader::ReadScalarArray(
       const BOVScalarImageIterator &it,
-      vtkDataSet *grid)
+      vtkDataSet *grid,
+      BOVCollectiveIO &io)
 {
-  #if defined BOVReaderTIME
-  vtkSQLog *log=vtkSQLog::GetGlobalInstance();
-  log->StartEvent("BOVReader::ReadScalarArray");
-  #endif
-
   const CartesianExtent &decomp=this->MetaData->GetDecomp();
   const size_t nCells=decomp.Size();
 
@@ -362,21 +359,17 @@ int BOVReader::ReadScalarArray(
   fa->Delete();
   float *pfa=fa->GetPointer(0);
 
-  // read
-  int ok=ReadDataArray(
-          it.GetFile(),
-          this->Hints,
-          this->MetaData->GetDomain(),
-          decomp,
-          1,
-          0,
-          pfa);
-
-  #if defined BOVReaderTIME
-  log->EndEvent("BOVReader::ReadScalarArray");
-  #endif
+  // queue the read
+  io.AddRead(
+        it.GetFile(),
+        this->Hints,
+        this->MetaData->GetDomain(),
+        decomp,
+        1,
+        0,
+        pfa);
 
-  return ok;
+  return 1;
 }
 
 //-----------------------------------------------------------------------------
@@ -429,16 +422,13 @@ int BOVReader::ReadScalarArray(
 //-----------------------------------------------------------------------------
 int BOVReader::ReadVectorArray(
       const BOVArrayImageIterator &it,
-      vtkDataSet *grid)
+      vtkDataSet *grid,
+      BOVCollectiveIO &io)
 {
-  #if defined BOVReaderTIME
-  vtkSQLog *log=vtkSQLog::GetGlobalInstance();
-  log->StartEvent("BOVReader::ReadVectorArray");
-  #endif
-
   // Memory requirements:
   // The vtk data is nComps*sizeof(component file).
-  // The intermediate buffer is sizeof(component file).
+  // Each component is staged in a buffer of sizeof(component file)
+  // until the reads of the time step complete.
   // One might use a strided mpi type for the memory view
   // but it's much slower if the seive buffer is either
   // disabled or too small to hold the read.
@@ -458,8 +448,6 @@ int BOVReader::ReadVectorArray(
   fa->Delete();
   float *pfa=fa->GetPointer(0);
 
-  float *buf=static_cast<float*>(malloc(nCells*sizeof(float)));
-
   for (int q=0; q<nComps; ++q)
     {
     // if a projection is requested then we zero out
@@ -474,33 +462,17 @@ int BOVReader::ReadVectorArray(
       continue;
       }
 
-    // Read qth component array
-    if (!ReadDataArray(
-            it.GetComponentFile(q),
-            this->Hints,
-            domain,
-            decomp,
-            1,0,
-            buf))
-      {
-      sqErrorMacro(std::cerr,
-        "ReadDataArray "<< it.GetName() << " component " << q << " failed.");
-      free(buf);
-      return 0;
-      }
-    // unpack from the read buffer into the vtk array
-    for (size_t i=0; i<nCells; ++i)
-      {
-      pfa[nComps*i+q]=buf[i];
-      }
+    // queue the read of the qth component array
+    io.AddRead(
+          it.GetComponentFile(q),
+          this->Hints,
+          domain,
+          decomp,
+          nComps,
+          q,
+          pfa);
     }
 
-  free(buf);
-
-  #if defined BOVReaderTIME
-  log->EndEvent("BOVReader::ReadVectorArray");
-  #endif
-
   return 1;
 }
 
@@ -584,19 +556,13 @@ int BOVReader::ReadVectorArray(
 //-----------------------------------------------------------------------------
 int BOVReader::ReadSymetricTensorArray(
       const BOVArrayImageIterator &it,
-      vtkDataSet *grid)
+      vtkDataSet *grid,
+      BOVCollectiveIO &io)
 {
-  #if defined BOVReaderTIME
-  vtkSQLog *log=vtkSQLog::GetGlobalInstance();
-  log->StartEvent("BOVReader::SymetricTensorArray");
-  #endif
-
   // Memory requirements:
   // The vtk data is nComps*sizeof(component file).
-  // The intermediate buffer is sizeof(component file).
-  // One might use a strided mpi type for the memory view
-  // but it's much slower if the seive buffer is either
-  // disabled or too small to hold the read.
+  // Each component is staged in a buffer of sizeof(component file)
+  // until the reads of the time step complete.
 
   const CartesianExtent &domain=this->MetaData->GetDomain();
   const CartesianExtent &decomp=this->MetaData->GetDecomp();
@@ -611,35 +577,38 @@ int BOVReader::ReadSymetricTensorArray(
   fa->Delete();
   float *pfa=fa->GetPointer(0);
 
-  float *buf=static_cast<float*>(malloc(nCells*sizeof(float)));
-
   // maps file component to memory component
   const int memComp[6]={0,1,2,4,5,8};
 
   for (int q=0; q<6; ++q)
     {
-    // Read qth component array
-    if (!ReadDataArray(
-            it.GetComponentFile(q),
-            this->Hints,
-            domain,
-            decomp,
-            1,0,
-            buf))
-      {
-      sqErrorMacro(std::cerr,
-        "ReadDataArray "<< it.GetName() << " component " << q << " failed.");
-      free(buf);
-      return 0;
-      }
-    // unpack from the read buffer into the vtk array
-    for (size_t i=0; i<nCells; ++i)
-      {
-      pfa[9*i+memComp[q]]=buf[i];
-      }
+    // queue the read of the qth component array
+    io.AddRead(
+          it.GetComponentFile(q),
+          this->Hints,
+          domain,
+          decomp,
+          9,
+          memComp[q],
+          pfa);
     }
 
-  free(buf);
+  return 1;
+}
+
+//-----------------------------------------------------------------------------
+void BOVReader::FillSymetricTensorArray(
+      const BOVArrayImageIterator &it,
+      vtkDataSet *grid)
+{
+  vtkFloatArray *fa
+    = vtkFloatArray::SafeDownCast(grid->GetPointData()->GetArray(it.GetName()));
+  if (fa==0)
+    {
+    return;
+    }
+  float *pfa=fa->GetPointer(0);
+  const size_t nCells=fa->GetNumberOfTuples();
 
   // fill in the symetric components
   const int srcComp[3]={1,2,5};
@@ -651,12 +620,6 @@ int BOVReader::ReadSymetricTensorArray(
       pfa[9*i+desComp[q]]=pfa[9*i+srcComp[q]];
       }
     }
-
-  #if defined BOVReaderTIME
-  log->EndEvent("BOVReader::ReadSymetricTensorArray");
-  #endif
-
-  return 1;
 }
 
 //-----------------------------------------------------------------------------
@@ -784,6 +747,11 @@ int BOVReader::ReadTimeStep(
   double prog=0.25;
   if(alg)alg->UpdateProgress(prog);
 
+  #ifndef SQTK_WITHOUT_MPI
+  double startTime=MPI_Wtime();
+  #endif
+  size_t nFiles=0;
+
   // scalars
   BOVScalarImageIterator sIt(step);
   for (;sIt.Ok(); sIt.Next())
@@ -793,6 +761,7 @@ int BOVReader::ReadTimeStep(
       {
       return 0;
       }
+    nFiles+=1;
     prog+=progInc;
     if(alg)alg->UpdateProgress(prog);
     }
@@ -806,6 +775,7 @@ int BOVReader::ReadTimeStep(
       {
       return 0;
       }
+    nFiles+=vIt.GetNumberOfComponents();
     prog+=progInc;
     if(alg)alg->UpdateProgress(prog);
     }
@@ -819,6 +789,7 @@ int BOVReader::ReadTimeStep(
       {
       return 0;
       }
+    nFiles+=tIt.GetNumberOfComponents();
     prog+=progInc;
     if(alg)alg->UpdateProgress(prog);
     }
@@ -832,10 +803,26 @@ int BOVReader::ReadTimeStep(
       {
       return 0;
       }
+    nFiles+=6;
     prog+=progInc;
     if(alg)alg->UpdateProgress(prog);
     }
 
+  #ifndef SQTK_WITHOUT_MPI
+  // the arrays are read in multiple passes, record the
+  // bandwidth of the time step. the blocks read by each
+  // process differ so there is no aggregate.
+  unsigned long long nBytes=nFiles*descr->GetMemExtent().Size()*sizeof(float);
+  BOVCollectiveIO::LogBandwidth(
+        MPI_COMM_SELF,
+        "BOVReader::ReadTimeStep",
+        nFiles,
+        nBytes,
+        MPI_Wtime()-startTime);
+  #else
+  (void)nFiles;
+  #endif
+
   #if defined BOVReaderTIME
   log->EndEvent("BOVReader::ReadTimeStep");
   #endif
@@ -854,62 +841,56 @@ int BOVReader::ReadTimeStep(
   log->StartEvent("BOVReader::ReadTimeStep");
   #endif
 
-  double progInc=0.70/(double)step->GetNumberOfImages();
   double prog=0.25;
   if(alg)alg->UpdateProgress(prog);
 
+  // The reads of all of the arrays are queued and then
+  // issued together.
+  BOVCollectiveIO io;
+
   // scalars
   BOVScalarImageIterator sIt(step);
   for (;sIt.Ok(); sIt.Next())
     {
-    int ok=this->ReadScalarArray(sIt,grid);
-    if (!ok)
-      {
-      return 0;
-      }
-    prog+=progInc;
-    if(alg)alg->UpdateProgress(prog);
+    this->ReadScalarArray(sIt,grid,io);
     }
 
   // vectors
   BOVVectorImageIterator vIt(step);
   for (;vIt.Ok(); vIt.Next())
     {
-    int ok=this->ReadVectorArray(vIt,grid);
-    if (!ok)
-      {
-      return 0;
-      }
-    prog+=progInc;
-    if(alg)alg->UpdateProgress(prog);
+    this->ReadVectorArray(vIt,grid,io);
     }
 
   // tensors
   BOVTensorImageIterator tIt(step);
   for (;tIt.Ok(); tIt.Next())
     {
-    int ok=this->ReadVectorArray(tIt,grid);
-    if (!ok)
-      {
-      return 0;
-      }
-    prog+=progInc;
-    if(alg)alg->UpdateProgress(prog);
+    this->ReadVectorArray(tIt,grid,io);
     }
 
   // symetric tensors
   BOVSymetricTensorImageIterator stIt(step);
   for (;stIt.Ok(); stIt.Next())
     {
-    int ok=this->ReadSymetricTensorArray(stIt,grid);
-    if (!ok)
-      {
-      return 0;
-      }
-    prog+=progInc;
-    if(alg)alg->UpdateProgress(prog);
+    this->ReadSymetricTensorArray(stIt,grid,io);
     }
 
+  if (!io.Execute(this->Comm,"BOVReader::ReadTimeStep"))
+    {
+    sqErrorMacro(std::cerr,"Failed to read the time step.");
+    return 0;
+    }
+
+  BOVSymetricTensorImageIterator fIt(step);
+  for (;fIt.Ok(); fIt.Next())
+    {
+    this->FillSymetricTensorArray(fIt,grid);
+    }
+
+  prog=0.95;
+  if(alg)alg->UpdateProgress(prog);
+
   #if defined BOVReaderTIME
   log->EndEvent("BOVReader::ReadTimeStep");
   #endif
@@ -46,6 +46,7 @@ class vtkAlgorithm;
 class BOVScalarImageIterator;
 class BOVArrayImageIterator;
 class BOVTimeStepImage;
+class BOVCollectiveIO;
 class CartesianDataBlockIODescriptor;
 
 /// Low level reader for BOV files with domain decomposition capability.
@@ -196,12 +197,30 @@ protected:
 
 private:
   /**
-  Read the array from the specified file into point data in a single
-  pass.
+  Create the array in point data and queue the read of the specified
+  file into it. The reads are done in a single pass by io.
   */
-  int ReadScalarArray(const BOVScalarImageIterator &it, vtkDataSet *grid);
-  int ReadVectorArray(const BOVArrayImageIterator &it, vtkDataSet *grid);
-  int ReadSymetricTensorArray(const BOVArrayImageIterator &it, vtkDataSet *grid);
+  int ReadScalarArray(
+        const BOVScalarImageIterator &it,
+        vtkDataSet *grid,
+        BOVCollectiveIO &io);
+
+  int ReadVectorArray(
+        const BOVArrayImageIterator &it,
+        vtkDataSet *grid,
+        BOVCollectiveIO &io);
+
+  int ReadSymetricTensorArray(
+        const BOVArrayImageIterator &it,
+        vtkDataSet *grid,
+        BOVCollectiveIO &io);
+
+  /**
+  Copy the symetric components of a tensor once it has been read.
+  */
+  void FillSymetricTensorArray(
+        const BOVArrayImageIterator &it,
+        vtkDataSet *grid);
 
   /**
   Read the array from the specified file into point data in multiple
@@ -33,6 +33,7 @@
 #include "BOVVectorImage.h"
 
 #include "BOVMetaData.h"
+#include "BOVCollectiveIO.h"
 #include "SQMacros.h"
 
 #include <sstream>
@@ -76,6 +77,10 @@ BOVTimeStepImage::BOVTimeStepImage(
 
   std::ostringstream seriesExt;
   seriesExt << "_" << stepIdx << "." << metaData->GetBrickFileExtension();
+  // The hints are tuned for the file system on the first file opened
+  // and then used for all the files of the time step.
+  MPI_Info userHints=hints;
+  hints=MPI_INFO_NULL;
   // Open each array.
   size_t nArrays=metaData->GetNumberOfArrays();
   for (size_t i=0; i<nArrays; ++i)
@@ -86,6 +91,28 @@ BOVTimeStepImage::BOVTimeStepImage(
       {
       continue;
       }
+    if (hints==MPI_INFO_NULL)
+      {
+      std::ostringstream fileName;
+      fileName << metaData->GetPathToBricks() << PATH_SEP << arrayName;
+      if (metaData->IsArrayVector(arrayName))
+        {
+        fileName << "x";
+        }
+      else
+      if (metaData->IsArrayTensor(arrayName)
+        || metaData->IsArraySymetricTensor(arrayName))
+        {
+        fileName << "-xx";
+        }
+      fileName << seriesExt.str();
+
+      hints=BOVCollectiveIO::TuneHints(
+            comm,
+            userHints,
+            fileName.str().c_str(),
+            metaData->ReadMode());
+      }
     // scalar
     if (metaData->IsArrayScalar(arrayName))
       {
@@ -195,6 +222,11 @@ BOVTimeStepImage::BOVTimeStepImage(
       sqErrorMacro(std::cerr,"Bad array type for array " << arrayName << ".");
       }
     }
+
+  if (hints!=MPI_INFO_NULL)
+    {
+    MPI_Info_free(&hints);
+    }
   #endif
 }
 
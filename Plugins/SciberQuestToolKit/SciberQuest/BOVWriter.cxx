@@ -38,6 +38,7 @@
 #include "vtkStructuredGrid.h"
 #include "vtkPointData.h"
 
+#include "BOVCollectiveIO.h"
 #include "BOVTimeStepImage.h"
 #include "BOVScalarImageIterator.h"
 #include "BOVArrayImageIterator.h"
@@ -252,7 +253,8 @@ int BOVWriter::WriteMetaData()
 //-----------------------------------------------------------------------------
 int BOVWriter::WriteScalarArray(
       const BOVScalarImageIterator &it,
-      vtkDataSet *grid)
+      vtkDataSet *grid,
+      BOVCollectiveIO &io)
 {
   vtkDataArray *array=grid->GetPointData()->GetArray(it.GetName());
   if (array==0)
@@ -264,12 +266,11 @@ int BOVWriter::WriteScalarArray(
   const CartesianExtent &domain=this->MetaData->GetDomain();
   const CartesianExtent &decomp=this->MetaData->GetDecomp();
 
-  // write
-  int ok=0;
+  // queue the write
   switch(array->GetDataType())
   {
     vtkTemplateMacro(
-        ok=WriteDataArray(
+        io.AddWrite(
           it.GetFile(),
           this->Hints,
           domain,
@@ -280,17 +281,19 @@ int BOVWriter::WriteScalarArray(
       );
   }
 
-  return ok;
+  return 1;
 }
 
 //-----------------------------------------------------------------------------
 int BOVWriter::WriteVectorArray(
       const BOVArrayImageIterator &it,
-      vtkDataSet *grid)
+      vtkDataSet *grid,
+      BOVCollectiveIO &io)
 {
   // Memory requirements:
   // The vtk data is nComps*sizeof(component file).
-  // The intermediate buffer is sizeof(component file).
+  // Each component is staged in a buffer of sizeof(component file)
+  // until the writes of the time step complete.
   // One might use a strided mpi type for the memory view
   // but it's much slower in our tests
 
@@ -303,7 +306,6 @@ int BOVWriter::WriteVectorArray(
 
   const CartesianExtent &domain=this->MetaData->GetDomain();
   const CartesianExtent &decomp=this->MetaData->GetDecomp();
-  const size_t nCells=decomp.Size();
 
   const int nComps=it.GetNumberOfComponents();
 
@@ -312,32 +314,19 @@ int BOVWriter::WriteVectorArray(
     vtkTemplateMacro(
 
       VTK_TT *pArray=(VTK_TT*)array->GetVoidPointer(0);
-      VTK_TT *buf=(VTK_TT*)malloc(nCells*sizeof(VTK_TT));
 
       for (int q=0; q<nComps; ++q)
         {
-        // flatten
-        for (size_t i=0; i<nCells; ++i)
-          {
-          buf[i]=pArray[nComps*i+q];
-          }
-        // Write qth component array
-        if (!WriteDataArray(
+        // queue the write of the qth component array
+        io.AddWrite(
               it.GetComponentFile(q),
               this->Hints,
               domain,
               decomp,
-              1,
-              0,
-              buf))
-          {
-              sqErrorMacro(std::cerr,
-                "WriteDataArray "<< it.GetName() << " component " << q << " failed.");
-              free(buf);
-              return 0;
-          }
+              nComps,
+              q,
+              pArray);
         }
-      free(buf);
       );
     }
 
@@ -347,14 +336,13 @@ int BOVWriter::WriteVectorArray(
 //-----------------------------------------------------------------------------
 int BOVWriter::WriteSymetricTensorArray(
       const BOVArrayImageIterator &it,
-      vtkDataSet *grid)
+      vtkDataSet *grid,
+      BOVCollectiveIO &io)
 {
   // Memory requirements:
   // The vtk data is nComps*sizeof(component file).
-  // The intermediate buffer is sizeof(component file).
-  // One might use a strided mpi type for the memory view
-  // but it's much slower if the seive buffer is either
-  // disabled or too small to hold the read.
+  // Each component is staged in a buffer of sizeof(component file)
+  // until the writes of the time step complete.
 
   vtkDataArray *array=grid->GetPointData()->GetArray(it.GetName());
   if (array==0)
@@ -365,7 +353,6 @@ int BOVWriter::WriteSymetricTensorArray(
 
   const CartesianExtent &domain=this->MetaData->GetDomain();
   const CartesianExtent &decomp=this->MetaData->GetDecomp();
-  const size_t nCells=decomp.Size();
 
   const int memComp[6]={0,1,2,4,5,8};
 
@@ -374,33 +361,19 @@ int BOVWriter::WriteSymetricTensorArray(
     vtkTemplateMacro(
 
       VTK_TT *pArray=(VTK_TT*)array->GetVoidPointer(0);
-      VTK_TT *buf=(VTK_TT*)malloc(nCells*sizeof(VTK_TT));
 
       for (int q=0; q<6; ++q)
         {
-        // flatten
-        for (size_t i=0; i<nCells; ++i)
-          {
-          buf[i]=pArray[9*i+memComp[q]];
-          }
-        // Write qth component array
-        if (!WriteDataArray(
+        // queue the write of the qth component array
+        io.AddWrite(
               it.GetComponentFile(q),
               this->Hints,
               domain,
               decomp,
-              1,
-              0,
-              buf))
-          {
-          sqErrorMacro(std::cerr,
-            "WriteDataArray "<< it.GetName() << " component " << q << " failed.");
-          free(buf);
-          return 0;
-          }
+              9,
+              memComp[q],
+              pArray);
         }
-
-      free(buf);
       );
   }
 
@@ -435,62 +408,66 @@ int BOVWriter::WriteTimeStep(
       vtkDataSet *grid,
       vtkAlgorithm *alg)
 {
-  double progInc=0.70/(double)step->GetNumberOfImages();
   double prog=0.25;
   if(alg)alg->UpdateProgress(prog);
 
+  // The writes of all of the arrays are queued and then
+  // issued together.
+  BOVCollectiveIO io;
+
   // scalars
   BOVScalarImageIterator sIt(step);
   for (;sIt.Ok(); sIt.Next())
     {
-    int ok=this->WriteScalarArray(sIt,grid);
+    int ok=this->WriteScalarArray(sIt,grid,io);
     if (!ok)
       {
       return 0;
       }
-    prog+=progInc;
-    if(alg)alg->UpdateProgress(prog);
     }
 
   // vectors
   BOVVectorImageIterator vIt(step);
   for (;vIt.Ok(); vIt.Next())
     {
-    int ok=this->WriteVectorArray(vIt,grid);
+    int ok=this->WriteVectorArray(vIt,grid,io);
     if (!ok)
       {
       return 0;
       }
-    prog+=progInc;
-    if(alg)alg->UpdateProgress(prog);
     }
 
   // tensors
   BOVTensorImageIterator tIt(step);
   for (;tIt.Ok(); tIt.Next())
     {
-    int ok=this->WriteVectorArray(tIt,grid);
+    int ok=this->WriteVectorArray(tIt,grid,io);
     if (!ok)
       {
       return 0;
       }
-    prog+=progInc;
-    if(alg)alg->UpdateProgress(prog);
     }
 
   // symetric tensors
   BOVSymetricTensorImageIterator stIt(step);
   for (;stIt.Ok(); stIt.Next())
     {
-    int ok=this->WriteSymetricTensorArray(stIt,grid);
+    int ok=this->WriteSymetricTensorArray(stIt,grid,io);
     if (!ok)
       {
       return 0;
       }
-    prog+=progInc;
-    if(alg)alg->UpdateProgress(prog);
     }
 
+  if (!io.Execute(this->Comm,"BOVWriter::WriteTimeStep"))
+    {
+    sqErrorMacro(pCerr(),"Failed to write the time step.");
+    return 0;
+    }
+
+  prog=0.95;
+  if(alg)alg->UpdateProgress(prog);
+
   return 1;
 }
 
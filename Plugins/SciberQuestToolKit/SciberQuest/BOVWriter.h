@@ -46,6 +46,7 @@ class vtkAlgorithm;
 class BOVScalarImageIterator;
 class BOVArrayImageIterator;
 class BOVTimeStepImage;
+class BOVCollectiveIO;
 
 /// Low level writer for BOV files with domain decomposition capability.
 /**
@@ -137,12 +138,23 @@ protected:
 
 private:
   /**
-  Write the array from the specified file into point data in a single
-  pass.
+  Queue the write of the point data array to the specified file. The
+  writes are done in a single pass by io.
   */
-  int WriteScalarArray(const BOVScalarImageIterator &it, vtkDataSet *grid);
-  int WriteVectorArray(const BOVArrayImageIterator &it, vtkDataSet *grid);
-  int WriteSymetricTensorArray(const BOVArrayImageIterator &it, vtkDataSet *grid);
+  int WriteScalarArray(
+        const BOVScalarImageIterator &it,
+        vtkDataSet *grid,
+        BOVCollectiveIO &io);
+
+  int WriteVectorArray(
+        const BOVArrayImageIterator &it,
+        vtkDataSet *grid,
+        BOVCollectiveIO &io);
+
+  int WriteSymetricTensorArray(
+        const BOVArrayImageIterator &it,
+        vtkDataSet *grid,
+        BOVCollectiveIO &io);
 
 private:
   BOVMetaData *MetaData;     // Object that knows how to interpret dataset.
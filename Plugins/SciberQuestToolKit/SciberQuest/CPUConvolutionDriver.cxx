@@ -40,6 +40,7 @@
 #include "postream.h"
 
 #include "vtkDataArray.h"
+#include "vtkPVSMPTools.h"
 
 #include <iostream>
 #include <vector>
@@ -47,10 +48,186 @@
 
 //#define CPUConvolutionDriverDEBUG
 
+namespace {
+
+// vtkPVSMPTools functor applying a 1D kernel along one axis (when KN is
+// null) or the full kernel to a range of output rows.
+template<typename T>
+class ConvolutionRowsFunctor
+{
+public:
+  ConvolutionRowsFunctor(
+        int nComp,
+        int *sn,
+        int *so,
+        size_t sStride,
+        const T *S,
+        int *dn,
+        T *D,
+        int kn,
+        int *KN,
+        const float *K)
+     :
+    NComp(nComp),
+    SN(sn),
+    SO(so),
+    SStride(sStride),
+    S(S),
+    DN(dn),
+    D(D),
+    Kn(kn),
+    KN(KN),
+    K(K)
+  {}
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    if (this->KN)
+      {
+      ::ScalarConvolutionRows<T>(
+            begin,end,this->NComp,this->SN,this->SO,this->S,
+            this->DN,this->D,this->KN,this->K);
+      }
+    else
+      {
+      ::ScalarConvolutionPass<T>(
+            begin,end,this->NComp,this->SN,this->SO,this->SStride,this->S,
+            this->DN,this->D,this->Kn,this->K);
+      }
+  }
+
+private:
+  int NComp;
+  int *SN;
+  int *SO;
+  size_t SStride;
+  const T *S;
+  int *DN;
+  T *D;
+  int Kn;
+  int *KN;
+  const float *K;
+};
+
+//-----------------------------------------------------------------------------
+template<typename T>
+void ForEachRow(int nThreads, vtkIdType nRows, ConvolutionRowsFunctor<T> &f)
+{
+  vtkPVSMPTools::For(nThreads,0,nRows,0,f);
+}
+
+/**
+Convolution of the VTK ordered arrays V and W. When the kernel is
+separable it's applied as 1D passes along each axis through temporary
+arrays covering the output extent along the axes already done and the
+output extent grown by the kernel along the others. Passes along
+collapsed dimensions are skipped. Other kernels are applied directly.
+*/
+//-----------------------------------------------------------------------------
+template<typename T>
+void SeparableConvolution(
+    int nThreads,
+    CartesianExtent &extV,
+    CartesianExtent &extW,
+    CartesianExtent &extK,
+    int nComp,
+    T *V,
+    T *W,
+    float *K)
+{
+  int nV[3];
+  extV.Size(nV);
+
+  int nW[3];
+  extW.Size(nW);
+
+  int nK[3];
+  extK.Size(nK);
+
+  // origin of the output in the input
+  int so[3];
+  for (int q=0; q<3; ++q)
+    {
+    so[q]=extW[2*q]-extV[2*q]+extK[2*q];
+    }
+
+  std::vector<float> k1[3];
+  for (int q=0; q<3; ++q)
+    {
+    k1[q].resize(nK[q]);
+    }
+
+  if (!::SeparateKernel(nK,K,&k1[0][0],&k1[1][0],&k1[2][0]))
+    {
+    ConvolutionRowsFunctor<T> rows(nComp,nV,so,0,V,nW,W,0,nK,K);
+    ForEachRow<T>(nThreads,((vtkIdType)nW[1])*nW[2],rows);
+    return;
+    }
+
+  // passes to make, at least one to fill the output.
+  int pass[3];
+  int nPass=0;
+  for (int q=0; q<3; ++q)
+    {
+    if ((nK[q]>1) || (k1[q][0]!=1.0f))
+      {
+      pass[nPass]=q;
+      ++nPass;
+      }
+    }
+  if (nPass==0)
+    {
+    pass[0]=0;
+    nPass=1;
+    }
+
+  const T *S=V;
+  int sn[3]={nV[0],nV[1],nV[2]};
+
+  for (int p=0; p<nPass; ++p)
+    {
+    int a=pass[p];
+
+    int dn[3];
+    for (int q=0; q<3; ++q)
+      {
+      dn[q]=nW[q]+(q>a?nK[q]-1:0);
+      }
+
+    T *D=W;
+    if (p<(nPass-1))
+      {
+      size_t dnijk=((size_t)dn[0])*dn[1]*dn[2]*nComp;
+      posix_memalign((void**)&D,64,dnijk*sizeof(T));
+      }
+
+    size_t sStride=(a==0?1:(a==1?sn[0]:((size_t)sn[0])*sn[1]));
+
+    ConvolutionRowsFunctor<T> rows(
+          nComp,sn,so,sStride,S,dn,D,nK[a],0,&k1[a][0]);
+    ForEachRow<T>(nThreads,((vtkIdType)dn[1])*dn[2],rows);
+
+    // the output of this pass is the input of the next
+    if (S!=V)
+      {
+      free((void*)S);
+      }
+    S=D;
+    for (int q=0; q<3; ++q)
+      {
+      sn[q]=dn[q];
+      so[q]=0;
+      }
+    }
+}
+
+};
+
 //-----------------------------------------------------------------------------
 CPUConvolutionDriver::CPUConvolutionDriver()
         :
-    Optimization(OPT_NONE)
+    Optimization(OPT_NONE),
+    NumberOfThreads(1)
 {}
 
 //-----------------------------------------------------------------------------
@@ -213,6 +390,23 @@ int CPUConvolutionDriver::Convolution(
         }
       break;
 
+    ///
+    case OPT_SEPARABLE:
+      switch (V->GetDataType())
+        {
+        vtkFloatTemplateMacro(
+          ::SeparableConvolution<VTK_TT>(
+              this->NumberOfThreads,
+              extV,
+              extW,
+              extK,
+              nComp,
+              (VTK_TT*)V->GetVoidPointer(0),
+              (VTK_TT*)W->GetVoidPointer(0),
+              K));
+        }
+      break;
+
     default:
       sqErrorMacro(pCerr(),"Invalid optimzation code " << this->Optimization);
       return -1;
@@ -42,16 +42,29 @@ public:
   CPUConvolutionDriver();
 
   /**
-  Select the optimizations used.
+  Select the optimizations used. OPT_SEPARABLE applies separable
+  kernels (eg Gaussian and constant) as three 1D passes and other
+  kernels with a row oriented direct convolution, in both cases with
+  vectorizable inner loops over cache sized tiles of the output rows,
+  the rows being distributed over NumberOfThreads threads.
   */
   enum{
     OPT_NONE=0,
     OPT_FLATTEN_VTK=1,
-    OPT_Z_ORDER=2
+    OPT_Z_ORDER=2,
+    OPT_SEPARABLE=3
   };
   void SetOptimization(int opt){ this->Optimization=opt; }
   int GetOptimization(){ return this->Optimization; }
 
+  /**
+  Set the number of threads used by OPT_SEPARABLE. 0 uses the
+  default number of threads of vtkSMPTools, larger values at most
+  that many of them.
+  */
+  void SetNumberOfThreads(int n){ this->NumberOfThreads=(n<0?0:n); }
+  int GetNumberOfThreads(){ return this->NumberOfThreads; }
+
   /// Invoke the kernel
   int Convolution(
       CartesianExtent &extV,
@@ -65,6 +78,7 @@ public:
 
 private:
   int Optimization;
+  int NumberOfThreads;
 };
 
 #endif
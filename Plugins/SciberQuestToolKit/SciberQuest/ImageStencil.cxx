@@ -0,0 +1,149 @@
+/*
+ * Copyright 2012 SciberQuest Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of SciberQuest Inc. nor the names of any contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "ImageStencil.h"
+
+#include "vtkInformation.h"
+#include "vtkPVSMPTools.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
+
+namespace {
+
+// vtkPVSMPTools functor applying a slab functor to a range of the planes
+// of an extent.
+class ImageStencilFunctor
+{
+public:
+  ImageStencilFunctor(
+        const CartesianExtent &ext,
+        int axis,
+        ImageStencilSlab &slab)
+     :
+    Ext(ext),
+    Axis(axis),
+    Slab(slab)
+  {}
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    CartesianExtent slab(this->Ext);
+    slab[2*this->Axis]=this->Ext[2*this->Axis]+static_cast<int>(begin);
+    slab[2*this->Axis+1]=this->Ext[2*this->Axis]+static_cast<int>(end)-1;
+    this->Slab.Execute(slab);
+  }
+
+private:
+  CartesianExtent Ext;
+  int Axis;
+  ImageStencilSlab &Slab;
+};
+
+};
+
+//-----------------------------------------------------------------------------
+void ImageStencil::RequestUpdateExtent(
+      vtkInformation *inInfo,
+      vtkInformation *outInfo,
+      int nGhosts,
+      int mode)
+{
+  typedef vtkStreamingDemandDrivenPipeline vtkSDDPipeline;
+
+  // The ghost levels requested downstream are passed up along with
+  // ours so that they are all made by the same exchange.
+  int nOutputGhosts
+    = outInfo->Get(vtkSDDPipeline::UPDATE_NUMBER_OF_GHOST_LEVELS());
+
+  inInfo->Set(
+        vtkSDDPipeline::UPDATE_NUMBER_OF_GHOST_LEVELS(),
+        nGhosts+nOutputGhosts);
+
+  CartesianExtent outputExt;
+  outInfo->Get(
+        vtkSDDPipeline::UPDATE_EXTENT(),
+        outputExt.GetData());
+
+  CartesianExtent wholeExt;
+  inInfo->Get(
+        vtkSDDPipeline::WHOLE_EXTENT(),
+        wholeExt.GetData());
+
+  outputExt = CartesianExtent::Grow(
+        outputExt,
+        wholeExt,
+        nGhosts,
+        mode);
+
+  inInfo->Set(
+        vtkSDDPipeline::UPDATE_EXTENT(),
+        outputExt.GetData(),
+        6);
+
+  int piece
+    = outInfo->Get(vtkSDDPipeline::UPDATE_PIECE_NUMBER());
+
+  int numPieces
+    = outInfo->Get(vtkSDDPipeline::UPDATE_NUMBER_OF_PIECES());
+
+  inInfo->Set(vtkSDDPipeline::UPDATE_PIECE_NUMBER(), piece);
+  inInfo->Set(vtkSDDPipeline::UPDATE_NUMBER_OF_PIECES(), numPieces);
+  inInfo->Set(vtkSDDPipeline::EXACT_EXTENT(), 1);
+}
+
+//-----------------------------------------------------------------------------
+CartesianExtent ImageStencil::GetOutputExtent(
+      const CartesianExtent &inputExt,
+      const CartesianExtent &outputDomain,
+      int nGhosts,
+      int mode)
+{
+  return CartesianExtent::Grow(inputExt,outputDomain,-nGhosts,mode);
+}
+
+//-----------------------------------------------------------------------------
+void ImageStencil::ForEachSlab(
+      const CartesianExtent &ext,
+      int nThreads,
+      ImageStencilSlab &slab)
+{
+  if (nThreads==1)
+    {
+    slab.Execute(ext);
+    return;
+    }
+
+  int axis=2;
+  while ((axis>0) && (ext[2*axis]==ext[2*axis+1]))
+    {
+    --axis;
+    }
+
+  ImageStencilFunctor f(ext,axis,slab);
+  vtkPVSMPTools::For(nThreads,0,ext[2*axis+1]-ext[2*axis]+1,1,f);
+}
@@ -0,0 +1,102 @@
+/*
+ * Copyright 2012 SciberQuest Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of SciberQuest Inc. nor the names of any contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef ImageStencil_h
+#define ImageStencil_h
+
+#include "CartesianExtent.h" // for CartesianExtent
+
+class vtkInformation;
+
+/// ImageStencilSlab - work done on a slab of the output by a stencil filter.
+class ImageStencilSlab
+{
+public:
+  virtual ~ImageStencilSlab(){}
+
+  /**
+  Apply the stencil to the points of the slab, a sub extent of the
+  output extent. Called concurrently on disjoint slabs.
+  */
+  virtual void Execute(const CartesianExtent &slab)=0;
+};
+
+/// ImageStencil - pipeline and threading support for stencil filters.
+/**
+The image filters applying a stencil to their input (vtkSQMedianFilter,
+vtkSQEdgeFilter, vtkSQKernelConvolution) use these to request their ghost
+layers and to distribute the work over threads.
+
+The ghost layers requested by a chain of stencil filters are accumulated
+in the update request, each filter adding the layers its stencil needs to
+those requested downstream. vtkSQImageGhosts upstream of the chain then
+exchanges all of the layers at once. Each filter computes its output on
+its input extent shrunk by its stencil and so passes the remaining layers
+down the chain.
+*/
+class ImageStencil
+{
+public:
+  /**
+  Request the output's update extent grown by nGhosts, and nGhosts
+  plus the output's ghost levels, from the input.
+  */
+  static void RequestUpdateExtent(
+        vtkInformation *inInfo,
+        vtkInformation *outInfo,
+        int nGhosts,
+        int mode);
+
+  /**
+  Return the extent a stencil filter computes given the extent of its
+  input, the input shrunk by nGhosts and clipped to the output's problem
+  domain.
+  */
+  static CartesianExtent GetOutputExtent(
+        const CartesianExtent &inputExt,
+        const CartesianExtent &outputDomain,
+        int nGhosts,
+        int mode);
+
+  /**
+  Apply the slab functor to ext split in planes along its slowest
+  varying non-degenerate axis, the planes being distributed over
+  nThreads threads. 0 uses the default number of threads of vtkSMPTools,
+  larger values at most that many of them, and 1 applies it to the whole
+  extent on the calling thread.
+  */
+  static void ForEachSlab(
+        const CartesianExtent &ext,
+        int nThreads,
+        ImageStencilSlab &slab);
+};
+
+#endif
+
+// VTK-HeaderTest-Exclude: ImageStencil.h
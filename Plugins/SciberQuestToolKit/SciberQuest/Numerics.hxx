@@ -12,6 +12,7 @@ Copyright 2012 SciberQuest Inc.
 #include<iostream>
 
 #include <cstdlib>
+#include <algorithm>
 #include <cmath>
 #include <complex>
 
@@ -934,6 +935,212 @@ void ScalarConvolution3D(
     }
 }
 
+/**
+Test if the kernel K of dimension kn[3] is the outer product of three
+1D kernels, kn[q] being 1 along the collapsed dimension of 2D kernels.
+If so the 1D kernels are returned in kx,ky,kz and 1 is returned. The
+factors are taken on the lines through the largest element and the
+product is checked element by element with the relative tolerance tol.
+Gaussian and constant kernels are separable, LoG kernels are not.
+*/
+//*****************************************************************************
+inline
+int SeparateKernel(
+      int *kn,
+      float *K,
+      float *kx,
+      float *ky,
+      float *kz,
+      float tol=1.0e-5f)
+{
+  const size_t kni=kn[0];
+  const size_t knij=kn[0]*kn[1];
+  const size_t knijk=knij*kn[2];
+
+  // pivot on the largest element
+  size_t p=0;
+  float pmax=0.0f;
+  for (size_t q=0; q<knijk; ++q)
+    {
+    float a=fabs(K[q]);
+    if (a>pmax)
+      {
+      pmax=a;
+      p=q;
+      }
+    }
+  if (pmax==0.0f)
+    {
+    return 0;
+    }
+  const size_t k0=p/knij;
+  const size_t j0=(p-k0*knij)/kni;
+  const size_t i0=p-k0*knij-j0*kni;
+  const float c=K[p];
+
+  for (int i=0; i<kn[0]; ++i)
+    {
+    kx[i]=K[k0*knij+j0*kni+i];
+    }
+  for (int j=0; j<kn[1]; ++j)
+    {
+    ky[j]=K[k0*knij+j*kni+i0]/c;
+    }
+  for (int k=0; k<kn[2]; ++k)
+    {
+    kz[k]=K[k*knij+j0*kni+i0]/c;
+    }
+
+  // check that the factors reproduce the kernel
+  const float etol=tol*pmax;
+  for (int k=0; k<kn[2]; ++k)
+    {
+    for (int j=0; j<kn[1]; ++j)
+      {
+      for (int i=0; i<kn[0]; ++i)
+        {
+        float e=K[k*knij+j*kni+i]-kx[i]*ky[j]*kz[k];
+        if (fabs(e)>etol)
+          {
+          return 0;
+          }
+        }
+      }
+    }
+
+  return 1;
+}
+
+/**
+Apply a 1D kernel k of length kn along one axis to the rows [rowBegin,
+rowEnd) of the output. The arrays are in VTK order with nComp
+interleaved components, S has dimension sn[3] and D has dimension dn[3].
+The output element (i,j,k) is the sum over t of k[t]*S(i+so[0],j+so[1],
+k+so[2]) shifted by t along the axis, where sStride is the distance
+between two consecutive elements along that axis in S. Each output row
+is contiguous in both arrays so that the inner loop is a unit stride
+multiply-add the compiler vectorizes. Rows are processed in tiles that
+stay in the L1 cache while the taps are applied.
+*/
+//*****************************************************************************
+template<typename T>
+void ScalarConvolutionPass(
+      size_t rowBegin,
+      size_t rowEnd,
+      int nComp,
+      int *sn,
+      int *so,
+      size_t sStride,
+      const T * __restrict__ S,
+      int *dn,
+      T * __restrict__ D,
+      int kn,
+      const float * __restrict__ k)
+{
+  const size_t tile=1024;
+  const size_t rowLen=((size_t)dn[0])*nComp;
+  const size_t sRowStride=((size_t)sn[0])*nComp;
+  const size_t sPlaneStride=sRowStride*sn[1];
+  const size_t tapStride=sStride*nComp;
+
+  for (size_t r=rowBegin; r<rowEnd; ++r)
+    {
+    const size_t dk=r/dn[1];
+    const size_t dj=r-dk*dn[1];
+
+    T * __restrict__ d=D+r*rowLen;
+    const T * __restrict__ s
+      = S+(dk+so[2])*sPlaneStride+(dj+so[1])*sRowStride+((size_t)so[0])*nComp;
+
+    for (size_t x0=0; x0<rowLen; x0+=tile)
+      {
+      const size_t x1=(x0+tile<rowLen?x0+tile:rowLen);
+
+      const T k0=((T)k[0]);
+      for (size_t x=x0; x<x1; ++x)
+        {
+        d[x]=k0*s[x];
+        }
+
+      for (int t=1; t<kn; ++t)
+        {
+        const T kt=((T)k[t]);
+        const T * __restrict__ st=s+t*tapStride;
+        for (size_t x=x0; x<x1; ++x)
+          {
+          d[x]+=kt*st[x];
+          }
+        }
+      }
+    }
+}
+
+/**
+Direct convolution of the rows [rowBegin, rowEnd) of the output with the
+full kernel K of dimension kn[3], used when the kernel is not separable.
+The arrays are laid out as in ScalarConvolutionPass, the output origin is
+at so[3] in S. Each kernel row contributes with a unit stride multiply-add
+over a tile of the output row.
+*/
+//*****************************************************************************
+template<typename T>
+void ScalarConvolutionRows(
+      size_t rowBegin,
+      size_t rowEnd,
+      int nComp,
+      int *sn,
+      int *so,
+      const T * __restrict__ S,
+      int *dn,
+      T * __restrict__ D,
+      int *kn,
+      const float * __restrict__ K)
+{
+  const size_t tile=1024;
+  const size_t rowLen=((size_t)dn[0])*nComp;
+  const size_t sRowStride=((size_t)sn[0])*nComp;
+  const size_t sPlaneStride=sRowStride*sn[1];
+
+  for (size_t r=rowBegin; r<rowEnd; ++r)
+    {
+    const size_t dk=r/dn[1];
+    const size_t dj=r-dk*dn[1];
+
+    T * __restrict__ d=D+r*rowLen;
+    const T * __restrict__ s
+      = S+(dk+so[2])*sPlaneStride+(dj+so[1])*sRowStride+((size_t)so[0])*nComp;
+
+    for (size_t x0=0; x0<rowLen; x0+=tile)
+      {
+      const size_t x1=(x0+tile<rowLen?x0+tile:rowLen);
+
+      for (size_t x=x0; x<x1; ++x)
+        {
+        d[x]=((T)0);
+        }
+
+      const float * __restrict__ kr=K;
+      for (int h=0; h<kn[2]; ++h)
+        {
+        for (int g=0; g<kn[1]; ++g)
+          {
+          const T * __restrict__ sr=s+h*sPlaneStride+g*sRowStride;
+          for (int f=0; f<kn[0]; ++f)
+            {
+            const T kf=((T)kr[f]);
+            const T * __restrict__ sf=sr+f*nComp;
+            for (size_t x=x0; x<x1; ++x)
+              {
+              d[x]+=kf*sf[x];
+              }
+            }
+          kr+=kn[0];
+          }
+        }
+      }
+    }
+}
+
 /*
 this vectorized version is slightly SLOWER than then unoptimized version
 
@@ -1075,139 +1282,119 @@ void ScalarConvolution3D(
 
 
 /**
-Functor for comapring array values by index
+Order a and b. The building block of the selection networks, written
+with min and max so that it compiles without branches.
 */
 template<typename T>
-class IndirectCompare
+inline
+void MedianExchange(T &a, T &b)
 {
-public:
-  //
-  IndirectCompare() : Data(0) {}
-  IndirectCompare(T *data) : Data(data) {}
-
-  // compare data at the given indices
-  bool operator()(size_t l, size_t r)
-  { return this->Data[l]<this->Data[r]; }
-
-private:
-  T *Data;
-};
+  T lo=std::min(a,b);
+  b=std::max(a,b);
+  a=lo;
+}
 
 /**
-This implementation is written so that adjacent threads access adjacent
-memory locations. This requires that vtk vectors/tensors etc be split.
+Median of 9 values by a selection network of 19 exchanges. The
+values are reordered.
 */
-//*****************************************************************************
 template<typename T>
-void ScalarMedianFilter2D(
-      //int worldRank,
-      size_t vni,
-      size_t wni,
-      size_t wnij,
-      size_t kni,
-      size_t knij,
-      size_t nGhost,
-      T * __restrict__ V,
-      T * __restrict__ W)
+inline
+T MedianSelect9(T *p)
 {
-  (void)nGhost;
-
-  size_t *ids=0;
-  posix_memalign((void**)&ids,16,knij*sizeof(size_t));
-
-  IndirectCompare<T> comp(V);
+  MedianExchange(p[1],p[2]); MedianExchange(p[4],p[5]); MedianExchange(p[7],p[8]);
+  MedianExchange(p[0],p[1]); MedianExchange(p[3],p[4]); MedianExchange(p[6],p[7]);
+  MedianExchange(p[1],p[2]); MedianExchange(p[4],p[5]); MedianExchange(p[7],p[8]);
+  MedianExchange(p[0],p[3]); MedianExchange(p[5],p[8]); MedianExchange(p[4],p[7]);
+  MedianExchange(p[3],p[6]); MedianExchange(p[1],p[4]); MedianExchange(p[2],p[5]);
+  MedianExchange(p[4],p[7]); MedianExchange(p[4],p[2]); MedianExchange(p[6],p[4]);
+  MedianExchange(p[4],p[2]);
+  return p[4];
+}
 
-  // get a tuple from the current flat index in the output
-  // index space
-  for (size_t wi=0; wi<wnij; ++wi)
+/**
+Median of n values, n odd. 3x3 windows use the selection network, the
+others a selection which is linear in n. The values are reordered.
+*/
+template<typename T>
+inline
+T MedianSelect(T *p, size_t n)
+{
+  if (n==9)
     {
-    size_t i,j;
-    j=wi/wni;
-    i=wi-j*wni;
-
-    // setup search space
-    size_t ki=0;
-    for (size_t g=0; g<kni; ++g)
-      {
-      size_t q=vni*(j+g)+i;
-      for (size_t f=0; f<kni; ++f)
-        {
-        size_t vi=q+f;
-        ids[ki]=vi;
-        ++ki;
-        }
-      }
-
-    // sort
-    //std::sort(ids,ids+knij,comp);
-    std::partial_sort(ids,ids+knij/2+1,ids+knij,comp);
-
-    // std::cerr << wi << " " << V[ids[0]] << " " << V[ids[knij/2]] << " " << V[ids[knij-1]] << std::endl;
-
-    // median
-    W[wi]=V[ids[knij/2]];
+    return MedianSelect9(p);
     }
-
-  free(ids);
+  T *mid=p+n/2;
+  std::nth_element(p,mid,p+n);
+  return *mid;
 }
 
+/**
+Median filter of the VTK ordered array V defined on the input extent
+into W defined on the output extent, for the points of slab, a sub
+extent of the output. The window has kn[0] x kn[1] x kn[2] points (odd,
+1 along collapsed dimensions) centered on each point and must lie in
+the input. work is scratch space for the values of a window. The
+components are filtered independently.
+*/
 //*****************************************************************************
 template<typename T>
-void ScalarMedianFilter3D(
-      size_t vni,
-      size_t vnij,
-      size_t wni,
-      size_t wnij,
-      size_t wnijk,
-      size_t kni,
-      size_t knij,
-      size_t knijk,
-      size_t nGhost,
+void MedianFilter(
+      int *input,
+      int *output,
+      int *slab,
+      int *kn,
+      int nComp,
       T * __restrict__ V,
-      T * __restrict__ W)
+      T * __restrict__ W,
+      T * __restrict__ work)
 {
-  (void)knij;
-  (void)nGhost;
+  // input and output array bounds
+  const size_t vni=input[1]-input[0]+1;
+  const size_t vnij=vni*(input[3]-input[2]+1);
+  const size_t wni=output[1]-output[0]+1;
+  const size_t wnij=wni*(output[3]-output[2]+1);
 
-  size_t *ids=0;
-  posix_memalign((void**)&ids,16,knijk*sizeof(size_t));
+  const int kh[3]={kn[0]/2,kn[1]/2,kn[2]/2};
+  const size_t knijk=kn[0]*kn[1]*kn[2];
 
-  IndirectCompare<T> comp(V);
-
-  // visit each output element
-  for (size_t wi=0; wi<wnijk; ++wi)
+  // loop over the slab in patch coordinates (the patches are in the same space)
+  for (int r=slab[4]; r<=slab[5]; ++r)
     {
-    size_t i,j,k;
-    k=wi/wnij;
-    j=(wi-k*wnij)/wni;
-    i=wi-k*wnij-j*wni;
-
-    // set up search space
-    size_t ki=0;
-    for (size_t h=0; h<kni; ++h)
+    for (int q=slab[2]; q<=slab[3]; ++q)
       {
-      size_t r=vnij*(k+h);
-      for (size_t g=0; g<kni; ++g)
+      // first row of the windows in the input, and row in the output
+      const size_t vq=(r-kh[2]-input[4])*vnij+(q-kh[1]-input[2])*vni;
+      const size_t wq=(r-output[4])*wnij+(q-output[2])*wni;
+
+      for (int p=slab[0]; p<=slab[1]; ++p)
         {
-        size_t q=r+vni*(j+g)+i;
-        for (size_t f=0; f<kni; ++f)
+        const size_t vi=nComp*(vq+(p-kh[0]-input[0]));
+        const size_t wi=nComp*(wq+(p-output[0]));
+
+        for (int c=0; c<nComp; ++c)
           {
-          size_t vi=q+f;
-          ids[ki]=vi;
-          ++ki;
+          // gather the window
+          size_t n=0;
+          for (int h=0; h<kn[2]; ++h)
+            {
+            for (int g=0; g<kn[1]; ++g)
+              {
+              const T *row=V+vi+nComp*(h*vnij+g*vni)+c;
+              for (int f=0; f<kn[0]; ++f)
+                {
+                work[n]=row[nComp*f];
+                ++n;
+                }
+              }
+            }
+
+          // median
+          W[wi+c]=MedianSelect(work,knijk);
           }
         }
       }
-
-    // sort
-    //std::sort(ids,ids+knijk,comp);
-    std::partial_sort(ids,ids+knijk/2+1,ids+knijk,comp);
-
-    // median
-    W[wi]=V[ids[knijk/2]];
     }
-
-  free(ids);
 }
 
 
@@ -2391,6 +2578,7 @@ void Divergence(
 // dX     -> grid spacing triple
 // S      -> scalar field
 // L      -> laplacian
+// bounds -> sub extent of output computed, output when 0
 //*****************************************************************************
 template <typename T>
 void Laplacian(
@@ -2399,7 +2587,8 @@ void Laplacian(
       int mode,
       double *dX,
       T *S,
-      T *L)
+      T *L,
+      int *bounds=0)
 {
   // input array bounds.
   const int ni=input[1]-input[0]+1;
@@ -2423,18 +2612,23 @@ void Laplacian(
       ((T)dX[1])*((T)dX[1]),
       ((T)dX[2])*((T)dX[2])};
 
-  // loop over output in patch coordinates (both patches are in the same space)
-  for (int r=output[4]; r<=output[5]; ++r)
+  if (bounds==0)
+    {
+    bounds=output;
+    }
+
+  // loop over bounds in patch coordinates (both patches are in the same space)
+  for (int r=bounds[4]; r<=bounds[5]; ++r)
     {
     const int  k=r-input[4];
     const int _k=r-output[4];
 
-    for (int q=output[2]; q<=output[3]; ++q)
+    for (int q=bounds[2]; q<=bounds[3]; ++q)
       {
       const int  j=q-input[2];
       const int _j=q-output[2];
 
-      for (int p=output[0]; p<=output[1]; ++p)
+      for (int p=bounds[0]; p<=bounds[1]; ++p)
         {
         const int _i=p-output[0];
         const size_t _pi=_idx.Index(_i,_j,_k);
@@ -2551,6 +2745,7 @@ void Laplacian(
 // dX     -> grid spacing triple
 // S      -> scalar field
 // G      -> gradient
+// bounds -> sub extent of output computed, output when 0
 //*****************************************************************************
 template <typename T>
 void Gradient(
@@ -2561,7 +2756,8 @@ void Gradient(
       T *S,
       T *Gx,
       T *Gy,
-      T *Gz)
+      T *Gz,
+      int *bounds=0)
 {
   // input array bounds.
   const int ni=input[1]-input[0]+1;
@@ -2585,18 +2781,23 @@ void Gradient(
       ((T)dX[1])*((T)2),
       ((T)dX[2])*((T)2)};
 
-  // loop over output in patch coordinates (both patches are in the same space)
-  for (int r=output[4]; r<=output[5]; ++r)
+  if (bounds==0)
+    {
+    bounds=output;
+    }
+
+  // loop over bounds in patch coordinates (both patches are in the same space)
+  for (int r=bounds[4]; r<=bounds[5]; ++r)
     {
     const int  k=r-input[4];
     const int _k=r-output[4];
 
-    for (int q=output[2]; q<=output[3]; ++q)
+    for (int q=bounds[2]; q<=bounds[3]; ++q)
       {
       const int  j=q-input[2];
       const int _j=q-output[2];
 
-      for (int p=output[0]; p<=output[1]; ++p)
+      for (int p=bounds[0]; p<=bounds[1]; ++p)
         {
         const int  i=p-input[0];
         const int _i=p-output[0];
@@ -158,6 +158,30 @@ void TerminationCondition::SetProblemDomain(
   verts->Delete();
 }
 
+//-----------------------------------------------------------------------------
+void TerminationCondition::Copy(const TerminationCondition &other)
+{
+  if (&other==this) return;
+
+  // periodic faces come in pairs, the first of the pair identifies
+  // a periodic direction.
+  int periodic[3]={
+      other.PeriodicBCFaces[0]!=0,
+      other.PeriodicBCFaces[2]!=0,
+      other.PeriodicBCFaces[4]!=0};
+  this->SetProblemDomain(other.ProblemDomain.GetData(),periodic);
+  this->WorkingDomain=other.WorkingDomain;
+
+  this->ClearTerminationSurfaces();
+  size_t nSurfaces=other.TerminationSurfaces.size();
+  for (size_t i=0; i<nSurfaces; ++i)
+    {
+    vtkPolyData *pd
+      = dynamic_cast<vtkPolyData*>(other.TerminationSurfaces[i]->GetDataSet());
+    this->PushTerminationSurface(pd,other.TerminationSurfaceNames[i].c_str());
+    }
+}
+
 //-----------------------------------------------------------------------------
 void TerminationCondition::PushTerminationSurface(
       vtkPolyData *pd,
@@ -116,6 +116,14 @@ public:
   */
   void ClearTerminationSurfaces();
 
+  /**
+  Copy the problem domain, periodic boundaries, working domain and
+  termination surfaces of another object. The locators are rebuilt
+  rather than shared so that the copy may be used concurrently with
+  the original, eg. by another thread. The color mapper is not copied.
+  */
+  void Copy(const TerminationCondition &other);
+
   /**
   Convert implementation defined surface ids into a unique color.
   */
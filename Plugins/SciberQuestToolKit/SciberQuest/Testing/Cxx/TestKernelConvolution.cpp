@@ -15,6 +15,7 @@ Copyright 2012 SciberQuest Inc.
 #include "vtkSQBOVReader.h"
 #include "vtkSQImageGhosts.h"
 #include "vtkSQKernelConvolution.h"
+#include "CPUConvolutionDriver.h"
 #include "vtkDataSetSurfaceFilter.h"
 #include "vtkProcessIdScalars.h"
 #include "vtkPointData.h"
@@ -106,26 +107,38 @@ int TestKernelConvolution(int argc, char *argv[])
 
   int aTestFailed=0;
 
-  for (int i=0; i<3; ++i)
+  // the direct convolution and the separable passes must both
+  // reproduce the baselines
+  int cpuOpt[2]={
+      CPUConvolutionDriver::OPT_NONE,
+      CPUConvolutionDriver::OPT_SEPARABLE};
+
+  for (int j=0; j<2; ++j)
     {
-    c1->SetKernelType(kernelType[i]);
-    s1->Update();
-
-    int testStatus = SerialRender(
-          controller,
-          s1->GetOutput(),
-          false,
-          tempDir,
-          baseline,
-          "SciberQuestToolKit-TestKernelConvolution",
-          700,300,
-          0,1,0,
-          0,0,0,
-          0,0,1,
-          2.25);
-    if (testStatus==vtkTesting::FAILED)
+    c1->SetCPUDriverOptimization(cpuOpt[j]);
+    c1->SetCPUDriverNumberOfThreads(j==0?1:0);
+
+    for (int i=0; i<3; ++i)
       {
-      aTestFailed=1;
+      c1->SetKernelType(kernelType[i]);
+      s1->Update();
+
+      int testStatus = SerialRender(
+            controller,
+            s1->GetOutput(),
+            false,
+            tempDir,
+            baseline,
+            "SciberQuestToolKit-TestKernelConvolution",
+            700,300,
+            0,1,0,
+            0,0,0,
+            0,0,1,
+            2.25);
+      if (testStatus==vtkTesting::FAILED)
+        {
+        aTestFailed=1;
+        }
       }
     }
 
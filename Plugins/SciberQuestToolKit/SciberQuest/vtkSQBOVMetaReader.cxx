@@ -115,6 +115,8 @@ vtkSQBOVMetaReader::vtkSQBOVMetaReader()
   this->DecompDims[1]=
   this->DecompDims[2]=1;
   this->BlockCacheSize=10;
+  this->BlockCacheMemory=0;
+  this->PrefetchBlocks=0;
   this->ClearCachedBlocks=1;
   this->BlockSize[0]=
   this->BlockSize[1]=
@@ -148,6 +150,8 @@ void vtkSQBOVMetaReader::Clear()
   this->DecompDims[1]=
   this->DecompDims[2]=1;
   this->BlockCacheSize=10;
+  this->BlockCacheMemory=0;
+  this->PrefetchBlocks=0;
   this->ClearCachedBlocks=1;
   this->BlockSize[0]=
   this->BlockSize[1]=
@@ -227,6 +231,20 @@ int vtkSQBOVMetaReader::Initialize(
     this->SetClearCachedBlocks(0);
     }
 
+  int block_cache_memory=0;
+  GetOptionalAttribute<int,1>(elem,"block_cache_memory",&block_cache_memory);
+  if (block_cache_memory>0)
+    {
+    this->SetBlockCacheMemory(block_cache_memory);
+    }
+
+  int prefetch_blocks=0;
+  GetOptionalAttribute<int,1>(elem,"prefetch_blocks",&prefetch_blocks);
+  if (prefetch_blocks>0)
+    {
+    this->SetPrefetchBlocks(1);
+    }
+
   this->SetUseCollectiveIO(vtkSQBOVMetaReader::HINT_DISABLED);
 
   vtkSQLog *log=vtkSQLog::GetGlobalInstance();
@@ -241,7 +259,9 @@ int vtkSQBOVMetaReader::Initialize(
       << "#   block_cache_size=" << this->BlockCacheSize << "\n"
       << "#   periodic_bc=" << Tuple<int>(this->PeriodicBC,3) << "\n"
       << "#   n_ghosts=" << this->NGhosts << "\n"
-      << "#   clear_cache=" << this->ClearCachedBlocks << "\n";
+      << "#   clear_cache=" << this->ClearCachedBlocks << "\n"
+      << "#   block_cache_memory=" << this->BlockCacheMemory << "\n"
+      << "#   prefetch_blocks=" << this->PrefetchBlocks << "\n";
     }
 
   return 0;
@@ -911,6 +931,8 @@ int vtkSQBOVMetaReader::RequestData(
   OOCReader->SetTimeIndex(stepId);
   OOCReader->SetDomainDecomp(ddecomp);
   OOCReader->SetBlockCacheSize(this->BlockCacheSize);
+  OOCReader->SetBlockCacheMemory(1024ul*this->BlockCacheMemory);
+  OOCReader->SetPrefetchBlocks(this->PrefetchBlocks);
   OOCReader->SetCloseClearsCachedBlocks(this->ClearCachedBlocks);
   OOCReader->InitializeBlockCache();
   OOCReader->SetLogLevel(this->LogLevel);
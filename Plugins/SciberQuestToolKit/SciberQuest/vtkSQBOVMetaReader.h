@@ -114,6 +114,19 @@ public:
   vtkSetMacro(ClearCachedBlocks,int);
   vtkGetMacro(ClearCachedBlocks,int);
 
+  // Description:
+  // Sets the memory budget (in MiB) of the block cache, which is
+  // shared by all readers of the process. 0 sets no budget, only
+  // BlockCacheSize limits the cache.
+  vtkSetClampMacro(BlockCacheMemory,int,0,VTK_INT_MAX);
+  vtkGetMacro(BlockCacheMemory,int);
+
+  // Description:
+  // If set the block next to the one being integrated, in the
+  // direction of integration, is read into the cache ahead of time.
+  vtkSetMacro(PrefetchBlocks,int);
+  vtkGetMacro(PrefetchBlocks,int);
+
 protected:
   virtual int RequestInformation(
         vtkInformation *req,
@@ -152,6 +165,8 @@ private:
   int DecompDims[3];       // subset split into an LxMxN cartesian decomposition
   int BlockCacheSize;      // number of blocks to cache during ooc oepration
   int ClearCachedBlocks;   // control persistence of cahce
+  int BlockCacheMemory;    // memory budget of the block cache in MiB
+  int PrefetchBlocks;      // read neighbor blocks ahead of time
   int BlockSize[3];        // size of block in the decomp
   double BlockCacheRamFactor; // % of per-core ram to use for the block cache
   long long ProcRam;       // ram available on this host for all ranks.
@@ -31,6 +31,7 @@
 
 #include "SQVTKTemplateMacroWarningSupression.h"
 #include "CartesianExtent.h"
+#include "ImageStencil.h"
 #include "postream.h"
 
 #include "vtkObjectFactory.h"
@@ -53,6 +54,96 @@
 
 //#define SQTK_DEBUG
 
+namespace {
+
+// Gradient and/or Laplacian of a slab of the output, see ImageStencil.
+template<typename T>
+class EdgeFilterSlab : public ImageStencilSlab
+{
+public:
+  EdgeFilterSlab(
+        const CartesianExtent &inputExt,
+        const CartesianExtent &outputExt,
+        int mode,
+        double *dX,
+        T *S,
+        T *Gx,
+        T *Gy,
+        T *Gz,
+        T *L)
+     :
+    InputExt(inputExt),
+    OutputExt(outputExt),
+    Mode(mode),
+    DX(dX),
+    S(S),
+    Gx(Gx),
+    Gy(Gy),
+    Gz(Gz),
+    L(L)
+  {}
+
+  virtual void Execute(const CartesianExtent &ext)
+  {
+    CartesianExtent slab(ext);
+    if (this->Gx)
+      {
+      Gradient<T>(
+          this->InputExt.GetData(),
+          this->OutputExt.GetData(),
+          this->Mode,
+          this->DX,
+          this->S,
+          this->Gx,
+          this->Gy,
+          this->Gz,
+          slab.GetData());
+      }
+    if (this->L)
+      {
+      Laplacian<T>(
+          this->InputExt.GetData(),
+          this->OutputExt.GetData(),
+          this->Mode,
+          this->DX,
+          this->S,
+          this->L,
+          slab.GetData());
+      }
+  }
+
+private:
+  CartesianExtent InputExt;
+  CartesianExtent OutputExt;
+  int Mode;
+  double *DX;
+  T *S;
+  T *Gx;
+  T *Gy;
+  T *Gz;
+  T *L;
+};
+
+//-----------------------------------------------------------------------------
+template<typename T>
+void ApplyEdgeFilter(
+      int nThreads,
+      const CartesianExtent &inputExt,
+      const CartesianExtent &outputExt,
+      int mode,
+      double *dX,
+      T *S,
+      T *Gx,
+      T *Gy,
+      T *Gz,
+      T *L)
+{
+  EdgeFilterSlab<T> slab(inputExt,outputExt,mode,dX,S,Gx,Gy,Gz,L);
+  ImageStencil::ForEachSlab(outputExt,nThreads,slab);
+}
+
+};
+
 vtkStandardNewMacro(vtkSQEdgeFilter);
 
 //-----------------------------------------------------------------------------
@@ -62,7 +153,8 @@ vtkSQEdgeFilter::vtkSQEdgeFilter()
   SplitComponents(0),
   ComputeGradient(0),
   ComputeLaplacian(0),
-  Mode(CartesianExtent::DIM_MODE_3D)
+  Mode(CartesianExtent::DIM_MODE_3D),
+  NumberOfThreads(1)
 {
   #ifdef SQTK_DEBUG
   pCerr() << "=====vtkSQEdgeFilter::vtkSQEdgeFilter" << std::endl;
@@ -187,55 +279,24 @@ int vtkSQEdgeFilter::RequestUpdateExtent(
 
   (void)req;
 
-  typedef vtkStreamingDemandDrivenPipeline vtkSDDPipeline;
-
   vtkInformation* outInfo=outInfos->GetInformationObject(0);
   vtkInformation *inInfo=inInfos[0]->GetInformationObject(0);
 
   // We will modify the extents we request from our input so
-  // that we will have a layers of ghost cells. We also pass
-  // the number of ghosts through the piece based key.
+  // that we will have a layers of ghost cells. The ghosts needed
+  // downstream are requested as well so that a chain of stencil
+  // filters is served by a single ghost exchange.
   int nGhosts = 1;
 
-  inInfo->Set(
-        vtkSDDPipeline::UPDATE_NUMBER_OF_GHOST_LEVELS(),
-        nGhosts);
-
-  CartesianExtent outputExt;
-  outInfo->Get(
-        vtkSDDPipeline::UPDATE_EXTENT(),
-        outputExt.GetData());
-
-  CartesianExtent wholeExt;
-  inInfo->Get(
-        vtkSDDPipeline::WHOLE_EXTENT(),
-        wholeExt.GetData());
-
-  outputExt = CartesianExtent::Grow(
-        outputExt,
-        wholeExt,
-        nGhosts,
-        this->Mode);
-
-  inInfo->Set(
-        vtkSDDPipeline::UPDATE_EXTENT(),
-        outputExt.GetData(),
-        6);
-
-  int piece
-    = outInfo->Get(vtkSDDPipeline::UPDATE_PIECE_NUMBER());
-
-  int numPieces
-    = outInfo->Get(vtkSDDPipeline::UPDATE_NUMBER_OF_PIECES());
-
-  inInfo->Set(vtkSDDPipeline::UPDATE_PIECE_NUMBER(), piece);
-  inInfo->Set(vtkSDDPipeline::UPDATE_NUMBER_OF_PIECES(), numPieces);
-  inInfo->Set(vtkSDDPipeline::EXACT_EXTENT(), 1);
+  ImageStencil::RequestUpdateExtent(inInfo,outInfo,nGhosts,this->Mode);
 
   #ifdef SQTK_DEBUG
+  CartesianExtent inputExt;
+  inInfo->Get(
+        vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(),
+        inputExt.GetData());
   pCerr()
-    << "WHOLE_EXTENT=" << wholeExt << std::endl
-    << "UPDATE_EXTENT=" << outputExt << std::endl
+    << "UPDATE_EXTENT=" << inputExt << std::endl
     << "nGhosts=" << nGhosts << std::endl;
   #endif
 
@@ -276,15 +337,17 @@ int vtkSQEdgeFilter::RequestData(
     return 1;
     }
 
-  // Get the input and output extents.
+  // Get the input and output extents. The output is computed on the
+  // input shrunk by our ghosts, ghosts requested downstream are passed
+  // on.
   CartesianExtent inputExt;
-  inInfo->Get(
-        vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(),
+  inData->GetInformation()->Get(
+        vtkDataObject::DATA_EXTENT(),
         inputExt.GetData());
-  CartesianExtent outputExt;
+  CartesianExtent updateExt;
   outInfo->Get(
         vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(),
-        outputExt.GetData());
+        updateExt.GetData());
   CartesianExtent domainExt;
   outInfo->Get(
         vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(),
@@ -292,18 +355,17 @@ int vtkSQEdgeFilter::RequestData(
 
   // Check that we have the ghost cells that we need (more is OK).
   int nGhost = 1;
-  CartesianExtent inputBox(inputExt);
-  CartesianExtent outputBox
-    = CartesianExtent::Grow(outputExt, nGhost, this->Mode);
+  CartesianExtent outputExt
+    = ImageStencil::GetOutputExtent(inputExt, domainExt, nGhost, this->Mode);
 
-  if (!inputBox.Contains(outputBox))
+  if (!outputExt.Contains(updateExt))
     {
     vtkErrorMacro(
       << "This filter requires ghost cells to function correctly. "
       << "The input must conatin the output plus " << nGhost
-      << " layers of ghosts. The input is " << inputBox
+      << " layers of ghosts. The input is " << inputExt
       << ", but it must be at least "
-      << outputBox << ".");
+      << CartesianExtent::Grow(updateExt, nGhost, this->Mode) << ".");
     return 1;
     }
 
@@ -334,8 +396,9 @@ int vtkSQEdgeFilter::RequestData(
     #ifdef SQTK_DEBUG
     pCerr()
       << "WHOLE_EXTENT=" << domainExt << std::endl
-      << "UPDATE_EXTENT(input)=" << inputExt << std::endl
-      << "UPDATE_EXTENT(output)=" << outputExt << std::endl
+      << "UPDATE_EXTENT(output)=" << updateExt << std::endl
+      << "EXTENT(input)=" << inputExt << std::endl
+      << "EXTENT(output)=" << outputExt << std::endl
       << "ORIGIN" << Tuple<double>(X0,3) << std::endl
       << "SPACING" << Tuple<double>(dX,3) << std::endl
       << std::endl;
@@ -377,11 +440,13 @@ int vtkSQEdgeFilter::RequestData(
       }
 
     // Gradient.
+    std::string name;
+    vtkDataArray *Gx=0;
+    vtkDataArray *Gy=0;
+    vtkDataArray *Gz=0;
     if (this->ComputeGradient)
       {
-      std::string name;
-
-      vtkDataArray *Gx=V->NewInstance();
+      Gx=V->NewInstance();
       Gx->SetNumberOfComponents(1);
       Gx->SetNumberOfTuples(outputTups);
       name="grad-";
@@ -389,7 +454,7 @@ int vtkSQEdgeFilter::RequestData(
       name+="x";
       Gx->SetName(name.c_str());
 
-      vtkDataArray *Gy=V->NewInstance();
+      Gy=V->NewInstance();
       Gy->SetNumberOfComponents(1);
       Gy->SetNumberOfTuples(outputTups);
       name="grad-";
@@ -397,29 +462,50 @@ int vtkSQEdgeFilter::RequestData(
       name+="y";
       Gy->SetName(name.c_str());
 
-      vtkDataArray *Gz=V->NewInstance();
+      Gz=V->NewInstance();
       Gz->SetNumberOfComponents(1);
       Gz->SetNumberOfTuples(outputTups);
       name="grad-";
       name+=V->GetName();
       name+="z";
       Gz->SetName(name.c_str());
+      }
 
+    // Laplacian.
+    vtkDataArray *L=0;
+    if (this->ComputeLaplacian)
+      {
+      L=V->NewInstance();
+      L->SetNumberOfComponents(1);
+      L->SetNumberOfTuples(outputTups);
+      name="lapl-";
+      name+=V->GetName();
+      L->SetName(name.c_str());
+      }
+
+    // Both are computed in a single pass over the slabs of the
+    // output, which are distributed over the threads.
+    if (Gx || L)
+      {
       switch(V->GetDataType())
         {
         vtkFloatTemplateMacro(
-          Gradient<VTK_TT>(
-              inputExt.GetData(),
-              outputExt.GetData(),
+          ::ApplyEdgeFilter<VTK_TT>(
+              this->NumberOfThreads,
+              inputExt,
+              outputExt,
               this->Mode,
               dX,
               (VTK_TT*)V->GetVoidPointer(0),
-              (VTK_TT*)Gx->GetVoidPointer(0),
-              (VTK_TT*)Gy->GetVoidPointer(0),
-              (VTK_TT*)Gz->GetVoidPointer(0));
-          );
+              (VTK_TT*)(Gx?Gx->GetVoidPointer(0):0),
+              (VTK_TT*)(Gy?Gy->GetVoidPointer(0):0),
+              (VTK_TT*)(Gz?Gz->GetVoidPointer(0):0),
+              (VTK_TT*)(L?L->GetVoidPointer(0):0)));
         }
+      }
 
+    if (this->ComputeGradient)
+      {
       if (this->SplitComponents)
         {
         outImData->GetPointData()->AddArray(Gx);
@@ -453,29 +539,10 @@ int vtkSQEdgeFilter::RequestData(
       Gz->Delete();
       }
 
-    // Laplacian.
     if (this->ComputeLaplacian)
       {
-      vtkDataArray *L=V->NewInstance();
       outImData->GetPointData()->AddArray(L);
       L->Delete();
-      L->SetNumberOfComponents(1);
-      L->SetNumberOfTuples(outputTups);
-      std::string name("lapl-");
-      name+=V->GetName();
-      L->SetName(name.c_str());
-      //
-      switch(V->GetDataType())
-        {
-        vtkFloatTemplateMacro(
-          Laplacian<VTK_TT>(
-              inputExt.GetData(),
-              outputExt.GetData(),
-              this->Mode,
-              dX,
-              (VTK_TT*)V->GetVoidPointer(0),
-              (VTK_TT*)L->GetVoidPointer(0)));
-        }
       }
     // outImData->Print(std::cerr);
     }
@@ -64,6 +64,14 @@ public:
   vtkSetMacro(ComputeLaplacian,int);
   vtkGetMacro(ComputeLaplacian,int);
 
+  // Description:
+  // Set the number of threads the output is computed with, the threads
+  // working on slabs of the output. 0 uses the number of threads provided
+  // by vtkSMPTools, larger values use at most that many of them for this
+  // filter only. The default is 1, the calling thread.
+  vtkSetClampMacro(NumberOfThreads,int,0,VTK_INT_MAX);
+  vtkGetMacro(NumberOfThreads,int);
+
 protected:
   int RequestDataObject(vtkInformation*,vtkInformationVector** inInfoVec,vtkInformationVector* outInfoVec);
   int RequestData(vtkInformation *req, vtkInformationVector **input, vtkInformationVector *output);
@@ -85,6 +93,7 @@ private:
 
   //
   int Mode;
+  int NumberOfThreads;
 
 private:
   vtkSQEdgeFilter(const vtkSQEdgeFilter &) VTK_DELETE_FUNCTION;
@@ -68,8 +68,11 @@
 #include "vtkRungeKutta45.h"
 #include "vtkMultiProcessController.h"
 #include "vtkMath.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSimpleCriticalSection.h"
 
 #include "vtkPVInformationKeys.h"
+#include "vtkPVSMPTools.h"
 
 #include "vtkSQLog.h"
 #include "vtkSQOOCReader.h"
@@ -118,6 +121,229 @@
   #define vtkSQFieldTracerDEBUG 0
 #endif
 
+//*****************************************************************************
+// Per-thread integration state. The integrator, interpolator and termination
+// condition (its locators and working domain) are not thread safe so each
+// thread has its own. The block being integrated is referenced so that it
+// remains valid when another thread evicts it from the reader's cache.
+class vtkSQFieldTracerWorker
+{
+public:
+  vtkSQFieldTracerWorker()
+        :
+    Integrator(0),
+    Interp(0),
+    Block(0),
+    Tcon(0)
+    {}
+
+  // copies start empty, they are initialized on first use by the
+  // thread that owns them.
+  vtkSQFieldTracerWorker(const vtkSQFieldTracerWorker &)
+        :
+    Integrator(0),
+    Interp(0),
+    Block(0),
+    Tcon(0)
+    {}
+
+  ~vtkSQFieldTracerWorker(){ this->Clear(); }
+
+  // Description:
+  // Read the neighborhood of p and point the integrator at it. The
+  // reader is given a hint to prefetch the next neighborhood in the
+  // direction of integration. The reader and its cache are shared by
+  // all threads, access is serialized by the given lock. Returns 0 if
+  // the read fails.
+  int LoadBlock(
+        vtkSQOOCReader *oocr,
+        vtkSimpleCriticalSection &readerLock,
+        double p[3],
+        int stepSign,
+        const char *fieldName);
+
+  // Description:
+  // Release all resources.
+  void Clear();
+
+public:
+  vtkInitialValueProblemSolver *Integrator;
+  vtkInterpolatedVelocityField *Interp;
+  vtkDataSet *Block;
+  TerminationCondition *Tcon;
+
+private:
+  void operator=(const vtkSQFieldTracerWorker &); // not implemented
+};
+
+//-----------------------------------------------------------------------------
+int vtkSQFieldTracerWorker::LoadBlock(
+      vtkSQOOCReader *oocr,
+      vtkSimpleCriticalSection &readerLock,
+      double p[3],
+      int stepSign,
+      const char *fieldName)
+{
+  readerLock.Lock();
+  vtkDataSet *block=oocr->ReadNeighborhood(p,this->Tcon->GetWorkingDomain());
+  if (block)
+    {
+    block->Register(0);
+    }
+  if (this->Block)
+    {
+    this->Block->UnRegister(0);
+    }
+  this->Block=block;
+  readerLock.Unlock();
+
+  if (!block)
+    {
+    return 0;
+    }
+
+  // Initialize the vector field interpolator.
+  if (this->Interp)
+    {
+    this->Interp->Delete();
+    }
+  this->Interp=vtkInterpolatedVelocityField::New();
+  this->Interp->AddDataSet(block);
+  this->Interp->SelectVectors(vtkDataObject::FIELD_ASSOCIATION_POINTS,fieldName);
+  this->Integrator->SetFunctionSet(this->Interp);
+
+  double v[3];
+  if (this->Interp->FunctionValues(p,v))
+    {
+    v[0]*=stepSign;
+    v[1]*=stepSign;
+    v[2]*=stepSign;
+    readerLock.Lock();
+    oocr->PrefetchNeighborhood(p,v);
+    readerLock.Unlock();
+    }
+
+  return 1;
+}
+
+//-----------------------------------------------------------------------------
+void vtkSQFieldTracerWorker::Clear()
+{
+  if (this->Integrator)
+    {
+    this->Integrator->Delete();
+    this->Integrator=0;
+    }
+  if (this->Interp)
+    {
+    this->Interp->Delete();
+    this->Interp=0;
+    }
+  if (this->Block)
+    {
+    this->Block->UnRegister(0);
+    this->Block=0;
+    }
+  delete this->Tcon;
+  this->Tcon=0;
+}
+
+//*****************************************************************************
+// The integration state of a rank, the workers of its threads and the lock
+// serializing access to the out-of-core reader.
+class vtkSQFieldTracerWorkers
+{
+public:
+  vtkSQFieldTracerWorkers(
+        vtkInitialValueProblemSolver *integrator,
+        TerminationCondition *tcon)
+        :
+    Integrator(integrator),
+    Tcon(tcon)
+    {}
+
+  ~vtkSQFieldTracerWorkers(){ this->Clear(); }
+
+  // Description:
+  // Get the calling thread's worker, its integrator and termination
+  // condition are copied from the filter's on first use.
+  vtkSQFieldTracerWorker &Local();
+
+  // Description:
+  // Release the resources of all workers.
+  void Clear();
+
+public:
+  vtkSimpleCriticalSection ReaderLock;
+
+private:
+  vtkInitialValueProblemSolver *Integrator;
+  TerminationCondition *Tcon;
+  vtkSMPThreadLocal<vtkSQFieldTracerWorker> Workers;
+};
+
+//-----------------------------------------------------------------------------
+vtkSQFieldTracerWorker &vtkSQFieldTracerWorkers::Local()
+{
+  vtkSQFieldTracerWorker &worker=this->Workers.Local();
+  if (!worker.Integrator)
+    {
+    worker.Integrator=this->Integrator->NewInstance();
+    worker.Tcon=new TerminationCondition;
+    worker.Tcon->Copy(*this->Tcon);
+    }
+  return worker;
+}
+
+//-----------------------------------------------------------------------------
+void vtkSQFieldTracerWorkers::Clear()
+{
+  vtkSMPThreadLocal<vtkSQFieldTracerWorker>::iterator it=this->Workers.begin();
+  vtkSMPThreadLocal<vtkSQFieldTracerWorker>::iterator end=this->Workers.end();
+  for (; it!=end; ++it)
+    {
+    (*it).Clear();
+    }
+}
+
+//*****************************************************************************
+// vtkPVSMPTools functor integrating a range of the field lines of a block.
+// Field line integration times vary widely so the range is split in small
+// grains that are balanced over the threads.
+class vtkSQFieldTracerIntegrateFunctor
+{
+public:
+  vtkSQFieldTracerIntegrateFunctor(
+        vtkSQFieldTracer *tracer,
+        FieldTraceData *traceData,
+        const char *fieldName,
+        vtkSQOOCReader *oocr,
+        vtkSQFieldTracerWorkers *workers)
+        :
+    Tracer(tracer),
+    TraceData(traceData),
+    FieldName(fieldName),
+    OOCR(oocr),
+    Workers(workers)
+    {}
+
+  void operator()(vtkIdType first, vtkIdType last)
+    {
+    for (vtkIdType i=first; i<last; ++i)
+      {
+      FieldLine *line=this->TraceData->GetFieldLine(i);
+      this->Tracer->IntegrateOne(this->OOCR,this->Workers,this->FieldName,line);
+      }
+    }
+
+private:
+  vtkSQFieldTracer *Tracer;
+  FieldTraceData *TraceData;
+  const char *FieldName;
+  vtkSQOOCReader *OOCR;
+  vtkSQFieldTracerWorkers *Workers;
+};
+
 const double vtkSQFieldTracer::EPSILON = 1.0E-12;
 
 //-----------------------------------------------------------------------------
@@ -131,6 +357,7 @@ vtkSQFieldTracer::vtkSQFieldTracer()
   UseDynamicScheduler(0),
   WorkerBlockSize(16),
   MasterBlockSize(256),
+  NumberOfThreads(1),
   ForwardOnly(0),
   StepUnit(ARC_LENGTH),
   MinStep(1.0E-8),
@@ -291,6 +518,13 @@ int vtkSQFieldTracer::Initialize(vtkPVXMLElement *root)
     this->SetWorkerBlockSize(workerBlockSize);
     }
 
+  int numberOfThreads=-1;
+  GetOptionalAttribute<int,1>(elem,"number_of_threads",&numberOfThreads);
+  if (numberOfThreads>=0)
+    {
+    this->SetNumberOfThreads(numberOfThreads);
+    }
+
   int squeezeColorMap=-1;
   GetOptionalAttribute<int,1>(elem,"squeeze_color_map",&squeezeColorMap);
   if (squeezeColorMap>=0)
@@ -318,6 +552,7 @@ int vtkSQFieldTracer::Initialize(vtkPVXMLElement *root)
       << "#   dynamicScheduler=" << this->GetUseDynamicScheduler() << "\n"
       << "#   masterBlockSize=" << this->GetMasterBlockSize() << "\n"
       << "#   workerBlockSize=" << this->GetWorkerBlockSize() << "\n"
+      << "#   numberOfThreads=" << this->GetNumberOfThreads() << "\n"
       << "#   squeezeColorMap=" << this->GetSqueezeColorMap() << "\n";
     }
 
@@ -696,10 +931,6 @@ int vtkSQFieldTracer::RequestData(
   oocr->ActivateArray(fieldName);
   oocr->SetCommunicator(this->UseCommWorld?MPI_COMM_WORLD:MPI_COMM_SELF);
   oocr->Open();
-  // We provide the integrator a pointer to a cache. The integrator
-  // uses this as it sees fit to reduce the number of reads. If its
-  // not null after the integrator returns we have to delete.
-  vtkDataSet *oocrCache=0;
 
   // the bounds (problem domain) of the data should be provided by the
   // meta reader.
@@ -880,6 +1111,11 @@ int vtkSQFieldTracer::RequestData(
     }
   tcon->InitializeColorMapper();
 
+  // Each thread integrates with its own copy of the integrator and
+  // termination condition, and keeps a reference to the last
+  // neighborhood read to reduce the number of reads.
+  vtkSQFieldTracerWorkers workers(this->Integrator,tcon);
+
   /// Work loops
   if (this->UseDynamicScheduler)
     {
@@ -897,7 +1133,7 @@ int vtkSQFieldTracer::RequestData(
           nSourceCells,
           fieldName,
           oocr.GetPointer(),
-          oocrCache,
+          &workers,
           traceData);
     }
   else
@@ -911,7 +1147,7 @@ int vtkSQFieldTracer::RequestData(
           source->GetNumberOfCells(),
           fieldName,
           oocr.GetPointer(),
-          oocrCache,
+          &workers,
           traceData);
     }
 
@@ -928,7 +1164,9 @@ int vtkSQFieldTracer::RequestData(
   // are used. The reduction makes use of global communication.
   traceData->PrintLegend(this->SqueezeColorMap);
 
-  // close the open file and release reader.
+  // release the blocks held by the workers, close the open file
+  // and release reader.
+  workers.Clear();
   oocr->Close();
   oocr->Delete();
 
@@ -949,7 +1187,7 @@ int vtkSQFieldTracer::IntegrateStatic(
       vtkIdType nCells,
       const char *fieldName,
       vtkSQOOCReader *oocr,
-      vtkDataSet *&oocrCache,
+      vtkSQFieldTracerWorkers *workers,
       FieldTraceData *traceData)
 {
   #if defined vtkSQFieldTracerTIME
@@ -967,7 +1205,7 @@ int vtkSQFieldTracer::IntegrateStatic(
             traceData,
             fieldName,
             oocr,
-            oocrCache);
+            workers);
 
   #if defined vtkSQFieldTracerTIME
   log->EndEvent("vtkSQFieldTracer::IntegrateStatic");
@@ -983,7 +1221,7 @@ int vtkSQFieldTracer::IntegrateDynamic(
       vtkIdType nCells,
       const char *fieldName,
       vtkSQOOCReader *oocr,
-      vtkDataSet *&oocrCache,
+      vtkSQFieldTracerWorkers *workers,
       FieldTraceData *traceData)
 {
   #if defined vtkSQFieldTracerTIME
@@ -997,7 +1235,7 @@ int vtkSQFieldTracer::IntegrateDynamic(
   (void)nCells;
   (void)fieldName;
   (void)oocr;
-  (void)oocrCache;
+  (void)workers;
   (void)traceData;
   #else
   const int masterProcId=(nProcs>1?1:0); // NOTE: proc 0 is busy with PV overhead.
@@ -1081,7 +1319,7 @@ int vtkSQFieldTracer::IntegrateDynamic(
                   traceData,
                   fieldName,
                   oocr,
-                  oocrCache);
+                  workers);
 
           double prog=(double)sourceIds.last()/(double)nCells;
           this->UpdateProgress(prog);
@@ -1133,7 +1371,7 @@ int vtkSQFieldTracer::IntegrateDynamic(
                 traceData,
                 fieldName,
                 oocr,
-                oocrCache);
+                workers);
 
       double prog=(double)sourceIds.last()/(double)nCells;
       this->UpdateProgress(prog);
@@ -1154,7 +1392,7 @@ int vtkSQFieldTracer::IntegrateBlock(
       FieldTraceData *traceData,
       const char *fieldName,
       vtkSQOOCReader *oocr,
-      vtkDataSet *&oocrCache)
+      vtkSQFieldTracerWorkers *workers)
 
 {
   // build the output.
@@ -1167,25 +1405,44 @@ int vtkSQFieldTracer::IntegrateBlock(
   log->EndEvent("vtkSQFieldTracer::InsertCells");
   #endif
 
-  TerminationCondition *tcon=traceData->GetTerminationCondition();
-
-  for (vtkIdType i=0; i<nLines; ++i) //, prog+=progInc)
+  if (this->NumberOfThreads!=1)
     {
-    // progress report for static load balance. the report
-    // for dunamic load balance is done once for each block.
-    if (!this->UseDynamicScheduler && !(i%10))
+    // trace the stream lines in parallel. progress is reported
+    // once the block is done.
+    vtkSQFieldTracerIntegrateFunctor integrate(
+          this,
+          traceData,
+          fieldName,
+          oocr,
+          workers);
+
+    vtkPVSMPTools::For(this->NumberOfThreads,0,nLines,1,integrate);
+
+    if (!this->UseDynamicScheduler)
       {
-      double prog=(double)i/(double)nLines;
-      this->UpdateProgress(prog);
+      this->UpdateProgress(1.0);
       }
+    }
+  else
+    {
+    for (vtkIdType i=0; i<nLines; ++i) //, prog+=progInc)
+      {
+      // progress report for static load balance. the report
+      // for dunamic load balance is done once for each block.
+      if (!this->UseDynamicScheduler && !(i%10))
+        {
+        double prog=(double)i/(double)nLines;
+        this->UpdateProgress(prog);
+        }
 
-    // trace a stream line
-    FieldLine *line=traceData->GetFieldLine(i);
-    this->IntegrateOne(oocr,oocrCache,fieldName,line,tcon);
+      // trace a stream line
+      FieldLine *line=traceData->GetFieldLine(i);
+      this->IntegrateOne(oocr,workers,fieldName,line);
 
-    #if vtkSQFieldTracerDEBUG>=0
-    cstd::err << ".";
-    #endif
+      #if vtkSQFieldTracerDEBUG>=0
+      cstd::err << ".";
+      #endif
+      }
     }
 
   // sync results to output. free resources in preparation
@@ -1206,16 +1463,19 @@ int vtkSQFieldTracer::IntegrateBlock(
 //-----------------------------------------------------------------------------
 void vtkSQFieldTracer::IntegrateOne(
       vtkSQOOCReader *oocR,
-      vtkDataSet *&oocRCache,
+      vtkSQFieldTracerWorkers *workers,
       const char *fieldName,
-      FieldLine *line,
-      TerminationCondition *tcon)
+      FieldLine *line)
 {
   #if defined vtkSQFieldTracerTIME
   vtkSQLog *log=vtkSQLog::GetGlobalInstance();
   log->StartEvent("vtkSQFieldTracer::Integrate");
   #endif
 
+  // the calling thread's integration state.
+  vtkSQFieldTracerWorker &worker=workers->Local();
+  TerminationCondition *tcon=worker.Tcon;
+
   // Sanity check -- seed point is in bounds. If not skip it.
   double seed[3];
   line->GetSeedPoint(seed);
@@ -1259,8 +1519,6 @@ void vtkSQFieldTracer::IntegrateOne(
     double p2[3]={0.0};                     // integrated point, non-periodic coordinate space.
     double s0[3]={0.0};                     // segment start point
     int bcSurf=0;                           // set when a periodic boundary condition has been applied.
-    static                                  // interpolator
-    vtkInterpolatedVelocityField *interp=0;
     #if vtkSQFieldTracerDEBUG>1
     double minStepTaken=VTK_DOUBLE_MAX;
     double maxStepTaken=VTK_DOUBLE_MIN;
@@ -1287,18 +1545,11 @@ void vtkSQFieldTracer::IntegrateOne(
         log->EndEvent("vtkSQFieldTracer::Integrate");
         log->StartEvent("vtkSQFieldTracer::LoadBlock");
         #endif
-        oocRCache=oocR->ReadNeighborhood(p0,tcon->GetWorkingDomain());
-        if (!oocRCache)
+        if (!worker.LoadBlock(oocR,workers->ReaderLock,p0,stepSign,fieldName))
           {
           vtkErrorMacro("Read neighborhood failed.");
           return;
           }
-        // Initialize the vector field interpolator.
-        interp=vtkInterpolatedVelocityField::New();
-        interp->AddDataSet(oocRCache);
-        interp->SelectVectors(vtkDataObject::FIELD_ASSOCIATION_POINTS,fieldName);
-        this->Integrator->SetFunctionSet(interp);
-        interp->Delete();
         #if defined vtkSQFieldTracerTIME
         log->EndEvent("vtkSQFieldTracer::LoadBlock");
         log->StartEvent("vtkSQFieldTracer::Integrate");
@@ -1306,6 +1557,7 @@ void vtkSQFieldTracer::IntegrateOne(
         }
 
       // interpolate vector field at seed point.
+      vtkInterpolatedVelocityField *interp=worker.Interp;
       interp->FunctionValues(p0,V0);
       double speed=vtkMath::Norm(V0);
       // check for field null
@@ -1361,7 +1613,7 @@ void vtkSQFieldTracer::IntegrateOne(
       interp->SetNormalizeVector(true);
       double error=0.0;
       double stepTaken=0.0;
-      int iErr=this->Integrator->ComputeNextStep(
+      int iErr=worker.Integrator->ComputeNextStep(
           p0,p1,0,
           stepSize,
           stepTaken,
@@ -52,6 +52,7 @@ class IdBlock;
 class FieldLine;
 class FieldTraceData;
 class TerminationCondition;
+class vtkSQFieldTracerWorkers;
 
 class VTKSCIBERQUEST_EXPORT vtkSQFieldTracer : public vtkDataSetAlgorithm
 {
@@ -203,6 +204,17 @@ public:
   vtkSetMacro(UseDynamicScheduler,int);
   vtkGetMacro(UseDynamicScheduler,int);
 
+  // Description:
+  // Set the number of threads used to integrate the field lines of each
+  // block of seeds. The threads share the out-of-core reader and its block
+  // cache, so that a single rank per node may be used with the dynamic
+  // scheduler feeding work to all of the node's cores. 0 uses the number of
+  // threads provided by vtkSMPTools, larger values use at most that many of
+  // them for this filter only. The default is 1, the field lines are
+  // integrated on the calling thread.
+  vtkSetClampMacro(NumberOfThreads,int,0,VTK_INT_MAX);
+  vtkGetMacro(NumberOfThreads,int);
+
   // Description:
   // Set the log level.
   // 0 -- no logging
@@ -233,7 +245,7 @@ private:
       vtkIdType nCells,
       const char *fieldName,
       vtkSQOOCReader *oocr,
-      vtkDataSet *&oocrCache,
+      vtkSQFieldTracerWorkers *workers,
       FieldTraceData *topoMap);
 
   // Description:
@@ -246,30 +258,33 @@ private:
       vtkIdType nCells,
       const char *fieldName,
       vtkSQOOCReader *oocr,
-      vtkDataSet *&oocrCache,
+      vtkSQFieldTracerWorkers *workers,
       FieldTraceData *topoMap);
 
   // Description:
   // Integrate field lines seeded from a block of consecutive cell ids.
+  // When NumberOfThreads is not 1 the field lines are distributed
+  // over the threads.
   int IntegrateBlock(
         IdBlock *sourceIds,
         FieldTraceData *topoMap,
         const char *fieldName,
         vtkSQOOCReader *oocr,
-        vtkDataSet *&oocrCache);
+        vtkSQFieldTracerWorkers *workers);
 
 
   // Description:
   // Trace one field line from the given seed point, using the given out-of-core
   // reader. As segments are generated they are tested using the stermination
-  // condition and terminated imediately. The last neighborhood read is stored
-  // in the nhood parameter. It is up to the caller to delete this.
+  // condition and terminated imediately. The integrator, termination condition
+  // and last neighborhood read are those of the calling thread's worker. This
+  // may be called concurrently from multiple threads.
   void IntegrateOne(
         vtkSQOOCReader *oocR,
-        vtkDataSet *&oocRCache,
+        vtkSQFieldTracerWorkers *workers,
         const char *fieldName,
-        FieldLine *line,
-        TerminationCondition *tcon);
+        FieldLine *line);
+  friend class vtkSQFieldTracerIntegrateFunctor;
 
   // Description:
   // Determine the start id of the cells in data relative
@@ -302,6 +317,7 @@ private:
   int UseDynamicScheduler;
   int WorkerBlockSize;
   int MasterBlockSize;
+  int NumberOfThreads;
 
   // Parameters controlling integration
   int ForwardOnly;
@@ -34,7 +34,7 @@
 #include "Numerics.hxx"
 #include "Tuple.hxx"
 #include "CartesianExtent.h"
-#include "CartesianExtent.h"
+#include "ImageStencil.h"
 #include "CPUConvolutionDriver.h"
 #include "CUDAConvolutionDriver.h"
 #include "XMLUtils.h"
@@ -319,6 +319,13 @@ int vtkSQKernelConvolution::Initialize(vtkPVXMLElement *root)
     this->SetCPUDriverOptimization(CPUDriverOptimization);
     }
 
+  int CPUDriverNumberOfThreads=-1;
+  GetOptionalAttribute<int,1>(elem,"cpu_driver_number_of_threads",&CPUDriverNumberOfThreads);
+  if (CPUDriverNumberOfThreads>=0)
+    {
+    this->SetCPUDriverNumberOfThreads(CPUDriverNumberOfThreads);
+    }
+
   int numberOfMPIRanksToUseCUDA=0;
   GetOptionalAttribute<int,1>(elem,"number_of_mpi_ranks_to_use_cuda",&numberOfMPIRanksToUseCUDA);
 
@@ -331,6 +338,7 @@ int vtkSQKernelConvolution::Initialize(vtkPVXMLElement *root)
       << "#   stencilWidth=" << stencilWidth << "\n"
       << "#   kernelType=" << kernelType << "\n"
       << "#   CPUDriverOptimization=" << CPUDriverOptimization << "\n"
+      << "#   CPUDriverNumberOfThreads=" << CPUDriverNumberOfThreads << "\n"
       << "#   numberOfMPIRanksToUseCUDA=" << numberOfMPIRanksToUseCUDA << "\n"
       << "#   input_arrays=";
     std::set<std::string>::iterator it=this->InputArrays.begin();
@@ -471,6 +479,24 @@ int vtkSQKernelConvolution::GetCPUDriverOptimization()
   return this->CPUDriver->GetOptimization();
 }
 
+//-----------------------------------------------------------------------------
+void vtkSQKernelConvolution::SetCPUDriverNumberOfThreads(int n)
+{
+  #ifdef SQTK_DEBUG
+  pCerr()
+    << "=====vtkSQKernelConvolution::SetCPUDriverNumberOfThreads"
+    << " " << n << std::endl;
+  #endif
+  this->CPUDriver->SetNumberOfThreads(n);
+  this->Modified();
+}
+
+//-----------------------------------------------------------------------------
+int vtkSQKernelConvolution::GetCPUDriverNumberOfThreads()
+{
+  return this->CPUDriver->GetNumberOfThreads();
+}
+
 //-----------------------------------------------------------------------------
 void vtkSQKernelConvolution::SetAllMPIRanksToUseCUDA(int allUse)
 {
@@ -959,46 +985,24 @@ int vtkSQKernelConvolution::RequestUpdateExtent(
 
   (void)req;
 
-  typedef vtkStreamingDemandDrivenPipeline vtkSDDPipeline;
-
   vtkInformation* outInfo=outInfos->GetInformationObject(0);
   vtkInformation *inInfo=inInfos[0]->GetInformationObject(0);
 
   // We will modify the extents we request from our input so
-  // that we will have a layers of ghost cells. We also pass
-  // the number of ghosts through the piece based key.
+  // that we will have a layers of ghost cells. The ghosts needed
+  // downstream are requested as well so that a chain of stencil
+  // filters is served by a single ghost exchange.
   int nGhosts = this->KernelWidth/2;
 
-  inInfo->Set(
-        vtkSDDPipeline::UPDATE_NUMBER_OF_GHOST_LEVELS(),
-        nGhosts);
-
-  CartesianExtent outputExt;
-  outInfo->Get(
-        vtkSDDPipeline::UPDATE_EXTENT(),
-        outputExt.GetData());
-
-  CartesianExtent wholeExt;
-  inInfo->Get(
-        vtkSDDPipeline::WHOLE_EXTENT(),
-        wholeExt.GetData());
-
-  outputExt = CartesianExtent::Grow(
-        outputExt,
-        wholeExt,
-        nGhosts,
-        this->Mode);
-
-  inInfo->Set(
-        vtkSDDPipeline::UPDATE_EXTENT(),
-        outputExt.GetData(),
-        6);
-  inInfo->Set(vtkSDDPipeline::EXACT_EXTENT(), 1);
+  ImageStencil::RequestUpdateExtent(inInfo,outInfo,nGhosts,this->Mode);
 
   #ifdef SQTK_DEBUG
+  CartesianExtent inputExt;
+  inInfo->Get(
+        vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(),
+        inputExt.GetData());
   oss
-    << "WHOLE_EXTENT=" << wholeExt << std::endl
-    << "UPDATE_EXTENT=" << outputExt << std::endl
+    << "UPDATE_EXTENT=" << inputExt << std::endl
     << "nGhosts=" << nGhosts << std::endl;
   pCerr() << oss.str() << std::endl;
   #endif
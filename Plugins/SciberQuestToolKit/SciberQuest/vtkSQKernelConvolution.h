@@ -150,10 +150,18 @@ public:
 
   // Description:
   // Select a set of optimization for code running on the
-  // CPU.
+  // CPU. See CPUConvolutionDriver, 3 applies separable kernels
+  // as 1D passes using CPUDriverNumberOfThreads threads.
   void SetCPUDriverOptimization(int opt);
   int GetCPUDriverOptimization();
 
+  // Description:
+  // Set the number of threads used by the CPU when the
+  // optimization is 3. 0 uses all the threads available, larger values at
+  // most that many.
+  void SetCPUDriverNumberOfThreads(int n);
+  int GetCPUDriverNumberOfThreads();
+
   // Description:
   // Set the log level.
   // 0 -- no logging
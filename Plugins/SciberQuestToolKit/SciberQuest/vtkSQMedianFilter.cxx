@@ -37,7 +37,7 @@
 #include "MemOrder.hxx"
 #include "Tuple.hxx"
 #include "CartesianExtent.h"
-#include "CartesianExtent.h"
+#include "ImageStencil.h"
 #include "CPUConvolutionDriver.h"
 #include "CUDAConvolutionDriver.h"
 #include "vtkSQLog.h"
@@ -66,6 +66,74 @@
 #include <utility>
 #include <algorithm>
 
+namespace {
+
+// Median filter of a slab of the output, see ImageStencil.
+template<typename T>
+class MedianFilterSlab : public ImageStencilSlab
+{
+public:
+  MedianFilterSlab(
+        const CartesianExtent &inputExt,
+        const CartesianExtent &outputExt,
+        int *kn,
+        int nComp,
+        T *V,
+        T *W)
+     :
+    InputExt(inputExt),
+    OutputExt(outputExt),
+    NComp(nComp),
+    V(V),
+    W(W)
+  {
+    this->KN[0]=kn[0];
+    this->KN[1]=kn[1];
+    this->KN[2]=kn[2];
+  }
+
+  virtual void Execute(const CartesianExtent &ext)
+  {
+    CartesianExtent slab(ext);
+    T *work=(T*)malloc(this->KN[0]*this->KN[1]*this->KN[2]*sizeof(T));
+    ::MedianFilter<T>(
+          this->InputExt.GetData(),
+          this->OutputExt.GetData(),
+          slab.GetData(),
+          this->KN,
+          this->NComp,
+          this->V,
+          this->W,
+          work);
+    free(work);
+  }
+
+private:
+  CartesianExtent InputExt;
+  CartesianExtent OutputExt;
+  int KN[3];
+  int NComp;
+  T *V;
+  T *W;
+};
+
+//-----------------------------------------------------------------------------
+template<typename T>
+void ApplyMedianFilter(
+      int nThreads,
+      const CartesianExtent &inputExt,
+      const CartesianExtent &outputExt,
+      int *kn,
+      int nComp,
+      T *V,
+      T *W)
+{
+  MedianFilterSlab<T> slab(inputExt,outputExt,kn,nComp,V,W);
+  ImageStencil::ForEachSlab(outputExt,nThreads,slab);
+}
+
+};
+
 vtkStandardNewMacro(vtkSQMedianFilter);
 
 //-----------------------------------------------------------------------------
@@ -80,6 +148,7 @@ vtkSQMedianFilter::vtkSQMedianFilter()
   //Kernel(0),
   KernelModified(1),
   Mode(CartesianExtent::DIM_MODE_3D),
+  NumberOfThreads(1),
   //NumberOfCUDADevices(0),
   //NumberOfActiveCUDADevices(0),
   //CUDADeviceId(-1),
@@ -264,6 +333,13 @@ int vtkSQMedianFilter::Initialize(vtkPVXMLElement *root)
     this->SetKernelType(kernelType);
     }
 
+  int numberOfThreads=-1;
+  GetOptionalAttribute<int,1>(elem,"number_of_threads",&numberOfThreads);
+  if (numberOfThreads>=0)
+    {
+    this->SetNumberOfThreads(numberOfThreads);
+    }
+
   /*
   int CPUDriverOptimization=-1;
   GetOptionalAttribute<int,1>(elem,"CPUDriverOptimization",&CPUDriverOptimization);
@@ -284,7 +360,8 @@ int vtkSQMedianFilter::Initialize(vtkPVXMLElement *root)
     log->GetHeader()
       << "# ::vtkSQMedianFilter" << "\n"
       << "#   stencilWidth=" << stencilWidth << "\n"
-      << "#   kernelType=" << kernelType << "\n";
+      << "#   kernelType=" << kernelType << "\n"
+      << "#   numberOfThreads=" << this->NumberOfThreads << "\n";
       //<< "#   CPUDriverOptimization=" << CPUDriverOptimization << "\n"
       //<< "#   numberOfMPIRanksToUseCUDA=" << numberOfMPIRanksToUseCUDA << "\n";
     }
@@ -733,55 +810,24 @@ int vtkSQMedianFilter::RequestUpdateExtent(
 
   (void)req;
 
-  typedef vtkStreamingDemandDrivenPipeline vtkSDDPipeline;
-
   vtkInformation* outInfo=outInfos->GetInformationObject(0);
   vtkInformation *inInfo=inInfos[0]->GetInformationObject(0);
 
   // We will modify the extents we request from our input so
-  // that we will have a layers of ghost cells. We also pass
-  // the number of ghosts through the piece based key.
+  // that we will have a layers of ghost cells. The ghosts needed
+  // downstream are requested as well so that a chain of stencil
+  // filters is served by a single ghost exchange.
   int nGhosts = this->KernelWidth/2;
 
-  inInfo->Set(
-        vtkSDDPipeline::UPDATE_NUMBER_OF_GHOST_LEVELS(),
-        nGhosts);
-
-  CartesianExtent outputExt;
-  outInfo->Get(
-        vtkSDDPipeline::UPDATE_EXTENT(),
-        outputExt.GetData());
-
-  CartesianExtent wholeExt;
-  inInfo->Get(
-        vtkSDDPipeline::WHOLE_EXTENT(),
-        wholeExt.GetData());
-
-  outputExt = CartesianExtent::Grow(
-        outputExt,
-        wholeExt,
-        nGhosts,
-        this->Mode);
-
-  inInfo->Set(
-        vtkSDDPipeline::UPDATE_EXTENT(),
-        outputExt.GetData(),
-        6);
-
-  int piece
-    = outInfo->Get(vtkSDDPipeline::UPDATE_PIECE_NUMBER());
-
-  int numPieces
-    = outInfo->Get(vtkSDDPipeline::UPDATE_NUMBER_OF_PIECES());
-
-  inInfo->Set(vtkSDDPipeline::UPDATE_PIECE_NUMBER(), piece);
-  inInfo->Set(vtkSDDPipeline::UPDATE_NUMBER_OF_PIECES(), numPieces);
-  inInfo->Set(vtkSDDPipeline::EXACT_EXTENT(), 1);
+  ImageStencil::RequestUpdateExtent(inInfo,outInfo,nGhosts,this->Mode);
 
   #ifdef SQTK_DEBUG
+  CartesianExtent inputExt;
+  inInfo->Get(
+        vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(),
+        inputExt.GetData());
   pCerr()
-    << "WHOLE_EXTENT=" << wholeExt << std::endl
-    << "UPDATE_EXTENT=" << outputExt << std::endl
+    << "UPDATE_EXTENT=" << inputExt << std::endl
     << "nGhosts=" << nGhosts << std::endl;
   #endif
 
@@ -829,21 +875,18 @@ int vtkSQMedianFilter::RequestData(
     return 1;
     }
 
-  // Get the input and output extents.
+  // Get the input and output extents. The output is computed on the
+  // input shrunk by our ghosts, ghosts requested downstream are passed
+  // on.
   CartesianExtent extV;
-  inInfo->Get(
-        vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(),
+  inData->GetInformation()->Get(
+        vtkDataObject::DATA_EXTENT(),
         extV.GetData());
 
-  CartesianExtent inputDom;
-  inInfo->Get(
-        vtkStreamingDemandDrivenPipeline::WHOLE_EXTENT(),
-        inputDom.GetData());
-
-  CartesianExtent extW;
+  CartesianExtent updateExt;
   outInfo->Get(
         vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(),
-        extW.GetData());
+        updateExt.GetData());
 
   CartesianExtent domainExt;
   outInfo->Get(
@@ -853,18 +896,17 @@ int vtkSQMedianFilter::RequestData(
   // Check that we have the ghost cells that we need (more is OK).
   int nGhost = this->KernelWidth/2;
 
-  CartesianExtent inputBox(extV);
-  CartesianExtent outputBox
-    = CartesianExtent::Grow(extW, nGhost, this->Mode);
+  CartesianExtent extW
+    = ImageStencil::GetOutputExtent(extV, domainExt, nGhost, this->Mode);
 
-  if (!inputBox.Contains(outputBox))
+  if (!extW.Contains(updateExt))
     {
     vtkErrorMacro(
       << "This filter requires ghost cells to function correctly. "
       << "The input must conatin the output plus " << nGhost
-      << " layers of ghosts. The input is " << inputBox
+      << " layers of ghosts. The input is " << extV
       << ", but it must be at least "
-      << outputBox << ".");
+      << CartesianExtent::Grow(updateExt, nGhost, this->Mode) << ".");
     return 1;
     }
 
@@ -901,8 +943,9 @@ int vtkSQMedianFilter::RequestData(
     #ifdef SQTK_DEBUG
     pCerr()
       << "WHOLE_EXTENT=" << domainExt << std::endl
-      << "UPDATE_EXTENT(input)=" << extV << std::endl
-      << "UPDATE_EXTENT(output)=" << extW << std::endl
+      << "UPDATE_EXTENT(output)=" << updateExt << std::endl
+      << "EXTENT(input)=" << extV << std::endl
+      << "EXTENT(output)=" << extW << std::endl
       << "ORIGIN" << Tuple<double>(X0,3) << std::endl
       << "SPACING" << Tuple<double>(dX,3) << std::endl
       << std::endl;
@@ -925,121 +968,24 @@ int vtkSQMedianFilter::RequestData(
     W->SetNumberOfTuples(outputTups);
     W->SetName(V->GetName());
 
-    int nV[3];
-    extV.Size(nV);
-    size_t vnijk=extV.Size();
-
-    int nW[3];
-    extW.Size(nW);
-    size_t wnijk=extW.Size();
-    size_t nComp=W->GetNumberOfComponents();
-
+    // window size, 1 along collapsed dimensions.
     int nK[3];
     this->KernelExt.Size(nK);
-    size_t knijk=this->KernelExt.Size();
-
-    int fastDim=0;
-    int slowDim=1;
-    switch (this->Mode)
-      {
-      case CartesianExtent::DIM_MODE_2D_XY:
-        fastDim=0;
-        slowDim=1;
-        break;
-      case CartesianExtent::DIM_MODE_2D_XZ:
-        fastDim=0;
-        slowDim=2;
-        break;
-      case CartesianExtent::DIM_MODE_2D_YZ:
-        fastDim=1;
-        slowDim=2;
-        break;
-      case CartesianExtent::DIM_MODE_3D:
-        fastDim=0;
-        slowDim=1;
-        break;
-      default:
-        sqErrorMacro(std::cerr,"Bad dim mode.");
-        return -1;
-      }
-
-    #ifdef SQTK_DEBUG
-    pCerr() << "wnijk=" << wnijk << std::endl;
-    pCerr() << "fastDim=" << fastDim << std::endl;
-    pCerr() << "slowDim=" << slowDim << std::endl;
-    pCerr() << "extV=" << extV << std::endl;
-    pCerr() << "nV=(" << nV[fastDim] <<  ", " << nV[slowDim] << ")" << std::endl;
-    pCerr() << "extW=" << extW << std::endl;
-    pCerr() << "nW=(" << nW[fastDim] <<  ", " << nW[slowDim] << ")" << std::endl;
-    #endif
 
+    // the median of each component is selected from the window
+    // around each point, with the slabs of the output distributed
+    // over the threads.
     switch (V->GetDataType())
       {
-      // TODO -- replace with vtkTemplateMacro
-      case VTK_FLOAT:
-        {
-        std::vector<float*> sV(nComp,0);
-        std::vector<float*> sW(nComp,0);
-        for (unsigned long q=0; q<nComp; ++q)
-          {
-          posix_memalign((void**)&sV[q],16,vnijk*sizeof(float));
-          posix_memalign((void**)&sW[q],16,wnijk*sizeof(float));
-          }
-
-        // convert vtk vectors/tensors into scalar component arrays
-        float *hV=(float*)V->GetVoidPointer(0);
-        Split<float>(vnijk,hV,sV);
-
-        // apply convolution
-        for (unsigned long q=0; q<nComp; ++q)
-          {
-          if ((this->Mode==CartesianExtent::DIM_MODE_2D_XY)
-            ||(this->Mode==CartesianExtent::DIM_MODE_2D_XZ)
-            ||(this->Mode==CartesianExtent::DIM_MODE_2D_YZ))
-            {
-            ::ScalarMedianFilter2D(
-                  nV[fastDim],
-                  nW[fastDim],
-                  wnijk,
-                  nK[fastDim],
-                  knijk,
-                  nGhost,
-                  sV[q],
-                  sW[q]);
-            }
-          else
-            {
-            ::ScalarMedianFilter3D(
-                  nV[fastDim],
-                  nV[fastDim]*nV[slowDim],
-                  nW[fastDim],
-                  nW[fastDim]*nW[slowDim],
-                  wnijk,
-                  nK[fastDim],
-                  nK[fastDim]*nK[slowDim],
-                  knijk,
-                  nGhost,
-                  sV[q],
-                  sW[q]);
-            }
-          }
-
-        // put results in vtk order
-        float *hW=(float*)W->GetVoidPointer(0);
-        Interleave(wnijk,sW,hW);
-
-        // clean up
-        for (unsigned long q=0; q<nComp; ++q)
-          {
-          free(sW[q]);
-          free(sV[q]);
-          }
-        }
-        break;
-      default:
-        // TODO
-        sqErrorMacro(std::cerr,"Not currently using vtkTemplateMacro");
-        return -1;
+      vtkFloatTemplateMacro(
+        ::ApplyMedianFilter<VTK_TT>(
+            this->NumberOfThreads,
+            extV,
+            extW,
+            nK,
+            nComps,
+            (VTK_TT*)V->GetVoidPointer(0),
+            (VTK_TT*)W->GetVoidPointer(0)));
       }
 
     outImData->GetPointData()->AddArray(W);
@@ -84,6 +84,14 @@ public:
   void SetKernelWidth(int width);
   vtkGetMacro(KernelWidth,int);
 
+  // Description:
+  // Set the number of threads the output is computed with, the threads
+  // working on slabs of the output. 0 uses the number of threads provided
+  // by vtkSMPTools, larger values use at most that many of them for this
+  // filter only. The default is 1, the calling thread.
+  vtkSetClampMacro(NumberOfThreads,int,0,VTK_INT_MAX);
+  vtkGetMacro(NumberOfThreads,int);
+
   /*
   // Description:
   // Query properties of the current device and available devices.
@@ -178,6 +186,7 @@ private:
   int KernelModified;
   //
   int Mode;
+  int NumberOfThreads;
 
   /*
   //
@@ -39,6 +39,7 @@
 #include "vtkIntArray.h"
 
 #include "vtkSQLog.h"
+#include "vtkSQOOCBlockCache.h"
 #include "BOVMetaData.h"
 #include "BOVReader.h"
 #include "BOVTimeStepImage.h"
@@ -47,7 +48,6 @@
 #include "RectilinearDecomp.h"
 #include "CartesianDataBlock.h"
 #include "CartesianDataBlockIODescriptor.h"
-#include "PriorityQueue.hxx"
 #include "Tuple.hxx"
 #include "postream.h"
 
@@ -118,25 +118,28 @@ vtkSQOOCBOVReader::vtkSQOOCBOVReader()
       :
   Reader(0),
   Image(0),
-  BlockAccessTime(0),
   BlockCacheSize(10),
+  BlockCacheMemory(0),
+  PrefetchBlocks(0),
   DomainDecomp(0),
-  LRUQueue(0),
+  LastBlock(0),
   CloseClearsCachedBlocks(1),
   CacheHitCount(0),
   CacheMissCount(0),
+  PrefetchCount(0),
   LogLevel(0)
-{
-  this->LRUQueue=new PriorityQueue<unsigned long int>;
-}
+{}
 
 //-----------------------------------------------------------------------------
 vtkSQOOCBOVReader::~vtkSQOOCBOVReader()
 {
   // this->Close(); expect the user to close
+  if (this->LastBlock)
+    {
+    this->LastBlock->UnRegister(0);
+    }
   this->SetReader(0);
   this->SetDomainDecomp(0);
-  delete this->LRUQueue;
 }
 
 //-----------------------------------------------------------------------------
@@ -150,9 +153,19 @@ void vtkSQOOCBOVReader::InitializeBlockCache()
 {
   this->ClearBlockCache();
 
-  int nBlocks=(int)this->DomainDecomp->GetNumberOfBlocks();
+  // the cache is shared by all readers, it is sized to hold
+  // the largest number of blocks requested by any of them.
+  vtkSQOOCBlockCache *cache=vtkSQOOCBlockCache::GetGlobalInstance();
+  if (this->BlockCacheSize>cache->GetMaximumNumberOfBlocks())
+    {
+    cache->SetMaximumNumberOfBlocks(this->BlockCacheSize);
+    }
+  if (this->BlockCacheMemory>0)
+    {
+    cache->SetMemoryBudget(this->BlockCacheMemory);
+    }
 
-  this->LRUQueue->Initialize(this->BlockCacheSize,nBlocks);
+  int nBlocks=(int)this->DomainDecomp->GetNumberOfBlocks();
 
   this->CacheHit.assign(nBlocks,0);
   this->CacheMiss.assign(nBlocks,0);
@@ -161,17 +174,25 @@ void vtkSQOOCBOVReader::InitializeBlockCache()
 //-----------------------------------------------------------------------------
 void vtkSQOOCBOVReader::ClearBlockCache()
 {
-  this->BlockAccessTime=0;
+  this->ResetBlockStatistics();
+
+  if (!this->CacheSource.empty())
+    {
+    vtkSQOOCBlockCache::GetGlobalInstance()->Remove(this->CacheSource.c_str());
+    }
+}
 
+//-----------------------------------------------------------------------------
+void vtkSQOOCBOVReader::ResetBlockStatistics()
+{
   this->CacheHitCount=0;
   this->CacheMissCount=0;
+  this->PrefetchCount=0;
 
-  while (!this->LRUQueue->Empty())
+  if (this->LastBlock)
     {
-    CartesianDataBlock *block
-      = this->DomainDecomp->GetBlock(this->LRUQueue->Pop());
-
-    block->SetData(0);
+    this->LastBlock->UnRegister(0);
+    this->LastBlock=0;
     }
 
   int nBlocks=(int)this->DomainDecomp->GetNumberOfBlocks();
@@ -188,7 +209,8 @@ void vtkSQOOCBOVReader::SetCommunicator(MPI_Comm comm)
 //-----------------------------------------------------------------------------
 int vtkSQOOCBOVReader::Open()
 {
-  this->ClearBlockCache();
+  // blocks cached by previous passes remain available.
+  this->ResetBlockStatistics();
 
   if (this->Image)
     {
@@ -203,6 +225,22 @@ int vtkSQOOCBOVReader::Open()
     return 0;
     }
 
+  // identify the blocks of this time step and array selection in
+  // the shared cache.
+  BOVMetaData *md=this->Reader->GetMetaData();
+  std::ostringstream oss;
+  oss << md->GetFileName() << ":" << this->TimeIndex;
+  size_t nArrays=md->GetNumberOfArrays();
+  for (size_t i=0; i<nArrays; ++i)
+    {
+    const char *name=md->GetArrayName(i);
+    if (md->IsArrayActive(name))
+      {
+      oss << ":" << name;
+      }
+    }
+  this->CacheSource=oss.str();
+
   return 1;
 }
 
@@ -281,6 +319,8 @@ void vtkSQOOCBOVReader::Close()
         }
       }
 
+    vtkSQOOCBlockCache *cache=vtkSQOOCBlockCache::GetGlobalInstance();
+
     log->GetBody()
       << worldRank
       << " vtkSQOOCBOVReader::BlockCacheStats"
@@ -288,6 +328,14 @@ void vtkSQOOCBOVReader::Close()
       << " nUniqueBlocks=" << nUsed
       << " HitCount=" << this->CacheHitCount
       << " MissCount=" << this->CacheMissCount
+      << " PrefetchCount=" << this->PrefetchCount
+      << " SharedBlocks=" << cache->GetNumberOfBlocks()
+      << " SharedMemoryUsed=" << cache->GetMemoryUsed()
+      << " SharedHitCount=" << cache->GetHitCount()
+      << " SharedMissCount=" << cache->GetMissCount()
+      << " SharedPrefetchCount=" << cache->GetPrefetchCount()
+      << " SharedPrefetchHitCount=" << cache->GetPrefetchHitCount()
+      << " SharedEvictionCount=" << cache->GetEvictionCount()
       << "\n";
     }
 
@@ -329,8 +377,18 @@ vtkDataSet *vtkSQOOCBOVReader::ReadNeighborhood(
   // update the working domain.
   workingDomain.Set(block->GetBounds());
 
-  // determine if the data associated with block is cached.
-  vtkDataSet *data=block->GetData();
+  // determine if the data associated with block is cached. The cache
+  // is shared by all the readers of the process.
+  const CartesianExtent &blockExt
+    = this->DomainDecomp->GetBlockIODescriptor(block->GetIndex())->GetMemExtent();
+
+  vtkSQOOCBlockCache *cache=vtkSQOOCBlockCache::GetGlobalInstance();
+
+  vtkDataSet *data=0;
+  if (this->BlockCacheSize>0)
+    {
+    data=cache->Find(this->CacheSource.c_str(),blockExt.GetData());
+    }
   if (data)
     {
     #if vtkSQOOCBOVReaderDEBUG>1
@@ -339,12 +397,6 @@ vtkDataSet *vtkSQOOCBOVReader::ReadNeighborhood(
 
     this->CacheHitCount+=1;
     this->CacheHit[block->GetIndex()]+=1;
-
-    // The data is locally cached. Update the LRU queue with the block's
-    // new access time, and return the cached dataset.
-    this->LRUQueue->Update(block->GetIndex(),++this->BlockAccessTime);
-
-    return data;
     }
   else
     {
@@ -355,123 +407,204 @@ vtkDataSet *vtkSQOOCBOVReader::ReadNeighborhood(
     this->CacheMissCount+=1;
     this->CacheMiss[block->GetIndex()]+=1;
 
-    // The data is not cached. If the cache is full then remove
-    // the least recently used block and delete it's dataset. Insert
-    // the requested block into the cache, load and return it's
-    // associated dataset.
-    if ((this->BlockCacheSize>0) && this->LRUQueue->Full())
+    // The data is not cached. Load the requested block and insert it
+    // into the cache, which releases the least recently used blocks
+    // when full.
+    data=this->ReadBlock(block);
+    if (!data)
       {
-      // get the oldest cahched block and delete it's associated data.
-      CartesianDataBlock *lruBlock
-        = this->DomainDecomp->GetBlock(this->LRUQueue->Pop());
-
-      lruBlock->SetData(0);
+      return 0;
+      }
 
+    if (this->BlockCacheSize>0)
+      {
       #if vtkSQOOCBOVReaderDEBUG>1
-      std::cerr << "\tRemoved " << Tuple<int>(lruBlock->GetId(),4);
+      std::cerr << "\tInserted " << Tuple<int>(block->GetId(),4) << std::endl;
       #endif
+      cache->Insert(this->CacheSource.c_str(),blockExt.GetData(),data);
       }
+    }
 
-    // configure a new dataset and read with ghost cells. Note: working
-    // domain is smaller than the bounds of the dataset that is read.
-    CartesianDataBlockIODescriptor *descr
-      = this->DomainDecomp->GetBlockIODescriptor(block->GetIndex());
-
-    const CartesianExtent &blockExt=descr->GetMemExtent();
-
-    if (this->Reader->DataSetTypeIsImage())
-      {
-      ImageDecomp *idec=dynamic_cast<ImageDecomp*>(this->DomainDecomp);
-      double *X0=idec->GetOrigin();
-      double *dX=idec->GetSpacing();
+  // hold a reference to the returned block so that it remains valid
+  // when it is released from the cache, until the next read.
+  if (this->LastBlock)
+    {
+    this->LastBlock->UnRegister(0);
+    }
+  this->LastBlock=data;
 
-      int nPoints[3];
-      blockExt.Size(nPoints);
+  return data;
+}
 
-      double blockX0[3];
-      blockExt.GetLowerBound(X0,dX,blockX0);
+//-----------------------------------------------------------------------------
+void vtkSQOOCBOVReader::PrefetchNeighborhood(
+    const double pt[3],
+    const double v[3])
+{
+  if (!this->PrefetchBlocks || (this->BlockCacheSize<1))
+    {
+    return;
+    }
 
-      vtkImageData *idata=vtkImageData::New();
-      idata->SetDimensions(nPoints);
-      idata->SetOrigin(blockX0);
-      idata->SetSpacing(dX);
+  CartesianDataBlock *block=this->DomainDecomp->GetBlock(pt);
+  if (block==0)
+    {
+    return;
+    }
 
-      data=idata;
+  // find where the ray pt+t*v leaves the block.
+  const CartesianBounds &bounds=block->GetBounds();
+  double tExit=VTK_DOUBLE_MAX;
+  int exitDir=-1;
+  for (int q=0; q<3; ++q)
+    {
+    double t=VTK_DOUBLE_MAX;
+    if (v[q]>0.0)
+      {
+      t=(bounds[2*q+1]-pt[q])/v[q];
       }
     else
-    if (this->Reader->DataSetTypeIsRectilinear())
+    if (v[q]<0.0)
       {
-      RectilinearDecomp *rdec=dynamic_cast<RectilinearDecomp*>(this->DomainDecomp);
+      t=(bounds[2*q]-pt[q])/v[q];
+      }
+    if (t<tExit)
+      {
+      tExit=t;
+      exitDir=q;
+      }
+    }
+  if (exitDir<0)
+    {
+    return;
+    }
+
+  // step across the exit face into the neighbor.
+  double next[3]={
+      pt[0]+tExit*v[0],
+      pt[1]+tExit*v[1],
+      pt[2]+tExit*v[2]};
+  double width=bounds[2*exitDir+1]-bounds[2*exitDir];
+  next[exitDir]+=(v[exitDir]>0.0?1.0E-3:-1.0E-3)*width;
 
-      int nPoints[3];
-      blockExt.Size(nPoints);
+  CartesianDataBlock *neighbor=this->DomainDecomp->GetBlock(next);
+  if ((neighbor==0) || (neighbor==block))
+    {
+    return;
+    }
 
-      vtkRectilinearGrid *rdata=vtkRectilinearGrid::New();
-      rdata->SetExtent(const_cast<int*>(blockExt.GetData()));
+  const CartesianExtent &neighborExt
+    = this->DomainDecomp->GetBlockIODescriptor(neighbor->GetIndex())->GetMemExtent();
 
-      vtkFloatArray *fa;
-      fa=vtkFloatArray::New();
-      fa->SetArray(rdec->SubsetCoordinate(0,blockExt),nPoints[0],0);
-      rdata->SetXCoordinates(fa);
-      fa->Delete();
+  vtkSQOOCBlockCache *cache=vtkSQOOCBlockCache::GetGlobalInstance();
+  if (cache->Contains(this->CacheSource.c_str(),neighborExt.GetData()))
+    {
+    return;
+    }
 
-      fa=vtkFloatArray::New();
-      fa->SetArray(rdec->SubsetCoordinate(1,blockExt),nPoints[1],0);
-      rdata->SetYCoordinates(fa);
-      fa->Delete();
+  #if vtkSQOOCBOVReaderDEBUG>1
+  std::cerr << "Prefetching " << Tuple<int>(neighbor->GetId(),4) << std::endl;
+  #endif
 
-      fa=vtkFloatArray::New();
-      fa->SetArray(rdec->SubsetCoordinate(2,blockExt),nPoints[2],0);
-      rdata->SetZCoordinates(fa);
-      fa->Delete();
+  vtkDataSet *data=this->ReadBlock(neighbor);
+  if (data)
+    {
+    this->PrefetchCount+=1;
+    cache->Insert(this->CacheSource.c_str(),neighborExt.GetData(),data,1);
+    data->Delete();
+    }
+}
 
-      data=rdata;
-      }
-    else
-    if (this->Reader->DataSetTypeIsStructured())
-      {
-      vtkErrorMacro("Path for vtkSturcturedData not implemented.");
-      return 0;
-      }
-    else
-      {
-      vtkErrorMacro("Unsupported dataset type \"" << this->Reader->GetDataSetType() << "\".");
-      return 0;
-      }
+//-----------------------------------------------------------------------------
+vtkDataSet *vtkSQOOCBOVReader::ReadBlock(CartesianDataBlock *block)
+{
+  // configure a new dataset and read with ghost cells. Note: working
+  // domain is smaller than the bounds of the dataset that is read.
+  CartesianDataBlockIODescriptor *descr
+    = this->DomainDecomp->GetBlockIODescriptor(block->GetIndex());
 
-    int ok=this->Reader->ReadTimeStep(this->Image,descr,data,(vtkAlgorithm*)0);
-    if (!ok)
-      {
-      data->Delete();
-      vtkErrorMacro("Read failed.");
-      return 0;
-      }
+  const CartesianExtent &blockExt=descr->GetMemExtent();
 
-    // cache the dataset
-    if (this->BlockCacheSize>0)
-      {
-      #if vtkSQOOCBOVReaderDEBUG>1
-      std::cerr << "\tInserted " << Tuple<int>(block->GetId(),4) << std::endl;
-      #endif
+  vtkDataSet *data=0;
 
-      // cache the newly read dataset, and insert this block into
-      // the lru queue.
-      block->SetData(data);
-      data->Delete();
-      this->LRUQueue->Push(block->GetIndex(),++this->BlockAccessTime);
-      }
+  if (this->Reader->DataSetTypeIsImage())
+    {
+    ImageDecomp *idec=dynamic_cast<ImageDecomp*>(this->DomainDecomp);
+    double *X0=idec->GetOrigin();
+    double *dX=idec->GetSpacing();
 
-    #if vtkSQOOCBOVReaderDEBUG>2
-    // data->Print(std::cerr);
-    vtkDataSetWriter *idw=vtkDataSetWriter::New();
-    std::ostringstream oss;
-    oss << "block." << block->GetIndex() << ".vtk";
-    idw->SetFileName(oss.str().c_str());
-    idw->SetInput(data);
-    idw->Write();
-    idw->Delete();
-    #endif
+    int nPoints[3];
+    blockExt.Size(nPoints);
+
+    double blockX0[3];
+    blockExt.GetLowerBound(X0,dX,blockX0);
+
+    vtkImageData *idata=vtkImageData::New();
+    idata->SetDimensions(nPoints);
+    idata->SetOrigin(blockX0);
+    idata->SetSpacing(dX);
+
+    data=idata;
+    }
+  else
+  if (this->Reader->DataSetTypeIsRectilinear())
+    {
+    RectilinearDecomp *rdec=dynamic_cast<RectilinearDecomp*>(this->DomainDecomp);
+
+    int nPoints[3];
+    blockExt.Size(nPoints);
+
+    vtkRectilinearGrid *rdata=vtkRectilinearGrid::New();
+    rdata->SetExtent(const_cast<int*>(blockExt.GetData()));
+
+    vtkFloatArray *fa;
+    fa=vtkFloatArray::New();
+    fa->SetArray(rdec->SubsetCoordinate(0,blockExt),nPoints[0],0);
+    rdata->SetXCoordinates(fa);
+    fa->Delete();
+
+    fa=vtkFloatArray::New();
+    fa->SetArray(rdec->SubsetCoordinate(1,blockExt),nPoints[1],0);
+    rdata->SetYCoordinates(fa);
+    fa->Delete();
+
+    fa=vtkFloatArray::New();
+    fa->SetArray(rdec->SubsetCoordinate(2,blockExt),nPoints[2],0);
+    rdata->SetZCoordinates(fa);
+    fa->Delete();
+
+    data=rdata;
     }
+  else
+  if (this->Reader->DataSetTypeIsStructured())
+    {
+    vtkErrorMacro("Path for vtkSturcturedData not implemented.");
+    return 0;
+    }
+  else
+    {
+    vtkErrorMacro("Unsupported dataset type \"" << this->Reader->GetDataSetType() << "\".");
+    return 0;
+    }
+
+  int ok=this->Reader->ReadTimeStep(this->Image,descr,data,(vtkAlgorithm*)0);
+  if (!ok)
+    {
+    data->Delete();
+    vtkErrorMacro("Read failed.");
+    return 0;
+    }
+
+  #if vtkSQOOCBOVReaderDEBUG>2
+  // data->Print(std::cerr);
+  vtkDataSetWriter *idw=vtkDataSetWriter::New();
+  std::ostringstream oss;
+  oss << "block." << block->GetIndex() << ".vtk";
+  idw->SetFileName(oss.str().c_str());
+  idw->SetInput(data);
+  idw->Write();
+  idw->Delete();
+  #endif
 
   return data;
 }
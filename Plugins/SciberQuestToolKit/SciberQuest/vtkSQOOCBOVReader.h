@@ -42,6 +42,7 @@ typedef void * MPI_Comm;
 #endif
 
 #include <vector> // for vector
+#include <string> // for string
 
 class vtkDataSet;
 class vtkImageData;
@@ -49,7 +50,6 @@ class BOVReader;
 class BOVTimeStepImage;
 class CartesianDecomp;
 class CartesianDataBlock;
-template<typename T> class PriorityQueue;
 
 /// Implementation for Brick-Of-Values (BOV) Out-Of-Core (OOC) file access.
 /**
@@ -86,10 +86,27 @@ public:
   Set the number of block to cache during out-of-core operation.
   Setting the cache size greater than the number of blocks in the
   decomposition results in in-core operation, with multiple reads.
+  Blocks are held in the process wide vtkSQOOCBlockCache, shared with
+  the other readers, which is sized to the largest of the requested
+  cache sizes. 0 disables caching.
   */
   vtkSetMacro(BlockCacheSize,int);
   vtkGetMacro(BlockCacheSize,int);
 
+  /**
+  Set the memory budget (in kiB) of the shared block cache. 0 leaves
+  the current budget unchanged.
+  */
+  vtkSetMacro(BlockCacheMemory,unsigned long);
+  vtkGetMacro(BlockCacheMemory,unsigned long);
+
+  /**
+  If set, PrefetchNeighborhood loads the neighbor block in the
+  direction of integration into the cache.
+  */
+  vtkSetMacro(PrefetchBlocks,int);
+  vtkGetMacro(PrefetchBlocks,int);
+
   /**
   After the set'ing of a domain and cahche size the cache must
   be initialized prior to any attempt to read data.
@@ -97,7 +114,7 @@ public:
   void InitializeBlockCache();
 
   /**
-  Empty any cached data.
+  Empty any cached data read by this reader.
   */
   void ClearBlockCache();
 
@@ -127,12 +144,19 @@ public:
   /**
   Return the dataset containing point, p, and its valid bounds,
   in WorkingDomain. These may differ from the bounds of the dataset
-  for example in the case where ghost cells are provided.
+  for example in the case where ghost cells are provided. The
+  returned dataset remains valid until the next read.
   */
   virtual vtkDataSet *ReadNeighborhood(
       const double p[3],
       CartesianBounds &WorkingDomain);
 
+  /**
+  Load the block next to the one containing p in direction v into
+  the cache, if PrefetchBlocks is set.
+  */
+  virtual void PrefetchNeighborhood(const double p[3], const double v[3]);
+
   /**
   Turn on an array to be read.
   */
@@ -161,19 +185,31 @@ private:
   vtkSQOOCBOVReader(const vtkSQOOCBOVReader&) VTK_DELETE_FUNCTION;
   void operator=(const vtkSQOOCBOVReader&) VTK_DELETE_FUNCTION;
 
+  // Description:
+  // Read a block with its ghost cells. The caller owns the returned
+  // dataset.
+  vtkDataSet *ReadBlock(CartesianDataBlock *block);
+
+  // Description:
+  // Reset the access statistics, and release the last block read.
+  void ResetBlockStatistics();
+
 private:
   BOVReader *Reader;                            // reader
   BOVTimeStepImage *Image;                      // file handle
-  unsigned long int BlockAccessTime;            // lru access time
   int BlockCacheSize;                           // number of block to keep in memory
+  unsigned long BlockCacheMemory;               // memory budget of the shared cache
+  int PrefetchBlocks;                           // enables prefetching of neighbor blocks
   CartesianDecomp *DomainDecomp;                // domain decomposition
-  PriorityQueue<unsigned long int> *LRUQueue;   // least-recently-used block queue
+  std::string CacheSource;                      // identifies our blocks in the shared cache
+  vtkDataSet *LastBlock;                        // reference to the last block returned
   int CloseClearsCachedBlocks;                  // controls cache flush on close
 
   std::vector<int> CacheHit;                    // count the number of times each block is accessed
   std::vector<int> CacheMiss;                   // count the number of times each block is accessed
   long long CacheHitCount;                      // track block cache hits
   long long CacheMissCount;                     // track block cache misses
+  long long PrefetchCount;                      // track blocks prefetched
 
   int LogLevel;                                 // enable logging
 };
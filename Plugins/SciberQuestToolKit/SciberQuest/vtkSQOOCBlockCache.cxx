@@ -0,0 +1,428 @@
+/*
+ * Copyright 2012 SciberQuest Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of SciberQuest Inc. nor the names of any contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include "vtkSQOOCBlockCache.h"
+
+#include "vtkObjectFactory.h"
+#include "vtkDataSet.h"
+#include "vtkSimpleCriticalSection.h"
+
+#include <list>
+#include <map>
+#include <sstream>
+#include <string>
+
+/*
+For singleton pattern
+**/
+vtkSQOOCBlockCache *vtkSQOOCBlockCache::GlobalInstance=0;
+vtkSQOOCBlockCacheDestructor vtkSQOOCBlockCache::GlobalInstanceDestructor;
+static vtkSimpleCriticalSection GlobalInstanceLock;
+
+//-----------------------------------------------------------------------------
+vtkSQOOCBlockCacheDestructor::~vtkSQOOCBlockCacheDestructor()
+{
+  if (this->Cache)
+    {
+    this->Cache->Delete();
+    }
+}
+
+//*****************************************************************************
+class vtkSQOOCBlockCache::vtkInternals
+{
+public:
+  vtkInternals()
+        :
+    MaximumNumberOfBlocks(0),
+    MemoryBudget(0),
+    MemoryUsed(0),
+    HitCount(0),
+    MissCount(0),
+    PrefetchCount(0),
+    PrefetchHitCount(0),
+    EvictionCount(0)
+    {}
+
+  ~vtkInternals(){ this->Clear(); }
+
+  struct Entry
+    {
+    vtkDataSet *Data;
+    unsigned long Size;
+    int Prefetched;
+    std::string Source;
+    std::list<std::string>::iterator Use;
+    };
+  typedef std::map<std::string,Entry> EntryMap;
+
+  // Description:
+  // Build the key identifying a block.
+  static std::string GetKey(const char *source, const int extent[6])
+    {
+    std::ostringstream oss;
+    oss
+      << (source?source:"") << ":"
+      << extent[0] << "," << extent[1] << ","
+      << extent[2] << "," << extent[3] << ","
+      << extent[4] << "," << extent[5];
+    return oss.str();
+    }
+
+  // Description:
+  // Release an entry.
+  void Erase(EntryMap::iterator it)
+    {
+    this->MemoryUsed-=it->second.Size;
+    it->second.Data->UnRegister(0);
+    this->LRU.erase(it->second.Use);
+    this->Entries.erase(it);
+    }
+
+  // Description:
+  // Release the least recently used entries until the limits are met.
+  // At least the most recently used entry is kept.
+  void Evict()
+    {
+    while ((this->Entries.size()>1)
+      && (((this->MaximumNumberOfBlocks>0)
+      && ((int)this->Entries.size()>this->MaximumNumberOfBlocks))
+      || ((this->MemoryBudget>0) && (this->MemoryUsed>this->MemoryBudget))))
+      {
+      this->Erase(this->Entries.find(this->LRU.front()));
+      this->EvictionCount+=1;
+      }
+    }
+
+  void Clear()
+    {
+    while (!this->Entries.empty())
+      {
+      this->Erase(this->Entries.begin());
+      }
+    }
+
+public:
+  vtkSimpleCriticalSection Lock;
+  EntryMap Entries;
+  std::list<std::string> LRU; // least recently used first
+  int MaximumNumberOfBlocks;
+  unsigned long MemoryBudget;
+  unsigned long MemoryUsed;
+  long long HitCount;
+  long long MissCount;
+  long long PrefetchCount;
+  long long PrefetchHitCount;
+  long long EvictionCount;
+};
+
+//-----------------------------------------------------------------------------
+vtkStandardNewMacro(vtkSQOOCBlockCache);
+
+//-----------------------------------------------------------------------------
+vtkSQOOCBlockCache::vtkSQOOCBlockCache()
+{
+  this->Internals=new vtkInternals;
+}
+
+//-----------------------------------------------------------------------------
+vtkSQOOCBlockCache::~vtkSQOOCBlockCache()
+{
+  delete this->Internals;
+}
+
+//-----------------------------------------------------------------------------
+vtkSQOOCBlockCache *vtkSQOOCBlockCache::GetGlobalInstance()
+{
+  GlobalInstanceLock.Lock();
+  if (vtkSQOOCBlockCache::GlobalInstance==0)
+    {
+    vtkSQOOCBlockCache *cache=vtkSQOOCBlockCache::New();
+    vtkSQOOCBlockCache::GlobalInstance=cache;
+    vtkSQOOCBlockCache::GlobalInstanceDestructor.SetCache(cache);
+    }
+  GlobalInstanceLock.Unlock();
+  return vtkSQOOCBlockCache::GlobalInstance;
+}
+
+//-----------------------------------------------------------------------------
+void vtkSQOOCBlockCache::DeleteGlobalInstance()
+{
+  GlobalInstanceLock.Lock();
+  if (vtkSQOOCBlockCache::GlobalInstance)
+    {
+    vtkSQOOCBlockCache::GlobalInstance->Delete();
+    vtkSQOOCBlockCache::GlobalInstance=0;
+    vtkSQOOCBlockCache::GlobalInstanceDestructor.SetCache(0);
+    }
+  GlobalInstanceLock.Unlock();
+}
+
+//-----------------------------------------------------------------------------
+void vtkSQOOCBlockCache::SetMaximumNumberOfBlocks(int n)
+{
+  this->Internals->Lock.Lock();
+  this->Internals->MaximumNumberOfBlocks=n<0?0:n;
+  this->Internals->Evict();
+  this->Internals->Lock.Unlock();
+}
+
+//-----------------------------------------------------------------------------
+int vtkSQOOCBlockCache::GetMaximumNumberOfBlocks()
+{
+  this->Internals->Lock.Lock();
+  int n=this->Internals->MaximumNumberOfBlocks;
+  this->Internals->Lock.Unlock();
+  return n;
+}
+
+//-----------------------------------------------------------------------------
+void vtkSQOOCBlockCache::SetMemoryBudget(unsigned long kib)
+{
+  this->Internals->Lock.Lock();
+  this->Internals->MemoryBudget=kib;
+  this->Internals->Evict();
+  this->Internals->Lock.Unlock();
+}
+
+//-----------------------------------------------------------------------------
+unsigned long vtkSQOOCBlockCache::GetMemoryBudget()
+{
+  this->Internals->Lock.Lock();
+  unsigned long kib=this->Internals->MemoryBudget;
+  this->Internals->Lock.Unlock();
+  return kib;
+}
+
+//-----------------------------------------------------------------------------
+vtkDataSet *vtkSQOOCBlockCache::Find(const char *source, const int extent[6])
+{
+  std::string key=vtkInternals::GetKey(source,extent);
+
+  this->Internals->Lock.Lock();
+  vtkDataSet *data=0;
+  vtkInternals::EntryMap::iterator it=this->Internals->Entries.find(key);
+  if (it==this->Internals->Entries.end())
+    {
+    this->Internals->MissCount+=1;
+    }
+  else
+    {
+    vtkInternals::Entry &entry=it->second;
+    this->Internals->HitCount+=1;
+    if (entry.Prefetched)
+      {
+      this->Internals->PrefetchHitCount+=1;
+      entry.Prefetched=0;
+      }
+    // move to the most recently used end.
+    this->Internals->LRU.splice(
+          this->Internals->LRU.end(),
+          this->Internals->LRU,
+          entry.Use);
+    data=entry.Data;
+    data->Register(0);
+    }
+  this->Internals->Lock.Unlock();
+
+  return data;
+}
+
+//-----------------------------------------------------------------------------
+int vtkSQOOCBlockCache::Contains(const char *source, const int extent[6])
+{
+  std::string key=vtkInternals::GetKey(source,extent);
+
+  this->Internals->Lock.Lock();
+  int found=this->Internals->Entries.find(key)!=this->Internals->Entries.end();
+  this->Internals->Lock.Unlock();
+
+  return found;
+}
+
+//-----------------------------------------------------------------------------
+void vtkSQOOCBlockCache::Insert(
+      const char *source,
+      const int extent[6],
+      vtkDataSet *data,
+      int prefetched)
+{
+  if (data==0)
+    {
+    return;
+    }
+
+  std::string key=vtkInternals::GetKey(source,extent);
+  unsigned long size=data->GetActualMemorySize();
+
+  this->Internals->Lock.Lock();
+  // another thread may have inserted the same block in the meantime.
+  vtkInternals::EntryMap::iterator it=this->Internals->Entries.find(key);
+  if (it!=this->Internals->Entries.end())
+    {
+    this->Internals->Erase(it);
+    }
+
+  vtkInternals::Entry &entry=this->Internals->Entries[key];
+  entry.Data=data;
+  entry.Data->Register(0);
+  entry.Size=size;
+  entry.Prefetched=prefetched;
+  entry.Source=source?source:"";
+  entry.Use=this->Internals->LRU.insert(this->Internals->LRU.end(),key);
+  this->Internals->MemoryUsed+=size;
+  if (prefetched)
+    {
+    this->Internals->PrefetchCount+=1;
+    }
+
+  this->Internals->Evict();
+  this->Internals->Lock.Unlock();
+}
+
+//-----------------------------------------------------------------------------
+void vtkSQOOCBlockCache::Remove(const char *source)
+{
+  std::string src=source?source:"";
+
+  this->Internals->Lock.Lock();
+  vtkInternals::EntryMap::iterator it=this->Internals->Entries.begin();
+  while (it!=this->Internals->Entries.end())
+    {
+    vtkInternals::EntryMap::iterator cur=it;
+    ++it;
+    if (cur->second.Source==src)
+      {
+      this->Internals->Erase(cur);
+      }
+    }
+  this->Internals->Lock.Unlock();
+}
+
+//-----------------------------------------------------------------------------
+void vtkSQOOCBlockCache::Clear()
+{
+  this->Internals->Lock.Lock();
+  this->Internals->Clear();
+  this->Internals->Lock.Unlock();
+}
+
+//-----------------------------------------------------------------------------
+long long vtkSQOOCBlockCache::GetHitCount()
+{
+  this->Internals->Lock.Lock();
+  long long n=this->Internals->HitCount;
+  this->Internals->Lock.Unlock();
+  return n;
+}
+
+//-----------------------------------------------------------------------------
+long long vtkSQOOCBlockCache::GetMissCount()
+{
+  this->Internals->Lock.Lock();
+  long long n=this->Internals->MissCount;
+  this->Internals->Lock.Unlock();
+  return n;
+}
+
+//-----------------------------------------------------------------------------
+long long vtkSQOOCBlockCache::GetPrefetchCount()
+{
+  this->Internals->Lock.Lock();
+  long long n=this->Internals->PrefetchCount;
+  this->Internals->Lock.Unlock();
+  return n;
+}
+
+//-----------------------------------------------------------------------------
+long long vtkSQOOCBlockCache::GetPrefetchHitCount()
+{
+  this->Internals->Lock.Lock();
+  long long n=this->Internals->PrefetchHitCount;
+  this->Internals->Lock.Unlock();
+  return n;
+}
+
+//-----------------------------------------------------------------------------
+long long vtkSQOOCBlockCache::GetEvictionCount()
+{
+  this->Internals->Lock.Lock();
+  long long n=this->Internals->EvictionCount;
+  this->Internals->Lock.Unlock();
+  return n;
+}
+
+//-----------------------------------------------------------------------------
+void vtkSQOOCBlockCache::ResetStatistics()
+{
+  this->Internals->Lock.Lock();
+  this->Internals->HitCount=0;
+  this->Internals->MissCount=0;
+  this->Internals->PrefetchCount=0;
+  this->Internals->PrefetchHitCount=0;
+  this->Internals->EvictionCount=0;
+  this->Internals->Lock.Unlock();
+}
+
+//-----------------------------------------------------------------------------
+int vtkSQOOCBlockCache::GetNumberOfBlocks()
+{
+  this->Internals->Lock.Lock();
+  int n=(int)this->Internals->Entries.size();
+  this->Internals->Lock.Unlock();
+  return n;
+}
+
+//-----------------------------------------------------------------------------
+unsigned long vtkSQOOCBlockCache::GetMemoryUsed()
+{
+  this->Internals->Lock.Lock();
+  unsigned long kib=this->Internals->MemoryUsed;
+  this->Internals->Lock.Unlock();
+  return kib;
+}
+
+//-----------------------------------------------------------------------------
+void vtkSQOOCBlockCache::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  this->Internals->Lock.Lock();
+  os
+    << indent << "MaximumNumberOfBlocks: " << this->Internals->MaximumNumberOfBlocks << endl
+    << indent << "MemoryBudget: " << this->Internals->MemoryBudget << endl
+    << indent << "NumberOfBlocks: " << this->Internals->Entries.size() << endl
+    << indent << "MemoryUsed: " << this->Internals->MemoryUsed << endl
+    << indent << "HitCount: " << this->Internals->HitCount << endl
+    << indent << "MissCount: " << this->Internals->MissCount << endl
+    << indent << "PrefetchCount: " << this->Internals->PrefetchCount << endl
+    << indent << "PrefetchHitCount: " << this->Internals->PrefetchHitCount << endl
+    << indent << "EvictionCount: " << this->Internals->EvictionCount << endl;
+  this->Internals->Lock.Unlock();
+}
@@ -0,0 +1,148 @@
+/*
+ * Copyright 2012 SciberQuest Inc.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ *  * Neither name of SciberQuest Inc. nor the names of any contributors may be
+ *    used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+// .NAME vtkSQOOCBlockCache -- Process wide cache of out-of-core blocks.
+// .SECTION Description
+//
+//  Holds the blocks read by the out-of-core readers so that they may be
+//  shared across readers, passes and threads of a process. Blocks are
+//  identified by the data source they were read from and their extent.
+//  The least recently used blocks are released when either the number
+//  of blocks or the memory they use exceeds the configured limits.
+//  All methods are thread safe.
+//
+
+#ifndef vtkSQOOCBlockCache_h
+#define vtkSQOOCBlockCache_h
+
+#include "vtkSciberQuestModule.h" // for export macro
+#include "vtkObject.h"
+
+class vtkDataSet;
+class vtkSQOOCBlockCache;
+
+/**
+A class responsible for delete'ing the global instance of the cache.
+*/
+class VTKSCIBERQUEST_EXPORT vtkSQOOCBlockCacheDestructor
+{
+public:
+  vtkSQOOCBlockCacheDestructor() : Cache(0) {}
+  ~vtkSQOOCBlockCacheDestructor();
+
+  void SetCache(vtkSQOOCBlockCache *cache){ this->Cache=cache; }
+
+private:
+  vtkSQOOCBlockCache *Cache;
+};
+
+//=============================================================================
+class VTKSCIBERQUEST_EXPORT vtkSQOOCBlockCache : public vtkObject
+{
+public:
+  static vtkSQOOCBlockCache *New();
+  vtkTypeMacro(vtkSQOOCBlockCache,vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // The cache implements the singleton pattern so that it may be
+  // shared by all readers of the process. If the instance doesn't
+  // exist then one is created. It is automatically destroyed at exit.
+  static vtkSQOOCBlockCache *GetGlobalInstance();
+
+  // Description:
+  // Explicitly delete the singleton.
+  static void DeleteGlobalInstance();
+
+  // Description:
+  // Set/Get the maximum number of blocks held. 0 means no limit.
+  void SetMaximumNumberOfBlocks(int n);
+  int GetMaximumNumberOfBlocks();
+
+  // Description:
+  // Set/Get the maximum amount of memory (in kiB) used by the blocks
+  // held. 0 means no limit.
+  void SetMemoryBudget(unsigned long kib);
+  unsigned long GetMemoryBudget();
+
+  // Description:
+  // Return the block of the given source with the given extent,
+  // or 0 if it is not cached. The returned dataset is Register'ed,
+  // the caller must UnRegister it.
+  vtkDataSet *Find(const char *source, const int extent[6]);
+
+  // Description:
+  // Return non-zero if the block is cached. Does not count as an
+  // access.
+  int Contains(const char *source, const int extent[6]);
+
+  // Description:
+  // Insert a block, blocks that exceed the limits are released.
+  // Prefetched blocks are accounted for separately in the statistics.
+  void Insert(
+        const char *source,
+        const int extent[6],
+        vtkDataSet *data,
+        int prefetched=0);
+
+  // Description:
+  // Release the blocks of the given source, or all blocks.
+  void Remove(const char *source);
+  void Clear();
+
+  // Description:
+  // Access statistics, since the last ResetStatistics.
+  long long GetHitCount();
+  long long GetMissCount();
+  long long GetPrefetchCount();
+  long long GetPrefetchHitCount();
+  long long GetEvictionCount();
+  void ResetStatistics();
+
+  // Description:
+  // Get the number of blocks held and the memory (in kiB) they use.
+  int GetNumberOfBlocks();
+  unsigned long GetMemoryUsed();
+
+protected:
+  vtkSQOOCBlockCache();
+  virtual ~vtkSQOOCBlockCache();
+
+private:
+  vtkSQOOCBlockCache(const vtkSQOOCBlockCache&) VTK_DELETE_FUNCTION;
+  void operator=(const vtkSQOOCBlockCache&) VTK_DELETE_FUNCTION;
+
+  class vtkInternals;
+  vtkInternals *Internals;
+
+  static vtkSQOOCBlockCache *GlobalInstance;
+  static vtkSQOOCBlockCacheDestructor GlobalInstanceDestructor;
+};
+
+#endif
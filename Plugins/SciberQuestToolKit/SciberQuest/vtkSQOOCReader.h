@@ -109,6 +109,17 @@ public:
       const double p[3],
       CartesianBounds &WorkingDomain)=0;
 
+  /**
+  Hint that the block next to the one containing point, p, in
+  direction, v, will be needed soon. The implementation may load
+  it ahead of time. Optional, the default does nothing.
+  */
+  virtual void PrefetchNeighborhood(const double p[3], const double v[3])
+    {
+    (void)p;
+    (void)v;
+    }
+
   /**
   Turn on an array to be read.
   */
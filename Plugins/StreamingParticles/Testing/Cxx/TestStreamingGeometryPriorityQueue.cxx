@@ -0,0 +1,180 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    TestStreamingGeometryPriorityQueue.cxx
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Streams the blocks of a nested multiblock meta-data with two views, and
+// checks the blocks requested for each view, the blocks purged to stay within
+// the memory limit, and that streaming pauses when the visible blocks alone
+// exceed the limit.
+
+#include "vtkCamera.h"
+#include "vtkCompositeDataSet.h"
+#include "vtkInformation.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkNew.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkStreamingGeometryPriorityQueue.h"
+
+#include <iostream>
+#include <set>
+#include <vector>
+
+namespace
+{
+  void SetBounds(vtkMultiBlockDataSet* mb, unsigned int index, double xmin)
+    {
+    double bounds[6] = { xmin, xmin + 1.0, 0.0, 1.0, 0.0, 1.0 };
+    mb->GetMetaData(index)->Set(
+      vtkStreamingDemandDrivenPipeline::BOUNDS(), bounds, 6);
+    }
+
+  // View planes of a camera looking down -z at the blocks around x.
+  void GetViewPlanes(double x, double planes[24])
+    {
+    vtkNew<vtkCamera> camera;
+    camera->SetPosition(x, 0.5, 10.0);
+    camera->SetFocalPoint(x, 0.5, 0.5);
+    camera->SetViewUp(0.0, 1.0, 0.0);
+    camera->SetViewAngle(30.0);
+    camera->SetClippingRange(1.0, 20.0);
+    camera->GetFrustumPlanes(1.0, planes);
+    }
+
+  std::set<unsigned int> PopAll(vtkStreamingGeometryPriorityQueue* queue,
+    std::vector<unsigned int>& order)
+    {
+    order.clear();
+    while (!queue->IsEmpty())
+      {
+      order.push_back(queue->Pop());
+      }
+    return std::set<unsigned int>(order.begin(), order.end());
+    }
+}
+
+#define TEST_ASSERT(condition, message) \
+  if (!(condition)) \
+    { \
+    std::cerr << "ERROR: " << message << std::endl; \
+    return EXIT_FAILURE; \
+    }
+
+int TestStreamingGeometryPriorityQueue(int, char* [])
+{
+  // Leaves 0 and 1 near x = 1, leaves 2 and 3 in a nested multiblock near
+  // x = 12 and leaf 4 without bounds.
+  vtkNew<vtkMultiBlockDataSet> metadata;
+  vtkNew<vtkMultiBlockDataSet> nested;
+  metadata->SetNumberOfBlocks(4);
+  nested->SetNumberOfBlocks(2);
+  SetBounds(metadata.GetPointer(), 0, 0.0);
+  SetBounds(metadata.GetPointer(), 1, 2.0);
+  SetBounds(nested.GetPointer(), 0, 11.0);
+  SetBounds(nested.GetPointer(), 1, 12.5);
+  metadata->SetBlock(2, nested.GetPointer());
+
+  double left[24], right[24];
+  GetViewPlanes(1.5, left);
+  GetViewPlanes(12.0, right);
+
+  vtkNew<vtkStreamingGeometryPriorityQueue> queue;
+  queue->SetController(NULL);
+  queue->Initialize(metadata.GetPointer());
+  TEST_ASSERT(queue->GetNumberOfBlocks() == 5,
+    "Wrong number of leaves: " << queue->GetNumberOfBlocks());
+
+  // The visible blocks come first, then the one without bounds.
+  std::vector<unsigned int> order;
+  queue->Update(left);
+  std::set<unsigned int> popped = PopAll(queue.GetPointer(), order);
+  TEST_ASSERT(order.size() == 3 && popped.count(0) && popped.count(1) &&
+    order[2] == 4, "Wrong blocks requested for the first view.");
+  TEST_ASSERT(queue->Pop() == VTK_UNSIGNED_INT_MAX,
+    "An empty queue returned a block.");
+
+  std::vector<unsigned int> sizes(3, 600);
+  sizes[2] = 100;
+  queue->MarkDelivered(order, sizes);
+  TEST_ASSERT(queue->GetNumberOfDeliveredBlocks() == 3 &&
+    queue->GetDeliveredMemorySize() == 1300,
+    "Wrong delivered blocks statistics.");
+
+  // Without a memory limit, nothing is purged when the view changes.
+  queue->Update(right);
+  TEST_ASSERT(queue->GetBlocksToPurge().empty(),
+    "Blocks purged without a memory limit.");
+
+  // With a 1 MiB limit, one of the blocks that left the view is purged. The
+  // block without bounds is never purged.
+  queue->SetMemoryLimit(1.0);
+  queue->Initialize(metadata.GetPointer());
+  queue->Update(left);
+  PopAll(queue.GetPointer(), order);
+  queue->MarkDelivered(order, sizes);
+  queue->Update(right);
+  std::set<unsigned int> purged = queue->GetBlocksToPurge();
+  TEST_ASSERT(purged.size() == 1 && (purged.count(0) || purged.count(1)),
+    "Wrong blocks purged for the second view.");
+  TEST_ASSERT(queue->GetDeliveredMemorySize() == 700,
+    "Wrong delivered memory after the purge: "
+    << queue->GetDeliveredMemorySize());
+  popped = PopAll(queue.GetPointer(), order);
+  TEST_ASSERT(popped.size() == 2 && popped.count(2) && popped.count(3),
+    "Wrong blocks requested for the second view.");
+
+  // Delivering more blocks purges the last block that left the view.
+  std::vector<unsigned int> visibleSizes(2, 600);
+  queue->MarkDelivered(order, visibleSizes);
+  queue->Update(right);
+  unsigned int remaining = purged.count(0)? 1 : 0;
+  TEST_ASSERT(queue->GetBlocksToPurge().size() == 1 &&
+    queue->GetBlocksToPurge().count(remaining),
+    "The last block out of the view was not purged.");
+
+  // Back to the first view, the blocks of the second view are purged and the
+  // blocks of the first view are requested again.
+  queue->Update(left);
+  purged = queue->GetBlocksToPurge();
+  TEST_ASSERT(purged.size() == 1 && (purged.count(2) || purged.count(3)),
+    "Wrong blocks purged when returning to the first view.");
+  popped = PopAll(queue.GetPointer(), order);
+  TEST_ASSERT(popped.size() == 2 && popped.count(0) && popped.count(1),
+    "The purged blocks were not requested again.");
+
+  // The visible blocks alone exceed the limit: streaming pauses, with a block
+  // still to request, until the view changes.
+  queue->Initialize(metadata.GetPointer());
+  queue->Update(left);
+  std::vector<unsigned int> first(1, queue->Pop());
+  queue->MarkDelivered(first, std::vector<unsigned int>(1, 1100));
+  queue->Update(left);
+  TEST_ASSERT(queue->IsEmpty() && queue->GetBlocksToPurge().empty() &&
+    queue->Pop() == VTK_UNSIGNED_INT_MAX,
+    "Streaming did not pause over the limit.");
+  queue->Update(right);
+  TEST_ASSERT(queue->GetBlocksToPurge().count(first[0]) && !queue->IsEmpty(),
+    "Streaming did not resume when the view changed.");
+
+  // Only the blocks this process can load are requested.
+  queue->SetMemoryLimit(0.0);
+  queue->AnyProcessCanLoadAnyBlockOff();
+  metadata->GetMetaData(1u)->Set(
+    vtkCompositeDataSet::CURRENT_PROCESS_CAN_LOAD_BLOCK(), 1);
+  queue->Initialize(metadata.GetPointer());
+  queue->Update(left);
+  PopAll(queue.GetPointer(), order);
+  TEST_ASSERT(order.size() == 1 && order[0] == 1,
+    "Blocks that cannot be loaded were requested.");
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,378 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    $RCSfile$
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkStreamingGeometryPriorityQueue.h"
+
+#include "vtkCompositeDataPipeline.h"
+#include "vtkDataObjectTreeIterator.h"
+#include "vtkInformation.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkMultiProcessController.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkStreamingPriorityQueue.h"
+#include "vtkUnsignedIntArray.h"
+
+#include <algorithm>
+#include <assert.h>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <set>
+#include <vector>
+
+class vtkStreamingGeometryPriorityQueue::vtkInternals
+{
+public:
+  struct vtkBlockInfo
+    {
+    unsigned int Identifier;
+    vtkBoundingBox Bounds;
+    bool CanLoad;
+    double Cost;
+    };
+
+  vtkSmartPointer<vtkMultiBlockDataSet> Metadata;
+  unsigned int NumberOfLeaves;
+  std::vector<vtkBlockInfo> Blocks;
+
+  std::deque<unsigned int> BlocksToRequest;
+  std::vector<unsigned int> EvictionCandidates;
+  std::set<unsigned int> BlocksToPurge;
+
+  // delivered blocks and their memory size in KiB.
+  std::map<unsigned int, unsigned int> DeliveredBlocks;
+  unsigned long DeliveredMemorySize;
+  bool OverMemoryLimit;
+
+  double PreviousViewPlanes[24];
+
+  vtkInternals() : NumberOfLeaves(0), DeliveredMemorySize(0),
+    OverMemoryLimit(false)
+    {
+    memset(this->PreviousViewPlanes, 0, sizeof(double)*24);
+    }
+  bool PlanesChanged(const double view_planes[24])
+    {
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable:4996)
+#endif
+    return !std::equal(this->PreviousViewPlanes, this->PreviousViewPlanes + 24, view_planes);
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+    }
+  void SetViewPlanes(const double view_planes[24])
+    {
+    std::copy(view_planes, view_planes + 24, this->PreviousViewPlanes);
+    }
+};
+
+vtkStandardNewMacro(vtkStreamingGeometryPriorityQueue);
+vtkCxxSetObjectMacro(vtkStreamingGeometryPriorityQueue, Controller, vtkMultiProcessController);
+//----------------------------------------------------------------------------
+vtkStreamingGeometryPriorityQueue::vtkStreamingGeometryPriorityQueue()
+{
+  this->Internals = new vtkInternals();
+  this->Controller = 0;
+  this->MemoryLimit = 0.0;
+  this->AnyProcessCanLoadAnyBlock = true;
+  this->SetController(vtkMultiProcessController::GetGlobalController());
+}
+
+//----------------------------------------------------------------------------
+vtkStreamingGeometryPriorityQueue::~vtkStreamingGeometryPriorityQueue()
+{
+  delete this->Internals;
+  this->Internals = 0;
+  this->SetController(0);
+}
+
+//----------------------------------------------------------------------------
+void vtkStreamingGeometryPriorityQueue::Initialize(vtkMultiBlockDataSet* metadata)
+{
+  delete this->Internals;
+  this->Internals = new vtkInternals();
+  this->Internals->Metadata = metadata;
+  if (!metadata)
+    {
+    return;
+    }
+
+  vtkSmartPointer<vtkDataObjectTreeIterator> iter;
+  iter.TakeReference(metadata->NewTreeIterator());
+  iter->SkipEmptyNodesOff();
+  iter->VisitOnlyLeavesOn();
+  iter->TraverseSubTreeOn();
+
+  unsigned int leaf_index = 0;
+  for (iter->InitTraversal(); !iter->IsDoneWithTraversal();
+    iter->GoToNextItem(), leaf_index++)
+    {
+    vtkInternals::vtkBlockInfo block;
+    block.Identifier = leaf_index;
+    block.CanLoad = this->AnyProcessCanLoadAnyBlock;
+    block.Cost = 0.0;
+    if (iter->HasCurrentMetaData())
+      {
+      vtkInformation* blockInfo = iter->GetCurrentMetaData();
+      if (blockInfo->Has(vtkStreamingDemandDrivenPipeline::BOUNDS()))
+        {
+        double bounds[6];
+        blockInfo->Get(vtkStreamingDemandDrivenPipeline::BOUNDS(), bounds);
+        block.Bounds.SetBounds(bounds);
+        }
+      if (blockInfo->Has(vtkCompositeDataPipeline::BLOCK_AMOUNT_OF_DETAIL()))
+        {
+        block.Cost = blockInfo->Get(
+          vtkCompositeDataPipeline::BLOCK_AMOUNT_OF_DETAIL());
+        }
+      if (!this->AnyProcessCanLoadAnyBlock)
+        {
+        block.CanLoad =
+          blockInfo->Has(vtkCompositeDataSet::CURRENT_PROCESS_CAN_LOAD_BLOCK()) &&
+          blockInfo->Get(vtkCompositeDataSet::CURRENT_PROCESS_CAN_LOAD_BLOCK()) != 0;
+        }
+      }
+    this->Internals->Blocks.push_back(block);
+    }
+  this->Internals->NumberOfLeaves = leaf_index;
+}
+
+//----------------------------------------------------------------------------
+void vtkStreamingGeometryPriorityQueue::UpdatePriorities(
+  const double view_planes[24])
+{
+  vtkInternals& internals = *this->Internals;
+
+  vtkStreamingPriorityQueue<> queue;
+  std::vector<unsigned int> unbounded;
+  for (std::vector<vtkInternals::vtkBlockInfo>::iterator iter =
+    internals.Blocks.begin(); iter != internals.Blocks.end(); ++iter)
+    {
+    if (!iter->Bounds.IsValid())
+      {
+      // blocks without bounds cannot be culled. They are requested after all
+      // the visible blocks and never evicted.
+      unbounded.push_back(iter->Identifier);
+      continue;
+      }
+    vtkStreamingPriorityQueueItem item;
+    item.Identifier = iter->Identifier;
+    item.Bounds = iter->Bounds;
+    item.Cost = iter->Cost;
+    queue.push(item);
+    }
+
+  double clamp_bounds[6];
+  vtkMath::UninitializeBounds(clamp_bounds);
+  queue.UpdatePriorities(view_planes, clamp_bounds);
+
+  internals.BlocksToRequest.clear();
+  internals.EvictionCandidates.clear();
+  for (; !queue.empty(); queue.pop())
+    {
+    const vtkStreamingPriorityQueueItem& item = queue.top();
+    bool delivered = internals.DeliveredBlocks.find(item.Identifier) !=
+      internals.DeliveredBlocks.end();
+    if (item.ScreenCoverage > 0)
+      {
+      if (!delivered && internals.Blocks[item.Identifier].CanLoad)
+        {
+        internals.BlocksToRequest.push_back(item.Identifier);
+        }
+      }
+    else if (delivered)
+      {
+      internals.EvictionCandidates.push_back(item.Identifier);
+      }
+    }
+
+  for (std::vector<unsigned int>::iterator iter = unbounded.begin();
+    iter != unbounded.end(); ++iter)
+    {
+    if (internals.Blocks[*iter].CanLoad &&
+      internals.DeliveredBlocks.find(*iter) == internals.DeliveredBlocks.end())
+      {
+      internals.BlocksToRequest.push_back(*iter);
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkStreamingGeometryPriorityQueue::UpdateBlocksToPurge()
+{
+  vtkInternals& internals = *this->Internals;
+  internals.BlocksToPurge.clear();
+  internals.OverMemoryLimit = false;
+  if (this->MemoryLimit <= 0.0)
+    {
+    return;
+    }
+
+  const double limit = this->MemoryLimit * 1024.0;
+  for (std::vector<unsigned int>::iterator iter =
+    internals.EvictionCandidates.begin();
+    iter != internals.EvictionCandidates.end() &&
+    internals.DeliveredMemorySize > limit; ++iter)
+    {
+    std::map<unsigned int, unsigned int>::iterator diter =
+      internals.DeliveredBlocks.find(*iter);
+    if (diter != internals.DeliveredBlocks.end())
+      {
+      internals.DeliveredMemorySize -= diter->second;
+      internals.DeliveredBlocks.erase(diter);
+      internals.BlocksToPurge.insert(*iter);
+      }
+    }
+
+  // if the visible blocks alone exceed the limit, stop requesting blocks till
+  // the view changes.
+  internals.OverMemoryLimit = (internals.DeliveredMemorySize >= limit);
+}
+
+//----------------------------------------------------------------------------
+void vtkStreamingGeometryPriorityQueue::Update(const double view_planes[24])
+{
+  this->Internals->BlocksToPurge.clear();
+  if (!this->Internals->Metadata)
+    {
+    return;
+    }
+
+  if (this->Internals->PlanesChanged(view_planes))
+    {
+    this->UpdatePriorities(view_planes);
+    this->Internals->SetViewPlanes(view_planes);
+    }
+  this->UpdateBlocksToPurge();
+}
+
+//----------------------------------------------------------------------------
+bool vtkStreamingGeometryPriorityQueue::IsEmpty()
+{
+  return this->Internals->BlocksToRequest.empty() ||
+    this->Internals->OverMemoryLimit;
+}
+
+//----------------------------------------------------------------------------
+unsigned int vtkStreamingGeometryPriorityQueue::Pop()
+{
+  if (this->IsEmpty())
+    {
+    return VTK_UNSIGNED_INT_MAX;
+    }
+
+  std::deque<unsigned int>& blocksToRequest = this->Internals->BlocksToRequest;
+  if (this->AnyProcessCanLoadAnyBlock && this->Controller)
+    {
+    // all processes have the same queue; pop one block for each process.
+    int myid = this->Controller->GetLocalProcessId();
+    int num_ranks = this->Controller->GetNumberOfProcesses();
+    unsigned int item = VTK_UNSIGNED_INT_MAX;
+    for (int cc=0; cc < num_ranks && !blocksToRequest.empty(); cc++)
+      {
+      if (cc == myid)
+        {
+        item = blocksToRequest.front();
+        }
+      blocksToRequest.pop_front();
+      }
+    return item;
+    }
+
+  unsigned int item = blocksToRequest.front();
+  blocksToRequest.pop_front();
+  return item;
+}
+
+//----------------------------------------------------------------------------
+void vtkStreamingGeometryPriorityQueue::MarkDelivered(
+  const std::vector<unsigned int>& ids, const std::vector<unsigned int>& sizes)
+{
+  assert(ids.size() == sizes.size());
+
+  vtkNew<vtkUnsignedIntArray> localDelivered;
+  localDelivered->SetNumberOfComponents(2);
+  localDelivered->SetNumberOfTuples(static_cast<vtkIdType>(ids.size()));
+  for (size_t cc=0; cc < ids.size(); cc++)
+    {
+    localDelivered->SetValue(static_cast<vtkIdType>(2*cc), ids[cc]);
+    localDelivered->SetValue(static_cast<vtkIdType>(2*cc + 1), sizes[cc]);
+    }
+
+  vtkSmartPointer<vtkUnsignedIntArray> delivered = localDelivered.GetPointer();
+  if (this->Controller && this->Controller->GetNumberOfProcesses() > 1)
+    {
+    delivered = vtkSmartPointer<vtkUnsignedIntArray>::New();
+    delivered->SetNumberOfComponents(2);
+    this->Controller->AllGatherV(localDelivered.GetPointer(), delivered);
+    }
+
+  vtkInternals& internals = *this->Internals;
+  for (vtkIdType cc=0; cc < delivered->GetNumberOfTuples(); cc++)
+    {
+    unsigned int id = delivered->GetValue(2*cc);
+    unsigned int size = delivered->GetValue(2*cc + 1);
+    std::map<unsigned int, unsigned int>::iterator iter =
+      internals.DeliveredBlocks.find(id);
+    if (iter != internals.DeliveredBlocks.end())
+      {
+      internals.DeliveredMemorySize -= iter->second;
+      }
+    internals.DeliveredBlocks[id] = size;
+    internals.DeliveredMemorySize += size;
+    }
+}
+
+//----------------------------------------------------------------------------
+const std::set<unsigned int>& vtkStreamingGeometryPriorityQueue::GetBlocksToPurge() const
+{
+  return this->Internals->BlocksToPurge;
+}
+
+//----------------------------------------------------------------------------
+unsigned int vtkStreamingGeometryPriorityQueue::GetNumberOfBlocks()
+{
+  return this->Internals->NumberOfLeaves;
+}
+
+//----------------------------------------------------------------------------
+unsigned int vtkStreamingGeometryPriorityQueue::GetNumberOfDeliveredBlocks()
+{
+  return static_cast<unsigned int>(this->Internals->DeliveredBlocks.size());
+}
+
+//----------------------------------------------------------------------------
+unsigned long vtkStreamingGeometryPriorityQueue::GetDeliveredMemorySize()
+{
+  return this->Internals->DeliveredMemorySize;
+}
+
+//----------------------------------------------------------------------------
+void vtkStreamingGeometryPriorityQueue::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "Controller: " << this->Controller << endl;
+  os << indent << "MemoryLimit: " << this->MemoryLimit << endl;
+  os << indent << "AnyProcessCanLoadAnyBlock: "
+     << this->AnyProcessCanLoadAnyBlock << endl;
+  os << indent << "NumberOfBlocks: " << this->GetNumberOfBlocks() << endl;
+  os << indent << "NumberOfDeliveredBlocks: "
+     << this->GetNumberOfDeliveredBlocks() << endl;
+  os << indent << "DeliveredMemorySize: "
+     << this->GetDeliveredMemorySize() << endl;
+}
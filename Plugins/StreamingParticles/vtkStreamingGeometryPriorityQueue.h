@@ -0,0 +1,146 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    $RCSfile$
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkStreamingGeometryPriorityQueue - view-based priority queue for
+// streaming the leaves of an arbitrary vtkMultiBlockDataSet.
+// .SECTION Description
+// vtkStreamingGeometryPriorityQueue is used by
+// vtkStreamingGeometryRepresentation to determine the order in which to
+// request the blocks of a multiblock dataset. Unlike
+// vtkStreamingParticlesPriorityQueue, it makes no assumptions about the
+// structure of the multiblock: every leaf in the meta-data that provides
+// vtkStreamingDemandDrivenPipeline::BOUNDS() is a candidate block, identified
+// by its leaf index (the index of the leaf in a depth-first traversal that
+// includes empty leaves).
+//
+// Blocks inside the view frustum are requested in order of decreasing screen
+// coverage. The queue also keeps track of the blocks delivered so far and
+// their memory footprint. When the delivered blocks exceed MemoryLimit, blocks
+// that are no longer inside the view frustum are reported in
+// GetBlocksToPurge(). If the blocks inside the view frustum alone exceed the
+// limit, no more blocks are requested until the view changes.
+//
+// All bookkeeping is global: so long as Initialize(), Update(), Pop() and
+// MarkDelivered() are called on all processes with the same meta-data and view
+// planes, all processes agree on the blocks to purge.
+// .SECTION See Also
+// vtkStreamingGeometryRepresentation, vtkStreamingParticlesPriorityQueue
+
+#ifndef vtkStreamingGeometryPriorityQueue_h
+#define vtkStreamingGeometryPriorityQueue_h
+
+#include "vtkObject.h"
+#include <set> // needed for set
+#include <vector> // needed for vector
+
+class vtkMultiBlockDataSet;
+class vtkMultiProcessController;
+
+class vtkStreamingGeometryPriorityQueue : public vtkObject
+{
+public:
+  static vtkStreamingGeometryPriorityQueue* New();
+  vtkTypeMacro(vtkStreamingGeometryPriorityQueue, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Controller used to distribute the blocks among processes and to share the
+  // delivered blocks information. By default, this is set to the
+  // vtkMultiProcessController::GetGlobalController().
+  void SetController(vtkMultiProcessController*);
+  vtkGetObjectMacro(Controller, vtkMultiProcessController);
+
+  // Description:
+  // Initializes the queue. All information about delivered blocks is lost.
+  // Only the meta-data is looked at i.e. none of the heavy data is tested.
+  void Initialize(vtkMultiBlockDataSet* metadata);
+
+  // Description:
+  // Updates the priorities of blocks based on the new view frustum planes and
+  // determines the blocks to purge. Blocks already delivered are not
+  // reinserted in the queue.
+  void Update(const double view_planes[24]);
+
+  // Description:
+  // Returns true if there are no blocks to request on this process, either
+  // because all visible blocks have been delivered or because the memory
+  // limit has been reached.
+  bool IsEmpty();
+
+  // Description:
+  // Pops and returns the leaf index for the next block to request on this
+  // process. Returns VTK_UNSIGNED_INT_MAX if there's no block to request.
+  // When AnyProcessCanLoadAnyBlock is true, each call pops one block for each
+  // process, hence it must be called the same number of times on all
+  // processes.
+  unsigned int Pop();
+
+  // Description:
+  // Must be called on all processes after the blocks popped in the current
+  // pass have been produced, providing the leaf indices and the memory size
+  // (in kibibytes) for blocks produced by this process.
+  void MarkDelivered(const std::vector<unsigned int>& ids,
+    const std::vector<unsigned int>& sizes);
+
+  // Description:
+  // After every Update() call, returns the list of delivered blocks that
+  // should be purged to remain within the MemoryLimit.
+  const std::set<unsigned int>& GetBlocksToPurge() const;
+
+  // Description:
+  // Limit, in megabytes, for the memory used by all the delivered blocks. 0
+  // (default) implies no limit.
+  vtkSetClampMacro(MemoryLimit, double, 0.0, VTK_DOUBLE_MAX);
+  vtkGetMacro(MemoryLimit, double);
+
+  // Description:
+  // If true (default), blocks are distributed among the processes in a
+  // round-robin fashion. Otherwise only blocks with
+  // vtkCompositeDataSet::CURRENT_PROCESS_CAN_LOAD_BLOCK set in the meta-data
+  // are requested on a process.
+  vtkGetMacro(AnyProcessCanLoadAnyBlock, bool);
+  vtkSetMacro(AnyProcessCanLoadAnyBlock, bool);
+  vtkBooleanMacro(AnyProcessCanLoadAnyBlock, bool);
+
+  // Description:
+  // Streaming progress statistics.
+  unsigned int GetNumberOfBlocks();
+  unsigned int GetNumberOfDeliveredBlocks();
+  unsigned long GetDeliveredMemorySize();
+
+protected:
+  vtkStreamingGeometryPriorityQueue();
+  ~vtkStreamingGeometryPriorityQueue();
+
+  // Description:
+  // Recomputes the blocks to request and the eviction candidates for the view.
+  void UpdatePriorities(const double view_planes[24]);
+
+  // Description:
+  // Fills BlocksToPurge from the eviction candidates.
+  void UpdateBlocksToPurge();
+
+  vtkMultiProcessController* Controller;
+  double MemoryLimit;
+  bool AnyProcessCanLoadAnyBlock;
+
+private:
+  vtkStreamingGeometryPriorityQueue(const vtkStreamingGeometryPriorityQueue&) VTK_DELETE_FUNCTION;
+  void operator=(const vtkStreamingGeometryPriorityQueue&) VTK_DELETE_FUNCTION;
+
+  class vtkInternals;
+  vtkInternals* Internals;
+};
+
+#endif
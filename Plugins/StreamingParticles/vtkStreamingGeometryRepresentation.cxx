@@ -0,0 +1,640 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    $RCSfile$
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkStreamingGeometryRepresentation.h"
+
+#include "vtkAlgorithmOutput.h"
+#include "vtkAppendCompositeDataLeaves.h"
+#include "vtkCompositeDataPipeline.h"
+#include "vtkCompositePolyDataMapper2.h"
+#include "vtkDataObjectTreeIterator.h"
+#include "vtkFieldData.h"
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkMultiProcessController.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkProperty.h"
+#include "vtkPVGeometryFilter.h"
+#include "vtkPVLODActor.h"
+#include "vtkPVRenderView.h"
+#include "vtkPVStreamingMacros.h"
+#include "vtkRenderer.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkStreamingGeometryPriorityQueue.h"
+#include "vtkUnsignedIntArray.h"
+
+#include <assert.h>
+#include <map>
+#include <set>
+
+static char const BLOCKS_TO_PURGE_ARRAY_NAME[] = "__blocks_to_purge";
+
+namespace
+{
+  // Returns a tree iterator that visits all leaves, including empty ones, so
+  // that the leaf index matches the one used by
+  // vtkStreamingGeometryPriorityQueue.
+  vtkDataObjectTreeIterator* NewLeafIterator(vtkMultiBlockDataSet* data)
+    {
+    vtkDataObjectTreeIterator* iter = data->NewTreeIterator();
+    iter->SkipEmptyNodesOff();
+    iter->VisitOnlyLeavesOn();
+    iter->TraverseSubTreeOn();
+    return iter;
+    }
+
+  void PurgeBlocks(vtkMultiBlockDataSet* data,
+    const std::set<unsigned int>& blocksToPurge)
+    {
+    vtkSmartPointer<vtkDataObjectTreeIterator> iter;
+    iter.TakeReference(NewLeafIterator(data));
+    unsigned int leaf_index = 0;
+    for (iter->InitTraversal(); !iter->IsDoneWithTraversal();
+      iter->GoToNextItem(), leaf_index++)
+      {
+      if (blocksToPurge.find(leaf_index) != blocksToPurge.end())
+        {
+        data->SetDataSet(iter, NULL);
+        }
+      }
+    }
+}
+
+vtkStandardNewMacro(vtkStreamingGeometryRepresentation);
+//----------------------------------------------------------------------------
+vtkStreamingGeometryRepresentation::vtkStreamingGeometryRepresentation()
+{
+  this->StreamingCapablePipeline = false;
+  this->InStreamingUpdate = false;
+  this->UseOutline = false;
+  this->StreamingRequestSize = 4;
+
+  this->PriorityQueue = vtkSmartPointer<vtkStreamingGeometryPriorityQueue>::New();
+  this->Mapper = vtkSmartPointer<vtkCompositePolyDataMapper2>::New();
+
+  this->Actor = vtkSmartPointer<vtkPVLODActor>::New();
+  this->Actor->SetMapper(this->Mapper);
+  this->Actor->SetPickable(0);
+}
+
+//----------------------------------------------------------------------------
+vtkStreamingGeometryRepresentation::~vtkStreamingGeometryRepresentation()
+{
+}
+
+//----------------------------------------------------------------------------
+void vtkStreamingGeometryRepresentation::SetVisibility(bool val)
+{
+  this->Actor->SetVisibility(val);
+  this->Superclass::SetVisibility(val);
+}
+
+//----------------------------------------------------------------------------
+void vtkStreamingGeometryRepresentation::SetMemoryLimit(double val)
+{
+  if (val != this->PriorityQueue->GetMemoryLimit())
+    {
+    // the limit is applied on the next streaming pass, there's no need to
+    // re-execute the representation.
+    this->PriorityQueue->SetMemoryLimit(val);
+    }
+}
+
+//----------------------------------------------------------------------------
+double vtkStreamingGeometryRepresentation::GetMemoryLimit()
+{
+  return this->PriorityQueue->GetMemoryLimit();
+}
+
+//----------------------------------------------------------------------------
+void vtkStreamingGeometryRepresentation::SetProcessesCanLoadAnyBlock(bool newVal)
+{
+  if (newVal != this->PriorityQueue->GetAnyProcessCanLoadAnyBlock())
+    {
+    this->PriorityQueue->SetAnyProcessCanLoadAnyBlock(newVal);
+    this->MarkModified();
+    }
+}
+
+//----------------------------------------------------------------------------
+bool vtkStreamingGeometryRepresentation::GetProcessesCanLoadAnyBlock()
+{
+  return this->PriorityQueue->GetAnyProcessCanLoadAnyBlock();
+}
+
+//----------------------------------------------------------------------------
+unsigned int vtkStreamingGeometryRepresentation::GetNumberOfBlocks()
+{
+  return this->PriorityQueue->GetNumberOfBlocks();
+}
+
+//----------------------------------------------------------------------------
+unsigned int vtkStreamingGeometryRepresentation::GetNumberOfStreamedBlocks()
+{
+  return this->PriorityQueue->GetNumberOfDeliveredBlocks();
+}
+
+//----------------------------------------------------------------------------
+unsigned long vtkStreamingGeometryRepresentation::GetStreamedMemorySize()
+{
+  return this->PriorityQueue->GetDeliveredMemorySize();
+}
+
+//----------------------------------------------------------------------------
+int vtkStreamingGeometryRepresentation::ProcessViewRequest(
+  vtkInformationRequestKey* request_type, vtkInformation* inInfo, vtkInformation* outInfo)
+{
+  // always forward to superclass first. Superclass returns 0 if the
+  // representation is not visible (among other things). In which case there's
+  // nothing to do.
+  if (!this->Superclass::ProcessViewRequest(request_type, inInfo, outInfo))
+    {
+    return 0;
+    }
+
+  if (request_type == vtkPVView::REQUEST_UPDATE())
+    {
+    vtkPVRenderView::SetPiece(inInfo, this, this->ProcessedData);
+    double bounds[6];
+    this->DataBounds.GetBounds(bounds);
+    vtkPVRenderView::SetGeometryBounds(inInfo, bounds);
+    vtkPVRenderView::SetStreamable(inInfo, this, this->GetStreamingCapablePipeline());
+    }
+  else if (request_type == vtkPVView::REQUEST_RENDER())
+    {
+    if (this->RenderedData == NULL)
+      {
+      vtkStreamingStatusMacro(<< this << ": cloning delivered data.");
+      vtkAlgorithmOutput* producerPort = vtkPVRenderView::GetPieceProducer(inInfo, this);
+      vtkAlgorithm* producer = producerPort->GetProducer();
+
+      this->RenderedData =
+        producer->GetOutputDataObject(producerPort->GetIndex());
+      this->Mapper->SetInputDataObject(this->RenderedData);
+      }
+    }
+  else if (request_type == vtkPVRenderView::REQUEST_STREAMING_UPDATE())
+    {
+    if (this->GetStreamingCapablePipeline())
+      {
+      double view_planes[24];
+      inInfo->Get(vtkPVRenderView::VIEW_PLANES(), view_planes);
+      if (this->StreamingUpdate(view_planes))
+        {
+        vtkPVRenderView::SetNextStreamedPiece(
+          inInfo, this, this->ProcessedPiece);
+        }
+      }
+    }
+  else if (request_type == vtkPVRenderView::REQUEST_PROCESS_STREAMED_PIECE())
+    {
+    vtkDataObject* piece = vtkPVRenderView::GetCurrentStreamedPiece(inInfo, this);
+    vtkMultiBlockDataSet* data =
+      vtkMultiBlockDataSet::SafeDownCast(this->RenderedData);
+    if (piece && piece->IsA("vtkMultiBlockDataSet") && data)
+      {
+      vtkStreamingStatusMacro( << this << ": received new piece.");
+
+      vtkUnsignedIntArray* array = vtkUnsignedIntArray::SafeDownCast(
+        piece->GetFieldData()->GetArray(BLOCKS_TO_PURGE_ARRAY_NAME));
+      if (array != NULL)
+        {
+        std::set<unsigned int> blocksToPurge;
+        for (vtkIdType cc=0; cc < array->GetNumberOfTuples(); ++cc)
+          {
+          blocksToPurge.insert(array->GetValue(cc));
+          }
+        piece->GetFieldData()->RemoveArray(BLOCKS_TO_PURGE_ARRAY_NAME);
+        PurgeBlocks(data, blocksToPurge);
+        }
+
+      // merge with what we are already rendering.
+      vtkNew<vtkAppendCompositeDataLeaves> appender;
+      appender->AddInputDataObject(piece);
+      appender->AddInputDataObject(data);
+      appender->Update();
+
+      this->RenderedData = appender->GetOutputDataObject(0);
+      this->Mapper->SetInputDataObject(this->RenderedData);
+      }
+    }
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkStreamingGeometryRepresentation::RequestInformation(vtkInformation *rqst,
+    vtkInformationVector **inputVector,
+    vtkInformationVector *outputVector)
+{
+  // A pipeline is streaming capable if it provides us with
+  // COMPOSITE_DATA_META_DATA() in the RequestInformation() pass.
+  this->StreamingCapablePipeline = false;
+  if (inputVector[0]->GetNumberOfInformationObjects() == 1)
+    {
+    vtkInformation* inInfo = inputVector[0]->GetInformationObject(0);
+    if (inInfo->Has(vtkCompositeDataPipeline::COMPOSITE_DATA_META_DATA()) &&
+      vtkPVView::GetEnableStreaming())
+      {
+      this->StreamingCapablePipeline = true;
+      }
+    }
+
+  vtkStreamingStatusMacro(
+    << this << ": streaming capable input pipeline? "
+    << (this->StreamingCapablePipeline? "yes" : "no"));
+  return this->Superclass::RequestInformation(rqst, inputVector, outputVector);
+}
+
+//----------------------------------------------------------------------------
+int vtkStreamingGeometryRepresentation::RequestUpdateExtent(
+  vtkInformation* request,
+  vtkInformationVector** inputVector,
+  vtkInformationVector* outputVector)
+{
+  if (!this->Superclass::RequestUpdateExtent(request, inputVector,
+      outputVector))
+    {
+    return 0;
+    }
+
+  for (int cc=0; cc < this->GetNumberOfInputPorts(); cc++)
+    {
+    for (int kk=0; kk < inputVector[cc]->GetNumberOfInformationObjects(); kk++)
+      {
+      vtkInformation* info = inputVector[cc]->GetInformationObject(kk);
+      if (this->InStreamingUpdate)
+        {
+        assert(this->StreamingRequest.size() > 0);
+
+        // Request the next "group of blocks" to stream.
+        info->Set(vtkCompositeDataPipeline::LOAD_REQUESTED_BLOCKS(), 1);
+        info->Set(vtkCompositeDataPipeline::UPDATE_COMPOSITE_INDICES(),
+          &this->StreamingRequest[0],
+          static_cast<int>(this->StreamingRequest.size()));
+        }
+      else if (this->StreamingCapablePipeline)
+        {
+        // don't load any blocks in the first pass; the meta-data provides
+        // the bounds and the blocks are streamed in afterwards.
+        int none = 0;
+        info->Set(vtkCompositeDataPipeline::LOAD_REQUESTED_BLOCKS(), 1);
+        info->Set(vtkCompositeDataPipeline::UPDATE_COMPOSITE_INDICES(),
+          &none, 0);
+        }
+      else
+        {
+        info->Remove(vtkCompositeDataPipeline::LOAD_REQUESTED_BLOCKS());
+        info->Remove(vtkCompositeDataPipeline::UPDATE_COMPOSITE_INDICES());
+        }
+      }
+    }
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkStreamingGeometryRepresentation::RequestData(vtkInformation *rqst,
+  vtkInformationVector **inputVector, vtkInformationVector *outputVector)
+{
+  vtkMultiBlockDataSet* metadata = NULL;
+  if (inputVector[0]->GetNumberOfInformationObjects() == 1)
+    {
+    vtkInformation* inInfo = inputVector[0]->GetInformationObject(0);
+    if (inInfo->Has(vtkCompositeDataPipeline::COMPOSITE_DATA_META_DATA()) &&
+      this->GetStreamingCapablePipeline() &&
+      !this->GetInStreamingUpdate())
+      {
+      // Since the representation reexecuted, it means that the input changed
+      // and we should initialize our streaming.
+      metadata = vtkMultiBlockDataSet::SafeDownCast(
+        inInfo->Get(vtkCompositeDataPipeline::COMPOSITE_DATA_META_DATA()));
+      this->PriorityQueue->Initialize(metadata);
+      }
+    }
+
+  this->ProcessedPiece = 0;
+  if (inputVector[0]->GetNumberOfInformationObjects() == 1)
+    {
+    vtkNew<vtkPVGeometryFilter> geomFilter;
+    geomFilter->SetUseOutline(this->UseOutline? 1 : 0);
+    geomFilter->SetController(NULL);
+
+    vtkDataObject* input = vtkDataObject::GetData(inputVector[0], 0);
+    geomFilter->SetInputData(input);
+    geomFilter->Update();
+    if (!this->GetInStreamingUpdate())
+      {
+      vtkDataObject* output = geomFilter->GetOutputDataObject(0);
+      if (!output->IsA("vtkMultiBlockDataSet"))
+        {
+        vtkNew<vtkMultiBlockDataSet> mb;
+        mb->SetBlock(0, output);
+        this->ProcessedData = mb.GetPointer();
+        }
+      else
+        {
+        this->ProcessedData = vtkMultiBlockDataSet::SafeDownCast(output);
+        }
+      assert(this->ProcessedData.GetPointer());
+
+      // Collect data bounds. When streaming, no blocks have been loaded yet
+      // so use the bounds from the meta-data.
+      this->DataBounds.Reset();
+      vtkSmartPointer<vtkDataObjectTreeIterator> iter;
+      if (metadata)
+        {
+        iter.TakeReference(NewLeafIterator(metadata));
+        for (iter->InitTraversal(); !iter->IsDoneWithTraversal(); iter->GoToNextItem())
+          {
+          if (iter->HasCurrentMetaData() && iter->GetCurrentMetaData()->Has(
+              vtkStreamingDemandDrivenPipeline::BOUNDS()))
+            {
+            double bounds[6];
+            iter->GetCurrentMetaData()->Get(
+              vtkStreamingDemandDrivenPipeline::BOUNDS(), bounds);
+            this->DataBounds.AddBounds(bounds);
+            }
+          }
+        }
+      iter.TakeReference(this->ProcessedData->NewTreeIterator());
+      for (iter->InitTraversal(); !iter->IsDoneWithTraversal(); iter->GoToNextItem())
+        {
+        vtkDataSet* ds = vtkDataSet::SafeDownCast(iter->GetCurrentDataObject());
+        if (ds)
+          {
+          this->DataBounds.AddBounds(ds->GetBounds());
+          }
+        }
+      }
+    else
+      {
+      this->ProcessedPiece = geomFilter->GetOutputDataObject(0);
+      }
+    }
+  else
+    {
+    // create an empty dataset. This is needed so that view knows what dataset
+    // to expect from the other processes on this node.
+    this->ProcessedData = vtkSmartPointer<vtkMultiBlockDataSet>::New();
+    this->DataBounds.Reset();
+    }
+
+  if (!this->GetInStreamingUpdate())
+    {
+    this->RenderedData = 0;
+
+    // provide the mapper with an empty input. This is needed only because
+    // mappers die when input is NULL, currently.
+    vtkNew<vtkMultiBlockDataSet> tmp;
+    this->Mapper->SetInputDataObject(tmp.GetPointer());
+    }
+
+  return this->Superclass::RequestData(rqst, inputVector, outputVector);
+}
+
+//----------------------------------------------------------------------------
+bool vtkStreamingGeometryRepresentation::StreamingUpdate(const double view_planes[24])
+{
+  assert(this->InStreamingUpdate == false);
+
+  // Update the priorities and determine the blocks to purge. The purge list
+  // is the same on all processes.
+  this->PriorityQueue->Update(view_planes);
+  const std::set<unsigned int>& toPurge = this->PriorityQueue->GetBlocksToPurge();
+
+  vtkMultiProcessController* controller = this->PriorityQueue->GetController();
+  int needsToStream = this->PriorityQueue->IsEmpty()? 0 : 1;
+  int anyNeedsToStream = needsToStream;
+  if (controller)
+    {
+    controller->AllReduce(&needsToStream, &anyNeedsToStream, 1,
+      vtkCommunicator::LOGICAL_OR_OP);
+    }
+  if (!anyNeedsToStream && toPurge.empty())
+    {
+    return false;
+    }
+
+  if (needsToStream && this->DetermineBlocksToStream())
+    {
+    this->InStreamingUpdate = true;
+    vtkStreamingStatusMacro(<< this << ": doing streaming-update.");
+
+    // This ensure that the representation re-executes.
+    this->MarkModified();
+
+    // Execute the pipeline.
+    this->Update();
+    this->InStreamingUpdate = false;
+    }
+  else
+    {
+    // nothing to stream on this process in this pass, however, we still need
+    // to deliver a piece since other processes may be delivering theirs.
+    this->StreamingRequest.clear();
+    vtkNew<vtkMultiBlockDataSet> clone;
+    clone->CopyStructure(this->ProcessedData);
+    this->ProcessedPiece = clone.GetPointer();
+    }
+  assert(this->ProcessedPiece != NULL);
+
+  this->MarkStreamedBlocksDelivered();
+
+  if (!toPurge.empty() &&
+    (controller == NULL || controller->GetLocalProcessId() == 0))
+    {
+    vtkNew<vtkUnsignedIntArray> purgeArray;
+    purgeArray->SetName(BLOCKS_TO_PURGE_ARRAY_NAME);
+    purgeArray->SetNumberOfTuples(static_cast<vtkIdType>(toPurge.size()));
+    vtkIdType index = 0;
+    for (std::set<unsigned int>::const_iterator iter = toPurge.begin();
+      iter != toPurge.end(); ++iter, ++index)
+      {
+      purgeArray->SetValue(index, *iter);
+      }
+    this->ProcessedPiece->GetFieldData()->AddArray(purgeArray.GetPointer());
+    }
+
+  vtkStreamingStatusMacro(<< this << ": streamed "
+    << this->GetNumberOfStreamedBlocks() << "/" << this->GetNumberOfBlocks()
+    << " blocks (" << this->GetStreamedMemorySize() << " KiB), purged "
+    << toPurge.size() << ".");
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkStreamingGeometryRepresentation::DetermineBlocksToStream()
+{
+  assert(this->StreamingRequestSize > 0);
+  this->StreamingRequest.clear();
+
+  for (int jj=0; jj < this->StreamingRequestSize; jj++)
+    {
+    unsigned int cid = this->PriorityQueue->Pop();
+    if (cid != VTK_UNSIGNED_INT_MAX)
+      {
+      vtkStreamingStatusMacro(<< this << ": requesting blocks: " << cid);
+      this->StreamingRequest.push_back(static_cast<int>(cid));
+      }
+    }
+  return this->StreamingRequest.size() > 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkStreamingGeometryRepresentation::MarkStreamedBlocksDelivered()
+{
+  std::map<unsigned int, unsigned int> sizes;
+  vtkMultiBlockDataSet* piece =
+    vtkMultiBlockDataSet::SafeDownCast(this->ProcessedPiece);
+  if (piece && !this->StreamingRequest.empty())
+    {
+    vtkSmartPointer<vtkDataObjectTreeIterator> iter;
+    iter.TakeReference(NewLeafIterator(piece));
+    unsigned int leaf_index = 0;
+    for (iter->InitTraversal(); !iter->IsDoneWithTraversal();
+      iter->GoToNextItem(), leaf_index++)
+      {
+      if (vtkDataObject* dobj = iter->GetCurrentDataObject())
+        {
+        sizes[leaf_index] = dobj->GetActualMemorySize();
+        }
+      }
+    }
+
+  // blocks that produced no geometry are still delivered, with a size of 0.
+  std::vector<unsigned int> ids;
+  std::vector<unsigned int> memory;
+  for (std::vector<int>::iterator iter = this->StreamingRequest.begin();
+    iter != this->StreamingRequest.end(); ++iter)
+    {
+    unsigned int id = static_cast<unsigned int>(*iter);
+    ids.push_back(id);
+    memory.push_back(sizes.find(id) != sizes.end()? sizes[id] : 0);
+    }
+  this->PriorityQueue->MarkDelivered(ids, memory);
+}
+
+//----------------------------------------------------------------------------
+int vtkStreamingGeometryRepresentation::FillInputPortInformation(
+  int vtkNotUsed(port), vtkInformation* info)
+{
+  info->Set(vtkAlgorithm::INPUT_REQUIRED_DATA_TYPE(), "vtkCompositeDataSet");
+  info->Append(vtkAlgorithm::INPUT_REQUIRED_DATA_TYPE(), "vtkDataSet");
+
+  // Saying INPUT_IS_OPTIONAL() is essential, since representations don't have
+  // any inputs on client-side (in client-server, client-render-server mode) and
+  // render-server-side (in client-render-server mode).
+  info->Set(vtkAlgorithm::INPUT_IS_OPTIONAL(), 1);
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+bool vtkStreamingGeometryRepresentation::AddToView(vtkView* view)
+{
+  vtkPVRenderView* rview = vtkPVRenderView::SafeDownCast(view);
+  if (rview)
+    {
+    rview->GetRenderer()->AddActor(this->Actor);
+    return this->Superclass::AddToView(view);
+    }
+  return false;
+}
+
+//----------------------------------------------------------------------------
+bool vtkStreamingGeometryRepresentation::RemoveFromView(vtkView* view)
+{
+  vtkPVRenderView* rview = vtkPVRenderView::SafeDownCast(view);
+  if (rview)
+    {
+    rview->GetRenderer()->RemoveActor(this->Actor);
+    return this->Superclass::RemoveFromView(view);
+    }
+  return false;
+}
+
+//----------------------------------------------------------------------------
+void vtkStreamingGeometryRepresentation::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "StreamingCapablePipeline: " << this->StreamingCapablePipeline << endl;
+  os << indent << "UseOutline: " << this->UseOutline << endl;
+  os << indent << "StreamingRequestSize: " << this->StreamingRequestSize << endl;
+  os << indent << "PriorityQueue: " << endl;
+  this->PriorityQueue->PrintSelf(os, indent.GetNextIndent());
+}
+
+//----------------------------------------------------------------------------
+void vtkStreamingGeometryRepresentation::SetInputArrayToProcess(
+  int idx, int port, int connection, int fieldAssociation, const char *name)
+{
+  this->Superclass::SetInputArrayToProcess(
+    idx, port, connection, fieldAssociation, name);
+
+  if (name && name[0])
+    {
+    this->Mapper->SetScalarVisibility(1);
+    this->Mapper->SelectColorArray(name);
+    this->Mapper->SetUseLookupTableScalarRange(1);
+    }
+  else
+    {
+    this->Mapper->SetScalarVisibility(0);
+    this->Mapper->SelectColorArray(static_cast<const char*>(NULL));
+    }
+
+  switch (fieldAssociation)
+    {
+  case vtkDataObject::FIELD_ASSOCIATION_CELLS:
+    this->Mapper->SetScalarMode(VTK_SCALAR_MODE_USE_CELL_FIELD_DATA);
+    break;
+
+  case vtkDataObject::FIELD_ASSOCIATION_POINTS:
+  default:
+    this->Mapper->SetScalarMode(VTK_SCALAR_MODE_USE_POINT_FIELD_DATA);
+    break;
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkStreamingGeometryRepresentation::SetLookupTable(vtkScalarsToColors* lut)
+{
+  this->Mapper->SetLookupTable(lut);
+}
+
+//----------------------------------------------------------------------------
+void vtkStreamingGeometryRepresentation::SetOpacity(double val)
+{
+  this->Actor->GetProperty()->SetOpacity(val);
+}
+
+//----------------------------------------------------------------------------
+void vtkStreamingGeometryRepresentation::SetPointSize(double val)
+{
+  this->Actor->GetProperty()->SetPointSize(val);
+}
+
+//----------------------------------------------------------------------------
+void vtkStreamingGeometryRepresentation::SetLineWidth(double val)
+{
+  this->Actor->GetProperty()->SetLineWidth(val);
+}
+
+//----------------------------------------------------------------------------
+void vtkStreamingGeometryRepresentation::SetRepresentation(int val)
+{
+  this->Actor->GetProperty()->SetRepresentation(val);
+}
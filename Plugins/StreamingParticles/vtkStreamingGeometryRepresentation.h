@@ -0,0 +1,242 @@
+/*=========================================================================
+
+  Program:   ParaView
+  Module:    $RCSfile$
+
+  Copyright (c) Kitware, Inc.
+  All rights reserved.
+  See Copyright.txt or http://www.paraview.org/HTML/Copyright.html for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME vtkStreamingGeometryRepresentation - representation for rendering
+// the surface of multiblock datasets with streaming.
+// .SECTION Description
+// vtkStreamingGeometryRepresentation is a representation for multiblock
+// datasets, e.g. large unstructured grids split into many blocks, that
+// streams the blocks instead of loading them all before the first render.
+// When the input pipeline provides composite meta-data with block bounds,
+// the first pass requests no blocks and uses the meta-data bounds. Subsequent
+// streaming passes request StreamingRequestSize blocks per process, in the
+// order determined by vtkStreamingGeometryPriorityQueue (blocks inside the
+// view frustum, largest screen coverage first), and deliver their surface
+// through vtkPVRenderView::SetNextStreamedPiece().
+//
+// When MemoryLimit is set, blocks that leave the view frustum are purged from
+// the rendered data to stay within the limit.
+// .SECTION See Also
+// vtkStreamingGeometryPriorityQueue, vtkStreamingParticlesRepresentation
+
+#ifndef vtkStreamingGeometryRepresentation_h
+#define vtkStreamingGeometryRepresentation_h
+
+#include "vtkPVDataRepresentation.h"
+#include "vtkSmartPointer.h" // for smart pointer.
+#include "vtkWeakPointer.h" // for weak pointer.
+#include "vtkBoundingBox.h" // needed for vtkBoundingBox.
+#include <vector> // needed for std::vector
+
+class vtkCompositePolyDataMapper2;
+class vtkMultiBlockDataSet;
+class vtkPVLODActor;
+class vtkScalarsToColors;
+class vtkStreamingGeometryPriorityQueue;
+
+class vtkStreamingGeometryRepresentation : public vtkPVDataRepresentation
+{
+public:
+  static vtkStreamingGeometryRepresentation* New();
+  vtkTypeMacro(vtkStreamingGeometryRepresentation, vtkPVDataRepresentation);
+  void PrintSelf(ostream& os, vtkIndent indent);
+
+  // Description:
+  // Set the input data arrays that this algorithm will process. Overridden to
+  // pass the array selection to the mapper.
+  virtual void SetInputArrayToProcess(int idx, int port, int connection,
+    int fieldAssociation, const char *name);
+  virtual void SetInputArrayToProcess(int idx, int port, int connection,
+    int fieldAssociation, int fieldAttributeType)
+    {
+    this->Superclass::SetInputArrayToProcess(
+      idx, port, connection, fieldAssociation, fieldAttributeType);
+    }
+  virtual void SetInputArrayToProcess(int idx, vtkInformation *info)
+    {
+    this->Superclass::SetInputArrayToProcess(idx, info);
+    }
+  virtual void SetInputArrayToProcess(int idx, int port, int connection,
+                              const char* fieldAssociation,
+                              const char* attributeTypeorName)
+    {
+    this->Superclass::SetInputArrayToProcess(idx, port, connection,
+      fieldAssociation, attributeTypeorName);
+    }
+
+  // Description:
+  // Overridden to handle various view passes.
+  virtual int ProcessViewRequest(vtkInformationRequestKey* request_type,
+    vtkInformation* inInfo, vtkInformation* outInfo);
+
+  // Description:
+  // Get/Set the visibility for this representation. When the visibility of
+  // representation of false, all view passes are ignored.
+  virtual void SetVisibility(bool val);
+
+  // Description:
+  // Set the number of blocks to request at a given time on a single process
+  // when streaming.
+  vtkSetClampMacro(StreamingRequestSize, int, 1, 10000);
+  vtkGetMacro(StreamingRequestSize, int);
+
+  // Description:
+  // Set the limit, in megabytes, for the memory used by the streamed blocks.
+  // When exceeded, blocks outside the view frustum are purged. 0 implies no
+  // limit.
+  void SetMemoryLimit(double val);
+  double GetMemoryLimit();
+
+  // Description:
+  // Should be true if any server process can load any block. When false,
+  // the input meta-data must provide
+  // vtkCompositeDataSet::CURRENT_PROCESS_CAN_LOAD_BLOCK for each block.
+  // Defaults to true.
+  void SetProcessesCanLoadAnyBlock(bool newVal);
+  bool GetProcessesCanLoadAnyBlock();
+  vtkBooleanMacro(ProcessesCanLoadAnyBlock, bool);
+
+  // Description:
+  // Helps with debugging.
+  vtkSetMacro(UseOutline, bool);
+
+  // Description:
+  // Streaming progress statistics. These are only meaningful on the
+  // data-server nodes.
+  unsigned int GetNumberOfBlocks();
+  unsigned int GetNumberOfStreamedBlocks();
+  unsigned long GetStreamedMemorySize();
+
+  //---------------------------------------------------------------------------
+  // The following API is to simply provide the functionality similar to
+  // vtkGeometryRepresentation.
+  //---------------------------------------------------------------------------
+  void SetLookupTable(vtkScalarsToColors*);
+  void SetOpacity(double val);
+  void SetPointSize(double val);
+  void SetLineWidth(double val);
+  void SetRepresentation(int val);
+
+protected:
+  vtkStreamingGeometryRepresentation();
+  ~vtkStreamingGeometryRepresentation();
+
+  // Description:
+  // Adds the representation to the view.  This is called from
+  // vtkView::AddRepresentation().  Subclasses should override this method.
+  // Returns true if the addition succeeds.
+  virtual bool AddToView(vtkView* view);
+
+  // Description:
+  // Removes the representation to the view.  This is called from
+  // vtkView::RemoveRepresentation().  Subclasses should override this method.
+  // Returns true if the removal succeeds.
+  virtual bool RemoveFromView(vtkView* view);
+
+  // Description:
+  // Fill input port information.
+  int FillInputPortInformation(int port, vtkInformation* info);
+
+  // Description:
+  // Overridden to check if the input pipeline is streaming capable i.e.
+  // streaming is enabled and the input provides
+  // vtkCompositeDataPipeline::COMPOSITE_DATA_META_DATA().
+  virtual int RequestInformation(vtkInformation *rqst,
+    vtkInformationVector **inputVector,
+    vtkInformationVector *outputVector);
+
+  // Description:
+  // Setup the block request. During StreamingUpdate, this will request the
+  // blocks popped from the vtkStreamingGeometryPriorityQueue. Otherwise, for a
+  // streaming capable pipeline, no blocks are requested.
+  virtual int RequestUpdateExtent(vtkInformation* request,
+    vtkInformationVector** inputVector,
+    vtkInformationVector* outputVector);
+
+  // Description:
+  // Generate the surface for the current input.
+  // When not in StreamingUpdate, this also initializes the priority queue since
+  // the input may have totally changed, including its structure.
+  virtual int RequestData(vtkInformation *rqst,
+    vtkInformationVector **inputVector,
+    vtkInformationVector *outputVector);
+
+  // Description:
+  // Returns true when the input pipeline supports streaming. It is set in
+  // RequestInformation().
+  vtkGetMacro(StreamingCapablePipeline, bool);
+
+  // Description:
+  // Returns true when StreamingUpdate() is being processed.
+  vtkGetMacro(InStreamingUpdate, bool);
+
+  // Description:
+  // Returns true if this representation has a "next piece" that it streamed.
+  // This method will update the PriorityQueue using the view planes specified
+  // and then call Update() on the representation, making it reexecute and
+  // regenerate the surface for the next "piece" of data. It must be called on
+  // all data-server processes.
+  bool StreamingUpdate(const double view_planes[24]);
+
+  // Description:
+  // Called in StreamingUpdate() to determine the blocks to stream in the
+  // current pass. Returns false if no blocks need to be streamed on this
+  // process.
+  bool DetermineBlocksToStream();
+
+  // Description:
+  // Reports the blocks produced in the current streaming pass, and their
+  // memory size, to the priority queue.
+  void MarkStreamedBlocksDelivered();
+
+  // Description:
+  // This is the data object generated processed by the most recent call to
+  // RequestData() while not streaming.
+  // This is non-empty only on the data-server nodes.
+  vtkSmartPointer<vtkMultiBlockDataSet> ProcessedData;
+
+  // Description:
+  // This is the data object generated processed by the most recent call to
+  // RequestData() while streaming.
+  // This is non-empty only on the data-server nodes.
+  vtkSmartPointer<vtkDataObject> ProcessedPiece;
+
+  // Description:
+  // Helps us keep track of the data being rendered.
+  vtkWeakPointer<vtkDataObject> RenderedData;
+
+  vtkSmartPointer<vtkStreamingGeometryPriorityQueue> PriorityQueue;
+
+  // Description:
+  // Actor used to render the surface in the view.
+  vtkSmartPointer<vtkCompositePolyDataMapper2> Mapper;
+  vtkSmartPointer<vtkPVLODActor> Actor;
+
+  // Description:
+  // Used to keep track of data bounds.
+  vtkBoundingBox DataBounds;
+
+  std::vector<int> StreamingRequest;
+  int StreamingRequestSize;
+  bool UseOutline;
+
+private:
+  vtkStreamingGeometryRepresentation(const vtkStreamingGeometryRepresentation&) VTK_DELETE_FUNCTION;
+  void operator=(const vtkStreamingGeometryRepresentation&) VTK_DELETE_FUNCTION;
+
+  bool StreamingCapablePipeline;
+  bool InStreamingUpdate;
+};
+
+#endif
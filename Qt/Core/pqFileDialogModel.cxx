@@ -57,6 +57,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <vtkStringList.h>
 
 #include "pqSMAdaptor.h"
+#include "pqTimer.h"
 
 //////////////////////////////////////////////////////////////////////
 // pqFileDialogModelFileInfo
@@ -243,8 +244,13 @@ class pqFileDialogModel::pqImplementation
 public:
   pqImplementation(pqServer* server) :
     Separator(0),
+    NumberOfDirectories(0),
+    ListingOffset(0),
+    ListingSize(0),
     Server(server)
   {
+    this->FetchTimer.setSingleShot(true);
+    this->FetchTimer.setInterval(0);
 
     // if we are doing remote browsing
     if(server)
@@ -290,16 +296,23 @@ public:
   /// query the file system for information
   vtkPVFileInformation* GetData(bool dirListing,
                                 const QString& path,
-                                bool specialDirs)
+                                bool specialDirs,
+                                int listingOffset = 0,
+                                int listingLength = 0)
     {
-    return this->GetData(dirListing, this->CurrentPath, path, specialDirs);
+    return this->GetData(dirListing, this->CurrentPath, path, specialDirs,
+      listingOffset, listingLength);
     }
 
-  /// query the file system for information
+  /// query the file system for information. When dirListing is true,
+  /// listingOffset and listingLength select the range of the listing to
+  /// return (0 length for the whole listing).
   vtkPVFileInformation* GetData(bool dirListing,
                                 const QString& workingDir,
                                 const QString& path,
-                                bool specialDirs)
+                                bool specialDirs,
+                                int listingOffset = 0,
+                                int listingLength = 0)
     {
     if(this->FileInformationHelperProxy)
       {
@@ -309,6 +322,10 @@ public:
         helper->GetProperty("WorkingDirectory"), workingDir);
       pqSMAdaptor::setElementProperty(
         helper->GetProperty("DirectoryListing"), dirListing);
+      pqSMAdaptor::setElementProperty(
+        helper->GetProperty("DirectoryListingOffset"), listingOffset);
+      pqSMAdaptor::setElementProperty(
+        helper->GetProperty("DirectoryListingLength"), listingLength);
       pqSMAdaptor::setElementProperty(
         helper->GetProperty("Path"), path.toLatin1().data());
       pqSMAdaptor::setElementProperty(
@@ -324,6 +341,8 @@ public:
       {
       vtkPVFileInformationHelper* helper = this->FileInformationHelper;
       helper->SetDirectoryListing(dirListing);
+      helper->SetDirectoryListingOffset(listingOffset);
+      helper->SetDirectoryListingLength(listingLength);
       helper->SetPath(path.toLatin1().data());
       helper->SetSpecialDirectories(specialDirs);
       helper->SetWorkingDirectory(workingDir.toLatin1().data());
@@ -340,7 +359,39 @@ public:
 
     QList<pqFileDialogModelFileInfo> dirs;
     QList<pqFileDialogModelFileInfo> files;
+    this->Collect(dir, dirs, files);
+
+    qSort(dirs.begin(), dirs.end(), CaseInsensitiveSort);
+    qSort(files.begin(), files.end(), CaseInsensitiveSort);
 
+    for(int i = 0; i != dirs.size(); ++i)
+      {
+      this->FileList.push_back(dirs[i]);
+      }
+    for(int i = 0; i != files.size(); ++i)
+      {
+      this->FileList.push_back(files[i]);
+      }
+    this->NumberOfDirectories = dirs.size();
+
+    // the rest of a large directory is fetched from the event loop.
+    this->ListingSize = dir->GetDirectoryListingSize();
+    this->ListingOffset = ListingLength;
+    if (this->ListingOffset < this->ListingSize)
+      {
+      this->FetchTimer.start();
+      }
+    else
+      {
+      this->FetchTimer.stop();
+      }
+    }
+
+  /// splits the contents of the queried directory into directories and files
+  void Collect(vtkPVFileInformation* dir,
+    QList<pqFileDialogModelFileInfo>& dirs,
+    QList<pqFileDialogModelFileInfo>& files)
+    {
     vtkSmartPointer<vtkCollectionIterator> iter;
     iter.TakeReference(dir->GetContents()->NewIterator());
 
@@ -384,18 +435,54 @@ public:
           vtkPVFileInformation::SINGLE_FILE,info->GetHidden(), groupFiles));
         }
       }
+    }
 
-    qSort(dirs.begin(), dirs.end(), CaseInsensitiveSort);
-    qSort(files.begin(), files.end(), CaseInsensitiveSort);
+  /// returns the row where the item should be inserted to keep the list
+  /// sorted, directories first.
+  int insertionRow(const pqFileDialogModelFileInfo& info, bool isDir) const
+    {
+    QList<pqFileDialogModelFileInfo>::const_iterator begin =
+      this->FileList.begin();
+    QList<pqFileDialogModelFileInfo>::const_iterator end =
+      this->FileList.end();
+    if (isDir)
+      {
+      end = begin + this->NumberOfDirectories;
+      }
+    else
+      {
+      begin += this->NumberOfDirectories;
+      }
+    return qUpperBound(begin, end, info, CaseInsensitiveSort) -
+      this->FileList.begin();
+    }
 
-    for(int i = 0; i != dirs.size(); ++i)
+  /// returns the row of an entry of FileList, or -1. The list is kept
+  /// sorted, so only the entries sharing its label are compared.
+  int rowOf(const pqFileDialogModelFileInfo* info) const
+    {
+    QList<pqFileDialogModelFileInfo>::const_iterator begin =
+      this->FileList.begin();
+    QList<pqFileDialogModelFileInfo>::const_iterator end =
+      this->FileList.end();
+    if (vtkPVFileInformation::IsDirectory(info->type()))
       {
-      this->FileList.push_back(dirs[i]);
+      end = begin + this->NumberOfDirectories;
       }
-    for(int i = 0; i != files.size(); ++i)
+    else
       {
-      this->FileList.push_back(files[i]);
+      begin += this->NumberOfDirectories;
       }
+    for (QList<pqFileDialogModelFileInfo>::const_iterator iter =
+      qLowerBound(begin, end, *info, CaseInsensitiveSort);
+      iter != end && !CaseInsensitiveSort(*info, *iter); ++iter)
+      {
+      if (&(*iter) == info)
+        {
+        return iter - this->FileList.begin();
+        }
+      }
+    return -1;
     }
 
   QStringList getFilePaths(const QModelIndex& Index)
@@ -462,7 +549,19 @@ public:
   /// Current path being displayed (server's filesystem).
   QString CurrentPath;
   /// Caches information about the set of files within the current path.
-  QVector<pqFileDialogModelFileInfo> FileList;  // adjacent memory occupation for QModelIndex
+  /// QList keeps the items in place when rows are inserted, which matters
+  /// since the indexes of grouped files point to their group.
+  QList<pqFileDialogModelFileInfo> FileList;
+  /// Number of directories, listed before the files in FileList.
+  int NumberOfDirectories;
+
+  /// Number of entries of the current directory requested per round trip.
+  static const int ListingLength = 1024;
+  /// Range of the listing of the current directory still to be fetched.
+  int ListingOffset;
+  int ListingSize;
+  /// Fetches the next range of the listing from the event loop.
+  pqTimer FetchTimer;
 
   const pqFileDialogModelFileInfo* infoForIndex(const QModelIndex& idx) const
     {
@@ -500,6 +599,8 @@ pqFileDialogModel::pqFileDialogModel(pqServer* _server, QObject* Parent) :
   base(Parent),
   Implementation(new pqImplementation(_server))
 {
+  QObject::connect(&this->Implementation->FetchTimer, SIGNAL(timeout()),
+    this, SLOT(fetchNextEntries()));
 }
 
 pqFileDialogModel::~pqFileDialogModel()
@@ -517,11 +618,55 @@ void pqFileDialogModel::setCurrentPath(const QString& Path)
   this->beginResetModel();
   QString cPath = this->Implementation->cleanPath(Path);
   vtkPVFileInformation* info;
-  info = this->Implementation->GetData(true, cPath, false);
+  info = this->Implementation->GetData(true, cPath, false,
+    0, pqImplementation::ListingLength);
   this->Implementation->Update(cPath, info);
   this->endResetModel();
 }
 
+void pqFileDialogModel::fetchNextEntries()
+{
+  pqImplementation* impl = this->Implementation;
+  if (impl->ListingOffset >= impl->ListingSize)
+    {
+    return;
+    }
+
+  vtkPVFileInformation* info = impl->GetData(true, impl->CurrentPath, false,
+    impl->ListingOffset, pqImplementation::ListingLength);
+  impl->ListingOffset += pqImplementation::ListingLength;
+  if (!vtkPVFileInformation::IsDirectory(info->GetType()))
+    {
+    // the directory is gone.
+    impl->ListingSize = 0;
+    return;
+    }
+
+  QList<pqFileDialogModelFileInfo> dirs;
+  QList<pqFileDialogModelFileInfo> files;
+  impl->Collect(info, dirs, files);
+  for (int i = 0; i != dirs.size(); ++i)
+    {
+    int row = impl->insertionRow(dirs[i], true);
+    this->beginInsertRows(QModelIndex(), row, row);
+    impl->FileList.insert(row, dirs[i]);
+    impl->NumberOfDirectories++;
+    this->endInsertRows();
+    }
+  for (int i = 0; i != files.size(); ++i)
+    {
+    int row = impl->insertionRow(files[i], false);
+    this->beginInsertRows(QModelIndex(), row, row);
+    impl->FileList.insert(row, files[i]);
+    this->endInsertRows();
+    }
+
+  if (impl->ListingOffset < impl->ListingSize)
+    {
+    impl->FetchTimer.start();
+    }
+}
+
 QString pqFileDialogModel::getCurrentPath()
 {
   return this->Implementation->CurrentPath;
@@ -611,12 +756,7 @@ bool pqFileDialogModel::mkdir(const QString& dirName)
     ret = (vtkDirectory::MakeDirectory(dirPath.toLatin1().data()) != 0);
     }
 
-  this->beginResetModel();
-  QString cPath = this->Implementation->cleanPath(this->getCurrentPath());
-  vtkPVFileInformation* info;
-  info = this->Implementation->GetData(true, cPath, false);
-  this->Implementation->Update(cPath, info);
-  this->endResetModel();
+  this->setCurrentPath(this->getCurrentPath());
 
   return ret;
 }
@@ -648,12 +788,7 @@ bool pqFileDialogModel::rmdir(const QString& dirName)
     ret = (vtkDirectory::DeleteDirectory(dirPath.toLatin1().data()) != 0);
     }
 
-  this->beginResetModel();
-  QString cPath = this->Implementation->cleanPath(this->getCurrentPath());
-  vtkPVFileInformation* info;
-  info = this->Implementation->GetData(true, cPath, false);
-  this->Implementation->Update(cPath, info);
-  this->endResetModel();
+  this->setCurrentPath(this->getCurrentPath());
 
 
   return ret;
@@ -709,11 +844,7 @@ bool pqFileDialogModel::rename(const QString& oldname, const QString& newname)
                                 newPath.toLatin1().data()) != 0);
     }
 
-  this->beginResetModel();
-  QString cPath = this->Implementation->cleanPath(this->getCurrentPath());
-  info = this->Implementation->GetData(true, cPath, false);
-  this->Implementation->Update(cPath, info);
-  this->endResetModel();
+  this->setCurrentPath(this->getCurrentPath());
 
   return ret;
 }
@@ -833,8 +964,12 @@ QModelIndex pqFileDialogModel::parent(const QModelIndex& idx) const
     }
 
   const pqFileDialogModelFileInfo* ptr = reinterpret_cast<pqFileDialogModelFileInfo*>(idx.internalPointer());
-  int row = ptr - &this->Implementation->FileList.first();
-  return this->createIndex(row, idx.column());
+  int row = this->Implementation->rowOf(ptr);
+  if (row >= 0)
+    {
+    return this->createIndex(row, idx.column());
+    }
+  return QModelIndex();
 }
 
 int pqFileDialogModel::rowCount(const QModelIndex& idx) const
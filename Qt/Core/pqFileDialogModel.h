@@ -130,6 +130,12 @@ public:
   /// returns flags for item
   Qt::ItemFlags flags(const QModelIndex& idx) const;
 
+private slots:
+  /// fetches the next range of the listing of a large directory. The first
+  /// range is fetched by setCurrentPath(), the others are added to the model
+  /// from the event loop so that the dialog remains responsive.
+  void fetchNextEntries();
+
 private:
   class pqImplementation;
   pqImplementation* const Implementation;
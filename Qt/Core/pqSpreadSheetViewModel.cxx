@@ -203,16 +203,22 @@ public:
 
   this->LastColumnCount = 0;
   this->LastRowCount = 0;
+  this->ReadAheadBlocks = 2;
+  this->ScrollDirection = 1;
   }
 
   QItemSelectionModel SelectionModel;
   pqTimer Timer;
+  pqTimer FetchTimer;
   pqTimer SelectionTimer;
   int DecimalPrecision;
   vtkIdType LastRowCount;
   vtkIdType LastColumnCount;
 
   int ActiveRegion[2];
+  int ReadAheadBlocks;
+  int ScrollDirection;
+  QList<vtkIdType> PendingBlocks;
   vtkSmartPointer<vtkEventQtSlotConnect> VTKConnect;
   QPointer<pqDataRepresentation> ActiveRepresentation;
   vtkWeakPointer<vtkSMProxy> ActiveRepresentationProxy;
@@ -240,10 +246,17 @@ pqSpreadSheetViewModel::pqSpreadSheetViewModel(vtkSMProxy* view,
     this, SLOT(onDataFetched(vtkObject*, unsigned long, void*, void*)));
 
   this->Internal->Timer.setSingleShot(true);
-  this->Internal->Timer.setInterval(500);//milliseconds.
+  this->Internal->Timer.setInterval(200);//milliseconds.
   QObject::connect(&this->Internal->Timer, SIGNAL(timeout()),
     this, SLOT(delayedUpdate()));
 
+  // Blocks are fetched one per event loop iteration so that the view keeps
+  // repainting and scrolling between fetches.
+  this->Internal->FetchTimer.setSingleShot(true);
+  this->Internal->FetchTimer.setInterval(0);
+  QObject::connect(&this->Internal->FetchTimer, SIGNAL(timeout()),
+    this, SLOT(fetchNextBlock()));
+
   this->Internal->SelectionTimer.setSingleShot(true);
   this->Internal->SelectionTimer.setInterval(100);//milliseconds.
   QObject::connect(&this->Internal->SelectionTimer, SIGNAL(timeout()),
@@ -322,6 +335,8 @@ void pqSpreadSheetViewModel::forceUpdate()
   this->Internal->ActiveRegion[1] = -1;
   this->Internal->SelectionModel.clear();
   this->Internal->Timer.stop();
+  this->Internal->FetchTimer.stop();
+  this->Internal->PendingBlocks.clear();
   this->Internal->SelectionTimer.stop();
 
   vtkIdType &rows = this->Internal->LastRowCount;
@@ -353,9 +368,81 @@ void pqSpreadSheetViewModel::forceUpdate()
 //-----------------------------------------------------------------------------
 void pqSpreadSheetViewModel::delayedUpdate()
 {
-  if (this->Internal->ActiveRegion[0] >= 0)
+  this->updatePendingBlocks();
+  if (!this->Internal->PendingBlocks.isEmpty())
+    {
+    this->Internal->FetchTimer.start();
+    }
+}
+
+//-----------------------------------------------------------------------------
+void pqSpreadSheetViewModel::fetchNextBlock()
+{
+  if (this->Internal->PendingBlocks.isEmpty())
+    {
+    return;
+    }
+
+  // This is a blocking fetch; it triggers onDataFetched().
+  vtkIdType block = this->Internal->PendingBlocks.takeFirst();
+  this->Internal->VTKView->Prefetch(block);
+
+  if (!this->Internal->PendingBlocks.isEmpty())
+    {
+    this->Internal->FetchTimer.start();
+    }
+}
+
+//-----------------------------------------------------------------------------
+void pqSpreadSheetViewModel::updatePendingBlocks()
+{
+  pqInternal& internal = *this->Internal;
+  internal.PendingBlocks.clear();
+
+  vtkIdType numRows = this->rowCount();
+  if (internal.ActiveRegion[0] < 0 || numRows <= 0)
+    {
+    return;
+    }
+
+  vtkIdType blockSize = vtkSMPropertyHelper(this->ViewProxy,
+    "BlockSize").GetAsIdType();
+  if (blockSize <= 0)
+    {
+    return;
+    }
+
+  vtkIdType lastBlock = (numRows - 1) / blockSize;
+  vtkIdType first = qMin<vtkIdType>(internal.ActiveRegion[0] / blockSize,
+    lastBlock);
+  vtkIdType last = qMin<vtkIdType>(
+    qMax(internal.ActiveRegion[0], internal.ActiveRegion[1]) / blockSize,
+    lastBlock);
+
+  // Keep enough blocks on the client for the visible and read-ahead blocks
+  // not to evict each other.
+  int needed = static_cast<int>(last - first + 1) +
+    2 * internal.ReadAheadBlocks + 2;
+  if (internal.VTKView->GetMaximumNumberOfCachedBlocks() < needed)
+    {
+    internal.VTKView->SetMaximumNumberOfCachedBlocks(needed);
+    }
+
+  for (vtkIdType cc = first; cc <= last; ++cc)
+    {
+    if (!internal.VTKView->IsAvailable(cc * blockSize))
+      {
+      internal.PendingBlocks.push_back(cc);
+      }
+    }
+  for (int cc = 1; cc <= internal.ReadAheadBlocks; ++cc)
     {
-    this->Internal->VTKView->GetValue(this->Internal->ActiveRegion[0], 0);
+    vtkIdType block = internal.ScrollDirection > 0 ? last + cc : first - cc;
+    if (block >= 0 && block <= lastBlock &&
+      !internal.VTKView->IsAvailable(block * blockSize))
+      {
+      internal.PendingBlocks.push_back(block);
+      }
     }
 }
 
@@ -368,8 +455,37 @@ void pqSpreadSheetViewModel::triggerSelectionChanged()
 //-----------------------------------------------------------------------------
 void pqSpreadSheetViewModel::setActiveRegion(int row_top, int row_bottom)
 {
-  this->Internal->ActiveRegion[0] = row_top;
-  this->Internal->ActiveRegion[1] = row_bottom;
+  pqInternal& internal = *this->Internal;
+  if (internal.ActiveRegion[0] >= 0 && row_top != internal.ActiveRegion[0])
+    {
+    internal.ScrollDirection = (row_top > internal.ActiveRegion[0])? 1 : -1;
+    }
+  internal.ActiveRegion[0] = row_top;
+  internal.ActiveRegion[1] = row_bottom;
+
+  // Cancel pending fetches that are no longer needed and queue the ones
+  // needed for the new region, read-ahead blocks included.
+  this->updatePendingBlocks();
+  if (internal.PendingBlocks.isEmpty())
+    {
+    internal.FetchTimer.stop();
+    }
+  else if (!internal.Timer.isActive())
+    {
+    internal.FetchTimer.start();
+    }
+}
+
+//-----------------------------------------------------------------------------
+void pqSpreadSheetViewModel::setReadAheadBlocks(int count)
+{
+  this->Internal->ReadAheadBlocks = qMax(count, 0);
+}
+
+//-----------------------------------------------------------------------------
+int pqSpreadSheetViewModel::readAheadBlocks() const
+{
+  return this->Internal->ReadAheadBlocks;
 }
 
 //-----------------------------------------------------------------------------
@@ -394,7 +510,7 @@ void pqSpreadSheetViewModel::onDataFetched(
     rowMax = this->rowCount() - 1;
     }
 
-  QModelIndex topLeft(this->index(rowMax, 0));
+  QModelIndex topLeft(this->index(rowMin, 0));
   QModelIndex bottomRight(this->index(rowMax, this->columnCount()-1));
 
   this->dataChanged(topLeft, bottomRight);
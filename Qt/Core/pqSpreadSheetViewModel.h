@@ -132,6 +132,13 @@ public:
   /// QAbstractTableModel::data(..) callback).
   void setActiveRegion(int row_top, int row_bottom);
 
+  /// Set/Get the number of blocks fetched ahead of the active-region, in the
+  /// direction of scrolling. Blocks are fetched one at a time from the event
+  /// loop, visible blocks first, and pending fetches for blocks that have
+  /// scrolled out of reach are dropped. Default is 2.
+  void setReadAheadBlocks(int);
+  int readAheadBlocks() const;
+
   /// Returns the active representation. Active representation is the
   /// representation being shown by the view.
   pqDataRepresentation* activeRepresentation() const;
@@ -161,6 +168,9 @@ private slots:
   /// called to fetch data for all pending blocks.
   void delayedUpdate();
 
+  /// fetches the next pending block, if any.
+  void fetchNextBlock();
+
   void triggerSelectionChanged();
 
   /// Caleld when the vtkSpreadSheetView fetches a new block, we fire
@@ -172,6 +182,11 @@ protected:
   /// less than the length of the data array associated with its column
   bool isDataValid(const QModelIndex &idx) const;
 
+  /// Rebuilds the list of blocks to fetch for the active-region: the visible
+  /// blocks first, then the read-ahead blocks. Blocks no longer needed are
+  /// dropped.
+  void updatePendingBlocks();
+
   vtkSpreadSheetView* GetView() const;
 private:
   Q_DISABLE_COPY(pqSpreadSheetViewModel)
@@ -307,6 +307,13 @@ class Store(object):
         if not self.__loaded:
             self.create()
 
+    def exists(self, descriptor):
+        """
+        Returns True if the document for the descriptor has already been
+        written to the store. Subclasses that can tell should override this.
+        """
+        return False
+
     def assign_parameter_dependence(self, dep_param, param, on_values):
         """
         mark a particular parameter as being explorable only for a subset
@@ -693,6 +700,10 @@ class FileStore(Store):
             else:
                 self.raster_wrangler.genericwriter(document.data, fname)
 
+    def exists(self, descriptor):
+        """ overridden to check for the document's file on disk """
+        return os.path.exists(self._get_filename(descriptor))
+
     def _load_data(self, doc_file, descriptor):
         doctype = self.determine_type(descriptor)
         try:
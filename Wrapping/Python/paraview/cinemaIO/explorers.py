@@ -48,6 +48,12 @@ class Explorer(object):
         self.__cinema_store = cinema_store
         self.parameters = parameters
         self.tracks = tracks
+        #when set, documents already in the store are not produced again
+        self.skip_existing = False
+        #(index, count): only produce every count'th document, starting at index
+        self.partition = (0, 1)
+        self.num_executed = 0
+        self.num_skipped = 0
 
     @property
     def cinema_store(self):
@@ -72,6 +78,22 @@ class Explorer(object):
             #print "EXECUTING track ", e, doc.descriptor
             e.execute(doc)
         self.insert(doc)
+        self.num_executed += 1
+
+    def should_skip(self, desc):
+        """ True if the document for desc is already in the store and we are
+        resuming a previous run """
+        return self.skip_existing and self.cinema_store.exists(desc)
+
+    def is_complete(self, fixedargs=None):
+        """ True if all the documents this explorer would produce with the given
+        fixed arguments are already in the store """
+        if not self.skip_existing:
+            return False
+        for descriptor in self.cinema_store.iterate(self.list_parameters(), fixedargs):
+            if not self.cinema_store.exists(descriptor):
+                return False
+        return True
 
     def explore(self, fixedargs=None):
         """
@@ -81,7 +103,14 @@ class Explorer(object):
         """
         self.prepare()
 
-        for descriptor in self.cinema_store.iterate(self.list_parameters(), fixedargs):
+        index, count = self.partition
+        for i, descriptor in enumerate(
+            self.cinema_store.iterate(self.list_parameters(), fixedargs)):
+            if count > 1 and i % count != index:
+                continue
+            if self.should_skip(descriptor):
+                self.num_skipped += 1
+                continue
             self.execute(descriptor)
 
         self.finish()
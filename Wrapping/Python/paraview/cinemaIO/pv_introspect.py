@@ -317,10 +317,12 @@ def add_customized_array_selection(sourceName, source, fields, ranges, userDefin
     return defaultName
 
 def make_cinema_store(proxies, ocsfname, forcetime=False, userDefined = {},
-                      specLevel = "A", camType = "Spherical"):
+                      specLevel = "A", camType = "Spherical", resume = False):
     """
     Takes in the pipeline, structured as a tree, and makes a cinema store definition
     containing all the parameters we will vary.
+    When resume is True, the time values of an existing store are kept so that
+    new timesteps can be added to it incrementally.
     """
 
     if "phi" in userDefined:
@@ -398,6 +400,8 @@ def make_cinema_store(proxies, ocsfname, forcetime=False, userDefined = {},
             pass
         else:
             prettytimes = [float_limiter(t) for t in times]
+            if resume:
+                prettytimes = sorted(set(prettytimes).union(tvalues))
             cs.add_parameter("time", cinema_store.make_parameter('time', prettytimes))
             fnp = "{time}"
 
@@ -425,10 +429,17 @@ def make_cinema_store(proxies, ocsfname, forcetime=False, userDefined = {},
     return cs
 
 def explore(cs, proxies, iSave=True, currentTime=None, userDefined = {},
-            specLevel = "A", camType = "Spherical"):
+            specLevel = "A", camType = "Spherical", resume = False,
+            partition = (0, 1)):
     """
     Runs a pipeline through all the changes we know how to make and saves off
     images into the store for each one.
+    When resume is True, images already in the store are not rendered again
+    and timesteps whose images are all present are not loaded.
+    partition is a (index, count) pair used to split the work among
+    independent processes: timesteps (or, without time, images) are assigned
+    round-robin and only those for index are produced.
+    Returns the number of images written and skipped.
     """
 #    import pv_explorers
     import explorers
@@ -513,13 +524,23 @@ def explore(cs, proxies, iSave=True, currentTime=None, userDefined = {},
     for c in cols:
         c.imageExplorer = e
 
+    e.skip_existing = resume
+    index, count = partition
     times = paraview.simple.GetAnimationScene().TimeKeeper.TimestepValues
     if not times:
+        e.partition = partition
         e.explore(currentTime)
     else:
-        for t in times:
+        for i, t in enumerate(times):
+            if count > 1 and i % count != index:
+                continue
+            timeargs = {'time':float_limiter(t)}
+            if e.is_complete(timeargs):
+                #don't bother loading a timestep that is already done
+                continue
             view_proxy.ViewTime=t
-            e.explore({'time':float_limiter(t)})
+            e.explore(timeargs)
+    return (e.num_executed, e.num_skipped)
 
 def explore_customized_array_selection(sourceName, source, colorList, userDefined):
     isArrayNotSelected = lambda aName, arrays: (aName not in arrays)
@@ -560,7 +581,8 @@ def explore_customized_array_selection(sourceName, source, colorList, userDefine
                             i, arr.GetRange(i))
     return numVals
 
-def export_scene(baseDirName, viewSelection, trackSelection, arraySelection):
+def export_scene(baseDirName, viewSelection, trackSelection, arraySelection,
+                 resume=False, partitionIndex=0, numberOfPartitions=1):
     '''This explores a set of user-defined views and tracks. export_scene is
     called from vtkCinemaExport.  The expected order of parameters is as follows:
 
@@ -579,7 +601,24 @@ def export_scene(baseDirName, viewSelection, trackSelection, arraySelection):
 
     Note:  baseDirName is used as the parent directory of the database generated for
     each view in viewSelection. 'Image filename' is used as the database directory name.
+
+    - resume:
+
+    When True, images already present in the database are not rendered again. This
+    allows resuming an interrupted export, or adding timesteps to an existing one.
+
+    - partitionIndex, numberOfPartitions:
+
+    Split the export among numberOfPartitions independent processes (e.g. batch
+    jobs writing to a shared file system). Timesteps are assigned round-robin; only
+    the process with partitionIndex 0 writes info.json.
     '''
+    import time
+    startTime = time.time()
+    numExecuted = 0
+    numSkipped = 0
+    partition = (partitionIndex, max(numberOfPartitions, 1))
+
     # save initial state
     initialView = paraview.simple.GetActiveView()
     pvstate = record_visibility()
@@ -645,14 +684,20 @@ def export_scene(baseDirName, viewSelection, trackSelection, arraySelection):
         cs = make_cinema_store(p, filePath, forcetime = False,\
                                userDefined = userDefValues,
                                specLevel = specLevel,
-                               camType = camType)
+                               camType = camType,
+                               resume = resume)
 
-        explore(cs, p, userDefined = userDefValues,
-                specLevel = specLevel,
-                camType = camType)
+        executed, skipped = explore(cs, p, userDefined = userDefValues,
+                                    specLevel = specLevel,
+                                    camType = camType,
+                                    resume = resume,
+                                    partition = partition)
+        numExecuted += executed
+        numSkipped += skipped
 
         view.LockBounds = 0
-        cs.save()
+        if partitionIndex == 0:
+            cs.save()
         atLeastOneViewExported = True
 
     if not atLeastOneViewExported:
@@ -662,7 +707,10 @@ def export_scene(baseDirName, viewSelection, trackSelection, arraySelection):
     # restore initial state
     paraview.simple.SetActiveView(initialView)
     restore_visibility(pvstate)
-    print "Finished exporting Cinema database!"
+    elapsed = time.time() - startTime
+    rate = numExecuted / elapsed if elapsed > 0 else 0.0
+    print "Finished exporting Cinema database! Wrote %d images (skipped %d existing) in %.1f s, %.2f images/s." % \
+          (numExecuted, numSkipped, elapsed, rate)
 
 def prepare_selection(trackSelection, arraySelection):
     '''The rest of pv_introspect expects to receive user-defined values in the
@@ -55,6 +55,7 @@ class CoProcessor(object):
         self.__EnableLiveVisualization = False
         self.__LiveVisualizationFrequency = 1;
         self.__LiveVisualizationLink = None
+        self.__LiveVisualizationBandwidth = 0
         # __CinemaTracksList is just for Spec-A compatibility (will be deprecated
         # when porting Spec-A to pv_introspect. Use __CinemaTracks instead.
         self.__CinemaTracksList = []
@@ -81,6 +82,15 @@ class CoProcessor(object):
         self.__EnableLiveVisualization = enable
         self.__LiveVisualizationFrequency = frequency
 
+    def SetLiveVisualizationBandwidth(self, bandwidth):
+        """Set the maximum bandwidth, in megabytes per second, used to send
+        the extracts to ParaView Live. Extracts that do not fit are decimated
+        or skipped for the timestep instead of slowing down the simulation.
+        0 (the default) means no limit."""
+        self.__LiveVisualizationBandwidth = bandwidth
+        if self.__LiveVisualizationLink:
+            self.__LiveVisualizationLink.SetMaximumExtractsBandwidth(bandwidth)
+
     def CreatePipeline(self, datadescription):
         """This methods must be overridden by subclasses to create the
            visualization pipeline."""
@@ -262,6 +272,8 @@ class CoProcessor(object):
             # for the visualization process.
             self.__LiveVisualizationLink.SetHostname(hostname)
             self.__LiveVisualizationLink.SetInsituPort(int(port))
+            self.__LiveVisualizationLink.SetMaximumExtractsBandwidth(
+                self.__LiveVisualizationBandwidth)
 
             # Initialize the "link"
             self.__LiveVisualizationLink.Initialize(servermanager.ActiveConnection.Session.GetSessionProxyManager())
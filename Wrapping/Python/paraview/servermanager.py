@@ -1777,6 +1777,17 @@ class ProxyManager(object):
     def SaveState(self, filename):
         self.SMProxyManager.SaveXMLState(filename)
 
+    def LoadBinaryState(self, filename):
+        """Loads a state saved with SaveBinaryState(). Returns False on
+        failure."""
+        return self.SMProxyManager.LoadBinaryState(filename)
+
+    def SaveBinaryState(self, filename):
+        """Saves the state of the registered proxies in a compact binary
+        format that loads faster than the XML state. Returns False on
+        failure."""
+        return self.SMProxyManager.SaveBinaryState(filename)
+
 class PropertyIterator(object):
     """Wrapper for a vtkSMPropertyIterator class to satisfy
        the python iterator protocol. Note that the list of
@@ -3,6 +3,7 @@
 import os
 import re
 import sys
+import time
 import exceptions
 from vtk.vtkPVServerManagerDefault import *
 
@@ -27,6 +28,7 @@ Threshold = 10.0
 SMStatesDir = ""
 StateXMLFileName = ""
 UseSavedStateForRegressionTests = False
+Benchmark = False
 
 def Error(message):
   print "ERROR: %s" % message
@@ -41,10 +43,13 @@ def ProcessCommandLineArguments():
   global StateXMLFileName
   global UseSavedStateForRegressionTests
   global SMStatesDir
+  global Benchmark
   global __ProcessedCommandLineArguments__
   if __ProcessedCommandLineArguments__:
     return
   __ProcessedCommandLineArguments__ = True
+  # a flag, that may be the last argument.
+  Benchmark = "--benchmark" in sys.argv
   length = len(sys.argv)
   index = 1
   while index < length:
@@ -70,6 +75,24 @@ def ProcessCommandLineArguments():
       index -=1
   return
 
+def ProblemSize(test, benchmark):
+  """Returns the size of the data to test with: small by default, large when
+  the test is run with --benchmark."""
+  ProcessCommandLineArguments()
+  if Benchmark:
+    return benchmark
+  return test
+
+def Timed(label, function, *args):
+  """Calls function with args and returns its result. When the test is run
+  with --benchmark, also prints the time it took."""
+  ProcessCommandLineArguments()
+  start = time.time()
+  result = function(*args)
+  if Benchmark:
+    print "%-50s %8.3f s" % (label, time.time() - start)
+  return result
+
 def LoadServerManagerState(filename):
   """This function loads the servermanager state xml/pvsm.
   Returns the status of the load."""